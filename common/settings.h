@@ -16,6 +16,7 @@
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/mapping.h"
+#include "flutter/fml/thread.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/fml/unique_fd.h"
 
@@ -136,6 +137,11 @@ struct Settings {
   std::optional<std::vector<std::string>> trace_skia_allowlist;
   bool trace_startup = false;
   bool trace_systrace = false;
+  // Record the trace events in memory with |fml::tracing::TraceRecorder|.
+  bool trace_recorder = false;
+  // Record the trace events in memory and dump them to
+  // |temp_directory_path| after a janky frame.
+  bool dump_trace_on_jank = false;
   bool enable_timeline_event_handler = true;
   bool dump_skp_on_shader_compilation = false;
   bool cache_sksl = false;
@@ -203,6 +209,32 @@ struct Settings {
   // not supported on the platform.
   bool enable_impeller = false;
 
+  // Coalesce and resample pointer move events to one packet per frame. See
+  // `ResamplingPointerDataDispatcher`. Only honored by platforms that use the
+  // default pointer data dispatcher.
+  bool enable_pointer_resampling = false;
+
+  // Adjust the depth of the layer tree pipeline and the start of frames after
+  // vsync from the timings of recent frames. See `PipelineDepthController`.
+  bool enable_adaptive_pipeline_depth = false;
+
+  // The depth of the layer tree pipeline, or zero for the default depth.
+  // Ignored when the pipeline depth is adaptive or the platform and raster
+  // threads are the same.
+  uint32_t layer_tree_pipeline_depth = 0;
+
+  // The CPU affinity and scheduling policy of the workers of the concurrent
+  // message loop owned by the VM. Embedders that pin the threads of their
+  // |ThreadHost| usually keep these workers away from the same CPUs.
+  std::optional<fml::Thread::ThreadPolicy> concurrent_worker_thread_policy;
+
+  // The CPU affinity and scheduling policies of the UI, raster and IO threads
+  // when the engine creates them. Threads that the embedder provides are left
+  // alone.
+  std::optional<fml::Thread::ThreadPolicy> ui_thread_policy;
+  std::optional<fml::Thread::ThreadPolicy> raster_thread_policy;
+  std::optional<fml::Thread::ThreadPolicy> io_thread_policy;
+
   // Data set by platform-specific embedders for use in font initialization.
   uint32_t font_initialization_data = 0;
 
@@ -301,6 +333,11 @@ struct Settings {
   // Max bytes threshold of resource cache, or 0 for unlimited.
   size_t resource_cache_max_bytes_threshold = 0;
 
+  // The number of bytes that the caches of all engines in the process may
+  // retain together before the memory governor trims them, or 0 for
+  // unlimited.
+  size_t memory_budget_bytes = 0;
+
   /// A timestamp representing when the engine started. The value is based
   /// on the clock used by the Dart timeline APIs. This timestamp is used
   /// to log a timeline event that tracks the latency of engine startup.
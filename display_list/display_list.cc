@@ -5,10 +5,9 @@
 #include <type_traits>
 
 #include "flutter/display_list/display_list.h"
-#include "flutter/display_list/display_list_canvas_dispatcher.h"
+#include "flutter/display_list/display_list_builder.h"
 #include "flutter/display_list/display_list_ops.h"
-#include "flutter/display_list/display_list_utils.h"
-#include "flutter/fml/trace_event.h"
+#include "flutter/display_list/display_list_static_dispatch.h"
 
 namespace flutter {
 
@@ -22,6 +21,7 @@ DisplayList::DisplayList()
       nested_byte_count_(0),
       nested_op_count_(0),
       unique_id_(0),
+      content_hash_(0),
       bounds_({0, 0, 0, 0}),
       bounds_cull_({0, 0, 0, 0}),
       can_apply_group_opacity_(true) {}
@@ -31,14 +31,19 @@ DisplayList::DisplayList(uint8_t* ptr,
                          unsigned int op_count,
                          size_t nested_byte_count,
                          unsigned int nested_op_count,
+                         uint64_t content_hash,
+                         const SkRect& bounds,
                          const SkRect& cull_rect,
+                         sk_sp<const DlRTree> rtree,
                          bool can_apply_group_opacity)
     : storage_(ptr),
       byte_count_(byte_count),
       op_count_(op_count),
       nested_byte_count_(nested_byte_count),
       nested_op_count_(nested_op_count),
-      bounds_({0, 0, -1, -1}),
+      content_hash_(content_hash),
+      bounds_(bounds),
+      rtree_(std::move(rtree)),
       bounds_cull_(cull_rect),
       can_apply_group_opacity_(can_apply_group_opacity) {
   static std::atomic<uint32_t> nextID{1};
@@ -52,49 +57,29 @@ DisplayList::~DisplayList() {
   DisposeOps(ptr, ptr + byte_count_);
 }
 
-void DisplayList::ComputeBounds() {
-  RectBoundsAccumulator accumulator;
-  DisplayListBoundsCalculator calculator(accumulator, &bounds_cull_);
-  Dispatch(calculator);
-  if (calculator.is_unbounded()) {
-    FML_LOG(INFO) << "returning partial bounds for unbounded DisplayList";
-  }
-  bounds_ = accumulator.bounds();
-}
-
 void DisplayList::ComputeRTree() {
-  RTreeBoundsAccumulator accumulator;
-  DisplayListBoundsCalculator calculator(accumulator, &bounds_cull_);
-  Dispatch(calculator);
-  if (calculator.is_unbounded()) {
-    FML_LOG(INFO) << "returning partial rtree for unbounded DisplayList";
-  }
-  rtree_ = accumulator.rtree();
+  // Recording the ops again associates the rects of the RTree with the
+  // indices of their rendering ops in the same way as a prepared RTree.
+  DisplayListBuilder builder(bounds_cull_, true);
+  StaticDispatch(builder);
+  rtree_ = builder.Build()->rtree_;
 }
 
-void DisplayList::Dispatch(Dispatcher& dispatcher,
-                           uint8_t* ptr,
-                           uint8_t* end) const {
-  TRACE_EVENT0("flutter", "DisplayList::Dispatch");
-  while (ptr < end) {
-    auto op = reinterpret_cast<const DLOp*>(ptr);
-    ptr += op->size;
-    FML_DCHECK(ptr <= end);
-    switch (op->type) {
-#define DL_OP_DISPATCH(name)                                \
-  case DisplayListOpType::k##name:                          \
-    static_cast<const name##Op*>(op)->dispatch(dispatcher); \
-    break;
-
-      FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPATCH)
+void DisplayList::Dispatch(Dispatcher& ctx) const {
+  StaticDispatch(ctx);
+}
 
-#undef DL_OP_DISPATCH
+void DisplayList::Dispatch(Dispatcher& ctx, const SkRect& cull_rect) const {
+  StaticDispatch(ctx, cull_rect);
+}
 
-      default:
-        FML_DCHECK(false);
-        return;
-    }
+bool DisplayList::GetCulledRenderOps(const SkRect& cull_rect,
+                                     std::vector<int>& render_ops) const {
+  if (!rtree_ || cull_rect.contains(bounds_)) {
+    return false;
   }
+  render_ops = rtree_->searchRenderOps(cull_rect);
+  return true;
 }
 
 void DisplayList::DisposeOps(uint8_t* ptr, uint8_t* end) {
@@ -193,19 +178,15 @@ void DisplayList::RenderTo(DisplayListBuilder* builder,
   if (!builder) {
     return;
   }
-  Dispatch(*builder);
-}
-
-void DisplayList::RenderTo(SkCanvas* canvas, SkScalar opacity) const {
-  DisplayListCanvasDispatcher dispatcher(canvas, opacity);
-  Dispatch(dispatcher);
+  StaticDispatch(*builder);
 }
 
 bool DisplayList::Equals(const DisplayList* other) const {
   if (this == other) {
     return true;
   }
-  if (byte_count_ != other->byte_count_ || op_count_ != other->op_count_) {
+  if (byte_count_ != other->byte_count_ || op_count_ != other->op_count_ ||
+      content_hash_ != other->content_hash_) {
     return false;
   }
   uint8_t* ptr = storage_.get();
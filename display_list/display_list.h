@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "flutter/display_list/display_list_rtree.h"
 #include "flutter/display_list/display_list_sampling_options.h"
@@ -38,6 +39,10 @@
 //                       Any class implementing Dispatcher can inherit from
 //                       these utility classes to simplify its creation
 //
+// display_list_bounds_accumulator.h: classes that accumulate the bounds of
+//                                    rendering operations into a single
+//                                    rectangle or into the rects of an RTree
+//
 // The Flutter DisplayList mechanism can be used in place of the Skia
 // SkPicture mechanism. The primary means of communication into and out
 // of the DisplayList is through the Dispatcher virtual class which
@@ -161,6 +166,12 @@ namespace flutter {
 enum class DisplayListOpType { FOR_EACH_DISPLAY_LIST_OP(DL_OP_TO_ENUM_VALUE) };
 #undef DL_OP_TO_ENUM_VALUE
 
+// The rendering ops are listed last. All other ops only change the state
+// (attributes, layers, transforms and clips) used by the rendering ops.
+constexpr bool IsRenderingOp(DisplayListOpType type) {
+  return type >= DisplayListOpType::kDrawPaint;
+}
+
 class Dispatcher;
 class DisplayListBuilder;
 
@@ -223,14 +234,35 @@ class DisplayList : public SkRefCnt {
 
   ~DisplayList();
 
-  void Dispatch(Dispatcher& ctx) const {
-    uint8_t* ptr = storage_.get();
-    Dispatch(ctx, ptr, ptr + byte_count_);
-  }
+  void Dispatch(Dispatcher& ctx) const;
+
+  // Dispatches all of the state ops, but only those rendering ops whose
+  // bounds intersect the |cull_rect|, which is specified in the coordinate
+  // space of the DisplayList.
+  //
+  // The rendering ops are found using the RTree, so every op is dispatched
+  // if the RTree was neither prepared by the |DisplayListBuilder| nor
+  // computed by an earlier call to |rtree()|.
+  void Dispatch(Dispatcher& ctx, const SkRect& cull_rect) const;
+
+  // Equivalent to |Dispatch|, but the ops call the methods of the concrete
+  // dispatcher type |T| directly instead of through the virtual methods of
+  // the |Dispatcher| interface. If |T| is a final class the calls are not
+  // virtual and the op handlers that are visible to the compiler can be
+  // inlined into the dispatch loop.
+  //
+  // These are templates that are defined in display_list_static_dispatch.h,
+  // which must be included wherever they are used.
+  template <typename T>
+  void StaticDispatch(T& dispatcher) const;
+  template <typename T>
+  void StaticDispatch(T& dispatcher, const SkRect& cull_rect) const;
 
   void RenderTo(DisplayListBuilder* builder,
                 SkScalar opacity = SK_Scalar1) const;
 
+  // Only the ops that intersect the clip of the |canvas| are rendered, see
+  // |Dispatch(Dispatcher&, const SkRect&)|.
   void RenderTo(SkCanvas* canvas, SkScalar opacity = SK_Scalar1) const;
 
   // SkPicture always includes nested bytes, but nested ops are
@@ -247,15 +279,19 @@ class DisplayList : public SkRefCnt {
 
   uint32_t unique_id() const { return unique_id_; }
 
-  const SkRect& bounds() {
-    if (bounds_.width() < 0.0) {
-      // ComputeBounds() will leave the variable with a
-      // non-negative width and height
-      ComputeBounds();
-    }
-    return bounds_;
-  }
+  // A hash of the recorded operations that is computed by the
+  // |DisplayListBuilder| while they are recorded. DisplayLists that are
+  // |Equals| always have the same hash, so DisplayLists with different
+  // hashes can be known to differ without comparing their operations.
+  // The converse does not hold, a matching hash is not proof of equality.
+  uint64_t content_hash() const { return content_hash_; }
+
+  // The bounds are computed by the |DisplayListBuilder| while the
+  // operations are recorded.
+  const SkRect& bounds() { return bounds_; }
 
+  // The RTree is prepared by the |DisplayListBuilder| if it was asked to
+  // do so, otherwise it is computed on first use.
   sk_sp<const DlRTree> rtree() {
     if (!rtree_) {
       ComputeRTree();
@@ -279,7 +315,10 @@ class DisplayList : public SkRefCnt {
               unsigned int op_count,
               size_t nested_byte_count,
               unsigned int nested_op_count,
+              uint64_t content_hash,
+              const SkRect& bounds,
               const SkRect& cull_rect,
+              sk_sp<const DlRTree> rtree,
               bool can_apply_group_opacity);
 
   std::unique_ptr<uint8_t, SkFunctionWrapper<void(void*), sk_free>> storage_;
@@ -290,17 +329,31 @@ class DisplayList : public SkRefCnt {
   unsigned int nested_op_count_;
 
   uint32_t unique_id_;
+  uint64_t content_hash_;
   SkRect bounds_;
   sk_sp<const DlRTree> rtree_;
 
-  // Only used for drawPaint() and drawColor()
+  // Only used for drawPaint() and drawColor() when computing the RTree
   SkRect bounds_cull_;
 
   bool can_apply_group_opacity_;
 
-  void ComputeBounds();
   void ComputeRTree();
-  void Dispatch(Dispatcher& ctx, uint8_t* ptr, uint8_t* end) const;
+
+  // Returns false if every op intersects the |cull_rect| or if there is no
+  // RTree to find the ones that do. Otherwise fills |render_ops| with the
+  // sorted indices of the rendering ops that intersect it.
+  bool GetCulledRenderOps(const SkRect& cull_rect,
+                          std::vector<int>& render_ops) const;
+
+  // Dispatches the ops between |ptr| and |end|. If |render_ops| is not
+  // null, only the rendering ops with an index in the sorted |render_ops|
+  // are dispatched.
+  template <typename T>
+  void DispatchOps(T& dispatcher,
+                   uint8_t* ptr,
+                   uint8_t* end,
+                   const std::vector<int>* render_ops) const;
 
   friend class DisplayListBuilder;
 };
@@ -4,10 +4,16 @@
 
 #include "flutter/display_list/display_list_benchmarks.h"
 #include "flutter/display_list/display_list_builder.h"
+#include "flutter/display_list/display_list_canvas_dispatcher.h"
+#include "flutter/display_list/display_list_complexity_gl.h"
+#include "flutter/display_list/display_list_complexity_metal.h"
 #include "flutter/display_list/display_list_flags.h"
+#include "flutter/display_list/display_list_static_dispatch.h"
+#include "flutter/display_list/display_list_utils.h"
 
 #include "third_party/skia/include/core/SkPoint.h"
 #include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
 
 namespace flutter {
 namespace testing {
@@ -1328,5 +1334,294 @@ void BM_SaveLayer(benchmark::State& state,
   canvas_provider->Snapshot(filename);
 }
 
+// Draws a vertical list of `state.range(0)` rows that is scrolled to its
+// middle, so only the rows that fit on the canvas are visible. With
+// `prepare_rtree` the DisplayList only dispatches the visible rows.
+void BM_DrawLongList(benchmark::State& state,
+                     BackendType backend_type,
+                     unsigned attributes,
+                     bool prepare_rtree) {
+  auto canvas_provider = CreateCanvasProvider(backend_type);
+  const size_t rows = state.range(0);
+  const SkScalar row_height = 32;
+  const SkScalar width = kFixedCanvasSize;
+  DisplayListBuilder builder(SkRect::MakeWH(width, rows * row_height),
+                             prepare_rtree);
+  builder.setAttributesFromPaint(GetPaintForRun(attributes),
+                                 DisplayListOpFlags::kDrawRRectFlags);
+  AnnotateAttributes(attributes, state, DisplayListOpFlags::kDrawRRectFlags);
+
+  canvas_provider->InitializeSurface(kFixedCanvasSize, kFixedCanvasSize);
+  auto canvas = canvas_provider->GetSurface()->getCanvas();
+
+  state.counters["DrawCallCount"] = rows * 3;
+  for (size_t i = 0; i < rows; i++) {
+    SkRect row = SkRect::MakeXYWH(0, i * row_height, width, row_height);
+    builder.drawRRect(SkRRect::MakeRectXY(row.makeInset(2, 2), 4, 4));
+    builder.drawRect(SkRect::MakeXYWH(8, row.fTop + 8, 16, 16));
+    builder.drawLine({32, row.centerY()}, {width - 8, row.centerY()});
+  }
+  auto display_list = builder.Build();
+  const SkScalar scroll_offset = (rows * row_height - kFixedCanvasSize) / 2;
+
+  // We only want to time the actual rasterization.
+  for ([[maybe_unused]] auto _ : state) {
+    SkAutoCanvasRestore restore(canvas, true);
+    canvas->translate(0, -scroll_offset);
+    display_list->RenderTo(canvas);
+    canvas_provider->GetSurface()->flushAndSubmit(true);
+  }
+
+  auto filename = canvas_provider->BackendName() + "-DrawLongList-" +
+                  (prepare_rtree ? "RTree-" : "") +
+                  std::to_string(state.range(0)) + ".png";
+  canvas_provider->Snapshot(filename);
+}
+
+namespace {
+
+enum class BoundsMode {
+  // Bounds are accumulated by the builder while recording.
+  kBuilder,
+  // Bounds and the RTree are accumulated by the builder while recording.
+  kBuilderWithRTree,
+  // Bounds are computed by dispatching the finished DisplayList through a
+  // DisplayListBoundsCalculator, as DisplayList::bounds() used to.
+  kDispatched,
+  // The RTree is computed by dispatching the finished DisplayList through a
+  // DisplayListBoundsCalculator, as DisplayList::rtree() used to.
+  kDispatchedRTree,
+};
+
+// Records |count| overlapping rects with the draw pattern of BM_DrawRect and a
+// translated save layer every 16 rects so the bounds accumulation has to map
+// through transforms and layers.
+void RecordBoundsScene(DisplayListBuilder& builder, size_t count) {
+  const SkScalar canvas_size = kFixedCanvasSize;
+  const SkScalar length = canvas_size / 4;
+  SkRect rect = SkRect::MakeLTRB(0, 0, length, length);
+  for (size_t i = 0; i < count; i++) {
+    if (i % 16 == 0) {
+      if (i > 0) {
+        builder.restore();
+      }
+      builder.saveLayer(nullptr, false);
+      builder.translate(0.5f, 0.5f);
+    }
+    builder.drawRect(rect);
+    rect.offset(0.5f, 0.5f);
+    if (rect.right() > canvas_size) {
+      rect.offset(-canvas_size, 0);
+    }
+    if (rect.bottom() > canvas_size) {
+      rect.offset(0, -canvas_size);
+    }
+  }
+  if (count > 0) {
+    builder.restore();
+  }
+}
+
+}  // namespace
+
+// Measures the cost of recording a DisplayList and making its bounds (and
+// optionally its RTree) available, either by accumulating them while
+// recording or by re-dispatching the finished DisplayList.
+void BM_BuildWithBounds(benchmark::State& state, BoundsMode mode) {
+  const size_t count = state.range(0);
+  const SkRect cull_rect = SkRect::MakeWH(kFixedCanvasSize, kFixedCanvasSize);
+  state.counters["DrawCallCount"] = count;
+  for ([[maybe_unused]] auto _ : state) {
+    DisplayListBuilder builder(cull_rect,
+                               mode == BoundsMode::kBuilderWithRTree);
+    RecordBoundsScene(builder, count);
+    auto display_list = builder.Build();
+    switch (mode) {
+      case BoundsMode::kBuilder:
+        benchmark::DoNotOptimize(display_list->bounds());
+        break;
+      case BoundsMode::kBuilderWithRTree:
+        benchmark::DoNotOptimize(display_list->rtree().get());
+        break;
+      case BoundsMode::kDispatched: {
+        RectBoundsAccumulator accumulator;
+        DisplayListBoundsCalculator calculator(accumulator, &cull_rect);
+        display_list->Dispatch(calculator);
+        benchmark::DoNotOptimize(accumulator.bounds());
+        break;
+      }
+      case BoundsMode::kDispatchedRTree: {
+        RTreeBoundsAccumulator accumulator;
+        DisplayListBoundsCalculator calculator(accumulator, &cull_rect);
+        display_list->Dispatch(calculator);
+        benchmark::DoNotOptimize(accumulator.rtree().get());
+        break;
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK_CAPTURE(BM_BuildWithBounds, Builder, BoundsMode::kBuilder)
+    ->RangeMultiplier(8)
+    ->Range(64, 32768)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BuildWithBounds,
+                  BuilderWithRTree,
+                  BoundsMode::kBuilderWithRTree)
+    ->RangeMultiplier(8)
+    ->Range(64, 32768)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BuildWithBounds, Dispatched, BoundsMode::kDispatched)
+    ->RangeMultiplier(8)
+    ->Range(64, 32768)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BuildWithBounds,
+                  DispatchedRTree,
+                  BoundsMode::kDispatchedRTree)
+    ->RangeMultiplier(8)
+    ->Range(64, 32768)
+    ->Unit(benchmark::kMicrosecond);
+
+namespace {
+
+enum class DispatchMode {
+  // DisplayList::Dispatch, which calls the dispatcher through the virtual
+  // methods of the Dispatcher interface.
+  kVirtual,
+  // DisplayList::StaticDispatch, which is instantiated for the final class
+  // of the dispatcher.
+  kStatic,
+};
+
+// Records a long stream of |count| groups of ops that mixes attribute,
+// transform, clip and rendering ops in roughly the proportions of a
+// recorded frame.
+sk_sp<DisplayList> RecordDispatchScene(size_t count) {
+  DisplayListBuilder builder;
+  const SkScalar canvas_size = kFixedCanvasSize;
+  for (size_t i = 0; i < count; i++) {
+    const SkScalar offset = (i % 64) * canvas_size / 64;
+    builder.save();
+    builder.translate(offset, offset);
+    builder.clipRect(SkRect::MakeWH(canvas_size / 4, canvas_size / 4),
+                     SkClipOp::kIntersect, false);
+    builder.setColor(i % 2 ? SK_ColorRED : SK_ColorBLUE);
+    builder.setStrokeWidth(i % 4);
+    builder.drawRect(SkRect::MakeWH(10, 10));
+    builder.drawLine({0, 0}, {10, 10});
+    builder.drawCircle({5, 5}, 5);
+    builder.restore();
+  }
+  return builder.Build();
+}
+
+template <typename T>
+void DispatchTo(const DisplayList& display_list,
+                T& dispatcher,
+                DispatchMode mode) {
+  if (mode == DispatchMode::kStatic) {
+    display_list.StaticDispatch(dispatcher);
+  } else {
+    display_list.Dispatch(dispatcher);
+  }
+}
+
+// Reports the time spent per op. The counter is shown in seconds, so a
+// value of 12n is 12 nanoseconds per op.
+void SetTimePerOp(benchmark::State& state, const DisplayList& display_list) {
+  state.counters["TimePerOp"] = benchmark::Counter(
+      display_list.op_count(),
+      benchmark::Counter::kIsIterationInvariantRate |
+          benchmark::Counter::kInvert);
+}
+
+}  // namespace
+
+// The BM_Dispatch* benchmarks measure the cost of replaying a long op
+// stream through each of the concrete dispatchers that are used to replay
+// DisplayLists on hot paths.
+
+// The canvas dispatcher draws into an SkNoDrawCanvas so that the cost of
+// the dispatch and of the SkCanvas state tracking is measured rather than
+// the cost of rasterization.
+void BM_DispatchToCanvas(benchmark::State& state, DispatchMode mode) {
+  auto display_list = RecordDispatchScene(state.range(0));
+  SkNoDrawCanvas canvas(kFixedCanvasSize, kFixedCanvasSize);
+  for ([[maybe_unused]] auto _ : state) {
+    int save_count = canvas.save();
+    DisplayListCanvasDispatcher dispatcher(&canvas);
+    DispatchTo(*display_list, dispatcher, mode);
+    canvas.restoreToCount(save_count);
+  }
+  SetTimePerOp(state, *display_list);
+}
+
+void BM_DispatchToBuilder(benchmark::State& state, DispatchMode mode) {
+  auto display_list = RecordDispatchScene(state.range(0));
+  for ([[maybe_unused]] auto _ : state) {
+    DisplayListBuilder builder;
+    DispatchTo(*display_list, builder, mode);
+    benchmark::DoNotOptimize(builder.Build());
+  }
+  SetTimePerOp(state, *display_list);
+}
+
+void BM_DispatchToBoundsCalculator(benchmark::State& state,
+                                   DispatchMode mode) {
+  auto display_list = RecordDispatchScene(state.range(0));
+  const SkRect cull_rect = SkRect::MakeWH(kFixedCanvasSize, kFixedCanvasSize);
+  for ([[maybe_unused]] auto _ : state) {
+    RectBoundsAccumulator accumulator;
+    DisplayListBoundsCalculator calculator(accumulator, &cull_rect);
+    DispatchTo(*display_list, calculator, mode);
+    benchmark::DoNotOptimize(accumulator.bounds());
+  }
+  SetTimePerOp(state, *display_list);
+}
+
+// The helpers of the complexity calculators are private, so only their
+// statically dispatched |Compute| methods are measured.
+void BM_DispatchToComplexityCalculator(
+    benchmark::State& state,
+    DisplayListComplexityCalculator* calculator) {
+  auto display_list = RecordDispatchScene(state.range(0));
+  for ([[maybe_unused]] auto _ : state) {
+    benchmark::DoNotOptimize(calculator->Compute(display_list.get()));
+  }
+  SetTimePerOp(state, *display_list);
+}
+
+#define DISPATCH_BENCHMARKS(DISPATCHER)                 \
+  BENCHMARK_CAPTURE(BM_DispatchTo##DISPATCHER, Virtual, \
+                    DispatchMode::kVirtual)             \
+      ->RangeMultiplier(8)                              \
+      ->Range(1 << 10, 1 << 16)                         \
+      ->Unit(benchmark::kMicrosecond);                  \
+  BENCHMARK_CAPTURE(BM_DispatchTo##DISPATCHER, Static,  \
+                    DispatchMode::kStatic)              \
+      ->RangeMultiplier(8)                              \
+      ->Range(1 << 10, 1 << 16)                         \
+      ->Unit(benchmark::kMicrosecond)
+
+DISPATCH_BENCHMARKS(Canvas);
+DISPATCH_BENCHMARKS(Builder);
+DISPATCH_BENCHMARKS(BoundsCalculator);
+
+#undef DISPATCH_BENCHMARKS
+
+BENCHMARK_CAPTURE(BM_DispatchToComplexityCalculator,
+                  GL,
+                  DisplayListGLComplexityCalculator::GetInstance())
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 16)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DispatchToComplexityCalculator,
+                  Metal,
+                  DisplayListMetalComplexityCalculator::GetInstance())
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 16)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace testing
 }  // namespace flutter
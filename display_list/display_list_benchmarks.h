@@ -107,6 +107,10 @@ void BM_SaveLayer(benchmark::State& state,
                   BackendType backend_type,
                   unsigned attributes,
                   size_t save_depth);
+void BM_DrawLongList(benchmark::State& state,
+                     BackendType backend_type,
+                     unsigned attributes,
+                     bool prepare_rtree);
 // clang-format off
 
 // DrawLine
@@ -544,6 +548,26 @@ void BM_SaveLayer(benchmark::State& state,
       ->UseRealTime()                                                   \
       ->Unit(benchmark::kMillisecond);
 
+// DrawLongList
+#define DRAW_LONG_LIST_BENCHMARKS(BACKEND, ATTRIBUTES)                  \
+  BENCHMARK_CAPTURE(BM_DrawLongList, BACKEND,                           \
+                    BackendType::k##BACKEND##_Backend,                  \
+                    ATTRIBUTES,                                         \
+                    false)                                              \
+      ->RangeMultiplier(4)                                              \
+      ->Range(256, 65536)                                               \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMillisecond);                                  \
+                                                                        \
+  BENCHMARK_CAPTURE(BM_DrawLongList, RTree/BACKEND,                     \
+                    BackendType::k##BACKEND##_Backend,                  \
+                    ATTRIBUTES,                                         \
+                    true)                                               \
+      ->RangeMultiplier(4)                                              \
+      ->Range(256, 65536)                                               \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMillisecond);
+
 // Applies stroke style and antialiasing
 #define STROKE_BENCHMARKS(BACKEND, ATTRIBUTES)                           \
   DRAW_LINE_BENCHMARKS(BACKEND, ATTRIBUTES)                              \
@@ -578,7 +602,8 @@ void BM_SaveLayer(benchmark::State& state,
   DRAW_IMAGE_NINE_BENCHMARKS(BACKEND, ATTRIBUTES)                        \
   DRAW_VERTICES_BENCHMARKS(BACKEND, ATTRIBUTES)                          \
   DRAW_SHADOW_BENCHMARKS(BACKEND, ATTRIBUTES)                            \
-  SAVE_LAYER_BENCHMARKS(BACKEND, ATTRIBUTES)
+  SAVE_LAYER_BENCHMARKS(BACKEND, ATTRIBUTES)                             \
+  DRAW_LONG_LIST_BENCHMARKS(BACKEND, ATTRIBUTES)
 
 #define RUN_DISPLAYLIST_BENCHMARKS(BACKEND)                              \
   STROKE_BENCHMARKS(BACKEND, kStrokedStyle_Flag)                         \
@@ -0,0 +1,140 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_bounds_accumulator.h"
+
+#include <limits>
+
+namespace flutter {
+
+void RectBoundsAccumulator::accumulate(const SkRect& r) {
+  if (r.fLeft < r.fRight && r.fTop < r.fBottom) {
+    rect_.accumulate(r.fLeft, r.fTop);
+    rect_.accumulate(r.fRight, r.fBottom);
+  }
+}
+
+void RectBoundsAccumulator::save() {
+  saved_rects_.emplace_back(rect_);
+  rect_ = AccumulationRect();
+}
+void RectBoundsAccumulator::restore() {
+  if (!saved_rects_.empty()) {
+    SkRect layer_bounds = rect_.bounds();
+    pop_and_accumulate(layer_bounds, nullptr);
+  }
+}
+bool RectBoundsAccumulator::restore(
+    std::function<bool(const SkRect&, SkRect&)> mapper,
+    const SkRect* clip) {
+  bool success = true;
+  if (!saved_rects_.empty()) {
+    SkRect layer_bounds = rect_.bounds();
+    success = mapper(layer_bounds, layer_bounds);
+    pop_and_accumulate(layer_bounds, clip);
+  }
+  return success;
+}
+void RectBoundsAccumulator::pop_and_accumulate(SkRect& layer_bounds,
+                                               const SkRect* clip) {
+  FML_DCHECK(!saved_rects_.empty());
+
+  rect_ = saved_rects_.back();
+  saved_rects_.pop_back();
+
+  if (clip == nullptr || layer_bounds.intersect(*clip)) {
+    accumulate(layer_bounds);
+  }
+}
+
+RectBoundsAccumulator::AccumulationRect::AccumulationRect() {
+  min_x_ = std::numeric_limits<SkScalar>::infinity();
+  min_y_ = std::numeric_limits<SkScalar>::infinity();
+  max_x_ = -std::numeric_limits<SkScalar>::infinity();
+  max_y_ = -std::numeric_limits<SkScalar>::infinity();
+}
+void RectBoundsAccumulator::AccumulationRect::accumulate(SkScalar x,
+                                                         SkScalar y) {
+  if (min_x_ > x) {
+    min_x_ = x;
+  }
+  if (min_y_ > y) {
+    min_y_ = y;
+  }
+  if (max_x_ < x) {
+    max_x_ = x;
+  }
+  if (max_y_ < y) {
+    max_y_ = y;
+  }
+}
+SkRect RectBoundsAccumulator::AccumulationRect::bounds() const {
+  return (max_x_ >= min_x_ && max_y_ >= min_y_)
+             ? SkRect::MakeLTRB(min_x_, min_y_, max_x_, max_y_)
+             : SkRect::MakeEmpty();
+}
+
+void RTreeBoundsAccumulator::accumulate(const SkRect& r,
+                                        int render_op_index) {
+  if (r.fLeft < r.fRight && r.fTop < r.fBottom) {
+    rects_.push_back(r);
+    render_op_indices_.push_back(render_op_index);
+  }
+}
+bool RTreeBoundsAccumulator::is_empty() const {
+  return rects_.empty();
+}
+bool RTreeBoundsAccumulator::is_not_empty() const {
+  return !rects_.empty();
+}
+void RTreeBoundsAccumulator::save() {
+  saved_offsets_.push_back(rects_.size());
+}
+void RTreeBoundsAccumulator::restore() {
+  if (saved_offsets_.empty()) {
+    return;
+  }
+
+  saved_offsets_.pop_back();
+}
+bool RTreeBoundsAccumulator::restore(
+    std::function<bool(const SkRect& original, SkRect& modified)> map,
+    const SkRect* clip) {
+  if (saved_offsets_.empty()) {
+    return true;
+  }
+
+  size_t previous_size = saved_offsets_.back();
+  saved_offsets_.pop_back();
+
+  bool success = true;
+  for (size_t i = previous_size; i < rects_.size(); i++) {
+    SkRect original = rects_[i];
+    if (!map(original, original)) {
+      success = false;
+      // The op may affect any pixel of the layer, so it must at least be
+      // found when searching for any part of the clip.
+      if (clip != nullptr) {
+        original = *clip;
+      }
+    }
+    if (clip == nullptr || original.intersect(*clip)) {
+      render_op_indices_[previous_size] = render_op_indices_[i];
+      rects_[previous_size++] = original;
+    }
+  }
+  rects_.resize(previous_size);
+  render_op_indices_.resize(previous_size);
+  return success;
+}
+sk_sp<DlRTree> RTreeBoundsAccumulator::rtree() const {
+  FML_DCHECK(saved_offsets_.empty());
+  DlRTreeFactory factory;
+  sk_sp<DlRTree> rtree = factory.getInstance();
+  rtree->insertRenderOps(rects_.data(), render_op_indices_.data(),
+                         rects_.size());
+  return rtree;
+}
+
+}  // namespace flutter
@@ -5,7 +5,9 @@
 #include "flutter/display_list/display_list_builder.h"
 
 #include "flutter/display_list/display_list_blend_mode.h"
+#include "flutter/display_list/display_list_canvas_dispatcher.h"
 #include "flutter/display_list/display_list_ops.h"
+#include "flutter/display_list/display_list_utils.h"
 
 namespace flutter {
 
@@ -25,6 +27,7 @@ static void CopyV(void* dst, const S* src, int n, Rest&&... rest) {
 
 template <typename T, typename... Args>
 void* DisplayListBuilder::Push(size_t pod, int op_inc, Args&&... args) {
+  HashPendingOps();
   size_t size = SkAlignPtr(sizeof(T) + pod);
   FML_DCHECK(size < (1 << 24));
   if (used_ + size > allocated_) {
@@ -43,6 +46,7 @@ void* DisplayListBuilder::Push(size_t pod, int op_inc, Args&&... args) {
   op->type = T::kType;
   op->size = size;
   op_count_ += op_inc;
+  current_render_op_ = IsRenderingOp(T::kType) ? render_op_count_++ : -1;
   return op + 1;
 }
 
@@ -50,21 +54,79 @@ sk_sp<DisplayList> DisplayListBuilder::Build() {
   while (layer_stack_.size() > 1) {
     restore();
   }
+  HashPendingOps();
   size_t bytes = used_;
   int count = op_count_;
   size_t nested_bytes = nested_bytes_;
   int nested_count = nested_op_count_;
+  uint64_t content_hash = content_hash_;
   used_ = allocated_ = op_count_ = 0;
   nested_bytes_ = nested_op_count_ = 0;
+  content_hash_ = 0;
+  hashed_bytes_ = 0;
+  render_op_count_ = 0;
+  current_render_op_ = -1;
   storage_.realloc(bytes);
   bool compatible = layer_stack_.back().is_group_opacity_compatible();
-  return sk_sp<DisplayList>(new DisplayList(storage_.release(), bytes, count,
-                                            nested_bytes, nested_count,
-                                            cull_rect_, compatible));
+  SkRect bounds = rect_accumulator_.bounds();
+  sk_sp<const DlRTree> rtree;
+  if (prepare_rtree_) {
+    rtree = rtree_accumulator_.rtree();
+    rtree_accumulator_ = RTreeBoundsAccumulator();
+  }
+  rect_accumulator_ = RectBoundsAccumulator();
+  return sk_sp<DisplayList>(new DisplayList(
+      storage_.release(), bytes, count, nested_bytes, nested_count,
+      content_hash, bounds, cull_rect_, std::move(rtree), compatible));
+}
+
+static uint64_t HashOpContents(const DLOp* op) {
+  switch (op->type) {
+#define DL_OP_HASH(name)           \
+  case DisplayListOpType::k##name: \
+    return static_cast<const name##Op*>(op)->hash();
+
+    FOR_EACH_DISPLAY_LIST_OP(DL_OP_HASH)
+
+#undef DL_OP_HASH
+
+    default:
+      FML_DCHECK(false);
+      return 0;
+  }
+}
+
+static bool IsSaveLayerOp(DisplayListOpType type) {
+  switch (type) {
+    case DisplayListOpType::kSaveLayer:
+    case DisplayListOpType::kSaveLayerBounds:
+    case DisplayListOpType::kSaveLayerBackdrop:
+    case DisplayListOpType::kSaveLayerBackdropBounds:
+      return true;
+    default:
+      return false;
+  }
 }
 
-DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect)
-    : cull_rect_(cull_rect) {
+void DisplayListBuilder::HashPendingOps() {
+  while (hashed_bytes_ < used_) {
+    auto op = reinterpret_cast<const DLOp*>(storage_.get() + hashed_bytes_);
+    if (!IsSaveLayerOp(op->type)) {
+      HashOp(hashed_bytes_);
+    }
+    hashed_bytes_ += op->size;
+  }
+}
+
+void DisplayListBuilder::HashOp(size_t offset) {
+  auto op = reinterpret_cast<const DLOp*>(storage_.get() + offset);
+  uint64_t op_hash = DlHashCombine(offset, static_cast<uint64_t>(op->type));
+  content_hash_ += DlHashCombine(op_hash, HashOpContents(op));
+}
+
+DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect,
+                                       bool prepare_rtree)
+    : cull_rect_(cull_rect), prepare_rtree_(prepare_rtree) {
   layer_stack_.emplace_back(SkM44(), cull_rect);
   current_layer_ = &layer_stack_.back();
 }
@@ -426,6 +488,26 @@ void DisplayListBuilder::restore() {
     layer_stack_.pop_back();
     current_layer_ = &layer_stack_.back();
     Push<RestoreOp>(0, 1);
+    if (layer_info.filter) {
+      // The filter is applied to the contents of the layer in the device
+      // space of the saveLayer() call, which is the current matrix again.
+      auto map = [filter = layer_info.filter.get(),
+                  matrix = current_layer_->matrix.asM33()](
+                     const SkRect& input, SkRect& output) {
+        SkIRect output_bounds;
+        bool ret = filter->map_device_bounds(input.roundOut(), matrix,
+                                             output_bounds);
+        output.set(output_bounds);
+        return ret;
+      };
+      const SkRect& clip = current_layer_->clip_bounds;
+      if (!rect_accumulator_.restore(map, &clip)) {
+        rect_accumulator_.accumulate(clip);
+      }
+      if (prepare_rtree_ && !rtree_accumulator_.restore(map, &clip)) {
+        rtree_accumulator_.accumulate(clip);
+      }
+    }
     if (layer_info.has_layer) {
       if (layer_info.is_group_opacity_compatible()) {
         // We are now going to go back and modify the matching saveLayer
@@ -444,6 +526,7 @@ void DisplayListBuilder::restore() {
             storage_.get() + layer_info.save_layer_offset);
         op->options = op->options.with_can_distribute_opacity();
       }
+      HashOp(layer_info.save_layer_offset);
     } else {
       // For regular save() ops there was no protecting layer so we have to
       // accumulate the values into the enclosing layer.
@@ -476,6 +559,13 @@ void DisplayListBuilder::saveLayer(const SkRect* bounds,
         : Push<SaveLayerOp>(0, 1, options);
   }
   CheckLayerOpacityCompatibility(options.renders_with_attributes());
+  if (options.renders_with_attributes() &&
+      !DisplayListBoundsCalculator::PaintNopsOnTransparency(
+          current_, current_blender_ != nullptr)) {
+    // The layer will fill the clip of the outer layer when it is restored,
+    // but we can just as well accumulate that up front.
+    AccumulateUnbounded();
+  }
   layer_stack_.emplace_back(current_layer_, save_layer_offset, true);
   current_layer_ = &layer_stack_.back();
   if (options.renders_with_attributes()) {
@@ -487,6 +577,23 @@ void DisplayListBuilder::saveLayer(const SkRect* bounds,
         current_.getImageFilter() != nullptr) {
       UpdateLayerOpacityCompatibility(false);
     }
+    current_layer_->filter = current_.getImageFilter();
+    if (current_layer_->filter) {
+      rect_accumulator_.save();
+      if (prepare_rtree_) {
+        rtree_accumulator_.save();
+      }
+    }
+  }
+  // Even though Skia claims that the bounds are only a hint, they actually
+  // use them as the temporary layer bounds during rendering the layer, so
+  // we set them as if a clip operation were performed.
+  if (bounds) {
+    IntersectClipBounds(*bounds, false);
+  }
+  if (backdrop) {
+    // A backdrop will affect up to the entire surface, bounded by the clip
+    AccumulateUnbounded();
   }
 }
 void DisplayListBuilder::saveLayer(const SkRect* bounds,
@@ -602,9 +709,7 @@ void DisplayListBuilder::clipRect(const SkRect& rect,
   switch (clip_op) {
     case SkClipOp::kIntersect:
       Push<ClipIntersectRectOp>(0, 1, rect, is_aa);
-      if (!current_layer_->clip_bounds.intersect(rect)) {
-        current_layer_->clip_bounds.setEmpty();
-      }
+      IntersectClipBounds(rect, is_aa);
       break;
     case SkClipOp::kDifference:
       Push<ClipDifferenceRectOp>(0, 1, rect, is_aa);
@@ -620,9 +725,7 @@ void DisplayListBuilder::clipRRect(const SkRRect& rrect,
     switch (clip_op) {
       case SkClipOp::kIntersect:
         Push<ClipIntersectRRectOp>(0, 1, rrect, is_aa);
-        if (!current_layer_->clip_bounds.intersect(rrect.getBounds())) {
-          current_layer_->clip_bounds.setEmpty();
-        }
+        IntersectClipBounds(rrect.getBounds(), is_aa);
         break;
       case SkClipOp::kDifference:
         Push<ClipDifferenceRRectOp>(0, 1, rrect, is_aa);
@@ -653,15 +756,22 @@ void DisplayListBuilder::clipPath(const SkPath& path,
   switch (clip_op) {
     case SkClipOp::kIntersect:
       Push<ClipIntersectPathOp>(0, 1, path, is_aa);
-      if (!current_layer_->clip_bounds.intersect(path.getBounds())) {
-        current_layer_->clip_bounds.setEmpty();
-      }
+      IntersectClipBounds(path.getBounds(), is_aa);
       break;
     case SkClipOp::kDifference:
       Push<ClipDifferencePathOp>(0, 1, path, is_aa);
       break;
   }
 }
+void DisplayListBuilder::IntersectClipBounds(const SkRect& rect, bool is_aa) {
+  SkRect dev_clip_bounds = current_layer_->matrix.asM33().mapRect(rect);
+  if (is_aa) {
+    dev_clip_bounds.roundOut(&dev_clip_bounds);
+  }
+  if (!current_layer_->clip_bounds.intersect(dev_clip_bounds)) {
+    current_layer_->clip_bounds.setEmpty();
+  }
+}
 SkRect DisplayListBuilder::getLocalClipBounds() {
   SkM44 inverse;
   if (current_layer_->matrix.invert(&inverse)) {
@@ -675,6 +785,7 @@ SkRect DisplayListBuilder::getLocalClipBounds() {
 void DisplayListBuilder::drawPaint() {
   Push<DrawPaintOp>(0, 1);
   CheckLayerOpacityCompatibility();
+  AccumulateUnbounded();
 }
 void DisplayListBuilder::drawPaint(const DlPaint& paint) {
   setAttributesFromDlPaint(paint, DisplayListOpFlags::kDrawPaintFlags);
@@ -683,10 +794,16 @@ void DisplayListBuilder::drawPaint(const DlPaint& paint) {
 void DisplayListBuilder::drawColor(DlColor color, DlBlendMode mode) {
   Push<DrawColorOp>(0, 1, color, mode);
   CheckLayerOpacityCompatibility(mode);
+  AccumulateUnbounded();
 }
 void DisplayListBuilder::drawLine(const SkPoint& p0, const SkPoint& p1) {
   Push<DrawLineOp>(0, 1, p0, p1);
   CheckLayerOpacityCompatibility();
+  SkRect bounds = SkRect::MakeLTRB(p0.fX, p0.fY, p1.fX, p1.fY).makeSorted();
+  DisplayListAttributeFlags flags =
+      (bounds.width() > 0.0f && bounds.height() > 0.0f) ? kDrawLineFlags
+                                                        : kDrawHVLineFlags;
+  AccumulateOpBounds(bounds, flags);
 }
 void DisplayListBuilder::drawLine(const SkPoint& p0,
                                   const SkPoint& p1,
@@ -697,6 +814,7 @@ void DisplayListBuilder::drawLine(const SkPoint& p0,
 void DisplayListBuilder::drawRect(const SkRect& rect) {
   Push<DrawRectOp>(0, 1, rect);
   CheckLayerOpacityCompatibility();
+  AccumulateOpBounds(rect, kDrawRectFlags);
 }
 void DisplayListBuilder::drawRect(const SkRect& rect, const DlPaint& paint) {
   setAttributesFromDlPaint(paint, DisplayListOpFlags::kDrawRectFlags);
@@ -705,6 +823,7 @@ void DisplayListBuilder::drawRect(const SkRect& rect, const DlPaint& paint) {
 void DisplayListBuilder::drawOval(const SkRect& bounds) {
   Push<DrawOvalOp>(0, 1, bounds);
   CheckLayerOpacityCompatibility();
+  AccumulateOpBounds(bounds, kDrawOvalFlags);
 }
 void DisplayListBuilder::drawOval(const SkRect& bounds, const DlPaint& paint) {
   setAttributesFromDlPaint(paint, DisplayListOpFlags::kDrawOvalFlags);
@@ -713,6 +832,9 @@ void DisplayListBuilder::drawOval(const SkRect& bounds, const DlPaint& paint) {
 void DisplayListBuilder::drawCircle(const SkPoint& center, SkScalar radius) {
   Push<DrawCircleOp>(0, 1, center, radius);
   CheckLayerOpacityCompatibility();
+  AccumulateOpBounds(SkRect::MakeLTRB(center.fX - radius, center.fY - radius,
+                                      center.fX + radius, center.fY + radius),
+                     kDrawCircleFlags);
 }
 void DisplayListBuilder::drawCircle(const SkPoint& center,
                                     SkScalar radius,
@@ -728,6 +850,7 @@ void DisplayListBuilder::drawRRect(const SkRRect& rrect) {
   } else {
     Push<DrawRRectOp>(0, 1, rrect);
     CheckLayerOpacityCompatibility();
+    AccumulateOpBounds(rrect.getBounds(), kDrawRRectFlags);
   }
 }
 void DisplayListBuilder::drawRRect(const SkRRect& rrect, const DlPaint& paint) {
@@ -738,6 +861,7 @@ void DisplayListBuilder::drawDRRect(const SkRRect& outer,
                                     const SkRRect& inner) {
   Push<DrawDRRectOp>(0, 1, outer, inner);
   CheckLayerOpacityCompatibility();
+  AccumulateOpBounds(outer.getBounds(), kDrawDRRectFlags);
 }
 void DisplayListBuilder::drawDRRect(const SkRRect& outer,
                                     const SkRRect& inner,
@@ -748,6 +872,11 @@ void DisplayListBuilder::drawDRRect(const SkRRect& outer,
 void DisplayListBuilder::drawPath(const SkPath& path) {
   Push<DrawPathOp>(0, 1, path);
   CheckLayerOpacityHairlineCompatibility();
+  if (path.isInverseFillType()) {
+    AccumulateUnbounded();
+  } else {
+    AccumulateOpBounds(path.getBounds(), kDrawPathFlags);
+  }
 }
 void DisplayListBuilder::drawPath(const SkPath& path, const DlPaint& paint) {
   setAttributesFromDlPaint(paint, DisplayListOpFlags::kDrawPathFlags);
@@ -764,6 +893,13 @@ void DisplayListBuilder::drawArc(const SkRect& bounds,
   } else {
     CheckLayerOpacityCompatibility();
   }
+  // This could be tighter if we compute where the start and end
+  // angles are and then also consider the quadrants swept and
+  // the center if specified.
+  AccumulateOpBounds(bounds,
+                     useCenter  //
+                         ? kDrawArcWithCenterFlags
+                         : kDrawArcNoCenterFlags);
 }
 void DisplayListBuilder::drawArc(const SkRect& bounds,
                                  SkScalar start,
@@ -778,17 +914,21 @@ void DisplayListBuilder::drawPoints(SkCanvas::PointMode mode,
                                     uint32_t count,
                                     const SkPoint pts[]) {
   void* data_ptr;
+  const DisplayListAttributeFlags* flags;
   FML_DCHECK(count < kMaxDrawPointsCount);
   int bytes = count * sizeof(SkPoint);
   switch (mode) {
     case SkCanvas::PointMode::kPoints_PointMode:
       data_ptr = Push<DrawPointsOp>(bytes, 1, count);
+      flags = &kDrawPointsAsPointsFlags;
       break;
     case SkCanvas::PointMode::kLines_PointMode:
       data_ptr = Push<DrawLinesOp>(bytes, 1, count);
+      flags = &kDrawPointsAsLinesFlags;
       break;
     case SkCanvas::PointMode::kPolygon_PointMode:
       data_ptr = Push<DrawPolygonOp>(bytes, 1, count);
+      flags = &kDrawPointsAsPolygonFlags;
       break;
     default:
       FML_DCHECK(false);
@@ -801,6 +941,13 @@ void DisplayListBuilder::drawPoints(SkCanvas::PointMode mode,
   // bounds of every sub-primitive.
   // See: https://fiddle.skia.org/c/228459001d2de8db117ce25ef5cedb0c
   UpdateLayerOpacityCompatibility(false);
+  if (count > 0) {
+    RectBoundsAccumulator point_bounds;
+    for (size_t i = 0; i < count; i++) {
+      point_bounds.accumulate(pts[i]);
+    }
+    AccumulateOpBounds(point_bounds.bounds(), *flags);
+  }
 }
 void DisplayListBuilder::drawPoints(SkCanvas::PointMode mode,
                                     uint32_t count,
@@ -826,7 +973,8 @@ void DisplayListBuilder::drawPoints(SkCanvas::PointMode mode,
 }
 void DisplayListBuilder::drawSkVertices(const sk_sp<SkVertices> vertices,
                                         SkBlendMode mode) {
-  Push<DrawSkVerticesOp>(0, 1, std::move(vertices), mode);
+  Push<DrawSkVerticesOp>(0, 1, vertices, mode);
+  AccumulateOpBounds(vertices->bounds(), kDrawVerticesFlags);
   // DrawVertices applies its colors to the paint so we have no way
   // of controlling opacity using the current paint attributes.
   // Although, examination of the |mode| might find some predictable
@@ -842,6 +990,7 @@ void DisplayListBuilder::drawVertices(const DlVertices* vertices,
   // Although, examination of the |mode| might find some predictable
   // cases.
   UpdateLayerOpacityCompatibility(false);
+  AccumulateOpBounds(vertices->bounds(), kDrawVerticesFlags);
 }
 void DisplayListBuilder::drawVertices(const DlVertices* vertices,
                                       DlBlendMode mode,
@@ -854,10 +1003,16 @@ void DisplayListBuilder::drawImage(const sk_sp<DlImage> image,
                                    const SkPoint point,
                                    DlImageSampling sampling,
                                    bool render_with_attributes) {
+  SkRect bounds = SkRect::MakeXYWH(point.fX, point.fY,  //
+                                   image->width(), image->height());
   render_with_attributes
       ? Push<DrawImageWithAttrOp>(0, 1, std::move(image), point, sampling)
       : Push<DrawImageOp>(0, 1, std::move(image), point, sampling);
   CheckLayerOpacityCompatibility(render_with_attributes);
+  DisplayListAttributeFlags flags = render_with_attributes  //
+                                        ? kDrawImageWithPaintFlags
+                                        : kDrawImageFlags;
+  AccumulateOpBounds(bounds, flags);
 }
 void DisplayListBuilder::drawImage(const sk_sp<DlImage> image,
                                    const SkPoint point,
@@ -880,6 +1035,10 @@ void DisplayListBuilder::drawImageRect(const sk_sp<DlImage> image,
   Push<DrawImageRectOp>(0, 1, std::move(image), src, dst, sampling,
                         render_with_attributes, constraint);
   CheckLayerOpacityCompatibility(render_with_attributes);
+  DisplayListAttributeFlags flags = render_with_attributes
+                                        ? kDrawImageRectWithPaintFlags
+                                        : kDrawImageRectFlags;
+  AccumulateOpBounds(dst, flags);
 }
 void DisplayListBuilder::drawImageRect(const sk_sp<DlImage> image,
                                        const SkRect& src,
@@ -905,6 +1064,10 @@ void DisplayListBuilder::drawImageNine(const sk_sp<DlImage> image,
                                       filter)
       : Push<DrawImageNineOp>(0, 1, std::move(image), center, dst, filter);
   CheckLayerOpacityCompatibility(render_with_attributes);
+  DisplayListAttributeFlags flags = render_with_attributes
+                                        ? kDrawImageNineWithPaintFlags
+                                        : kDrawImageNineFlags;
+  AccumulateOpBounds(dst, flags);
 }
 void DisplayListBuilder::drawImageNine(const sk_sp<DlImage> image,
                                        const SkIRect& center,
@@ -940,6 +1103,10 @@ void DisplayListBuilder::drawImageLattice(const sk_sp<DlImage> image,
   CopyV(pod, lattice.fXDivs, xDivCount, lattice.fYDivs, yDivCount,
         lattice.fColors, cellCount, lattice.fRectTypes, cellCount);
   CheckLayerOpacityCompatibility(render_with_attributes);
+  DisplayListAttributeFlags flags = render_with_attributes
+                                        ? kDrawImageLatticeWithPaintFlags
+                                        : kDrawImageLatticeFlags;
+  AccumulateOpBounds(dst, flags);
 }
 void DisplayListBuilder::drawAtlas(const sk_sp<DlImage> atlas,
                                    const SkRSXform xform[],
@@ -978,6 +1145,22 @@ void DisplayListBuilder::drawAtlas(const sk_sp<DlImage> atlas,
   // on it to distribute the opacity without overlap without checking all
   // of the transforms and texture rectangles.
   UpdateLayerOpacityCompatibility(false);
+
+  SkPoint quad[4];
+  RectBoundsAccumulator atlas_bounds;
+  for (int i = 0; i < count; i++) {
+    const SkRect& src = tex[i];
+    xform[i].toQuad(src.width(), src.height(), quad);
+    for (int j = 0; j < 4; j++) {
+      atlas_bounds.accumulate(quad[j]);
+    }
+  }
+  if (atlas_bounds.is_not_empty()) {
+    DisplayListAttributeFlags flags = render_with_attributes  //
+                                          ? kDrawAtlasWithPaintFlags
+                                          : kDrawAtlasFlags;
+    AccumulateOpBounds(atlas_bounds.bounds(), flags);
+  }
 }
 void DisplayListBuilder::drawAtlas(const sk_sp<DlImage> atlas,
                                    const SkRSXform xform[],
@@ -1002,10 +1185,21 @@ void DisplayListBuilder::drawAtlas(const sk_sp<DlImage> atlas,
 void DisplayListBuilder::drawPicture(const sk_sp<SkPicture> picture,
                                      const SkMatrix* matrix,
                                      bool render_with_attributes) {
+  // The recorded bounds use the cull rect of the picture, as
+  // DisplayListBoundsCalculator::drawPicture does, so that they match the
+  // bounds computed by dispatching the display list.
+  SkRect bounds = picture->cullRect();
+  if (matrix) {
+    matrix->mapRect(&bounds);
+  }
+  DisplayListAttributeFlags flags = render_with_attributes  //
+                                        ? kDrawPictureWithPaintFlags
+                                        : kDrawPictureFlags;
   matrix  //
-      ? Push<DrawSkPictureMatrixOp>(0, 1, std::move(picture), *matrix,
+      ? Push<DrawSkPictureMatrixOp>(0, 1, picture, *matrix,
                                     render_with_attributes)
-      : Push<DrawSkPictureOp>(0, 1, std::move(picture), render_with_attributes);
+      : Push<DrawSkPictureOp>(0, 1, picture, render_with_attributes);
+  AccumulateOpBounds(bounds, flags);
   // The non-nested op count accumulated in the |Push| method will include
   // this call to |drawPicture| for non-nested op count metrics.
   // But, for nested op count metrics we want the |drawPicture| call itself
@@ -1018,7 +1212,8 @@ void DisplayListBuilder::drawPicture(const sk_sp<SkPicture> picture,
 }
 void DisplayListBuilder::drawDisplayList(
     const sk_sp<DisplayList> display_list) {
-  Push<DrawDisplayListOp>(0, 1, std::move(display_list));
+  Push<DrawDisplayListOp>(0, 1, display_list);
+  AccumulateOpBounds(display_list->bounds(), kDrawDisplayListFlags);
   // The non-nested op count accumulated in the |Push| method will include
   // this call to |drawDisplayList| for non-nested op count metrics.
   // But, for nested op count metrics we want the |drawDisplayList| call itself
@@ -1032,7 +1227,8 @@ void DisplayListBuilder::drawDisplayList(
 void DisplayListBuilder::drawTextBlob(const sk_sp<SkTextBlob> blob,
                                       SkScalar x,
                                       SkScalar y) {
-  Push<DrawTextBlobOp>(0, 1, std::move(blob), x, y);
+  Push<DrawTextBlobOp>(0, 1, blob, x, y);
+  AccumulateOpBounds(blob->bounds().makeOffset(x, y), kDrawTextBlobFlags);
   CheckLayerOpacityCompatibility();
 }
 void DisplayListBuilder::drawShadow(const SkPath& path,
@@ -1044,6 +1240,37 @@ void DisplayListBuilder::drawShadow(const SkPath& path,
       ? Push<DrawShadowTransparentOccluderOp>(0, 1, path, color, elevation, dpr)
       : Push<DrawShadowOp>(0, 1, path, color, elevation, dpr);
   UpdateLayerOpacityCompatibility(false);
+  SkRect shadow_bounds = DisplayListCanvasDispatcher::ComputeShadowBounds(
+      path, elevation, dpr, current_layer_->matrix.asM33());
+  AccumulateOpBounds(shadow_bounds, kDrawShadowFlags);
+}
+
+void DisplayListBuilder::AccumulateUnbounded() {
+  // The cull rect always bounds the clip, so there is always a clip to
+  // accumulate here.
+  rect_accumulator_.accumulate(current_layer_->clip_bounds);
+  if (prepare_rtree_) {
+    rtree_accumulator_.accumulate(current_layer_->clip_bounds,
+                                  current_render_op_);
+  }
+}
+void DisplayListBuilder::AccumulateOpBounds(SkRect& bounds,
+                                            DisplayListAttributeFlags flags) {
+  if (DisplayListBoundsCalculator::AdjustBoundsForPaint(bounds, flags,
+                                                        current_)) {
+    AccumulateBounds(bounds);
+  } else {
+    AccumulateUnbounded();
+  }
+}
+void DisplayListBuilder::AccumulateBounds(SkRect& bounds) {
+  current_layer_->matrix.asM33().mapRect(&bounds);
+  if (bounds.intersect(current_layer_->clip_bounds)) {
+    rect_accumulator_.accumulate(bounds);
+    if (prepare_rtree_) {
+      rtree_accumulator_.accumulate(bounds, current_render_op_);
+    }
+  }
 }
 
 }  // namespace flutter
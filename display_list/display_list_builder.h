@@ -7,6 +7,7 @@
 
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_blend_mode.h"
+#include "flutter/display_list/display_list_bounds_accumulator.h"
 #include "flutter/display_list/display_list_comparable.h"
 #include "flutter/display_list/display_list_dispatcher.h"
 #include "flutter/display_list/display_list_flags.h"
@@ -24,11 +25,18 @@ namespace flutter {
 // If there is some code that already renders to an SkCanvas object,
 // those rendering commands can be captured into a DisplayList using
 // the DisplayListCanvasRecorder class.
+//
+// The builder tracks the transform, clip and rendering attributes while
+// the operations are recorded so that the bounds of the DisplayList are
+// known as soon as it is built. If |prepare_rtree| is true then the
+// bounds of the individual operations are also collected into the RTree
+// returned from |DisplayList::rtree()|.
 class DisplayListBuilder final : public virtual Dispatcher,
                                  public SkRefCnt,
                                  DisplayListOpFlags {
  public:
-  explicit DisplayListBuilder(const SkRect& cull_rect = kMaxCullRect_);
+  explicit DisplayListBuilder(const SkRect& cull_rect = kMaxCullRect_,
+                              bool prepare_rtree = false);
 
   ~DisplayListBuilder();
 
@@ -352,13 +360,38 @@ class DisplayListBuilder final : public virtual Dispatcher,
   size_t nested_bytes_ = 0;
   int nested_op_count_ = 0;
 
+  // The sum of the hashes of all ops before |hashed_bytes_|, see
+  // |HashPendingOps|.
+  uint64_t content_hash_ = 0;
+  size_t hashed_bytes_ = 0;
+
   SkRect cull_rect_;
+  bool prepare_rtree_;
+  RectBoundsAccumulator rect_accumulator_;
+  RTreeBoundsAccumulator rtree_accumulator_;
+
+  // The rendering ops are counted so that the rects of the RTree can refer
+  // to them, see |DisplayList::Dispatch(Dispatcher&, const SkRect&)|.
+  // Bounds are always accumulated after the op has been pushed, so they
+  // belong to the most recently pushed op if it is a rendering op.
+  int render_op_count_ = 0;
+  int current_render_op_ = -1;
   static constexpr SkRect kMaxCullRect_ =
       SkRect::MakeLTRB(-1E9F, -1E9F, 1E9F, 1E9F);
 
   template <typename T, typename... Args>
   void* Push(size_t extra, int op_inc, Args&&... args);
 
+  // Folds the ops recorded since the last call into |content_hash_|.
+  // The data following an op is only complete once the next op is pushed,
+  // so this is called from |Push| and |Build| rather than for each op.
+  //
+  // SaveLayer ops are skipped because their options are only final once
+  // the layer is restored. They are folded in by |restore| instead, which
+  // is why the ops are combined with a commutative sum keyed by offset.
+  void HashPendingOps();
+  void HashOp(size_t offset);
+
   void setAttributesFromDlPaint(const DlPaint& paint,
                                 const DisplayListAttributeFlags flags);
 
@@ -403,6 +436,11 @@ class DisplayListBuilder final : public virtual Dispatcher,
     SkM44 matrix;
     SkRect clip_bounds;
 
+    // The image filter that is applied to the contents of this layer when
+    // it is restored, if any. The bounds accumulated since the matching
+    // saveLayer() call are adjusted by this filter on restore().
+    std::shared_ptr<const DlImageFilter> filter;
+
     bool is_group_opacity_compatible() const { return !cannot_inherit_opacity; }
 
     void mark_incompatible() { cannot_inherit_opacity = true; }
@@ -482,6 +520,31 @@ class DisplayListBuilder final : public virtual Dispatcher,
     UpdateLayerOpacityCompatibility(IsOpacityCompatible(mode));
   }
 
+  // Intersects the clip bounds of the current layer with the given
+  // |rect| after transforming it by the current matrix.
+  void IntersectClipBounds(const SkRect& rect, bool is_aa);
+
+  // Records the fact that we encountered an op that either could not
+  // estimate its bounds or that fills all of the destination space.
+  void AccumulateUnbounded();
+
+  // Records the bounds for an op after modifying them according to the
+  // supplied attribute flags and transforming by the current matrix.
+  void AccumulateOpBounds(const SkRect& bounds,
+                          DisplayListAttributeFlags flags) {
+    SkRect safe_bounds = bounds;
+    AccumulateOpBounds(safe_bounds, flags);
+  }
+
+  // Records the bounds for an op after modifying them according to the
+  // supplied attribute flags and transforming by the current matrix
+  // and clipping against the current clip.
+  void AccumulateOpBounds(SkRect& bounds, DisplayListAttributeFlags flags);
+
+  // Records the given bounds after transforming by the current matrix
+  // and clipping against the current clip.
+  void AccumulateBounds(SkRect& bounds);
+
   void onSetAntiAlias(bool aa);
   void onSetDither(bool dither);
   void onSetInvertColors(bool invert);
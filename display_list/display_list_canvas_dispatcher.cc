@@ -5,6 +5,7 @@
 #include "flutter/display_list/display_list_canvas_dispatcher.h"
 
 #include "flutter/display_list/display_list_blend_mode.h"
+#include "flutter/display_list/display_list_static_dispatch.h"
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -327,4 +328,11 @@ void DisplayListCanvasDispatcher::drawShadow(const SkPath& path,
   DrawShadow(canvas_, path, color, elevation, transparent_occluder, dpr);
 }
 
+// Defined here rather than in display_list.cc so that the handlers above
+// can be inlined into the dispatch loop.
+void DisplayList::RenderTo(SkCanvas* canvas, SkScalar opacity) const {
+  DisplayListCanvasDispatcher dispatcher(canvas, opacity);
+  StaticDispatch(dispatcher, canvas->getLocalClipBounds());
+}
+
 }  // namespace flutter
@@ -19,8 +19,8 @@ namespace flutter {
 ///
 /// Receives all methods on Dispatcher and sends them to an SkCanvas
 ///
-class DisplayListCanvasDispatcher : public virtual Dispatcher,
-                                    public SkPaintDispatchHelper {
+class DisplayListCanvasDispatcher final : public virtual Dispatcher,
+                                          public SkPaintDispatchHelper {
  public:
   explicit DisplayListCanvasDispatcher(SkCanvas* canvas,
                                        SkScalar opacity = SK_Scalar1)
@@ -26,7 +26,9 @@ class DisplayListCanvasRecorder
       public SkRefCnt,
       DisplayListOpFlags {
  public:
-  explicit DisplayListCanvasRecorder(const SkRect& bounds);
+  // See |DisplayListBuilder| for a description of |prepare_rtree|.
+  explicit DisplayListCanvasRecorder(const SkRect& bounds,
+                                     bool prepare_rtree = false);
 
   const sk_sp<DisplayListBuilder> builder() { return builder_; }
 
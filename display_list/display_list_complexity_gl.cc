@@ -4,6 +4,8 @@
 
 #include "flutter/display_list/display_list_complexity_gl.h"
 
+#include "flutter/display_list/display_list_static_dispatch.h"
+
 // The numbers and weightings used in this file stem from taking the
 // data from the DisplayListBenchmarks suite run on an Pixel 4 and
 // applying very rough analysis on them to identify the approximate
@@ -25,6 +27,13 @@ DisplayListGLComplexityCalculator::GetInstance() {
   return instance_;
 }
 
+unsigned int DisplayListGLComplexityCalculator::Compute(
+    DisplayList* display_list) {
+  GLHelper helper(ceiling_);
+  display_list->StaticDispatch(helper);
+  return helper.ComplexityScore();
+}
+
 unsigned int DisplayListGLComplexityCalculator::GLHelper::BatchedComplexity() {
   // Calculate the impact of saveLayer.
   unsigned int save_layer_complexity;
@@ -643,7 +652,7 @@ void DisplayListGLComplexityCalculator::GLHelper::drawDisplayList(
     return;
   }
   GLHelper helper(Ceiling() - CurrentComplexityScore());
-  display_list->Dispatch(helper);
+  display_list->StaticDispatch(helper);
   AccumulateComplexity(helper.ComplexityScore());
 }
 
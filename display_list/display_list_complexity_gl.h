@@ -14,11 +14,7 @@ class DisplayListGLComplexityCalculator
  public:
   static DisplayListGLComplexityCalculator* GetInstance();
 
-  unsigned int Compute(DisplayList* display_list) override {
-    GLHelper helper(ceiling_);
-    display_list->Dispatch(helper);
-    return helper.ComplexityScore();
-  }
+  unsigned int Compute(DisplayList* display_list) override;
 
   bool ShouldBeCached(unsigned int complexity_score) override {
     // Set cache threshold at 1ms
@@ -30,7 +26,7 @@ class DisplayListGLComplexityCalculator
   }
 
  private:
-  class GLHelper : public ComplexityCalculatorHelper {
+  class GLHelper final : public ComplexityCalculatorHelper {
    public:
     GLHelper(unsigned int ceiling)
         : ComplexityCalculatorHelper(ceiling),
@@ -4,6 +4,8 @@
 
 #include "flutter/display_list/display_list_complexity_metal.h"
 
+#include "flutter/display_list/display_list_static_dispatch.h"
+
 // The numbers and weightings used in this file stem from taking the
 // data from the DisplayListBenchmarks suite run on an iPhone 12 and
 // applying very rough analysis on them to identify the approximate
@@ -25,6 +27,13 @@ DisplayListMetalComplexityCalculator::GetInstance() {
   return instance_;
 }
 
+unsigned int DisplayListMetalComplexityCalculator::Compute(
+    DisplayList* display_list) {
+  MetalHelper helper(ceiling_);
+  display_list->StaticDispatch(helper);
+  return helper.ComplexityScore();
+}
+
 unsigned int
 DisplayListMetalComplexityCalculator::MetalHelper::BatchedComplexity() {
   // Calculate the impact of saveLayer.
@@ -589,7 +598,7 @@ void DisplayListMetalComplexityCalculator::MetalHelper::drawDisplayList(
     return;
   }
   MetalHelper helper(Ceiling() - CurrentComplexityScore());
-  display_list->Dispatch(helper);
+  display_list->StaticDispatch(helper);
   AccumulateComplexity(helper.ComplexityScore());
 }
 
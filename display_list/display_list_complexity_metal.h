@@ -14,11 +14,7 @@ class DisplayListMetalComplexityCalculator
  public:
   static DisplayListMetalComplexityCalculator* GetInstance();
 
-  unsigned int Compute(DisplayList* display_list) override {
-    MetalHelper helper(ceiling_);
-    display_list->Dispatch(helper);
-    return helper.ComplexityScore();
-  }
+  unsigned int Compute(DisplayList* display_list) override;
 
   bool ShouldBeCached(unsigned int complexity_score) override {
     // Set cache threshold at 1ms
@@ -30,7 +26,7 @@ class DisplayListMetalComplexityCalculator
   }
 
  private:
-  class MetalHelper : public ComplexityCalculatorHelper {
+  class MetalHelper final : public ComplexityCalculatorHelper {
    public:
     MetalHelper(unsigned int ceiling)
         : ComplexityCalculatorHelper(ceiling),
@@ -0,0 +1,83 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_HASH_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_HASH_H_
+
+#include <cstdint>
+#include <cstring>
+
+#include "flutter/display_list/types.h"
+
+namespace flutter {
+
+// These helpers compute the 64-bit hashes that the DisplayListBuilder
+// folds into |DisplayList::content_hash|.
+//
+// The hashes only need to be consistent with the |equals| methods of the
+// ops, i.e. ops that compare equal must hash equal. They are not
+// cryptographically strong and different contents may hash equal, so a
+// matching hash never proves that two DisplayLists are equal.
+
+// Distributes the bits of |value| over the entire hash (the finalizer
+// of the SplitMix64 generator).
+constexpr uint64_t DlHashMix(uint64_t value) {
+  value ^= value >> 30;
+  value *= 0xbf58476d1ce4e5b9u;
+  value ^= value >> 27;
+  value *= 0x94d049bb133111ebu;
+  value ^= value >> 31;
+  return value;
+}
+
+constexpr uint64_t DlHashCombine(uint64_t seed, uint64_t value) {
+  return DlHashMix(seed ^ (value + 0x9e3779b97f4a7c15u));
+}
+
+// Hashes the bytes of a bulk comparable op, 8 bytes at a time.
+inline uint64_t DlHashBytes(const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  uint64_t hash = size;
+  while (size >= sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes, sizeof(word));
+    hash = DlHashCombine(hash, word);
+    bytes += sizeof(word);
+    size -= sizeof(word);
+  }
+  if (size > 0) {
+    uint64_t word = 0;
+    memcpy(&word, bytes, size);
+    hash = DlHashCombine(hash, word);
+  }
+  return hash;
+}
+
+// Scalars are compared with ==, so 0 and -0 must hash equal.
+inline uint64_t DlHashScalar(SkScalar value) {
+  value += 0.0f;
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline uint64_t DlHashRect(const SkRect& rect) {
+  uint64_t hash = DlHashScalar(rect.fLeft);
+  hash = DlHashCombine(hash, DlHashScalar(rect.fTop));
+  hash = DlHashCombine(hash, DlHashScalar(rect.fRight));
+  return DlHashCombine(hash, DlHashScalar(rect.fBottom));
+}
+
+// Summarizes the path rather than hashing all of its points. Equal paths
+// always produce the same summary.
+inline uint64_t DlHashPath(const SkPath& path) {
+  uint64_t hash = static_cast<uint64_t>(path.getFillType());
+  hash = DlHashCombine(hash, path.countVerbs());
+  hash = DlHashCombine(hash, path.countPoints());
+  return DlHashCombine(hash, DlHashRect(path.getBounds()));
+}
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_HASH_H_
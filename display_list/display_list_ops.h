@@ -8,6 +8,7 @@
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_blend_mode.h"
 #include "flutter/display_list/display_list_dispatcher.h"
+#include "flutter/display_list/display_list_hash.h"
 #include "flutter/display_list/display_list_sampling_options.h"
 #include "flutter/display_list/types.h"
 #include "flutter/fml/macros.h"
@@ -24,6 +25,10 @@ namespace flutter {
 //
 // Only a DLOp that wants to do a deep compare needs to override the
 // DLOp::equals() method and return a value of kEqual or kNotEqual.
+//
+// The DLOp::hash() method likewise hashes the bytes of the op and
+// must be overridden together with DLOp::equals() so that ops that
+// compare equal always produce the same hash.
 enum class DisplayListCompare {
   // The Op is deferring comparisons to a bulk memcmp performed lazily
   // across all bulk-comparable ops.
@@ -57,6 +62,8 @@ struct DLOp {
   DisplayListCompare equals(const DLOp* other) const {
     return DisplayListCompare::kUseBulkCompare;
   }
+
+  uint64_t hash() const { return DlHashBytes(this, size); }
 };
 
 // 4 byte header + 4 byte payload packs into minimum 8 bytes
@@ -68,7 +75,8 @@ struct DLOp {
                                                              \
     const bool value;                                        \
                                                              \
-    void dispatch(Dispatcher& dispatcher) const {            \
+    template <typename T>                                    \
+    void dispatch(T& dispatcher) const {                     \
       dispatcher.set##name(value);                           \
     }                                                        \
   };
@@ -86,7 +94,8 @@ DEFINE_SET_BOOL_OP(InvertColors)
                                                                          \
     const DlStroke##name value;                                          \
                                                                          \
-    void dispatch(Dispatcher& dispatcher) const {                        \
+    template <typename T>                                                \
+    void dispatch(T& dispatcher) const {                                 \
       dispatcher.setStroke##name(value);                                 \
     }                                                                    \
   };
@@ -102,7 +111,8 @@ struct SetStyleOp final : DLOp {
 
   const DlDrawStyle style;
 
-  void dispatch(Dispatcher& dispatcher) const { dispatcher.setStyle(style); }
+  template <typename T>
+  void dispatch(T& dispatcher) const { dispatcher.setStyle(style); }
 };
 // 4 byte header + 4 byte payload packs into minimum 8 bytes
 struct SetStrokeWidthOp final : DLOp {
@@ -112,7 +122,8 @@ struct SetStrokeWidthOp final : DLOp {
 
   const float width;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.setStrokeWidth(width);
   }
 };
@@ -124,7 +135,8 @@ struct SetStrokeMiterOp final : DLOp {
 
   const float limit;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.setStrokeMiter(limit);
   }
 };
@@ -137,7 +149,8 @@ struct SetColorOp final : DLOp {
 
   const DlColor color;
 
-  void dispatch(Dispatcher& dispatcher) const { dispatcher.setColor(color); }
+  template <typename T>
+  void dispatch(T& dispatcher) const { dispatcher.setColor(color); }
 };
 // 4 byte header + 4 byte payload packs into minimum 8 bytes
 struct SetBlendModeOp final : DLOp {
@@ -147,7 +160,8 @@ struct SetBlendModeOp final : DLOp {
 
   const DlBlendMode mode;
 
-  void dispatch(Dispatcher& dispatcher) const { dispatcher.setBlendMode(mode); }
+  template <typename T>
+  void dispatch(T& dispatcher) const { dispatcher.setBlendMode(mode); }
 };
 
 // Clear: 4 byte header + unused 4 byte payload uses 8 bytes
@@ -161,7 +175,8 @@ struct SetBlendModeOp final : DLOp {
                                                                                \
     Clear##name##Op() {}                                                       \
                                                                                \
-    void dispatch(Dispatcher& dispatcher) const {                              \
+    template <typename T>                                                      \
+    void dispatch(T& dispatcher) const {                                       \
       dispatcher.set##name(nullptr);                                           \
     }                                                                          \
   };                                                                           \
@@ -172,7 +187,8 @@ struct SetBlendModeOp final : DLOp {
                                                                                \
     sk_sp<Sk##name> field;                                                     \
                                                                                \
-    void dispatch(Dispatcher& dispatcher) const {                              \
+    template <typename T>                                                      \
+    void dispatch(T& dispatcher) const {                                       \
       dispatcher.set##name(field);                                             \
     }                                                                          \
   };
@@ -194,7 +210,8 @@ DEFINE_SET_CLEAR_SKREF_OP(Blender, blender)
                                                                             \
     Clear##name##Op() {}                                                    \
                                                                             \
-    void dispatch(Dispatcher& dispatcher) const {                           \
+    template <typename T>                                                   \
+    void dispatch(T& dispatcher) const {                                    \
       dispatcher.set##name(nullptr);                                        \
     }                                                                       \
   };                                                                        \
@@ -203,7 +220,8 @@ DEFINE_SET_CLEAR_SKREF_OP(Blender, blender)
                                                                             \
     SetPod##name##Op() {}                                                   \
                                                                             \
-    void dispatch(Dispatcher& dispatcher) const {                           \
+    template <typename T>                                                   \
+    void dispatch(T& dispatcher) const {                                    \
       const Dl##name* filter = reinterpret_cast<const Dl##name*>(this + 1); \
       dispatcher.set##name(filter);                                         \
     }                                                                       \
@@ -215,7 +233,8 @@ DEFINE_SET_CLEAR_SKREF_OP(Blender, blender)
                                                                             \
     sk_sp<Sk##sk_name> field;                                               \
                                                                             \
-    void dispatch(Dispatcher& dispatcher) const {                           \
+    template <typename T>                                                   \
+    void dispatch(T& dispatcher) const {                                    \
       DlUnknown##name dl_filter(field);                                     \
       dispatcher.set##name(&dl_filter);                                     \
     }                                                                       \
@@ -241,7 +260,8 @@ struct SetImageColorSourceOp : DLOp {
 
   const DlImageColorSource source;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.setColorSource(&source);
   }
 };
@@ -255,7 +275,8 @@ struct SetSharedImageFilterOp : DLOp {
 
   const std::shared_ptr<DlImageFilter> filter;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.setImageFilter(filter.get());
   }
 
@@ -263,6 +284,8 @@ struct SetSharedImageFilterOp : DLOp {
     return Equals(filter, other->filter) ? DisplayListCompare::kEqual
                                          : DisplayListCompare::kNotEqual;
   }
+
+  uint64_t hash() const { return static_cast<uint64_t>(filter->type()); }
 };
 
 // 4 byte header + no payload uses minimum 8 bytes (4 bytes unused)
@@ -271,7 +294,8 @@ struct SaveOp final : DLOp {
 
   SaveOp() {}
 
-  void dispatch(Dispatcher& dispatcher) const { dispatcher.save(); }
+  template <typename T>
+  void dispatch(T& dispatcher) const { dispatcher.save(); }
 };
 // 4 byte header + 4 byte payload packs into minimum 8 bytes
 struct SaveLayerOp final : DLOp {
@@ -281,8 +305,9 @@ struct SaveLayerOp final : DLOp {
 
   SaveLayerOptions options;
 
-  void dispatch(Dispatcher& dispatcher) const {
-    dispatcher.saveLayer(nullptr, options);
+  template <typename T>
+  void dispatch(T& dispatcher) const {
+    dispatcher.saveLayer(nullptr, options, nullptr);
   }
 };
 // 4 byte header + 20 byte payload packs evenly into 24 bytes
@@ -295,8 +320,9 @@ struct SaveLayerBoundsOp final : DLOp {
   SaveLayerOptions options;
   const SkRect rect;
 
-  void dispatch(Dispatcher& dispatcher) const {
-    dispatcher.saveLayer(&rect, options);
+  template <typename T>
+  void dispatch(T& dispatcher) const {
+    dispatcher.saveLayer(&rect, options, nullptr);
   }
 };
 // 4 byte header + 20 byte payload packs into minimum 24 bytes
@@ -310,7 +336,8 @@ struct SaveLayerBackdropOp final : DLOp {
   SaveLayerOptions options;
   const std::shared_ptr<DlImageFilter> backdrop;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.saveLayer(nullptr, options, backdrop.get());
   }
 
@@ -319,6 +346,12 @@ struct SaveLayerBackdropOp final : DLOp {
                ? DisplayListCompare::kEqual
                : DisplayListCompare::kNotEqual;
   }
+
+  uint64_t hash() const {
+    return DlHashCombine(options.can_distribute_opacity() * 2 +
+                             options.renders_with_attributes(),
+                         static_cast<uint64_t>(backdrop->type()));
+  }
 };
 // 4 byte header + 36 byte payload packs evenly into 36 bytes
 struct SaveLayerBackdropBoundsOp final : DLOp {
@@ -333,7 +366,8 @@ struct SaveLayerBackdropBoundsOp final : DLOp {
   const SkRect rect;
   const std::shared_ptr<DlImageFilter> backdrop;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.saveLayer(&rect, options, backdrop.get());
   }
 
@@ -343,6 +377,13 @@ struct SaveLayerBackdropBoundsOp final : DLOp {
                ? DisplayListCompare::kEqual
                : DisplayListCompare::kNotEqual;
   }
+
+  uint64_t hash() const {
+    uint64_t hash = DlHashCombine(options.can_distribute_opacity() * 2 +
+                                      options.renders_with_attributes(),
+                                  static_cast<uint64_t>(backdrop->type()));
+    return DlHashCombine(hash, DlHashRect(rect));
+  }
 };
 // 4 byte header + no payload uses minimum 8 bytes (4 bytes unused)
 struct RestoreOp final : DLOp {
@@ -350,7 +391,8 @@ struct RestoreOp final : DLOp {
 
   RestoreOp() {}
 
-  void dispatch(Dispatcher& dispatcher) const { dispatcher.restore(); }
+  template <typename T>
+  void dispatch(T& dispatcher) const { dispatcher.restore(); }
 };
 
 // 4 byte header + 8 byte payload uses 12 bytes but is rounded up to 16 bytes
@@ -363,7 +405,8 @@ struct TranslateOp final : DLOp {
   const SkScalar tx;
   const SkScalar ty;
 
-  void dispatch(Dispatcher& dispatcher) const { dispatcher.translate(tx, ty); }
+  template <typename T>
+  void dispatch(T& dispatcher) const { dispatcher.translate(tx, ty); }
 };
 // 4 byte header + 8 byte payload uses 12 bytes but is rounded up to 16 bytes
 // (4 bytes unused)
@@ -375,7 +418,8 @@ struct ScaleOp final : DLOp {
   const SkScalar sx;
   const SkScalar sy;
 
-  void dispatch(Dispatcher& dispatcher) const { dispatcher.scale(sx, sy); }
+  template <typename T>
+  void dispatch(T& dispatcher) const { dispatcher.scale(sx, sy); }
 };
 // 4 byte header + 4 byte payload packs into minimum 8 bytes
 struct RotateOp final : DLOp {
@@ -385,7 +429,8 @@ struct RotateOp final : DLOp {
 
   const SkScalar degrees;
 
-  void dispatch(Dispatcher& dispatcher) const { dispatcher.rotate(degrees); }
+  template <typename T>
+  void dispatch(T& dispatcher) const { dispatcher.rotate(degrees); }
 };
 // 4 byte header + 8 byte payload uses 12 bytes but is rounded up to 16 bytes
 // (4 bytes unused)
@@ -397,7 +442,8 @@ struct SkewOp final : DLOp {
   const SkScalar sx;
   const SkScalar sy;
 
-  void dispatch(Dispatcher& dispatcher) const { dispatcher.skew(sx, sy); }
+  template <typename T>
+  void dispatch(T& dispatcher) const { dispatcher.skew(sx, sy); }
 };
 // 4 byte header + 24 byte payload uses 28 bytes but is rounded up to 32 bytes
 // (4 bytes unused)
@@ -413,7 +459,8 @@ struct Transform2DAffineOp final : DLOp {
   const SkScalar mxx, mxy, mxt;
   const SkScalar myx, myy, myt;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.transform2DAffine(mxx, mxy, mxt,  //
                                  myx, myy, myt);
   }
@@ -440,7 +487,8 @@ struct TransformFullPerspectiveOp final : DLOp {
   const SkScalar mzx, mzy, mzz, mzt;
   const SkScalar mwx, mwy, mwz, mwt;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.transformFullPerspective(mxx, mxy, mxz, mxt,  //
                                         myx, myy, myz, myt,  //
                                         mzx, mzy, mzz, mzt,  //
@@ -454,7 +502,8 @@ struct TransformResetOp final : DLOp {
 
   TransformResetOp() = default;
 
-  void dispatch(Dispatcher& dispatcher) const { dispatcher.transformReset(); }
+  template <typename T>
+  void dispatch(T& dispatcher) const { dispatcher.transformReset(); }
 };
 
 // 4 byte header + 4 byte common payload packs into minimum 8 bytes
@@ -477,7 +526,8 @@ struct TransformResetOp final : DLOp {
     const bool is_aa;                                                      \
     const Sk##shapetype shape;                                             \
                                                                            \
-    void dispatch(Dispatcher& dispatcher) const {                          \
+    template <typename T>                                                  \
+    void dispatch(T& dispatcher) const {                                   \
       dispatcher.clip##shapetype(shape, SkClipOp::k##clipop, is_aa);       \
     }                                                                      \
   };
@@ -487,25 +537,28 @@ DEFINE_CLIP_SHAPE_OP(Rect, Difference)
 DEFINE_CLIP_SHAPE_OP(RRect, Difference)
 #undef DEFINE_CLIP_SHAPE_OP
 
-#define DEFINE_CLIP_PATH_OP(clipop)                                      \
-  struct Clip##clipop##PathOp final : DLOp {                             \
-    static const auto kType = DisplayListOpType::kClip##clipop##Path;    \
-                                                                         \
-    Clip##clipop##PathOp(SkPath path, bool is_aa)                        \
-        : is_aa(is_aa), path(path) {}                                    \
-                                                                         \
-    const bool is_aa;                                                    \
-    const SkPath path;                                                   \
-                                                                         \
-    void dispatch(Dispatcher& dispatcher) const {                        \
-      dispatcher.clipPath(path, SkClipOp::k##clipop, is_aa);             \
-    }                                                                    \
-                                                                         \
-    DisplayListCompare equals(const Clip##clipop##PathOp* other) const { \
-      return is_aa == other->is_aa && path == other->path                \
-                 ? DisplayListCompare::kEqual                            \
-                 : DisplayListCompare::kNotEqual;                        \
-    }                                                                    \
+#define DEFINE_CLIP_PATH_OP(clipop)                                          \
+  struct Clip##clipop##PathOp final : DLOp {                                 \
+    static const auto kType = DisplayListOpType::kClip##clipop##Path;        \
+                                                                             \
+    Clip##clipop##PathOp(SkPath path, bool is_aa)                            \
+        : is_aa(is_aa), path(path) {}                                        \
+                                                                             \
+    const bool is_aa;                                                        \
+    const SkPath path;                                                       \
+                                                                             \
+    template <typename T>                                                    \
+    void dispatch(T& dispatcher) const {                                     \
+      dispatcher.clipPath(path, SkClipOp::k##clipop, is_aa);                 \
+    }                                                                        \
+                                                                             \
+    DisplayListCompare equals(const Clip##clipop##PathOp* other) const {     \
+      return is_aa == other->is_aa && path == other->path                    \
+                 ? DisplayListCompare::kEqual                                \
+                 : DisplayListCompare::kNotEqual;                            \
+    }                                                                        \
+                                                                             \
+    uint64_t hash() const { return DlHashCombine(is_aa, DlHashPath(path)); } \
   };
 DEFINE_CLIP_PATH_OP(Intersect)
 DEFINE_CLIP_PATH_OP(Difference)
@@ -517,7 +570,8 @@ struct DrawPaintOp final : DLOp {
 
   DrawPaintOp() {}
 
-  void dispatch(Dispatcher& dispatcher) const { dispatcher.drawPaint(); }
+  template <typename T>
+  void dispatch(T& dispatcher) const { dispatcher.drawPaint(); }
 };
 // 4 byte header + 8 byte payload uses 12 bytes but is rounded up to 16 bytes
 // (4 bytes unused)
@@ -529,7 +583,8 @@ struct DrawColorOp final : DLOp {
   const DlColor color;
   const DlBlendMode mode;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.drawColor(color, mode);
   }
 };
@@ -547,7 +602,8 @@ struct DrawColorOp final : DLOp {
                                                                           \
     const arg_type arg_name;                                              \
                                                                           \
-    void dispatch(Dispatcher& dispatcher) const {                         \
+    template <typename T>                                                 \
+    void dispatch(T& dispatcher) const {                                  \
       dispatcher.draw##op_name(arg_name);                                 \
     }                                                                     \
   };
@@ -565,12 +621,15 @@ struct DrawPathOp final : DLOp {
 
   const SkPath path;
 
-  void dispatch(Dispatcher& dispatcher) const { dispatcher.drawPath(path); }
+  template <typename T>
+  void dispatch(T& dispatcher) const { dispatcher.drawPath(path); }
 
   DisplayListCompare equals(const DrawPathOp* other) const {
     return path == other->path ? DisplayListCompare::kEqual
                                : DisplayListCompare::kNotEqual;
   }
+
+  uint64_t hash() const { return DlHashPath(path); }
 };
 
 // The common data is a 4 byte header with an unused 4 bytes
@@ -589,7 +648,8 @@ struct DrawPathOp final : DLOp {
     const type1 name1;                                           \
     const type2 name2;                                           \
                                                                  \
-    void dispatch(Dispatcher& dispatcher) const {                \
+    template <typename T>                                        \
+    void dispatch(T& dispatcher) const {                         \
       dispatcher.draw##op_name(name1, name2);                    \
     }                                                            \
   };
@@ -610,7 +670,8 @@ struct DrawArcOp final : DLOp {
   const SkScalar sweep;
   const bool center;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.drawArc(bounds, start, sweep, center);
   }
 };
@@ -629,7 +690,8 @@ struct DrawArcOp final : DLOp {
                                                                        \
     const uint32_t count;                                              \
                                                                        \
-    void dispatch(Dispatcher& dispatcher) const {                      \
+    template <typename T>                                              \
+    void dispatch(T& dispatcher) const {                               \
       const SkPoint* pts = reinterpret_cast<const SkPoint*>(this + 1); \
       dispatcher.drawPoints(SkCanvas::PointMode::mode, count, pts);    \
     }                                                                  \
@@ -651,11 +713,36 @@ struct DrawVerticesOp final : DLOp {
 
   DrawVerticesOp(DlBlendMode mode) : mode(mode) {}
 
+  // The copy of the vertices tells backends when it is the last one.
+  ~DrawVerticesOp() { vertices()->~DlVertices(); }
+
   const DlBlendMode mode;
 
-  void dispatch(Dispatcher& dispatcher) const {
-    const DlVertices* vertices = reinterpret_cast<const DlVertices*>(this + 1);
-    dispatcher.drawVertices(vertices, mode);
+  const DlVertices* vertices() const {
+    return reinterpret_cast<const DlVertices*>(this + 1);
+  }
+
+  template <typename T>
+  void dispatch(T& dispatcher) const {
+    dispatcher.drawVertices(vertices(), mode);
+  }
+
+  // The vertices hold a reference to their identity, which differs between
+  // equal vertices, so they are compared by their contents.
+  DisplayListCompare equals(const DrawVerticesOp* other) const {
+    return mode == other->mode && *vertices() == *other->vertices()
+               ? DisplayListCompare::kEqual
+               : DisplayListCompare::kNotEqual;
+  }
+
+  uint64_t hash() const {
+    const DlVertices* vertices = this->vertices();
+    const uint8_t* data =
+        reinterpret_cast<const uint8_t*>(vertices) + sizeof(DlVertices);
+    return DlHashCombine(
+        DlHashCombine(static_cast<uint64_t>(mode),
+                      static_cast<uint64_t>(vertices->mode())),
+        DlHashBytes(data, vertices->size() - sizeof(DlVertices)));
   }
 };
 
@@ -669,7 +756,8 @@ struct DrawSkVerticesOp final : DLOp {
   const SkBlendMode mode;
   const sk_sp<SkVertices> vertices;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.drawSkVertices(vertices, mode);
   }
 };
@@ -689,7 +777,8 @@ struct DrawSkVerticesOp final : DLOp {
     const DlImageSampling sampling;                                    \
     const sk_sp<DlImage> image;                                        \
                                                                        \
-    void dispatch(Dispatcher& dispatcher) const {                      \
+    template <typename T>                                              \
+    void dispatch(T& dispatcher) const {                               \
       dispatcher.drawImage(image, point, sampling, with_attributes);   \
     }                                                                  \
   };
@@ -722,7 +811,8 @@ struct DrawImageRectOp final : DLOp {
   const SkCanvas::SrcRectConstraint constraint;
   const sk_sp<DlImage> image;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.drawImageRect(image, src, dst, sampling, render_with_attributes,
                              constraint);
   }
@@ -744,7 +834,8 @@ struct DrawImageRectOp final : DLOp {
     const DlFilterMode filter;                                                 \
     const sk_sp<DlImage> image;                                                \
                                                                                \
-    void dispatch(Dispatcher& dispatcher) const {                              \
+    template <typename T>                                                      \
+    void dispatch(T& dispatcher) const {                                       \
       dispatcher.drawImageNine(image, center, dst, filter,                     \
                                render_with_attributes);                        \
     }                                                                          \
@@ -783,7 +874,8 @@ struct DrawImageLatticeOp final : DLOp {
   const SkRect dst;
   const sk_sp<DlImage> image;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     const int* xDivs = reinterpret_cast<const int*>(this + 1);
     const int* yDivs = reinterpret_cast<const int*>(xDivs + x_count);
     const SkColor* colors =
@@ -847,7 +939,8 @@ struct DrawAtlasOp final : DrawAtlasBaseOp {
                         has_colors,
                         render_with_attributes) {}
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     const SkRSXform* xform = reinterpret_cast<const SkRSXform*>(this + 1);
     const SkRect* tex = reinterpret_cast<const SkRect*>(xform + count);
     const DlColor* colors =
@@ -882,7 +975,8 @@ struct DrawAtlasCulledOp final : DrawAtlasBaseOp {
 
   const SkRect cull_rect;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     const SkRSXform* xform = reinterpret_cast<const SkRSXform*>(this + 1);
     const SkRect* tex = reinterpret_cast<const SkRect*>(xform + count);
     const DlColor* colors =
@@ -904,7 +998,8 @@ struct DrawSkPictureOp final : DLOp {
   const bool render_with_attributes;
   const sk_sp<SkPicture> picture;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.drawPicture(picture, nullptr, render_with_attributes);
   }
 };
@@ -924,7 +1019,8 @@ struct DrawSkPictureMatrixOp final : DLOp {
   const sk_sp<SkPicture> picture;
   const SkMatrix matrix;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.drawPicture(picture, &matrix, render_with_attributes);
   }
 };
@@ -939,7 +1035,8 @@ struct DrawDisplayListOp final : DLOp {
 
   sk_sp<DisplayList> display_list;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.drawDisplayList(display_list);
   }
 
@@ -948,6 +1045,8 @@ struct DrawDisplayListOp final : DLOp {
                ? DisplayListCompare::kEqual
                : DisplayListCompare::kNotEqual;
   }
+
+  uint64_t hash() const { return display_list->content_hash(); }
 };
 
 // 4 byte header + 8 payload bytes + an aligned pointer take 24 bytes
@@ -962,7 +1061,8 @@ struct DrawTextBlobOp final : DLOp {
   const SkScalar y;
   const sk_sp<SkTextBlob> blob;
 
-  void dispatch(Dispatcher& dispatcher) const {
+  template <typename T>
+  void dispatch(T& dispatcher) const {
     dispatcher.drawTextBlob(blob, x, y);
   }
 };
@@ -983,7 +1083,8 @@ struct DrawTextBlobOp final : DLOp {
     const SkScalar dpr;                                                   \
     const SkPath path;                                                    \
                                                                           \
-    void dispatch(Dispatcher& dispatcher) const {                         \
+    template <typename T>                                                 \
+    void dispatch(T& dispatcher) const {                                  \
       dispatcher.drawShadow(path, color, elevation, transparent_occluder, \
                             dpr);                                         \
     }                                                                     \
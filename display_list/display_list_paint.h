@@ -209,6 +209,10 @@ class DlPaint {
     pathEffect_ = pathEffect;
     return *this;
   }
+  DlPaint& setPathEffect(const DlPathEffect* effect) {
+    pathEffect_ = effect ? effect->shared() : nullptr;
+    return *this;
+  }
 
   bool operator==(DlPaint const& other) const;
   bool operator!=(DlPaint const& other) const { return !(*this == other); }
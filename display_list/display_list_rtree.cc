@@ -4,6 +4,8 @@
 
 #include "flutter/display_list/display_list_rtree.h"
 
+#include <algorithm>
+
 #include "flutter/fml/logging.h"
 
 namespace flutter {
@@ -27,10 +29,39 @@ void DlRTree::insert(const SkRect boundsArray[], int N) {
   insert(boundsArray, nullptr, N);
 }
 
+void DlRTree::insertRenderOps(const SkRect boundsArray[],
+                              const int render_op_indices[],
+                              int N) {
+  insert(boundsArray, N);
+  render_op_indices_.assign(render_op_indices, render_op_indices + N);
+  has_render_op_indices_ = true;
+}
+
 void DlRTree::search(const SkRect& query, std::vector<int>* results) const {
   bbh_->search(query, results);
 }
 
+std::vector<int> DlRTree::searchRenderOps(const SkRect& query) const {
+  FML_DCHECK(has_render_op_indices_);
+  std::vector<int> results;
+  search(query, &results);
+
+  std::vector<int> render_ops;
+  render_ops.reserve(results.size());
+  for (int index : results) {
+    int render_op = render_op_indices_[index];
+    if (render_op >= 0) {
+      render_ops.push_back(render_op);
+    }
+  }
+  // The search returns the rects in the order of the tree rather than in
+  // the order of the operations.
+  std::sort(render_ops.begin(), render_ops.end());
+  render_ops.erase(std::unique(render_ops.begin(), render_ops.end()),
+                   render_ops.end());
+  return render_ops;
+}
+
 std::list<SkRect> DlRTree::searchNonOverlappingDrawnRects(
     const SkRect& query) const {
   // Get the indexes for the operations that intersect with the query rect.
@@ -7,6 +7,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #include "third_party/skia/include/core/SkBBHFactory.h"
 #include "third_party/skia/include/core/SkRect.h"
@@ -29,7 +30,20 @@ class DlRTree : public SkBBoxHierarchy {
               const SkBBoxHierarchy::Metadata[],
               int N) override;
   void insert(const SkRect[], int N) override;
+
+  // Inserts the rects along with the index of the rendering operation that
+  // each of them was accumulated for, as returned from |searchRenderOps|.
+  // An index of -1 marks a rect that does not belong to a rendering
+  // operation, such as the area filled by a saveLayer.
+  void insertRenderOps(const SkRect[], const int render_op_indices[], int N);
+
   void search(const SkRect& query, std::vector<int>* results) const override;
+
+  // Finds the indices of the rendering operations that have a rect that
+  // intersects with the query rect. The indices are sorted and unique.
+  //
+  // Must only be called if the tree was created with |insertRenderOps|.
+  std::vector<int> searchRenderOps(const SkRect& query) const;
   size_t bytesUsed() const override;
 
   // Finds the rects in the tree that represent drawing operations and intersect
@@ -49,6 +63,8 @@ class DlRTree : public SkBBoxHierarchy {
   std::map<int, SkRect> draw_op_;
   sk_sp<SkBBoxHierarchy> bbh_;
   int all_ops_count_;
+  std::vector<int> render_op_indices_;
+  bool has_render_op_indices_ = false;
 };
 
 class DlRTreeFactory : public SkBBHFactory {
@@ -0,0 +1,84 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_STATIC_DISPATCH_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_STATIC_DISPATCH_H_
+
+#include <vector>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/display_list/display_list_ops.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+// The definitions of the templated dispatch methods of |DisplayList|.
+//
+// The virtual |DisplayList::Dispatch| methods are the instantiation of
+// these templates for the |Dispatcher| interface. The hot dispatchers
+// (the canvas dispatcher, the builder, the bounds and complexity
+// calculators and the Impeller dispatcher) are final classes that use
+// |DisplayList::StaticDispatch| so that every op calls their handlers
+// directly.
+
+namespace flutter {
+
+template <typename T>
+void DisplayList::StaticDispatch(T& dispatcher) const {
+  uint8_t* ptr = storage_.get();
+  DispatchOps(dispatcher, ptr, ptr + byte_count_, nullptr);
+}
+
+template <typename T>
+void DisplayList::StaticDispatch(T& dispatcher,
+                                 const SkRect& cull_rect) const {
+  uint8_t* ptr = storage_.get();
+  std::vector<int> render_ops;
+  if (!GetCulledRenderOps(cull_rect, render_ops)) {
+    DispatchOps(dispatcher, ptr, ptr + byte_count_, nullptr);
+    return;
+  }
+  DispatchOps(dispatcher, ptr, ptr + byte_count_, &render_ops);
+}
+
+template <typename T>
+void DisplayList::DispatchOps(T& dispatcher,
+                              uint8_t* ptr,
+                              uint8_t* end,
+                              const std::vector<int>* render_ops) const {
+  TRACE_EVENT0("flutter", "DisplayList::Dispatch");
+  int render_op_index = 0;
+  size_t next_render_op = 0;
+  while (ptr < end) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    ptr += op->size;
+    FML_DCHECK(ptr <= end);
+    if (render_ops && IsRenderingOp(op->type)) {
+      bool culled = next_render_op == render_ops->size() ||
+                    (*render_ops)[next_render_op] != render_op_index;
+      render_op_index++;
+      if (culled) {
+        continue;
+      }
+      next_render_op++;
+    }
+    switch (op->type) {
+#define DL_OP_DISPATCH(name)                                \
+  case DisplayListOpType::k##name:                          \
+    static_cast<const name##Op*>(op)->dispatch(dispatcher); \
+    break;
+
+      FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPATCH)
+
+#undef DL_OP_DISPATCH
+
+      default:
+        FML_DCHECK(false);
+        return;
+    }
+  }
+}
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_STATIC_DISPATCH_H_
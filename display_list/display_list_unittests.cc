@@ -9,6 +9,7 @@
 #include "flutter/display_list/display_list_builder.h"
 #include "flutter/display_list/display_list_canvas_recorder.h"
 #include "flutter/display_list/display_list_rtree.h"
+#include "flutter/display_list/display_list_static_dispatch.h"
 #include "flutter/display_list/display_list_utils.h"
 #include "flutter/fml/math.h"
 #include "flutter/testing/display_list_testing.h"
@@ -933,12 +934,32 @@ TEST(DisplayList, SingleOpDisplayListsRecapturedAreEqual) {
       ASSERT_EQ(copy->op_count(true), dl->op_count(true)) << desc;
       ASSERT_EQ(copy->bytes(true), dl->bytes(true)) << desc;
       ASSERT_EQ(copy->bounds(), dl->bounds()) << desc;
+      ASSERT_EQ(copy->content_hash(), dl->content_hash()) << desc;
       ASSERT_TRUE(copy->Equals(*dl)) << desc;
       ASSERT_TRUE(dl->Equals(*copy)) << desc;
     }
   }
 }
 
+TEST(DisplayList, SingleOpDisplayListsStaticallyRecapturedAreEqual) {
+  for (auto& group : allGroups) {
+    for (size_t i = 0; i < group.variants.size(); i++) {
+      sk_sp<DisplayList> dl = group.variants[i].Build();
+      // The templated dispatch must replay the same calls as the virtual
+      // dispatch when instantiated for a concrete dispatcher
+      DisplayListBuilder builder;
+      dl->StaticDispatch(builder);
+      sk_sp<DisplayList> copy = builder.Build();
+      auto desc = group.op_name + "(variant " + std::to_string(i + 1) +
+                  " == static copy)";
+      ASSERT_EQ(copy->op_count(true), dl->op_count(true)) << desc;
+      ASSERT_EQ(copy->bytes(true), dl->bytes(true)) << desc;
+      ASSERT_EQ(copy->bounds(), dl->bounds()) << desc;
+      ASSERT_TRUE(copy->Equals(*dl)) << desc;
+    }
+  }
+}
+
 TEST(DisplayList, SingleOpDisplayListsRecapturedViaSkCanvasAreEqual) {
   for (auto& group : allGroups) {
     for (size_t i = 0; i < group.variants.size(); i++) {
@@ -1000,6 +1021,7 @@ TEST(DisplayList, SingleOpDisplayListsCompareToEachOther) {
           ASSERT_EQ(listA->op_count(true), listB->op_count(true)) << desc;
           ASSERT_EQ(listA->bytes(true), listB->bytes(true)) << desc;
           ASSERT_EQ(listA->bounds(), listB->bounds()) << desc;
+          ASSERT_EQ(listA->content_hash(), listB->content_hash()) << desc;
           ASSERT_TRUE(listA->Equals(*listB)) << desc;
           ASSERT_TRUE(listB->Equals(*listA)) << desc;
         } else {
@@ -1013,6 +1035,122 @@ TEST(DisplayList, SingleOpDisplayListsCompareToEachOther) {
   }
 }
 
+static sk_sp<DisplayList> BuildContentHashScene(SkScalar rect_size) {
+  DisplayListBuilder nested_builder;
+  nested_builder.drawRect({0, 0, rect_size, rect_size});
+  sk_sp<DisplayList> nested = nested_builder.Build();
+
+  DisplayListBuilder builder;
+  builder.setColor(SK_ColorBLUE);
+  // The opacity optimization flag of this layer is set on restore.
+  builder.saveLayer(nullptr, true);
+  builder.drawRect({10, 10, 20, 20});
+  builder.restore();
+  DlBlurImageFilter backdrop(2, 2, DlTileMode::kClamp);
+  builder.saveLayer(nullptr, SaveLayerOptions::kNoAttributes, &backdrop);
+  builder.drawPath(SkPath().addOval({0, 0, rect_size, rect_size}));
+  builder.restore();
+  builder.drawPoints(SkCanvas::kLines_PointMode, 2, TestPoints);
+  builder.drawDisplayList(nested);
+  return builder.Build();
+}
+
+TEST(DisplayList, EqualDisplayListsHaveEqualContentHash) {
+  sk_sp<DisplayList> dl1 = BuildContentHashScene(50);
+  sk_sp<DisplayList> dl2 = BuildContentHashScene(50);
+  // The nested display lists are different instances with equal contents.
+  ASSERT_NE(dl1.get(), dl2.get());
+  EXPECT_EQ(dl1->content_hash(), dl2->content_hash());
+  EXPECT_TRUE(dl1->Equals(*dl2));
+}
+
+TEST(DisplayList, DifferentDisplayListsHaveDifferentContentHash) {
+  sk_sp<DisplayList> dl1 = BuildContentHashScene(50);
+  sk_sp<DisplayList> dl2 = BuildContentHashScene(60);
+  EXPECT_EQ(dl1->bytes(), dl2->bytes());
+  EXPECT_EQ(dl1->op_count(), dl2->op_count());
+  EXPECT_NE(dl1->content_hash(), dl2->content_hash());
+  EXPECT_FALSE(dl1->Equals(*dl2));
+
+  DisplayListBuilder builder1;
+  builder1.drawRect({0, 0, 10, 10});
+  builder1.drawRect({0, 0, 20, 20});
+  DisplayListBuilder builder2;
+  builder2.drawRect({0, 0, 20, 20});
+  builder2.drawRect({0, 0, 10, 10});
+  EXPECT_NE(builder1.Build()->content_hash(), builder2.Build()->content_hash());
+}
+
+// Records a scene in which some of the rendering ops are outside of
+// kCullingSceneCullRect. If |skip_culled| is true those ops are left out.
+static const SkRect kCullingSceneCullRect = SkRect::MakeWH(100, 100);
+static void RecordCullingScene(DisplayListBuilder& builder, bool skip_culled) {
+  builder.setColor(SK_ColorRED);
+  builder.drawRect({10, 10, 20, 20});
+  builder.setColor(SK_ColorBLUE);
+  if (!skip_culled) {
+    builder.drawRect({210, 10, 220, 20});
+  }
+  builder.save();
+  builder.translate(200, 0);
+  builder.clipRect({0, 0, 100, 100}, SkClipOp::kIntersect, false);
+  if (!skip_culled) {
+    builder.drawOval({10, 10, 20, 20});
+  }
+  builder.restore();
+  builder.drawCircle({50, 50}, 10);
+  // The rect is outside of the cull rect, but the blur of the layer
+  // spreads it into the cull rect.
+  DlBlurImageFilter blur(20, 20, DlTileMode::kDecal);
+  builder.setImageFilter(&blur);
+  builder.saveLayer(nullptr, true);
+  builder.setImageFilter(nullptr);
+  builder.drawRect({120, 40, 130, 50});
+  builder.restore();
+  if (!skip_culled) {
+    builder.drawRect({300, 300, 310, 310});
+  }
+}
+
+TEST(DisplayList, CulledDispatchSkipsRenderingOpsOutsideCullRect) {
+  DisplayListBuilder builder(SkRect::MakeWH(1000, 1000), true);
+  RecordCullingScene(builder, false);
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  DisplayListBuilder expected_builder;
+  RecordCullingScene(expected_builder, true);
+  sk_sp<DisplayList> expected = expected_builder.Build();
+
+  DisplayListBuilder culled_builder;
+  display_list->Dispatch(culled_builder, kCullingSceneCullRect);
+  sk_sp<DisplayList> culled = culled_builder.Build();
+  EXPECT_EQ(culled->op_count(), display_list->op_count() - 3);
+  EXPECT_TRUE(DisplayListsEQ_Verbose(culled, expected));
+
+  DisplayListBuilder unculled_builder;
+  display_list->Dispatch(unculled_builder, display_list->bounds());
+  EXPECT_TRUE(DisplayListsEQ_Verbose(unculled_builder.Build(), display_list));
+}
+
+TEST(DisplayList, CulledDispatchWithoutRTreeDispatchesAllOps) {
+  DisplayListBuilder builder;
+  RecordCullingScene(builder, false);
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  DisplayListBuilder unculled_builder;
+  display_list->Dispatch(unculled_builder, kCullingSceneCullRect);
+  EXPECT_TRUE(DisplayListsEQ_Verbose(unculled_builder.Build(), display_list));
+
+  // Once the RTree has been computed it is used for culling.
+  ASSERT_NE(display_list->rtree(), nullptr);
+  DisplayListBuilder expected_builder;
+  RecordCullingScene(expected_builder, true);
+  DisplayListBuilder culled_builder;
+  display_list->Dispatch(culled_builder, kCullingSceneCullRect);
+  EXPECT_TRUE(
+      DisplayListsEQ_Verbose(culled_builder.Build(), expected_builder.Build()));
+}
+
 TEST(DisplayList, FullRotationsAreNop) {
   DisplayListBuilder builder;
   builder.rotate(0);
@@ -2450,5 +2588,120 @@ TEST(DisplayList, RTreeOfClippedSaveLayerFilterScene) {
   test_rtree(rtree, {19, 19, 51, 51}, rects, {0, 1});
 }
 
+TEST(DisplayList, ClipBoundsAreTransformedToDestinationSpace) {
+  DisplayListBuilder builder;
+  builder.scale(2, 2);
+  builder.clipRect({10, 10, 20.2, 20.2}, SkClipOp::kIntersect, false);
+  ASSERT_EQ(builder.getDestinationClipBounds(),
+            SkRect::MakeLTRB(20, 20, 40.4, 40.4));
+
+  // Anti-aliased clips are rounded out to cover partial pixels
+  builder.clipRect({10, 10, 20.1, 20.1}, SkClipOp::kIntersect, true);
+  ASSERT_EQ(builder.getDestinationClipBounds(),
+            SkRect::MakeLTRB(20, 20, 40.4, 40.4));
+  builder.clipRect({10.3, 10.3, 30, 30}, SkClipOp::kIntersect, true);
+  ASSERT_EQ(builder.getDestinationClipBounds(),
+            SkRect::MakeLTRB(20, 20, 40.4, 40.4));
+}
+
+TEST(DisplayList, SaveLayerBoundsClipContents) {
+  DisplayListBuilder builder;
+  SkRect layer_bounds = SkRect::MakeLTRB(10, 10, 20, 20);
+  builder.saveLayer(&layer_bounds, false);
+  builder.drawRect({0, 0, 100, 100});
+  builder.restore();
+  builder.drawRect({30, 30, 40, 40});
+  ASSERT_EQ(builder.Build()->bounds(), SkRect::MakeLTRB(10, 10, 40, 40));
+}
+
+// Computes the bounds of a DisplayList by dispatching it through a
+// DisplayListBoundsCalculator after the fact.
+static SkRect ComputeDispatchedBounds(const sk_sp<DisplayList>& display_list,
+                                      const SkRect& cull_rect) {
+  RectBoundsAccumulator accumulator;
+  DisplayListBoundsCalculator calculator(accumulator, &cull_rect);
+  display_list->Dispatch(calculator);
+  return accumulator.bounds();
+}
+
+TEST(DisplayList, BuilderBoundsMatchDispatchedBounds) {
+  const SkRect cull_rect = SkRect::MakeLTRB(-1000, -1000, 1000, 1000);
+  DlBlurImageFilter filter(2.0, 3.0, DlTileMode::kClamp);
+  DlPaint filter_paint = DlPaint().setImageFilter(&filter);
+  for (auto& group : allGroups) {
+    for (size_t i = 0; i < group.variants.size(); i++) {
+      auto& invocation = group.variants[i];
+      auto desc = group.op_name + "(variant " + std::to_string(i + 1) + ")";
+      {
+        DisplayListBuilder builder(cull_rect);
+        invocation.invoker(builder);
+        sk_sp<DisplayList> dl = builder.Build();
+        EXPECT_EQ(dl->bounds(), ComputeDispatchedBounds(dl, cull_rect))
+            << desc;
+      }
+      {
+        DisplayListBuilder builder(cull_rect);
+        builder.translate(5, 7);
+        builder.rotate(30);
+        builder.clipRect({0, 0, 60, 60}, SkClipOp::kIntersect, true);
+        builder.saveLayer(nullptr, &filter_paint);
+        invocation.invoker(builder);
+        builder.restore();
+        sk_sp<DisplayList> dl = builder.Build();
+        EXPECT_EQ(dl->bounds(), ComputeDispatchedBounds(dl, cull_rect))
+            << desc << " (transformed, clipped and filtered)";
+      }
+    }
+  }
+}
+
+TEST(DisplayList, PreparedRTreeMatchesComputedRTree) {
+  const SkRect cull_rect = SkRect::MakeLTRB(0, 0, 200, 200);
+  DlBlurImageFilter filter(1.0, 1.0, DlTileMode::kClamp);
+  DlPaint filter_paint = DlPaint().setImageFilter(&filter);
+  auto record = [&filter_paint](DisplayListBuilder& builder) {
+    builder.drawRect({10, 10, 20, 20});
+    builder.save();
+    builder.translate(30, 30);
+    builder.scale(2, 2);
+    builder.drawOval({0, 0, 10, 10});
+    builder.restore();
+    builder.saveLayer(nullptr, &filter_paint);
+    builder.drawRect({53, 53, 57, 57});
+    builder.drawCircle({80, 80}, 5);
+    builder.restore();
+    builder.clipRect({100, 100, 150, 150}, SkClipOp::kIntersect, false);
+    builder.drawPaint();
+  };
+
+  DisplayListBuilder prepared_builder(cull_rect, true);
+  record(prepared_builder);
+  sk_sp<DisplayList> prepared = prepared_builder.Build();
+  DisplayListBuilder builder(cull_rect);
+  record(builder);
+  sk_sp<DisplayList> computed = builder.Build();
+
+  auto prepared_rtree = prepared->rtree();
+  auto computed_rtree = computed->rtree();
+  ASSERT_EQ(prepared_rtree->getCount(), 5);
+  ASSERT_EQ(prepared_rtree->getCount(), computed_rtree->getCount());
+  for (const SkRect& query : {
+           SkRect::MakeLTRB(0, 0, 200, 200),
+           SkRect::MakeLTRB(15, 15, 16, 16),
+           SkRect::MakeLTRB(45, 45, 46, 46),
+           SkRect::MakeLTRB(49, 49, 52, 52),
+           SkRect::MakeLTRB(120, 120, 130, 130),
+       }) {
+    std::vector<int> prepared_indices;
+    std::vector<int> computed_indices;
+    prepared_rtree->search(query, &prepared_indices);
+    computed_rtree->search(query, &computed_indices);
+    EXPECT_EQ(prepared_indices, computed_indices);
+    EXPECT_EQ(prepared_rtree->searchNonOverlappingDrawnRects(query),
+              computed_rtree->searchNonOverlappingDrawnRects(query));
+  }
+  EXPECT_EQ(prepared->bounds(), computed->bounds());
+}
+
 }  // namespace testing
 }  // namespace flutter
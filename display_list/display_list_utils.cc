@@ -258,125 +258,6 @@ void ClipBoundsDispatchHelper::reset(const SkRect* cull_rect) {
   }
 }
 
-void RectBoundsAccumulator::accumulate(const SkRect& r) {
-  if (r.fLeft < r.fRight && r.fTop < r.fBottom) {
-    rect_.accumulate(r.fLeft, r.fTop);
-    rect_.accumulate(r.fRight, r.fBottom);
-  }
-}
-
-void RectBoundsAccumulator::save() {
-  saved_rects_.emplace_back(rect_);
-  rect_ = AccumulationRect();
-}
-void RectBoundsAccumulator::restore() {
-  if (!saved_rects_.empty()) {
-    SkRect layer_bounds = rect_.bounds();
-    pop_and_accumulate(layer_bounds, nullptr);
-  }
-}
-bool RectBoundsAccumulator::restore(
-    std::function<bool(const SkRect&, SkRect&)> mapper,
-    const SkRect* clip) {
-  bool success = true;
-  if (!saved_rects_.empty()) {
-    SkRect layer_bounds = rect_.bounds();
-    success = mapper(layer_bounds, layer_bounds);
-    pop_and_accumulate(layer_bounds, clip);
-  }
-  return success;
-}
-void RectBoundsAccumulator::pop_and_accumulate(SkRect& layer_bounds,
-                                               const SkRect* clip) {
-  FML_DCHECK(!saved_rects_.empty());
-
-  rect_ = saved_rects_.back();
-  saved_rects_.pop_back();
-
-  if (clip == nullptr || layer_bounds.intersect(*clip)) {
-    accumulate(layer_bounds);
-  }
-}
-
-RectBoundsAccumulator::AccumulationRect::AccumulationRect() {
-  min_x_ = std::numeric_limits<SkScalar>::infinity();
-  min_y_ = std::numeric_limits<SkScalar>::infinity();
-  max_x_ = -std::numeric_limits<SkScalar>::infinity();
-  max_y_ = -std::numeric_limits<SkScalar>::infinity();
-}
-void RectBoundsAccumulator::AccumulationRect::accumulate(SkScalar x,
-                                                         SkScalar y) {
-  if (min_x_ > x) {
-    min_x_ = x;
-  }
-  if (min_y_ > y) {
-    min_y_ = y;
-  }
-  if (max_x_ < x) {
-    max_x_ = x;
-  }
-  if (max_y_ < y) {
-    max_y_ = y;
-  }
-}
-SkRect RectBoundsAccumulator::AccumulationRect::bounds() const {
-  return (max_x_ >= min_x_ && max_y_ >= min_y_)
-             ? SkRect::MakeLTRB(min_x_, min_y_, max_x_, max_y_)
-             : SkRect::MakeEmpty();
-}
-
-void RTreeBoundsAccumulator::accumulate(const SkRect& r) {
-  if (r.fLeft < r.fRight && r.fTop < r.fBottom) {
-    rects_.push_back(r);
-  }
-}
-bool RTreeBoundsAccumulator::is_empty() const {
-  return rects_.empty();
-}
-bool RTreeBoundsAccumulator::is_not_empty() const {
-  return !rects_.empty();
-}
-void RTreeBoundsAccumulator::save() {
-  saved_offsets_.push_back(rects_.size());
-}
-void RTreeBoundsAccumulator::restore() {
-  if (saved_offsets_.empty()) {
-    return;
-  }
-
-  saved_offsets_.pop_back();
-}
-bool RTreeBoundsAccumulator::restore(
-    std::function<bool(const SkRect& original, SkRect& modified)> map,
-    const SkRect* clip) {
-  if (saved_offsets_.empty()) {
-    return true;
-  }
-
-  size_t previous_size = saved_offsets_.back();
-  saved_offsets_.pop_back();
-
-  bool success = true;
-  for (size_t i = previous_size; i < rects_.size(); i++) {
-    SkRect original = rects_[i];
-    if (!map(original, original)) {
-      success = false;
-    }
-    if (clip == nullptr || original.intersect(*clip)) {
-      rects_[previous_size++] = original;
-    }
-  }
-  rects_.resize(previous_size);
-  return success;
-}
-sk_sp<DlRTree> RTreeBoundsAccumulator::rtree() const {
-  FML_DCHECK(saved_offsets_.empty());
-  DlRTreeFactory factory;
-  sk_sp<DlRTree> rtree = factory.getInstance();
-  rtree->insert(rects_.data(), rects_.size());
-  return rtree;
-}
-
 DisplayListBoundsCalculator::DisplayListBoundsCalculator(
     BoundsAccumulator& accumulator,
     const SkRect* cull_rect)
@@ -384,44 +265,46 @@ DisplayListBoundsCalculator::DisplayListBoundsCalculator(
   layer_infos_.emplace_back(std::make_unique<LayerData>(nullptr));
 }
 void DisplayListBoundsCalculator::setStrokeCap(DlStrokeCap cap) {
-  cap_is_square_ = (cap == DlStrokeCap::kSquare);
+  paint_.setStrokeCap(cap);
 }
 void DisplayListBoundsCalculator::setStrokeJoin(DlStrokeJoin join) {
-  join_is_miter_ = (join == DlStrokeJoin::kMiter);
+  paint_.setStrokeJoin(join);
 }
 void DisplayListBoundsCalculator::setStyle(DlDrawStyle style) {
-  style_ = style;
+  paint_.setDrawStyle(style);
 }
 void DisplayListBoundsCalculator::setStrokeWidth(SkScalar width) {
-  half_stroke_width_ = std::max(width * 0.5f, kMinStrokeWidth);
+  paint_.setStrokeWidth(width);
 }
 void DisplayListBoundsCalculator::setStrokeMiter(SkScalar limit) {
-  miter_limit_ = std::max(limit, 1.0f);
+  paint_.setStrokeMiter(limit);
 }
 void DisplayListBoundsCalculator::setBlendMode(DlBlendMode mode) {
-  blend_mode_ = mode;
+  paint_.setBlendMode(mode);
+  has_blender_ = false;
 }
 void DisplayListBoundsCalculator::setBlender(sk_sp<SkBlender> blender) {
   SkPaint paint;
   paint.setBlender(std::move(blender));
   auto blend_mode = paint.asBlendMode();
   if (blend_mode.has_value()) {
-    blend_mode_ = ToDl(blend_mode.value());
+    paint_.setBlendMode(ToDl(blend_mode.value()));
+    has_blender_ = false;
   } else {
-    blend_mode_ = std::nullopt;
+    has_blender_ = true;
   }
 }
 void DisplayListBoundsCalculator::setImageFilter(const DlImageFilter* filter) {
-  image_filter_ = filter ? filter->shared() : nullptr;
+  paint_.setImageFilter(filter);
 }
 void DisplayListBoundsCalculator::setColorFilter(const DlColorFilter* filter) {
-  color_filter_ = filter ? filter->shared() : nullptr;
+  paint_.setColorFilter(filter);
 }
 void DisplayListBoundsCalculator::setPathEffect(const DlPathEffect* effect) {
-  path_effect_ = effect ? effect->shared() : nullptr;
+  paint_.setPathEffect(effect);
 }
 void DisplayListBoundsCalculator::setMaskFilter(const DlMaskFilter* filter) {
-  mask_filter_ = filter ? filter->shared() : nullptr;
+  paint_.setMaskFilter(filter);
 }
 void DisplayListBoundsCalculator::save() {
   SkMatrixDispatchHelper::save();
@@ -439,12 +322,13 @@ void DisplayListBoundsCalculator::saveLayer(const SkRect* bounds,
     // (eventual) corresponding restore is called, but rather than
     // remember this information in the LayerInfo until the restore
     // method is processed, we just mark the unbounded state up front.
-    if (!paint_nops_on_transparency()) {
+    if (!PaintNopsOnTransparency(paint_, has_blender_)) {
       // We will fill the clip of the outer layer when we restore
       AccumulateUnbounded();
     }
 
-    layer_infos_.emplace_back(std::make_unique<LayerData>(image_filter_));
+    layer_infos_.emplace_back(
+        std::make_unique<LayerData>(paint_.getImageFilter()));
   } else {
     layer_infos_.emplace_back(std::make_unique<LayerData>(nullptr));
   }
@@ -474,7 +358,7 @@ void DisplayListBoundsCalculator::restore() {
 
     // Before we pop_back we will get the current layer bounds from the
     // current accumulator and adjust ot as required based on the filter.
-    std::shared_ptr<DlImageFilter> filter = layer_info->filter();
+    std::shared_ptr<const DlImageFilter> filter = layer_info->filter();
     const SkRect* clip = has_clip() ? &clip_bounds() : nullptr;
     if (filter) {
       if (!accumulator_.restore(
@@ -689,58 +573,53 @@ void DisplayListBoundsCalculator::drawShadow(const SkPath& path,
   AccumulateOpBounds(shadow_bounds, kDrawShadowFlags);
 }
 
-bool DisplayListBoundsCalculator::ComputeFilteredBounds(SkRect& bounds,
-                                                        DlImageFilter* filter) {
-  if (filter) {
-    if (!filter->map_local_bounds(bounds, bounds)) {
-      return false;
-    }
-  }
-  return true;
-}
-
 bool DisplayListBoundsCalculator::AdjustBoundsForPaint(
     SkRect& bounds,
-    DisplayListAttributeFlags flags) {
+    DisplayListAttributeFlags flags,
+    const DlPaint& paint) {
   if (flags.ignores_paint()) {
     return true;
   }
 
   if (flags.is_geometric()) {
+    const DlPathEffect* path_effect = paint.getPathEffectPtr();
     // Path effect occurs before stroking...
     DisplayListSpecialGeometryFlags special_flags =
-        flags.WithPathEffect(path_effect_.get());
-    if (path_effect_) {
-      auto effect_bounds = path_effect_->effect_bounds(bounds);
+        flags.WithPathEffect(path_effect);
+    if (path_effect) {
+      auto effect_bounds = path_effect->effect_bounds(bounds);
       if (!effect_bounds.has_value()) {
         return false;
       }
       bounds = effect_bounds.value();
     }
 
-    if (flags.is_stroked(style_)) {
+    if (flags.is_stroked(paint.getDrawStyle())) {
       // Determine the max multiplier to the stroke width first.
       SkScalar pad = 1.0f;
-      if (join_is_miter_ && special_flags.may_have_acute_joins()) {
-        pad = std::max(pad, miter_limit_);
+      if (paint.getStrokeJoin() == DlStrokeJoin::kMiter &&
+          special_flags.may_have_acute_joins()) {
+        pad = std::max(pad, paint.getStrokeMiter());
       }
-      if (cap_is_square_ && special_flags.may_have_diagonal_caps()) {
+      if (paint.getStrokeCap() == DlStrokeCap::kSquare &&
+          special_flags.may_have_diagonal_caps()) {
         pad = std::max(pad, SK_ScalarSqrt2);
       }
-      pad *= half_stroke_width_;
+      pad *= std::max(paint.getStrokeWidth() * 0.5f, kMinStrokeWidth);
       bounds.outset(pad, pad);
     }
   }
 
   if (flags.applies_mask_filter()) {
-    if (mask_filter_) {
-      const DlBlurMaskFilter* blur_filter = mask_filter_->asBlur();
+    const DlMaskFilter* mask_filter = paint.getMaskFilterPtr();
+    if (mask_filter) {
+      const DlBlurMaskFilter* blur_filter = mask_filter->asBlur();
       if (blur_filter) {
         SkScalar mask_sigma_pad = blur_filter->sigma() * 3.0;
         bounds.outset(mask_sigma_pad, mask_sigma_pad);
       } else {
         SkPaint p;
-        p.setMaskFilter(mask_filter_->skia_object());
+        p.setMaskFilter(mask_filter->skia_object());
         if (!p.canComputeFastBounds()) {
           return false;
         }
@@ -750,7 +629,10 @@ bool DisplayListBoundsCalculator::AdjustBoundsForPaint(
   }
 
   if (flags.applies_image_filter()) {
-    return ComputeFilteredBounds(bounds, image_filter_.get());
+    const DlImageFilter* image_filter = paint.getImageFilterPtr();
+    if (image_filter && !image_filter->map_local_bounds(bounds, bounds)) {
+      return false;
+    }
   }
 
   return true;
@@ -766,7 +648,7 @@ void DisplayListBoundsCalculator::AccumulateUnbounded() {
 void DisplayListBoundsCalculator::AccumulateOpBounds(
     SkRect& bounds,
     DisplayListAttributeFlags flags) {
-  if (AdjustBoundsForPaint(bounds, flags)) {
+  if (AdjustBoundsForPaint(bounds, flags, paint_)) {
     AccumulateBounds(bounds);
   } else {
     AccumulateUnbounded();
@@ -779,11 +661,13 @@ void DisplayListBoundsCalculator::AccumulateBounds(SkRect& bounds) {
   }
 }
 
-bool DisplayListBoundsCalculator::paint_nops_on_transparency() {
+bool DisplayListBoundsCalculator::PaintNopsOnTransparency(const DlPaint& paint,
+                                                          bool has_blender) {
   // SkImageFilter::canComputeFastBounds tests for transparency behavior
   // This test assumes that the blend mode checked down below will
   // NOP on transparent black.
-  if (image_filter_ && image_filter_->modifies_transparent_black()) {
+  const DlImageFilter* image_filter = paint.getImageFilterPtr();
+  if (image_filter && image_filter->modifies_transparent_black()) {
     return false;
   }
 
@@ -793,11 +677,12 @@ bool DisplayListBoundsCalculator::paint_nops_on_transparency() {
   // save layer untouched out to the edge of the output surface.
   // This test assumes that the blend mode checked down below will
   // NOP on transparent black.
-  if (color_filter_ && color_filter_->modifies_transparent_black()) {
+  const DlColorFilter* color_filter = paint.getColorFilterPtr();
+  if (color_filter && color_filter->modifies_transparent_black()) {
     return false;
   }
 
-  if (!blend_mode_) {
+  if (has_blender) {
     return false;  // can we query other blenders for this?
   }
   // Unusual blendmodes require us to process a saved layer
@@ -805,7 +690,7 @@ bool DisplayListBoundsCalculator::paint_nops_on_transparency() {
   // For example, DstIn is used by masking layers.
   // https://code.google.com/p/skia/issues/detail?id=1291
   // https://crbug.com/401593
-  switch (blend_mode_.value()) {
+  switch (paint.getBlendMode()) {
     // For each of the following transfer modes, if the source
     // alpha is zero (our transparent black), the resulting
     // blended pixel is not necessarily equal to the original
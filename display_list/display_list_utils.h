@@ -9,6 +9,7 @@
 
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_blend_mode.h"
+#include "flutter/display_list/display_list_bounds_accumulator.h"
 #include "flutter/display_list/display_list_builder.h"
 #include "flutter/display_list/display_list_rtree.h"
 #include "flutter/fml/logging.h"
@@ -337,129 +338,6 @@ class ClipBoundsDispatchHelper : public virtual Dispatcher,
   void intersect(const SkRect& clipBounds, bool is_aa);
 };
 
-class BoundsAccumulator {
- public:
-  /// function definition for modifying the bounds of a rectangle
-  /// during a restore operation. The function is used primarily
-  /// to account for the bounds impact of an ImageFilter on a
-  /// saveLayer on a per-rect basis. The implementation may apply
-  /// this function at whatever granularity it can manage easily
-  /// (for example, a Rect accumulator might apply it to the entire
-  /// local bounds being restored, whereas an RTree accumulator might
-  /// apply it individually to each element in the local RTree).
-  ///
-  /// The function will do a best faith attempt at determining the
-  /// modified bounds and store the results in the supplied |dest|
-  /// rectangle and return true. If the function is unable to
-  /// accurately determine the modifed bounds, it will set the
-  /// |dest| rectangle to a copy of the input bounds (or a best
-  /// guess) and return false to indicate that the bounds should not
-  /// be trusted.
-  typedef bool BoundsModifier(const SkRect& original, SkRect* dest);
-
-  virtual void accumulate(const SkRect& r) = 0;
-
-  virtual bool is_empty() const = 0;
-  virtual bool is_not_empty() const = 0;
-
-  /// Save aside the rects/bounds currently being accumulated and start
-  /// accumulating a new set of rects/bounds. When restore is called,
-  /// some additional modifications may be applied to these new bounds
-  /// before they are accumulated back into the surrounding bounds.
-  virtual void save() = 0;
-
-  /// Restore to the previous accumulation and incorporate the bounds of
-  /// the primitives that were recorded since the last save (if needed).
-  virtual void restore() = 0;
-
-  /// Restore the previous set of accumulation rects/bounds and accumulate
-  /// the current rects/bounds that were accumulated since the most recent
-  /// call to |save| into them with modifications specified by the |map|
-  /// parameter and clipping to the clip parameter if it is not null.
-  ///
-  /// The indicated map function is applied to the various rects and bounds
-  /// that have been accumulated in this save/restore cycle before they
-  /// are then accumulated into the previous accumulations. The granularity
-  /// of the application of the map function to the rectangles that were
-  /// accumulated during the save period is left up to the implementation.
-  ///
-  /// This method will return true if the map function returned true on
-  /// every single invocation. A false return value means that the
-  /// bounds accumulated during this restore may not be trusted (as
-  /// determined by the map function).
-  ///
-  /// If there are no saved accumulations to restore to, this method will
-  /// NOP ignoring the map function and the optional clip entirely.
-  virtual bool restore(
-      std::function<bool(const SkRect& original, SkRect& modified)> map,
-      const SkRect* clip = nullptr) = 0;
-};
-
-class RectBoundsAccumulator final : public virtual BoundsAccumulator {
- public:
-  void accumulate(SkScalar x, SkScalar y) { rect_.accumulate(x, y); }
-  void accumulate(const SkPoint& p) { rect_.accumulate(p.fX, p.fY); }
-  void accumulate(const SkRect& r) override;
-
-  bool is_empty() const override { return rect_.is_empty(); }
-  bool is_not_empty() const override { return rect_.is_not_empty(); }
-
-  void save() override;
-  void restore() override;
-  bool restore(std::function<bool(const SkRect&, SkRect&)> mapper,
-               const SkRect* clip) override;
-
-  SkRect bounds() const {
-    FML_DCHECK(saved_rects_.empty());
-    return rect_.bounds();
-  }
-
- private:
-  class AccumulationRect {
-   public:
-    AccumulationRect();
-
-    void accumulate(SkScalar x, SkScalar y);
-
-    bool is_empty() const { return min_x_ >= max_x_ || min_y_ >= max_y_; }
-    bool is_not_empty() const { return min_x_ < max_x_ && min_y_ < max_y_; }
-
-    SkRect bounds() const;
-
-   private:
-    SkScalar min_x_;
-    SkScalar min_y_;
-    SkScalar max_x_;
-    SkScalar max_y_;
-  };
-
-  void pop_and_accumulate(SkRect& layer_bounds, const SkRect* clip);
-
-  AccumulationRect rect_;
-  std::vector<AccumulationRect> saved_rects_;
-};
-
-class RTreeBoundsAccumulator final : public virtual BoundsAccumulator {
- public:
-  void accumulate(const SkRect& r) override;
-
-  bool is_empty() const override;
-  bool is_not_empty() const override;
-
-  void save() override;
-  void restore() override;
-
-  bool restore(
-      std::function<bool(const SkRect& original, SkRect& modified)> map,
-      const SkRect* clip = nullptr) override;
-
-  sk_sp<DlRTree> rtree() const;
-
- private:
-  std::vector<SkRect> rects_;
-  std::vector<size_t> saved_offsets_;
-};
-
 // This class implements all rendering methods and computes a liberal
 // bounds of the rendering operations.
 class DisplayListBoundsCalculator final
@@ -481,6 +359,20 @@ class DisplayListBoundsCalculator final
   explicit DisplayListBoundsCalculator(BoundsAccumulator& accumulator,
                                        const SkRect* cull_rect = nullptr);
 
+  // Adjusts the |bounds| of an op rendered with the indicated |flags| for
+  // the stroke, path effect, mask filter and image filter attributes of
+  // |paint| and returns true if the calculation was possible, or false if
+  // the bounds could not be estimated.
+  static bool AdjustBoundsForPaint(SkRect& bounds,
+                                   DisplayListAttributeFlags flags,
+                                   const DlPaint& paint);
+
+  // Returns true if rendering transparent black with the blend mode and
+  // filters of |paint| leaves the destination unchanged. The blend mode
+  // of |paint| is not consulted if |has_blender| is true, in which case
+  // the answer is always false.
+  static bool PaintNopsOnTransparency(const DlPaint& paint, bool has_blender);
+
   void setStrokeCap(DlStrokeCap cap) override;
   void setStrokeJoin(DlStrokeJoin join) override;
   void setStyle(DlDrawStyle style) override;
@@ -589,12 +481,12 @@ class DisplayListBoundsCalculator final
     // Some saveLayer calls will process their bounds by a
     // |DlImageFilter| when they are restored, but for most
     // saveLayer (and all save) calls the filter will be null.
-    explicit LayerData(std::shared_ptr<DlImageFilter> filter = nullptr)
+    explicit LayerData(std::shared_ptr<const DlImageFilter> filter = nullptr)
         : filter_(filter), is_unbounded_(false) {}
     ~LayerData() = default;
 
     // The filter to apply to the layer bounds when it is restored
-    std::shared_ptr<DlImageFilter> filter() { return filter_; }
+    std::shared_ptr<const DlImageFilter> filter() { return filter_; }
 
     // is_unbounded should be set to true if we ever encounter an operation
     // on a layer that either is unrestricted (|drawColor| or |drawPaint|)
@@ -632,7 +524,7 @@ class DisplayListBoundsCalculator final
     }
 
    private:
-    std::shared_ptr<DlImageFilter> filter_;
+    std::shared_ptr<const DlImageFilter> filter_;
     bool is_unbounded_;
 
     FML_DISALLOW_COPY_AND_ASSIGN(LayerData);
@@ -642,26 +534,10 @@ class DisplayListBoundsCalculator final
 
   static constexpr SkScalar kMinStrokeWidth = 0.01;
 
-  std::optional<DlBlendMode> blend_mode_ = DlBlendMode::kSrcOver;
-  std::shared_ptr<const DlColorFilter> color_filter_;
-
-  SkScalar half_stroke_width_ = kMinStrokeWidth;
-  SkScalar miter_limit_ = 4.0;
-  DlDrawStyle style_ = DlDrawStyle::kFill;
-  bool join_is_miter_ = true;
-  bool cap_is_square_ = false;
-  std::shared_ptr<DlImageFilter> image_filter_;
-  std::shared_ptr<const DlPathEffect> path_effect_;
-  std::shared_ptr<const DlMaskFilter> mask_filter_;
-
-  bool paint_nops_on_transparency();
-
-  // Computes the bounds of an operation adjusted for a given ImageFilter
-  static bool ComputeFilteredBounds(SkRect& bounds, DlImageFilter* filter);
-
-  // Adjusts the indicated bounds for the given flags and returns true if
-  // the calculation was possible, or false if it could not be estimated.
-  bool AdjustBoundsForPaint(SkRect& bounds, DisplayListAttributeFlags flags);
+  // The attributes that affect the bounds of the rendering operations.
+  DlPaint paint_;
+  // If |has_blender_| is true then |paint_.getBlendMode()| is ignored.
+  bool has_blender_ = false;
 
   // Records the fact that we encountered an op that either could not
   // estimate its bounds or that fills all of the destination space.
@@ -4,14 +4,213 @@
 
 #include "flutter/display_list/display_list_vertices.h"
 
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "flutter/display_list/display_list_utils.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/memory/memory_governor.h"
 
 namespace flutter {
 
 using Flags = DlVertices::Builder::Flags;
 
-static void DlVerticesDeleter(void* p) {
+static uint64_t NextUniqueId() {
+  static std::atomic<uint64_t> next_id = 1;
+  return next_id++;
+}
+
+namespace {
+
+struct ReleaseCallbacks {
+  std::mutex mutex;
+  std::vector<DlVertices::ReleaseCallback> callbacks;
+};
+
+ReleaseCallbacks& GetReleaseCallbacks() {
+  static ReleaseCallbacks* callbacks = new ReleaseCallbacks();
+  return *callbacks;
+}
+
+// The Skia analogs of the most recently used vertices, up to a number of
+// bytes. Analogs are only kept from the second frame they are asked for in,
+// so that vertices made anew in every frame do not push out the ones that are
+// reused. The analogs of released vertices are dropped at the end of the
+// frame.
+//
+// The cache is shared by every engine in the process, so a frame ends
+// whenever one of them finishes a frame.
+class SkiaObjectCache {
+ public:
+  static constexpr size_t kMaxBytes = 64 * 1024 * 1024;
+
+  static SkiaObjectCache& GetInstance() {
+    static SkiaObjectCache* instance = new SkiaObjectCache();
+    return *instance;
+  }
+
+  sk_sp<SkVertices> Get(uint64_t unique_id) {
+    std::scoped_lock lock(mutex_);
+    auto found = entries_by_id_.find(unique_id);
+    if (found == entries_by_id_.end()) {
+      return nullptr;
+    }
+    // Moves the entry to the front, where the most recently used ones are.
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return found->second->vertices;
+  }
+
+  // Returns whether the analog of the vertices was asked for in an earlier
+  // frame too, in which case it is worth keeping.
+  bool ShouldInsert(uint64_t unique_id) {
+    std::scoped_lock lock(mutex_);
+    auto [found, inserted] = candidates_.try_emplace(unique_id, frame_);
+    if (inserted || found->second == frame_) {
+      return false;
+    }
+    candidates_.erase(found);
+    return true;
+  }
+
+  void Insert(uint64_t unique_id, sk_sp<SkVertices> vertices) {
+    const size_t bytes = vertices->approximateSize();
+    if (bytes > kMaxBytes) {
+      return;
+    }
+    {
+      std::scoped_lock lock(mutex_);
+      if (entries_by_id_.find(unique_id) != entries_by_id_.end()) {
+        return;
+      }
+      entries_.push_front({unique_id, std::move(vertices), bytes});
+      entries_by_id_[unique_id] = entries_.begin();
+      bytes_ += bytes;
+      EvictLocked(kMaxBytes);
+    }
+    registration_->ReportBytes(GetBytes());
+  }
+
+  void FinishFrame() {
+    {
+      std::scoped_lock lock(mutex_);
+      for (uint64_t unique_id : released_) {
+        auto found = entries_by_id_.find(unique_id);
+        if (found != entries_by_id_.end()) {
+          bytes_ -= found->second->bytes;
+          entries_.erase(found->second);
+          entries_by_id_.erase(found);
+        }
+        candidates_.erase(unique_id);
+      }
+      released_.clear();
+      // Vertices that were not asked for again in the frame after their first
+      // one are forgotten, so that vertices made in every frame are never
+      // kept.
+      for (auto it = candidates_.begin(); it != candidates_.end();) {
+        if (it->second < frame_) {
+          it = candidates_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+      frame_++;
+    }
+    registration_->ReportBytes(GetBytes());
+  }
+
+ private:
+  struct Entry {
+    uint64_t unique_id;
+    sk_sp<SkVertices> vertices;
+    size_t bytes;
+  };
+
+  mutable std::mutex mutex_;
+  std::list<Entry> entries_;
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> entries_by_id_;
+  size_t bytes_ = 0;
+  // Incremented by |FinishFrame|.
+  uint64_t frame_ = 0;
+  // The vertices asked for once in the current and the last frame, and the
+  // frame that they were first asked for in.
+  std::unordered_map<uint64_t, uint64_t> candidates_;
+  // The released vertices that are cached or candidates, dropped by the next
+  // |FinishFrame|.
+  std::vector<uint64_t> released_;
+  std::unique_ptr<fml::MemoryGovernor::Registration> registration_;
+
+  SkiaObjectCache() {
+    // Recreating the analogs only takes a copy of the vertices.
+    registration_ = fml::MemoryGovernor::GetInstance().Register(
+        "SkiaVerticesCache", fml::MemoryGovernor::Priority::kLow,
+        [this](size_t target_bytes) {
+          {
+            std::scoped_lock lock(mutex_);
+            EvictLocked(target_bytes);
+          }
+          registration_->ReportBytes(GetBytes());
+        });
+    DlVertices::AddReleaseCallback(
+        [](uint64_t unique_id) { GetInstance().Release(unique_id); });
+  }
+
+  size_t GetBytes() const {
+    std::scoped_lock lock(mutex_);
+    return bytes_;
+  }
+
+  // Only the ids that the cache knows are queued, so that the queue stays
+  // small when no frames are drawn with Skia.
+  void Release(uint64_t unique_id) {
+    std::scoped_lock lock(mutex_);
+    if (entries_by_id_.count(unique_id) != 0 ||
+        candidates_.count(unique_id) != 0) {
+      released_.push_back(unique_id);
+    }
+  }
+
+  void EvictLocked(size_t max_bytes) {
+    while (bytes_ > max_bytes) {
+      const Entry& entry = entries_.back();
+      bytes_ -= entry.bytes;
+      entries_by_id_.erase(entry.unique_id);
+      entries_.pop_back();
+    }
+  }
+};
+
+}  // namespace
+
+class DlVertices::Identity {
+ public:
+  Identity() : unique_id(NextUniqueId()) {}
+
+  ~Identity() {
+    ReleaseCallbacks& release_callbacks = GetReleaseCallbacks();
+    std::scoped_lock lock(release_callbacks.mutex);
+    for (ReleaseCallback callback : release_callbacks.callbacks) {
+      callback(unique_id);
+    }
+  }
+
+  const uint64_t unique_id;
+};
+
+void DlVertices::AddReleaseCallback(ReleaseCallback callback) {
+  ReleaseCallbacks& release_callbacks = GetReleaseCallbacks();
+  std::scoped_lock lock(release_callbacks.mutex);
+  release_callbacks.callbacks.push_back(callback);
+}
+
+void DlVertices::FinishSkiaObjectFrame() {
+  SkiaObjectCache::GetInstance().FinishFrame();
+}
+
+static void DlVerticesDeleter(DlVertices* p) {
+  p->~DlVertices();
   // Some of our target environments would prefer a sized delete,
   // but other target environments do not have that operator.
   // Use an unsized delete until we get better agreement in the
@@ -100,8 +299,12 @@ DlVertices::DlVertices(DlVertexMode mode,
                        const DlColor* colors,
                        int unchecked_index_count,
                        const uint16_t* indices,
-                       const SkRect* bounds)
+                       const SkRect* bounds,
+                       std::shared_ptr<const Identity> identity)
     : mode_(mode),
+      identity_(identity ? std::move(identity)
+                         : std::make_shared<const Identity>()),
+      unique_id_(identity_->unique_id),
       vertex_count_(std::max(unchecked_vertex_count, 0)),
       index_count_(indices ? std::max(unchecked_index_count, 0) : 0) {
   bounds_ = bounds ? *bounds : compute_bounds(vertices, vertex_count_);
@@ -138,13 +341,16 @@ DlVertices::DlVertices(const DlVertices* other)
                  other->colors(),
                  other->index_count_,
                  other->indices(),
-                 &other->bounds_) {}
+                 &other->bounds_,
+                 other->identity_) {}
 
 DlVertices::DlVertices(DlVertexMode mode,
                        int unchecked_vertex_count,
                        Flags flags,
                        int unchecked_index_count)
     : mode_(mode),
+      identity_(std::make_shared<const Identity>()),
+      unique_id_(identity_->unique_id),
       vertex_count_(std::max(unchecked_vertex_count, 0)),
       index_count_(std::max(unchecked_index_count, 0)) {
   char* pod = reinterpret_cast<char*>(this);
@@ -176,11 +382,22 @@ DlVertices::DlVertices(DlVertexMode mode,
   FML_DCHECK((index_count_ != 0) == (indices() != nullptr));
 }
 
+DlVertices::~DlVertices() = default;
+
 sk_sp<SkVertices> DlVertices::skia_object() const {
+  SkiaObjectCache& cache = SkiaObjectCache::GetInstance();
+  sk_sp<SkVertices> result = cache.Get(unique_id_);
+  if (result) {
+    return result;
+  }
   const SkColor* sk_colors = reinterpret_cast<const SkColor*>(colors());
-  return SkVertices::MakeCopy(ToSk(mode_), vertex_count_, vertices(),
-                              texture_coordinates(), sk_colors, index_count_,
-                              indices());
+  result = SkVertices::MakeCopy(ToSk(mode_), vertex_count_, vertices(),
+                                texture_coordinates(), sk_colors, index_count_,
+                                indices());
+  if (cache.ShouldInsert(unique_id_)) {
+    cache.Insert(unique_id_, result);
+  }
+  return result;
 }
 
 bool DlVertices::operator==(DlVertices const& other) const {
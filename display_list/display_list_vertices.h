@@ -5,6 +5,8 @@
 #ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_VERTICES_H_
 #define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_VERTICES_H_
 
+#include <memory>
+
 #include "flutter/display_list/display_list_color.h"
 #include "flutter/display_list/types.h"
 
@@ -198,6 +200,19 @@ class DlVertices {
   /// Returns the bounds of the vertices.
   SkRect bounds() const { return bounds_; }
 
+  /// Returns an identifier that is unique to this object and shared by the
+  /// copies of it that display lists make. Backends use it to reuse the data
+  /// they derive from vertices that are drawn in many frames.
+  uint64_t unique_id() const { return unique_id_; }
+
+  /// Called with the |unique_id| of vertices once their last copy is
+  /// destroyed, on the thread that destroyed it. Backends use it to release
+  /// the data they derived from the vertices.
+  using ReleaseCallback = void (*)(uint64_t unique_id);
+
+  /// Adds a callback for released vertices. Callbacks cannot be removed.
+  static void AddReleaseCallback(ReleaseCallback callback);
+
   /// Returns the vertex mode that defines how the vertices (or the indices)
   /// are turned into triangles.
   DlVertexMode mode() const { return mode_; }
@@ -233,14 +248,27 @@ class DlVertices {
     return static_cast<const uint16_t*>(pod(indices_offset_));
   }
 
-  // Returns an equivalent sk_sp<SkVertices> analog to this object.
+  // Returns an equivalent sk_sp<SkVertices> analog to this object. The analogs
+  // of recently used vertices are cached by their |unique_id| from the second
+  // time they are asked for, so vertices that are drawn in every frame are not
+  // copied again.
   sk_sp<SkVertices> skia_object() const;
 
+  // Ends a frame of the cache of Skia analogs. Vertices that were asked for
+  // in a frame and not in the next one are forgotten, and the analogs of
+  // released vertices are dropped.
+  static void FinishSkiaObjectFrame();
+
   bool operator==(DlVertices const& other) const;
 
   bool operator!=(DlVertices const& other) const { return !(*this == other); }
 
+  ~DlVertices();
+
  private:
+  // Shared by the copies of vertices, and destroyed along with the last one.
+  class Identity;
+
   // Constructors are designed to encapsulate arrays sequentially in memory
   // which means they can only be called by intantiations that use the
   // new (ptr) paradigm which precomputes and preallocates the memory for
@@ -252,7 +280,8 @@ class DlVertices {
              const DlColor colors[],
              int index_count,
              const uint16_t indices[],
-             const SkRect* bounds = nullptr);
+             const SkRect* bounds = nullptr,
+             std::shared_ptr<const Identity> identity = nullptr);
 
   // This constructor is specifically used by the DlVertices::Builder to
   // establish the object before the copying of data is requested.
@@ -268,6 +297,8 @@ class DlVertices {
   explicit DlVertices(const DlVertices* other);
 
   DlVertexMode mode_;
+  std::shared_ptr<const Identity> identity_;
+  uint64_t unique_id_;
 
   int vertex_count_;
   size_t vertices_offset_;
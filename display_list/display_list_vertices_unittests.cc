@@ -5,8 +5,10 @@
 #include "flutter/display_list/display_list_attributes_testing.h"
 #include "flutter/display_list/display_list_builder.h"
 #include "flutter/display_list/display_list_comparable.h"
+#include "flutter/display_list/display_list_utils.h"
 #include "flutter/display_list/display_list_vertices.h"
 #include "flutter/display_list/types.h"
+#include "flutter/fml/memory/memory_governor.h"
 #include "gtest/gtest.h"
 
 namespace flutter {
@@ -982,5 +984,144 @@ TEST(DisplayListVertices, TestNotEquals) {
   }
 }
 
+namespace {
+
+class VerticesRecorder : public virtual Dispatcher,
+                         public IgnoreAttributeDispatchHelper,
+                         public IgnoreClipDispatchHelper,
+                         public IgnoreTransformDispatchHelper,
+                         public IgnoreDrawDispatchHelper {
+ public:
+  void drawVertices(const DlVertices* vertices, DlBlendMode mode) override {
+    unique_ids_.push_back(vertices->unique_id());
+    skia_objects_.push_back(vertices->skia_object());
+  }
+
+  const std::vector<uint64_t>& unique_ids() const { return unique_ids_; }
+  const std::vector<sk_sp<SkVertices>>& skia_objects() const {
+    return skia_objects_;
+  }
+
+ private:
+  std::vector<uint64_t> unique_ids_;
+  std::vector<sk_sp<SkVertices>> skia_objects_;
+};
+
+size_t GetSkiaObjectCacheBytes() {
+  for (const auto& stats : fml::MemoryGovernor::GetInstance().GetCacheStats()) {
+    if (stats.name == "SkiaVerticesCache") {
+      return stats.bytes;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+TEST(DisplayListVertices, UniqueIdIsSharedByDisplayListCopies) {
+  SkPoint coords[3] = {
+      SkPoint::Make(2, 3),
+      SkPoint::Make(5, 6),
+      SkPoint::Make(15, 20),
+  };
+  std::shared_ptr<const DlVertices> vertices1 = DlVertices::Make(
+      DlVertexMode::kTriangles, 3, coords, nullptr, nullptr);
+  std::shared_ptr<const DlVertices> vertices2 = DlVertices::Make(
+      DlVertexMode::kTriangles, 3, coords, nullptr, nullptr);
+  // Equal vertices are still different objects.
+  TestEquals(*vertices1, *vertices2);
+  EXPECT_NE(vertices1->unique_id(), vertices2->unique_id());
+
+  // Every frame records the vertices into a new display list.
+  VerticesRecorder recorder;
+  for (int frame = 0; frame < 3; frame++) {
+    DisplayListBuilder builder;
+    builder.drawVertices(vertices1, DlBlendMode::kSrcOver);
+    builder.Build()->Dispatch(recorder);
+    DlVertices::FinishSkiaObjectFrame();
+  }
+  ASSERT_EQ(recorder.unique_ids().size(), 3u);
+  for (uint64_t unique_id : recorder.unique_ids()) {
+    EXPECT_EQ(unique_id, vertices1->unique_id());
+  }
+  // The Skia analog is kept from the second frame on.
+  EXPECT_EQ(recorder.skia_objects()[1], recorder.skia_objects()[2]);
+  EXPECT_EQ(recorder.skia_objects()[1], vertices1->skia_object());
+  EXPECT_NE(vertices1->skia_object(), vertices2->skia_object());
+}
+
+TEST(DisplayListVertices, SkiaObjectsOfVerticesMadeInEveryFrameAreNotKept) {
+  SkPoint coords[3] = {
+      SkPoint::Make(2, 3),
+      SkPoint::Make(5, 6),
+      SkPoint::Make(15, 20),
+  };
+  // Drops the analogs of the vertices released by earlier tests.
+  DlVertices::FinishSkiaObjectFrame();
+  const size_t cached_bytes = GetSkiaObjectCacheBytes();
+  // Like a new Vertices object built in every call to paint.
+  for (int frame = 0; frame < 100; frame++) {
+    std::shared_ptr<const DlVertices> vertices = DlVertices::Make(
+        DlVertexMode::kTriangles, 3, coords, nullptr, nullptr);
+    DisplayListBuilder builder;
+    builder.drawVertices(vertices, DlBlendMode::kSrcOver);
+    VerticesRecorder recorder;
+    builder.Build()->Dispatch(recorder);
+    ASSERT_EQ(recorder.skia_objects().size(), 1u);
+    DlVertices::FinishSkiaObjectFrame();
+  }
+  EXPECT_EQ(GetSkiaObjectCacheBytes(), cached_bytes);
+}
+
+TEST(DisplayListVertices, SkiaObjectsOfReleasedVerticesAreDropped) {
+  SkPoint coords[3] = {
+      SkPoint::Make(2, 3),
+      SkPoint::Make(5, 6),
+      SkPoint::Make(15, 20),
+  };
+  // Drops the analogs of the vertices released by earlier tests.
+  DlVertices::FinishSkiaObjectFrame();
+  const size_t cached_bytes = GetSkiaObjectCacheBytes();
+  std::shared_ptr<const DlVertices> vertices = DlVertices::Make(
+      DlVertexMode::kTriangles, 3, coords, nullptr, nullptr);
+  sk_sp<DisplayList> display_list;
+  for (int frame = 0; frame < 2; frame++) {
+    DisplayListBuilder builder;
+    builder.drawVertices(vertices, DlBlendMode::kSrcOver);
+    display_list = builder.Build();
+    VerticesRecorder recorder;
+    display_list->Dispatch(recorder);
+    DlVertices::FinishSkiaObjectFrame();
+  }
+  EXPECT_GT(GetSkiaObjectCacheBytes(), cached_bytes);
+
+  // The copy in the display list keeps the analog.
+  vertices.reset();
+  DlVertices::FinishSkiaObjectFrame();
+  EXPECT_GT(GetSkiaObjectCacheBytes(), cached_bytes);
+
+  display_list.reset();
+  EXPECT_GT(GetSkiaObjectCacheBytes(), cached_bytes);
+  DlVertices::FinishSkiaObjectFrame();
+  EXPECT_EQ(GetSkiaObjectCacheBytes(), cached_bytes);
+}
+
+TEST(DisplayListVertices, DisplayListsOfEqualVerticesAreEqual) {
+  SkPoint coords[3] = {
+      SkPoint::Make(2, 3),
+      SkPoint::Make(5, 6),
+      SkPoint::Make(15, 20),
+  };
+  sk_sp<DisplayList> display_lists[2];
+  for (sk_sp<DisplayList>& display_list : display_lists) {
+    DisplayListBuilder builder;
+    builder.drawVertices(DlVertices::Make(DlVertexMode::kTriangles, 3, coords,
+                                          nullptr, nullptr),
+                         DlBlendMode::kSrcOver);
+    display_list = builder.Build();
+  }
+  EXPECT_TRUE(display_lists[0]->Equals(display_lists[1]));
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -5,6 +5,8 @@
 #include "flutter/flow/compositor_context.h"
 
 #include <optional>
+
+#include "flutter/display_list/display_list_vertices.h"
 #include "flutter/flow/layers/layer_tree.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 
@@ -66,6 +68,11 @@ void CompositorContext::EndFrame(ScopedFrame& frame,
   if (enable_instrumentation) {
     raster_time_.Stop();
   }
+  // Frames that are drawn with Impeller have no canvas, and use the mesh
+  // cache of Impeller instead.
+  if (frame.canvas()) {
+    DlVertices::FinishSkiaObjectFrame();
+  }
 }
 
 std::unique_ptr<CompositorContext::ScopedFrame> CompositorContext::AcquireFrame(
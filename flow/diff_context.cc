@@ -242,7 +242,8 @@ void DiffContext::Statistics::LogStatistics() {
   FML_TRACE_COUNTER("flutter", "DiffContext", reinterpret_cast<int64_t>(this),
                     "NewPictures", new_pictures_, "PicturesTooComplexToCompare",
                     pictures_too_complex_to_compare_, "DeepComparePictures",
-                    deep_compare_pictures_, "SameInstancePictures",
+                    deep_compare_pictures_, "AvoidedDeepComparePictures",
+                    avoided_deep_compare_pictures_, "SameInstancePictures",
                     same_instance_pictures_,
                     "DifferentInstanceButEqualPictures",
                     different_instance_but_equal_pictures_);
@@ -171,6 +171,11 @@ class DiffContext {
     // Picture that had to be serialized to compare for equality
     void AddDeepComparePicture() { ++deep_compare_pictures_; }
 
+    // Picture that would have required deep comparison (or would have been
+    // considered too complex to compare) but was known to be different
+    // because its content hash differed
+    void AddAvoidedDeepComparePicture() { ++avoided_deep_compare_pictures_; }
+
     // Picture that had to be serialized to compare (different instances),
     // but were equal
     void AddDifferentInstanceButEqualPicture() {
@@ -185,6 +190,7 @@ class DiffContext {
     int pictures_too_complex_to_compare_ = 0;
     int same_instance_pictures_ = 0;
     int deep_compare_pictures_ = 0;
+    int avoided_deep_compare_pictures_ = 0;
     int different_instance_but_equal_pictures_ = 0;
   };
 
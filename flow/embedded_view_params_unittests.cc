@@ -94,5 +94,24 @@ TEST(EmbeddedViewParams,
   ASSERT_TRUE(SkScalarNearlyEqual(rect.height(), 3));
 }
 
+TEST(EmbeddedViewParams, EqualityOfParamsSharingAMutatorsStack) {
+  MutatorsStack stack;
+  SkMatrix matrix = SkMatrix::Translate(10, 10);
+  stack.PushTransform(matrix);
+  stack.PushClipRect(SkRect::MakeWH(100, 100));
+
+  EmbeddedViewParams params(matrix, SkSize::Make(20, 20), stack);
+  EmbeddedViewParams same(matrix, SkSize::Make(20, 20), stack);
+  ASSERT_TRUE(params == same);
+
+  stack.PushOpacity(128);
+  EmbeddedViewParams with_opacity(matrix, SkSize::Make(20, 20), stack);
+  ASSERT_FALSE(params == with_opacity);
+  // The params keep their own copy of the stack.
+  ASSERT_EQ(std::distance(params.mutatorsStack().Begin(),
+                          params.mutatorsStack().End()),
+            2);
+}
+
 }  // namespace testing
 }  // namespace flutter
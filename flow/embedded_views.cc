@@ -4,6 +4,11 @@
 
 #include "flutter/flow/embedded_views.h"
 
+#include <new>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/thread_local.h"
+
 namespace flutter {
 
 void ExternalViewEmbedder::SubmitFrame(GrDirectContext* context,
@@ -11,60 +16,202 @@ void ExternalViewEmbedder::SubmitFrame(GrDirectContext* context,
   frame->Submit();
 };
 
+namespace {
+
+size_t HashMutator(const Mutator& mutator) {
+  switch (mutator.GetType()) {
+    case kClipRect: {
+      const SkRect& rect = mutator.GetRect();
+      return fml::HashCombine(kClipRect, rect.fLeft, rect.fTop, rect.fRight,
+                              rect.fBottom);
+    }
+    case kClipRRect: {
+      const SkRRect& rrect = mutator.GetRRect();
+      const SkRect& rect = rrect.rect();
+      size_t hash = fml::HashCombine(kClipRRect, rect.fLeft, rect.fTop,
+                                     rect.fRight, rect.fBottom);
+      for (const SkVector& radii : {rrect.radii(SkRRect::kUpperLeft_Corner),
+                                    rrect.radii(SkRRect::kUpperRight_Corner),
+                                    rrect.radii(SkRRect::kLowerRight_Corner),
+                                    rrect.radii(SkRRect::kLowerLeft_Corner)}) {
+        fml::HashCombineSeed(hash, radii.fX, radii.fY);
+      }
+      return hash;
+    }
+    case kClipPath: {
+      // Equal paths have the same points and verbs, comparing them is left to
+      // the equality check.
+      const SkPath& path = mutator.GetPath();
+      return fml::HashCombine(kClipPath, path.countPoints(), path.countVerbs(),
+                              path.getFillType());
+    }
+    case kTransform: {
+      const SkMatrix& matrix = mutator.GetMatrix();
+      size_t hash = fml::HashCombine(kTransform);
+      for (int i = 0; i < 9; i++) {
+        fml::HashCombineSeed(hash, matrix[i]);
+      }
+      return hash;
+    }
+    case kOpacity:
+      return fml::HashCombine(kOpacity, mutator.GetAlpha());
+    case kBackdropFilter:
+      return fml::HashCombine(kBackdropFilter, mutator.GetFilter().type());
+  }
+  return fml::HashCombine();
+}
+
+// Recycles the memory of released mutator nodes. The embedder may release
+// the stacks of a frame on a different thread than the one that built them,
+// so each thread keeps its own free list and nodes are returned to the list
+// of whichever thread releases them.
+class MutatorNodePool {
+ public:
+  static constexpr size_t kMaxFreeNodes = 256;
+
+  MutatorNodePool() = default;
+
+  ~MutatorNodePool() {
+    while (free_list_) {
+      FreeNode* next = free_list_->next;
+      ::operator delete(free_list_);
+      free_list_ = next;
+    }
+  }
+
+  static MutatorNodePool& GetForCurrentThread() {
+    FML_THREAD_LOCAL fml::ThreadLocalUniquePtr<MutatorNodePool> tls_pool;
+    if (!tls_pool.get()) {
+      tls_pool.reset(new MutatorNodePool());
+    }
+    return *tls_pool.get();
+  }
+
+  void* Allocate(size_t size) {
+    FML_DCHECK(node_size_ == 0 || node_size_ == size);
+    node_size_ = size;
+    if (!free_list_) {
+      return ::operator new(size);
+    }
+    FreeNode* node = free_list_;
+    free_list_ = node->next;
+    free_count_--;
+    return node;
+  }
+
+  void Free(void* memory) {
+    if (free_count_ >= kMaxFreeNodes) {
+      ::operator delete(memory);
+      return;
+    }
+    free_list_ = new (memory) FreeNode{free_list_};
+    free_count_++;
+  }
+
+ private:
+  struct FreeNode {
+    FreeNode* next;
+  };
+
+  FreeNode* free_list_ = nullptr;
+  size_t free_count_ = 0;
+  size_t node_size_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(MutatorNodePool);
+};
+
+}  // namespace
+
+MutatorsStack::Node::Node(fml::RefPtr<const Node> parent,
+                          const Mutator& mutator)
+    : parent_(std::move(parent)),
+      mutator_(mutator),
+      hash_(fml::HashCombine(parent_ ? parent_->hash() : 0,
+                             HashMutator(mutator_))) {}
+
+MutatorsStack::Node::~Node() = default;
+
+void* MutatorsStack::Node::operator new(size_t size) {
+  return MutatorNodePool::GetForCurrentThread().Allocate(size);
+}
+
+void MutatorsStack::Node::operator delete(void* node) {
+  MutatorNodePool::GetForCurrentThread().Free(node);
+}
+
+void MutatorsStack::Push(const Mutator& mutator) {
+  bottom_ = fml::AdoptRef(new Node(std::move(bottom_), mutator));
+  mutators_.push_back(&bottom_->mutator());
+}
+
 void MutatorsStack::PushClipRect(const SkRect& rect) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(rect);
-  vector_.push_back(element);
+  Push(Mutator(rect));
 };
 
 void MutatorsStack::PushClipRRect(const SkRRect& rrect) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(rrect);
-  vector_.push_back(element);
+  Push(Mutator(rrect));
 };
 
 void MutatorsStack::PushClipPath(const SkPath& path) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(path);
-  vector_.push_back(element);
+  Push(Mutator(path));
 };
 
 void MutatorsStack::PushTransform(const SkMatrix& matrix) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(matrix);
-  vector_.push_back(element);
+  Push(Mutator(matrix));
 };
 
 void MutatorsStack::PushOpacity(const int& alpha) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(alpha);
-  vector_.push_back(element);
+  Push(Mutator(alpha));
 };
 
 void MutatorsStack::PushBackdropFilter(const DlImageFilter& filter) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(filter);
-  vector_.push_back(element);
+  Push(Mutator(filter));
 };
 
 void MutatorsStack::Pop() {
-  vector_.pop_back();
+  FML_DCHECK(bottom_);
+  bottom_ = bottom_->parent();
+  mutators_.pop_back();
 };
 
-const std::vector<std::shared_ptr<Mutator>>::const_reverse_iterator
-MutatorsStack::Top() const {
-  return vector_.rend();
+MutatorsStack::const_reverse_iterator MutatorsStack::Top() const {
+  return mutators_.rend();
 };
 
-const std::vector<std::shared_ptr<Mutator>>::const_reverse_iterator
-MutatorsStack::Bottom() const {
-  return vector_.rbegin();
+MutatorsStack::const_reverse_iterator MutatorsStack::Bottom() const {
+  return mutators_.rbegin();
 };
 
-const std::vector<std::shared_ptr<Mutator>>::const_iterator
-MutatorsStack::Begin() const {
-  return vector_.begin();
+MutatorsStack::const_iterator MutatorsStack::Begin() const {
+  return mutators_.begin();
 };
 
-const std::vector<std::shared_ptr<Mutator>>::const_iterator MutatorsStack::End()
-    const {
-  return vector_.end();
+MutatorsStack::const_iterator MutatorsStack::End() const {
+  return mutators_.end();
 };
 
+bool MutatorsStack::operator==(const MutatorsStack& other) const {
+  const Node* node = bottom_.get();
+  const Node* other_node = other.bottom_.get();
+  if (node == other_node) {
+    return true;
+  }
+  if (mutators_.size() != other.mutators_.size() ||
+      node->hash() != other_node->hash()) {
+    return false;
+  }
+  // Both chains have the same length, so they either meet at a shared prefix
+  // or both end after the first mutator.
+  while (node != other_node) {
+    if (node->mutator() != other_node->mutator()) {
+      return false;
+    }
+    node = node->parent().get();
+    other_node = other_node->parent().get();
+  }
+  return true;
+}
+
 bool ExternalViewEmbedder::SupportsDynamicThreadMerging() {
   return false;
 }
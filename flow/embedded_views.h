@@ -106,7 +106,7 @@ class Mutator {
 
   bool operator!=(const Mutator& other) const { return !operator==(other); }
 
-  bool IsClipType() {
+  bool IsClipType() const {
     return type_ == kClipRect || type_ == kClipRRect || type_ == kClipPath;
   }
 
@@ -141,6 +141,10 @@ class Mutator {
 // to a platform view P1 will result in T1(T2(T3(P1))).
 class MutatorsStack {
  public:
+  using const_iterator = std::vector<const Mutator*>::const_iterator;
+  using const_reverse_iterator =
+      std::vector<const Mutator*>::const_reverse_iterator;
+
   MutatorsStack() = default;
 
   void PushClipRect(const SkRect& rect);
@@ -151,46 +155,34 @@ class MutatorsStack {
   void PushBackdropFilter(const DlImageFilter& filter);
 
   // Removes the `Mutator` on the top of the stack
-  // and destroys it.
+  // and destroys it once no other stack shares it.
   void Pop();
 
   // Returns a reverse iterator pointing to the top of the stack, which is the
   // mutator that is furtherest from the leaf node.
-  const std::vector<std::shared_ptr<Mutator>>::const_reverse_iterator Top()
-      const;
+  const_reverse_iterator Top() const;
   // Returns a reverse iterator pointing to the bottom of the stack, which is
   // the mutator that is closeset from the leaf node.
-  const std::vector<std::shared_ptr<Mutator>>::const_reverse_iterator Bottom()
-      const;
+  const_reverse_iterator Bottom() const;
 
   // Returns an iterator pointing to the beginning of the mutator vector, which
   // is the mutator that is furtherest from the leaf node.
-  const std::vector<std::shared_ptr<Mutator>>::const_iterator Begin() const;
+  const_iterator Begin() const;
 
   // Returns an iterator pointing to the end of the mutator vector, which is the
   // mutator that is closest from the leaf node.
-  const std::vector<std::shared_ptr<Mutator>>::const_iterator End() const;
+  const_iterator End() const;
 
-  bool is_empty() const { return vector_.empty(); }
+  bool is_empty() const { return mutators_.empty(); }
 
-  bool operator==(const MutatorsStack& other) const {
-    if (vector_.size() != other.vector_.size()) {
-      return false;
-    }
-    for (size_t i = 0; i < vector_.size(); i++) {
-      if (*vector_[i] != *other.vector_[i]) {
-        return false;
-      }
-    }
-    return true;
-  }
+  bool operator==(const MutatorsStack& other) const;
 
   bool operator==(const std::vector<Mutator>& other) const {
-    if (vector_.size() != other.size()) {
+    if (mutators_.size() != other.size()) {
       return false;
     }
-    for (size_t i = 0; i < vector_.size(); i++) {
-      if (*vector_[i] != other[i]) {
+    for (size_t i = 0; i < mutators_.size(); i++) {
+      if (*mutators_[i] != other[i]) {
         return false;
       }
     }
@@ -206,7 +198,43 @@ class MutatorsStack {
   }
 
  private:
-  std::vector<std::shared_ptr<Mutator>> vector_;
+  // An immutable link in a chain of mutators that ends at the one furthest
+  // from the leaf node. Copies of a stack, and stacks that were pushed onto
+  // from a common prefix, share the nodes of that prefix, so copying a stack
+  // for every embedded view only retains its last node.
+  class Node : public fml::RefCountedThreadSafe<Node> {
+   public:
+    Node(fml::RefPtr<const Node> parent, const Mutator& mutator);
+
+    const fml::RefPtr<const Node>& parent() const { return parent_; }
+    const Mutator& mutator() const { return mutator_; }
+    // Combines the hashes of this mutator and all of the ones before it, so
+    // that most unequal stacks are told apart without walking them.
+    size_t hash() const { return hash_; }
+
+    // Nodes are recycled through a per-thread pool instead of going through
+    // the allocator for each push.
+    static void* operator new(size_t size);
+    static void operator delete(void* node);
+
+   private:
+    const fml::RefPtr<const Node> parent_;
+    const Mutator mutator_;
+    const size_t hash_;
+
+    ~Node();
+
+    FML_FRIEND_REF_COUNTED_THREAD_SAFE(Node);
+    FML_DISALLOW_COPY_AND_ASSIGN(Node);
+  };
+
+  // The most recently pushed node, which is the bottom of the stack.
+  fml::RefPtr<const Node> bottom_;
+  // The mutators of the chain that ends in |bottom_|, in push order. The nodes
+  // own the mutators; this flat view only serves the iterators.
+  std::vector<const Mutator*> mutators_;
+
+  void Push(const Mutator& mutator);
 };  // MutatorsStack
 
 class EmbeddedViewParams {
@@ -75,6 +75,12 @@ bool DisplayListLayer::Compare(DiffContext::Statistics& statistics,
     return false;
   }
 
+  if (dl1->content_hash() != dl2->content_hash()) {
+    statistics.AddAvoidedDeepComparePicture();
+    statistics.AddNewPicture();
+    return false;
+  }
+
   if (op_bytes_1 > kMaxBytesToCompare) {
     statistics.AddPictureTooComplexToCompare();
     return false;
@@ -159,6 +165,9 @@ void DisplayListLayer::Paint(PaintContext& context) const {
     context.leaf_nodes_builder->drawDisplayList(display_list_.skia_object());
     context.leaf_nodes_builder->restoreToCount(restore_count);
   } else {
+    // Only the ops that intersect the clip of the canvas are dispatched,
+    // which skips the parts of large pictures outside of the damage clip
+    // of a partial repaint.
     display_list()->RenderTo(context.leaf_nodes_canvas,
                              context.inherited_opacity);
   }
@@ -0,0 +1,104 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/flow/embedded_views.h"
+
+namespace flutter {
+
+namespace {
+
+// Pushes the mutators of |depth| nested layers, the way preroll builds the
+// stack above a platform view.
+void PushLayers(MutatorsStack& stack, int depth) {
+  for (int i = 0; i < depth; i++) {
+    switch (i % 3) {
+      case 0:
+        stack.PushTransform(SkMatrix::Translate(i, i));
+        break;
+      case 1:
+        stack.PushClipRect(SkRect::MakeWH(1000 - i, 1000 - i));
+        break;
+      case 2:
+        stack.PushOpacity(255 - i);
+        break;
+    }
+  }
+}
+
+// Builds the params of |view_count| platform views that sit below the same
+// |depth| layers, each with a transform and a clip of its own.
+std::vector<std::unique_ptr<EmbeddedViewParams>> BuildFrame(int view_count,
+                                                            int depth) {
+  std::vector<std::unique_ptr<EmbeddedViewParams>> params;
+  MutatorsStack stack;
+  PushLayers(stack, depth);
+  for (int i = 0; i < view_count; i++) {
+    SkMatrix matrix = SkMatrix::Translate(0, i * 50);
+    stack.PushTransform(matrix);
+    stack.PushClipRRect(SkRRect::MakeRectXY(SkRect::MakeWH(100, 50), 8, 8));
+    params.push_back(std::make_unique<EmbeddedViewParams>(
+        matrix, SkSize::Make(100, 50), stack));
+    stack.Pop();
+    stack.Pop();
+  }
+  return params;
+}
+
+}  // namespace
+
+static void BM_MutatorsStackBuildFrame(benchmark::State& state) {
+  const int view_count = state.range(0);
+  const int depth = state.range(1);
+  while (state.KeepRunning()) {
+    auto params = BuildFrame(view_count, depth);
+    benchmark::DoNotOptimize(params);
+  }
+}
+
+// Compares the params of a frame against the ones of the previous frame, like
+// the iOS embedder does to decide whether a platform view needs to be updated.
+static void BM_MutatorsStackCompareFrames(benchmark::State& state) {
+  const int view_count = state.range(0);
+  const int depth = state.range(1);
+  auto previous = BuildFrame(view_count, depth);
+  auto current = BuildFrame(view_count, depth);
+  while (state.KeepRunning()) {
+    int changed = 0;
+    for (int i = 0; i < view_count; i++) {
+      if (!(*previous[i] == *current[i])) {
+        changed++;
+      }
+    }
+    benchmark::DoNotOptimize(changed);
+  }
+}
+
+static void BM_MutatorsStackCopy(benchmark::State& state) {
+  MutatorsStack stack;
+  PushLayers(stack, state.range(0));
+  while (state.KeepRunning()) {
+    MutatorsStack copy = stack;
+    benchmark::DoNotOptimize(copy);
+  }
+}
+
+BENCHMARK(BM_MutatorsStackBuildFrame)
+    ->Args({1, 4})
+    ->Args({16, 4})
+    ->Args({64, 4})
+    ->Args({64, 16})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MutatorsStackCompareFrames)
+    ->Args({1, 4})
+    ->Args({16, 4})
+    ->Args({64, 4})
+    ->Args({64, 16})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MutatorsStackCopy)->RangeMultiplier(4)->Range(1, 64);
+
+}  // namespace flutter
@@ -36,11 +36,11 @@ TEST(MutatorsStack, CopyAndUpdateTheCopy) {
   ASSERT_TRUE(copy.is_empty());
   ASSERT_TRUE(!stack.is_empty());
   auto iter = stack.Bottom();
-  ASSERT_TRUE(iter->get()->GetType() == MutatorType::kClipRRect);
-  ASSERT_TRUE(iter->get()->GetRRect() == rrect);
+  ASSERT_TRUE((*iter)->GetType() == MutatorType::kClipRRect);
+  ASSERT_TRUE((*iter)->GetRRect() == rrect);
   ++iter;
-  ASSERT_TRUE(iter->get()->GetType() == MutatorType::kClipRect);
-  ASSERT_TRUE(iter->get()->GetRect() == rect);
+  ASSERT_TRUE((*iter)->GetType() == MutatorType::kClipRect);
+  ASSERT_TRUE((*iter)->GetRect() == rect);
 }
 
 TEST(MutatorsStack, PushClipRect) {
@@ -48,8 +48,8 @@ TEST(MutatorsStack, PushClipRect) {
   auto rect = SkRect::MakeEmpty();
   stack.PushClipRect(rect);
   auto iter = stack.Bottom();
-  ASSERT_TRUE(iter->get()->GetType() == MutatorType::kClipRect);
-  ASSERT_TRUE(iter->get()->GetRect() == rect);
+  ASSERT_TRUE((*iter)->GetType() == MutatorType::kClipRect);
+  ASSERT_TRUE((*iter)->GetRect() == rect);
 }
 
 TEST(MutatorsStack, PushClipRRect) {
@@ -57,8 +57,8 @@ TEST(MutatorsStack, PushClipRRect) {
   auto rrect = SkRRect::MakeEmpty();
   stack.PushClipRRect(rrect);
   auto iter = stack.Bottom();
-  ASSERT_TRUE(iter->get()->GetType() == MutatorType::kClipRRect);
-  ASSERT_TRUE(iter->get()->GetRRect() == rrect);
+  ASSERT_TRUE((*iter)->GetType() == MutatorType::kClipRRect);
+  ASSERT_TRUE((*iter)->GetRRect() == rrect);
 }
 
 TEST(MutatorsStack, PushClipPath) {
@@ -66,8 +66,8 @@ TEST(MutatorsStack, PushClipPath) {
   SkPath path;
   stack.PushClipPath(path);
   auto iter = stack.Bottom();
-  ASSERT_TRUE(iter->get()->GetType() == flutter::MutatorType::kClipPath);
-  ASSERT_TRUE(iter->get()->GetPath() == path);
+  ASSERT_TRUE((*iter)->GetType() == flutter::MutatorType::kClipPath);
+  ASSERT_TRUE((*iter)->GetPath() == path);
 }
 
 TEST(MutatorsStack, PushTransform) {
@@ -76,8 +76,8 @@ TEST(MutatorsStack, PushTransform) {
   matrix.setIdentity();
   stack.PushTransform(matrix);
   auto iter = stack.Bottom();
-  ASSERT_TRUE(iter->get()->GetType() == MutatorType::kTransform);
-  ASSERT_TRUE(iter->get()->GetMatrix() == matrix);
+  ASSERT_TRUE((*iter)->GetType() == MutatorType::kTransform);
+  ASSERT_TRUE((*iter)->GetMatrix() == matrix);
 }
 
 TEST(MutatorsStack, PushOpacity) {
@@ -85,8 +85,8 @@ TEST(MutatorsStack, PushOpacity) {
   int alpha = 240;
   stack.PushOpacity(alpha);
   auto iter = stack.Bottom();
-  ASSERT_TRUE(iter->get()->GetType() == MutatorType::kOpacity);
-  ASSERT_TRUE(iter->get()->GetAlpha() == 240);
+  ASSERT_TRUE((*iter)->GetType() == MutatorType::kOpacity);
+  ASSERT_TRUE((*iter)->GetAlpha() == 240);
 }
 
 TEST(MutatorsStack, PushBackdropFilter) {
@@ -94,8 +94,8 @@ TEST(MutatorsStack, PushBackdropFilter) {
   auto filter = DlBlurImageFilter(5, 5, DlTileMode::kClamp);
   stack.PushBackdropFilter(filter);
   auto iter = stack.Bottom();
-  ASSERT_TRUE(iter->get()->GetType() == MutatorType::kBackdropFilter);
-  ASSERT_TRUE(iter->get()->GetFilter() == filter);
+  ASSERT_TRUE((*iter)->GetType() == MutatorType::kBackdropFilter);
+  ASSERT_TRUE((*iter)->GetFilter() == filter);
 }
 
 TEST(MutatorsStack, Pop) {
@@ -122,16 +122,16 @@ TEST(MutatorsStack, Traversal) {
   while (iter != stack.Top()) {
     switch (index) {
       case 0:
-        ASSERT_TRUE(iter->get()->GetType() == MutatorType::kClipRRect);
-        ASSERT_TRUE(iter->get()->GetRRect() == rrect);
+        ASSERT_TRUE((*iter)->GetType() == MutatorType::kClipRRect);
+        ASSERT_TRUE((*iter)->GetRRect() == rrect);
         break;
       case 1:
-        ASSERT_TRUE(iter->get()->GetType() == MutatorType::kClipRect);
-        ASSERT_TRUE(iter->get()->GetRect() == rect);
+        ASSERT_TRUE((*iter)->GetType() == MutatorType::kClipRect);
+        ASSERT_TRUE((*iter)->GetRect() == rect);
         break;
       case 2:
-        ASSERT_TRUE(iter->get()->GetType() == MutatorType::kTransform);
-        ASSERT_TRUE(iter->get()->GetMatrix() == matrix);
+        ASSERT_TRUE((*iter)->GetType() == MutatorType::kTransform);
+        ASSERT_TRUE((*iter)->GetMatrix() == matrix);
         break;
       default:
         break;
@@ -169,6 +169,120 @@ TEST(MutatorsStack, Equality) {
   ASSERT_TRUE(stack == stackOther);
 }
 
+TEST(MutatorsStack, ForwardTraversal) {
+  MutatorsStack stack;
+  SkMatrix matrix = SkMatrix::Scale(2, 2);
+  stack.PushTransform(matrix);
+  auto rect = SkRect::MakeWH(10, 10);
+  stack.PushClipRect(rect);
+  int alpha = 128;
+  stack.PushOpacity(alpha);
+
+  std::vector<MutatorType> types;
+  for (auto iter = stack.Begin(); iter != stack.End(); ++iter) {
+    types.push_back((*iter)->GetType());
+  }
+  ASSERT_EQ(types, (std::vector<MutatorType>{MutatorType::kTransform,
+                                             MutatorType::kClipRect,
+                                             MutatorType::kOpacity}));
+}
+
+TEST(MutatorsStack, CopiesAreIndependentOfEachOther) {
+  MutatorsStack stack;
+  stack.PushTransform(SkMatrix::Translate(10, 10));
+  stack.PushClipRect(SkRect::MakeWH(100, 100));
+
+  MutatorsStack copy = stack;
+  copy.Pop();
+  copy.PushClipRRect(SkRRect::MakeRectXY(SkRect::MakeWH(50, 50), 5, 5));
+  stack.PushOpacity(100);
+
+  ASSERT_TRUE(copy != stack);
+  auto iter = stack.Bottom();
+  ASSERT_TRUE((*iter)->GetType() == MutatorType::kOpacity);
+  ++iter;
+  ASSERT_TRUE((*iter)->GetType() == MutatorType::kClipRect);
+  ++iter;
+  ASSERT_TRUE((*iter)->GetType() == MutatorType::kTransform);
+  ++iter;
+  ASSERT_TRUE(iter == stack.Top());
+
+  iter = copy.Bottom();
+  ASSERT_TRUE((*iter)->GetType() == MutatorType::kClipRRect);
+  ++iter;
+  ASSERT_TRUE((*iter)->GetType() == MutatorType::kTransform);
+  ASSERT_TRUE((*iter)->GetMatrix() == SkMatrix::Translate(10, 10));
+  ++iter;
+  ASSERT_TRUE(iter == copy.Top());
+}
+
+TEST(MutatorsStack, EqualityOfStacksSharingAPrefix) {
+  MutatorsStack stack;
+  stack.PushTransform(SkMatrix::Scale(2, 2));
+  stack.PushClipRect(SkRect::MakeWH(100, 100));
+
+  MutatorsStack first = stack;
+  MutatorsStack second = stack;
+  first.PushOpacity(100);
+  second.PushOpacity(100);
+  ASSERT_TRUE(first == second);
+
+  first.Pop();
+  second.Pop();
+  first.PushOpacity(100);
+  second.PushOpacity(101);
+  ASSERT_TRUE(first != second);
+
+  second.Pop();
+  ASSERT_TRUE(first != second);
+  ASSERT_TRUE(second == stack);
+}
+
+TEST(MutatorsStack, EqualityOfStacksBuiltSeparately) {
+  MutatorsStack stack;
+  MutatorsStack other;
+  for (MutatorsStack* s : {&stack, &other}) {
+    s->PushTransform(SkMatrix::Scale(2, 2));
+    s->PushClipRect(SkRect::MakeWH(100, 100));
+  }
+  ASSERT_TRUE(stack == other);
+
+  stack.PushClipRect(SkRect::MakeWH(10, 10));
+  other.PushClipRect(SkRect::MakeWH(10, 20));
+  ASSERT_TRUE(stack != other);
+
+  // Stacks with the same mutators in a different order are not equal.
+  MutatorsStack reversed;
+  reversed.PushClipRect(SkRect::MakeWH(100, 100));
+  reversed.PushTransform(SkMatrix::Scale(2, 2));
+  stack.Pop();
+  ASSERT_TRUE(stack != reversed);
+
+  // Zero and negative zero are equal, so they must hash the same.
+  MutatorsStack zero;
+  zero.PushClipRect(SkRect::MakeLTRB(0, 0, 10, 10));
+  MutatorsStack negative_zero;
+  negative_zero.PushClipRect(SkRect::MakeLTRB(-0.0f, -0.0f, 10, 10));
+  ASSERT_TRUE(zero == negative_zero);
+}
+
+TEST(MutatorsStack, PoppedMutatorsOutliveCopies) {
+  MutatorsStack copy;
+  {
+    MutatorsStack stack;
+    SkPath path;
+    path.addCircle(10, 10, 5);
+    stack.PushClipPath(path);
+    copy = stack;
+    stack.Pop();
+    ASSERT_TRUE(stack.is_empty());
+  }
+  ASSERT_FALSE(copy.is_empty());
+  SkPath path;
+  path.addCircle(10, 10, 5);
+  ASSERT_TRUE((*copy.Bottom())->GetPath() == path);
+}
+
 TEST(Mutator, Initialization) {
   SkRect rect = SkRect::MakeEmpty();
   Mutator mutator = Mutator(rect);
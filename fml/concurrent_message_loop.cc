@@ -5,6 +5,7 @@
 #include "flutter/fml/concurrent_message_loop.h"
 
 #include <algorithm>
+#include <utility>
 
 #include "flutter/fml/thread.h"
 #include "flutter/fml/trace_event.h"
@@ -12,17 +13,23 @@
 namespace fml {
 
 std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
-    size_t worker_count) {
+    size_t worker_count,
+    std::optional<Thread::ThreadPolicy> worker_policy) {
   return std::shared_ptr<ConcurrentMessageLoop>{
-      new ConcurrentMessageLoop(worker_count)};
+      new ConcurrentMessageLoop(worker_count, std::move(worker_policy))};
 }
 
-ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
+ConcurrentMessageLoop::ConcurrentMessageLoop(
+    size_t worker_count,
+    std::optional<Thread::ThreadPolicy> worker_policy)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
   for (size_t i = 0; i < worker_count_; ++i) {
-    workers_.emplace_back([i, this]() {
+    workers_.emplace_back([i, worker_policy, this]() {
       fml::Thread::SetCurrentThreadName(fml::Thread::ThreadConfig(
           std::string{"io.worker." + std::to_string(i + 1)}));
+      if (worker_policy.has_value()) {
+        fml::Thread::SetCurrentThreadPolicy(worker_policy.value());
+      }
       WorkerMain();
     });
   }
@@ -7,12 +7,14 @@
 
 #include <condition_variable>
 #include <map>
+#include <optional>
 #include <queue>
 #include <thread>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
+#include "flutter/fml/thread.h"
 
 namespace fml {
 
@@ -21,8 +23,11 @@ class ConcurrentTaskRunner;
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
+  /// Creates a loop with |worker_count| worker threads that each apply
+  /// |worker_policy|, if any, before they start running tasks.
   static std::shared_ptr<ConcurrentMessageLoop> Create(
-      size_t worker_count = std::thread::hardware_concurrency());
+      size_t worker_count = std::thread::hardware_concurrency(),
+      std::optional<Thread::ThreadPolicy> worker_policy = std::nullopt);
 
   ~ConcurrentMessageLoop();
 
@@ -46,7 +51,8 @@ class ConcurrentMessageLoop
   std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
   bool shutdown_ = false;
 
-  explicit ConcurrentMessageLoop(size_t worker_count);
+  ConcurrentMessageLoop(size_t worker_count,
+                        std::optional<Thread::ThreadPolicy> worker_policy);
 
   void WorkerMain();
 
@@ -0,0 +1,209 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/memory/memory_governor.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace fml {
+
+MemoryGovernor::Registration::Registration(MemoryGovernor* governor,
+                                           uint64_t id)
+    : governor_(governor), id_(id) {}
+
+MemoryGovernor::Registration::~Registration() {
+  governor_->Unregister(id_);
+}
+
+void MemoryGovernor::Registration::ReportBytes(size_t bytes) {
+  governor_->ReportBytes(id_, bytes);
+}
+
+MemoryGovernor& MemoryGovernor::GetInstance() {
+  static MemoryGovernor* instance = new MemoryGovernor();
+  return *instance;
+}
+
+MemoryGovernor::MemoryGovernor() = default;
+
+MemoryGovernor::~MemoryGovernor() {
+  FML_DCHECK(caches_.empty());
+}
+
+std::unique_ptr<MemoryGovernor::Registration> MemoryGovernor::Register(
+    std::string name,
+    Priority priority,
+    TrimCallback trim) {
+  FML_DCHECK(trim);
+  std::scoped_lock lock(mutex_);
+  const uint64_t id = next_id_++;
+  Cache& cache = caches_[id];
+  cache.stats.name = std::move(name);
+  cache.stats.priority = priority;
+  cache.trim = std::move(trim);
+  return std::unique_ptr<Registration>(new Registration(this, id));
+}
+
+void MemoryGovernor::Unregister(uint64_t id) {
+  std::scoped_lock trim_lock(trim_mutex_);
+  std::scoped_lock lock(mutex_);
+  auto found = caches_.find(id);
+  FML_DCHECK(found != caches_.end());
+  total_bytes_ -= found->second.stats.bytes;
+  caches_.erase(found);
+  TraceTotalLocked();
+}
+
+void MemoryGovernor::ReportBytes(uint64_t id, size_t bytes) {
+  Trims trims;
+  {
+    std::scoped_lock lock(mutex_);
+    auto found = caches_.find(id);
+    FML_DCHECK(found != caches_.end());
+    CacheStats& stats = found->second.stats;
+    const size_t previous_bytes = stats.bytes;
+    stats.bytes = bytes;
+    stats.peak_bytes = std::max(stats.peak_bytes, bytes);
+    total_bytes_ = total_bytes_ - previous_bytes + bytes;
+    peak_total_bytes_ = std::max(peak_total_bytes_, total_bytes_);
+    TraceTotalLocked();
+    // Only growth triggers trimming, so that caches which report their size
+    // after being trimmed are not asked to trim again.
+    if (bytes > previous_bytes) {
+      trims = CollectBudgetTrimsLocked();
+    }
+  }
+  RunTrims(trims);
+}
+
+void MemoryGovernor::SetBudgetBytes(size_t budget_bytes) {
+  Trims trims;
+  {
+    std::scoped_lock lock(mutex_);
+    budget_bytes_ = budget_bytes;
+    trims = CollectBudgetTrimsLocked();
+  }
+  RunTrims(trims);
+}
+
+size_t MemoryGovernor::GetBudgetBytes() const {
+  std::scoped_lock lock(mutex_);
+  return budget_bytes_;
+}
+
+void MemoryGovernor::NotifyPressure(Pressure pressure) {
+  TRACE_EVENT0("flutter", "MemoryGovernor::NotifyPressure");
+  Trims trims;
+  {
+    std::scoped_lock lock(mutex_);
+    for (auto& [id, cache] : caches_) {
+      if (pressure == Pressure::kModerate &&
+          cache.stats.priority != Priority::kLow) {
+        continue;
+      }
+      cache.stats.trim_count++;
+      trims.emplace_back(id, 0);
+    }
+  }
+  RunTrims(trims);
+}
+
+size_t MemoryGovernor::GetTotalBytes() const {
+  std::scoped_lock lock(mutex_);
+  return total_bytes_;
+}
+
+size_t MemoryGovernor::GetPeakTotalBytes() const {
+  std::scoped_lock lock(mutex_);
+  return peak_total_bytes_;
+}
+
+std::vector<MemoryGovernor::CacheStats> MemoryGovernor::GetCacheStats() const {
+  std::vector<CacheStats> stats;
+  {
+    std::scoped_lock lock(mutex_);
+    stats.reserve(caches_.size());
+    for (const auto& [id, cache] : caches_) {
+      stats.push_back(cache.stats);
+    }
+  }
+  std::stable_sort(stats.begin(), stats.end(),
+                   [](const CacheStats& a, const CacheStats& b) {
+                     return a.priority < b.priority;
+                   });
+  return stats;
+}
+
+MemoryGovernor::Trims MemoryGovernor::CollectBudgetTrimsLocked() {
+  Trims trims;
+  if (budget_bytes_ == 0 || total_bytes_ <= budget_bytes_) {
+    return trims;
+  }
+  // Within a priority, the largest caches are trimmed first so that as few
+  // caches as possible lose their contents.
+  std::vector<std::pair<uint64_t, Cache*>> order;
+  order.reserve(caches_.size());
+  for (auto& [id, cache] : caches_) {
+    order.emplace_back(id, &cache);
+  }
+  std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+    const CacheStats& a_stats = a.second->stats;
+    const CacheStats& b_stats = b.second->stats;
+    if (a_stats.priority != b_stats.priority) {
+      return a_stats.priority < b_stats.priority;
+    }
+    return a_stats.bytes > b_stats.bytes;
+  });
+
+  size_t excess_bytes = total_bytes_ - budget_bytes_;
+  for (const auto& [id, cache] : order) {
+    if (excess_bytes == 0) {
+      break;
+    }
+    const size_t bytes = cache->stats.bytes;
+    if (bytes == 0) {
+      continue;
+    }
+    const size_t released_bytes = std::min(bytes, excess_bytes);
+    excess_bytes -= released_bytes;
+    cache->stats.trim_count++;
+    trims.emplace_back(id, bytes - released_bytes);
+  }
+  return trims;
+}
+
+void MemoryGovernor::RunTrims(const Trims& trims) {
+  if (trims.empty()) {
+    return;
+  }
+  // Caches may have been unregistered since the trims were collected. As
+  // |Unregister| takes |trim_mutex_| first, the caches that are still
+  // registered once it is held stay alive until their trim returns.
+  std::scoped_lock trim_lock(trim_mutex_);
+  for (const auto& [id, target_bytes] : trims) {
+    TrimCallback trim;
+    {
+      std::scoped_lock lock(mutex_);
+      auto found = caches_.find(id);
+      if (found == caches_.end()) {
+        continue;
+      }
+      trim = found->second.trim;
+    }
+    trim(target_bytes);
+  }
+}
+
+void MemoryGovernor::TraceTotalLocked() const {
+  FML_TRACE_COUNTER("flutter",                          //
+                    "MemoryGovernor",                   //
+                    reinterpret_cast<int64_t>(this),    //
+                    "KBytes", total_bytes_ / 1024,      //
+                    "BudgetKBytes", budget_bytes_ / 1024);
+}
+
+}  // namespace fml
@@ -0,0 +1,169 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_MEMORY_MEMORY_GOVERNOR_H_
+#define FLUTTER_FML_MEMORY_MEMORY_GOVERNOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+
+namespace fml {
+
+//------------------------------------------------------------------------------
+/// @brief      Keeps track of the memory retained by the caches of the engine
+///             and asks them to release some of it when their total exceeds a
+///             budget, or when the system runs low on memory.
+///
+///             Caches register with a name, a priority and a callback that
+///             trims them down to a number of bytes, and report their size
+///             whenever it changes. When the total grows beyond the budget,
+///             the caches with the lowest priority are trimmed first, and the
+///             ones with a higher priority only once those below them are
+///             empty.
+///
+///             Trim callbacks are invoked on the thread that reported the
+///             growth or the memory pressure, with the governor's trim mutex
+///             held but not the mutex that guards its bookkeeping. The trim
+///             mutex is recursive, so callbacks may report sizes. Caches that
+///             are confined to a thread post the trim to it, and report their
+///             new size once they are done. Sizes must not be reported while
+///             holding a lock that the trim callback acquires.
+///
+///             Destroying a registration acquires the trim mutex, so it waits
+///             for running trims to finish and trim callbacks never outlive
+///             their cache. A trim callback must therefore never wait
+///             synchronously on a thread that may be destroying a
+///             registration, as that thread waits on the callback in turn.
+///
+class MemoryGovernor {
+ public:
+  enum class Priority {
+    /// Caches that are cheap to repopulate. Trimmed first.
+    kLow,
+    kNormal,
+    /// Caches whose contents are expensive to recreate. Trimmed last.
+    kHigh,
+  };
+
+  /// How much memory the system asks the engine to release.
+  enum class Pressure {
+    /// Empties the caches with a low priority.
+    kModerate,
+    /// Empties all caches.
+    kCritical,
+  };
+
+  /// Trims a cache down to at most the given number of bytes.
+  using TrimCallback = std::function<void(size_t target_bytes)>;
+
+  struct CacheStats {
+    std::string name;
+    Priority priority;
+    size_t bytes = 0;
+    size_t peak_bytes = 0;
+    /// The number of times the cache was asked to trim itself.
+    size_t trim_count = 0;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      The registration of a cache, which it reports its size
+  ///             through. The cache is unregistered when this is destroyed,
+  ///             which must happen before the governor is destroyed.
+  ///
+  class Registration {
+   public:
+    ~Registration();
+
+    /// Records the number of bytes that the cache currently retains, which
+    /// trims caches if the total grew beyond the budget.
+    void ReportBytes(size_t bytes);
+
+   private:
+    friend class MemoryGovernor;
+
+    MemoryGovernor* const governor_;
+    const uint64_t id_;
+
+    Registration(MemoryGovernor* governor, uint64_t id);
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Registration);
+  };
+
+  /// The governor that the caches of all engines in the process share.
+  static MemoryGovernor& GetInstance();
+
+  MemoryGovernor();
+
+  ~MemoryGovernor();
+
+  [[nodiscard]] std::unique_ptr<Registration> Register(std::string name,
+                                                       Priority priority,
+                                                       TrimCallback trim);
+
+  /// Sets the number of bytes that the caches together may retain, or 0 for
+  /// no limit, and trims caches if they retain more than that.
+  void SetBudgetBytes(size_t budget_bytes);
+
+  size_t GetBudgetBytes() const;
+
+  /// Asks caches to release memory according to |pressure|, regardless of
+  /// the budget.
+  void NotifyPressure(Pressure pressure);
+
+  size_t GetTotalBytes() const;
+
+  size_t GetPeakTotalBytes() const;
+
+  /// The stats of every registered cache, from the lowest to the highest
+  /// priority.
+  std::vector<CacheStats> GetCacheStats() const;
+
+ private:
+  struct Cache {
+    CacheStats stats;
+    TrimCallback trim;
+  };
+
+  // The ids of the caches to trim and their target sizes.
+  using Trims = std::vector<std::pair<uint64_t, size_t>>;
+
+  // Held while trim callbacks run and while caches are unregistered, and
+  // always acquired before |mutex_|. Recursive because trims may report sizes
+  // that trigger further trims on the same thread.
+  std::recursive_mutex trim_mutex_;
+  mutable std::mutex mutex_;
+  size_t budget_bytes_ = 0;
+  size_t total_bytes_ = 0;
+  size_t peak_total_bytes_ = 0;
+  uint64_t next_id_ = 0;
+  std::map<uint64_t, Cache> caches_;
+
+  void Unregister(uint64_t id);
+
+  void ReportBytes(uint64_t id, size_t bytes);
+
+  // The caches to trim and their targets for the total to fit into the
+  // budget.
+  Trims CollectBudgetTrimsLocked();
+
+  // Invokes the trim callbacks of the caches that are still registered.
+  void RunTrims(const Trims& trims);
+
+  void TraceTotalLocked() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(MemoryGovernor);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_MEMORY_MEMORY_GOVERNOR_H_
@@ -0,0 +1,145 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/memory/memory_governor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace {
+
+// A cache that releases memory as soon as it is asked to.
+class TestCache {
+ public:
+  TestCache(MemoryGovernor& governor,
+            std::string name,
+            MemoryGovernor::Priority priority)
+      : registration_(governor.Register(std::move(name), priority,
+                                        [this](size_t target_bytes) {
+                                          SetBytes(std::min(bytes_,
+                                                            target_bytes));
+                                        })) {}
+
+  void SetBytes(size_t bytes) {
+    bytes_ = bytes;
+    registration_->ReportBytes(bytes);
+  }
+
+  size_t bytes() const { return bytes_; }
+
+ private:
+  size_t bytes_ = 0;
+  std::unique_ptr<MemoryGovernor::Registration> registration_;
+};
+
+}  // namespace
+
+TEST(MemoryGovernorTest, TracksCurrentAndPeakBytes) {
+  MemoryGovernor governor;
+  {
+    TestCache images(governor, "images", MemoryGovernor::Priority::kNormal);
+    TestCache glyphs(governor, "glyphs", MemoryGovernor::Priority::kLow);
+    images.SetBytes(300);
+    glyphs.SetBytes(100);
+    images.SetBytes(200);
+    EXPECT_EQ(governor.GetTotalBytes(), 300u);
+    EXPECT_EQ(governor.GetPeakTotalBytes(), 400u);
+
+    std::vector<MemoryGovernor::CacheStats> stats = governor.GetCacheStats();
+    ASSERT_EQ(stats.size(), 2u);
+    EXPECT_EQ(stats[0].name, "glyphs");
+    EXPECT_EQ(stats[0].bytes, 100u);
+    EXPECT_EQ(stats[1].name, "images");
+    EXPECT_EQ(stats[1].bytes, 200u);
+    EXPECT_EQ(stats[1].peak_bytes, 300u);
+  }
+  // Unregistered caches no longer count.
+  EXPECT_EQ(governor.GetTotalBytes(), 0u);
+  EXPECT_TRUE(governor.GetCacheStats().empty());
+}
+
+TEST(MemoryGovernorTest, TrimsLowPriorityCachesFirstOverBudget) {
+  MemoryGovernor governor;
+  TestCache raster(governor, "raster", MemoryGovernor::Priority::kHigh);
+  TestCache layout(governor, "layout", MemoryGovernor::Priority::kLow);
+  TestCache fonts(governor, "fonts", MemoryGovernor::Priority::kNormal);
+  governor.SetBudgetBytes(1000);
+  raster.SetBytes(500);
+  layout.SetBytes(200);
+  fonts.SetBytes(300);
+  EXPECT_EQ(layout.bytes(), 200u);
+
+  // Going 150 bytes over the budget only trims the low priority cache.
+  raster.SetBytes(650);
+  EXPECT_EQ(layout.bytes(), 50u);
+  EXPECT_EQ(fonts.bytes(), 300u);
+  EXPECT_EQ(raster.bytes(), 650u);
+
+  // Caches of higher priorities are trimmed once the ones below are empty.
+  raster.SetBytes(900);
+  EXPECT_EQ(layout.bytes(), 0u);
+  EXPECT_EQ(fonts.bytes(), 100u);
+  EXPECT_EQ(raster.bytes(), 900u);
+  EXPECT_EQ(governor.GetTotalBytes(), 1000u);
+
+  // Lowering the budget trims right away.
+  governor.SetBudgetBytes(600);
+  EXPECT_EQ(fonts.bytes(), 0u);
+  EXPECT_EQ(raster.bytes(), 600u);
+}
+
+TEST(MemoryGovernorTest, EmptiesCachesUnderPressure) {
+  MemoryGovernor governor;
+  TestCache raster(governor, "raster", MemoryGovernor::Priority::kHigh);
+  TestCache layout(governor, "layout", MemoryGovernor::Priority::kLow);
+  raster.SetBytes(500);
+  layout.SetBytes(200);
+
+  governor.NotifyPressure(MemoryGovernor::Pressure::kModerate);
+  EXPECT_EQ(layout.bytes(), 0u);
+  EXPECT_EQ(raster.bytes(), 500u);
+
+  governor.NotifyPressure(MemoryGovernor::Pressure::kCritical);
+  EXPECT_EQ(raster.bytes(), 0u);
+  EXPECT_EQ(governor.GetTotalBytes(), 0u);
+
+  std::vector<MemoryGovernor::CacheStats> stats = governor.GetCacheStats();
+  ASSERT_EQ(stats.size(), 2u);
+  EXPECT_EQ(stats[0].trim_count, 2u);
+  EXPECT_EQ(stats[1].trim_count, 1u);
+}
+
+TEST(MemoryGovernorTest, DoesNotTrimUnregisteredCaches) {
+  MemoryGovernor governor;
+  std::atomic_bool done = false;
+  std::atomic_int late_trims = 0;
+  std::thread pressure([&governor, &done]() {
+    while (!done) {
+      governor.NotifyPressure(MemoryGovernor::Pressure::kCritical);
+    }
+  });
+  for (int i = 0; i < 10000; i++) {
+    auto destroyed = std::make_shared<std::atomic_bool>(false);
+    auto registration = governor.Register(
+        "transient", MemoryGovernor::Priority::kLow,
+        [destroyed, &late_trims](size_t target_bytes) {
+          if (*destroyed) {
+            late_trims++;
+          }
+        });
+    registration->ReportBytes(100);
+    // Once unregistered, the cache may be destroyed and must not be trimmed.
+    registration.reset();
+    *destroyed = true;
+  }
+  done = true;
+  pressure.join();
+  EXPECT_EQ(late_trims, 0);
+}
+
+}  // namespace fml
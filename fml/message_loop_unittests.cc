@@ -6,6 +6,7 @@
 
 #include "flutter/fml/message_loop.h"
 
+#include <atomic>
 #include <iostream>
 #include <thread>
 
@@ -17,6 +18,10 @@
 #include "flutter/fml/time/chrono_timestamp_provider.h"
 #include "gtest/gtest.h"
 
+#if defined(FML_OS_LINUX) || defined(FML_OS_ANDROID)
+#include <sys/resource.h>
+#endif
+
 #define TIMESENSITIVE(x) TimeSensitiveTest_##x
 #if FML_OS_WIN
 #define PLATFORM_SPECIFIC_CAPTURE(...) [ __VA_ARGS__, count ]
@@ -317,3 +322,21 @@ TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   latch.Wait();
   ASSERT_GE(thread_ids.size(), 1u);
 }
+
+#if defined(FML_OS_LINUX) || defined(FML_OS_ANDROID)
+TEST(MessageLoop, ConcurrentMessageLoopWorkersApplyThreadPolicy) {
+  fml::Thread::ThreadPolicy policy;
+  policy.nice = 19;
+  auto loop = fml::ConcurrentMessageLoop::Create(2u, policy);
+  fml::CountDownLatch latch(loop->GetWorkerCount());
+  std::atomic_int nice_workers = 0;
+  loop->PostTaskToAllWorkers([&]() {
+    if (getpriority(PRIO_PROCESS, 0) == 19) {
+      nice_workers++;
+    }
+    latch.CountDown();
+  });
+  latch.Wait();
+  ASSERT_EQ(nice_workers, 2);
+}
+#endif
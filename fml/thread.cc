@@ -6,11 +6,13 @@
 
 #include "flutter/fml/thread.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
 
 #include "flutter/fml/build_config.h"
+#include "flutter/fml/logging.h"
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 
@@ -22,6 +24,14 @@
 #include <pthread.h>
 #endif
 
+#if defined(FML_OS_LINUX) || defined(FML_OS_ANDROID)
+#include <sched.h>
+#include <sys/resource.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
 namespace fml {
 
 #if defined(FML_OS_WIN)
@@ -67,6 +77,67 @@ void Thread::SetCurrentThreadName(const Thread::ThreadConfig& config) {
   SetThreadName(config.name);
 }
 
+bool Thread::SetCurrentThreadPolicy(const ThreadPolicy& policy) {
+#if defined(FML_OS_LINUX) || defined(FML_OS_ANDROID)
+  bool applied = true;
+
+  if (!policy.cpus.empty()) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : policy.cpus) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &cpu_set);
+      }
+    }
+    // A pid of 0 refers to the calling thread.
+    if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+      FML_LOG(WARNING) << "Could not set the CPU affinity of the thread: "
+                       << strerror(errno);
+      applied = false;
+    }
+  }
+
+  bool realtime = false;
+  if (policy.scheduler != ThreadPolicy::Scheduler::kDefault) {
+    const int scheduler = policy.scheduler == ThreadPolicy::Scheduler::kFifo
+                              ? SCHED_FIFO
+                              : SCHED_RR;
+    sched_param param = {};
+    param.sched_priority = std::clamp(policy.realtime_priority,
+                                      sched_get_priority_min(scheduler),
+                                      sched_get_priority_max(scheduler));
+    const int result = pthread_setschedparam(pthread_self(), scheduler, &param);
+    if (result == 0) {
+      realtime = true;
+    } else {
+      FML_LOG(WARNING) << "Could not use a real-time scheduler for the thread ("
+                       << strerror(result) << "), falling back to its nice "
+                       << "value.";
+      applied = false;
+    }
+  }
+
+  // Linux keeps a nice value per thread, and a who of 0 refers to the calling
+  // thread. It has no effect on threads with a real-time scheduler.
+  if (!realtime && policy.nice.has_value()) {
+    if (setpriority(PRIO_PROCESS, 0, policy.nice.value()) != 0) {
+      FML_LOG(WARNING) << "Could not set the nice value of the thread: "
+                       << strerror(errno);
+      applied = false;
+    }
+  }
+
+  return applied;
+#else
+  const bool is_empty = policy.cpus.empty() && !policy.nice.has_value() &&
+                        policy.scheduler == ThreadPolicy::Scheduler::kDefault;
+  if (!is_empty) {
+    FML_DLOG(INFO) << "Thread policies are not supported on this platform.";
+  }
+  return is_empty;
+#endif
+}
+
 Thread::Thread(const std::string& name)
     : Thread(Thread::SetCurrentThreadName, ThreadConfig(name)) {}
 
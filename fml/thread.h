@@ -8,8 +8,10 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
@@ -46,6 +48,33 @@ class Thread {
 
   using ThreadConfigSetter = std::function<void(const ThreadConfig&)>;
 
+  /// The CPU affinity and scheduling policy of a thread. Attributes that are
+  /// left unset are not changed when the policy is applied.
+  struct ThreadPolicy {
+    enum class Scheduler {
+      /// The default time-sharing scheduler of the platform.
+      kDefault,
+      /// SCHED_FIFO.
+      kFifo,
+      /// SCHED_RR.
+      kRoundRobin,
+    };
+
+    /// The CPUs the thread may run on. Empty to allow any CPU.
+    std::vector<int> cpus;
+
+    /// The nice value of the thread, from -20 (most favorable) to 19. Also
+    /// used when a real-time scheduler was requested but could not be set.
+    std::optional<int> nice;
+
+    /// Real-time schedulers need CAP_SYS_NICE or a large enough RLIMIT_RTPRIO.
+    Scheduler scheduler = Scheduler::kDefault;
+
+    /// The priority of the thread within a real-time scheduler. Clamped to
+    /// the range the platform supports.
+    int realtime_priority = 1;
+  };
+
   explicit Thread(const std::string& name = "");
 
   explicit Thread(const ThreadConfigSetter& setter,
@@ -59,6 +88,11 @@ class Thread {
 
   static void SetCurrentThreadName(const ThreadConfig& config);
 
+  /// Applies |policy| to the calling thread. Returns false if any part of it
+  /// could not be applied, including when a real-time scheduler fell back to
+  /// the nice value. Only Linux and Android support thread policies.
+  static bool SetCurrentThreadPolicy(const ThreadPolicy& policy);
+
  private:
   std::unique_ptr<std::thread> thread_;
 
@@ -0,0 +1,131 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace fml {
+namespace benchmarking {
+
+namespace {
+
+enum class RasterPolicy {
+  // The raster thread competes with the load like any other thread.
+  kNone,
+  // The raster thread asks for SCHED_FIFO, and is made less nice instead
+  // when the benchmark runs without the privileges for it.
+  kRealtime,
+  // The raster thread gets a CPU of its own, which the load stays off.
+  kIsolatedCPU,
+};
+
+// Keeps twice as many threads as there are CPUs spinning until destroyed.
+class SyntheticCPULoad {
+ public:
+  explicit SyntheticCPULoad(const Thread::ThreadPolicy& policy) {
+    const size_t thread_count =
+        std::max(std::thread::hardware_concurrency(), 1u) * 2;
+    for (size_t i = 0; i < thread_count; i++) {
+      threads_.emplace_back([this, policy]() {
+        Thread::SetCurrentThreadPolicy(policy);
+        while (!stop_.load(std::memory_order_relaxed)) {
+        }
+      });
+    }
+  }
+
+  ~SyntheticCPULoad() {
+    stop_ = true;
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+ private:
+  std::atomic_bool stop_ = false;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace
+
+// Measures the time between posting a task to an idle raster thread and the
+// task starting to run, while every CPU is busy with other threads.
+static void BM_RasterThreadWakeupLatencyUnderLoad(benchmark::State& state,
+                                                  RasterPolicy kind) {
+  const unsigned int cpu_count =
+      std::max(std::thread::hardware_concurrency(), 1u);
+  Thread::ThreadPolicy raster_policy;
+  Thread::ThreadPolicy load_policy;
+  switch (kind) {
+    case RasterPolicy::kNone:
+      break;
+    case RasterPolicy::kRealtime:
+      raster_policy.scheduler = Thread::ThreadPolicy::Scheduler::kFifo;
+      raster_policy.nice = -10;
+      break;
+    case RasterPolicy::kIsolatedCPU:
+      if (cpu_count < 2) {
+        state.SkipWithError("Needs at least two CPUs.");
+        return;
+      }
+      raster_policy.cpus = {0};
+      for (unsigned int cpu = 1; cpu < cpu_count; cpu++) {
+        load_policy.cpus.push_back(cpu);
+      }
+      break;
+  }
+
+  bool policy_applied = false;
+  Thread raster_thread(
+      [&raster_policy, &policy_applied](const Thread::ThreadConfig& config) {
+        Thread::SetCurrentThreadName(config);
+        policy_applied = Thread::SetCurrentThreadPolicy(raster_policy);
+      },
+      Thread::ThreadConfig("raster"));
+  auto raster_task_runner = raster_thread.GetTaskRunner();
+  SyntheticCPULoad load(load_policy);
+
+  AutoResetWaitableEvent ran;
+  TimePoint started;
+  while (state.KeepRunning()) {
+    // Gives the raster thread time to go back to sleep.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    const TimePoint posted = TimePoint::Now();
+    raster_task_runner->PostTask([&ran, &started]() {
+      started = TimePoint::Now();
+      ran.Signal();
+    });
+    ran.Wait();
+    state.SetIterationTime((started - posted).ToSecondsF());
+  }
+  state.counters["PolicyApplied"] = policy_applied ? 1 : 0;
+}
+
+BENCHMARK_CAPTURE(BM_RasterThreadWakeupLatencyUnderLoad,
+                  NoPolicy,
+                  RasterPolicy::kNone)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RasterThreadWakeupLatencyUnderLoad,
+                  Realtime,
+                  RasterPolicy::kRealtime)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RasterThreadWakeupLatencyUnderLoad,
+                  IsolatedCPU,
+                  RasterPolicy::kIsolatedCPU)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace benchmarking
+}  // namespace fml
@@ -16,8 +16,15 @@
 #endif
 
 #include <memory>
+
+#include "flutter/fml/build_config.h"
 #include "gtest/gtest.h"
 
+#if defined(FML_OS_LINUX) || defined(FML_OS_ANDROID)
+#include <sched.h>
+#include <sys/resource.h>
+#endif
+
 TEST(Thread, CanStartAndEnd) {
   fml::Thread thread;
   ASSERT_TRUE(thread.GetTaskRunner());
@@ -110,3 +117,84 @@ TEST(Thread, ThreadPriorityCreatedWithConfig) {
   ASSERT_TRUE(done);
 }
 #endif
+
+TEST(Thread, EmptyThreadPolicyIsAlwaysApplied) {
+  fml::Thread thread;
+  bool applied = false;
+  thread.GetTaskRunner()->PostTask([&applied]() {
+    applied = fml::Thread::SetCurrentThreadPolicy(fml::Thread::ThreadPolicy());
+  });
+  thread.Join();
+  ASSERT_TRUE(applied);
+}
+
+#if defined(FML_OS_LINUX) || defined(FML_OS_ANDROID)
+static int GetFirstAllowedCPU() {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  sched_getaffinity(0, sizeof(cpu_set), &cpu_set);
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &cpu_set)) {
+      return cpu;
+    }
+  }
+  return 0;
+}
+
+TEST(Thread, ThreadPolicySetsAffinityAndNiceValue) {
+  const int cpu = GetFirstAllowedCPU();
+  fml::Thread::ThreadPolicy policy;
+  policy.cpus = {cpu};
+  // Unprivileged threads may always make themselves nicer.
+  policy.nice = 19;
+
+  fml::Thread thread(
+      [policy](const fml::Thread::ThreadConfig& config) {
+        fml::Thread::SetCurrentThreadName(config);
+        fml::Thread::SetCurrentThreadPolicy(policy);
+      },
+      fml::Thread::ThreadConfig("Pinned"));
+  bool done = false;
+  thread.GetTaskRunner()->PostTask([&]() {
+    done = true;
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set), &cpu_set), 0);
+    ASSERT_EQ(CPU_COUNT(&cpu_set), 1);
+    ASSERT_TRUE(CPU_ISSET(cpu, &cpu_set));
+    ASSERT_EQ(getpriority(PRIO_PROCESS, 0), 19);
+  });
+  thread.Join();
+  ASSERT_TRUE(done);
+
+  // The policy only applies to the thread it was set on.
+  ASSERT_NE(getpriority(PRIO_PROCESS, 0), 19);
+}
+
+TEST(Thread, RealtimeThreadPolicyFallsBackToNiceValue) {
+  fml::Thread thread;
+  bool done = false;
+  thread.GetTaskRunner()->PostTask([&done]() {
+    done = true;
+    fml::Thread::ThreadPolicy policy;
+    policy.scheduler = fml::Thread::ThreadPolicy::Scheduler::kFifo;
+    policy.realtime_priority = 1;
+    policy.nice = 19;
+    const bool applied = fml::Thread::SetCurrentThreadPolicy(policy);
+
+    int scheduler;
+    sched_param param;
+    pthread_getschedparam(pthread_self(), &scheduler, &param);
+    if (applied) {
+      // The test runs with CAP_SYS_NICE.
+      ASSERT_EQ(scheduler, SCHED_FIFO);
+      ASSERT_EQ(param.sched_priority, 1);
+    } else {
+      ASSERT_EQ(scheduler, SCHED_OTHER);
+      ASSERT_EQ(getpriority(PRIO_PROCESS, 0), 19);
+    }
+  });
+  thread.Join();
+  ASSERT_TRUE(done);
+}
+#endif
@@ -11,6 +11,7 @@
 #include "flutter/fml/ascii_trie.h"
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/trace_recorder.h"
 
 namespace fml {
 namespace tracing {
@@ -36,9 +37,17 @@ inline void FlutterTimelineEvent(const char* label,
                                  const char** argument_values) {
   TimelineEventHandler handler =
       gTimelineEventHandler.load(std::memory_order_relaxed);
-  if (handler && gAllowlist.Query(label)) {
-    handler(label, timestamp0, timestamp1_or_async_id, type, argument_count,
-            argument_names, argument_values);
+  const bool recording = TraceRecorder::IsRecording();
+  if ((handler || recording) && gAllowlist.Query(label)) {
+    if (handler) {
+      handler(label, timestamp0, timestamp1_or_async_id, type, argument_count,
+              argument_names, argument_values);
+    }
+    if (recording) {
+      TraceRecorder::GetInstance().Record(
+          label, timestamp0, timestamp1_or_async_id, type, argument_count,
+          argument_names, argument_values);
+    }
   }
 }
 }  // namespace
@@ -0,0 +1,731 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_recorder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/thread_local.h"
+#include "flutter/fml/time/time_point.h"
+
+#if defined(FML_OS_LINUX) || defined(FML_OS_ANDROID)
+#include <sys/prctl.h>
+#elif defined(FML_OS_MACOSX)
+#include <pthread.h>
+#endif
+
+#if defined(FML_OS_WIN)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fml {
+namespace tracing {
+
+namespace {
+
+int64_t NowMicros() {
+  return TimePoint::Now().ToEpochDelta().ToMicroseconds();
+}
+
+int64_t GetProcessId() {
+#if defined(FML_OS_WIN)
+  return _getpid();
+#else
+  return getpid();
+#endif
+}
+
+std::string GetCurrentThreadName() {
+#if defined(FML_OS_LINUX) || defined(FML_OS_ANDROID)
+  char name[16] = {};
+  prctl(PR_GET_NAME, name);
+  return name;
+#elif defined(FML_OS_MACOSX)
+  char name[64] = {};
+  pthread_getname_np(pthread_self(), name, sizeof(name));
+  return name;
+#else
+  return "";
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Chrome JSON.
+
+void AppendJsonString(std::string& json, std::string_view string) {
+  json.push_back('"');
+  for (char c : string) {
+    switch (c) {
+      case '"':
+        json.append("\\\"");
+        break;
+      case '\\':
+        json.append("\\\\");
+        break;
+      case '\n':
+        json.append("\\n");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[7];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          json.append(escaped);
+        } else {
+          json.push_back(c);
+        }
+    }
+  }
+  json.push_back('"');
+}
+
+// Counters are plotted from numbers, and the values of their arguments are
+// recorded as strings.
+bool IsJsonNumber(const char* value) {
+  if (*value == '\0') {
+    return false;
+  }
+  char* end = nullptr;
+  std::strtod(value, &end);
+  return *end == '\0';
+}
+
+const char* GetChromePhase(Dart_Timeline_Event_Type type) {
+  switch (type) {
+    case Dart_Timeline_Event_Begin:
+      return "B";
+    case Dart_Timeline_Event_End:
+      return "E";
+    case Dart_Timeline_Event_Instant:
+      return "i";
+    case Dart_Timeline_Event_Duration:
+      return "X";
+    case Dart_Timeline_Event_Async_Begin:
+      return "b";
+    case Dart_Timeline_Event_Async_End:
+      return "e";
+    case Dart_Timeline_Event_Async_Instant:
+      return "n";
+    case Dart_Timeline_Event_Counter:
+      return "C";
+    case Dart_Timeline_Event_Flow_Begin:
+      return "s";
+    case Dart_Timeline_Event_Flow_Step:
+      return "t";
+    case Dart_Timeline_Event_Flow_End:
+      return "f";
+  }
+  return "i";
+}
+
+bool HasId(Dart_Timeline_Event_Type type) {
+  return type != Dart_Timeline_Event_Begin &&
+         type != Dart_Timeline_Event_End &&
+         type != Dart_Timeline_Event_Instant &&
+         type != Dart_Timeline_Event_Duration;
+}
+
+//------------------------------------------------------------------------------
+// Perfetto protobuf. The field numbers are those of
+// protos/perfetto/trace/trace_packet.proto and the messages it refers to.
+
+constexpr uint32_t kTracePacketField = 1;
+
+constexpr uint32_t kPacketTimestampField = 8;
+constexpr uint32_t kPacketSequenceIdField = 10;
+constexpr uint32_t kPacketTrackEventField = 11;
+constexpr uint32_t kPacketSequenceFlagsField = 13;
+constexpr uint32_t kPacketTrackDescriptorField = 60;
+constexpr uint64_t kSequenceIncrementalStateCleared = 1;
+
+constexpr uint32_t kTrackUuidField = 1;
+constexpr uint32_t kTrackNameField = 2;
+constexpr uint32_t kTrackProcessField = 3;
+constexpr uint32_t kTrackThreadField = 4;
+constexpr uint32_t kTrackParentUuidField = 5;
+constexpr uint32_t kTrackCounterField = 8;
+
+constexpr uint32_t kProcessPidField = 1;
+constexpr uint32_t kThreadPidField = 1;
+constexpr uint32_t kThreadTidField = 2;
+constexpr uint32_t kThreadNameField = 5;
+
+constexpr uint32_t kEventDebugAnnotationField = 4;
+constexpr uint32_t kEventTypeField = 9;
+constexpr uint32_t kEventTrackUuidField = 11;
+constexpr uint32_t kEventNameField = 23;
+constexpr uint32_t kEventDoubleCounterValueField = 44;
+constexpr uint32_t kEventFlowIdsField = 47;
+constexpr uint32_t kEventTerminatingFlowIdsField = 48;
+
+constexpr uint32_t kAnnotationStringValueField = 6;
+constexpr uint32_t kAnnotationNameField = 10;
+
+constexpr uint64_t kSliceBegin = 1;
+constexpr uint64_t kSliceEnd = 2;
+constexpr uint64_t kInstant = 3;
+constexpr uint64_t kCounter = 4;
+
+constexpr uint32_t kSequenceId = 1;
+constexpr uint64_t kProcessTrackUuid = 1;
+
+class ProtoWriter {
+ public:
+  void WriteVarint(uint32_t field, uint64_t value) {
+    WriteTag(field, 0);
+    AppendVarint(value);
+  }
+
+  void WriteFixed64(uint32_t field, uint64_t value) {
+    WriteTag(field, 1);
+    for (int i = 0; i < 8; i++) {
+      data_.push_back(static_cast<char>(value >> (i * 8)));
+    }
+  }
+
+  void WriteDouble(uint32_t field, double value) {
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(value));
+    memcpy(&bits, &value, sizeof(bits));
+    WriteFixed64(field, bits);
+  }
+
+  void WriteBytes(uint32_t field, std::string_view value) {
+    WriteTag(field, 2);
+    AppendVarint(value.size());
+    data_.append(value);
+  }
+
+  void WriteMessage(uint32_t field, const ProtoWriter& message) {
+    WriteBytes(field, message.data_);
+  }
+
+  const std::string& data() const { return data_; }
+
+ private:
+  std::string data_;
+
+  void WriteTag(uint32_t field, uint32_t wire_type) {
+    AppendVarint((field << 3) | wire_type);
+  }
+
+  void AppendVarint(uint64_t value) {
+    while (value >= 0x80) {
+      data_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    data_.push_back(static_cast<char>(value));
+  }
+};
+
+class PerfettoTraceWriter {
+ public:
+  PerfettoTraceWriter() {
+    ProtoWriter process;
+    process.WriteVarint(kProcessPidField, GetProcessId());
+    ProtoWriter track;
+    track.WriteVarint(kTrackUuidField, kProcessTrackUuid);
+    track.WriteMessage(kTrackProcessField, process);
+    WriteTrackDescriptor(track);
+  }
+
+  uint64_t AddThreadTrack(int64_t tid, const std::string& name) {
+    const uint64_t uuid = next_uuid_++;
+    ProtoWriter thread;
+    thread.WriteVarint(kThreadPidField, GetProcessId());
+    thread.WriteVarint(kThreadTidField, tid);
+    thread.WriteBytes(kThreadNameField, name);
+    ProtoWriter track;
+    track.WriteVarint(kTrackUuidField, uuid);
+    track.WriteMessage(kTrackThreadField, thread);
+    WriteTrackDescriptor(track);
+    return uuid;
+  }
+
+  // Async events with the same name and id share a track.
+  uint64_t GetAsyncTrack(uint32_t name_id,
+                         int64_t id,
+                         const std::string& name) {
+    auto found = async_tracks_.find({name_id, id});
+    if (found != async_tracks_.end()) {
+      return found->second;
+    }
+    const uint64_t uuid = next_uuid_++;
+    ProtoWriter track;
+    track.WriteVarint(kTrackUuidField, uuid);
+    track.WriteBytes(kTrackNameField, name);
+    track.WriteVarint(kTrackParentUuidField, kProcessTrackUuid);
+    WriteTrackDescriptor(track);
+    async_tracks_[{name_id, id}] = uuid;
+    return uuid;
+  }
+
+  // Every argument of a counter is plotted on a track of its own.
+  uint64_t GetCounterTrack(uint32_t name_id,
+                           uint32_t argument_name_id,
+                           const std::string& name) {
+    auto found = counter_tracks_.find({name_id, argument_name_id});
+    if (found != counter_tracks_.end()) {
+      return found->second;
+    }
+    const uint64_t uuid = next_uuid_++;
+    ProtoWriter track;
+    track.WriteVarint(kTrackUuidField, uuid);
+    track.WriteBytes(kTrackNameField, name);
+    track.WriteVarint(kTrackParentUuidField, kProcessTrackUuid);
+    track.WriteMessage(kTrackCounterField, ProtoWriter());
+    WriteTrackDescriptor(track);
+    counter_tracks_[{name_id, argument_name_id}] = uuid;
+    return uuid;
+  }
+
+  void WriteTrackEvent(int64_t timestamp_micros, const ProtoWriter& event) {
+    ProtoWriter packet = MakePacket();
+    packet.WriteVarint(kPacketTimestampField, timestamp_micros * 1000);
+    packet.WriteMessage(kPacketTrackEventField, event);
+    trace_.WriteMessage(kTracePacketField, packet);
+  }
+
+  const std::string& data() const { return trace_.data(); }
+
+ private:
+  ProtoWriter trace_;
+  bool first_packet_ = true;
+  uint64_t next_uuid_ = kProcessTrackUuid + 1;
+  std::map<std::pair<uint32_t, int64_t>, uint64_t> async_tracks_;
+  std::map<std::pair<uint32_t, uint32_t>, uint64_t> counter_tracks_;
+
+  ProtoWriter MakePacket() {
+    ProtoWriter packet;
+    packet.WriteVarint(kPacketSequenceIdField, kSequenceId);
+    if (first_packet_) {
+      first_packet_ = false;
+      packet.WriteVarint(kPacketSequenceFlagsField,
+                         kSequenceIncrementalStateCleared);
+    }
+    return packet;
+  }
+
+  void WriteTrackDescriptor(const ProtoWriter& track) {
+    ProtoWriter packet = MakePacket();
+    packet.WriteMessage(kPacketTrackDescriptorField, track);
+    trace_.WriteMessage(kTracePacketField, packet);
+  }
+};
+
+}  // namespace
+
+//------------------------------------------------------------------------------
+// The buffer that a thread records its events into. Only that thread writes
+// the events and moves the head, and dumps read the events behind the head.
+class TraceRecorder::ThreadBuffer {
+ public:
+  // An event that is stored as relaxed atomic words, because dumps read it
+  // while its thread may be overwriting it. A dump may therefore read a mix
+  // of two events, which it detects by checking the head again afterwards.
+  class Slot {
+   public:
+    void Store(const EventRecord& event) {
+      uint64_t words[kWordCount];
+      std::memcpy(words, &event, sizeof(words));
+      // Pairs with the fence of dumps after they read the slot, so that a dump
+      // that reads any word of this event also sees the head that was
+      // published before it.
+      std::atomic_thread_fence(std::memory_order_release);
+      for (size_t i = 0; i < kWordCount; i++) {
+        words_[i].store(words[i], std::memory_order_relaxed);
+      }
+    }
+
+    EventRecord Load() const {
+      uint64_t words[kWordCount];
+      for (size_t i = 0; i < kWordCount; i++) {
+        words[i] = words_[i].load(std::memory_order_relaxed);
+      }
+      EventRecord event;
+      std::memcpy(&event, words, sizeof(event));
+      return event;
+    }
+
+   private:
+    static constexpr size_t kWordCount = sizeof(EventRecord) / sizeof(uint64_t);
+    static_assert(sizeof(EventRecord) % sizeof(uint64_t) == 0);
+    static_assert(std::is_trivially_copyable_v<EventRecord>);
+
+    std::atomic<uint64_t> words_[kWordCount] = {};
+  };
+
+  explicit ThreadBuffer(size_t capacity) : events(capacity) {}
+
+  std::vector<Slot> events;
+  // The number of events ever recorded into the buffer.
+  std::atomic<uint64_t> head = 0;
+  // The index of the first event recorded by the current thread since the
+  // recording started.
+  std::atomic<uint64_t> first = 0;
+
+  // Only accessed by the thread that records into the buffer.
+  std::unordered_map<const char*, Name> name_cache;
+
+  // Guarded by |threads_mutex_|.
+  bool in_use = false;
+  int64_t tid = 0;
+  std::string thread_name;
+};
+
+// Hands the buffer of a thread over to other threads once it exits.
+class TraceRecorder::ThreadBufferHolder {
+ public:
+  explicit ThreadBufferHolder(ThreadBuffer* buffer) : buffer_(buffer) {}
+
+  ~ThreadBufferHolder() {
+    std::scoped_lock lock(TraceRecorder::GetInstance().threads_mutex_);
+    buffer_->in_use = false;
+  }
+
+  ThreadBuffer* get() const { return buffer_; }
+
+ private:
+  ThreadBuffer* const buffer_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ThreadBufferHolder);
+};
+
+std::atomic_bool TraceRecorder::recording_ = false;
+
+TraceRecorder& TraceRecorder::GetInstance() {
+  // Threads may record until they exit, so the recorder is never destroyed.
+  static TraceRecorder* instance = new TraceRecorder;
+  return *instance;
+}
+
+TraceRecorder::TraceRecorder() = default;
+
+TraceRecorder::~TraceRecorder() = default;
+
+void TraceRecorder::Start(size_t records_per_thread) {
+  std::scoped_lock lock(threads_mutex_);
+  records_per_thread_ = std::max<size_t>(records_per_thread, 1);
+  for (const auto& buffer : threads_) {
+    buffer->first.store(buffer->head.load(std::memory_order_acquire),
+                        std::memory_order_release);
+  }
+  recording_ = true;
+}
+
+void TraceRecorder::Stop() {
+  recording_ = false;
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::GetCurrentThreadBuffer() {
+  FML_THREAD_LOCAL ThreadLocalUniquePtr<ThreadBufferHolder> tls_buffer;
+  if (ThreadBufferHolder* holder = tls_buffer.get()) {
+    return holder->get();
+  }
+
+  std::scoped_lock lock(threads_mutex_);
+  ThreadBuffer* buffer = nullptr;
+  for (const auto& thread : threads_) {
+    if (!thread->in_use && thread->events.size() == records_per_thread_) {
+      buffer = thread.get();
+      break;
+    }
+  }
+  if (!buffer) {
+    threads_.push_back(std::make_unique<ThreadBuffer>(records_per_thread_));
+    buffer = threads_.back().get();
+  }
+  // The events of the thread that used the buffer before are dropped.
+  buffer->first.store(buffer->head.load(std::memory_order_relaxed),
+                      std::memory_order_release);
+  buffer->in_use = true;
+  buffer->tid = next_tid_++;
+  buffer->thread_name = GetCurrentThreadName();
+  tls_buffer.reset(new ThreadBufferHolder(buffer));
+  return buffer;
+}
+
+uint32_t TraceRecorder::Intern(ThreadBuffer* buffer, const char* name) {
+  // Names are usually string literals, so the thread looks their address up
+  // first. The contents are compared as well, as names may be temporaries
+  // whose address is reused for another name.
+  auto cached = buffer->name_cache.find(name);
+  if (cached != buffer->name_cache.end() && *cached->second.string == name) {
+    return cached->second.id;
+  }
+
+  std::scoped_lock lock(names_mutex_);
+  auto found = name_ids_.find(name);
+  uint32_t id;
+  if (found != name_ids_.end()) {
+    id = found->second;
+  } else {
+    id = static_cast<uint32_t>(names_.size());
+    names_.emplace_back(name);
+    name_ids_[name] = id;
+  }
+  buffer->name_cache[name] = {id, &names_[id]};
+  return id;
+}
+
+void TraceRecorder::Record(const char* label,
+                           int64_t timestamp_micros,
+                           int64_t timestamp1_or_id,
+                           Dart_Timeline_Event_Type type,
+                           intptr_t argument_count,
+                           const char** argument_names,
+                           const char** argument_values) {
+  if (!IsRecording()) {
+    return;
+  }
+  ThreadBuffer* buffer = GetCurrentThreadBuffer();
+  const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+  EventRecord event = {};
+  event.timestamp_micros =
+      timestamp_micros >= 0 ? timestamp_micros : NowMicros();
+  event.timestamp1_or_id = timestamp1_or_id;
+  event.name = Intern(buffer, label);
+  event.type = static_cast<uint8_t>(type);
+  event.argument_count = static_cast<uint8_t>(
+      std::clamp<intptr_t>(argument_count, 0, kMaxArgumentCount));
+  for (size_t i = 0; i < event.argument_count; i++) {
+    event.argument_names[i] = Intern(buffer, argument_names[i]);
+    strncpy(event.argument_values[i], argument_values[i],
+            kMaxArgumentValueLength);
+    event.argument_values[i][kMaxArgumentValueLength] = '\0';
+  }
+  buffer->events[head % buffer->events.size()].Store(event);
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+TraceRecorder::Snapshot TraceRecorder::TakeSnapshot() const {
+  Snapshot snapshot;
+  {
+    std::scoped_lock lock(threads_mutex_);
+    for (const auto& buffer : threads_) {
+      const uint64_t capacity = buffer->events.size();
+      const uint64_t head = buffer->head.load(std::memory_order_acquire);
+      uint64_t first = buffer->first.load(std::memory_order_acquire);
+      first = std::max(first, head > capacity ? head - capacity : 0);
+
+      Snapshot::Thread thread;
+      thread.tid = buffer->tid;
+      thread.name = buffer->thread_name;
+      std::vector<EventRecord> events;
+      events.reserve(head - first);
+      for (uint64_t i = first; i < head; i++) {
+        events.push_back(buffer->events[i % capacity].Load());
+      }
+      // The thread keeps recording while the events are copied. The ones it
+      // has overwritten in the meantime are dropped, along with the one it
+      // may be writing.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      const uint64_t valid_end =
+          buffer->head.load(std::memory_order_relaxed) + 1;
+      const uint64_t overwritten =
+          valid_end > capacity + first
+              ? std::min(valid_end - capacity - first, head - first)
+              : 0;
+      thread.events.assign(events.begin() + overwritten, events.end());
+      if (!thread.events.empty()) {
+        snapshot.threads.push_back(std::move(thread));
+      }
+    }
+  }
+  {
+    std::scoped_lock lock(names_mutex_);
+    snapshot.names.assign(names_.begin(), names_.end());
+  }
+  return snapshot;
+}
+
+std::string TraceRecorder::Dump(Format format) const {
+  const Snapshot snapshot = TakeSnapshot();
+  switch (format) {
+    case Format::kChromeJson:
+      return ToChromeJson(snapshot);
+    case Format::kPerfetto:
+      return ToPerfetto(snapshot);
+  }
+  return "";
+}
+
+bool TraceRecorder::DumpToFile(const fml::UniqueFD& directory,
+                               const char* file_name,
+                               Format format) const {
+  return WriteAtomically(directory, file_name, DataMapping(Dump(format)));
+}
+
+std::string TraceRecorder::ToChromeJson(const Snapshot& snapshot) {
+  const std::string pid = std::to_string(GetProcessId());
+  std::string json = "{\"traceEvents\":[";
+  bool first_event = true;
+  auto begin_event = [&](const std::string& name, const char* phase,
+                         int64_t tid) {
+    json.append(first_event ? "\n{" : ",\n{");
+    first_event = false;
+    json.append("\"name\":");
+    AppendJsonString(json, name);
+    json.append(",\"cat\":\"flutter\",\"ph\":\"");
+    json.append(phase);
+    json.append("\",\"pid\":");
+    json.append(pid);
+    json.append(",\"tid\":");
+    json.append(std::to_string(tid));
+  };
+
+  for (const auto& thread : snapshot.threads) {
+    begin_event("thread_name", "M", thread.tid);
+    json.append(",\"args\":{\"name\":");
+    AppendJsonString(json, thread.name);
+    json.append("}}");
+
+    for (const auto& event : thread.events) {
+      const auto type = static_cast<Dart_Timeline_Event_Type>(event.type);
+      begin_event(snapshot.names[event.name], GetChromePhase(type),
+                  thread.tid);
+      json.append(",\"ts\":");
+      json.append(std::to_string(event.timestamp_micros));
+      if (type == Dart_Timeline_Event_Duration) {
+        json.append(",\"dur\":");
+        json.append(std::to_string(event.timestamp1_or_id -
+                                   event.timestamp_micros));
+      } else if (HasId(type)) {
+        char id[24];
+        snprintf(id, sizeof(id), "0x%llx",
+                 static_cast<unsigned long long>(event.timestamp1_or_id));
+        json.append(",\"id\":\"");
+        json.append(id);
+        json.append("\"");
+      }
+      if (type == Dart_Timeline_Event_Instant) {
+        json.append(",\"s\":\"t\"");
+      } else if (type == Dart_Timeline_Event_Flow_End) {
+        json.append(",\"bp\":\"e\"");
+      }
+      json.append(",\"args\":{");
+      for (size_t i = 0; i < event.argument_count; i++) {
+        if (i > 0) {
+          json.append(",");
+        }
+        AppendJsonString(json, snapshot.names[event.argument_names[i]]);
+        json.append(":");
+        const char* value = event.argument_values[i];
+        if (type == Dart_Timeline_Event_Counter && IsJsonNumber(value)) {
+          json.append(value);
+        } else {
+          AppendJsonString(json, value);
+        }
+      }
+      json.append("}}");
+    }
+  }
+  json.append("\n],\"displayTimeUnit\":\"ms\"}\n");
+  return json;
+}
+
+std::string TraceRecorder::ToPerfetto(const Snapshot& snapshot) {
+  PerfettoTraceWriter writer;
+  for (const auto& thread : snapshot.threads) {
+    const uint64_t thread_track =
+        writer.AddThreadTrack(thread.tid, thread.name);
+    for (const auto& event : thread.events) {
+      const auto type = static_cast<Dart_Timeline_Event_Type>(event.type);
+      const std::string& name = snapshot.names[event.name];
+
+      if (type == Dart_Timeline_Event_Counter) {
+        for (size_t i = 0; i < event.argument_count; i++) {
+          const std::string& argument_name =
+              snapshot.names[event.argument_names[i]];
+          ProtoWriter counter;
+          counter.WriteVarint(kEventTypeField, kCounter);
+          counter.WriteVarint(
+              kEventTrackUuidField,
+              writer.GetCounterTrack(event.name, event.argument_names[i],
+                                     name + "." + argument_name));
+          counter.WriteDouble(kEventDoubleCounterValueField,
+                              std::strtod(event.argument_values[i], nullptr));
+          writer.WriteTrackEvent(event.timestamp_micros, counter);
+        }
+        continue;
+      }
+
+      ProtoWriter track_event;
+      uint64_t track = thread_track;
+      switch (type) {
+        case Dart_Timeline_Event_Begin:
+        case Dart_Timeline_Event_Duration:
+          track_event.WriteVarint(kEventTypeField, kSliceBegin);
+          break;
+        case Dart_Timeline_Event_End:
+          track_event.WriteVarint(kEventTypeField, kSliceEnd);
+          break;
+        case Dart_Timeline_Event_Async_Begin:
+          track =
+              writer.GetAsyncTrack(event.name, event.timestamp1_or_id, name);
+          track_event.WriteVarint(kEventTypeField, kSliceBegin);
+          break;
+        case Dart_Timeline_Event_Async_End:
+          track =
+              writer.GetAsyncTrack(event.name, event.timestamp1_or_id, name);
+          track_event.WriteVarint(kEventTypeField, kSliceEnd);
+          break;
+        case Dart_Timeline_Event_Async_Instant:
+          track =
+              writer.GetAsyncTrack(event.name, event.timestamp1_or_id, name);
+          track_event.WriteVarint(kEventTypeField, kInstant);
+          break;
+        case Dart_Timeline_Event_Flow_Begin:
+        case Dart_Timeline_Event_Flow_Step:
+          track_event.WriteVarint(kEventTypeField, kInstant);
+          track_event.WriteFixed64(kEventFlowIdsField, event.timestamp1_or_id);
+          break;
+        case Dart_Timeline_Event_Flow_End:
+          track_event.WriteVarint(kEventTypeField, kInstant);
+          track_event.WriteFixed64(kEventTerminatingFlowIdsField,
+                                   event.timestamp1_or_id);
+          break;
+        default:
+          track_event.WriteVarint(kEventTypeField, kInstant);
+          break;
+      }
+      track_event.WriteVarint(kEventTrackUuidField, track);
+      if (type != Dart_Timeline_Event_End &&
+          type != Dart_Timeline_Event_Async_End) {
+        track_event.WriteBytes(kEventNameField, name);
+      }
+      for (size_t i = 0; i < event.argument_count; i++) {
+        ProtoWriter annotation;
+        annotation.WriteBytes(kAnnotationNameField,
+                              snapshot.names[event.argument_names[i]]);
+        annotation.WriteBytes(kAnnotationStringValueField,
+                              event.argument_values[i]);
+        track_event.WriteMessage(kEventDebugAnnotationField, annotation);
+      }
+      writer.WriteTrackEvent(event.timestamp_micros, track_event);
+
+      if (type == Dart_Timeline_Event_Duration) {
+        ProtoWriter end;
+        end.WriteVarint(kEventTypeField, kSliceEnd);
+        end.WriteVarint(kEventTrackUuidField, thread_track);
+        writer.WriteTrackEvent(event.timestamp1_or_id, end);
+      }
+    }
+  }
+  return writer.data();
+}
+
+}  // namespace tracing
+}  // namespace fml
@@ -0,0 +1,176 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TRACE_RECORDER_H_
+#define FLUTTER_FML_TRACE_RECORDER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/unique_fd.h"
+#include "third_party/dart/runtime/include/dart_tools_api.h"
+
+namespace fml {
+namespace tracing {
+
+//------------------------------------------------------------------------------
+/// @brief      Records the trace events of the engine in memory, so that they
+///             can be looked at without a connection to the VM service, such
+///             as after a janky frame.
+///
+///             Every thread records into a ring buffer of its own, without
+///             locks, and only the most recent events of each thread are
+///             kept. Events are stored as fixed size records that refer to
+///             their name and argument names by an id. Names are interned the
+///             first time they are recorded. At most two arguments are kept
+///             per event, and their values are truncated to
+///             `kMaxArgumentValueLength` characters.
+///
+///             The buffers are converted to the Chrome JSON trace format or to
+///             the Perfetto protobuf trace format when dumped. Dumping does
+///             not stop the recording.
+///
+///             The recorder receives the events that pass the trace allowlist,
+///             whether or not the Dart timeline is listening to them.
+///
+/// @see        `TraceSetAllowlist`
+///
+class TraceRecorder {
+ public:
+  static constexpr size_t kDefaultRecordsPerThread = 4096;
+  static constexpr size_t kMaxArgumentCount = 2;
+  static constexpr size_t kMaxArgumentValueLength = 16;
+
+  enum class Format {
+    /// The JSON format of `chrome://tracing`, which Perfetto opens as well.
+    kChromeJson,
+    /// The protobuf format of Perfetto traces.
+    kPerfetto,
+  };
+
+  static TraceRecorder& GetInstance();
+
+  //----------------------------------------------------------------------------
+  /// @return     Whether trace events are being recorded. This is cheap enough
+  ///             to be checked for every trace event.
+  ///
+  static bool IsRecording() {
+    return recording_.load(std::memory_order_relaxed);
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Starts recording. The events recorded before are dropped.
+  ///
+  /// @param[in]  records_per_thread  The number of events kept for each
+  ///                                 thread. This only applies to the threads
+  ///                                 that have not recorded any event yet.
+  ///
+  void Start(size_t records_per_thread = kDefaultRecordsPerThread);
+
+  void Stop();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records an event of the calling thread. The arguments are
+  ///             those of the Dart timeline. A negative `timestamp_micros`
+  ///             stands for the current time.
+  ///
+  void Record(const char* label,
+              int64_t timestamp_micros,
+              int64_t timestamp1_or_id,
+              Dart_Timeline_Event_Type type,
+              intptr_t argument_count,
+              const char** argument_names,
+              const char** argument_values);
+
+  //----------------------------------------------------------------------------
+  /// @return     The events recorded since the last call to `Start` that are
+  ///             still held by the buffers, in the given format. The oldest
+  ///             event of a full buffer is left out, as its thread may be
+  ///             overwriting it.
+  ///
+  std::string Dump(Format format) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Dumps the recorded events to `file_name` in `directory`.
+  ///
+  /// @return     Whether the file was written.
+  ///
+  bool DumpToFile(const fml::UniqueFD& directory,
+                  const char* file_name,
+                  Format format) const;
+
+ private:
+  struct EventRecord {
+    int64_t timestamp_micros;
+    // The id of async, flow and counter events, or the end of duration
+    // events.
+    int64_t timestamp1_or_id;
+    uint32_t name;
+    uint32_t argument_names[kMaxArgumentCount];
+    uint8_t type;
+    uint8_t argument_count;
+    // Null terminated.
+    char argument_values[kMaxArgumentCount][kMaxArgumentValueLength + 1];
+  };
+  static_assert(sizeof(EventRecord) == 64, "Records fill a cache line.");
+
+  struct Name {
+    uint32_t id;
+    const std::string* string;
+  };
+
+  class ThreadBuffer;
+  class ThreadBufferHolder;
+
+  struct Snapshot {
+    struct Thread {
+      int64_t tid;
+      std::string name;
+      std::vector<EventRecord> events;
+    };
+    std::vector<Thread> threads;
+    std::vector<std::string> names;
+  };
+
+  static std::atomic_bool recording_;
+
+  mutable std::mutex threads_mutex_;
+  size_t records_per_thread_ = kDefaultRecordsPerThread;
+  std::vector<std::unique_ptr<ThreadBuffer>> threads_;
+  int64_t next_tid_ = 1;
+
+  mutable std::mutex names_mutex_;
+  std::unordered_map<std::string, uint32_t> name_ids_;
+  // Never shrinks, so that the names stay where threads cache them.
+  std::deque<std::string> names_;
+
+  TraceRecorder();
+
+  ~TraceRecorder();
+
+  ThreadBuffer* GetCurrentThreadBuffer();
+
+  uint32_t Intern(ThreadBuffer* buffer, const char* name);
+
+  Snapshot TakeSnapshot() const;
+
+  static std::string ToChromeJson(const Snapshot& snapshot);
+
+  static std::string ToPerfetto(const Snapshot& snapshot);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TraceRecorder);
+};
+
+}  // namespace tracing
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TRACE_RECORDER_H_
@@ -0,0 +1,69 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_recorder.h"
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/trace_event.h"
+
+namespace fml {
+namespace benchmarking {
+
+// The cost of a scoped trace event, which records a begin and an end event,
+// with and without the recorder.
+static void BM_TraceEvent(benchmark::State& state) {
+  const bool record = state.range(0);
+  if (record) {
+    tracing::TraceRecorder::GetInstance().Start();
+  }
+  for (auto _ : state) {
+    TRACE_EVENT0("flutter", "BM_TraceEvent");
+  }
+  if (record) {
+    tracing::TraceRecorder::GetInstance().Stop();
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// The cost of recording an event with an argument, without the trace event
+// functions around it.
+static void BM_TraceRecorderRecord(benchmark::State& state) {
+  tracing::TraceRecorder& recorder = tracing::TraceRecorder::GetInstance();
+  recorder.Start();
+  const char* names[] = {"frame_number"};
+  const char* values[] = {"1234"};
+  for (auto _ : state) {
+    recorder.Record("BM_TraceRecorderRecord", -1, 0,
+                    Dart_Timeline_Event_Instant, 1, names, values);
+  }
+  recorder.Stop();
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_TraceRecorderDump(benchmark::State& state) {
+  tracing::TraceRecorder& recorder = tracing::TraceRecorder::GetInstance();
+  recorder.Start();
+  for (size_t i = 0; i < tracing::TraceRecorder::kDefaultRecordsPerThread;
+       i++) {
+    recorder.Record("BM_TraceRecorderDump", -1, 0, Dart_Timeline_Event_Instant,
+                    0, nullptr, nullptr);
+  }
+  recorder.Stop();
+  const auto format = static_cast<tracing::TraceRecorder::Format>(
+      state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(recorder.Dump(format));
+  }
+}
+
+BENCHMARK(BM_TraceEvent)->ArgName("record")->Arg(false)->Arg(true);
+BENCHMARK(BM_TraceRecorderRecord);
+BENCHMARK(BM_TraceRecorderDump)
+    ->ArgName("format")
+    ->Arg(static_cast<int>(tracing::TraceRecorder::Format::kChromeJson))
+    ->Arg(static_cast<int>(tracing::TraceRecorder::Format::kPerfetto))
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace benchmarking
+}  // namespace fml
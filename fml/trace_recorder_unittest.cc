@@ -0,0 +1,168 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_recorder.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "flutter/fml/trace_event.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace tracing {
+namespace testing {
+
+namespace {
+
+void RecordEvent(const char* label,
+                 Dart_Timeline_Event_Type type,
+                 int64_t timestamp_micros,
+                 int64_t timestamp1_or_id = 0,
+                 const char* argument_name = nullptr,
+                 const char* argument_value = nullptr) {
+  const char* names[] = {argument_name};
+  const char* values[] = {argument_value};
+  TraceRecorder::GetInstance().Record(label, timestamp_micros,
+                                      timestamp1_or_id, type,
+                                      argument_name ? 1 : 0, names, values);
+}
+
+bool Contains(const std::string& string, const std::string& part) {
+  return string.find(part) != std::string::npos;
+}
+
+}  // namespace
+
+TEST(TraceRecorderTest, DumpsChromeJson) {
+  TraceRecorder& recorder = TraceRecorder::GetInstance();
+  recorder.Start();
+  RecordEvent("Frame", Dart_Timeline_Event_Begin, 100);
+  RecordEvent("Frame", Dart_Timeline_Event_End, 150);
+  RecordEvent("Layout", Dart_Timeline_Event_Duration, 110, 130, "nodes",
+              "12");
+  RecordEvent("Upload", Dart_Timeline_Event_Async_Begin, 120, 31);
+  RecordEvent("Cache", Dart_Timeline_Event_Counter, 140, 0, "bytes", "2048");
+  RecordEvent("Quote\"d", Dart_Timeline_Event_Instant, 145);
+  recorder.Stop();
+  // Events are only recorded while the recorder runs.
+  RecordEvent("Stopped", Dart_Timeline_Event_Instant, 160);
+
+  const std::string json =
+      recorder.Dump(TraceRecorder::Format::kChromeJson);
+  EXPECT_TRUE(Contains(json, "\"traceEvents\":["));
+  EXPECT_TRUE(Contains(json, R"("name":"Frame","cat":"flutter","ph":"B")"));
+  EXPECT_TRUE(Contains(json, R"("ph":"E")"));
+  EXPECT_TRUE(Contains(json, R"("ts":110,"dur":20,"args":{"nodes":"12"})"));
+  EXPECT_TRUE(Contains(json, R"("ts":120,"id":"0x1f")"));
+  EXPECT_TRUE(Contains(json, R"("args":{"bytes":2048})"));
+  EXPECT_TRUE(Contains(json, R"("name":"Quote\"d")"));
+  EXPECT_TRUE(Contains(json, R"("ph":"M")"));
+  EXPECT_FALSE(Contains(json, "Stopped"));
+
+  // Starting again drops the events recorded before.
+  recorder.Start();
+  RecordEvent("Second", Dart_Timeline_Event_Instant, 200);
+  recorder.Stop();
+  const std::string second_json =
+      recorder.Dump(TraceRecorder::Format::kChromeJson);
+  EXPECT_TRUE(Contains(second_json, "Second"));
+  EXPECT_FALSE(Contains(second_json, "Frame"));
+}
+
+TEST(TraceRecorderTest, KeepsTheMostRecentEventsOfEachThread) {
+  TraceRecorder& recorder = TraceRecorder::GetInstance();
+  recorder.Start(/*records_per_thread=*/4);
+  std::thread thread([]() {
+    const char* labels[] = {"E0", "E1", "E2", "E3", "E4", "E5"};
+    for (size_t i = 0; i < 6; i++) {
+      RecordEvent(labels[i], Dart_Timeline_Event_Instant, i);
+    }
+  });
+  thread.join();
+  recorder.Stop();
+
+  const std::string json =
+      recorder.Dump(TraceRecorder::Format::kChromeJson);
+  EXPECT_FALSE(Contains(json, "\"E0\""));
+  EXPECT_FALSE(Contains(json, "\"E1\""));
+  // The oldest event of a full buffer may be being overwritten, so it is not
+  // dumped.
+  EXPECT_FALSE(Contains(json, "\"E2\""));
+  for (const char* label : {"\"E3\"", "\"E4\"", "\"E5\""}) {
+    EXPECT_TRUE(Contains(json, label)) << label;
+  }
+}
+
+TEST(TraceRecorderTest, DumpsWhileAThreadRecords) {
+  TraceRecorder& recorder = TraceRecorder::GetInstance();
+  recorder.Start(/*records_per_thread=*/16);
+  std::atomic_bool done = false;
+  std::thread thread([&done]() {
+    for (int64_t i = 0; i < 100000; i++) {
+      RecordEvent("Spin", Dart_Timeline_Event_Instant, i, 0, "arg", "value");
+    }
+    done = true;
+  });
+  // The records are read while they are overwritten, which must not be a data
+  // race.
+  while (!done) {
+    recorder.Dump(TraceRecorder::Format::kChromeJson);
+  }
+  thread.join();
+  recorder.Stop();
+  EXPECT_TRUE(Contains(recorder.Dump(TraceRecorder::Format::kChromeJson),
+                       "\"arg\":\"value\""));
+}
+
+TEST(TraceRecorderTest, TruncatesArgumentValues) {
+  TraceRecorder& recorder = TraceRecorder::GetInstance();
+  recorder.Start();
+  RecordEvent("Long", Dart_Timeline_Event_Instant, 10, 0, "value",
+              "0123456789abcdefghij");
+  recorder.Stop();
+
+  const std::string json =
+      recorder.Dump(TraceRecorder::Format::kChromeJson);
+  EXPECT_TRUE(Contains(json, R"("value":"0123456789abcdef")"));
+  EXPECT_FALSE(Contains(json, "0123456789abcdefg"));
+}
+
+TEST(TraceRecorderTest, DumpsPerfettoProtobuf) {
+  TraceRecorder& recorder = TraceRecorder::GetInstance();
+  recorder.Start();
+  RecordEvent("PerfettoSlice", Dart_Timeline_Event_Begin, 100);
+  RecordEvent("PerfettoSlice", Dart_Timeline_Event_End, 200);
+  RecordEvent("PerfettoCounter", Dart_Timeline_Event_Counter, 150, 0, "count",
+              "3");
+  recorder.Stop();
+
+  const std::string trace = recorder.Dump(TraceRecorder::Format::kPerfetto);
+  ASSERT_FALSE(trace.empty());
+  // Every top level field is a length delimited trace packet.
+  EXPECT_EQ(trace[0], '\x0a');
+  EXPECT_TRUE(Contains(trace, "PerfettoSlice"));
+  EXPECT_TRUE(Contains(trace, "PerfettoCounter.count"));
+}
+
+#if FLUTTER_TIMELINE_ENABLED
+TEST(TraceRecorderTest, RecordsTraceEventMacros) {
+  TraceRecorder& recorder = TraceRecorder::GetInstance();
+  recorder.Start();
+  { TRACE_EVENT0("flutter", "TraceRecorderTest::Macro"); }
+  recorder.Stop();
+
+  const std::string json =
+      recorder.Dump(TraceRecorder::Format::kChromeJson);
+  EXPECT_TRUE(Contains(json, R"("name":"TraceRecorderTest::Macro","cat":)"
+                             R"("flutter","ph":"B")"));
+  EXPECT_TRUE(Contains(json, R"("name":"TraceRecorderTest::Macro","cat":)"
+                             R"("flutter","ph":"E")"));
+}
+#endif  // FLUTTER_TIMELINE_ENABLED
+
+}  // namespace testing
+}  // namespace tracing
+}  // namespace fml
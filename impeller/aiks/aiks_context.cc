@@ -37,11 +37,34 @@ bool AiksContext::Render(const Picture& picture, RenderTarget& render_target) {
     return false;
   }
 
+  bool result = true;
   if (picture.pass) {
-    return picture.pass->Render(*content_context_, render_target);
+    result = picture.pass->Render(*content_context_, render_target);
   }
+  content_context_->GetMeshCache().FinishFrame();
+  return result;
+}
+
+size_t AiksContext::PrecompilePipelines(
+    const std::vector<ContentContext::PipelineVariant>& variants) {
+  if (!IsValid()) {
+    return 0;
+  }
+  return content_context_->PrecompilePipelines(variants);
+}
 
-  return true;
+ContentContext::PipelineStats AiksContext::GetPipelineStats() const {
+  if (!IsValid()) {
+    return {};
+  }
+  return content_context_->GetPipelineStats();
+}
+
+MeshCache::Stats AiksContext::GetMeshCacheStats() const {
+  if (!IsValid()) {
+    return {};
+  }
+  return content_context_->GetMeshCache().GetStats();
 }
 
 }  // namespace impeller
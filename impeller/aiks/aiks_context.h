@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "flutter/fml/macros.h"
 #include "impeller/entity/contents/content_context.h"
@@ -28,6 +29,17 @@ class AiksContext {
 
   bool Render(const Picture& picture, RenderTarget& render_target);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Starts creating the given pipeline variants ahead of their
+  ///             first use. See `ContentContext::PrecompilePipelines`.
+  ///
+  size_t PrecompilePipelines(
+      const std::vector<ContentContext::PipelineVariant>& variants);
+
+  ContentContext::PipelineStats GetPipelineStats() const;
+
+  MeshCache::Stats GetMeshCacheStats() const;
+
  private:
   std::shared_ptr<Context> context_;
   std::unique_ptr<ContentContext> content_context_;
@@ -6,8 +6,10 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/mapping.h"
@@ -15,9 +17,26 @@
 namespace impeller {
 
 constexpr const uint32_t kBlobCatMagic = 0x0B10BCA7;
+constexpr const uint32_t kBlobCatVersion = 2u;
+
+//------------------------------------------------------------------------------
+/// @brief      The payload of every blob starts at an offset from the start of
+///             the library that is a multiple of this alignment. This allows
+///             blobs in a suitably aligned mapping to be handed to the GPU
+///             without being copied first.
+///
+constexpr const uint64_t kBlobPayloadAlignment = 256u;
+
+//------------------------------------------------------------------------------
+/// @brief      The header at the start of a blob library. It is immediately
+///             followed by `blob_count` `Blob` descriptions sorted by type and
+///             then by name, which are followed by the blob payloads.
+///
 struct BlobHeader {
   uint32_t magic = kBlobCatMagic;
+  uint32_t version = kBlobCatVersion;
   uint32_t blob_count = 0u;
+  uint32_t payload_alignment = kBlobPayloadAlignment;
 };
 
 struct Blob {
@@ -32,6 +51,22 @@ struct Blob {
   uint64_t offset = 0;
   uint64_t length = 0;
   uint8_t name[kMaxNameLength] = {};
+
+  std::string_view GetName() const {
+    const auto* chars = reinterpret_cast<const char*>(name);
+    return std::string_view{chars, ::strnlen(chars, kMaxNameLength)};
+  }
+
+  /// The order of blobs in the description table of a library.
+  static bool IsOrderedBefore(ShaderType lhs_type,
+                              std::string_view lhs_name,
+                              ShaderType rhs_type,
+                              std::string_view rhs_name) {
+    if (lhs_type != rhs_type) {
+      return lhs_type < rhs_type;
+    }
+    return lhs_name < rhs_name;
+  }
 };
 
 struct BlobDescription {
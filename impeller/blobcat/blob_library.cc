@@ -4,6 +4,7 @@
 
 #include "impeller/blobcat/blob_library.h"
 
+#include <cstring>
 #include <string>
 
 namespace impeller {
@@ -16,59 +17,43 @@ BlobLibrary::BlobLibrary(std::shared_ptr<fml::Mapping> mapping)
   }
 
   BlobHeader header;
-  std::vector<Blob> blobs;
-
-  size_t offset = 0u;
 
   // Read the header.
   {
     const size_t read_size = sizeof(BlobHeader);
-    if (mapping_->GetSize() < offset + read_size) {
+    if (mapping_->GetSize() < read_size) {
       return;
     }
-    std::memcpy(&header, mapping_->GetMapping() + offset, read_size);
-    offset += read_size;
+    std::memcpy(&header, mapping_->GetMapping(), read_size);
 
     // Validate the header.
     if (header.magic != kBlobCatMagic) {
       FML_LOG(ERROR) << "Invalid blob magic.";
       return;
     }
-
-    blobs.resize(header.blob_count);
-  }
-
-  // Read the blob descriptions.
-  {
-    const size_t read_size = sizeof(Blob) * header.blob_count;
-    ::memcpy(blobs.data(), mapping_->GetMapping() + offset, read_size);
-    offset += read_size;  // NOLINT(clang-analyzer-deadcode.DeadStores)
+    if (header.version != kBlobCatVersion) {
+      FML_LOG(ERROR) << "Unsupported blob library version " << header.version
+                     << ", expected " << kBlobCatVersion << ".";
+      return;
+    }
+    if (header.payload_alignment != kBlobPayloadAlignment) {
+      FML_LOG(ERROR) << "Unexpected blob payload alignment.";
+      return;
+    }
   }
 
-  // Read the blobs.
+  // The description table must fit in the mapping. The bounds of individual
+  // payloads are checked as they are accessed.
   {
-    for (size_t i = 0; i < header.blob_count; i++) {
-      const auto& blob = blobs[i];
-
-      BlobKey key;
-      key.type = blob.type;
-      key.name = std::string{reinterpret_cast<const char*>(blob.name)};
-      auto mapping = std::make_shared<fml::NonOwnedMapping>(
-          mapping_->GetMapping() + blob.offset,  // offset
-          blob.length,                           // length
-          [mapping = mapping_](const uint8_t* data, size_t size) {}
-          // release proc
-      );
-
-      auto inserted = blobs_.insert({key, mapping});
-      if (!inserted.second) {
-        FML_LOG(ERROR) << "Shader library had duplicate shader named "
-                       << key.name;
-        return;
-      }
+    const size_t table_size =
+        sizeof(BlobHeader) + sizeof(Blob) * uint64_t{header.blob_count};
+    if (mapping_->GetSize() < table_size) {
+      FML_LOG(ERROR) << "Blob description table was truncated.";
+      return;
     }
   }
 
+  blob_count_ = header.blob_count;
   is_valid_ = true;
 }
 
@@ -81,16 +66,77 @@ bool BlobLibrary::IsValid() const {
 }
 
 size_t BlobLibrary::GetShaderCount() const {
-  return blobs_.size();
+  return blob_count_;
+}
+
+std::optional<BlobLibrary::BlobView> BlobLibrary::GetBlobAtIndex(
+    size_t index) const {
+  // The mapping may not be suitably aligned to reference the description in
+  // place, so copy it out.
+  Blob blob;
+  std::memcpy(&blob,
+              mapping_->GetMapping() + sizeof(BlobHeader) + sizeof(Blob) * index,
+              sizeof(Blob));
+  if (blob.offset > mapping_->GetSize() ||
+      blob.length > mapping_->GetSize() - blob.offset) {
+    FML_LOG(ERROR) << "Blob payload lies outside of the library mapping.";
+    return std::nullopt;
+  }
+
+  // The name is read from the mapping so that the view outlives |blob|.
+  const auto name_offset =
+      sizeof(BlobHeader) + sizeof(Blob) * index + offsetof(Blob, name);
+  const auto* name_chars =
+      reinterpret_cast<const char*>(mapping_->GetMapping() + name_offset);
+
+  BlobView view;
+  view.type = blob.type;
+  view.name = std::string_view{name_chars, blob.GetName().size()};
+  view.data = mapping_->GetMapping() + blob.offset;
+  view.length = blob.length;
+  return view;
+}
+
+std::optional<BlobLibrary::BlobView> BlobLibrary::FindBlob(
+    Blob::ShaderType type,
+    std::string_view name) const {
+  if (!IsValid()) {
+    return std::nullopt;
+  }
+  size_t low = 0u;
+  size_t high = blob_count_;
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    auto blob = GetBlobAtIndex(mid);
+    if (!blob.has_value()) {
+      return std::nullopt;
+    }
+    if (Blob::IsOrderedBefore(blob->type, blob->name, type, name)) {
+      low = mid + 1;
+    } else if (Blob::IsOrderedBefore(type, name, blob->type, blob->name)) {
+      high = mid;
+    } else {
+      return blob;
+    }
+  }
+  return std::nullopt;
+}
+
+std::shared_ptr<fml::Mapping> BlobLibrary::CreateMapping(
+    const BlobView& view) const {
+  return std::make_shared<fml::NonOwnedMapping>(
+      view.data,    // data
+      view.length,  // length
+      [mapping = mapping_](const uint8_t* data, size_t size) {}
+      // release proc
+  );
 }
 
-std::shared_ptr<fml::Mapping> BlobLibrary::GetMapping(Blob::ShaderType type,
-                                                      std::string name) const {
-  BlobKey key;
-  key.type = type;
-  key.name = name;
-  auto found = blobs_.find(key);
-  return found == blobs_.end() ? nullptr : found->second;
+std::shared_ptr<fml::Mapping> BlobLibrary::GetMapping(
+    Blob::ShaderType type,
+    std::string_view name) const {
+  auto blob = FindBlob(type, name);
+  return blob.has_value() ? CreateMapping(blob.value()) : nullptr;
 }
 
 size_t BlobLibrary::IterateAllBlobs(
@@ -102,9 +148,13 @@ size_t BlobLibrary::IterateAllBlobs(
     return 0u;
   }
   size_t count = 0u;
-  for (const auto& blob : blobs_) {
+  for (size_t i = 0; i < blob_count_; i++) {
+    auto blob = GetBlobAtIndex(i);
+    if (!blob.has_value()) {
+      break;
+    }
     count++;
-    if (!callback(blob.first.type, blob.first.name, blob.second)) {
+    if (!callback(blob->type, std::string{blob->name}, CreateMapping(*blob))) {
       break;
     }
   }
@@ -4,19 +4,38 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
-#include <type_traits>
-#include <unordered_map>
+#include <optional>
+#include <string>
+#include <string_view>
 
-#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/mapping.h"
 #include "impeller/blobcat/blob.h"
 
 namespace impeller {
 
+//------------------------------------------------------------------------------
+/// @brief      A read-only view of a library written by a `BlobWriter`.
+///
+///             Constructing a library only validates the header. Blobs are
+///             located by a binary search of the sorted description table in
+///             the mapping, so no per-blob state is allocated.
+///
 class BlobLibrary {
  public:
+  //----------------------------------------------------------------------------
+  /// @brief      A blob payload that points into the library mapping. It is
+  ///             only valid while the library mapping is alive.
+  ///
+  struct BlobView {
+    Blob::ShaderType type = Blob::ShaderType::kVertex;
+    std::string_view name;
+    const uint8_t* data = nullptr;
+    size_t length = 0u;
+  };
+
   BlobLibrary(std::shared_ptr<fml::Mapping> mapping);
 
   BlobLibrary(BlobLibrary&&);
@@ -27,8 +46,14 @@ class BlobLibrary {
 
   size_t GetShaderCount() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Find the payload of a blob without allocating.
+  ///
+  std::optional<BlobView> FindBlob(Blob::ShaderType type,
+                                   std::string_view name) const;
+
   std::shared_ptr<fml::Mapping> GetMapping(Blob::ShaderType type,
-                                           std::string name) const;
+                                           std::string_view name) const;
 
   size_t IterateAllBlobs(
       std::function<bool(Blob::ShaderType type,
@@ -36,34 +61,14 @@ class BlobLibrary {
                          const std::shared_ptr<fml::Mapping>& mapping)>) const;
 
  private:
-  struct BlobKey {
-    Blob::ShaderType type = Blob::ShaderType::kFragment;
-    std::string name;
-
-    struct Hash {
-      size_t operator()(const BlobKey& key) const {
-        return fml::HashCombine(
-            static_cast<std::underlying_type_t<decltype(key.type)>>(key.type),
-            key.name);
-      }
-    };
-
-    struct Equal {
-      bool operator()(const BlobKey& lhs, const BlobKey& rhs) const {
-        return lhs.type == rhs.type && lhs.name == rhs.name;
-      }
-    };
-  };
-
-  using Blobs = std::unordered_map<BlobKey,
-                                   std::shared_ptr<fml::Mapping>,
-                                   BlobKey::Hash,
-                                   BlobKey::Equal>;
-
   std::shared_ptr<fml::Mapping> mapping_;
-  Blobs blobs_;
+  size_t blob_count_ = 0u;
   bool is_valid_ = false;
 
+  std::optional<BlobView> GetBlobAtIndex(size_t index) const;
+
+  std::shared_ptr<fml::Mapping> CreateMapping(const BlobView& view) const;
+
   FML_DISALLOW_COPY_AND_ASSIGN(BlobLibrary);
 };
 
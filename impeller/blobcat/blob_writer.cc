@@ -4,6 +4,7 @@
 
 #include "impeller/blobcat/blob_writer.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <optional>
 
@@ -88,13 +89,38 @@ std::shared_ptr<fml::Mapping> BlobWriter::CreateMapping() const {
   BlobHeader header;
   header.blob_count = blob_descriptions_.size();
 
+  // The library looks blobs up by binary search over the description table.
+  std::vector<const BlobDescription*> sorted;
+  sorted.reserve(blob_descriptions_.size());
+  for (const auto& desc : blob_descriptions_) {
+    sorted.push_back(&desc);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const BlobDescription* lhs, const BlobDescription* rhs) {
+              return Blob::IsOrderedBefore(lhs->type, lhs->name, rhs->type,
+                                           rhs->name);
+            });
+  for (size_t i = 1; i < sorted.size(); i++) {
+    if (sorted[i - 1]->type == sorted[i]->type &&
+        sorted[i - 1]->name == sorted[i]->name) {
+      FML_LOG(ERROR) << "Shader library had duplicate shader named "
+                     << sorted[i]->name;
+      return nullptr;
+    }
+  }
+
+  auto align = [](uint64_t offset) {
+    return (offset + kBlobPayloadAlignment - 1) & ~(kBlobPayloadAlignment - 1);
+  };
+
   uint64_t offset = sizeof(BlobHeader) + (sizeof(Blob) * header.blob_count);
 
   std::vector<Blob> blobs;
   {
     blobs.resize(header.blob_count);
     for (size_t i = 0; i < header.blob_count; i++) {
-      const auto& desc = blob_descriptions_[i];
+      const auto& desc = *sorted[i];
+      offset = align(offset);
       blobs[i].type = desc.type;
       blobs[i].offset = offset;
       blobs[i].length = desc.mapping->GetSize();
@@ -124,11 +150,12 @@ std::shared_ptr<fml::Mapping> BlobWriter::CreateMapping() const {
       write_offset += write_length;
     }
 
-    // Write the blobs themselves.
+    // Write the blobs themselves. The padding between them is already zeroed.
     {
       for (size_t i = 0; i < header.blob_count; i++) {
-        const auto& desc = blob_descriptions_[i];
+        const auto& desc = *sorted[i];
         const size_t write_length = desc.mapping->GetSize();
+        write_offset = blobs[i].offset;
         std::memcpy(buffer->data() + write_offset, desc.mapping->GetMapping(),
                     write_length);
         write_offset += write_length;
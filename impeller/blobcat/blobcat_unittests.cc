@@ -2,7 +2,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <cstring>
 #include <string>
+#include <vector>
 
 #include "flutter/fml/mapping.h"
 #include "flutter/testing/testing.h"
@@ -53,5 +55,104 @@ TEST(BlobTest, CanReadAndWriteBlobs) {
   ASSERT_EQ(CreateStringFromMapping(*hello_vtx), "World");
 }
 
+TEST(BlobTest, CanFindBlobsWithoutAllocatingKeys) {
+  BlobWriter writer;
+  const std::vector<std::string> names = {"Zed", "Alpha", "Mid", "Beta"};
+  for (const auto& name : names) {
+    ASSERT_TRUE(writer.AddBlob(Blob::ShaderType::kFragment, name,
+                               CreateMappingFromString(name + "Frag")));
+    ASSERT_TRUE(writer.AddBlob(Blob::ShaderType::kVertex, name,
+                               CreateMappingFromString(name + "Vert")));
+  }
+
+  BlobLibrary library(writer.CreateMapping());
+  ASSERT_TRUE(library.IsValid());
+  ASSERT_EQ(library.GetShaderCount(), 8u);
+
+  for (const auto& name : names) {
+    auto frag = library.FindBlob(Blob::ShaderType::kFragment,
+                                 std::string_view{name});
+    ASSERT_TRUE(frag.has_value());
+    ASSERT_EQ(frag->name, name);
+    ASSERT_EQ(std::string(reinterpret_cast<const char*>(frag->data),
+                          frag->length),
+              name + "Frag");
+    auto vert =
+        library.FindBlob(Blob::ShaderType::kVertex, std::string_view{name});
+    ASSERT_TRUE(vert.has_value());
+    ASSERT_EQ(std::string(reinterpret_cast<const char*>(vert->data),
+                          vert->length),
+              name + "Vert");
+  }
+  ASSERT_FALSE(library.FindBlob(Blob::ShaderType::kVertex, "Missing"));
+  ASSERT_FALSE(library.FindBlob(Blob::ShaderType::kVertex, ""));
+}
+
+TEST(BlobTest, BlobPayloadsAreAligned) {
+  BlobWriter writer;
+  ASSERT_TRUE(writer.AddBlob(Blob::ShaderType::kVertex, "A",
+                             CreateMappingFromString("1")));
+  ASSERT_TRUE(writer.AddBlob(Blob::ShaderType::kVertex, "B",
+                             CreateMappingFromString("22")));
+  ASSERT_TRUE(writer.AddBlob(Blob::ShaderType::kVertex, "C",
+                             CreateMappingFromString("333")));
+  auto mapping = writer.CreateMapping();
+  ASSERT_NE(mapping, nullptr);
+
+  BlobLibrary library(mapping);
+  ASSERT_TRUE(library.IsValid());
+  size_t count = library.IterateAllBlobs(
+      [&](auto type, const auto& name, const auto& blob) -> bool {
+        const auto offset = blob->GetMapping() - mapping->GetMapping();
+        EXPECT_EQ(offset % kBlobPayloadAlignment, 0u);
+        return true;
+      });
+  ASSERT_EQ(count, 3u);
+}
+
+TEST(BlobTest, RejectsDuplicateBlobs) {
+  BlobWriter writer;
+  ASSERT_TRUE(writer.AddBlob(Blob::ShaderType::kVertex, "Hello",
+                             CreateMappingFromString("World")));
+  ASSERT_TRUE(writer.AddBlob(Blob::ShaderType::kVertex, "Hello",
+                             CreateMappingFromString("Again")));
+  ASSERT_EQ(writer.CreateMapping(), nullptr);
+}
+
+TEST(BlobTest, RejectsMismatchedVersions) {
+  BlobWriter writer;
+  ASSERT_TRUE(writer.AddBlob(Blob::ShaderType::kVertex, "Hello",
+                             CreateMappingFromString("World")));
+  auto mapping = writer.CreateMapping();
+  ASSERT_NE(mapping, nullptr);
+
+  std::string data = CreateStringFromMapping(*mapping);
+  BlobHeader header;
+  std::memcpy(&header, data.data(), sizeof(header));
+  header.version = kBlobCatVersion + 1;
+  std::memcpy(data.data(), &header, sizeof(header));
+
+  BlobLibrary library(CreateMappingFromString(data));
+  ASSERT_FALSE(library.IsValid());
+}
+
+TEST(BlobTest, RejectsTruncatedLibraries) {
+  BlobWriter writer;
+  ASSERT_TRUE(writer.AddBlob(Blob::ShaderType::kVertex, "Hello",
+                             CreateMappingFromString("World")));
+  auto mapping = writer.CreateMapping();
+  ASSERT_NE(mapping, nullptr);
+
+  std::string data = CreateStringFromMapping(*mapping);
+  BlobLibrary table_only(CreateMappingFromString(
+      data.substr(0, sizeof(BlobHeader) + sizeof(Blob))));
+  ASSERT_TRUE(table_only.IsValid());
+  ASSERT_FALSE(table_only.FindBlob(Blob::ShaderType::kVertex, "Hello"));
+
+  BlobLibrary header_only(
+      CreateMappingFromString(data.substr(0, sizeof(BlobHeader))));
+  ASSERT_FALSE(header_only.IsValid());
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -9,12 +9,14 @@
 
 #include "display_list/display_list_blend_mode.h"
 #include "display_list/display_list_path_effect.h"
+#include "display_list/display_list_static_dispatch.h"
 #include "display_list/display_list_tile_mode.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
 #include "impeller/display_list/display_list_image_impeller.h"
 #include "impeller/entity/contents/filters/filter_contents.h"
 #include "impeller/entity/contents/linear_gradient_contents.h"
+#include "impeller/entity/contents/mesh_cache.h"
 #include "impeller/entity/contents/solid_stroke_contents.h"
 #include "impeller/entity/entity.h"
 #include "impeller/geometry/path.h"
@@ -616,8 +618,17 @@ static Vertices ToVertices(const flutter::DlVertices* vertices) {
   }
 
   auto bounds = vertices->bounds();
-  return Vertices(std::move(points), std::move(indices), std::move(colors),
+  Vertices result(std::move(points), std::move(indices), std::move(colors),
                   mode, ToRect(bounds));
+  // The meshes cached for the vertices are released once the last display
+  // list that draws them is gone.
+  static const bool registered_release = [] {
+    flutter::DlVertices::AddReleaseCallback(&MeshCache::ReleaseMesh);
+    return true;
+  }();
+  (void)registered_release;
+  result.SetMeshId(vertices->unique_id());
+  return result;
 }
 
 // |flutter::Dispatcher|
@@ -835,7 +846,7 @@ void DisplayListDispatcher::drawDisplayList(
   int saveCount = canvas_.GetSaveCount();
   Paint savePaint = paint_;
   paint_ = Paint();
-  display_list->Dispatch(*this);
+  display_list->StaticDispatch(*this);
   paint_ = savePaint;
   canvas_.RestoreToCount(saveCount);
 }
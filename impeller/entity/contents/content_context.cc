@@ -5,7 +5,9 @@
 #include "impeller/entity/contents/content_context.h"
 
 #include <sstream>
+#include <utility>
 
+#include "flutter/fml/trace_event.h"
 #include "impeller/renderer/command_buffer.h"
 #include "impeller/renderer/formats.h"
 #include "impeller/renderer/render_pass.h"
@@ -144,7 +146,7 @@ static std::unique_ptr<PipelineT> CreateDefaultPipeline(
 }
 
 ContentContext::ContentContext(std::shared_ptr<Context> context)
-    : context_(std::move(context)) {
+    : context_(std::move(context)), mesh_cache_(std::make_unique<MeshCache>()) {
   if (!context_ || !context_->IsValid()) {
     return;
   }
@@ -225,6 +227,104 @@ bool ContentContext::IsValid() const {
   return is_valid_;
 }
 
+size_t ContentContext::PrecompilePipelines(
+    const std::vector<PipelineVariant>& variants) const {
+  if (!IsValid()) {
+    return 0;
+  }
+  TRACE_EVENT0("impeller", "ContentContext::PrecompilePipelines");
+
+  // Only the prototypes are waited for. They were all requested by the
+  // constructor, and the variants are left for the pipeline library to create
+  // concurrently.
+  size_t requested = 0;
+  for (const auto& variant : variants) {
+    ForEachPipelineVariants([&](PipelineKind kind, auto& container) {
+      if (kind != variant.kind || container.count(variant.options) > 0) {
+        return;
+      }
+      container[variant.options] = CreateVariant(container, variant.options);
+      precompiled_variants_.push_back(variant);
+      requested++;
+    });
+  }
+  return requested;
+}
+
+std::vector<ContentContext::PipelineVariant>
+ContentContext::GetPipelineVariants() const {
+  std::vector<PipelineVariant> variants;
+  ForEachPipelineVariants([&](PipelineKind kind, const auto& container) {
+    for (const auto& [options, pipeline] : container) {
+      if (!ContentContextOptions::Equal{}(options, {})) {
+        variants.push_back({kind, options});
+      }
+    }
+  });
+  return variants;
+}
+
+std::vector<ContentContext::PipelineVariant>
+ContentContext::GetCommonPipelineVariants(SampleCount onscreen_sample_count) {
+  std::vector<SampleCount> sample_counts = {SampleCount::kCount1};
+  if (onscreen_sample_count != SampleCount::kCount1) {
+    sample_counts.push_back(onscreen_sample_count);
+  }
+
+  std::vector<PipelineVariant> variants;
+  for (auto sample_count : sample_counts) {
+    ContentContextOptions options;
+    options.sample_count = sample_count;
+    for (int i = 0; i <= static_cast<int>(PipelineKind::kLastPipelineKind);
+         i++) {
+      auto kind = static_cast<PipelineKind>(i);
+      if (kind != PipelineKind::kClip) {
+        variants.push_back({kind, options});
+      }
+    }
+
+    // Clips only write to the stencil attachment.
+    const std::pair<CompareFunction, StencilOperation> clip_stencils[] = {
+        {CompareFunction::kEqual, StencilOperation::kIncrementClamp},
+        {CompareFunction::kEqual, StencilOperation::kDecrementClamp},
+        {CompareFunction::kLess, StencilOperation::kSetToReferenceValue},
+    };
+    for (const auto& [compare, operation] : clip_stencils) {
+      ContentContextOptions clip_options = options;
+      clip_options.stencil_compare = compare;
+      clip_options.stencil_operation = operation;
+      variants.push_back({PipelineKind::kClip, clip_options});
+    }
+
+    // Filters overwrite their snapshots.
+    ContentContextOptions source_options = options;
+    source_options.blend_mode = Entity::BlendMode::kSource;
+    for (auto kind : {PipelineKind::kBlend, PipelineKind::kTexture,
+                      PipelineKind::kGaussianBlur,
+                      PipelineKind::kBorderMaskBlur}) {
+      variants.push_back({kind, source_options});
+    }
+  }
+  return variants;
+}
+
+ContentContext::PipelineStats ContentContext::GetPipelineStats() const {
+  PipelineStats stats = pipeline_stats_;
+  stats.precompiled_variants = precompiled_variants_.size();
+  for (const auto& variant : precompiled_variants_) {
+    ForEachPipelineVariants([&](PipelineKind kind, const auto& container) {
+      if (kind != variant.kind) {
+        return;
+      }
+      auto found = container.find(variant.options);
+      if (found != container.end() && found->second->IsReady()) {
+        stats.ready_precompiled_variants++;
+      }
+    });
+  }
+  return stats;
+}
+
 std::shared_ptr<Texture> ContentContext::MakeSubpass(
     ISize texture_size,
     SubpassCallback subpass_callback) const {
@@ -267,4 +367,8 @@ std::shared_ptr<Context> ContentContext::GetContext() const {
   return context_;
 }
 
+MeshCache& ContentContext::GetMeshCache() const {
+  return *mesh_cache_;
+}
+
 }  // namespace impeller
@@ -6,10 +6,14 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/fml/hash_combine.h"
 #include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
 #include "fml/logging.h"
+#include "impeller/base/promise.h"
 #include "impeller/base/validation.h"
 #include "impeller/entity/advanced_blend.vert.h"
 #include "impeller/entity/advanced_blend_color.frag.h"
@@ -31,6 +35,7 @@
 #include "impeller/entity/blend.vert.h"
 #include "impeller/entity/border_mask_blur.frag.h"
 #include "impeller/entity/border_mask_blur.vert.h"
+#include "impeller/entity/contents/mesh_cache.h"
 #include "impeller/entity/entity.h"
 #include "impeller/entity/gaussian_blur.frag.h"
 #include "impeller/entity/gaussian_blur.vert.h"
@@ -129,12 +134,98 @@ struct ContentContextOptions {
 
 class ContentContext {
  public:
+  enum class PipelineKind {
+    kGradientFill,
+    kSolidFill,
+    kBlend,
+    kTexture,
+    kGaussianBlur,
+    kBorderMaskBlur,
+    kSolidStroke,
+    kClip,
+    kGlyphAtlas,
+    kVertices,
+    // Advanced blends.
+    kBlendColor,
+    kBlendColorBurn,
+    kBlendColorDodge,
+    kBlendDarken,
+    kBlendDifference,
+    kBlendExclusion,
+    kBlendHardLight,
+    kBlendHue,
+    kBlendLighten,
+    kBlendLuminosity,
+    kBlendMultiply,
+    kBlendOverlay,
+    kBlendSaturation,
+    kBlendScreen,
+    kBlendSoftLight,
+
+    kLastPipelineKind = kBlendSoftLight,
+  };
+
+  /// A pipeline and the options of one of its variants.
+  struct PipelineVariant {
+    PipelineKind kind;
+    ContentContextOptions options;
+  };
+
+  struct PipelineStats {
+    /// The number of variants that were created on their first use, which
+    /// waits for the whole pipeline creation in the middle of a frame.
+    size_t on_demand_variants = 0;
+    /// The number of variants that were requested by `PrecompilePipelines`,
+    /// and how many of those are ready to be used.
+    size_t precompiled_variants = 0;
+    size_t ready_precompiled_variants = 0;
+    /// The number of times a pipeline was used before it was ready, and the
+    /// total time spent waiting for those pipelines.
+    size_t pipeline_waits = 0;
+    fml::TimeDelta pipeline_wait_time;
+  };
+
   ContentContext(std::shared_ptr<Context> context);
 
   ~ContentContext();
 
   bool IsValid() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Starts the creation of the given pipeline variants without
+  ///             waiting for them, so that their first use in a frame does not
+  ///             have to wait for the pipeline creation.
+  ///
+  ///             The variants are created concurrently by the pipeline library
+  ///             of the backend. Their progress is reported by
+  ///             `GetPipelineStats`.
+  ///
+  /// @param[in]  variants  The variants to create, either a declared list such
+  ///                       as `GetCommonPipelineVariants` or a usage profile
+  ///                       recorded with `GetPipelineVariants`.
+  ///
+  /// @return     The number of variants that did not exist yet.
+  ///
+  size_t PrecompilePipelines(
+      const std::vector<PipelineVariant>& variants) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the variants that have been created so far, other than
+  ///             the default variants that are always created, as a usage
+  ///             profile for `PrecompilePipelines`.
+  ///
+  std::vector<PipelineVariant> GetPipelineVariants() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the variants that most frames use when rendering to
+  ///             offscreen targets and to onscreen targets with the given
+  ///             sample count.
+  ///
+  static std::vector<PipelineVariant> GetCommonPipelineVariants(
+      SampleCount onscreen_sample_count);
+
+  PipelineStats GetPipelineStats() const;
+
   std::shared_ptr<Pipeline> GetGradientFillPipeline(
       ContentContextOptions opts) const {
     return GetPipeline(gradient_fill_pipelines_, opts);
@@ -262,6 +353,9 @@ class ContentContext {
 
   std::shared_ptr<Context> GetContext() const;
 
+  /// The device buffers of the meshes that are drawn in many frames.
+  MeshCache& GetMeshCache() const;
+
   using SubpassCallback =
       std::function<bool(const ContentContext&, RenderPass&)>;
 
@@ -272,6 +366,7 @@ class ContentContext {
 
  private:
   std::shared_ptr<Context> context_;
+  std::unique_ptr<MeshCache> mesh_cache_;
 
   template <class T>
   using Variants = std::unordered_map<ContentContextOptions,
@@ -309,6 +404,10 @@ class ContentContext {
   mutable Variants<BlendScreenPipeline> blend_screen_pipelines_;
   mutable Variants<BlendSoftLightPipeline> blend_softlight_pipelines_;
 
+  // The variants requested by PrecompilePipelines.
+  mutable std::vector<PipelineVariant> precompiled_variants_;
+  mutable PipelineStats pipeline_stats_;
+
   template <class TypedPipeline>
   std::shared_ptr<Pipeline> GetPipeline(Variants<TypedPipeline>& container,
                                         ContentContextOptions opts) const {
@@ -316,25 +415,78 @@ class ContentContext {
       return nullptr;
     }
 
-    if (auto found = container.find(opts); found != container.end()) {
-      return found->second->WaitAndGet();
+    auto found = container.find(opts);
+    if (found == container.end()) {
+      pipeline_stats_.on_demand_variants++;
+      found = container.emplace(opts, CreateVariant(container, opts)).first;
     }
+    return WaitForPipeline(*found->second);
+  }
 
+  template <class TypedPipeline>
+  std::unique_ptr<TypedPipeline> CreateVariant(
+      Variants<TypedPipeline>& container,
+      ContentContextOptions opts) const {
     auto prototype = container.find({});
 
     // The prototype must always be initialized in the constructor.
     FML_CHECK(prototype != container.end());
 
-    auto variant_future = prototype->second->WaitAndGet()->CreateVariant(
+    auto prototype_pipeline = prototype->second->WaitAndGet();
+    if (!prototype_pipeline) {
+      return std::make_unique<TypedPipeline>(
+          RealizedFuture<std::shared_ptr<Pipeline>>(nullptr));
+    }
+    auto variant_future = prototype_pipeline->CreateVariant(
         [&opts, variants_count = container.size()](PipelineDescriptor& desc) {
           opts.ApplyToPipelineDescriptor(desc);
           desc.SetLabel(
               SPrintF("%s V#%zu", desc.GetLabel().c_str(), variants_count));
         });
-    auto variant = std::make_unique<TypedPipeline>(std::move(variant_future));
-    auto variant_pipeline = variant->WaitAndGet();
-    container[opts] = std::move(variant);
-    return variant_pipeline;
+    return std::make_unique<TypedPipeline>(std::move(variant_future));
+  }
+
+  template <class TypedPipeline>
+  std::shared_ptr<Pipeline> WaitForPipeline(TypedPipeline& pipeline) const {
+    if (pipeline.IsReady()) {
+      return pipeline.WaitAndGet();
+    }
+    const auto start = fml::TimePoint::Now();
+    auto result = pipeline.WaitAndGet();
+    pipeline_stats_.pipeline_waits++;
+    pipeline_stats_.pipeline_wait_time =
+        pipeline_stats_.pipeline_wait_time + (fml::TimePoint::Now() - start);
+    return result;
+  }
+
+  // Invokes |callback| with the kind and the variants of every pipeline.
+  template <class Callback>
+  void ForEachPipelineVariants(Callback callback) const {
+    callback(PipelineKind::kGradientFill, gradient_fill_pipelines_);
+    callback(PipelineKind::kSolidFill, solid_fill_pipelines_);
+    callback(PipelineKind::kBlend, texture_blend_pipelines_);
+    callback(PipelineKind::kTexture, texture_pipelines_);
+    callback(PipelineKind::kGaussianBlur, gaussian_blur_pipelines_);
+    callback(PipelineKind::kBorderMaskBlur, border_mask_blur_pipelines_);
+    callback(PipelineKind::kSolidStroke, solid_stroke_pipelines_);
+    callback(PipelineKind::kClip, clip_pipelines_);
+    callback(PipelineKind::kGlyphAtlas, glyph_atlas_pipelines_);
+    callback(PipelineKind::kVertices, vertices_pipelines_);
+    callback(PipelineKind::kBlendColor, blend_color_pipelines_);
+    callback(PipelineKind::kBlendColorBurn, blend_colorburn_pipelines_);
+    callback(PipelineKind::kBlendColorDodge, blend_colordodge_pipelines_);
+    callback(PipelineKind::kBlendDarken, blend_darken_pipelines_);
+    callback(PipelineKind::kBlendDifference, blend_difference_pipelines_);
+    callback(PipelineKind::kBlendExclusion, blend_exclusion_pipelines_);
+    callback(PipelineKind::kBlendHardLight, blend_hardlight_pipelines_);
+    callback(PipelineKind::kBlendHue, blend_hue_pipelines_);
+    callback(PipelineKind::kBlendLighten, blend_lighten_pipelines_);
+    callback(PipelineKind::kBlendLuminosity, blend_luminosity_pipelines_);
+    callback(PipelineKind::kBlendMultiply, blend_multiply_pipelines_);
+    callback(PipelineKind::kBlendOverlay, blend_overlay_pipelines_);
+    callback(PipelineKind::kBlendSaturation, blend_saturation_pipelines_);
+    callback(PipelineKind::kBlendScreen, blend_screen_pipelines_);
+    callback(PipelineKind::kBlendSoftLight, blend_softlight_pipelines_);
   }
 
   bool is_valid_ = false;
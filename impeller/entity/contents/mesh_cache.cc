@@ -0,0 +1,216 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/contents/mesh_cache.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "flutter/fml/trace_event.h"
+
+namespace impeller {
+
+namespace {
+
+// The caches that released meshes are forwarded to.
+struct MeshCaches {
+  std::mutex mutex;
+  std::vector<MeshCache*> caches;
+};
+
+MeshCaches& GetMeshCaches() {
+  static MeshCaches* caches = new MeshCaches();
+  return *caches;
+}
+
+}  // namespace
+
+MeshCache::MeshCache(size_t max_bytes) : max_bytes_(max_bytes) {
+  {
+    MeshCaches& caches = GetMeshCaches();
+    std::scoped_lock lock(caches.mutex);
+    caches.caches.push_back(this);
+  }
+  // Meshes are large and uploading them again stalls the frame that draws
+  // them, so they are trimmed after cheaper caches.
+  registration_ = fml::MemoryGovernor::GetInstance().Register(
+      "ImpellerMeshCache", fml::MemoryGovernor::Priority::kNormal,
+      [this](size_t target_bytes) { Trim(target_bytes); });
+}
+
+MeshCache::~MeshCache() {
+  {
+    MeshCaches& caches = GetMeshCaches();
+    std::scoped_lock lock(caches.mutex);
+    caches.caches.erase(
+        std::find(caches.caches.begin(), caches.caches.end(), this));
+  }
+  // Waits for running trims before the entries go away.
+  registration_.reset();
+}
+
+void MeshCache::ReleaseMesh(uint64_t mesh_id) {
+  MeshCaches& caches = GetMeshCaches();
+  std::scoped_lock lock(caches.mutex);
+  for (MeshCache* cache : caches.caches) {
+    std::scoped_lock released_lock(cache->released_mutex_);
+    cache->released_mesh_ids_.push_back(mesh_id);
+  }
+}
+
+void MeshCache::SetMaxBytes(size_t max_bytes) {
+  {
+    std::scoped_lock lock(mutex_);
+    max_bytes_ = max_bytes;
+    EvictLocked(max_bytes_);
+  }
+  ReportBytes();
+}
+
+size_t MeshCache::GetMaxBytes() const {
+  std::scoped_lock lock(mutex_);
+  return max_bytes_;
+}
+
+std::shared_ptr<DeviceBuffer> MeshCache::Get(const Key& key) {
+  std::scoped_lock lock(mutex_);
+  auto found = entries_by_key_.find(key);
+  if (found == entries_by_key_.end()) {
+    stats_.misses++;
+    return nullptr;
+  }
+  stats_.hits++;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->buffer;
+}
+
+bool MeshCache::ShouldInsert(const Key& key) {
+  std::scoped_lock lock(mutex_);
+  auto [found, inserted] = candidates_.try_emplace(key, frame_);
+  if (inserted || found->second == frame_) {
+    return false;
+  }
+  candidates_.erase(found);
+  return true;
+}
+
+void MeshCache::Insert(const Key& key,
+                       std::shared_ptr<DeviceBuffer> buffer,
+                       size_t bytes) {
+  {
+    std::scoped_lock lock(mutex_);
+    stats_.uploaded_bytes += bytes;
+    frame_uploaded_bytes_ += bytes;
+    if (bytes > max_bytes_ ||
+        entries_by_key_.find(key) != entries_by_key_.end()) {
+      return;
+    }
+    entries_.push_front({key, std::move(buffer), bytes});
+    entries_by_key_[key] = entries_.begin();
+    stats_.bytes += bytes;
+    EvictLocked(max_bytes_);
+  }
+  ReportBytes();
+}
+
+void MeshCache::RecordTransientUpload(size_t bytes) {
+  std::scoped_lock lock(mutex_);
+  stats_.uploaded_bytes += bytes;
+  frame_uploaded_bytes_ += bytes;
+}
+
+size_t MeshCache::FinishFrame() {
+  std::vector<uint64_t> released_mesh_ids;
+  {
+    std::scoped_lock lock(released_mutex_);
+    released_mesh_ids.swap(released_mesh_ids_);
+  }
+
+  size_t uploaded_bytes;
+  bool released_entries;
+  {
+    std::scoped_lock lock(mutex_);
+    uploaded_bytes = frame_uploaded_bytes_;
+    frame_uploaded_bytes_ = 0;
+    released_entries = RemoveReleasedMeshesLocked(released_mesh_ids);
+    // Meshes that were not drawn again in the frame after their first one are
+    // forgotten, so that vertices made in every frame are never kept.
+    for (auto it = candidates_.begin(); it != candidates_.end();) {
+      if (it->second < frame_) {
+        it = candidates_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    frame_++;
+    FML_TRACE_COUNTER("impeller",                                 //
+                      "MeshCache",                                //
+                      reinterpret_cast<int64_t>(this),            //
+                      "UploadedKBytes", uploaded_bytes / 1024,    //
+                      "CachedKBytes", stats_.bytes / 1024);
+  }
+  if (released_entries) {
+    ReportBytes();
+  }
+  return uploaded_bytes;
+}
+
+MeshCache::Stats MeshCache::GetStats() const {
+  std::scoped_lock lock(mutex_);
+  Stats stats = stats_;
+  stats.candidates = candidates_.size();
+  return stats;
+}
+
+void MeshCache::EvictLocked(size_t max_bytes) {
+  while (stats_.bytes > max_bytes) {
+    const Entry& entry = entries_.back();
+    stats_.bytes -= entry.bytes;
+    entries_by_key_.erase(entry.key);
+    entries_.pop_back();
+  }
+}
+
+bool MeshCache::RemoveReleasedMeshesLocked(
+    const std::vector<uint64_t>& mesh_ids) {
+  if (mesh_ids.empty()) {
+    return false;
+  }
+  // A mesh has an entry for every color it was drawn with.
+  const std::unordered_set<uint64_t> released(mesh_ids.begin(),
+                                              mesh_ids.end());
+  bool removed_entries = false;
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (released.count(it->key.mesh_id) != 0) {
+      stats_.bytes -= it->bytes;
+      entries_by_key_.erase(it->key);
+      it = entries_.erase(it);
+      removed_entries = true;
+    } else {
+      ++it;
+    }
+  }
+  for (auto it = candidates_.begin(); it != candidates_.end();) {
+    if (released.count(it->first.mesh_id) != 0) {
+      it = candidates_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return removed_entries;
+}
+
+void MeshCache::Trim(size_t target_bytes) {
+  {
+    std::scoped_lock lock(mutex_);
+    EvictLocked(target_bytes);
+  }
+  ReportBytes();
+}
+
+void MeshCache::ReportBytes() {
+  registration_->ReportBytes(GetStats().bytes);
+}
+
+}  // namespace impeller
@@ -0,0 +1,167 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/memory_governor.h"
+#include "impeller/geometry/color.h"
+#include "impeller/renderer/device_buffer.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Keeps the device buffers of meshes that are drawn in many
+///             frames, so that their vertices are uploaded once instead of in
+///             every frame. The least recently used meshes are evicted when
+///             the buffers exceed a number of bytes.
+///
+///             Meshes are only kept from the second frame that draws them.
+///             Vertices that are made anew in every frame are uploaded to
+///             transient buffers instead, and never take space in the cache.
+///
+///             The buffers of meshes that will not be drawn again are
+///             released at the end of the next frame, once |ReleaseMesh| is
+///             called for them.
+///
+///             The cache also counts the bytes of the vertices uploaded in
+///             each frame, whether they are cached or not.
+///
+class MeshCache {
+ public:
+  static constexpr size_t kDefaultMaxBytes = 128 * 1024 * 1024;
+
+  struct Key {
+    /// The mesh id of the vertices.
+    uint64_t mesh_id = 0;
+    /// The color of the vertices that do not have colors of their own.
+    Color color;
+
+    struct Hash {
+      std::size_t operator()(const Key& key) const {
+        return fml::HashCombine(key.mesh_id, key.color.red, key.color.green,
+                                key.color.blue, key.color.alpha);
+      }
+    };
+
+    struct Equal {
+      constexpr bool operator()(const Key& lhs, const Key& rhs) const {
+        return lhs.mesh_id == rhs.mesh_id && lhs.color == rhs.color;
+      }
+    };
+  };
+
+  struct Stats {
+    size_t bytes = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    /// The bytes of vertices uploaded since the cache was created.
+    size_t uploaded_bytes = 0;
+    /// The meshes drawn in the last frame that would be kept if they are
+    /// drawn again.
+    size_t candidates = 0;
+  };
+
+  explicit MeshCache(size_t max_bytes = kDefaultMaxBytes);
+
+  ~MeshCache();
+
+  void SetMaxBytes(size_t max_bytes);
+
+  size_t GetMaxBytes() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the buffer of the mesh, or nullptr if it has to be
+  ///             uploaded.
+  ///
+  std::shared_ptr<DeviceBuffer> Get(const Key& key);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called for a mesh that missed the cache.
+  ///
+  /// @return     Whether the mesh was drawn in an earlier frame too, in which
+  ///             case it is worth uploading to a buffer that is passed to
+  ///             |Insert|. Otherwise the vertices are uploaded to a transient
+  ///             buffer and counted with |RecordTransientUpload|.
+  ///
+  bool ShouldInsert(const Key& key);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Keeps the buffer that the vertices of the mesh were just
+  ///             uploaded to, which takes |bytes|.
+  ///
+  void Insert(const Key& key,
+              std::shared_ptr<DeviceBuffer> buffer,
+              size_t bytes);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Counts vertices that were uploaded to a transient buffer.
+  ///
+  void RecordTransientUpload(size_t bytes);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Ends a frame, and traces the bytes uploaded during it.
+  ///
+  /// @return     The bytes of vertices uploaded since the last call.
+  ///
+  size_t FinishFrame();
+
+  Stats GetStats() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Releases the buffers of a mesh that will not be drawn again
+  ///             from every cache, at the end of their next frame. Can be
+  ///             called on any thread.
+  ///
+  static void ReleaseMesh(uint64_t mesh_id);
+
+ private:
+  struct Entry {
+    Key key;
+    std::shared_ptr<DeviceBuffer> buffer;
+    size_t bytes;
+  };
+
+  using Entries = std::list<Entry>;
+
+  mutable std::mutex mutex_;
+  size_t max_bytes_;
+  // The most recently used entries first.
+  Entries entries_;
+  std::unordered_map<Key, Entries::iterator, Key::Hash, Key::Equal>
+      entries_by_key_;
+  Stats stats_;
+  size_t frame_uploaded_bytes_ = 0;
+  // Incremented by |FinishFrame|.
+  uint64_t frame_ = 0;
+  // The meshes that missed the cache in the current and the last frame, and
+  // the frame that they were first drawn in.
+  std::unordered_map<Key, uint64_t, Key::Hash, Key::Equal> candidates_;
+  // The meshes released since the last frame. Guarded by |released_mutex_|
+  // rather than |mutex_|, as meshes are released from any thread.
+  std::mutex released_mutex_;
+  std::vector<uint64_t> released_mesh_ids_;
+  std::unique_ptr<fml::MemoryGovernor::Registration> registration_;
+
+  void EvictLocked(size_t max_bytes);
+
+  // Drops the entries and candidates of the released meshes, and returns
+  // whether there were any entries.
+  bool RemoveReleasedMeshesLocked(const std::vector<uint64_t>& mesh_ids);
+
+  void Trim(size_t target_bytes);
+
+  void ReportBytes();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(MeshCache);
+};
+
+}  // namespace impeller
@@ -0,0 +1,142 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/contents/mesh_cache.h"
+
+#include <memory>
+
+#include "flutter/testing/testing.h"
+#include "gtest/gtest.h"
+
+namespace impeller {
+namespace testing {
+
+namespace {
+
+class FakeDeviceBuffer final : public DeviceBuffer {
+ public:
+  explicit FakeDeviceBuffer(size_t size)
+      : DeviceBuffer(size, StorageMode::kHostVisible) {}
+
+  bool CopyHostBuffer(const uint8_t* source,
+                      Range source_range,
+                      size_t offset) override {
+    return true;
+  }
+
+  bool SetLabel(const std::string& label) override { return true; }
+
+  bool SetLabel(const std::string& label, Range range) override {
+    return true;
+  }
+};
+
+MeshCache::Key MakeKey(uint64_t mesh_id) {
+  return {.mesh_id = mesh_id, .color = Color::Red()};
+}
+
+}  // namespace
+
+TEST(MeshCacheTest, ReusesBuffersOfTheSameMesh) {
+  MeshCache cache;
+  EXPECT_EQ(cache.Get(MakeKey(1)), nullptr);
+  auto buffer = std::make_shared<FakeDeviceBuffer>(100);
+  cache.Insert(MakeKey(1), buffer, 100);
+  EXPECT_EQ(cache.FinishFrame(), 100u);
+
+  EXPECT_EQ(cache.Get(MakeKey(1)), buffer);
+  // Vertices without colors of their own are uploaded for every color.
+  EXPECT_EQ(cache.Get({.mesh_id = 1, .color = Color::Blue()}), nullptr);
+  EXPECT_EQ(cache.FinishFrame(), 0u);
+
+  cache.RecordTransientUpload(30);
+  EXPECT_EQ(cache.FinishFrame(), 30u);
+
+  MeshCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.bytes, 100u);
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 2u);
+  EXPECT_EQ(stats.uploaded_bytes, 130u);
+}
+
+TEST(MeshCacheTest, EvictsLeastRecentlyUsedMeshesOverBudget) {
+  MeshCache cache(250);
+  cache.Insert(MakeKey(1), std::make_shared<FakeDeviceBuffer>(100), 100);
+  cache.Insert(MakeKey(2), std::make_shared<FakeDeviceBuffer>(100), 100);
+  ASSERT_NE(cache.Get(MakeKey(1)), nullptr);
+  cache.Insert(MakeKey(3), std::make_shared<FakeDeviceBuffer>(100), 100);
+  EXPECT_NE(cache.Get(MakeKey(1)), nullptr);
+  EXPECT_EQ(cache.Get(MakeKey(2)), nullptr);
+  EXPECT_NE(cache.Get(MakeKey(3)), nullptr);
+  EXPECT_EQ(cache.GetStats().bytes, 200u);
+
+  // Meshes larger than the budget are not kept.
+  cache.Insert(MakeKey(4), std::make_shared<FakeDeviceBuffer>(300), 300);
+  EXPECT_EQ(cache.Get(MakeKey(4)), nullptr);
+  EXPECT_EQ(cache.GetStats().bytes, 200u);
+
+  cache.SetMaxBytes(100);
+  EXPECT_NE(cache.Get(MakeKey(3)), nullptr);
+  EXPECT_EQ(cache.Get(MakeKey(1)), nullptr);
+  EXPECT_EQ(cache.GetStats().bytes, 100u);
+}
+
+TEST(MeshCacheTest, KeepsMeshesFromTheirSecondFrame) {
+  MeshCache cache;
+  EXPECT_FALSE(cache.ShouldInsert(MakeKey(1)));
+  // Drawing a mesh twice in the same frame does not make it worth keeping.
+  EXPECT_FALSE(cache.ShouldInsert(MakeKey(1)));
+  cache.FinishFrame();
+  EXPECT_TRUE(cache.ShouldInsert(MakeKey(1)));
+  EXPECT_EQ(cache.GetStats().candidates, 0u);
+
+  // Meshes that skip a frame start over.
+  EXPECT_FALSE(cache.ShouldInsert(MakeKey(2)));
+  cache.FinishFrame();
+  cache.FinishFrame();
+  EXPECT_FALSE(cache.ShouldInsert(MakeKey(2)));
+}
+
+TEST(MeshCacheTest, DoesNotGrowWithMeshesMadeInEveryFrame) {
+  MeshCache cache;
+  // Like a new Vertices object built in every call to paint.
+  uint64_t mesh_id = 1;
+  for (int frame = 0; frame < 100; frame++) {
+    const MeshCache::Key key = MakeKey(mesh_id++);
+    ASSERT_EQ(cache.Get(key), nullptr);
+    ASSERT_FALSE(cache.ShouldInsert(key));
+    cache.RecordTransientUpload(100);
+    EXPECT_EQ(cache.FinishFrame(), 100u);
+  }
+
+  MeshCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.bytes, 0u);
+  EXPECT_EQ(stats.candidates, 1u);
+  EXPECT_EQ(stats.uploaded_bytes, 10000u);
+}
+
+TEST(MeshCacheTest, DropsReleasedMeshesAtTheEndOfTheFrame) {
+  MeshCache cache;
+  cache.Insert(MakeKey(1), std::make_shared<FakeDeviceBuffer>(100), 100);
+  cache.Insert({.mesh_id = 1, .color = Color::Blue()},
+               std::make_shared<FakeDeviceBuffer>(100), 100);
+  cache.Insert(MakeKey(2), std::make_shared<FakeDeviceBuffer>(100), 100);
+  EXPECT_FALSE(cache.ShouldInsert(MakeKey(3)));
+
+  MeshCache::ReleaseMesh(1);
+  MeshCache::ReleaseMesh(3);
+  // Released meshes stay until the frame that may still draw them ends.
+  EXPECT_NE(cache.Get(MakeKey(1)), nullptr);
+  cache.FinishFrame();
+
+  EXPECT_EQ(cache.Get(MakeKey(1)), nullptr);
+  EXPECT_EQ(cache.Get({.mesh_id = 1, .color = Color::Blue()}), nullptr);
+  EXPECT_NE(cache.Get(MakeKey(2)), nullptr);
+  MeshCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.bytes, 100u);
+  EXPECT_EQ(stats.candidates, 0u);
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -61,36 +61,68 @@ bool VerticesContents::Render(const ContentContext& renderer,
     return true;
   }
 
-  std::vector<VS::PerVertexData> vertex_data;
-  {
-    const auto& positions = vertices_.GetPositions();
-    const auto& colors = vertices_.GetColors();
-    for (size_t i = 0; i < positions.size(); i++) {
-      vertex_data.push_back(VS::PerVertexData{
-          .position = positions[i],
-          // TODO(108047): Blend these colors together when available. Use
-          //               colors[i] as the destination and color_ as the
-          //               source. Always use color_ when vertex colors are not
-          //               supplied.
-          .color = i < colors.size() ? colors[i] : color_,
-      });
-    }
+  size_t total_vtx_bytes =
+      vertices_.GetPositions().size() * sizeof(VS::PerVertexData);
+  size_t total_idx_bytes = vertices_.GetIndices().size() * sizeof(uint16_t);
+
+  // Meshes that are drawn in many frames are uploaded once, to a buffer that
+  // outlives the frame. Until a mesh is drawn in a second frame, it is
+  // uploaded to a transient buffer like vertices without a mesh id.
+  MeshCache& mesh_cache = renderer.GetMeshCache();
+  const MeshCache::Key mesh_key = {
+      .mesh_id = vertices_.GetMeshId(),
+      .color = vertices_.GetColors().empty() ? color_ : Color(),
+  };
+  std::shared_ptr<DeviceBuffer> buffer;
+  if (mesh_key.mesh_id != 0) {
+    buffer = mesh_cache.Get(mesh_key);
   }
 
-  size_t total_vtx_bytes = vertex_data.size() * sizeof(VS::PerVertexData);
-  size_t total_idx_bytes = vertices_.GetIndices().size() * sizeof(uint16_t);
+  if (!buffer) {
+    const bool cache_mesh =
+        mesh_key.mesh_id != 0 && mesh_cache.ShouldInsert(mesh_key);
+    std::vector<VS::PerVertexData> vertex_data;
+    {
+      const auto& positions = vertices_.GetPositions();
+      const auto& colors = vertices_.GetColors();
+      vertex_data.reserve(positions.size());
+      for (size_t i = 0; i < positions.size(); i++) {
+        vertex_data.push_back(VS::PerVertexData{
+            .position = positions[i],
+            // TODO(108047): Blend these colors together when available. Use
+            //               colors[i] as the destination and color_ as the
+            //               source. Always use color_ when vertex colors are
+            //               not supplied.
+            .color = i < colors.size() ? colors[i] : color_,
+        });
+      }
+    }
 
-  auto buffer = renderer.GetContext()->GetTransientsAllocator()->CreateBuffer(
-      StorageMode::kHostVisible, total_vtx_bytes + total_idx_bytes);
+    auto allocator = cache_mesh
+                         ? renderer.GetContext()->GetPermanentsAllocator()
+                         : renderer.GetContext()->GetTransientsAllocator();
+    buffer = allocator->CreateBuffer(StorageMode::kHostVisible,
+                                     total_vtx_bytes + total_idx_bytes);
+    if (!buffer) {
+      return false;
+    }
 
-  if (!buffer->CopyHostBuffer(reinterpret_cast<uint8_t*>(vertex_data.data()),
-                              Range{0, total_vtx_bytes}, 0)) {
-    return false;
-  }
-  if (!buffer->CopyHostBuffer(reinterpret_cast<uint8_t*>(const_cast<uint16_t*>(
-                                  vertices_.GetIndices().data())),
-                              Range{0, total_idx_bytes}, total_vtx_bytes)) {
-    return false;
+    if (!buffer->CopyHostBuffer(reinterpret_cast<uint8_t*>(vertex_data.data()),
+                                Range{0, total_vtx_bytes}, 0)) {
+      return false;
+    }
+    if (!buffer->CopyHostBuffer(
+            reinterpret_cast<uint8_t*>(
+                const_cast<uint16_t*>(vertices_.GetIndices().data())),
+            Range{0, total_idx_bytes}, total_vtx_bytes)) {
+      return false;
+    }
+
+    if (cache_mesh) {
+      mesh_cache.Insert(mesh_key, buffer, total_vtx_bytes + total_idx_bytes);
+    } else {
+      mesh_cache.RecordTransientUpload(total_vtx_bytes + total_idx_bytes);
+    }
   }
 
   auto& host_buffer = pass.GetTransientsBuffer();
@@ -7,6 +7,7 @@
 
 #include "flutter/testing/testing.h"
 #include "impeller/entity/contents/clip_contents.h"
+#include "impeller/entity/contents/content_context.h"
 #include "impeller/entity/contents/filters/blend_filter_contents.h"
 #include "impeller/entity/contents/filters/filter_contents.h"
 #include "impeller/entity/contents/filters/inputs/filter_input.h"
@@ -1176,5 +1177,64 @@ TEST_P(EntityTest, ClipContentsShouldRenderIsCorrect) {
   }
 }
 
+TEST_P(EntityTest, PrecompiledPipelinesAreNotCreatedOnFirstUse) {
+  ContentContext content_context(GetContext());
+  ASSERT_TRUE(content_context.IsValid());
+
+  auto variants =
+      ContentContext::GetCommonPipelineVariants(SampleCount::kCount4);
+  auto requested = content_context.PrecompilePipelines(variants);
+  // The default variants already exist.
+  ASSERT_GT(requested, 0u);
+  ASSERT_LT(requested, variants.size());
+  ASSERT_EQ(content_context.PrecompilePipelines(variants), 0u);
+
+  auto stats = content_context.GetPipelineStats();
+  ASSERT_EQ(stats.precompiled_variants, requested);
+  ASSERT_LE(stats.ready_precompiled_variants, requested);
+
+  ContentContextOptions clip_options;
+  clip_options.sample_count = SampleCount::kCount4;
+  clip_options.stencil_operation = StencilOperation::kIncrementClamp;
+  ASSERT_TRUE(content_context.GetClipPipeline(clip_options));
+  ContentContextOptions solid_options;
+  solid_options.sample_count = SampleCount::kCount4;
+  ASSERT_TRUE(content_context.GetSolidFillPipeline(solid_options));
+  ASSERT_EQ(content_context.GetPipelineStats().on_demand_variants, 0u);
+
+  // Variants that were not precompiled are still created on their first use.
+  solid_options.blend_mode = Entity::BlendMode::kXor;
+  ASSERT_TRUE(content_context.GetSolidFillPipeline(solid_options));
+  stats = content_context.GetPipelineStats();
+  ASSERT_EQ(stats.on_demand_variants, 1u);
+  ASSERT_GE(stats.pipeline_waits, 1u);
+}
+
+TEST_P(EntityTest, PipelineUsageProfileCanBePrecompiled) {
+  ContentContextOptions options;
+  options.blend_mode = Entity::BlendMode::kPlus;
+  std::vector<ContentContext::PipelineVariant> profile;
+  {
+    ContentContext content_context(GetContext());
+    ASSERT_TRUE(content_context.IsValid());
+    ASSERT_TRUE(content_context.GetSolidFillPipeline(options));
+    ASSERT_TRUE(content_context.GetTexturePipeline(options));
+    ASSERT_TRUE(content_context.GetSolidFillPipeline(options));
+    ASSERT_TRUE(content_context.GetTexturePipeline({}));
+    ASSERT_EQ(content_context.GetPipelineStats().on_demand_variants, 2u);
+    profile = content_context.GetPipelineVariants();
+  }
+  ASSERT_EQ(profile.size(), 2u);
+
+  ContentContext content_context(GetContext());
+  ASSERT_TRUE(content_context.IsValid());
+  ASSERT_EQ(content_context.PrecompilePipelines(profile), 2u);
+  ASSERT_TRUE(content_context.GetSolidFillPipeline(options));
+  ASSERT_TRUE(content_context.GetTexturePipeline(options));
+  auto stats = content_context.GetPipelineStats();
+  ASSERT_EQ(stats.on_demand_variants, 0u);
+  ASSERT_EQ(stats.ready_precompiled_variants, 2u);
+}
+
 }  // namespace testing
 }  // namespace impeller
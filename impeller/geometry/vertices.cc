@@ -61,6 +61,14 @@ VertexMode Vertices::GetMode() const {
   return vertex_mode_;
 }
 
+void Vertices::SetMeshId(uint64_t mesh_id) {
+  mesh_id_ = mesh_id;
+}
+
+uint64_t Vertices::GetMeshId() const {
+  return mesh_id_;
+}
+
 void Vertices::NormalizeIndices() {
   if (indices_.size() != 0 || positions_.size() == 0) {
     return;
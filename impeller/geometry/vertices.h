@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <vector>
 
@@ -42,12 +43,20 @@ class Vertices {
 
   VertexMode GetMode() const;
 
+  /// Identifies the mesh these vertices were created from across frames, so
+  /// that the data uploaded for it can be reused. 0 for vertices that are
+  /// not reused.
+  void SetMeshId(uint64_t mesh_id);
+
+  uint64_t GetMeshId() const;
+
  private:
   std::vector<Point> positions_;
   std::vector<uint16_t> indices_;
   std::vector<Color> colors_;
   VertexMode vertex_mode_;
   Rect bounds_;
+  uint64_t mesh_id_ = 0;
 
   void NormalizeIndices();
 };
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <future>
 
 #include "flutter/fml/macros.h"
@@ -98,6 +99,13 @@ class PipelineT {
     return pipeline_;
   }
 
+  /// Whether `WaitAndGet` can return the pipeline without blocking.
+  bool IsReady() const {
+    return did_wait_ || !pipeline_future_.valid() ||
+           pipeline_future_.wait_for(std::chrono::seconds(0)) ==
+               std::future_status::ready;
+  }
+
  private:
   PipelineFuture pipeline_future_;
   std::shared_ptr<Pipeline> pipeline_;
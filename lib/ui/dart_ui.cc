@@ -142,6 +142,7 @@ typedef CanvasPath Path;
   V(Canvas, drawRect, 7)                               \
   V(Canvas, drawShadow, 5)                             \
   V(Canvas, drawVertices, 5)                           \
+  V(Canvas, executeCommands, 3)                        \
   V(Canvas, getDestinationClipBounds, 2)               \
   V(Canvas, getLocalClipBounds, 2)                     \
   V(Canvas, getSaveCount, 1)                           \
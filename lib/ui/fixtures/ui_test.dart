@@ -231,6 +231,29 @@ void frameCallback(_Image, int) {
 @pragma('vm:entry-point')
 void messageCallback(dynamic data) {}
 
+// Records |count| items of a list of cards, with seven canvas calls for each
+// of them.
+@pragma('vm:entry-point')
+void recordCanvasCommands(int count) {
+  final PictureRecorder recorder = PictureRecorder();
+  final Canvas canvas = Canvas(recorder);
+  final Paint fill = Paint()..color = const Color(0xFF2196F3);
+  final Paint stroke = Paint()
+    ..style = PaintingStyle.stroke
+    ..strokeWidth = 2;
+  final RRect card = RRect.fromLTRBR(8, 4, 392, 44, const Radius.circular(4));
+  for (int i = 0; i < count; i++) {
+    canvas.save();
+    canvas.translate(0, i * 48.0);
+    canvas.clipRect(const Rect.fromLTWH(0, 0, 400, 48));
+    canvas.drawRRect(card, fill);
+    canvas.drawCircle(const Offset(28, 24), 12, stroke);
+    canvas.drawLine(const Offset(48, 24), const Offset(380, 24), stroke);
+    canvas.restore();
+  }
+  recorder.endRecording().dispose();
+}
+
 @pragma('vm:entry-point')
 void validateConfiguration() native 'ValidateConfiguration';
 
@@ -1135,6 +1135,10 @@ class Paint {
   static const int _kDitherOffset = _kDitherIndex << 2;
   // If you add more fields, remember to update _kDataByteCount.
   static const int _kDataByteCount = 56;
+  static const int _kDataWordCount = _kDataByteCount >> 2;
+
+  // A view of [_data] as the words that batched canvas commands copy.
+  late final Uint32List _words = _data.buffer.asUint32List(_data.offsetInBytes, _kDataWordCount);
 
   // Binary format must match the deserialization code in paint.cc.
   List<Object?>? _objects;
@@ -4450,6 +4454,76 @@ class Canvas extends NativeFieldWrapperClass1 {
   // garbage collected until PictureRecorder.endRecording is called.
   PictureRecorder? _recorder;
 
+  // Commands that do not need to unwrap native objects are written into a
+  // buffer of words and replayed by a single native call, instead of making a
+  // native call each. The buffer is flushed when it is full, before any other
+  // native call, and when the recording ends.
+  //
+  // The values and argument layouts must match CanvasCommand in
+  // canvas_commands.h.
+  static const int _kSaveCommand = 0;
+  static const int _kRestoreCommand = 1;
+  static const int _kTranslateCommand = 2;
+  static const int _kScaleCommand = 3;
+  static const int _kRotateCommand = 4;
+  static const int _kSkewCommand = 5;
+  static const int _kClipRectCommand = 6;
+  static const int _kDrawColorCommand = 7;
+  static const int _kDrawPaintCommand = 8;
+  static const int _kDrawLineCommand = 9;
+  static const int _kDrawRectCommand = 10;
+  static const int _kDrawRRectCommand = 11;
+  static const int _kDrawOvalCommand = 12;
+  static const int _kDrawCircleCommand = 13;
+
+  static const int _kCommandBufferWordCount = 1024;
+
+  // Whether commands are batched. Benchmarks turn this off to measure the
+  // cost of a native call per command.
+  @pragma('vm:entry-point')
+  static bool _batchCommands = true;
+
+  Uint32List? _commandWords;
+  Float32List? _commandFloats;
+  int _commandLength = 0;
+
+  // Appends a command with |argumentCount| words of arguments to the buffer
+  // and returns the index at which its arguments are to be written.
+  int _addCommand(int command, int argumentCount) {
+    Uint32List? words = _commandWords;
+    if (words == null) {
+      words = _commandWords = Uint32List(_kCommandBufferWordCount);
+      _commandFloats = Float32List.view(words.buffer);
+    } else if (_commandLength + argumentCount + 1 > _kCommandBufferWordCount) {
+      _flushCommands();
+    }
+    final int index = _commandLength;
+    words[index] = command;
+    _commandLength = index + argumentCount + 1;
+    return index + 1;
+  }
+
+  int _addPaintCommand(int command, int argumentCount, Paint paint) {
+    final int index = _addCommand(command, argumentCount + Paint._kDataWordCount);
+    final int paintIndex = index + argumentCount;
+    _commandWords!.setRange(paintIndex, paintIndex + Paint._kDataWordCount, paint._words);
+    return index;
+  }
+
+  // Whether a command that draws with |paint| can be batched.
+  static bool _canBatchPaint(Paint paint) => _batchCommands && paint._objects == null;
+
+  void _flushCommands() {
+    final int length = _commandLength;
+    if (length == 0)
+      return;
+    _commandLength = 0;
+    _executeCommands(_commandWords!, length);
+  }
+
+  @FfiNative<Void Function(Pointer<Void>, Handle, Int32)>('Canvas::executeCommands')
+  external void _executeCommands(Uint32List commands, int length);
+
   /// Saves a copy of the current transform and clip on the save stack.
   ///
   /// Call [restore] to pop the save stack.
@@ -4458,8 +4532,16 @@ class Canvas extends NativeFieldWrapperClass1 {
   ///
   ///  * [saveLayer], which does the same thing but additionally also groups the
   ///    commands done until the matching [restore].
+  void save() {
+    if (_batchCommands) {
+      _addCommand(_kSaveCommand, 0);
+      return;
+    }
+    _save();
+  }
+
   @FfiNative<Void Function(Pointer<Void>)>('Canvas::save', isLeaf: true)
-  external void save();
+  external void _save();
 
   /// Saves a copy of the current transform and clip on the save stack, and then
   /// creates a new group which subsequent calls will become a part of. When the
@@ -4572,6 +4654,7 @@ class Canvas extends NativeFieldWrapperClass1 {
   ///    [saveLayer].
   void saveLayer(Rect? bounds, Paint paint) {
     assert(paint != null);
+    _flushCommands();
     if (bounds == null) {
       _saveLayerWithoutBounds(paint._objects, paint._data);
     } else {
@@ -4593,8 +4676,16 @@ class Canvas extends NativeFieldWrapperClass1 {
   ///
   /// If the state was pushed with with [saveLayer], then this call will also
   /// cause the new layer to be composited into the previous layer.
+  void restore() {
+    if (_batchCommands) {
+      _addCommand(_kRestoreCommand, 0);
+      return;
+    }
+    _restore();
+  }
+
   @FfiNative<Void Function(Pointer<Void>)>('Canvas::restore', isLeaf: true)
-  external void restore();
+  external void _restore();
 
   /// Returns the number of items on the save stack, including the
   /// initial state. This means it returns 1 for a clean canvas, and
@@ -4602,13 +4693,29 @@ class Canvas extends NativeFieldWrapperClass1 {
   /// each matching call to [restore] decrements it.
   ///
   /// This number cannot go below 1.
+  int getSaveCount() {
+    _flushCommands();
+    return _getSaveCount();
+  }
+
   @FfiNative<Int32 Function(Pointer<Void>)>('Canvas::getSaveCount', isLeaf: true)
-  external int getSaveCount();
+  external int _getSaveCount();
 
   /// Add a translation to the current transform, shifting the coordinate space
   /// horizontally by the first argument and vertically by the second argument.
+  void translate(double dx, double dy) {
+    if (_batchCommands) {
+      final int index = _addCommand(_kTranslateCommand, 2);
+      final Float32List floats = _commandFloats!;
+      floats[index] = dx;
+      floats[index + 1] = dy;
+      return;
+    }
+    _translate(dx, dy);
+  }
+
   @FfiNative<Void Function(Pointer<Void>, Double, Double)>('Canvas::translate', isLeaf: true)
-  external void translate(double dx, double dy);
+  external void _translate(double dx, double dy);
 
   /// Add an axis-aligned scale to the current transform, scaling by the first
   /// argument in the horizontal direction and the second in the vertical
@@ -4616,21 +4723,52 @@ class Canvas extends NativeFieldWrapperClass1 {
   ///
   /// If [sy] is unspecified, [sx] will be used for the scale in both
   /// directions.
-  void scale(double sx, [double? sy]) => _scale(sx, sy ?? sx);
+  void scale(double sx, [double? sy]) {
+    sy ??= sx;
+    if (_batchCommands) {
+      final int index = _addCommand(_kScaleCommand, 2);
+      final Float32List floats = _commandFloats!;
+      floats[index] = sx;
+      floats[index + 1] = sy;
+      return;
+    }
+    _scale(sx, sy);
+  }
 
   @FfiNative<Void Function(Pointer<Void>, Double, Double)>('Canvas::scale', isLeaf: true)
   external void _scale(double sx, double sy);
 
   /// Add a rotation to the current transform. The argument is in radians clockwise.
+  void rotate(double radians) {
+    if (_batchCommands) {
+      // Converted here so that the angle is rounded like the one of the
+      // native call.
+      _commandFloats![_addCommand(_kRotateCommand, 1)] = radians * 180.0 / math.pi;
+      return;
+    }
+    _rotate(radians);
+  }
+
   @FfiNative<Void Function(Pointer<Void>, Double)>('Canvas::rotate', isLeaf: true)
-  external void rotate(double radians);
+  external void _rotate(double radians);
 
   /// Add an axis-aligned skew to the current transform, with the first argument
   /// being the horizontal skew in rise over run units clockwise around the
   /// origin, and the second argument being the vertical skew in rise over run
   /// units clockwise around the origin.
+  void skew(double sx, double sy) {
+    if (_batchCommands) {
+      final int index = _addCommand(_kSkewCommand, 2);
+      final Float32List floats = _commandFloats!;
+      floats[index] = sx;
+      floats[index + 1] = sy;
+      return;
+    }
+    _skew(sx, sy);
+  }
+
   @FfiNative<Void Function(Pointer<Void>, Double, Double)>('Canvas::skew', isLeaf: true)
-  external void skew(double sx, double sy);
+  external void _skew(double sx, double sy);
 
   /// Multiply the current transform by the specified 4⨉4 transformation matrix
   /// specified as a list of values in column-major order.
@@ -4638,6 +4776,7 @@ class Canvas extends NativeFieldWrapperClass1 {
     assert(matrix4 != null);
     if (matrix4.length != 16)
       throw ArgumentError('"matrix4" must have 16 entries.');
+    _flushCommands();
     _transform(matrix4);
   }
 
@@ -4654,6 +4793,7 @@ class Canvas extends NativeFieldWrapperClass1 {
   /// associated [save] or [saveLayer] call.
   Float64List getTransform() {
     final Float64List matrix4 = Float64List(16);
+    _flushCommands();
     _getTransform(matrix4);
     return matrix4;
   }
@@ -4676,6 +4816,18 @@ class Canvas extends NativeFieldWrapperClass1 {
     assert(_rectIsValid(rect));
     assert(clipOp != null);
     assert(doAntiAlias != null);
+    if (_batchCommands) {
+      final int index = _addCommand(_kClipRectCommand, 6);
+      final Float32List floats = _commandFloats!;
+      floats[index] = rect.left;
+      floats[index + 1] = rect.top;
+      floats[index + 2] = rect.right;
+      floats[index + 3] = rect.bottom;
+      final Uint32List words = _commandWords!;
+      words[index + 4] = clipOp.index;
+      words[index + 5] = doAntiAlias ? 1 : 0;
+      return;
+    }
     _clipRect(rect.left, rect.top, rect.right, rect.bottom, clipOp.index, doAntiAlias);
   }
 
@@ -4693,6 +4845,7 @@ class Canvas extends NativeFieldWrapperClass1 {
   void clipRRect(RRect rrect, {bool doAntiAlias = true}) {
     assert(_rrectIsValid(rrect));
     assert(doAntiAlias != null);
+    _flushCommands();
     _clipRRect(rrect._getValue32(), doAntiAlias);
   }
 
@@ -4710,6 +4863,7 @@ class Canvas extends NativeFieldWrapperClass1 {
   void clipPath(Path path, {bool doAntiAlias = true}) {
     assert(path != null); // path is checked on the engine side
     assert(doAntiAlias != null);
+    _flushCommands();
     _clipPath(path, doAntiAlias);
   }
 
@@ -4767,6 +4921,7 @@ class Canvas extends NativeFieldWrapperClass1 {
   /// {@endtemplate}
   Rect getLocalClipBounds() {
     final Float64List bounds = Float64List(4);
+    _flushCommands();
     _getLocalClipBounds(bounds);
     return Rect.fromLTRB(bounds[0], bounds[1], bounds[2], bounds[3]);
   }
@@ -4790,6 +4945,7 @@ class Canvas extends NativeFieldWrapperClass1 {
   /// {@macro dart.ui.canvas.conservativeClipBounds}
   Rect getDestinationClipBounds() {
     final Float64List bounds = Float64List(4);
+    _flushCommands();
     _getDestinationClipBounds(bounds);
     return Rect.fromLTRB(bounds[0], bounds[1], bounds[2], bounds[3]);
   }
@@ -4803,6 +4959,13 @@ class Canvas extends NativeFieldWrapperClass1 {
   void drawColor(Color color, BlendMode blendMode) {
     assert(color != null);
     assert(blendMode != null);
+    if (_batchCommands) {
+      final int index = _addCommand(_kDrawColorCommand, 2);
+      final Uint32List words = _commandWords!;
+      words[index] = color.value;
+      words[index + 1] = blendMode.index;
+      return;
+    }
     _drawColor(color.value, blendMode.index);
   }
 
@@ -4817,6 +4980,16 @@ class Canvas extends NativeFieldWrapperClass1 {
     assert(_offsetIsValid(p1));
     assert(_offsetIsValid(p2));
     assert(paint != null);
+    if (_canBatchPaint(paint)) {
+      final int index = _addPaintCommand(_kDrawLineCommand, 4, paint);
+      final Float32List floats = _commandFloats!;
+      floats[index] = p1.dx;
+      floats[index + 1] = p1.dy;
+      floats[index + 2] = p2.dx;
+      floats[index + 3] = p2.dy;
+      return;
+    }
+    _flushCommands();
     _drawLine(p1.dx, p1.dy, p2.dx, p2.dy, paint._objects, paint._data);
   }
 
@@ -4829,6 +5002,11 @@ class Canvas extends NativeFieldWrapperClass1 {
   /// [drawColor] instead.
   void drawPaint(Paint paint) {
     assert(paint != null);
+    if (_canBatchPaint(paint)) {
+      _addPaintCommand(_kDrawPaintCommand, 0, paint);
+      return;
+    }
+    _flushCommands();
     _drawPaint(paint._objects, paint._data);
   }
 
@@ -4840,6 +5018,16 @@ class Canvas extends NativeFieldWrapperClass1 {
   void drawRect(Rect rect, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null);
+    if (_canBatchPaint(paint)) {
+      final int index = _addPaintCommand(_kDrawRectCommand, 4, paint);
+      final Float32List floats = _commandFloats!;
+      floats[index] = rect.left;
+      floats[index + 1] = rect.top;
+      floats[index + 2] = rect.right;
+      floats[index + 3] = rect.bottom;
+      return;
+    }
+    _flushCommands();
     _drawRect(rect.left, rect.top, rect.right, rect.bottom, paint._objects, paint._data);
   }
 
@@ -4851,6 +5039,24 @@ class Canvas extends NativeFieldWrapperClass1 {
   void drawRRect(RRect rrect, Paint paint) {
     assert(_rrectIsValid(rrect));
     assert(paint != null);
+    if (_canBatchPaint(paint)) {
+      final int index = _addPaintCommand(_kDrawRRectCommand, 12, paint);
+      final Float32List floats = _commandFloats!;
+      floats[index] = rrect.left;
+      floats[index + 1] = rrect.top;
+      floats[index + 2] = rrect.right;
+      floats[index + 3] = rrect.bottom;
+      floats[index + 4] = rrect.tlRadiusX;
+      floats[index + 5] = rrect.tlRadiusY;
+      floats[index + 6] = rrect.trRadiusX;
+      floats[index + 7] = rrect.trRadiusY;
+      floats[index + 8] = rrect.brRadiusX;
+      floats[index + 9] = rrect.brRadiusY;
+      floats[index + 10] = rrect.blRadiusX;
+      floats[index + 11] = rrect.blRadiusY;
+      return;
+    }
+    _flushCommands();
     _drawRRect(rrect._getValue32(), paint._objects, paint._data);
   }
 
@@ -4866,6 +5072,7 @@ class Canvas extends NativeFieldWrapperClass1 {
     assert(_rrectIsValid(outer));
     assert(_rrectIsValid(inner));
     assert(paint != null);
+    _flushCommands();
     _drawDRRect(outer._getValue32(), inner._getValue32(), paint._objects, paint._data);
   }
 
@@ -4878,6 +5085,16 @@ class Canvas extends NativeFieldWrapperClass1 {
   void drawOval(Rect rect, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null);
+    if (_canBatchPaint(paint)) {
+      final int index = _addPaintCommand(_kDrawOvalCommand, 4, paint);
+      final Float32List floats = _commandFloats!;
+      floats[index] = rect.left;
+      floats[index + 1] = rect.top;
+      floats[index + 2] = rect.right;
+      floats[index + 3] = rect.bottom;
+      return;
+    }
+    _flushCommands();
     _drawOval(rect.left, rect.top, rect.right, rect.bottom, paint._objects, paint._data);
   }
 
@@ -4891,6 +5108,15 @@ class Canvas extends NativeFieldWrapperClass1 {
   void drawCircle(Offset c, double radius, Paint paint) {
     assert(_offsetIsValid(c));
     assert(paint != null);
+    if (_canBatchPaint(paint)) {
+      final int index = _addPaintCommand(_kDrawCircleCommand, 3, paint);
+      final Float32List floats = _commandFloats!;
+      floats[index] = c.dx;
+      floats[index + 1] = c.dy;
+      floats[index + 2] = radius;
+      return;
+    }
+    _flushCommands();
     _drawCircle(c.dx, c.dy, radius, paint._objects, paint._data);
   }
 
@@ -4911,6 +5137,7 @@ class Canvas extends NativeFieldWrapperClass1 {
   void drawArc(Rect rect, double startAngle, double sweepAngle, bool useCenter, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null);
+    _flushCommands();
     _drawArc(rect.left, rect.top, rect.right, rect.bottom, startAngle, sweepAngle, useCenter, paint._objects, paint._data);
   }
 
@@ -4934,6 +5161,7 @@ class Canvas extends NativeFieldWrapperClass1 {
   void drawPath(Path path, Paint paint) {
     assert(path != null); // path is checked on the engine side
     assert(paint != null);
+    _flushCommands();
     _drawPath(path, paint._objects, paint._data);
   }
 
@@ -4946,6 +5174,7 @@ class Canvas extends NativeFieldWrapperClass1 {
     assert(image != null); // image is checked on the engine side
     assert(_offsetIsValid(offset));
     assert(paint != null);
+    _flushCommands();
     final String? error = _drawImage(image._image, offset.dx, offset.dy, paint._objects, paint._data, paint.filterQuality.index);
     if (error != null) {
       throw PictureRasterizationException._(error, stack: image._debugStack);
@@ -4969,6 +5198,7 @@ class Canvas extends NativeFieldWrapperClass1 {
     assert(_rectIsValid(src));
     assert(_rectIsValid(dst));
     assert(paint != null);
+    _flushCommands();
     final String? error = _drawImageRect(image._image,
                                          src.left,
                                          src.top,
@@ -5019,6 +5249,7 @@ class Canvas extends NativeFieldWrapperClass1 {
     assert(_rectIsValid(center));
     assert(_rectIsValid(dst));
     assert(paint != null);
+    _flushCommands();
     final String? error = _drawImageNine(image._image,
                                          center.left,
                                          center.top,
@@ -5055,6 +5286,7 @@ class Canvas extends NativeFieldWrapperClass1 {
   /// [PictureRecorder].
   void drawPicture(Picture picture) {
     assert(picture != null); // picture is checked on the engine side
+    _flushCommands();
     _drawPicture(picture);
   }
 
@@ -5085,6 +5317,7 @@ class Canvas extends NativeFieldWrapperClass1 {
     assert(paragraph != null);
     assert(_offsetIsValid(offset));
     assert(!paragraph._needsLayout);
+    _flushCommands();
     paragraph._paint(this, offset.dx, offset.dy);
   }
 
@@ -5100,6 +5333,7 @@ class Canvas extends NativeFieldWrapperClass1 {
     assert(pointMode != null);
     assert(points != null);
     assert(paint != null);
+    _flushCommands();
     _drawPoints(paint._objects, paint._data, pointMode.index, _encodePointList(points));
   }
 
@@ -5118,6 +5352,7 @@ class Canvas extends NativeFieldWrapperClass1 {
     assert(paint != null);
     if (points.length % 2 != 0)
       throw ArgumentError('"points" must have an even number of values.');
+    _flushCommands();
     _drawPoints(paint._objects, paint._data, pointMode.index, points);
   }
 
@@ -5149,6 +5384,7 @@ class Canvas extends NativeFieldWrapperClass1 {
     assert(vertices != null); // vertices is checked on the engine side
     assert(paint != null);
     assert(blendMode != null);
+    _flushCommands();
     _drawVertices(vertices, blendMode.index, paint._objects, paint._data);
   }
 
@@ -5326,6 +5562,7 @@ class Canvas extends NativeFieldWrapperClass1 {
     final Float32List? cullRectBuffer = cullRect?._getValue32();
     final int qualityIndex = paint.filterQuality.index;
 
+    _flushCommands();
     final String? error = _drawAtlas(
       paint._objects, paint._data, qualityIndex, atlas._image, rstTransformBuffer, rectBuffer,
       colorBuffer, (blendMode ?? BlendMode.src).index, cullRectBuffer
@@ -5499,6 +5736,7 @@ class Canvas extends NativeFieldWrapperClass1 {
       throw ArgumentError('If non-null, "colors" length must be one fourth the length of "rstTransforms" and "rects".');
     final int qualityIndex = paint.filterQuality.index;
 
+    _flushCommands();
     final String? error = _drawAtlas(
       paint._objects, paint._data, qualityIndex, atlas._image, rstTransforms, rects,
       colors, (blendMode ?? BlendMode.src).index, cullRect?._getValue32()
@@ -5531,6 +5769,7 @@ class Canvas extends NativeFieldWrapperClass1 {
     assert(path != null); // path is checked on the engine side
     assert(color != null);
     assert(transparentOccluder != null);
+    _flushCommands();
     _drawShadow(path, color.value, elevation, transparentOccluder);
   }
 
@@ -5678,6 +5917,7 @@ class PictureRecorder extends NativeFieldWrapperClass1 {
     if (_canvas == null)
       throw StateError('PictureRecorder did not start recording.');
     final Picture picture = Picture._();
+    _canvas!._flushCommands();
     _endRecording(picture);
     _canvas!._recorder = null;
     _canvas = null;
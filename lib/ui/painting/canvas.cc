@@ -11,6 +11,7 @@
 #include "flutter/display_list/display_list_builder.h"
 #include "flutter/display_list/display_list_canvas_dispatcher.h"
 #include "flutter/flow/layers/physical_shape_layer.h"
+#include "flutter/lib/ui/painting/canvas_commands.h"
 #include "flutter/lib/ui/painting/image.h"
 #include "flutter/lib/ui/painting/matrix.h"
 #include "flutter/lib/ui/painting/paint.h"
@@ -617,6 +618,19 @@ void Canvas::drawShadow(const CanvasPath* path,
   }
 }
 
+void Canvas::executeCommands(const tonic::Uint32List& commands, int length) {
+  if (length < 0 || static_cast<size_t>(length) > commands.num_elements()) {
+    Dart_ThrowException(
+        ToDart("Canvas command buffer is shorter than its length."));
+    return;
+  }
+  if (display_list_recorder_) {
+    if (!DispatchCanvasCommands(commands.data(), length, builder())) {
+      Dart_ThrowException(ToDart("Malformed canvas command buffer."));
+    }
+  }
+}
+
 void Canvas::Invalidate() {
   canvas_ = nullptr;
   display_list_recorder_ = nullptr;
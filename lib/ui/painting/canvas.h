@@ -186,6 +186,11 @@ class Canvas : public RefCountedDartWrappable<Canvas>, DisplayListOpFlags {
                   double elevation,
                   bool transparentOccluder);
 
+  // Replays the first |length| words of a buffer of commands that the Dart
+  // canvas batched instead of calling the methods above one at a time. See
+  // canvas_commands.h for the encoding.
+  void executeCommands(const tonic::Uint32List& commands, int length);
+
   SkCanvas* canvas() const { return canvas_; }
   void Invalidate();
 
@@ -0,0 +1,191 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/canvas_commands.h"
+
+#include <cstring>
+
+#include "flutter/display_list/display_list_flags.h"
+#include "flutter/fml/logging.h"
+#include "flutter/lib/ui/painting/paint.h"
+
+namespace flutter {
+
+namespace {
+
+// Reads the arguments of one command at a time from a command buffer.
+class CommandReader {
+ public:
+  CommandReader(const uint32_t* words, size_t count)
+      : words_(words), end_(words + count) {}
+
+  bool HasMore() const { return words_ < end_; }
+
+  // Whether the next |count| words are part of the buffer.
+  bool Has(size_t count) const {
+    return static_cast<size_t>(end_ - words_) >= count;
+  }
+
+  uint32_t ReadWord() { return *words_++; }
+
+  float ReadFloat() {
+    float value;
+    memcpy(&value, words_++, sizeof(value));
+    return value;
+  }
+
+  SkRect ReadRect() {
+    const float left = ReadFloat();
+    const float top = ReadFloat();
+    const float right = ReadFloat();
+    const float bottom = ReadFloat();
+    return SkRect::MakeLTRB(left, top, right, bottom);
+  }
+
+  void ReadPaint(DisplayListBuilder* builder,
+                 const DisplayListAttributeFlags& flags) {
+    Paint::SyncDataTo(words_, builder, flags);
+    words_ += Paint::kDataWordCount;
+  }
+
+ private:
+  const uint32_t* words_;
+  const uint32_t* const end_;
+};
+
+// The number of words that follow each command, indexed by command.
+constexpr size_t kArgumentWordCounts[] = {
+    0,                            // kSave
+    0,                            // kRestore
+    2,                            // kTranslate
+    2,                            // kScale
+    1,                            // kRotate
+    2,                            // kSkew
+    6,                            // kClipRect
+    2,                            // kDrawColor
+    Paint::kDataWordCount,        // kDrawPaint
+    4 + Paint::kDataWordCount,    // kDrawLine
+    4 + Paint::kDataWordCount,    // kDrawRect
+    12 + Paint::kDataWordCount,   // kDrawRRect
+    4 + Paint::kDataWordCount,    // kDrawOval
+    3 + Paint::kDataWordCount,    // kDrawCircle
+};
+constexpr size_t kCommandCount =
+    sizeof(kArgumentWordCounts) / sizeof(kArgumentWordCounts[0]);
+static_assert(static_cast<size_t>(CanvasCommand::kDrawCircle) + 1 ==
+              kCommandCount);
+
+using Flags = DisplayListOpFlags;
+
+}  // namespace
+
+bool DispatchCanvasCommands(const uint32_t* words,
+                            size_t count,
+                            DisplayListBuilder* builder) {
+  CommandReader reader(words, count);
+  while (reader.HasMore()) {
+    const uint32_t command = reader.ReadWord();
+    if (command >= kCommandCount) {
+      FML_LOG(ERROR) << "Unknown canvas command " << command << ".";
+      return false;
+    }
+    if (!reader.Has(kArgumentWordCounts[command])) {
+      FML_LOG(ERROR) << "Truncated canvas command " << command << ".";
+      return false;
+    }
+
+    switch (static_cast<CanvasCommand>(command)) {
+      case CanvasCommand::kSave:
+        builder->save();
+        break;
+      case CanvasCommand::kRestore:
+        builder->restore();
+        break;
+      case CanvasCommand::kTranslate: {
+        const float dx = reader.ReadFloat();
+        const float dy = reader.ReadFloat();
+        builder->translate(dx, dy);
+        break;
+      }
+      case CanvasCommand::kScale: {
+        const float sx = reader.ReadFloat();
+        const float sy = reader.ReadFloat();
+        builder->scale(sx, sy);
+        break;
+      }
+      case CanvasCommand::kRotate:
+        builder->rotate(reader.ReadFloat());
+        break;
+      case CanvasCommand::kSkew: {
+        const float sx = reader.ReadFloat();
+        const float sy = reader.ReadFloat();
+        builder->skew(sx, sy);
+        break;
+      }
+      case CanvasCommand::kClipRect: {
+        const SkRect rect = reader.ReadRect();
+        const auto clip_op = static_cast<SkClipOp>(reader.ReadWord());
+        const bool anti_alias = reader.ReadWord() != 0;
+        builder->clipRect(rect, clip_op, anti_alias);
+        break;
+      }
+      case CanvasCommand::kDrawColor: {
+        const SkColor color = reader.ReadWord();
+        const auto blend_mode = static_cast<DlBlendMode>(reader.ReadWord());
+        builder->drawColor(color, blend_mode);
+        break;
+      }
+      case CanvasCommand::kDrawPaint:
+        reader.ReadPaint(builder, Flags::kDrawPaintFlags);
+        builder->drawPaint();
+        break;
+      case CanvasCommand::kDrawLine: {
+        const float x1 = reader.ReadFloat();
+        const float y1 = reader.ReadFloat();
+        const float x2 = reader.ReadFloat();
+        const float y2 = reader.ReadFloat();
+        reader.ReadPaint(builder, Flags::kDrawLineFlags);
+        builder->drawLine(SkPoint::Make(x1, y1), SkPoint::Make(x2, y2));
+        break;
+      }
+      case CanvasCommand::kDrawRect: {
+        const SkRect rect = reader.ReadRect();
+        reader.ReadPaint(builder, Flags::kDrawRectFlags);
+        builder->drawRect(rect);
+        break;
+      }
+      case CanvasCommand::kDrawRRect: {
+        const SkRect rect = reader.ReadRect();
+        SkVector radii[4];
+        for (SkVector& radius : radii) {
+          const float x = reader.ReadFloat();
+          const float y = reader.ReadFloat();
+          radius.set(x, y);
+        }
+        SkRRect rrect;
+        rrect.setRectRadii(rect, radii);
+        reader.ReadPaint(builder, Flags::kDrawRRectFlags);
+        builder->drawRRect(rrect);
+        break;
+      }
+      case CanvasCommand::kDrawOval: {
+        const SkRect rect = reader.ReadRect();
+        reader.ReadPaint(builder, Flags::kDrawOvalFlags);
+        builder->drawOval(rect);
+        break;
+      }
+      case CanvasCommand::kDrawCircle: {
+        const float x = reader.ReadFloat();
+        const float y = reader.ReadFloat();
+        const float radius = reader.ReadFloat();
+        reader.ReadPaint(builder, Flags::kDrawCircleFlags);
+        builder->drawCircle(SkPoint::Make(x, y), radius);
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace flutter
@@ -0,0 +1,58 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_CANVAS_COMMANDS_H_
+#define FLUTTER_LIB_UI_PAINTING_CANVAS_COMMANDS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "flutter/display_list/display_list_builder.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// The commands that a `Canvas` in dart:ui batches into a command buffer
+/// instead of making a native call for each of them.
+///
+/// A command buffer is a list of 32-bit words. Each command is a word with
+/// its value below, followed by its arguments: coordinates as floats, enums
+/// and colors as integers, and, for commands that draw with a paint, the
+/// `Paint::kDataWordCount` words of the encoded data of a paint without
+/// shader or filter objects.
+///
+/// Must be kept in sync with `_CanvasCommand` in painting.dart.
+///
+enum class CanvasCommand : uint32_t {
+  kSave,        // ()
+  kRestore,     // ()
+  kTranslate,   // (dx, dy)
+  kScale,       // (sx, sy)
+  kRotate,      // (degrees)
+  kSkew,        // (sx, sy)
+  kClipRect,    // (left, top, right, bottom, clip op, anti-alias)
+  kDrawColor,   // (color, blend mode)
+  kDrawPaint,   // (paint)
+  kDrawLine,    // (x1, y1, x2, y2, paint)
+  kDrawRect,    // (left, top, right, bottom, paint)
+  kDrawRRect,   // (left, top, right, bottom, 8 radii, paint)
+  kDrawOval,    // (left, top, right, bottom, paint)
+  kDrawCircle,  // (x, y, radius, paint)
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Replays the |count| words of batched canvas commands at |words|
+///             onto |builder|.
+///
+/// @return     Whether all commands could be decoded. Decoding stops at the
+///             first command that is unknown or truncated, after the commands
+///             before it were replayed.
+///
+bool DispatchCanvasCommands(const uint32_t* words,
+                            size_t count,
+                            DisplayListBuilder* builder);
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_CANVAS_COMMANDS_H_
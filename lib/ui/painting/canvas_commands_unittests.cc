@@ -0,0 +1,175 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/canvas_commands.h"
+
+#include <cstring>
+#include <vector>
+
+#include "flutter/lib/ui/painting/paint.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Encodes commands the way the Canvas in painting.dart does.
+class CommandWriter {
+ public:
+  CommandWriter& Command(CanvasCommand command) {
+    words_.push_back(static_cast<uint32_t>(command));
+    return *this;
+  }
+
+  CommandWriter& Word(uint32_t word) {
+    words_.push_back(word);
+    return *this;
+  }
+
+  CommandWriter& Float(float value) {
+    uint32_t word;
+    memcpy(&word, &value, sizeof(word));
+    return Word(word);
+  }
+
+  CommandWriter& Rect(const SkRect& rect) {
+    return Float(rect.left())
+        .Float(rect.top())
+        .Float(rect.right())
+        .Float(rect.bottom());
+  }
+
+  // The encoded data of an anti-aliased paint with |color| that strokes with
+  // |stroke_width|, or fills if it is zero.
+  CommandWriter& PaintData(uint32_t color, float stroke_width) {
+    uint32_t data[Paint::kDataWordCount] = {};
+    data[1] = color ^ 0xFF000000;
+    if (stroke_width > 0) {
+      data[3] = static_cast<uint32_t>(DlDrawStyle::kStroke);
+      memcpy(&data[4], &stroke_width, sizeof(stroke_width));
+    }
+    words_.insert(words_.end(), data, data + Paint::kDataWordCount);
+    return *this;
+  }
+
+  const std::vector<uint32_t>& words() const { return words_; }
+
+ private:
+  std::vector<uint32_t> words_;
+};
+
+DlPaint MakePaint(uint32_t color, float stroke_width) {
+  DlPaint paint;
+  paint.setAntiAlias(true);
+  paint.setColor(color);
+  if (stroke_width > 0) {
+    paint.setDrawStyle(DlDrawStyle::kStroke);
+    paint.setStrokeWidth(stroke_width);
+  }
+  return paint;
+}
+
+}  // namespace
+
+TEST(CanvasCommandsTest, ReplaysCommandsLikeDirectCalls) {
+  const SkRect rect = SkRect::MakeLTRB(10, 20, 110, 70);
+  const SkVector radii[4] = {{1, 2}, {3, 4}, {5, 6}, {7, 8}};
+  SkRRect rrect;
+  rrect.setRectRadii(rect, radii);
+
+  CommandWriter writer;
+  writer.Command(CanvasCommand::kSave)
+      .Command(CanvasCommand::kTranslate)
+      .Float(5)
+      .Float(6)
+      .Command(CanvasCommand::kScale)
+      .Float(2)
+      .Float(3)
+      .Command(CanvasCommand::kRotate)
+      .Float(45)
+      .Command(CanvasCommand::kSkew)
+      .Float(0.5)
+      .Float(0.25)
+      .Command(CanvasCommand::kClipRect)
+      .Rect(rect)
+      .Word(static_cast<uint32_t>(SkClipOp::kDifference))
+      .Word(1)
+      .Command(CanvasCommand::kDrawColor)
+      .Word(0xFF00FF00)
+      .Word(static_cast<uint32_t>(DlBlendMode::kMultiply))
+      .Command(CanvasCommand::kDrawPaint)
+      .PaintData(0xFF0000FF, 0)
+      .Command(CanvasCommand::kDrawLine)
+      .Float(1)
+      .Float(2)
+      .Float(3)
+      .Float(4)
+      .PaintData(0xFFFF0000, 3)
+      .Command(CanvasCommand::kDrawRect)
+      .Rect(rect)
+      .PaintData(0x80FF0000, 0)
+      .Command(CanvasCommand::kDrawRRect)
+      .Rect(rect);
+  for (const SkVector& radius : radii) {
+    writer.Float(radius.x()).Float(radius.y());
+  }
+  writer.PaintData(0xFF00FF00, 2)
+      .Command(CanvasCommand::kDrawOval)
+      .Rect(rect)
+      .PaintData(0xFF0000FF, 0)
+      .Command(CanvasCommand::kDrawCircle)
+      .Float(50)
+      .Float(60)
+      .Float(20)
+      .PaintData(0xFF0000FF, 4)
+      .Command(CanvasCommand::kRestore);
+
+  DisplayListBuilder batched;
+  ASSERT_TRUE(DispatchCanvasCommands(writer.words().data(),
+                                     writer.words().size(), &batched));
+
+  DisplayListBuilder direct;
+  direct.save();
+  direct.translate(5, 6);
+  direct.scale(2, 3);
+  direct.rotate(45);
+  direct.skew(0.5, 0.25);
+  direct.clipRect(rect, SkClipOp::kDifference, true);
+  direct.drawColor(0xFF00FF00, DlBlendMode::kMultiply);
+  direct.drawPaint(MakePaint(0xFF0000FF, 0));
+  direct.drawLine({1, 2}, {3, 4}, MakePaint(0xFFFF0000, 3));
+  direct.drawRect(rect, MakePaint(0x80FF0000, 0));
+  direct.drawRRect(rrect, MakePaint(0xFF00FF00, 2));
+  direct.drawOval(rect, MakePaint(0xFF0000FF, 0));
+  direct.drawCircle({50, 60}, 20, MakePaint(0xFF0000FF, 4));
+  direct.restore();
+
+  EXPECT_TRUE(batched.Build()->Equals(direct.Build()));
+}
+
+TEST(CanvasCommandsTest, StopsAtMalformedCommands) {
+  // A rectangle without its paint.
+  CommandWriter truncated;
+  truncated.Command(CanvasCommand::kSave)
+      .Command(CanvasCommand::kDrawRect)
+      .Rect(SkRect::MakeWH(10, 10));
+  DisplayListBuilder truncated_builder;
+  EXPECT_FALSE(DispatchCanvasCommands(truncated.words().data(),
+                                      truncated.words().size(),
+                                      &truncated_builder));
+  // The commands before the malformed one were replayed.
+  EXPECT_EQ(truncated_builder.getSaveCount(), 2);
+
+  CommandWriter unknown;
+  unknown.Word(0xFFFF);
+  DisplayListBuilder unknown_builder;
+  EXPECT_FALSE(DispatchCanvasCommands(unknown.words().data(),
+                                      unknown.words().size(),
+                                      &unknown_builder));
+  EXPECT_EQ(unknown_builder.Build()->op_count(), 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -45,6 +45,13 @@ class ImageDecoder {
 
   fml::WeakPtr<ImageDecoder> GetWeakPtr() const;
 
+  // The runner that images are decompressed on, which is shared with the
+  // frame decodes of animated images.
+  const std::shared_ptr<fml::ConcurrentTaskRunner>& GetConcurrentTaskRunner()
+      const {
+    return concurrent_task_runner_;
+  }
+
  protected:
   TaskRunners runners_;
   std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
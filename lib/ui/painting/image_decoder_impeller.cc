@@ -20,13 +20,17 @@
 
 namespace flutter {
 
+// The memory of decodes up to this size is kept around for the next decode.
+static constexpr size_t kMaxRetainedStagingBytes = 32 * 1024 * 1024;
+
 ImageDecoderImpeller::ImageDecoderImpeller(
     TaskRunners runners,
     std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
     fml::WeakPtr<IOManager> io_manager)
     : ImageDecoder(std::move(runners),
                    std::move(concurrent_task_runner),
-                   io_manager) {
+                   io_manager),
+      staging_pool_(ImageDecoderStagingPool::Create(kMaxRetainedStagingBytes)) {
   std::promise<std::shared_ptr<impeller::Context>> context_promise;
   context_ = context_promise.get_future();
   runners_.GetIOTaskRunner()->PostTask(fml::MakeCopyable(
@@ -56,18 +60,45 @@ static std::optional<impeller::PixelFormat> ToPixelFormat(SkColorType type) {
   return std::nullopt;
 }
 
+// Allocates a bitmap whose pixels live in a buffer from the |staging_pool|.
+// The buffer returns to the pool once the pixels of the bitmap are released.
+static std::shared_ptr<SkBitmap> AllocateStagingBitmap(
+    const SkImageInfo& image_info,
+    ImageDecoderStagingPool& staging_pool) {
+  const size_t byte_size = image_info.computeMinByteSize();
+  if (SkImageInfo::ByteSizeOverflowed(byte_size)) {
+    return nullptr;
+  }
+  auto buffer = staging_pool.Acquire(byte_size);
+  if (!buffer) {
+    return nullptr;
+  }
+  using BufferRef = std::shared_ptr<ImageDecoderStagingPool::Buffer>;
+  auto bitmap = std::make_shared<SkBitmap>();
+  // The release proc is also invoked if the pixels cannot be installed.
+  if (!bitmap->installPixels(
+          image_info, buffer->GetData(), image_info.minRowBytes(),
+          [](void* pixels, void* context) {
+            delete reinterpret_cast<BufferRef*>(context);
+          },
+          new BufferRef(buffer))) {
+    return nullptr;
+  }
+  return bitmap;
+}
+
 std::shared_ptr<SkBitmap> ImageDecoderImpeller::DecompressTexture(
     ImageDescriptor* descriptor,
-    SkISize target_size) {
+    SkISize target_size,
+    const std::shared_ptr<ImageDecoderStagingPool>& staging_pool) {
   TRACE_EVENT0("impeller", __FUNCTION__);
   if (!descriptor) {
     FML_DLOG(ERROR) << "Invalid descriptor.";
     return nullptr;
   }
 
-  if (!descriptor->is_compressed()) {
-    FML_DLOG(ERROR)
-        << "Uncompressed images are not implemented in Impeller yet.";
+  if (!staging_pool) {
+    FML_DLOG(ERROR) << "Invalid staging pool.";
     return nullptr;
   }
 
@@ -76,10 +107,6 @@ std::shared_ptr<SkBitmap> ImageDecoderImpeller::DecompressTexture(
       static_cast<double>(target_size.width()) / source_size.width(),
       static_cast<double>(target_size.height()) / source_size.height()));
 
-  //----------------------------------------------------------------------------
-  /// 1. Decode the image into the image generator's closest supported size.
-  ///
-
   const auto base_image_info = descriptor->image_info();
   const auto image_info =
       base_image_info.makeWH(decode_size.width(), decode_size.height())
@@ -93,43 +120,71 @@ std::shared_ptr<SkBitmap> ImageDecoderImpeller::DecompressTexture(
     return nullptr;
   }
 
-  auto bitmap = std::make_shared<SkBitmap>();
-  if (!bitmap->tryAllocPixels(image_info)) {
-    FML_DLOG(ERROR)
-        << "Could not allocate intermediate for image decompression.";
-    return nullptr;
-  }
-
-  if (!descriptor->get_pixels(bitmap->pixmap())) {
-    FML_DLOG(ERROR) << "Could not decompress image.";
-    return nullptr;
-  }
+  //----------------------------------------------------------------------------
+  /// 1. Find the source pixels. Compressed images are decoded into the image
+  ///    generator's closest supported size, straight into the staging buffer
+  ///    that is returned if that is the requested target size. Uncompressed
+  ///    images are read in place.
+  ///
 
-  if (decode_size == target_size) {
-    return bitmap;
+  std::shared_ptr<SkBitmap> decoded;
+  SkPixmap source;
+  if (descriptor->is_compressed()) {
+    decoded = AllocateStagingBitmap(image_info, *staging_pool);
+    if (!decoded) {
+      FML_DLOG(ERROR)
+          << "Could not allocate intermediate for image decompression.";
+      return nullptr;
+    }
+
+    if (!descriptor->get_pixels(decoded->pixmap())) {
+      FML_DLOG(ERROR) << "Could not decompress image.";
+      return nullptr;
+    }
+
+    if (decode_size == target_size) {
+      decoded->setImmutable();
+      return decoded;
+    }
+    source = decoded->pixmap();
+  } else {
+    const auto data = descriptor->data();
+    const size_t row_bytes = descriptor->row_bytes();
+    if (!data || data->size() < base_image_info.computeByteSize(row_bytes)) {
+      FML_DLOG(ERROR) << "Uncompressed image data is too small.";
+      return nullptr;
+    }
+    source = SkPixmap(base_image_info, data->data(), row_bytes);
   }
 
   //----------------------------------------------------------------------------
-  /// 2. If the decoded image isn't the requested target size, resize it.
+  /// 2. Scale the source pixels to the target size, converting them to the
+  ///    pixel format of the texture, into a staging buffer.
   ///
 
   TRACE_EVENT0("impeller", "DecodeScale");
-  const auto scaled_image_info = image_info.makeDimensions(target_size);
-
-  auto scaled_bitmap = std::make_shared<SkBitmap>();
-  if (!scaled_bitmap->tryAllocPixels(scaled_image_info)) {
+  auto target = AllocateStagingBitmap(image_info.makeDimensions(target_size),
+                                      *staging_pool);
+  if (!target) {
     FML_LOG(ERROR)
         << "Could not allocate scaled bitmap for image decompression.";
     return nullptr;
   }
-  if (!bitmap->pixmap().scalePixels(
-          scaled_bitmap->pixmap(),
-          SkSamplingOptions(SkFilterMode::kLinear, SkMipmapMode::kNone))) {
+  if (source.dimensions() == target_size) {
+    if (!source.readPixels(target->pixmap())) {
+      FML_LOG(ERROR) << "Could not convert decoded bitmap data.";
+      return nullptr;
+    }
+  } else if (!source.scalePixels(
+                 target->pixmap(),
+                 SkSamplingOptions(SkFilterMode::kLinear,
+                                   SkMipmapMode::kNone))) {
     FML_LOG(ERROR) << "Could not scale decoded bitmap data.";
+    return nullptr;
   }
-  scaled_bitmap->setImmutable();
+  target->setImmutable();
 
-  return scaled_bitmap;
+  return target;
 }
 
 static sk_sp<DlImage> UploadTexture(std::shared_ptr<impeller::Context> context,
@@ -198,10 +253,12 @@ void ImageDecoderImpeller::Decode(fml::RefPtr<ImageDescriptor> descriptor,
        context = context_.get(),                                  //
        target_size = SkISize::Make(target_width, target_height),  //
        io_runner = runners_.GetIOTaskRunner(),                    //
+       staging_pool = staging_pool_,                              //
        result                                                     //
   ]() {
         // Always decompress on the concurrent runner.
-        auto bitmap = DecompressTexture(raw_descriptor, target_size);
+        auto bitmap =
+            DecompressTexture(raw_descriptor, target_size, staging_pool);
         if (!bitmap) {
           result(nullptr);
           return;
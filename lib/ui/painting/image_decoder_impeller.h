@@ -9,6 +9,7 @@
 
 #include "flutter/fml/macros.h"
 #include "flutter/lib/ui/painting/image_decoder.h"
+#include "flutter/lib/ui/painting/image_decoder_staging_pool.h"
 
 namespace impeller {
 class Context;
@@ -31,13 +32,25 @@ class ImageDecoderImpeller final : public ImageDecoder {
               uint32_t target_height,
               const ImageResult& result) override;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Decodes (or for uncompressed descriptors, converts) the image
+  ///             and scales it to |target_size|. The pixels of the returned
+  ///             bitmap live in a buffer from |staging_pool| that returns to
+  ///             the pool once the bitmap is released.
+  ///
+  ///             If the decoder can produce the target size directly, the
+  ///             image is decoded straight into the returned buffer without
+  ///             an intermediate allocation.
+  ///
   static std::shared_ptr<SkBitmap> DecompressTexture(
       ImageDescriptor* descriptor,
-      SkISize target_size);
+      SkISize target_size,
+      const std::shared_ptr<ImageDecoderStagingPool>& staging_pool);
 
  private:
   using FutureContext = std::shared_future<std::shared_ptr<impeller::Context>>;
   FutureContext context_;
+  std::shared_ptr<ImageDecoderStagingPool> staging_pool_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoderImpeller);
 };
@@ -0,0 +1,103 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_decoder_staging_pool.h"
+
+#include <algorithm>
+#include <new>
+
+namespace flutter {
+
+ImageDecoderStagingPool::Buffer::Buffer(size_t capacity)
+    : data_(new (std::nothrow) uint8_t[capacity]),
+      capacity_(capacity),
+      size_(capacity) {}
+
+std::shared_ptr<ImageDecoderStagingPool> ImageDecoderStagingPool::Create(
+    size_t max_retained_bytes) {
+  return std::shared_ptr<ImageDecoderStagingPool>(
+      new ImageDecoderStagingPool(max_retained_bytes));
+}
+
+ImageDecoderStagingPool::ImageDecoderStagingPool(size_t max_retained_bytes)
+    : max_retained_bytes_(max_retained_bytes) {}
+
+ImageDecoderStagingPool::~ImageDecoderStagingPool() = default;
+
+std::shared_ptr<ImageDecoderStagingPool::Buffer>
+ImageDecoderStagingPool::Acquire(size_t size) {
+  std::unique_ptr<Buffer> buffer;
+  {
+    std::scoped_lock lock(mutex_);
+    auto best = retained_.end();
+    for (auto it = retained_.begin(); it != retained_.end(); ++it) {
+      if ((*it)->capacity_ >= size &&
+          (best == retained_.end() || (*it)->capacity_ < (*best)->capacity_)) {
+        best = it;
+      }
+    }
+    if (best != retained_.end()) {
+      buffer = std::move(*best);
+      retained_.erase(best);
+      retained_bytes_ -= buffer->capacity_;
+    }
+  }
+
+  if (!buffer) {
+    buffer.reset(new Buffer(size));
+    if (!buffer->data_) {
+      return nullptr;
+    }
+    std::scoped_lock lock(mutex_);
+    allocated_bytes_ += size;
+    peak_allocated_bytes_ = std::max(peak_allocated_bytes_, allocated_bytes_);
+  }
+  buffer->size_ = size;
+
+  return std::shared_ptr<Buffer>(
+      buffer.release(),
+      [weak_pool = weak_from_this()](Buffer* released) {
+        std::unique_ptr<Buffer> owned(released);
+        if (auto pool = weak_pool.lock()) {
+          pool->Release(std::move(owned));
+        }
+      });
+}
+
+void ImageDecoderStagingPool::Release(std::unique_ptr<Buffer> buffer) {
+  std::scoped_lock lock(mutex_);
+  if (retained_bytes_ + buffer->capacity_ > max_retained_bytes_) {
+    allocated_bytes_ -= buffer->capacity_;
+    return;
+  }
+  retained_bytes_ += buffer->capacity_;
+  retained_.push_back(std::move(buffer));
+}
+
+void ImageDecoderStagingPool::Purge() {
+  std::vector<std::unique_ptr<Buffer>> purged;
+  {
+    std::scoped_lock lock(mutex_);
+    purged.swap(retained_);
+    allocated_bytes_ -= retained_bytes_;
+    retained_bytes_ = 0;
+  }
+}
+
+size_t ImageDecoderStagingPool::GetRetainedBytes() const {
+  std::scoped_lock lock(mutex_);
+  return retained_bytes_;
+}
+
+size_t ImageDecoderStagingPool::GetAllocatedBytes() const {
+  std::scoped_lock lock(mutex_);
+  return allocated_bytes_;
+}
+
+size_t ImageDecoderStagingPool::GetPeakAllocatedBytes() const {
+  std::scoped_lock lock(mutex_);
+  return peak_allocated_bytes_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,98 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_STAGING_POOL_H_
+#define FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_STAGING_POOL_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A thread-safe pool of host memory that image decoders decode
+///             and scale into before the pixels are uploaded to a texture.
+///
+///             Buffers return to the pool when the last reference to them is
+///             released, so the memory of a decode is reused by the next one
+///             instead of being freed and allocated again. Up to
+///             `max_retained_bytes` of unused buffers are kept, anything
+///             beyond that is freed immediately.
+///
+class ImageDecoderStagingPool final
+    : public std::enable_shared_from_this<ImageDecoderStagingPool> {
+ public:
+  class Buffer {
+   public:
+    uint8_t* GetData() const { return data_.get(); }
+
+    size_t GetSize() const { return size_; }
+
+    size_t GetCapacity() const { return capacity_; }
+
+   private:
+    friend class ImageDecoderStagingPool;
+
+    std::unique_ptr<uint8_t[]> data_;
+    size_t capacity_;
+    size_t size_;
+
+    explicit Buffer(size_t capacity);
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Buffer);
+  };
+
+  static std::shared_ptr<ImageDecoderStagingPool> Create(
+      size_t max_retained_bytes);
+
+  ~ImageDecoderStagingPool();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns a buffer of at least |size| bytes. The smallest
+  ///             retained buffer that is large enough is reused, otherwise a
+  ///             new buffer is allocated.
+  ///
+  /// @return     The buffer, or nullptr if the allocation failed. The buffer
+  ///             may outlive the pool, in which case it is freed when
+  ///             released.
+  ///
+  std::shared_ptr<Buffer> Acquire(size_t size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Frees all of the retained buffers.
+  ///
+  void Purge();
+
+  /// The bytes of the buffers that are retained for reuse.
+  size_t GetRetainedBytes() const;
+
+  /// The bytes of all buffers allocated by the pool that have not been freed,
+  /// both the retained buffers and the ones in use.
+  size_t GetAllocatedBytes() const;
+
+  /// The largest value that `GetAllocatedBytes` has reached.
+  size_t GetPeakAllocatedBytes() const;
+
+ private:
+  const size_t max_retained_bytes_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Buffer>> retained_;
+  size_t retained_bytes_ = 0;
+  size_t allocated_bytes_ = 0;
+  size_t peak_allocated_bytes_ = 0;
+
+  explicit ImageDecoderStagingPool(size_t max_retained_bytes);
+
+  void Release(std::unique_ptr<Buffer> buffer);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoderStagingPool);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_STAGING_POOL_H_
@@ -5,10 +5,13 @@
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/lib/ui/painting/image_decoder.h"
 #include "flutter/lib/ui/painting/image_decoder_impeller.h"
 #include "flutter/lib/ui/painting/image_decoder_skia.h"
+#include "flutter/lib/ui/painting/image_decoder_staging_pool.h"
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
+#include "flutter/lib/ui/painting/multi_frame_decoder.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
 #include "flutter/testing/dart_isolate_runner.h"
@@ -569,6 +572,120 @@ TEST(ImageDecoderTest,
   ASSERT_EQ(webp_generator->GetPlayCount(), static_cast<unsigned int>(2));
 }
 
+static std::shared_ptr<ImageGenerator> CreateAnimatedGenerator(
+    const char* fixture_name) {
+  auto mapping = OpenFixtureAsSkData(fixture_name);
+  if (!mapping) {
+    return nullptr;
+  }
+  ImageGeneratorRegistry registry;
+  return registry.CreateCompatibleGenerator(mapping);
+}
+
+TEST(ImageDecoderTest, MultiFrameDecoderDecodesFramesAhead) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  for (auto fixture_name : {"hello_loop_2.gif", "hello_loop_2.webp"}) {
+    auto generator = CreateAnimatedGenerator(fixture_name);
+    ASSERT_TRUE(generator);
+    // A budget of zero bytes never retains the loop, so every frame goes
+    // through the decode ahead queue.
+    auto decoder = MultiFrameDecoder::Create(
+        generator, loop->GetTaskRunner(),
+        MultiFrameDecoder::kDefaultDecodeAheadCount, 0);
+    const int frame_count = decoder->GetFrameCount();
+    ASSERT_GT(frame_count, 1);
+
+    // Nothing has been decoded ahead of the first request.
+    auto frame = decoder->GetNextFrame();
+    ASSERT_TRUE(frame.bitmap);
+    EXPECT_EQ(frame.index, 0);
+    EXPECT_EQ(decoder->GetStats().dropped_frames, 1u);
+
+    for (int i = 1; i < frame_count * 2; i++) {
+      decoder->WaitForDecodeAhead();
+      frame = decoder->GetNextFrame();
+      ASSERT_TRUE(frame.bitmap);
+      EXPECT_EQ(frame.index, i % frame_count);
+    }
+
+    auto stats = decoder->GetStats();
+    EXPECT_EQ(stats.requested_frames, static_cast<size_t>(frame_count * 2));
+    EXPECT_EQ(stats.dropped_frames, 1u);
+    EXPECT_GE(stats.decoded_frames, stats.requested_frames);
+    EXPECT_GT(stats.max_decode_latency, fml::TimeDelta::Zero());
+    EXPECT_GE(stats.total_decode_latency, stats.max_decode_latency);
+    EXPECT_FALSE(decoder->IsLoopRetained());
+  }
+}
+
+TEST(ImageDecoderTest, MultiFrameDecoderCountsDroppedFrames) {
+  for (auto fixture_name : {"hello_loop_2.gif", "hello_loop_2.webp"}) {
+    auto generator = CreateAnimatedGenerator(fixture_name);
+    ASSERT_TRUE(generator);
+    // Without a decode runner every frame is decoded when it is requested.
+    auto decoder = MultiFrameDecoder::Create(
+        generator, nullptr, MultiFrameDecoder::kDefaultDecodeAheadCount, 0);
+    const int frame_count = decoder->GetFrameCount();
+    for (int i = 0; i < frame_count; i++) {
+      ASSERT_TRUE(decoder->GetNextFrame().bitmap);
+    }
+
+    auto stats = decoder->GetStats();
+    EXPECT_EQ(stats.requested_frames, static_cast<size_t>(frame_count));
+    EXPECT_EQ(stats.dropped_frames, static_cast<size_t>(frame_count));
+    EXPECT_EQ(stats.decoded_frames, static_cast<size_t>(frame_count));
+  }
+}
+
+TEST(ImageDecoderTest, MultiFrameDecoderRetainsLoopWithinBudget) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  for (auto fixture_name : {"hello_loop_2.gif", "hello_loop_2.webp"}) {
+    auto generator = CreateAnimatedGenerator(fixture_name);
+    ASSERT_TRUE(generator);
+    auto decoder = MultiFrameDecoder::Create(generator, loop->GetTaskRunner());
+    const int frame_count = decoder->GetFrameCount();
+
+    for (int i = 0; i < frame_count * 3; i++) {
+      ASSERT_TRUE(decoder->GetNextFrame().bitmap);
+      decoder->WaitForDecodeAhead();
+    }
+
+    // Every frame is decoded once, later loops reuse the retained frames.
+    EXPECT_TRUE(decoder->IsLoopRetained());
+    auto stats = decoder->GetStats();
+    EXPECT_EQ(stats.decoded_frames, static_cast<size_t>(frame_count));
+    EXPECT_EQ(stats.dropped_frames, 1u);
+  }
+}
+
+TEST(ImageDecoderTest, MultiFrameDecoderDecodesAheadSamePixels) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  for (auto fixture_name : {"hello_loop_2.gif", "hello_loop_2.webp"}) {
+    auto ahead_generator = CreateAnimatedGenerator(fixture_name);
+    auto sync_generator = CreateAnimatedGenerator(fixture_name);
+    ASSERT_TRUE(ahead_generator);
+    ASSERT_TRUE(sync_generator);
+    auto ahead_decoder =
+        MultiFrameDecoder::Create(ahead_generator, loop->GetTaskRunner());
+    auto sync_decoder = MultiFrameDecoder::Create(sync_generator, nullptr);
+
+    for (int i = 0; i < ahead_decoder->GetFrameCount() * 2; i++) {
+      auto ahead_frame = ahead_decoder->GetNextFrame();
+      auto sync_frame = sync_decoder->GetNextFrame();
+      ASSERT_TRUE(ahead_frame.bitmap);
+      ASSERT_TRUE(sync_frame.bitmap);
+      EXPECT_EQ(ahead_frame.index, sync_frame.index);
+      EXPECT_EQ(ahead_frame.duration, sync_frame.duration);
+      ASSERT_EQ(ahead_frame.bitmap->info(), sync_frame.bitmap->info());
+      ASSERT_EQ(ahead_frame.bitmap->rowBytes(), sync_frame.bitmap->rowBytes());
+      EXPECT_EQ(memcmp(ahead_frame.bitmap->getPixels(),
+                       sync_frame.bitmap->getPixels(),
+                       ahead_frame.bitmap->computeByteSize()),
+                0);
+    }
+  }
+}
+
 TEST(ImageDecoderTest, VerifySimpleDecoding) {
   auto data = OpenFixtureAsSkData("Horizontal.jpg");
   auto image = SkImage::MakeFromEncoded(data);
@@ -589,13 +706,142 @@ TEST(ImageDecoderTest, VerifySimpleDecoding) {
             SkISize::Make(6, 2));
 
 #if IMPELLER_SUPPORTS_RENDERING
-  ASSERT_EQ(ImageDecoderImpeller::DecompressTexture(descriptor.get(),
-                                                    SkISize::Make(6, 2))
+  auto staging_pool = ImageDecoderStagingPool::Create(1024 * 1024);
+  ASSERT_EQ(ImageDecoderImpeller::DecompressTexture(
+                descriptor.get(), SkISize::Make(6, 2), staging_pool)
                 ->dimensions(),
             SkISize::Make(6, 2));
 #endif  // IMPELLER_SUPPORTS_RENDERING
 }
 
+TEST(ImageDecoderTest, StagingPoolRecyclesBuffers) {
+  auto pool = ImageDecoderStagingPool::Create(1024);
+  uint8_t* data = nullptr;
+  {
+    auto buffer = pool->Acquire(100);
+    ASSERT_TRUE(buffer);
+    ASSERT_EQ(buffer->GetSize(), 100u);
+    data = buffer->GetData();
+    ASSERT_EQ(pool->GetAllocatedBytes(), 100u);
+    ASSERT_EQ(pool->GetRetainedBytes(), 0u);
+  }
+  ASSERT_EQ(pool->GetRetainedBytes(), 100u);
+
+  // A smaller request reuses the retained buffer.
+  {
+    auto buffer = pool->Acquire(60);
+    ASSERT_EQ(buffer->GetData(), data);
+    ASSERT_EQ(buffer->GetSize(), 60u);
+    ASSERT_EQ(buffer->GetCapacity(), 100u);
+    ASSERT_EQ(pool->GetRetainedBytes(), 0u);
+
+    // A larger request cannot.
+    auto larger = pool->Acquire(200);
+    ASSERT_NE(larger->GetData(), data);
+    ASSERT_EQ(pool->GetAllocatedBytes(), 300u);
+  }
+  ASSERT_EQ(pool->GetRetainedBytes(), 300u);
+  ASSERT_EQ(pool->GetPeakAllocatedBytes(), 300u);
+
+  pool->Purge();
+  ASSERT_EQ(pool->GetRetainedBytes(), 0u);
+  ASSERT_EQ(pool->GetAllocatedBytes(), 0u);
+  ASSERT_EQ(pool->GetPeakAllocatedBytes(), 300u);
+}
+
+TEST(ImageDecoderTest, StagingPoolFreesBuffersBeyondRetainLimit) {
+  auto pool = ImageDecoderStagingPool::Create(150);
+  {
+    auto first = pool->Acquire(100);
+    auto second = pool->Acquire(100);
+  }
+  ASSERT_EQ(pool->GetRetainedBytes(), 100u);
+  ASSERT_EQ(pool->GetAllocatedBytes(), 100u);
+
+  // Buffers that outlive their pool are freed when released.
+  auto buffer = pool->Acquire(100);
+  pool.reset();
+  buffer.reset();
+}
+
+#if IMPELLER_SUPPORTS_RENDERING
+TEST(ImageDecoderTest, ImpellerDecodesUncompressedImages) {
+  const auto info = SkImageInfo::Make(4, 2, kBGRA_8888_SkColorType,
+                                      kPremul_SkAlphaType);
+  const size_t row_bytes = info.minRowBytes() + 8;
+  std::vector<uint8_t> pixels(row_bytes * info.height(), 0);
+  for (int y = 0; y < info.height(); y++) {
+    uint32_t* row = reinterpret_cast<uint32_t*>(pixels.data() + y * row_bytes);
+    for (int x = 0; x < info.width(); x++) {
+      row[x] = SK_ColorBLUE;
+    }
+  }
+  auto descriptor = fml::MakeRefCounted<ImageDescriptor>(
+      SkData::MakeWithCopy(pixels.data(), pixels.size()), info, row_bytes);
+  auto staging_pool = ImageDecoderStagingPool::Create(1024 * 1024);
+
+  auto same_size = ImageDecoderImpeller::DecompressTexture(
+      descriptor.get(), SkISize::Make(4, 2), staging_pool);
+  ASSERT_TRUE(same_size);
+  ASSERT_EQ(same_size->colorType(), kRGBA_8888_SkColorType);
+  ASSERT_EQ(same_size->getColor(3, 1), SK_ColorBLUE);
+
+  auto scaled = ImageDecoderImpeller::DecompressTexture(
+      descriptor.get(), SkISize::Make(2, 1), staging_pool);
+  ASSERT_TRUE(scaled);
+  ASSERT_EQ(scaled->dimensions(), SkISize::Make(2, 1));
+  ASSERT_EQ(scaled->getColor(1, 0), SK_ColorBLUE);
+}
+
+// Decodes the same image repeatedly and records the time per decode and
+// the peak memory of the staging buffers. After the first decode all of
+// the staging memory is recycled.
+TEST(ImageDecoderTest, ImpellerDecodesReuseStagingMemory) {
+  auto data = OpenFixtureAsSkData("Horizontal.jpg");
+  ImageGeneratorRegistry registry;
+  std::shared_ptr<ImageGenerator> generator =
+      registry.CreateCompatibleGenerator(data);
+  ASSERT_TRUE(generator);
+  auto descriptor =
+      fml::MakeRefCounted<ImageDescriptor>(data, std::move(generator));
+  std::vector<size_t> peaks;
+  for (auto target_size : {SkISize::Make(600, 200), SkISize::Make(100, 33)}) {
+    // A pool per size, so that the peak of each size is measured on its own.
+    auto staging_pool = ImageDecoderStagingPool::Create(16 * 1024 * 1024);
+    auto first = ImageDecoderImpeller::DecompressTexture(
+        descriptor.get(), target_size, staging_pool);
+    ASSERT_TRUE(first);
+    first.reset();
+    const size_t peak_bytes = staging_pool->GetPeakAllocatedBytes();
+
+    constexpr int kDecodeCount = 10;
+    const auto start = fml::TimePoint::Now();
+    for (int i = 0; i < kDecodeCount; i++) {
+      auto bitmap = ImageDecoderImpeller::DecompressTexture(
+          descriptor.get(), target_size, staging_pool);
+      ASSERT_TRUE(bitmap);
+      ASSERT_EQ(bitmap->dimensions(), target_size);
+    }
+    const auto elapsed = fml::TimePoint::Now() - start;
+
+    ASSERT_EQ(staging_pool->GetPeakAllocatedBytes(), peak_bytes);
+    ASSERT_GE(peak_bytes, target_size.width() * target_size.height() * 4u);
+
+    const std::string suffix = std::to_string(target_size.width()) + "x" +
+                               std::to_string(target_size.height());
+    ::testing::Test::RecordProperty("PeakStagingBytes" + suffix,
+                                    std::to_string(peak_bytes));
+    ::testing::Test::RecordProperty(
+        "MicrosPerDecode" + suffix,
+        std::to_string(elapsed.ToMicroseconds() / kDecodeCount));
+    peaks.push_back(peak_bytes);
+  }
+  // Smaller targets stage less memory.
+  ASSERT_EQ(peaks.size(), 2u);
+  ASSERT_LT(peaks[1], peaks[0]);
+}
+#endif  // IMPELLER_SUPPORTS_RENDERING
+
 TEST(ImageDecoderTest, VerifySubpixelDecodingPreservesExifOrientation) {
   auto data = OpenFixtureAsSkData("Horizontal.jpg");
 
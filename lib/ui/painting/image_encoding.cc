@@ -13,6 +13,7 @@
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/striped_image_encoder.h"
 #include "third_party/skia/include/core/SkEncodedImageFormat.h"
 #include "third_party/tonic/dart_persistent_value.h"
 #include "third_party/tonic/logging/dart_invoke.h"
@@ -183,40 +184,67 @@ sk_sp<SkData> CopyImageByteData(sk_sp<SkImage> raster_image,
   return SkData::MakeWithCopy(pixmap.addr(), pixmap.computeByteSize());
 }
 
-sk_sp<SkData> EncodeImage(sk_sp<SkImage> raster_image, ImageByteFormat format) {
+// Encodes 8 bit sRGB images as PNG in parallel on the
+// |concurrent_task_runner|, and calls |on_encoded| on one of its workers.
+// Other PNGs and the raw formats are encoded before this returns.
+void EncodeImage(
+    sk_sp<SkImage> raster_image,
+    ImageByteFormat format,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
+    std::function<void(sk_sp<SkData>)> on_encoded) {
   TRACE_EVENT0("flutter", __FUNCTION__);
 
   if (!raster_image) {
-    return nullptr;
+    on_encoded(nullptr);
+    return;
   }
 
   switch (format) {
     case kPNG: {
+      if (StripedImageEncoder::CanEncodePNG(raster_image->imageInfo())) {
+        StripedImageEncoder::Options options;
+        options.format = StripedImageEncoder::Format::kPNG;
+        StripedImageEncoder::EncodeToData(
+            std::move(raster_image), options,
+            std::move(concurrent_task_runner),
+            [on_encoded = std::move(on_encoded)](sk_sp<SkData> encoded) {
+              if (!encoded) {
+                FML_LOG(ERROR) << "Could not convert raster image to PNG.";
+              }
+              on_encoded(std::move(encoded));
+            });
+        return;
+      }
+      // SkPngEncoder keeps the color space and the 16 bit channels that the
+      // striped encoder does not write.
       auto png_image =
           raster_image->encodeToData(SkEncodedImageFormat::kPNG, 0);
 
       if (png_image == nullptr) {
         FML_LOG(ERROR) << "Could not convert raster image to PNG.";
-        return nullptr;
-      };
-      return png_image;
-    } break;
+      }
+      on_encoded(std::move(png_image));
+      return;
+    }
     case kRawRGBA: {
-      return CopyImageByteData(raster_image, kRGBA_8888_SkColorType,
-                               kPremul_SkAlphaType);
-    } break;
+      on_encoded(CopyImageByteData(raster_image, kRGBA_8888_SkColorType,
+                                   kPremul_SkAlphaType));
+      return;
+    }
     case kRawStraightRGBA: {
-      return CopyImageByteData(raster_image, kRGBA_8888_SkColorType,
-                               kUnpremul_SkAlphaType);
-    } break;
+      on_encoded(CopyImageByteData(raster_image, kRGBA_8888_SkColorType,
+                                   kUnpremul_SkAlphaType));
+      return;
+    }
     case kRawUnmodified: {
-      return CopyImageByteData(raster_image, raster_image->colorType(),
-                               raster_image->alphaType());
-    } break;
+      on_encoded(CopyImageByteData(raster_image, raster_image->colorType(),
+                                   raster_image->alphaType()));
+      return;
+    }
   }
 
   FML_LOG(ERROR) << "Unknown error encoding image.";
-  return nullptr;
+  on_encoded(nullptr);
 }
 
 void EncodeImageAndInvokeDataCallback(
@@ -226,6 +254,7 @@ void EncodeImageAndInvokeDataCallback(
     fml::RefPtr<fml::TaskRunner> ui_task_runner,
     fml::RefPtr<fml::TaskRunner> raster_task_runner,
     fml::RefPtr<fml::TaskRunner> io_task_runner,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
     fml::WeakPtr<GrDirectContext> resource_context,
     fml::WeakPtr<SnapshotDelegate> snapshot_delegate,
     const std::shared_ptr<const fml::SyncSwitch>& is_gpu_disabled_sync_switch) {
@@ -235,12 +264,16 @@ void EncodeImageAndInvokeDataCallback(
       });
 
   auto encode_task = [callback_task = std::move(callback_task), format,
-                      ui_task_runner](sk_sp<SkImage> raster_image) {
-    sk_sp<SkData> encoded = EncodeImage(std::move(raster_image), format);
-    ui_task_runner->PostTask([callback_task = std::move(callback_task),
-                              encoded = std::move(encoded)]() mutable {
-      callback_task(std::move(encoded));
-    });
+                      ui_task_runner, concurrent_task_runner](
+                         sk_sp<SkImage> raster_image) {
+    EncodeImage(std::move(raster_image), format, concurrent_task_runner,
+                [callback_task, ui_task_runner](sk_sp<SkData> encoded) {
+                  ui_task_runner->PostTask(
+                      [callback_task = std::move(callback_task),
+                       encoded = std::move(encoded)]() mutable {
+                        callback_task(std::move(encoded));
+                      });
+                });
   };
 
   FML_DCHECK(image);
@@ -277,19 +310,25 @@ Dart_Handle EncodeImage(CanvasImage* canvas_image,
 
   const auto& task_runners = UIDartState::Current()->GetTaskRunners();
 
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner;
+  if (auto image_decoder = UIDartState::Current()->GetImageDecoder()) {
+    concurrent_task_runner = image_decoder->GetConcurrentTaskRunner();
+  }
+
   task_runners.GetIOTaskRunner()->PostTask(fml::MakeCopyable(
       [callback = std::move(callback), image = canvas_image->image(),
        image_format, ui_task_runner = task_runners.GetUITaskRunner(),
        raster_task_runner = task_runners.GetRasterTaskRunner(),
        io_task_runner = task_runners.GetIOTaskRunner(),
+       concurrent_task_runner = std::move(concurrent_task_runner),
        io_manager = UIDartState::Current()->GetIOManager(),
        snapshot_delegate =
            UIDartState::Current()->GetSnapshotDelegate()]() mutable {
         EncodeImageAndInvokeDataCallback(
             std::move(image), std::move(callback), image_format,
             std::move(ui_task_runner), std::move(raster_task_runner),
-            std::move(io_task_runner), io_manager->GetResourceContext(),
-            std::move(snapshot_delegate),
+            std::move(io_task_runner), std::move(concurrent_task_runner),
+            io_manager->GetResourceContext(), std::move(snapshot_delegate),
             io_manager->GetIsGpuDisabledSyncSwitch());
       }));
 
@@ -8,6 +8,7 @@
 #include "flutter/fml/macros.h"
 #include "flutter/lib/ui/painting/codec.h"
 #include "flutter/lib/ui/painting/image_generator.h"
+#include "flutter/lib/ui/painting/multi_frame_decoder.h"
 
 using tonic::DartPersistentValue;
 
@@ -48,20 +49,15 @@ class MultiFrameCodec : public Codec {
     // The non-const members and functions below here are only read or written
     // to on the IO thread. They are not safe to access or write on the UI
     // thread.
-    int nextFrameIndex_;
-    // The last decoded frame that's required to decode any subsequent frames.
-    std::unique_ptr<SkBitmap> lastRequiredFrame_;
-
-    // The index of the last decoded required frame.
-    int lastRequiredFrameIndex_ = -1;
-
-    sk_sp<SkImage> GetNextFrameImage(
-        fml::WeakPtr<GrDirectContext> resourceContext,
-        const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch);
+    //
+    // Created on the first frame request, the decoder decodes the upcoming
+    // frames ahead on the concurrent task runner.
+    std::shared_ptr<MultiFrameDecoder> decoder_;
 
     void GetNextFrameAndInvokeCallback(
         std::unique_ptr<DartPersistentValue> callback,
         fml::RefPtr<fml::TaskRunner> ui_task_runner,
+        std::shared_ptr<fml::ConcurrentTaskRunner> decode_runner,
         fml::WeakPtr<GrDirectContext> resourceContext,
         fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
         const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
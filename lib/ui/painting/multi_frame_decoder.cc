@@ -0,0 +1,217 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/multi_frame_decoder.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+static SkImageInfo MakeFrameImageInfo(const SkImageInfo& generator_info) {
+  SkImageInfo info = generator_info.makeColorType(kN32_SkColorType);
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    info = info.makeAlphaType(kPremul_SkAlphaType);
+  }
+  return info;
+}
+
+std::shared_ptr<MultiFrameDecoder> MultiFrameDecoder::Create(
+    std::shared_ptr<ImageGenerator> generator,
+    std::shared_ptr<fml::ConcurrentTaskRunner> decode_runner,
+    size_t decode_ahead_count,
+    size_t loop_budget_bytes) {
+  return std::shared_ptr<MultiFrameDecoder>(
+      new MultiFrameDecoder(std::move(generator), std::move(decode_runner),
+                            decode_ahead_count, loop_budget_bytes));
+}
+
+MultiFrameDecoder::MultiFrameDecoder(
+    std::shared_ptr<ImageGenerator> generator,
+    std::shared_ptr<fml::ConcurrentTaskRunner> decode_runner,
+    size_t decode_ahead_count,
+    size_t loop_budget_bytes)
+    : generator_(std::move(generator)),
+      decode_runner_(std::move(decode_runner)),
+      decode_ahead_count_(decode_ahead_count),
+      loop_budget_bytes_(loop_budget_bytes),
+      frame_count_(generator_->GetFrameCount()),
+      frame_image_info_(MakeFrameImageInfo(generator_->GetInfo())),
+      loop_frames_(frame_count_) {
+  frame_infos_.reserve(frame_count_);
+  for (int i = 0; i < frame_count_; i++) {
+    frame_infos_.push_back(generator_->GetFrameInfo(i));
+  }
+}
+
+MultiFrameDecoder::~MultiFrameDecoder() = default;
+
+MultiFrameDecoder::Frame MultiFrameDecoder::GetNextFrame() {
+  std::unique_lock lock(mutex_);
+  Frame frame;
+  if (frame_count_ == 0) {
+    return frame;
+  }
+  frame.index = next_frame_index_;
+  frame.duration = frame_infos_[frame.index].duration;
+  stats_.requested_frames++;
+
+  if (!IsLoopRetainedLocked() && ready_frames_.empty()) {
+    stats_.dropped_frames++;
+    // A decode ahead task that owns the generator may be decoding this
+    // frame.
+    decode_done_.wait(lock, [this]() {
+      return !decoding_ || !ready_frames_.empty() || IsLoopRetainedLocked();
+    });
+  }
+
+  if (IsLoopRetainedLocked()) {
+    frame.bitmap = loop_frames_[frame.index];
+    ready_frames_.clear();
+  } else if (!ready_frames_.empty()) {
+    frame.bitmap = std::move(ready_frames_.front());
+    ready_frames_.pop_front();
+  } else {
+    decoding_ = true;
+    frame.bitmap = DecodeFrameUnlocked(frame.index, lock);
+    decoding_ = false;
+    decode_done_.notify_all();
+  }
+
+  next_frame_index_ = (next_frame_index_ + 1) % frame_count_;
+  ScheduleDecodeAheadLocked();
+  return frame;
+}
+
+void MultiFrameDecoder::WaitForDecodeAhead() {
+  std::unique_lock lock(mutex_);
+  decode_done_.wait(lock, [this]() { return !decoding_; });
+}
+
+bool MultiFrameDecoder::IsLoopRetained() const {
+  std::scoped_lock lock(mutex_);
+  return IsLoopRetainedLocked();
+}
+
+bool MultiFrameDecoder::IsLoopRetainedLocked() const {
+  return loop_retainable_ && loop_frame_count_ == loop_frames_.size();
+}
+
+MultiFrameDecoder::Stats MultiFrameDecoder::GetStats() const {
+  std::scoped_lock lock(mutex_);
+  return stats_;
+}
+
+void MultiFrameDecoder::ScheduleDecodeAheadLocked() {
+  if (!decode_runner_ || decoding_ || IsLoopRetainedLocked() ||
+      ready_frames_.size() >= decode_ahead_count_) {
+    return;
+  }
+  decoding_ = true;
+  decode_runner_->PostTask([weak_decoder = weak_from_this()]() {
+    if (auto decoder = weak_decoder.lock()) {
+      decoder->DecodeAhead();
+    }
+  });
+}
+
+void MultiFrameDecoder::DecodeAhead() {
+  TRACE_EVENT0("flutter", "MultiFrameDecoder::DecodeAhead");
+  std::unique_lock lock(mutex_);
+  FML_DCHECK(decoding_);
+  while (!IsLoopRetainedLocked() &&
+         ready_frames_.size() < decode_ahead_count_) {
+    const int index =
+        (next_frame_index_ + ready_frames_.size()) % frame_count_;
+    auto bitmap = DecodeFrameUnlocked(index, lock);
+    if (!bitmap) {
+      // Leave the failure to the request for the frame.
+      break;
+    }
+    ready_frames_.push_back(std::move(bitmap));
+    decode_done_.notify_all();
+  }
+  decoding_ = false;
+  decode_done_.notify_all();
+}
+
+std::shared_ptr<const SkBitmap> MultiFrameDecoder::DecodeFrameUnlocked(
+    int index,
+    std::unique_lock<std::mutex>& lock) {
+  FML_DCHECK(decoding_);
+  lock.unlock();
+  const auto start = fml::TimePoint::Now();
+  auto bitmap = DecodeFrame(index);
+  const auto latency = fml::TimePoint::Now() - start;
+  lock.lock();
+
+  stats_.decoded_frames++;
+  stats_.total_decode_latency = stats_.total_decode_latency + latency;
+  stats_.max_decode_latency = std::max(stats_.max_decode_latency, latency);
+
+  if (!loop_retainable_ || loop_frames_[index]) {
+    return bitmap;
+  }
+  const size_t bytes = bitmap ? bitmap->computeByteSize() : 0;
+  if (!bitmap || loop_bytes_ + bytes > loop_budget_bytes_) {
+    loop_retainable_ = false;
+    loop_frames_.clear();
+    loop_frame_count_ = 0;
+    loop_bytes_ = 0;
+    return bitmap;
+  }
+  loop_frames_[index] = bitmap;
+  loop_frame_count_++;
+  loop_bytes_ += bytes;
+  return bitmap;
+}
+
+std::shared_ptr<const SkBitmap> MultiFrameDecoder::DecodeFrame(int index) {
+  TRACE_EVENT0("flutter", "MultiFrameDecoder::DecodeFrame");
+  auto bitmap = std::make_shared<SkBitmap>();
+  if (!bitmap->tryAllocPixels(frame_image_info_)) {
+    FML_LOG(ERROR) << "Could not allocate pixels for frame " << index;
+    return nullptr;
+  }
+
+  const ImageGenerator::FrameInfo& frame_info = frame_infos_[index];
+  const int required_frame_index =
+      frame_info.required_frame.value_or(SkCodec::kNoFrame);
+
+  if (required_frame_index != SkCodec::kNoFrame) {
+    if (last_required_frame_ == nullptr) {
+      FML_LOG(ERROR) << "Frame " << index << " depends on frame "
+                     << required_frame_index
+                     << " and no required frames are cached.";
+      return nullptr;
+    } else if (last_required_frame_index_ != required_frame_index) {
+      FML_DLOG(INFO) << "Required frame " << required_frame_index
+                     << " is not cached. Using " << last_required_frame_index_
+                     << " instead";
+    }
+    // The required frame has the same image info, so its pixels are copied
+    // straight into the new frame.
+    last_required_frame_->pixmap().readPixels(bitmap->pixmap());
+  }
+
+  if (!generator_->GetPixels(frame_image_info_, bitmap->getPixels(),
+                             bitmap->rowBytes(), index,
+                             required_frame_index)) {
+    FML_LOG(ERROR) << "Could not getPixels for frame " << index;
+    return nullptr;
+  }
+  bitmap->setImmutable();
+
+  // Hold onto this if we need it to decode future frames.
+  if (frame_info.disposal_method == SkCodecAnimation::DisposalMethod::kKeep) {
+    last_required_frame_ = bitmap;
+    last_required_frame_index_ = index;
+  }
+  return bitmap;
+}
+
+}  // namespace flutter
@@ -0,0 +1,158 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_MULTI_FRAME_DECODER_H_
+#define FLUTTER_LIB_UI_PAINTING_MULTI_FRAME_DECODER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/lib/ui/painting/image_generator.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Decodes the frames of an animated image in display order and
+///             keeps up to `decode_ahead_count` of the upcoming frames decoded
+///             ahead of the requests for them.
+///
+///             Frames are decoded ahead on the decode runner while the caller
+///             uploads and displays the current one. The `ImageGenerator` is
+///             not thread safe and every frame may depend on the previous one,
+///             so the frames of a single image are decoded one at a time.
+///
+///             If all of the frames of the animation fit into
+///             `loop_budget_bytes`, they are retained after the first loop and
+///             never decoded again.
+///
+class MultiFrameDecoder final
+    : public std::enable_shared_from_this<MultiFrameDecoder> {
+ public:
+  static constexpr size_t kDefaultDecodeAheadCount = 3;
+  static constexpr size_t kDefaultLoopBudgetBytes = 16 * 1024 * 1024;
+
+  struct Frame {
+    int index = 0;
+    /// Number of milliseconds to show this frame.
+    int duration = 0;
+    /// The immutable pixels of the frame, or nullptr if it could not be
+    /// decoded.
+    std::shared_ptr<const SkBitmap> bitmap;
+  };
+
+  struct Stats {
+    /// The number of frames returned by `GetNextFrame`.
+    size_t requested_frames = 0;
+    /// The number of frames that had not been decoded ahead when they were
+    /// requested, so that `GetNextFrame` had to wait for their decode.
+    size_t dropped_frames = 0;
+    /// The number of frame decodes, including the decodes of frames that are
+    /// decoded again on later loops of the animation.
+    size_t decoded_frames = 0;
+    fml::TimeDelta total_decode_latency;
+    fml::TimeDelta max_decode_latency;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a decoder for the frames of the |generator|.
+  ///
+  /// @param[in]  decode_runner       The runner that frames are decoded ahead
+  ///                                 on. If null, every frame is decoded when
+  ///                                 it is requested.
+  ///
+  static std::shared_ptr<MultiFrameDecoder> Create(
+      std::shared_ptr<ImageGenerator> generator,
+      std::shared_ptr<fml::ConcurrentTaskRunner> decode_runner,
+      size_t decode_ahead_count = kDefaultDecodeAheadCount,
+      size_t loop_budget_bytes = kDefaultLoopBudgetBytes);
+
+  ~MultiFrameDecoder();
+
+  int GetFrameCount() const { return frame_count_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the next frame of the animation, decoding it first if
+  ///             it has not been decoded ahead, and schedules the decode of
+  ///             the frames after it. May be called from one thread at a time.
+  ///
+  Frame GetNextFrame();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Blocks until the frames that are being decoded ahead are
+  ///             ready.
+  ///
+  void WaitForDecodeAhead();
+
+  /// Whether all frames of the animation are retained, so that no more frames
+  /// are decoded.
+  bool IsLoopRetained() const;
+
+  Stats GetStats() const;
+
+ private:
+  const std::shared_ptr<ImageGenerator> generator_;
+  const std::shared_ptr<fml::ConcurrentTaskRunner> decode_runner_;
+  const size_t decode_ahead_count_;
+  const size_t loop_budget_bytes_;
+  const int frame_count_;
+  // Collected up front so that the generator is only used by one decode at a
+  // time.
+  const SkImageInfo frame_image_info_;
+  std::vector<ImageGenerator::FrameInfo> frame_infos_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable decode_done_;
+  // Whether a decode ahead task currently owns the generator and the required
+  // frame below.
+  bool decoding_ = false;
+  // The index of the frame that the next call to |GetNextFrame| returns.
+  int next_frame_index_ = 0;
+  // The frames that have been decoded ahead, starting at |next_frame_index_|.
+  std::deque<std::shared_ptr<const SkBitmap>> ready_frames_;
+  // The frames of the animation that are retained while they fit into the
+  // loop budget.
+  std::vector<std::shared_ptr<const SkBitmap>> loop_frames_;
+  size_t loop_frame_count_ = 0;
+  size_t loop_bytes_ = 0;
+  bool loop_retainable_ = true;
+  Stats stats_;
+
+  // Only accessed by the owner of the generator.
+  std::shared_ptr<const SkBitmap> last_required_frame_;
+  int last_required_frame_index_ = -1;
+
+  MultiFrameDecoder(std::shared_ptr<ImageGenerator> generator,
+                    std::shared_ptr<fml::ConcurrentTaskRunner> decode_runner,
+                    size_t decode_ahead_count,
+                    size_t loop_budget_bytes);
+
+  bool IsLoopRetainedLocked() const;
+
+  // Decodes the frame at |index|. Must only be called by the owner of the
+  // generator, in display order.
+  std::shared_ptr<const SkBitmap> DecodeFrame(int index);
+
+  // Decodes the frame at |index| and records it, with the lock released
+  // during the decode. Must only be called by the owner of the generator.
+  std::shared_ptr<const SkBitmap> DecodeFrameUnlocked(
+      int index,
+      std::unique_lock<std::mutex>& lock);
+
+  void ScheduleDecodeAheadLocked();
+
+  void DecodeAhead();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(MultiFrameDecoder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_MULTI_FRAME_DECODER_H_
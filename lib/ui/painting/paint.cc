@@ -35,6 +35,7 @@ constexpr int kMaskFilterSigmaIndex = 11;
 constexpr int kInvertColorIndex = 12;
 constexpr int kDitherIndex = 13;
 constexpr size_t kDataByteCount = 56;  // 4 * (last index + 1)
+static_assert(kDataByteCount == Paint::kDataWordCount * sizeof(uint32_t));
 
 // Indices for objects.
 constexpr int kShaderIndex = 0;
@@ -66,6 +67,97 @@ constexpr float kInvertColors[20] = {
 // Must be kept in sync with the MaskFilter private constants in painting.dart.
 enum MaskFilterType { kNull, kBlur };
 
+namespace {
+
+void SyncNullObjects(DisplayListBuilder* builder,
+                     const DisplayListAttributeFlags& flags) {
+  if (flags.applies_shader()) {
+    builder->setColorSource(nullptr);
+  }
+  if (flags.applies_color_filter()) {
+    builder->setColorFilter(nullptr);
+  }
+  if (flags.applies_image_filter()) {
+    builder->setImageFilter(nullptr);
+  }
+}
+
+// Synchronizes the attributes that are encoded in the data of a Paint.
+void SyncData(const uint32_t* uint_data,
+              DisplayListBuilder* builder,
+              const DisplayListAttributeFlags& flags) {
+  const float* float_data = reinterpret_cast<const float*>(uint_data);
+
+  if (flags.applies_anti_alias()) {
+    builder->setAntiAlias(uint_data[kIsAntiAliasIndex] == 0);
+  }
+
+  if (flags.applies_alpha_or_color()) {
+    uint32_t encoded_color = uint_data[kColorIndex];
+    builder->setColor(encoded_color ^ kColorDefault);
+  }
+
+  if (flags.applies_blend()) {
+    uint32_t encoded_blend_mode = uint_data[kBlendModeIndex];
+    uint32_t blend_mode = encoded_blend_mode ^ kBlendModeDefault;
+    builder->setBlendMode(static_cast<DlBlendMode>(blend_mode));
+  }
+
+  if (flags.applies_style()) {
+    uint32_t style = uint_data[kStyleIndex];
+    builder->setStyle(static_cast<DlDrawStyle>(style));
+  }
+
+  if (flags.is_stroked(builder->getStyle())) {
+    float stroke_width = float_data[kStrokeWidthIndex];
+    builder->setStrokeWidth(stroke_width);
+
+    float stroke_miter_limit = float_data[kStrokeMiterLimitIndex];
+    builder->setStrokeMiter(stroke_miter_limit + kStrokeMiterLimitDefault);
+
+    uint32_t stroke_cap = uint_data[kStrokeCapIndex];
+    builder->setStrokeCap(static_cast<DlStrokeCap>(stroke_cap));
+
+    uint32_t stroke_join = uint_data[kStrokeJoinIndex];
+    builder->setStrokeJoin(static_cast<DlStrokeJoin>(stroke_join));
+  }
+
+  if (flags.applies_color_filter()) {
+    builder->setInvertColors(uint_data[kInvertColorIndex] != 0);
+  }
+
+  if (flags.applies_dither()) {
+    builder->setDither(uint_data[kDitherIndex] != 0);
+  }
+
+  if (flags.applies_path_effect()) {
+    // The paint API exposed to Dart does not support path effects.  But other
+    // operations such as text may set a path effect, which must be cleared.
+    builder->setPathEffect(nullptr);
+  }
+
+  if (flags.applies_mask_filter()) {
+    switch (uint_data[kMaskFilterIndex]) {
+      case kNull:
+        builder->setMaskFilter(nullptr);
+        break;
+      case kBlur:
+        SkBlurStyle blur_style =
+            static_cast<SkBlurStyle>(uint_data[kMaskFilterBlurStyleIndex]);
+        double sigma = float_data[kMaskFilterSigmaIndex];
+        DlBlurMaskFilter dl_filter(blur_style, sigma);
+        if (dl_filter.skia_object()) {
+          builder->setMaskFilter(&dl_filter);
+        } else {
+          builder->setMaskFilter(nullptr);
+        }
+        break;
+    }
+  }
+}
+
+}  // namespace
+
 Paint::Paint(Dart_Handle paint_objects, Dart_Handle paint_data)
     : paint_objects_(paint_objects), paint_data_(paint_data) {}
 
@@ -191,19 +283,10 @@ bool Paint::sync_to(DisplayListBuilder* builder,
   FML_CHECK(byte_data.length_in_bytes() == kDataByteCount);
 
   const uint32_t* uint_data = static_cast<const uint32_t*>(byte_data.data());
-  const float* float_data = static_cast<const float*>(byte_data.data());
 
   Dart_Handle values[kObjectCount];
   if (Dart_IsNull(paint_objects_)) {
-    if (flags.applies_shader()) {
-      builder->setColorSource(nullptr);
-    }
-    if (flags.applies_color_filter()) {
-      builder->setColorFilter(nullptr);
-    }
-    if (flags.applies_image_filter()) {
-      builder->setImageFilter(nullptr);
-    }
+    SyncNullObjects(builder, flags);
   } else {
     FML_DCHECK(Dart_IsList(paint_objects_));
     intptr_t length = 0;
@@ -250,76 +333,17 @@ bool Paint::sync_to(DisplayListBuilder* builder,
     }
   }
 
-  if (flags.applies_anti_alias()) {
-    builder->setAntiAlias(uint_data[kIsAntiAliasIndex] == 0);
-  }
-
-  if (flags.applies_alpha_or_color()) {
-    uint32_t encoded_color = uint_data[kColorIndex];
-    builder->setColor(encoded_color ^ kColorDefault);
-  }
-
-  if (flags.applies_blend()) {
-    uint32_t encoded_blend_mode = uint_data[kBlendModeIndex];
-    uint32_t blend_mode = encoded_blend_mode ^ kBlendModeDefault;
-    builder->setBlendMode(static_cast<DlBlendMode>(blend_mode));
-  }
-
-  if (flags.applies_style()) {
-    uint32_t style = uint_data[kStyleIndex];
-    builder->setStyle(static_cast<DlDrawStyle>(style));
-  }
-
-  if (flags.is_stroked(builder->getStyle())) {
-    float stroke_width = float_data[kStrokeWidthIndex];
-    builder->setStrokeWidth(stroke_width);
-
-    float stroke_miter_limit = float_data[kStrokeMiterLimitIndex];
-    builder->setStrokeMiter(stroke_miter_limit + kStrokeMiterLimitDefault);
-
-    uint32_t stroke_cap = uint_data[kStrokeCapIndex];
-    builder->setStrokeCap(static_cast<DlStrokeCap>(stroke_cap));
-
-    uint32_t stroke_join = uint_data[kStrokeJoinIndex];
-    builder->setStrokeJoin(static_cast<DlStrokeJoin>(stroke_join));
-  }
-
-  if (flags.applies_color_filter()) {
-    builder->setInvertColors(uint_data[kInvertColorIndex] != 0);
-  }
-
-  if (flags.applies_dither()) {
-    builder->setDither(uint_data[kDitherIndex] != 0);
-  }
-
-  if (flags.applies_path_effect()) {
-    // The paint API exposed to Dart does not support path effects.  But other
-    // operations such as text may set a path effect, which must be cleared.
-    builder->setPathEffect(nullptr);
-  }
-
-  if (flags.applies_mask_filter()) {
-    switch (uint_data[kMaskFilterIndex]) {
-      case kNull:
-        builder->setMaskFilter(nullptr);
-        break;
-      case kBlur:
-        SkBlurStyle blur_style =
-            static_cast<SkBlurStyle>(uint_data[kMaskFilterBlurStyleIndex]);
-        double sigma = float_data[kMaskFilterSigmaIndex];
-        DlBlurMaskFilter dl_filter(blur_style, sigma);
-        if (dl_filter.skia_object()) {
-          builder->setMaskFilter(&dl_filter);
-        } else {
-          builder->setMaskFilter(nullptr);
-        }
-        break;
-    }
-  }
-
+  SyncData(uint_data, builder, flags);
   return true;
 }
 
+void Paint::SyncDataTo(const uint32_t* paint_data,
+                       DisplayListBuilder* builder,
+                       const DisplayListAttributeFlags& flags) {
+  SyncNullObjects(builder, flags);
+  SyncData(paint_data, builder, flags);
+}
+
 }  // namespace flutter
 
 namespace tonic {
@@ -28,6 +28,16 @@ class Paint {
   bool sync_to(DisplayListBuilder* builder,
                const DisplayListAttributeFlags& flags) const;
 
+  /// The number of 32-bit words in the encoded data of a Paint.
+  static constexpr size_t kDataWordCount = 14;
+
+  /// Synchronize the properties of a Paint without shader or filter
+  /// objects from a copy of its encoded data, such as the one in a
+  /// batched canvas command.
+  static void SyncDataTo(const uint32_t* paint_data,
+                         DisplayListBuilder* builder,
+                         const DisplayListAttributeFlags& flags);
+
   bool isNull() const { return Dart_IsNull(paint_data_); }
   bool isNotNull() const { return !Dart_IsNull(paint_data_); }
 
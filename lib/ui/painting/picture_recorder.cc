@@ -27,7 +27,11 @@ PictureRecorder::PictureRecorder() {}
 PictureRecorder::~PictureRecorder() {}
 
 SkCanvas* PictureRecorder::BeginRecording(SkRect bounds) {
-  display_list_recorder_ = sk_make_sp<DisplayListCanvasRecorder>(bounds);
+  // Pictures are often larger than the area that is repainted in a frame,
+  // for example the contents of a scrollable, so they are culled using
+  // their RTree when they are rendered.
+  display_list_recorder_ =
+      sk_make_sp<DisplayListCanvasRecorder>(bounds, /*prepare_rtree=*/true);
   return display_list_recorder_.get();
 }
 
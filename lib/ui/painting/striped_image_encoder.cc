@@ -0,0 +1,486 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/striped_image_encoder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/zlib/zlib.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr uint8_t kPNGSignature[] = {137, 80, 78, 71, 13, 10, 26, 10};
+// The length, type and CRC of a PNG chunk.
+constexpr size_t kPNGChunkOverhead = 12;
+constexpr uint8_t kPNGColorTypeRGB = 2;
+constexpr uint8_t kPNGColorTypeRGBA = 6;
+// The rendering intent that SkPngEncoder writes for sRGB images.
+constexpr uint8_t kPNGSRGBIntentPerceptual = 0;
+
+void WriteBigEndian32(uint8_t* dst, uint32_t value) {
+  dst[0] = static_cast<uint8_t>(value >> 24);
+  dst[1] = static_cast<uint8_t>(value >> 16);
+  dst[2] = static_cast<uint8_t>(value >> 8);
+  dst[3] = static_cast<uint8_t>(value);
+}
+
+// Fills in the length, type and CRC of the PNG chunk at |chunk|, whose
+// |data_length| bytes of data are already in place after the type.
+void FinishPNGChunk(uint8_t* chunk, const char* type, size_t data_length) {
+  WriteBigEndian32(chunk, static_cast<uint32_t>(data_length));
+  memcpy(chunk + 4, type, 4);
+  uLong crc = crc32(0L, Z_NULL, 0);
+  crc = crc32(crc, chunk + 4, static_cast<uInt>(data_length + 4));
+  WriteBigEndian32(chunk + 8 + data_length, static_cast<uint32_t>(crc));
+}
+
+void AppendPNGChunk(std::vector<uint8_t>& out,
+                    const char* type,
+                    const uint8_t* data,
+                    size_t data_length) {
+  const size_t offset = out.size();
+  out.resize(offset + kPNGChunkOverhead + data_length);
+  if (data_length > 0) {
+    memcpy(out.data() + offset + 8, data, data_length);
+  }
+  FinishPNGChunk(out.data() + offset, type, data_length);
+}
+
+// The PNG row filters, see https://www.w3.org/TR/PNG/#9Filters.
+enum PNGFilter {
+  kNone = 0,
+  kSub = 1,
+  kUp = 2,
+  kAverage = 3,
+  kPaeth = 4,
+};
+
+inline int PaethPredictor(int a, int b, int c) {
+  const int p = a + b - c;
+  const int pa = std::abs(p - a);
+  const int pb = std::abs(p - b);
+  const int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc) {
+    return a;
+  }
+  return pb <= pc ? b : c;
+}
+
+template <PNGFilter kFilter>
+inline uint8_t FilterByte(const uint8_t* row,
+                          const uint8_t* prior,
+                          size_t i,
+                          size_t bpp) {
+  const int a = i >= bpp ? row[i - bpp] : 0;
+  const int b = prior[i];
+  const int c = i >= bpp ? prior[i - bpp] : 0;
+  int predicted = 0;
+  if constexpr (kFilter == kSub) {
+    predicted = a;
+  } else if constexpr (kFilter == kUp) {
+    predicted = b;
+  } else if constexpr (kFilter == kAverage) {
+    predicted = (a + b) >> 1;
+  } else if constexpr (kFilter == kPaeth) {
+    predicted = PaethPredictor(a, b, c);
+  }
+  return static_cast<uint8_t>(row[i] - predicted);
+}
+
+template <PNGFilter kFilter>
+void ApplyFilter(const uint8_t* row,
+                 const uint8_t* prior,
+                 size_t row_bytes,
+                 size_t bpp,
+                 uint8_t* out) {
+  out[0] = kFilter;
+  for (size_t i = 0; i < row_bytes; i++) {
+    out[i + 1] = FilterByte<kFilter>(row, prior, i, bpp);
+  }
+}
+
+// The sum of the filtered bytes as signed values, which is the heuristic that
+// libpng uses to pick the filter that compresses best. Stops counting once
+// the sum reaches |limit|.
+template <PNGFilter kFilter>
+uint64_t SumFilter(const uint8_t* row,
+                   const uint8_t* prior,
+                   size_t row_bytes,
+                   size_t bpp,
+                   uint64_t limit) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < row_bytes && sum < limit; i++) {
+    sum += std::abs(
+        static_cast<int8_t>(FilterByte<kFilter>(row, prior, i, bpp)));
+  }
+  return sum;
+}
+
+void FilterRow(const uint8_t* row,
+               const uint8_t* prior,
+               size_t row_bytes,
+               size_t bpp,
+               bool adaptive,
+               uint8_t* out) {
+  if (!adaptive) {
+    ApplyFilter<kNone>(row, prior, row_bytes, bpp, out);
+    return;
+  }
+  using SumFunction = uint64_t (*)(const uint8_t*, const uint8_t*, size_t,
+                                   size_t, uint64_t);
+  using ApplyFunction = void (*)(const uint8_t*, const uint8_t*, size_t,
+                                 size_t, uint8_t*);
+  static constexpr SumFunction kSums[] = {
+      SumFilter<kNone>,    SumFilter<kSub>,   SumFilter<kUp>,
+      SumFilter<kAverage>, SumFilter<kPaeth>,
+  };
+  static constexpr ApplyFunction kApplies[] = {
+      ApplyFilter<kNone>,    ApplyFilter<kSub>,   ApplyFilter<kUp>,
+      ApplyFilter<kAverage>, ApplyFilter<kPaeth>,
+  };
+  size_t best = 0;
+  uint64_t best_sum = UINT64_MAX;
+  for (size_t filter = 0; filter < std::size(kSums); filter++) {
+    const uint64_t sum = kSums[filter](row, prior, row_bytes, bpp, best_sum);
+    if (sum < best_sum) {
+      best = filter;
+      best_sum = sum;
+    }
+  }
+  kApplies[best](row, prior, row_bytes, bpp, out);
+}
+
+}  // namespace
+
+bool StripedImageEncoder::CanEncodePNG(const SkImageInfo& image) {
+  switch (image.colorType()) {
+    case kRGBA_8888_SkColorType:
+    case kBGRA_8888_SkColorType:
+    case kRGB_888x_SkColorType:
+      break;
+    default:
+      return false;
+  }
+  return image.colorSpace() == nullptr || image.colorSpace()->isSRGB();
+}
+
+void StripedImageEncoder::Encode(sk_sp<SkImage> raster_image,
+                                 const Options& options,
+                                 std::shared_ptr<fml::BasicTaskRunner> runner,
+                                 ChunkCallback on_chunk,
+                                 DoneCallback on_done) {
+  TRACE_EVENT0("flutter", "StripedImageEncoder::Encode");
+  std::shared_ptr<StripedImageEncoder> encoder(
+      new StripedImageEncoder(std::move(raster_image), options,
+                              std::move(on_chunk), std::move(on_done)));
+  if (!encoder->Prepare()) {
+    encoder->on_done_(false);
+    return;
+  }
+
+  if (options.format == Format::kPNG) {
+    encoder->on_chunk_(encoder->EncodePNGHeader());
+  }
+
+  const size_t stripe_count = encoder->stripes_.size();
+  for (size_t i = 0; i < stripe_count; i++) {
+    if (runner) {
+      runner->PostTask([encoder, i]() { encoder->EncodeStripe(i); });
+    } else {
+      encoder->EncodeStripe(i);
+    }
+  }
+}
+
+void StripedImageEncoder::EncodeToData(
+    sk_sp<SkImage> raster_image,
+    const Options& options,
+    std::shared_ptr<fml::BasicTaskRunner> runner,
+    std::function<void(sk_sp<SkData>)> on_encoded) {
+  // The encoder delivers one chunk at a time and in order, so the chunks
+  // don't need a lock of their own.
+  auto chunks = std::make_shared<std::vector<sk_sp<SkData>>>();
+  Encode(
+      std::move(raster_image), options, std::move(runner),
+      [chunks](sk_sp<SkData> chunk) { chunks->push_back(std::move(chunk)); },
+      [chunks, on_encoded = std::move(on_encoded)](bool success) {
+        if (!success) {
+          on_encoded(nullptr);
+          return;
+        }
+        if (chunks->size() == 1) {
+          on_encoded(std::move(chunks->front()));
+          return;
+        }
+        size_t size = 0;
+        for (const auto& chunk : *chunks) {
+          size += chunk->size();
+        }
+        sk_sp<SkData> data = SkData::MakeUninitialized(size);
+        auto* dst = static_cast<uint8_t*>(data->writable_data());
+        for (const auto& chunk : *chunks) {
+          memcpy(dst, chunk->data(), chunk->size());
+          dst += chunk->size();
+        }
+        chunks->clear();
+        on_encoded(std::move(data));
+      });
+}
+
+StripedImageEncoder::StripedImageEncoder(sk_sp<SkImage> image,
+                                         const Options& options,
+                                         ChunkCallback on_chunk,
+                                         DoneCallback on_done)
+    : image_(std::move(image)),
+      options_(options),
+      on_chunk_(std::move(on_chunk)),
+      on_done_(std::move(on_done)) {}
+
+StripedImageEncoder::~StripedImageEncoder() = default;
+
+bool StripedImageEncoder::Prepare() {
+  if (!image_ || !image_->peekPixels(&pixmap_)) {
+    FML_LOG(ERROR) << "Could not read the pixels of the image to encode.";
+    return false;
+  }
+  if (pixmap_.dimensions().isEmpty()) {
+    FML_LOG(ERROR) << "Image dimensions were empty.";
+    return false;
+  }
+  if (options_.format == Format::kPNG && !CanEncodePNG(pixmap_.info())) {
+    FML_LOG(ERROR) << "Only 8 bit sRGB images can be encoded in stripes.";
+    return false;
+  }
+  if (options_.format == Format::kRaw &&
+      options_.color_type == kUnknown_SkColorType) {
+    FML_LOG(ERROR) << "Unknown color type to encode.";
+    return false;
+  }
+
+  png_pixel_bytes_ = pixmap_.isOpaque() ? 3 : 4;
+  rows_per_stripe_ = options_.rows_per_stripe;
+  if (rows_per_stripe_ <= 0) {
+    rows_per_stripe_ = static_cast<int>(std::max<size_t>(
+        kDefaultStripeBytes / std::max<size_t>(pixmap_.rowBytes(), 1), 1));
+  }
+  const int height = pixmap_.height();
+  stripes_.resize((height + rows_per_stripe_ - 1) / rows_per_stripe_);
+  pending_stripes_ = stripes_.size();
+  return true;
+}
+
+sk_sp<SkData> StripedImageEncoder::EncodePNGHeader() const {
+  std::vector<uint8_t> out(std::begin(kPNGSignature), std::end(kPNGSignature));
+
+  uint8_t header[13];
+  WriteBigEndian32(header, pixmap_.width());
+  WriteBigEndian32(header + 4, pixmap_.height());
+  header[8] = 8;  // Bit depth.
+  header[9] = png_pixel_bytes_ == 3 ? kPNGColorTypeRGB : kPNGColorTypeRGBA;
+  header[10] = 0;  // Deflate compression.
+  header[11] = 0;  // Adaptive filtering.
+  header[12] = 0;  // No interlace.
+  AppendPNGChunk(out, "IHDR", header, sizeof(header));
+  if (pixmap_.colorSpace() != nullptr) {
+    AppendPNGChunk(out, "sRGB", &kPNGSRGBIntentPerceptual, 1);
+  }
+
+  // The zlib header of the image data. The stripes are raw deflate data.
+  const int level = std::clamp(options_.compression_level, 0, 9);
+  const uint8_t compression_info = 0x78;  // Deflate with a 32K window.
+  uint8_t level_flag = 3;
+  if (level < 2) {
+    level_flag = 0;
+  } else if (level < 6) {
+    level_flag = 1;
+  } else if (level == 6) {
+    level_flag = 2;
+  }
+  uint32_t zlib_header = (compression_info << 8) | (level_flag << 6);
+  zlib_header += 31 - (zlib_header % 31);
+  const uint8_t zlib_header_bytes[] = {
+      static_cast<uint8_t>(zlib_header >> 8),
+      static_cast<uint8_t>(zlib_header),
+  };
+  AppendPNGChunk(out, "IDAT", zlib_header_bytes, sizeof(zlib_header_bytes));
+
+  return SkData::MakeWithCopy(out.data(), out.size());
+}
+
+sk_sp<SkData> StripedImageEncoder::EncodePNGTrailer(uint32_t adler) const {
+  std::vector<uint8_t> out;
+  uint8_t adler_bytes[4];
+  WriteBigEndian32(adler_bytes, adler);
+  AppendPNGChunk(out, "IDAT", adler_bytes, sizeof(adler_bytes));
+  AppendPNGChunk(out, "IEND", nullptr, 0);
+  return SkData::MakeWithCopy(out.data(), out.size());
+}
+
+void StripedImageEncoder::EncodeStripe(size_t index) {
+  TRACE_EVENT0("flutter", "StripedImageEncoder::EncodeStripe");
+  {
+    std::scoped_lock lock(mutex_);
+    if (failed_) {
+      OnStripeDoneLocked(index, {}, false);
+      return;
+    }
+  }
+
+  const int first_row = static_cast<int>(index) * rows_per_stripe_;
+  const int end_row = std::min(first_row + rows_per_stripe_, pixmap_.height());
+  Stripe stripe;
+  bool success = false;
+  switch (options_.format) {
+    case Format::kPNG:
+      success = EncodePNGStripe(first_row, end_row,
+                                index == stripes_.size() - 1, stripe);
+      break;
+    case Format::kRaw:
+      success = EncodeRawStripe(first_row, end_row, stripe);
+      break;
+  }
+
+  std::scoped_lock lock(mutex_);
+  OnStripeDoneLocked(index, std::move(stripe), success);
+}
+
+bool StripedImageEncoder::EncodePNGStripe(int first_row,
+                                          int end_row,
+                                          bool last,
+                                          Stripe& stripe) {
+  const size_t width = pixmap_.width();
+  const size_t bpp = png_pixel_bytes_;
+  const size_t row_bytes = width * bpp;
+  const SkImageInfo rgba_info = SkImageInfo::Make(
+      pixmap_.width(), 1, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType);
+  std::vector<uint8_t> rgba(width * 4);
+  auto read_row = [&](int y, uint8_t* dst) {
+    if (bpp == 4) {
+      return pixmap_.readPixels(rgba_info, dst, row_bytes, 0, y);
+    }
+    if (!pixmap_.readPixels(rgba_info, rgba.data(), rgba.size(), 0, y)) {
+      return false;
+    }
+    for (size_t x = 0; x < width; x++) {
+      memcpy(dst + x * 3, rgba.data() + x * 4, 3);
+    }
+    return true;
+  };
+
+  // The filters of the first row of a stripe depend on the last row of the
+  // stripe before it, which is read again rather than shared.
+  std::vector<uint8_t> prior(row_bytes, 0);
+  std::vector<uint8_t> current(row_bytes);
+  if (first_row > 0 && !read_row(first_row - 1, prior.data())) {
+    return false;
+  }
+
+  const bool adaptive = options_.compression_level > 0;
+  std::vector<uint8_t> filtered((end_row - first_row) * (row_bytes + 1));
+  uint8_t* out = filtered.data();
+  for (int y = first_row; y < end_row; y++) {
+    if (!read_row(y, current.data())) {
+      return false;
+    }
+    FilterRow(current.data(), prior.data(), row_bytes, bpp, adaptive, out);
+    out += row_bytes + 1;
+    std::swap(prior, current);
+  }
+
+  z_stream stream = {};
+  if (deflateInit2(&stream, std::clamp(options_.compression_level, 0, 9),
+                   Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    FML_LOG(ERROR) << "Could not initialize the PNG compressor.";
+    return false;
+  }
+  // Sync flushes can add a few bytes beyond the bound.
+  const size_t bound = deflateBound(&stream, filtered.size()) + 16;
+  std::vector<uint8_t> chunk(kPNGChunkOverhead + bound);
+  stream.next_in = filtered.data();
+  stream.avail_in = static_cast<uInt>(filtered.size());
+  stream.next_out = chunk.data() + 8;
+  stream.avail_out = static_cast<uInt>(bound);
+  // Every stripe but the last ends on a byte boundary without ending the
+  // deflate stream, so the stripes can be concatenated.
+  const int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+  const size_t compressed_length = stream.total_out;
+  const bool compressed = result == (last ? Z_STREAM_END : Z_OK) &&
+                          stream.avail_in == 0 && stream.avail_out > 0;
+  deflateEnd(&stream);
+  if (!compressed) {
+    FML_LOG(ERROR) << "Could not compress the PNG rows " << first_row << " to "
+                   << end_row;
+    return false;
+  }
+
+  FinishPNGChunk(chunk.data(), "IDAT", compressed_length);
+  stripe.data = SkData::MakeWithCopy(chunk.data(),
+                                     kPNGChunkOverhead + compressed_length);
+  stripe.adler = static_cast<uint32_t>(
+      adler32(adler32(0L, Z_NULL, 0), filtered.data(),
+              static_cast<uInt>(filtered.size())));
+  stripe.raw_length = filtered.size();
+  return true;
+}
+
+bool StripedImageEncoder::EncodeRawStripe(int first_row,
+                                          int end_row,
+                                          Stripe& stripe) {
+  const SkImageInfo info =
+      SkImageInfo::Make(pixmap_.width(), end_row - first_row,
+                        options_.color_type, options_.alpha_type);
+  sk_sp<SkData> data = SkData::MakeUninitialized(info.computeMinByteSize());
+  if (!pixmap_.readPixels(info, data->writable_data(), info.minRowBytes(), 0,
+                          first_row)) {
+    FML_LOG(ERROR) << "Could not copy pixels from the raster image.";
+    return false;
+  }
+  stripe.data = std::move(data);
+  return true;
+}
+
+void StripedImageEncoder::OnStripeDoneLocked(size_t index,
+                                             Stripe stripe,
+                                             bool success) {
+  pending_stripes_--;
+  if (!success) {
+    failed_ = true;
+  }
+  if (failed_) {
+    // Finish once the stripes that are still encoding are done with the
+    // image.
+    if (pending_stripes_ == 0) {
+      on_done_(false);
+    }
+    return;
+  }
+
+  stripe.done = true;
+  stripes_[index] = std::move(stripe);
+  while (next_stripe_to_deliver_ < stripes_.size() &&
+         stripes_[next_stripe_to_deliver_].done) {
+    Stripe& next = stripes_[next_stripe_to_deliver_++];
+    adler_ = static_cast<uint32_t>(adler32_combine(
+        adler_, next.adler, static_cast<z_off_t>(next.raw_length)));
+    on_chunk_(std::move(next.data));
+  }
+
+  if (next_stripe_to_deliver_ == stripes_.size()) {
+    if (options_.format == Format::kPNG) {
+      on_chunk_(EncodePNGTrailer(adler_));
+    }
+    on_done_(true);
+  }
+}
+
+}  // namespace flutter
@@ -0,0 +1,150 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_STRIPED_IMAGE_ENCODER_H_
+#define FLUTTER_LIB_UI_PAINTING_STRIPED_IMAGE_ENCODER_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Encodes a raster image as PNG or raw pixels by splitting its
+///             rows into stripes that are encoded in parallel.
+///
+///             Every stripe of a PNG is filtered and deflated independently
+///             and ends on a byte boundary with a sync flush, so the
+///             compressed stripes are joined into a single zlib stream
+///             without being decompressed again. The output is delivered in
+///             order as soon as the stripes before it are done, so the
+///             caller can stream it instead of waiting for the whole image.
+///
+///             PNGs are written with 8 bits per channel and are only tagged
+///             as sRGB, see |CanEncodePNG|.
+///
+class StripedImageEncoder final {
+ public:
+  enum class Format {
+    kPNG,
+    kRaw,
+  };
+
+  struct Options {
+    Format format = Format::kPNG;
+    /// The pixel format of `Format::kRaw` output.
+    SkColorType color_type = kRGBA_8888_SkColorType;
+    SkAlphaType alpha_type = kPremul_SkAlphaType;
+    /// The zlib level of PNG compression, from 0 for the fastest encode to 9
+    /// for the smallest output. Level 0 also skips the row filters.
+    int compression_level = 6;
+    /// The number of rows that a single task encodes, or 0 to pick enough
+    /// rows for about `kDefaultStripeBytes` of pixels.
+    int rows_per_stripe = 0;
+  };
+
+  static constexpr size_t kDefaultStripeBytes = 512 * 1024;
+
+  /// Called with consecutive pieces of the output, from one thread at a time.
+  /// It must not block on the encoder.
+  using ChunkCallback = std::function<void(sk_sp<SkData> chunk)>;
+
+  /// Called once after the last chunk, or with false if the image could not
+  /// be encoded. Chunks that were delivered before a failure are not valid
+  /// output on their own.
+  using DoneCallback = std::function<void(bool success)>;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether a PNG of the |image| keeps all of its precision and
+  ///             color space, which is the case for 8 bit RGB images that
+  ///             are sRGB or untagged. Other images should be encoded with
+  ///             `SkPngEncoder`.
+  ///
+  static bool CanEncodePNG(const SkImageInfo& image);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Encodes the |raster_image|, whose pixels must be readable
+  ///             with `peekPixels`.
+  ///
+  /// @param[in]  runner     The runner that stripes are encoded on. If null,
+  ///                        the image is encoded on the calling thread before
+  ///                        this returns.
+  ///
+  static void Encode(sk_sp<SkImage> raster_image,
+                     const Options& options,
+                     std::shared_ptr<fml::BasicTaskRunner> runner,
+                     ChunkCallback on_chunk,
+                     DoneCallback on_done);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Encodes the |raster_image| like `Encode`, and calls
+  ///             |on_encoded| with all of the output in one buffer, or with
+  ///             nullptr if the image could not be encoded.
+  ///
+  static void EncodeToData(sk_sp<SkImage> raster_image,
+                           const Options& options,
+                           std::shared_ptr<fml::BasicTaskRunner> runner,
+                           std::function<void(sk_sp<SkData>)> on_encoded);
+
+  ~StripedImageEncoder();
+
+ private:
+  struct Stripe {
+    bool done = false;
+    sk_sp<SkData> data;
+    // The Adler-32 checksum and length of the uncompressed PNG rows.
+    uint32_t adler = 1;
+    size_t raw_length = 0;
+  };
+
+  const sk_sp<SkImage> image_;
+  const Options options_;
+  const ChunkCallback on_chunk_;
+  const DoneCallback on_done_;
+  SkPixmap pixmap_;
+  int rows_per_stripe_ = 0;
+  // The bytes per pixel of the PNG rows, 3 for opaque images and 4 otherwise.
+  int png_pixel_bytes_ = 4;
+
+  std::mutex mutex_;
+  std::vector<Stripe> stripes_;
+  size_t next_stripe_to_deliver_ = 0;
+  size_t pending_stripes_ = 0;
+  bool failed_ = false;
+  uint32_t adler_ = 1;
+
+  StripedImageEncoder(sk_sp<SkImage> image,
+                      const Options& options,
+                      ChunkCallback on_chunk,
+                      DoneCallback on_done);
+
+  bool Prepare();
+
+  sk_sp<SkData> EncodePNGHeader() const;
+
+  sk_sp<SkData> EncodePNGTrailer(uint32_t adler) const;
+
+  void EncodeStripe(size_t index);
+
+  bool EncodePNGStripe(int first_row, int end_row, bool last, Stripe& stripe);
+
+  bool EncodeRawStripe(int first_row, int end_row, Stripe& stripe);
+
+  // Delivers the stripes that are done in order, and finishes the encode once
+  // all of them are.
+  void OnStripeDoneLocked(size_t index, Stripe stripe, bool success);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(StripedImageEncoder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_STRIPED_IMAGE_ENCODER_H_
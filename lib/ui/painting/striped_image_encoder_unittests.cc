@@ -0,0 +1,210 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/striped_image_encoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+sk_sp<SkImage> MakeTestImage(int width, int height, bool opaque) {
+  auto surface = SkSurface::MakeRaster(SkImageInfo::MakeN32(
+      width, height, opaque ? kOpaque_SkAlphaType : kPremul_SkAlphaType));
+  SkCanvas* canvas = surface->getCanvas();
+  canvas->clear(opaque ? SK_ColorWHITE : SK_ColorTRANSPARENT);
+  SkPaint paint;
+  for (int i = 0; i < 16; i++) {
+    paint.setColor(SkColorSetARGB(opaque ? 0xFF : 0x40 + i * 8, i * 16,
+                                  255 - i * 16, (i * 37) % 256));
+    canvas->drawCircle(width * (i % 4) / 4.0f, height * (i / 4) / 4.0f,
+                       width / 3.0f, paint);
+  }
+  return surface->makeImageSnapshot();
+}
+
+std::vector<uint8_t> ReadUnpremulRGBA(const sk_sp<SkImage>& image) {
+  SkImageInfo info = SkImageInfo::Make(image->dimensions(),
+                                       kRGBA_8888_SkColorType,
+                                       kUnpremul_SkAlphaType);
+  std::vector<uint8_t> pixels(info.computeMinByteSize());
+  EXPECT_TRUE(image->readPixels(info, pixels.data(), info.minRowBytes(), 0, 0));
+  return pixels;
+}
+
+sk_sp<SkData> EncodeToDataSync(
+    const sk_sp<SkImage>& image,
+    const StripedImageEncoder::Options& options,
+    const std::shared_ptr<fml::BasicTaskRunner>& runner) {
+  fml::AutoResetWaitableEvent latch;
+  sk_sp<SkData> result;
+  StripedImageEncoder::EncodeToData(image, options, runner,
+                                    [&](sk_sp<SkData> encoded) {
+                                      result = std::move(encoded);
+                                      latch.Signal();
+                                    });
+  latch.Wait();
+  return result;
+}
+
+}  // namespace
+
+TEST(StripedImageEncoderTest, EncodesPNGInParallelStripes) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  for (bool opaque : {false, true}) {
+    auto image = MakeTestImage(123, 77, opaque);
+    StripedImageEncoder::Options options;
+    options.rows_per_stripe = 7;
+
+    auto png = EncodeToDataSync(image, options, loop->GetTaskRunner());
+    ASSERT_TRUE(png);
+
+    auto decoded = SkImage::MakeFromEncoded(png);
+    ASSERT_TRUE(decoded);
+    ASSERT_EQ(decoded->dimensions(), image->dimensions());
+    EXPECT_EQ(ReadUnpremulRGBA(decoded), ReadUnpremulRGBA(image));
+  }
+}
+
+TEST(StripedImageEncoderTest, OutputDoesNotDependOnTheRunner) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto image = MakeTestImage(64, 200, false);
+  StripedImageEncoder::Options options;
+  options.rows_per_stripe = 16;
+
+  auto parallel = EncodeToDataSync(image, options, loop->GetTaskRunner());
+  auto inline_encoded = EncodeToDataSync(image, options, nullptr);
+  ASSERT_TRUE(parallel);
+  ASSERT_TRUE(inline_encoded);
+  EXPECT_TRUE(parallel->equals(inline_encoded.get()));
+}
+
+TEST(StripedImageEncoderTest, StreamsChunksInOrder) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto image = MakeTestImage(64, 200, false);
+  StripedImageEncoder::Options options;
+  options.rows_per_stripe = 16;
+
+  std::vector<sk_sp<SkData>> chunks;
+  fml::AutoResetWaitableEvent latch;
+  bool succeeded = false;
+  StripedImageEncoder::Encode(
+      image, options, loop->GetTaskRunner(),
+      [&](sk_sp<SkData> chunk) { chunks.push_back(std::move(chunk)); },
+      [&](bool success) {
+        succeeded = success;
+        latch.Signal();
+      });
+  latch.Wait();
+  ASSERT_TRUE(succeeded);
+
+  // The header, one chunk per stripe and the trailer.
+  ASSERT_EQ(chunks.size(), 2u + 13u);
+  std::vector<uint8_t> streamed;
+  for (const auto& chunk : chunks) {
+    auto bytes = static_cast<const uint8_t*>(chunk->data());
+    streamed.insert(streamed.end(), bytes, bytes + chunk->size());
+  }
+  auto buffered = EncodeToDataSync(image, options, nullptr);
+  ASSERT_EQ(streamed.size(), buffered->size());
+  EXPECT_EQ(memcmp(streamed.data(), buffered->data(), streamed.size()), 0);
+}
+
+TEST(StripedImageEncoderTest, CompressionLevelTradesSizeForSpeed) {
+  auto image = MakeTestImage(256, 256, true);
+  StripedImageEncoder::Options fastest;
+  fastest.compression_level = 0;
+  StripedImageEncoder::Options smallest;
+  smallest.compression_level = 9;
+
+  auto stored = EncodeToDataSync(image, fastest, nullptr);
+  auto compressed = EncodeToDataSync(image, smallest, nullptr);
+  ASSERT_TRUE(stored);
+  ASSERT_TRUE(compressed);
+  EXPECT_LT(compressed->size(), stored->size());
+
+  auto decoded = SkImage::MakeFromEncoded(stored);
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(ReadUnpremulRGBA(decoded), ReadUnpremulRGBA(image));
+}
+
+TEST(StripedImageEncoderTest, EncodesRawPixels) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto image = MakeTestImage(100, 50, false);
+  StripedImageEncoder::Options options;
+  options.format = StripedImageEncoder::Format::kRaw;
+  options.color_type = kRGBA_8888_SkColorType;
+  options.alpha_type = kUnpremul_SkAlphaType;
+  options.rows_per_stripe = 9;
+
+  auto raw = EncodeToDataSync(image, options, loop->GetTaskRunner());
+  ASSERT_TRUE(raw);
+  auto expected = ReadUnpremulRGBA(image);
+  ASSERT_EQ(raw->size(), expected.size());
+  EXPECT_EQ(memcmp(raw->data(), expected.data(), expected.size()), 0);
+}
+
+TEST(StripedImageEncoderTest, ReportsFailureForImagesWithoutPixels) {
+  bool done = false;
+  bool succeeded = true;
+  StripedImageEncoder::Encode(
+      nullptr, {}, nullptr, [](sk_sp<SkData> chunk) { FAIL(); },
+      [&](bool success) {
+        done = true;
+        succeeded = success;
+      });
+  EXPECT_TRUE(done);
+  EXPECT_FALSE(succeeded);
+}
+
+TEST(StripedImageEncoderTest, OnlyEncodesPNGsOf8BitSRGBImages) {
+  EXPECT_TRUE(StripedImageEncoder::CanEncodePNG(SkImageInfo::MakeN32Premul(
+      10, 10, SkColorSpace::MakeSRGB())));
+  EXPECT_TRUE(
+      StripedImageEncoder::CanEncodePNG(SkImageInfo::MakeN32Premul(10, 10)));
+  EXPECT_FALSE(StripedImageEncoder::CanEncodePNG(SkImageInfo::MakeN32Premul(
+      10, 10,
+      SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB,
+                            SkNamedGamut::kDisplayP3))));
+  EXPECT_FALSE(StripedImageEncoder::CanEncodePNG(
+      SkImageInfo::Make(10, 10, kRGBA_F16_SkColorType, kPremul_SkAlphaType)));
+  EXPECT_FALSE(StripedImageEncoder::CanEncodePNG(SkImageInfo::Make(
+      10, 10, kR16G16B16A16_unorm_SkColorType, kPremul_SkAlphaType)));
+
+  // sRGB images are tagged with an sRGB chunk, like SkPngEncoder does.
+  SkBitmap bitmap;
+  bitmap.allocPixels(
+      SkImageInfo::MakeN32Premul(10, 10, SkColorSpace::MakeSRGB()));
+  bitmap.eraseColor(SK_ColorBLUE);
+  auto png = EncodeToDataSync(SkImage::MakeFromBitmap(bitmap), {}, nullptr);
+  ASSERT_TRUE(png);
+  const auto* bytes = static_cast<const char*>(png->data());
+  const char kSRGBChunk[] = "sRGB";
+  EXPECT_NE(std::search(bytes, bytes + png->size(), kSRGBChunk, kSRGBChunk + 4),
+            bytes + png->size());
+  EXPECT_TRUE(SkImage::MakeFromEncoded(png));
+
+  // Images that would lose their color space are rejected.
+  bitmap.allocPixels(SkImageInfo::MakeN32Premul(
+      10, 10,
+      SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB,
+                            SkNamedGamut::kDisplayP3)));
+  bitmap.eraseColor(SK_ColorBLUE);
+  EXPECT_FALSE(EncodeToDataSync(SkImage::MakeFromBitmap(bitmap), {}, nullptr));
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -14,8 +14,14 @@ SemanticsNode::SemanticsNode() = default;
 
 SemanticsNode::SemanticsNode(const SemanticsNode& other) = default;
 
+SemanticsNode::SemanticsNode(SemanticsNode&& other) = default;
+
 SemanticsNode::~SemanticsNode() = default;
 
+SemanticsNode& SemanticsNode::operator=(const SemanticsNode& other) = default;
+
+SemanticsNode& SemanticsNode::operator=(SemanticsNode&& other) = default;
+
 bool SemanticsNode::HasAction(SemanticsAction action) const {
   return (actions & static_cast<int32_t>(action)) != 0;
 }
@@ -0,0 +1,722 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/semantics/semantics_update_codec.h"
+
+#include <cstring>
+#include <string_view>
+#include <unordered_set>
+
+namespace flutter {
+
+namespace {
+
+// The fields of a `SemanticsNode` that can be present in an encoded node.
+enum SemanticsField : uint32_t {
+  kFlags = 1u << 0,
+  kActions = 1u << 1,
+  kMaxValueLength = 1u << 2,
+  kCurrentValueLength = 1u << 3,
+  kTextSelectionBase = 1u << 4,
+  kTextSelectionExtent = 1u << 5,
+  kPlatformViewId = 1u << 6,
+  kScrollChildren = 1u << 7,
+  kScrollIndex = 1u << 8,
+  kTextDirection = 1u << 9,
+  kScrollPosition = 1u << 10,
+  kScrollExtentMax = 1u << 11,
+  kScrollExtentMin = 1u << 12,
+  kElevation = 1u << 13,
+  kThickness = 1u << 14,
+  kLabel = 1u << 15,
+  kHint = 1u << 16,
+  kValue = 1u << 17,
+  kIncreasedValue = 1u << 18,
+  kDecreasedValue = 1u << 19,
+  kTooltip = 1u << 20,
+  kLabelAttributes = 1u << 21,
+  kHintAttributes = 1u << 22,
+  kValueAttributes = 1u << 23,
+  kIncreasedValueAttributes = 1u << 24,
+  kDecreasedValueAttributes = 1u << 25,
+  kChildrenInTraversalOrder = 1u << 26,
+  kChildrenInHitTestOrder = 1u << 27,
+  kCustomAccessibilityActions = 1u << 28,
+  kRect = 1u << 29,
+  kTransform = 1u << 30,
+};
+
+template <typename T>
+struct FieldDescriptor {
+  SemanticsField field;
+  T SemanticsNode::*member;
+};
+
+// The present fields of a node are written in the order of these tables,
+// followed by the rect and the transform.
+constexpr FieldDescriptor<int32_t> kInt32Fields[] = {
+    {kFlags, &SemanticsNode::flags},
+    {kActions, &SemanticsNode::actions},
+    {kMaxValueLength, &SemanticsNode::maxValueLength},
+    {kCurrentValueLength, &SemanticsNode::currentValueLength},
+    {kTextSelectionBase, &SemanticsNode::textSelectionBase},
+    {kTextSelectionExtent, &SemanticsNode::textSelectionExtent},
+    {kPlatformViewId, &SemanticsNode::platformViewId},
+    {kScrollChildren, &SemanticsNode::scrollChildren},
+    {kScrollIndex, &SemanticsNode::scrollIndex},
+    {kTextDirection, &SemanticsNode::textDirection},
+};
+
+constexpr FieldDescriptor<double> kDoubleFields[] = {
+    {kScrollPosition, &SemanticsNode::scrollPosition},
+    {kScrollExtentMax, &SemanticsNode::scrollExtentMax},
+    {kScrollExtentMin, &SemanticsNode::scrollExtentMin},
+    {kElevation, &SemanticsNode::elevation},
+    {kThickness, &SemanticsNode::thickness},
+};
+
+constexpr FieldDescriptor<std::string> kStringFields[] = {
+    {kLabel, &SemanticsNode::label},
+    {kHint, &SemanticsNode::hint},
+    {kValue, &SemanticsNode::value},
+    {kIncreasedValue, &SemanticsNode::increasedValue},
+    {kDecreasedValue, &SemanticsNode::decreasedValue},
+    {kTooltip, &SemanticsNode::tooltip},
+};
+
+constexpr FieldDescriptor<StringAttributes> kAttributeFields[] = {
+    {kLabelAttributes, &SemanticsNode::labelAttributes},
+    {kHintAttributes, &SemanticsNode::hintAttributes},
+    {kValueAttributes, &SemanticsNode::valueAttributes},
+    {kIncreasedValueAttributes, &SemanticsNode::increasedValueAttributes},
+    {kDecreasedValueAttributes, &SemanticsNode::decreasedValueAttributes},
+};
+
+constexpr FieldDescriptor<std::vector<int32_t>> kInt32ListFields[] = {
+    {kChildrenInTraversalOrder, &SemanticsNode::childrenInTraversalOrder},
+    {kChildrenInHitTestOrder, &SemanticsNode::childrenInHitTestOrder},
+    {kCustomAccessibilityActions, &SemanticsNode::customAccessibilityActions},
+};
+
+// Set in the header when the decoder must discard its string table before
+// reading the update.
+constexpr uint8_t kResetStringsFlag = 1u << 0;
+
+class Writer {
+ public:
+  explicit Writer(std::vector<uint8_t>& buffer) : buffer_(buffer) {}
+
+  void WriteByte(uint8_t value) { buffer_.push_back(value); }
+
+  void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      buffer_.push_back(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    buffer_.push_back(static_cast<uint8_t>(value));
+  }
+
+  // Zig-zag encoding keeps small negative values such as -1 small.
+  void WriteSigned(int32_t value) {
+    WriteVarint((static_cast<uint32_t>(value) << 1) ^
+                static_cast<uint32_t>(value >> 31));
+  }
+
+  void WriteBytes(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    buffer_.insert(buffer_.end(), bytes, bytes + size);
+  }
+
+ private:
+  std::vector<uint8_t>& buffer_;
+};
+
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  bool ReadByte(uint8_t* value) {
+    if (offset_ >= size_) {
+      return false;
+    }
+    *value = data_[offset_++];
+    return true;
+  }
+
+  bool ReadVarint(uint64_t* value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte;
+      if (!ReadByte(&byte)) {
+        return false;
+      }
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        *value = result;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadSigned(int32_t* value) {
+    uint64_t raw;
+    if (!ReadVarint(&raw) || raw > UINT32_MAX) {
+      return false;
+    }
+    const auto encoded = static_cast<uint32_t>(raw);
+    *value = static_cast<int32_t>((encoded >> 1) ^ (~(encoded & 1) + 1));
+    return true;
+  }
+
+  bool ReadBytes(void* destination, size_t size) {
+    if (size > size_ - offset_) {
+      return false;
+    }
+    std::memcpy(destination, data_ + offset_, size);
+    offset_ += size;
+    return true;
+  }
+
+  // The view points into the buffer being read.
+  bool ReadStringView(size_t size, std::string_view* value) {
+    if (size > size_ - offset_) {
+      return false;
+    }
+    *value = std::string_view(reinterpret_cast<const char*>(data_ + offset_),
+                              size);
+    offset_ += size;
+    return true;
+  }
+
+  bool IsAtEnd() const { return offset_ == size_; }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+// NaN is the default for the scroll fields, so doubles are compared by their
+// bit patterns.
+bool BitwiseEqual(double a, double b) {
+  return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+bool AttributesEqual(const StringAttributes& a, const StringAttributes& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    const StringAttribute& lhs = *a[i];
+    const StringAttribute& rhs = *b[i];
+    if (lhs.type != rhs.type || lhs.start != rhs.start || lhs.end != rhs.end) {
+      return false;
+    }
+    if (lhs.type == StringAttributeType::kLocale &&
+        static_cast<const LocaleStringAttribute&>(lhs).locale !=
+            static_cast<const LocaleStringAttribute&>(rhs).locale) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TransformsEqual(const SkM44& a, const SkM44& b) {
+  SkScalar lhs[16];
+  SkScalar rhs[16];
+  a.getColMajor(lhs);
+  b.getColMajor(rhs);
+  return std::memcmp(lhs, rhs, sizeof(lhs)) == 0;
+}
+
+// Forgets the detached nodes, the former children of the nodes of an update
+// whose children changed, that were neither part of the update nor listed by
+// one of its nodes. Their descendants are forgotten with them. The encoder and
+// the decoder make the same decision from the same retained state.
+void RemoveDetachedNodes(std::unordered_map<int32_t, SemanticsNode>& nodes,
+                         std::vector<int32_t>& detached,
+                         const std::unordered_set<int32_t>& attached) {
+  while (!detached.empty()) {
+    const int32_t id = detached.back();
+    detached.pop_back();
+    if (attached.count(id) != 0) {
+      continue;
+    }
+    auto found = nodes.find(id);
+    if (found == nodes.end()) {
+      continue;
+    }
+    const std::vector<int32_t>& children =
+        found->second.childrenInTraversalOrder;
+    detached.insert(detached.end(), children.begin(), children.end());
+    nodes.erase(found);
+  }
+}
+
+uint32_t ChangedFields(const SemanticsNode& old_node,
+                       const SemanticsNode& new_node) {
+  uint32_t fields = 0;
+  for (const auto& descriptor : kInt32Fields) {
+    if (old_node.*descriptor.member != new_node.*descriptor.member) {
+      fields |= descriptor.field;
+    }
+  }
+  for (const auto& descriptor : kDoubleFields) {
+    if (!BitwiseEqual(old_node.*descriptor.member,
+                      new_node.*descriptor.member)) {
+      fields |= descriptor.field;
+    }
+  }
+  for (const auto& descriptor : kStringFields) {
+    if (old_node.*descriptor.member != new_node.*descriptor.member) {
+      fields |= descriptor.field;
+    }
+  }
+  for (const auto& descriptor : kAttributeFields) {
+    if (!AttributesEqual(old_node.*descriptor.member,
+                         new_node.*descriptor.member)) {
+      fields |= descriptor.field;
+    }
+  }
+  for (const auto& descriptor : kInt32ListFields) {
+    if (old_node.*descriptor.member != new_node.*descriptor.member) {
+      fields |= descriptor.field;
+    }
+  }
+  if (std::memcmp(&old_node.rect, &new_node.rect, sizeof(SkRect)) != 0) {
+    fields |= kRect;
+  }
+  if (!TransformsEqual(old_node.transform, new_node.transform)) {
+    fields |= kTransform;
+  }
+  return fields;
+}
+
+class NodeEncoder {
+ public:
+  NodeEncoder(Writer& writer,
+              std::unordered_map<std::string, uint32_t>& strings)
+      : writer_(writer), strings_(strings) {}
+
+  // An even reference is the index of an interned string. An odd reference is
+  // followed by a new string which is interned at the end of the table.
+  void WriteString(const std::string& value) {
+    auto found = strings_.find(value);
+    if (found != strings_.end()) {
+      writer_.WriteVarint(static_cast<uint64_t>(found->second) << 1);
+      return;
+    }
+    strings_.emplace(value, static_cast<uint32_t>(strings_.size()));
+    writer_.WriteVarint(1u);
+    writer_.WriteVarint(value.size());
+    writer_.WriteBytes(value.data(), value.size());
+  }
+
+  void WriteAttributes(const StringAttributes& attributes) {
+    writer_.WriteVarint(attributes.size());
+    for (const auto& attribute : attributes) {
+      writer_.WriteVarint(static_cast<uint32_t>(attribute->type));
+      writer_.WriteSigned(attribute->start);
+      writer_.WriteSigned(attribute->end);
+      if (attribute->type == StringAttributeType::kLocale) {
+        WriteString(
+            static_cast<const LocaleStringAttribute&>(*attribute).locale);
+      }
+    }
+  }
+
+  void WriteInt32List(const std::vector<int32_t>& list) {
+    writer_.WriteVarint(list.size());
+    for (int32_t value : list) {
+      writer_.WriteSigned(value);
+    }
+  }
+
+  void WriteNode(const SemanticsNode& node, uint32_t fields) {
+    writer_.WriteSigned(node.id);
+    writer_.WriteVarint(fields);
+    for (const auto& descriptor : kInt32Fields) {
+      if (fields & descriptor.field) {
+        writer_.WriteSigned(node.*descriptor.member);
+      }
+    }
+    for (const auto& descriptor : kDoubleFields) {
+      if (fields & descriptor.field) {
+        writer_.WriteBytes(&(node.*descriptor.member), sizeof(double));
+      }
+    }
+    for (const auto& descriptor : kStringFields) {
+      if (fields & descriptor.field) {
+        WriteString(node.*descriptor.member);
+      }
+    }
+    for (const auto& descriptor : kAttributeFields) {
+      if (fields & descriptor.field) {
+        WriteAttributes(node.*descriptor.member);
+      }
+    }
+    for (const auto& descriptor : kInt32ListFields) {
+      if (fields & descriptor.field) {
+        WriteInt32List(node.*descriptor.member);
+      }
+    }
+    if (fields & kRect) {
+      writer_.WriteBytes(&node.rect, sizeof(SkRect));
+    }
+    if (fields & kTransform) {
+      SkScalar matrix[16];
+      node.transform.getColMajor(matrix);
+      writer_.WriteBytes(matrix, sizeof(matrix));
+    }
+  }
+
+ private:
+  Writer& writer_;
+  std::unordered_map<std::string, uint32_t>& strings_;
+};
+
+class NodeDecoder {
+ public:
+  NodeDecoder(Reader& reader, std::deque<std::string>& strings)
+      : reader_(reader), strings_(strings) {}
+
+  // The view points into the string table, which new strings are appended
+  // to.
+  bool ReadStringView(std::string_view* value) {
+    uint64_t reference;
+    if (!reader_.ReadVarint(&reference)) {
+      return false;
+    }
+    if ((reference & 1) == 0) {
+      const uint64_t index = reference >> 1;
+      if (index >= strings_.size()) {
+        return false;
+      }
+      *value = strings_[index];
+      return true;
+    }
+    uint64_t size;
+    std::string_view bytes;
+    if (!reader_.ReadVarint(&size) || !reader_.ReadStringView(size, &bytes)) {
+      return false;
+    }
+    *value = strings_.emplace_back(bytes);
+    return true;
+  }
+
+  bool ReadString(std::string* value) {
+    std::string_view view;
+    if (!ReadStringView(&view)) {
+      return false;
+    }
+    value->assign(view.data(), view.size());
+    return true;
+  }
+
+  bool ReadAttributes(StringAttributes* attributes) {
+    uint64_t count;
+    if (!reader_.ReadVarint(&count)) {
+      return false;
+    }
+    attributes->clear();
+    for (uint64_t i = 0; i < count; i++) {
+      uint64_t type;
+      int32_t start;
+      int32_t end;
+      if (!reader_.ReadVarint(&type) || !reader_.ReadSigned(&start) ||
+          !reader_.ReadSigned(&end)) {
+        return false;
+      }
+      StringAttributePtr attribute;
+      switch (static_cast<StringAttributeType>(type)) {
+        case StringAttributeType::kSpellOut:
+          attribute = std::make_shared<SpellOutStringAttribute>();
+          break;
+        case StringAttributeType::kLocale: {
+          auto locale = std::make_shared<LocaleStringAttribute>();
+          if (!ReadString(&locale->locale)) {
+            return false;
+          }
+          attribute = std::move(locale);
+          break;
+        }
+        default:
+          return false;
+      }
+      attribute->type = static_cast<StringAttributeType>(type);
+      attribute->start = start;
+      attribute->end = end;
+      attributes->push_back(std::move(attribute));
+    }
+    return true;
+  }
+
+  bool ReadInt32List(std::vector<int32_t>* list) {
+    uint64_t count;
+    if (!reader_.ReadVarint(&count)) {
+      return false;
+    }
+    list->clear();
+    for (uint64_t i = 0; i < count; i++) {
+      int32_t value;
+      if (!reader_.ReadSigned(&value)) {
+        return false;
+      }
+      list->push_back(value);
+    }
+    return true;
+  }
+
+  bool ReadFields(uint32_t fields, SemanticsNode& node) {
+    for (const auto& descriptor : kInt32Fields) {
+      if ((fields & descriptor.field) &&
+          !reader_.ReadSigned(&(node.*descriptor.member))) {
+        return false;
+      }
+    }
+    for (const auto& descriptor : kDoubleFields) {
+      if ((fields & descriptor.field) &&
+          !reader_.ReadBytes(&(node.*descriptor.member), sizeof(double))) {
+        return false;
+      }
+    }
+    for (const auto& descriptor : kStringFields) {
+      if ((fields & descriptor.field) &&
+          !ReadString(&(node.*descriptor.member))) {
+        return false;
+      }
+    }
+    for (const auto& descriptor : kAttributeFields) {
+      if ((fields & descriptor.field) &&
+          !ReadAttributes(&(node.*descriptor.member))) {
+        return false;
+      }
+    }
+    for (const auto& descriptor : kInt32ListFields) {
+      if ((fields & descriptor.field) &&
+          !ReadInt32List(&(node.*descriptor.member))) {
+        return false;
+      }
+    }
+    if ((fields & kRect) && !reader_.ReadBytes(&node.rect, sizeof(SkRect))) {
+      return false;
+    }
+    if (fields & kTransform) {
+      SkScalar matrix[16];
+      if (!reader_.ReadBytes(matrix, sizeof(matrix))) {
+        return false;
+      }
+      node.transform = SkM44::ColMajor(matrix);
+    }
+    return true;
+  }
+
+ private:
+  Reader& reader_;
+  std::deque<std::string>& strings_;
+};
+
+}  // namespace
+
+SemanticsUpdateEncoder::SemanticsUpdateEncoder() = default;
+
+SemanticsUpdateEncoder::~SemanticsUpdateEncoder() = default;
+
+void SemanticsUpdateEncoder::Encode(
+    const SemanticsNodeUpdates& nodes,
+    const CustomAccessibilityActionUpdates& actions,
+    std::vector<uint8_t>& buffer) {
+  buffer.clear();
+  Writer writer(buffer);
+  writer.WriteByte(kSemanticsUpdateCodecVersion);
+
+  uint8_t flags = 0;
+  if (strings_.size() > kMaxInternedStrings) {
+    strings_.clear();
+    flags |= kResetStringsFlag;
+  }
+  writer.WriteByte(flags);
+
+  // New nodes are always written, even when all of their fields have the
+  // default values, so that the decoder learns about them.
+  static const SemanticsNode kDefaultNode;
+  std::vector<int32_t> detached;
+  std::unordered_set<int32_t> attached;
+  changed_nodes_.clear();
+  for (const auto& [id, node] : nodes) {
+    auto found = nodes_.find(id);
+    if (found == nodes_.end()) {
+      const uint32_t fields = ChangedFields(kDefaultNode, node);
+      attached.insert(node.childrenInTraversalOrder.begin(),
+                      node.childrenInTraversalOrder.end());
+      changed_nodes_.emplace_back(&node, fields);
+      nodes_.emplace(id, node);
+      continue;
+    }
+    const uint32_t fields = ChangedFields(found->second, node);
+    if (fields == 0) {
+      continue;
+    }
+    if (fields & kChildrenInTraversalOrder) {
+      const std::vector<int32_t>& old_children =
+          found->second.childrenInTraversalOrder;
+      detached.insert(detached.end(), old_children.begin(),
+                      old_children.end());
+      attached.insert(node.childrenInTraversalOrder.begin(),
+                      node.childrenInTraversalOrder.end());
+    }
+    changed_nodes_.emplace_back(&node, fields);
+    found->second = node;
+  }
+
+  NodeEncoder encoder(writer, strings_);
+  writer.WriteVarint(changed_nodes_.size());
+  for (const auto& [node, fields] : changed_nodes_) {
+    encoder.WriteNode(*node, fields);
+    attached.insert(node->id);
+  }
+  changed_nodes_.clear();
+  RemoveDetachedNodes(nodes_, detached, attached);
+
+  writer.WriteVarint(actions.size());
+  for (const auto& [id, action] : actions) {
+    writer.WriteSigned(action.id);
+    writer.WriteSigned(action.overrideId);
+    encoder.WriteString(action.label);
+    encoder.WriteString(action.hint);
+  }
+}
+
+void SemanticsUpdateEncoder::Reset() {
+  nodes_.clear();
+  strings_.clear();
+}
+
+SemanticsUpdateDecoder::SemanticsUpdateDecoder() = default;
+
+SemanticsUpdateDecoder::~SemanticsUpdateDecoder() = default;
+
+bool SemanticsUpdateDecoder::Decode(const uint8_t* data,
+                                    size_t size,
+                                    const NodeVisitor& node_visitor,
+                                    const ActionVisitor& action_visitor) {
+  Reader reader(data, size);
+  uint8_t version;
+  uint8_t flags;
+  if (!reader.ReadByte(&version) ||
+      version != kSemanticsUpdateCodecVersion || !reader.ReadByte(&flags)) {
+    return false;
+  }
+  if (flags & kResetStringsFlag) {
+    strings_.clear();
+  }
+
+  NodeDecoder decoder(reader, strings_);
+  uint64_t node_count;
+  if (!reader.ReadVarint(&node_count)) {
+    return false;
+  }
+  std::vector<int32_t> detached;
+  std::unordered_set<int32_t> attached;
+  for (uint64_t i = 0; i < node_count; i++) {
+    int32_t id;
+    uint64_t fields;
+    if (!reader.ReadSigned(&id) || !reader.ReadVarint(&fields) ||
+        fields > UINT32_MAX) {
+      return false;
+    }
+    SemanticsNode& node = nodes_[id];
+    node.id = id;
+    if (fields & kChildrenInTraversalOrder) {
+      detached.insert(detached.end(), node.childrenInTraversalOrder.begin(),
+                      node.childrenInTraversalOrder.end());
+    }
+    if (!decoder.ReadFields(static_cast<uint32_t>(fields), node)) {
+      return false;
+    }
+    if (fields & kChildrenInTraversalOrder) {
+      attached.insert(node.childrenInTraversalOrder.begin(),
+                      node.childrenInTraversalOrder.end());
+    }
+    attached.insert(id);
+    if (node_visitor) {
+      node_visitor(node);
+    }
+  }
+  // The nodes of the update are attached, so the nodes already visited stay
+  // valid.
+  RemoveDetachedNodes(nodes_, detached, attached);
+
+  uint64_t action_count;
+  if (!reader.ReadVarint(&action_count)) {
+    return false;
+  }
+  for (uint64_t i = 0; i < action_count; i++) {
+    CustomAccessibilityAction action;
+    if (!reader.ReadSigned(&action.id) ||
+        !reader.ReadSigned(&action.overrideId) ||
+        !decoder.ReadString(&action.label) ||
+        !decoder.ReadString(&action.hint)) {
+      return false;
+    }
+    if (action_visitor) {
+      action_visitor(action);
+    }
+  }
+  return reader.IsAtEnd();
+}
+
+void SemanticsUpdateDecoder::Reset() {
+  nodes_.clear();
+  strings_.clear();
+}
+
+const SemanticsNode* SemanticsUpdateDecoder::GetNode(int32_t id) const {
+  auto found = nodes_.find(id);
+  return found == nodes_.end() ? nullptr : &found->second;
+}
+
+RetainedSemanticsTree::RetainedSemanticsTree() = default;
+
+RetainedSemanticsTree::~RetainedSemanticsTree() = default;
+
+void RetainedSemanticsTree::Update(SemanticsNodeUpdates& nodes,
+                                   std::vector<const SemanticsNode*>& changed) {
+  changed.clear();
+  std::vector<int32_t> detached;
+  std::unordered_set<int32_t> attached;
+  for (auto& [id, node] : nodes) {
+    attached.insert(id);
+    auto [found, inserted] = nodes_.try_emplace(id);
+    if (!inserted) {
+      const uint32_t fields = ChangedFields(found->second, node);
+      if (fields == 0) {
+        continue;
+      }
+      if (fields & kChildrenInTraversalOrder) {
+        const std::vector<int32_t>& old_children =
+            found->second.childrenInTraversalOrder;
+        detached.insert(detached.end(), old_children.begin(),
+                        old_children.end());
+      }
+    }
+    attached.insert(node.childrenInTraversalOrder.begin(),
+                    node.childrenInTraversalOrder.end());
+    found->second = std::move(node);
+    changed.push_back(&found->second);
+  }
+  RemoveDetachedNodes(nodes_, detached, attached);
+}
+
+void RetainedSemanticsTree::Reset() {
+  nodes_.clear();
+}
+
+const SemanticsNode* RetainedSemanticsTree::GetNode(int32_t id) const {
+  auto found = nodes_.find(id);
+  return found == nodes_.end() ? nullptr : &found->second;
+}
+
+}  // namespace flutter
@@ -0,0 +1,185 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_SEMANTICS_SEMANTICS_UPDATE_CODEC_H_
+#define FLUTTER_LIB_UI_SEMANTICS_SEMANTICS_UPDATE_CODEC_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/semantics/custom_accessibility_action.h"
+#include "flutter/lib/ui/semantics/semantics_node.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// The version of the binary semantics update format. Encoders and decoders
+/// only interoperate when their versions match.
+///
+constexpr uint8_t kSemanticsUpdateCodecVersion = 1u;
+
+//------------------------------------------------------------------------------
+/// @brief      Encodes semantics updates into a compact binary format that only
+///             carries the fields of each node that changed since the node was
+///             last encoded. Nodes that did not change at all are left out.
+///
+///             Nodes that were detached from the tree by an update, because
+///             the parent that listed them no longer does and no other node of
+///             the update lists them, are forgotten together with their
+///             descendants by both the encoder and the decoder.
+///
+///             Strings are interned: the first time a string is encoded it is
+///             written in full and assigned the next index of a table that is
+///             shared with the decoder across updates. Later occurrences of
+///             the same string are written as that index.
+///
+///             The buffers produced by an encoder must be decoded, in order,
+///             by a single `SemanticsUpdateDecoder`.
+///
+class SemanticsUpdateEncoder {
+ public:
+  /// When the string table grows past this many entries it is discarded by
+  /// both sides and rebuilt from scratch.
+  static constexpr size_t kMaxInternedStrings = 1u << 16;
+
+  SemanticsUpdateEncoder();
+
+  ~SemanticsUpdateEncoder();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Encode an update into |buffer|, replacing its contents.
+  ///
+  void Encode(const SemanticsNodeUpdates& nodes,
+              const CustomAccessibilityActionUpdates& actions,
+              std::vector<uint8_t>& buffer);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forget every node and string encoded so far. The decoder of
+  ///             the updates must be reset at the same time.
+  ///
+  void Reset();
+
+  /// The number of strings currently in the interning table.
+  size_t GetInternedStringCount() const { return strings_.size(); }
+
+  /// The number of nodes currently retained to compute deltas against.
+  size_t GetNodeCount() const { return nodes_.size(); }
+
+ private:
+  std::unordered_map<int32_t, SemanticsNode> nodes_;
+  std::unordered_map<std::string, uint32_t> strings_;
+  // The nodes of the update being encoded and their changed fields. Kept
+  // across updates to reuse its storage.
+  std::vector<std::pair<const SemanticsNode*, uint32_t>> changed_nodes_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SemanticsUpdateEncoder);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Applies updates produced by a `SemanticsUpdateEncoder` to a
+///             retained copy of the semantics tree.
+///
+class SemanticsUpdateDecoder {
+ public:
+  /// Called once for every node in a decoded update with the decoder's own
+  /// copy of the node, after all of its changed fields have been applied.
+  /// The node remains valid until the next call to `Decode` or `Reset`.
+  using NodeVisitor = std::function<void(const SemanticsNode& node)>;
+
+  /// Called once for every custom action in a decoded update.
+  using ActionVisitor =
+      std::function<void(const CustomAccessibilityAction& action)>;
+
+  SemanticsUpdateDecoder();
+
+  ~SemanticsUpdateDecoder();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Apply an encoded update.
+  ///
+  /// @return     false if the buffer is malformed or was produced by a
+  ///             different version of the format. Nodes preceding the
+  ///             malformed data may already have been updated.
+  ///
+  [[nodiscard]] bool Decode(const uint8_t* data,
+                            size_t size,
+                            const NodeVisitor& node_visitor,
+                            const ActionVisitor& action_visitor);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forget every node and string decoded so far.
+  ///
+  void Reset();
+
+  /// The retained state of a node, or nullptr if it was never updated or
+  /// was removed from the tree since.
+  const SemanticsNode* GetNode(int32_t id) const;
+
+  /// The number of nodes currently retained.
+  size_t GetNodeCount() const { return nodes_.size(); }
+
+ private:
+  std::unordered_map<int32_t, SemanticsNode> nodes_;
+  // A deque, so that interned strings can be referenced while the table
+  // grows.
+  std::deque<std::string> strings_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SemanticsUpdateDecoder);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      A retained copy of the semantics tree that filters updates
+///             down to the nodes that are new or changed, for consumers that
+///             live in the same process as the framework and do not need the
+///             binary format.
+///
+///             Detached nodes are forgotten the same way the codec forgets
+///             them.
+///
+class RetainedSemanticsTree {
+ public:
+  RetainedSemanticsTree();
+
+  ~RetainedSemanticsTree();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Apply an update, moving the new and changed nodes into the
+  ///             tree.
+  ///
+  /// @param[in]  nodes    The update. Nodes that were moved into the tree are
+  ///                      left in a moved-from state.
+  /// @param[out] changed  Replaced with the retained copies of the nodes that
+  ///                      are new or changed. They remain valid until the
+  ///                      next call to `Update` or `Reset`.
+  ///
+  void Update(SemanticsNodeUpdates& nodes,
+              std::vector<const SemanticsNode*>& changed);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forget every node retained so far.
+  ///
+  void Reset();
+
+  /// The retained state of a node, or nullptr if it was never updated or
+  /// was removed from the tree since.
+  const SemanticsNode* GetNode(int32_t id) const;
+
+  /// The number of nodes currently retained.
+  size_t GetNodeCount() const { return nodes_.size(); }
+
+ private:
+  std::unordered_map<int32_t, SemanticsNode> nodes_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RetainedSemanticsTree);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_SEMANTICS_SEMANTICS_UPDATE_CODEC_H_
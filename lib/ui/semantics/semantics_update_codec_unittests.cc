@@ -0,0 +1,425 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/semantics/semantics_update_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+SemanticsNode CreateNode(int32_t id, std::string label) {
+  SemanticsNode node;
+  node.id = id;
+  node.label = std::move(label);
+  node.rect = SkRect::MakeLTRB(0, id * 10, 100, id * 10 + 10);
+  return node;
+}
+
+bool BufferContains(const std::vector<uint8_t>& buffer,
+                    const std::string& string) {
+  return std::search(buffer.begin(), buffer.end(), string.begin(),
+                     string.end()) != buffer.end();
+}
+
+}  // namespace
+
+TEST(SemanticsUpdateCodecTest, RoundTripsEveryField) {
+  SemanticsNode node;
+  node.id = 7;
+  node.flags = static_cast<int32_t>(SemanticsFlags::kIsButton);
+  node.actions = static_cast<int32_t>(SemanticsAction::kTap);
+  node.maxValueLength = 10;
+  node.currentValueLength = 3;
+  node.textSelectionBase = 1;
+  node.textSelectionExtent = 2;
+  node.platformViewId = 4;
+  node.scrollChildren = 2;
+  node.scrollIndex = 1;
+  node.scrollPosition = 1.5;
+  node.scrollExtentMax = 100.0;
+  node.scrollExtentMin = -1.0;
+  node.elevation = 3.0;
+  node.thickness = 4.0;
+  node.label = "label";
+  node.hint = "hint";
+  node.value = "value";
+  node.increasedValue = "increased";
+  node.decreasedValue = "decreased";
+  node.tooltip = "tooltip";
+  auto spell_out = std::make_shared<SpellOutStringAttribute>();
+  spell_out->type = StringAttributeType::kSpellOut;
+  spell_out->start = 0;
+  spell_out->end = 2;
+  node.labelAttributes.push_back(spell_out);
+  auto locale = std::make_shared<LocaleStringAttribute>();
+  locale->type = StringAttributeType::kLocale;
+  locale->start = 1;
+  locale->end = 3;
+  locale->locale = "en-US";
+  node.hintAttributes.push_back(locale);
+  node.textDirection = 2;
+  node.rect = SkRect::MakeLTRB(1, 2, 3, 4);
+  node.transform = SkM44::Translate(5, 6);
+  node.childrenInTraversalOrder = {8, 9};
+  node.childrenInHitTestOrder = {9, 8};
+  node.customAccessibilityActions = {-1, 1};
+
+  CustomAccessibilityAction action;
+  action.id = 3;
+  action.overrideId = 1;
+  action.label = "action";
+  action.hint = "label";
+
+  SemanticsUpdateEncoder encoder;
+  std::vector<uint8_t> buffer;
+  encoder.Encode({{node.id, node}}, {{action.id, action}}, buffer);
+
+  SemanticsUpdateDecoder decoder;
+  std::vector<int32_t> visited_nodes;
+  std::vector<CustomAccessibilityAction> visited_actions;
+  ASSERT_TRUE(decoder.Decode(
+      buffer.data(), buffer.size(),
+      [&](const SemanticsNode& node) { visited_nodes.push_back(node.id); },
+      [&](const CustomAccessibilityAction& action) {
+        visited_actions.push_back(action);
+      }));
+  ASSERT_EQ(visited_nodes, std::vector<int32_t>{7});
+
+  const SemanticsNode* decoded = decoder.GetNode(7);
+  ASSERT_NE(decoded, nullptr);
+  EXPECT_EQ(decoded->flags, node.flags);
+  EXPECT_EQ(decoded->actions, node.actions);
+  EXPECT_EQ(decoded->maxValueLength, 10);
+  EXPECT_EQ(decoded->currentValueLength, 3);
+  EXPECT_EQ(decoded->textSelectionBase, 1);
+  EXPECT_EQ(decoded->textSelectionExtent, 2);
+  EXPECT_EQ(decoded->platformViewId, 4);
+  EXPECT_EQ(decoded->scrollChildren, 2);
+  EXPECT_EQ(decoded->scrollIndex, 1);
+  EXPECT_EQ(decoded->scrollPosition, 1.5);
+  EXPECT_EQ(decoded->scrollExtentMax, 100.0);
+  EXPECT_EQ(decoded->scrollExtentMin, -1.0);
+  EXPECT_EQ(decoded->elevation, 3.0);
+  EXPECT_EQ(decoded->thickness, 4.0);
+  EXPECT_EQ(decoded->label, "label");
+  EXPECT_EQ(decoded->hint, "hint");
+  EXPECT_EQ(decoded->value, "value");
+  EXPECT_EQ(decoded->increasedValue, "increased");
+  EXPECT_EQ(decoded->decreasedValue, "decreased");
+  EXPECT_EQ(decoded->tooltip, "tooltip");
+  ASSERT_EQ(decoded->labelAttributes.size(), 1u);
+  EXPECT_EQ(decoded->labelAttributes[0]->type, StringAttributeType::kSpellOut);
+  EXPECT_EQ(decoded->labelAttributes[0]->start, 0);
+  EXPECT_EQ(decoded->labelAttributes[0]->end, 2);
+  ASSERT_EQ(decoded->hintAttributes.size(), 1u);
+  EXPECT_EQ(decoded->hintAttributes[0]->type, StringAttributeType::kLocale);
+  EXPECT_EQ(std::static_pointer_cast<LocaleStringAttribute>(
+                decoded->hintAttributes[0])
+                ->locale,
+            "en-US");
+  EXPECT_EQ(decoded->textDirection, 2);
+  EXPECT_EQ(decoded->rect, node.rect);
+  EXPECT_EQ(decoded->transform, node.transform);
+  EXPECT_EQ(decoded->childrenInTraversalOrder, node.childrenInTraversalOrder);
+  EXPECT_EQ(decoded->childrenInHitTestOrder, node.childrenInHitTestOrder);
+  EXPECT_EQ(decoded->customAccessibilityActions,
+            node.customAccessibilityActions);
+
+  ASSERT_EQ(visited_actions.size(), 1u);
+  EXPECT_EQ(visited_actions[0].id, 3);
+  EXPECT_EQ(visited_actions[0].overrideId, 1);
+  EXPECT_EQ(visited_actions[0].label, "action");
+  EXPECT_EQ(visited_actions[0].hint, "label");
+}
+
+TEST(SemanticsUpdateCodecTest, DefaultFieldsAreNotEncoded) {
+  SemanticsUpdateEncoder encoder;
+  std::vector<uint8_t> buffer;
+  SemanticsNode node;
+  node.id = 1;
+  encoder.Encode({{node.id, node}}, {}, buffer);
+
+  // Version, flags, node count, id, empty field mask and action count.
+  EXPECT_EQ(buffer.size(), 6u);
+
+  SemanticsUpdateDecoder decoder;
+  ASSERT_TRUE(decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+  ASSERT_NE(decoder.GetNode(1), nullptr);
+  EXPECT_TRUE(std::isnan(decoder.GetNode(1)->scrollPosition));
+}
+
+TEST(SemanticsUpdateCodecTest, OnlyChangedFieldsAreEncoded) {
+  SemanticsUpdateEncoder encoder;
+  SemanticsUpdateDecoder decoder;
+  std::vector<uint8_t> buffer;
+
+  SemanticsNodeUpdates nodes;
+  for (int32_t id = 0; id < 100; id++) {
+    nodes[id] = CreateNode(id, "Item " + std::to_string(id));
+  }
+  encoder.Encode(nodes, {}, buffer);
+  const size_t full_size = buffer.size();
+  ASSERT_TRUE(decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+
+  // Resending an unchanged node costs nothing.
+  SemanticsNode changed = nodes[42];
+  changed.value = "Selected";
+  encoder.Encode({{42, changed}, {43, nodes[43]}}, {}, buffer);
+  EXPECT_LT(buffer.size(), full_size / 50);
+  EXPECT_FALSE(BufferContains(buffer, "Item 42"));
+  EXPECT_TRUE(BufferContains(buffer, "Selected"));
+
+  std::vector<int32_t> visited;
+  ASSERT_TRUE(decoder.Decode(
+      buffer.data(), buffer.size(),
+      [&](const SemanticsNode& node) { visited.push_back(node.id); },
+      nullptr));
+  EXPECT_EQ(visited, std::vector<int32_t>{42});
+  EXPECT_EQ(decoder.GetNode(42)->label, "Item 42");
+  EXPECT_EQ(decoder.GetNode(42)->value, "Selected");
+  EXPECT_EQ(decoder.GetNode(43)->label, "Item 43");
+}
+
+TEST(SemanticsUpdateCodecTest, InternsStringsAcrossUpdates) {
+  SemanticsUpdateEncoder encoder;
+  SemanticsUpdateDecoder decoder;
+  std::vector<uint8_t> buffer;
+
+  encoder.Encode({{1, CreateNode(1, "Shared label")}}, {}, buffer);
+  ASSERT_TRUE(BufferContains(buffer, "Shared label"));
+  ASSERT_TRUE(decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+
+  encoder.Encode({{2, CreateNode(2, "Shared label")}}, {}, buffer);
+  EXPECT_FALSE(BufferContains(buffer, "Shared label"));
+  EXPECT_EQ(encoder.GetInternedStringCount(), 1u);
+  ASSERT_TRUE(decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+  EXPECT_EQ(decoder.GetNode(2)->label, "Shared label");
+}
+
+TEST(SemanticsUpdateCodecTest, ResetsTheStringTableWhenItIsFull) {
+  SemanticsUpdateEncoder encoder;
+  SemanticsUpdateDecoder decoder;
+  std::vector<uint8_t> buffer;
+
+  SemanticsNodeUpdates nodes;
+  for (size_t id = 0; id <= SemanticsUpdateEncoder::kMaxInternedStrings;
+       id++) {
+    nodes[id] = CreateNode(id, std::to_string(id));
+  }
+  encoder.Encode(nodes, {}, buffer);
+  ASSERT_TRUE(decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+  ASSERT_GT(encoder.GetInternedStringCount(),
+            SemanticsUpdateEncoder::kMaxInternedStrings);
+
+  encoder.Encode({{0, CreateNode(0, "A")}, {1, CreateNode(1, "A")}}, {},
+                 buffer);
+  EXPECT_EQ(encoder.GetInternedStringCount(), 1u);
+  ASSERT_TRUE(decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+  EXPECT_EQ(decoder.GetNode(0)->label, "A");
+  EXPECT_EQ(decoder.GetNode(1)->label, "A");
+  EXPECT_EQ(decoder.GetNode(2)->label, "2");
+}
+
+TEST(SemanticsUpdateCodecTest, ForgetsNodesRemovedFromTheTree) {
+  SemanticsUpdateEncoder encoder;
+  SemanticsUpdateDecoder decoder;
+  std::vector<uint8_t> buffer;
+
+  SemanticsNode root = CreateNode(0, "Root");
+  root.childrenInTraversalOrder = {1, 2};
+  SemanticsNode group = CreateNode(1, "Group");
+  group.childrenInTraversalOrder = {3};
+  encoder.Encode({{0, root},
+                  {1, group},
+                  {2, CreateNode(2, "Item 2")},
+                  {3, CreateNode(3, "Item 3")}},
+                 {}, buffer);
+  ASSERT_TRUE(decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+  ASSERT_EQ(encoder.GetNodeCount(), 4u);
+  ASSERT_EQ(decoder.GetNodeCount(), 4u);
+
+  // Removing the group removes its child too.
+  root.childrenInTraversalOrder = {2};
+  encoder.Encode({{0, root}}, {}, buffer);
+  ASSERT_TRUE(decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+  EXPECT_EQ(encoder.GetNodeCount(), 2u);
+  EXPECT_EQ(decoder.GetNodeCount(), 2u);
+  EXPECT_EQ(decoder.GetNode(1), nullptr);
+  EXPECT_EQ(decoder.GetNode(3), nullptr);
+  EXPECT_NE(decoder.GetNode(2), nullptr);
+
+  // A node that comes back is sent in full again.
+  root.childrenInTraversalOrder = {2, 3};
+  encoder.Encode({{0, root}, {3, CreateNode(3, "Item 3")}}, {}, buffer);
+  ASSERT_TRUE(decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+  ASSERT_NE(decoder.GetNode(3), nullptr);
+  EXPECT_EQ(decoder.GetNode(3)->label, "Item 3");
+  EXPECT_EQ(decoder.GetNode(3)->rect, SkRect::MakeLTRB(0, 30, 100, 40));
+}
+
+TEST(SemanticsUpdateCodecTest, KeepsNodesMovedToAnotherParent) {
+  SemanticsUpdateEncoder encoder;
+  SemanticsUpdateDecoder decoder;
+  std::vector<uint8_t> buffer;
+
+  SemanticsNode root = CreateNode(0, "Root");
+  root.childrenInTraversalOrder = {1, 2};
+  SemanticsNode first = CreateNode(1, "First");
+  first.childrenInTraversalOrder = {3};
+  SemanticsNode second = CreateNode(2, "Second");
+  encoder.Encode({{0, root},
+                  {1, first},
+                  {2, second},
+                  {3, CreateNode(3, "Item")}},
+                 {}, buffer);
+  ASSERT_TRUE(decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+
+  first.childrenInTraversalOrder = {};
+  second.childrenInTraversalOrder = {3};
+  encoder.Encode({{1, first}, {2, second}}, {}, buffer);
+  ASSERT_TRUE(decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+  EXPECT_EQ(encoder.GetNodeCount(), 4u);
+  EXPECT_EQ(decoder.GetNodeCount(), 4u);
+  ASSERT_NE(decoder.GetNode(3), nullptr);
+  EXPECT_EQ(decoder.GetNode(3)->label, "Item");
+}
+
+TEST(SemanticsUpdateCodecTest, DoesNotGrowWhileAListScrolls) {
+  SemanticsUpdateEncoder encoder;
+  SemanticsUpdateDecoder decoder;
+  std::vector<uint8_t> buffer;
+
+  // Every frame, the first visible item scrolls out and a new one comes in.
+  constexpr int32_t kVisibleItems = 10;
+  for (int32_t first = 1; first < 1000; first++) {
+    SemanticsNode list = CreateNode(0, "List");
+    SemanticsNodeUpdates nodes;
+    for (int32_t id = first; id < first + kVisibleItems; id++) {
+      list.childrenInTraversalOrder.push_back(id);
+      nodes[id] = CreateNode(id, "Item " + std::to_string(id));
+    }
+    nodes[0] = list;
+    encoder.Encode(nodes, {}, buffer);
+    ASSERT_TRUE(
+        decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+    ASSERT_EQ(encoder.GetNodeCount(), kVisibleItems + 1u);
+    ASSERT_EQ(decoder.GetNodeCount(), kVisibleItems + 1u);
+  }
+}
+
+TEST(SemanticsUpdateCodecTest, ResetForgetsEverything) {
+  SemanticsUpdateEncoder encoder;
+  SemanticsUpdateDecoder decoder;
+  std::vector<uint8_t> buffer;
+  const SemanticsNode node = CreateNode(1, "Label");
+  encoder.Encode({{1, node}}, {}, buffer);
+  ASSERT_TRUE(decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+
+  encoder.Reset();
+  decoder.Reset();
+  EXPECT_EQ(encoder.GetNodeCount(), 0u);
+  EXPECT_EQ(encoder.GetInternedStringCount(), 0u);
+  EXPECT_EQ(decoder.GetNode(1), nullptr);
+
+  // The same node is sent in full again.
+  encoder.Encode({{1, node}}, {}, buffer);
+  EXPECT_TRUE(BufferContains(buffer, "Label"));
+  ASSERT_TRUE(decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr));
+  EXPECT_EQ(decoder.GetNode(1)->label, "Label");
+}
+
+TEST(SemanticsUpdateCodecTest, RejectsMalformedBuffers) {
+  SemanticsUpdateEncoder encoder;
+  std::vector<uint8_t> buffer;
+  encoder.Encode({{1, CreateNode(1, "Label")}}, {}, buffer);
+
+  for (size_t size = 0; size < buffer.size(); size++) {
+    SemanticsUpdateDecoder decoder;
+    EXPECT_FALSE(decoder.Decode(buffer.data(), size, nullptr, nullptr));
+  }
+
+  std::vector<uint8_t> wrong_version = buffer;
+  wrong_version[0] = kSemanticsUpdateCodecVersion + 1;
+  SemanticsUpdateDecoder decoder;
+  EXPECT_FALSE(decoder.Decode(wrong_version.data(), wrong_version.size(),
+                              nullptr, nullptr));
+
+  std::vector<uint8_t> trailing = buffer;
+  trailing.push_back(0);
+  EXPECT_FALSE(
+      decoder.Decode(trailing.data(), trailing.size(), nullptr, nullptr));
+}
+
+TEST(RetainedSemanticsTreeTest, ReportsOnlyNewAndChangedNodes) {
+  RetainedSemanticsTree tree;
+  std::vector<const SemanticsNode*> changed;
+
+  SemanticsNode root = CreateNode(0, "Root");
+  root.childrenInTraversalOrder = {1, 2};
+  SemanticsNodeUpdates update = {{0, root},
+                                 {1, CreateNode(1, "Item 1")},
+                                 {2, CreateNode(2, "Item 2")}};
+  tree.Update(update, changed);
+  EXPECT_EQ(changed.size(), 3u);
+  EXPECT_EQ(tree.GetNodeCount(), 3u);
+
+  update = {{0, root},
+            {1, CreateNode(1, "Item 1")},
+            {2, CreateNode(2, "Changed")}};
+  tree.Update(update, changed);
+  ASSERT_EQ(changed.size(), 1u);
+  EXPECT_EQ(changed[0], tree.GetNode(2));
+  EXPECT_EQ(changed[0]->label, "Changed");
+
+  update = {{0, root}, {1, CreateNode(1, "Item 1")}};
+  tree.Update(update, changed);
+  EXPECT_TRUE(changed.empty());
+}
+
+TEST(RetainedSemanticsTreeTest, ForgetsNodesRemovedFromTheTree) {
+  RetainedSemanticsTree tree;
+  std::vector<const SemanticsNode*> changed;
+
+  SemanticsNode root = CreateNode(0, "Root");
+  root.childrenInTraversalOrder = {1, 2};
+  SemanticsNode group = CreateNode(1, "Group");
+  group.childrenInTraversalOrder = {3};
+  SemanticsNodeUpdates update = {{0, root},
+                                 {1, group},
+                                 {2, CreateNode(2, "Item 2")},
+                                 {3, CreateNode(3, "Item 3")}};
+  tree.Update(update, changed);
+  ASSERT_EQ(tree.GetNodeCount(), 4u);
+
+  // Removing the group removes its child too.
+  root.childrenInTraversalOrder = {2};
+  update = {{0, root}};
+  tree.Update(update, changed);
+  ASSERT_EQ(changed.size(), 1u);
+  EXPECT_EQ(tree.GetNodeCount(), 2u);
+  EXPECT_EQ(tree.GetNode(1), nullptr);
+  EXPECT_EQ(tree.GetNode(3), nullptr);
+
+  // A node that comes back is reported again.
+  root.childrenInTraversalOrder = {2, 3};
+  update = {{0, root}, {3, CreateNode(3, "Item 3")}};
+  tree.Update(update, changed);
+  EXPECT_EQ(changed.size(), 2u);
+  ASSERT_NE(tree.GetNode(3), nullptr);
+  EXPECT_EQ(tree.GetNode(3)->label, "Item 3");
+
+  tree.Reset();
+  EXPECT_EQ(tree.GetNodeCount(), 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
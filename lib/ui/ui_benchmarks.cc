@@ -4,12 +4,19 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/common/settings.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/lib/ui/painting/striped_image_encoder.h"
+#include "flutter/lib/ui/semantics/semantics_update_codec.h"
 #include "flutter/lib/ui/volatile_path_tracker.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/dart_isolate_runner.h"
 #include "flutter/testing/fixture_test.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkEncodedImageFormat.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/tonic/converter/dart_converter.h"
 
 #include <future>
 
@@ -112,9 +119,202 @@ static void BM_PathVolatilityTracker(benchmark::State& state) {
   }
 }
 
+// A scrolling list of |state.range(0)| items where one in ten nodes changes
+// between updates.
+static SemanticsNodeUpdates CreateSemanticsTree(int64_t node_count,
+                                                int64_t generation) {
+  SemanticsNodeUpdates nodes;
+  SemanticsNode& root = nodes[0];
+  for (int32_t id = 1; id < node_count; id++) {
+    SemanticsNode& node = nodes[id];
+    node.id = id;
+    node.flags = static_cast<int32_t>(SemanticsFlags::kHasEnabledState) |
+                 static_cast<int32_t>(SemanticsFlags::kIsEnabled);
+    node.actions = static_cast<int32_t>(SemanticsAction::kTap);
+    node.label = "List item " + std::to_string(id);
+    node.hint = "Double tap to open";
+    node.rect = SkRect::MakeXYWH(0, id * 48, 400, 48);
+    if (id % 10 == generation % 10) {
+      node.value = std::to_string(generation);
+    }
+    root.childrenInTraversalOrder.push_back(id);
+    root.childrenInHitTestOrder.push_back(id);
+  }
+  return nodes;
+}
+
+static void BM_SemanticsUpdateEncodeFull(benchmark::State& state) {
+  const SemanticsNodeUpdates nodes = CreateSemanticsTree(state.range(0), 0);
+  std::vector<uint8_t> buffer;
+  while (state.KeepRunning()) {
+    SemanticsUpdateEncoder encoder;
+    encoder.Encode(nodes, {}, buffer);
+  }
+  state.counters["Bytes"] = buffer.size();
+}
+
+static void BM_SemanticsUpdateEncodeDelta(benchmark::State& state) {
+  const SemanticsNodeUpdates nodes[] = {
+      CreateSemanticsTree(state.range(0), 0),
+      CreateSemanticsTree(state.range(0), 1),
+  };
+  SemanticsUpdateEncoder encoder;
+  std::vector<uint8_t> buffer;
+  size_t generation = 0;
+  while (state.KeepRunning()) {
+    encoder.Encode(nodes[generation++ % 2], {}, buffer);
+  }
+  state.counters["Bytes"] = buffer.size();
+}
+
+static void BM_SemanticsUpdateDecodeDelta(benchmark::State& state) {
+  SemanticsUpdateEncoder encoder;
+  std::vector<uint8_t> buffers[2];
+  encoder.Encode(CreateSemanticsTree(state.range(0), 0), {}, buffers[0]);
+  encoder.Encode(CreateSemanticsTree(state.range(0), 1), {}, buffers[1]);
+  SemanticsUpdateDecoder decoder;
+  FML_CHECK(decoder.Decode(buffers[0].data(), buffers[0].size(), nullptr,
+                           nullptr));
+  size_t generation = 1;
+  while (state.KeepRunning()) {
+    const auto& buffer = buffers[generation++ % 2];
+    bool successful =
+        decoder.Decode(buffer.data(), buffer.size(), nullptr, nullptr);
+    FML_CHECK(successful);
+  }
+}
+
+// A screenshot sized raster image of |width| by |height| pixels.
+static sk_sp<SkImage> CreateScreenshotImage(int width, int height) {
+  auto surface = SkSurface::MakeRasterN32Premul(width, height);
+  SkCanvas* canvas = surface->getCanvas();
+  canvas->clear(SK_ColorWHITE);
+  SkPaint paint;
+  for (int y = 0; y < height; y += 48) {
+    paint.setColor(SkColorSetRGB(y % 256, 128, 255 - y % 256));
+    canvas->drawRect(SkRect::MakeXYWH(16, y + 4, width - 32, 40), paint);
+  }
+  return surface->makeImageSnapshot();
+}
+
+// Encodes a |state.range(0)| by |state.range(1)| image as PNG in stripes on
+// |state.range(2)| workers, or on the calling thread if it is zero.
+static void BM_StripedImageEncoderPNG(benchmark::State& state) {
+  auto image = CreateScreenshotImage(state.range(0), state.range(1));
+  std::shared_ptr<fml::ConcurrentMessageLoop> loop;
+  std::shared_ptr<fml::BasicTaskRunner> runner;
+  if (state.range(2) > 0) {
+    loop = fml::ConcurrentMessageLoop::Create(state.range(2));
+    runner = loop->GetTaskRunner();
+  }
+  StripedImageEncoder::Options options;
+  size_t encoded_size = 0;
+  while (state.KeepRunning()) {
+    fml::AutoResetWaitableEvent latch;
+    StripedImageEncoder::EncodeToData(image, options, runner,
+                                      [&](sk_sp<SkData> encoded) {
+                                        FML_CHECK(encoded);
+                                        encoded_size = encoded->size();
+                                        latch.Signal();
+                                      });
+    latch.Wait();
+  }
+  state.counters["Bytes"] = encoded_size;
+}
+
+// The single threaded Skia PNG encoder that the striped encoder replaces.
+static void BM_SkiaImageEncoderPNG(benchmark::State& state) {
+  auto image = CreateScreenshotImage(state.range(0), state.range(1));
+  size_t encoded_size = 0;
+  while (state.KeepRunning()) {
+    auto encoded = image->encodeToData(SkEncodedImageFormat::kPNG, 0);
+    FML_CHECK(encoded);
+    encoded_size = encoded->size();
+  }
+  state.counters["Bytes"] = encoded_size;
+}
+
+// Records |state.range(0)| items of a list through the Dart canvas, with its
+// commands batched into a buffer or with a native call for each of them.
+static void BM_CanvasRecordCommands(benchmark::State& state, bool batched) {
+  ThreadHost thread_host(ThreadHost::ThreadHostConfig(
+      "test", ThreadHost::Type::Platform | ThreadHost::Type::RASTER |
+                  ThreadHost::Type::IO | ThreadHost::Type::UI));
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  Fixture fixture;
+  auto settings = fixture.CreateSettingsForFixture();
+  auto vm_ref = DartVMRef::Create(settings);
+  auto isolate =
+      testing::RunDartCodeInIsolate(vm_ref, settings, task_runners, "main", {},
+                                    testing::GetDefaultKernelFilePath(), {});
+
+  bool successful = isolate->RunInIsolateScope([batched]() -> bool {
+    Dart_Handle canvas_class =
+        Dart_GetClass(Dart_LookupLibrary(tonic::ToDart("dart:ui")),
+                      tonic::ToDart("Canvas"));
+    return !Dart_IsError(Dart_SetField(canvas_class,
+                                       tonic::ToDart("_batchCommands"),
+                                       Dart_NewBoolean(batched)));
+  });
+  FML_CHECK(successful);
+
+  const int64_t item_count = state.range(0);
+  while (state.KeepRunning()) {
+    successful = isolate->RunInIsolateScope([item_count]() -> bool {
+      Dart_Handle args[] = {tonic::ToDart(item_count)};
+      return !Dart_IsError(Dart_Invoke(
+          Dart_RootLibrary(), tonic::ToDart("recordCanvasCommands"), 1, args));
+    });
+    FML_CHECK(successful);
+  }
+  // The fixture makes seven canvas calls per item.
+  state.counters["TimePerCall"] = benchmark::Counter(
+      item_count * 7, benchmark::Counter::kIsIterationInvariantRate |
+                          benchmark::Counter::kInvert);
+}
+
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
+BENCHMARK_CAPTURE(BM_CanvasRecordCommands, Batched, true)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_CanvasRecordCommands, Unbatched, false)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK(BM_PathVolatilityTracker)->Unit(benchmark::kMillisecond);
 
+BENCHMARK(BM_SemanticsUpdateEncodeFull)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_SemanticsUpdateEncodeDelta)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_SemanticsUpdateDecodeDelta)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_StripedImageEncoderPNG)
+    ->Args({3840, 2160, 0})
+    ->Args({3840, 2160, 4})
+    ->Args({3840, 2160, 8})
+    ->Args({7680, 4320, 0})
+    ->Args({7680, 4320, 4})
+    ->Args({7680, 4320, 8})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_SkiaImageEncoderPNG)
+    ->Args({3840, 2160})
+    ->Args({7680, 4320})
+    ->Unit(benchmark::kMillisecond);
+
 }  // namespace flutter
@@ -108,6 +108,14 @@ std::unique_ptr<RuntimeController> RuntimeController::Clone() const {
   );
 }
 
+void RuntimeController::CopyPlatformDataFrom(const RuntimeController& other) {
+  // The viewport metrics belong to the window of each runtime controller.
+  const ViewportMetrics viewport_metrics = platform_data_.viewport_metrics;
+  platform_data_ = other.platform_data_;
+  platform_data_.viewport_metrics = viewport_metrics;
+  FlushRuntimeStateToIsolate();
+}
+
 bool RuntimeController::FlushRuntimeStateToIsolate() {
   return SetViewportMetrics(platform_data_.viewport_metrics) &&
          SetLocales(platform_data_.locale_data) &&
@@ -163,6 +163,18 @@ class RuntimeController : public PlatformConfigurationClient {
   ///
   std::unique_ptr<RuntimeController> Clone() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Replace the platform data, except for the viewport metrics,
+  ///             with that of another runtime controller and forward it to the
+  ///             running isolate. If the isolate is not running, the data will
+  ///             be saved and flushed to the isolate when it starts running.
+  ///             This brings runtime controllers that were spawned ahead of
+  ///             time up to date with their spawner.
+  ///
+  /// @param[in]  other  The runtime controller to copy the platform data of.
+  ///
+  void CopyPlatformDataFrom(const RuntimeController& other);
+
   //----------------------------------------------------------------------------
   /// @brief      Forward the specified viewport metrics to the running isolate.
   ///             If the isolate is not running, these metrics will be saved and
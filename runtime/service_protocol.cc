@@ -40,6 +40,8 @@ const std::string_view
 const std::string_view
     ServiceProtocol::kRenderFrameWithRasterStatsExtensionName =
         "_flutter.renderFrameWithRasterStats";
+const std::string_view ServiceProtocol::kGetCacheMemoryUsageExtensionName =
+    "_flutter.getCacheMemoryUsage";
 
 static constexpr std::string_view kViewIdPrefx = "_flutterView/";
 static constexpr std::string_view kListViewsExtensionName =
@@ -60,6 +62,7 @@ ServiceProtocol::ServiceProtocol()
           kGetSkSLsExtensionName,
           kEstimateRasterCacheMemoryExtensionName,
           kRenderFrameWithRasterStatsExtensionName,
+          kGetCacheMemoryUsageExtensionName,
       }),
       handlers_mutex_(fml::SharedMutex::Create()) {}
 
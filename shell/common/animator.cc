@@ -5,6 +5,7 @@
 #include "flutter/shell/common/animator.h"
 
 #include "flutter/flow/frame_timings.h"
+#include "flutter/fml/make_copyable.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
@@ -45,6 +46,20 @@ Animator::Animator(Delegate& delegate,
 
 Animator::~Animator() = default;
 
+void Animator::SetPipelineDepthController(
+    std::shared_ptr<PipelineDepthController> controller) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  pipeline_depth_controller_ = std::move(controller);
+  if (pipeline_depth_controller_) {
+    layer_tree_pipeline_->SetDepth(pipeline_depth_controller_->GetDepth());
+  }
+}
+
+void Animator::SetPipelineDepth(uint32_t depth) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  layer_tree_pipeline_->SetDepth(depth);
+}
+
 void Animator::EnqueueTraceFlowId(uint64_t trace_flow_id) {
   fml::TaskRunner::RunNowOrPostTask(
       task_runners_.GetUITaskRunner(),
@@ -85,6 +100,10 @@ void Animator::BeginFrame(
   regenerate_layer_tree_ = false;
   pending_frame_semaphore_.Signal();
 
+  if (pipeline_depth_controller_) {
+    layer_tree_pipeline_->SetDepth(pipeline_depth_controller_->GetDepth());
+  }
+
   if (!producer_continuation_) {
     // We may already have a valid pipeline continuation in case a previous
     // begin frame did not result in an Animation::Render. Simply reuse that
@@ -96,7 +115,22 @@ void Animator::BeginFrame(
       // full because the consumer is being too slow. Try again at the next
       // frame interval.
       TRACE_EVENT0("flutter", "PipelineFull");
-      RequestFrame();
+      if (waiter_->IsPacedByDisplay()) {
+        RequestFrame();
+        return;
+      }
+      // Waiters that are not paced by a display would keep the UI thread
+      // spinning until a slot frees up, so retry once the raster thread is
+      // done with the frame it is drawing instead.
+      task_runners_.GetRasterTaskRunner()->PostTask(
+          [ui_task_runner = task_runners_.GetUITaskRunner(),
+           self = weak_factory_.GetWeakPtr()]() {
+            ui_task_runner->PostTask([self]() {
+              if (self) {
+                self->RequestFrame();
+              }
+            });
+          });
       return;
     }
   }
@@ -245,7 +279,7 @@ void Animator::AwaitVSync() {
           if (self->CanReuseLastLayerTree()) {
             self->DrawLastLayerTree(std::move(frame_timings_recorder));
           } else {
-            self->BeginFrame(std::move(frame_timings_recorder));
+            self->ScheduleBeginFrame(std::move(frame_timings_recorder));
           }
         }
       });
@@ -254,6 +288,32 @@ void Animator::AwaitVSync() {
   }
 }
 
+void Animator::ScheduleBeginFrame(
+    std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder) {
+  const fml::TimeDelta start_offset =
+      pipeline_depth_controller_
+          ? pipeline_depth_controller_->GetFrameStartOffset()
+          : fml::TimeDelta::Zero();
+  if (start_offset <= fml::TimeDelta::Zero()) {
+    BeginFrame(std::move(frame_timings_recorder));
+    return;
+  }
+
+  // Starting later leaves less time between sampling input and presenting the
+  // frame. The controller only asks for this when frames finish well ahead of
+  // their target time.
+  const fml::TimePoint start_time =
+      frame_timings_recorder->GetVsyncStartTime() + start_offset;
+  auto begin_frame = [self = weak_factory_.GetWeakPtr(),
+                      recorder = std::move(frame_timings_recorder)]() mutable {
+    if (self) {
+      self->BeginFrame(std::move(recorder));
+    }
+  };
+  task_runners_.GetUITaskRunner()->PostTaskForTime(
+      fml::MakeCopyable(std::move(begin_frame)), start_time);
+}
+
 void Animator::ScheduleSecondaryVsyncCallback(uintptr_t id,
                                               const fml::closure& callback) {
   waiter_->ScheduleSecondaryCallback(id, callback);
@@ -14,6 +14,7 @@
 #include "flutter/fml/synchronization/semaphore.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/shell/common/pipeline.h"
+#include "flutter/shell/common/pipeline_depth_controller.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/vsync_waiter.h"
 
@@ -76,6 +77,23 @@ class Animator final {
   void ScheduleSecondaryVsyncCallback(uintptr_t id,
                                       const fml::closure& callback);
 
+  //--------------------------------------------------------------------------
+  /// @brief    Lets the |controller| pick the depth of the layer tree
+  ///           pipeline and how long after vsync frames start, instead of
+  ///           using a fixed depth. The caller is responsible for feeding
+  ///           the controller with the timings of rasterized frames.
+  ///
+  ///           Must be called on the UI thread.
+  void SetPipelineDepthController(
+      std::shared_ptr<PipelineDepthController> controller);
+
+  //--------------------------------------------------------------------------
+  /// @brief    Sets a fixed depth for the layer tree pipeline. Overridden by
+  ///           the pipeline depth controller, if there is one.
+  ///
+  ///           Must be called on the UI thread.
+  void SetPipelineDepth(uint32_t depth);
+
   // Enqueue |trace_flow_id| into |trace_flow_ids_|.  The flow event will be
   // ended at either the next frame, or the next vsync interval with no active
   // active rendering.
@@ -84,6 +102,11 @@ class Animator final {
  private:
   void BeginFrame(std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder);
 
+  // Calls |BeginFrame| once the frame start offset of the pipeline depth
+  // controller has passed since vsync.
+  void ScheduleBeginFrame(
+      std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder);
+
   bool CanReuseLastLayerTree();
 
   void DrawLastLayerTree(
@@ -102,6 +125,7 @@ class Animator final {
   uint64_t frame_request_number_ = 1;
   fml::TimePoint dart_frame_deadline_;
   std::shared_ptr<LayerTreePipeline> layer_tree_pipeline_;
+  std::shared_ptr<PipelineDepthController> pipeline_depth_controller_;
   fml::Semaphore pending_frame_semaphore_;
   LayerTreePipeline::ProducerContinuation producer_continuation_;
   bool regenerate_layer_tree_ = false;
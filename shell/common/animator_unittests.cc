@@ -248,6 +248,143 @@ TEST_F(ShellTest, AnimatorDoesNotNotifyDelegateIfPipelineIsNotEmpty) {
   PostTaskSync(task_runners.GetUITaskRunner(), [&] { animator.reset(); });
 }
 
+TEST_F(ShellTest, AnimatorBuildsAheadAsFarAsThePipelineDepthAllows) {
+  FakeAnimatorDelegate delegate;
+  TaskRunners task_runners = {
+      "test",
+      CreateNewThread(),  // platform
+      CreateNewThread(),  // raster
+      CreateNewThread(),  // ui
+      CreateNewThread()   // io
+  };
+
+  auto clock = std::make_shared<ShellTestVsyncClock>();
+  std::shared_ptr<Animator> animator;
+  // A controller that has settled on the deepest pipeline because of
+  // sustained raster pressure.
+  auto controller = std::make_shared<PipelineDepthController>(3);
+
+  auto flush_vsync_task = [&] {
+    fml::AutoResetWaitableEvent ui_latch;
+    task_runners.GetUITaskRunner()->PostTask([&] { ui_latch.Signal(); });
+    do {
+      clock->SimulateVSync();
+    } while (ui_latch.WaitWithTimeout(fml::TimeDelta::FromMilliseconds(1)));
+  };
+
+  PostTaskSync(task_runners.GetUITaskRunner(), [&] {
+    auto vsync_waiter = static_cast<std::unique_ptr<VsyncWaiter>>(
+        std::make_unique<ShellTestVsyncWaiter>(task_runners, clock));
+    animator = std::make_unique<Animator>(delegate, task_runners,
+                                          std::move(vsync_waiter));
+    animator->SetPipelineDepthController(controller);
+  });
+
+  fml::AutoResetWaitableEvent begin_frame_latch;
+  EXPECT_CALL(delegate, OnAnimatorBeginFrame)
+      .WillRepeatedly(
+          [&](fml::TimePoint frame_target_time, uint64_t frame_number) {
+            begin_frame_latch.Signal();
+          });
+  EXPECT_CALL(delegate, OnAnimatorUpdateLatestFrameTargetTime).Times(3);
+  // Nothing consumes the pipeline, so only the first frame is drawn.
+  std::shared_ptr<LayerTreePipeline> pipeline;
+  EXPECT_CALL(delegate, OnAnimatorDraw)
+      .WillOnce([&](std::shared_ptr<LayerTreePipeline> drawn_pipeline) {
+        pipeline = std::move(drawn_pipeline);
+      });
+
+  // With the default depth of two, the third frame would not begin until the
+  // raster thread consumed the first one.
+  for (int i = 0; i < 3; i++) {
+    task_runners.GetUITaskRunner()->PostTask([&] {
+      animator->RequestFrame();
+      task_runners.GetPlatformTaskRunner()->PostTask(flush_vsync_task);
+    });
+    begin_frame_latch.Wait();
+
+    PostTaskSync(task_runners.GetUITaskRunner(), [&] {
+      auto layer_tree =
+          std::make_unique<LayerTree>(SkISize::Make(600, 800), 1.0);
+      animator->Render(std::move(layer_tree));
+    });
+  }
+
+  ASSERT_TRUE(pipeline);
+  EXPECT_EQ(pipeline->GetDepth(), 3u);
+
+  PostTaskSync(task_runners.GetUITaskRunner(), [&] { animator.reset(); });
+}
+
+TEST_F(ShellTest, AnimatorDelaysFrameStartByTheControllerOffset) {
+  FakeAnimatorDelegate delegate;
+  TaskRunners task_runners = {
+      "test",
+      CreateNewThread(),  // platform
+      CreateNewThread(),  // raster
+      CreateNewThread(),  // ui
+      CreateNewThread()   // io
+  };
+
+  auto clock = std::make_shared<ShellTestVsyncClock>();
+  std::shared_ptr<Animator> animator;
+
+  // Frames that take a fraction of the budget make the controller pick a
+  // single frame deep pipeline that starts frames well after vsync.
+  PipelineDepthController::Config config;
+  config.window_size = 1;
+  auto controller = std::make_shared<PipelineDepthController>(2, config);
+  const fml::TimePoint vsync = fml::TimePoint::Now();
+  FrameTiming timing;
+  timing.Set(FrameTiming::kVsyncStart, vsync);
+  timing.Set(FrameTiming::kBuildStart, vsync);
+  timing.Set(FrameTiming::kBuildFinish,
+             vsync + fml::TimeDelta::FromMilliseconds(1));
+  timing.Set(FrameTiming::kRasterStart,
+             vsync + fml::TimeDelta::FromMilliseconds(1));
+  timing.Set(FrameTiming::kRasterFinish,
+             vsync + fml::TimeDelta::FromMilliseconds(2));
+  controller->AddFrameTiming(timing, fml::TimeDelta::FromMicroseconds(16667));
+  ASSERT_EQ(controller->GetDepth(), 1u);
+  const fml::TimeDelta offset = controller->GetFrameStartOffset();
+  ASSERT_GT(offset, fml::TimeDelta::Zero());
+
+  PostTaskSync(task_runners.GetUITaskRunner(), [&] {
+    auto vsync_waiter = static_cast<std::unique_ptr<VsyncWaiter>>(
+        std::make_unique<ShellTestVsyncWaiter>(task_runners, clock));
+    animator = std::make_unique<Animator>(delegate, task_runners,
+                                          std::move(vsync_waiter));
+    animator->SetPipelineDepthController(controller);
+  });
+
+  fml::AutoResetWaitableEvent begin_frame_latch;
+  fml::TimePoint begin_frame_time;
+  EXPECT_CALL(delegate, OnAnimatorBeginFrame)
+      .WillOnce([&](fml::TimePoint frame_target_time, uint64_t frame_number) {
+        begin_frame_time = fml::TimePoint::Now();
+        begin_frame_latch.Signal();
+      });
+
+  // The vsync that starts the frame is issued no earlier than this.
+  fml::TimePoint vsync_time;
+  auto flush_vsync_task = [&] {
+    vsync_time = fml::TimePoint::Now();
+    fml::AutoResetWaitableEvent ui_latch;
+    task_runners.GetUITaskRunner()->PostTask([&] { ui_latch.Signal(); });
+    do {
+      clock->SimulateVSync();
+    } while (ui_latch.WaitWithTimeout(fml::TimeDelta::FromMilliseconds(1)));
+  };
+  task_runners.GetUITaskRunner()->PostTask([&] {
+    animator->RequestFrame();
+    task_runners.GetPlatformTaskRunner()->PostTask(flush_vsync_task);
+  });
+  begin_frame_latch.Wait();
+  EXPECT_GE(begin_frame_time - vsync_time, offset);
+
+  PostTaskSync(task_runners.GetUITaskRunner(), [&] { animator.reset(); });
+}
+
 }  // namespace testing
 }  // namespace flutter
 
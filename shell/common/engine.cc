@@ -501,6 +501,10 @@ void Engine::ScheduleSecondaryVsyncCallback(uintptr_t id,
   animator_->ScheduleSecondaryVsyncCallback(id, callback);
 }
 
+fml::TimePoint Engine::GetCurrentTimePoint() {
+  return delegate_.GetCurrentTimePoint();
+}
+
 void Engine::HandleAssetPlatformMessage(
     std::unique_ptr<PlatformMessage> message) {
   fml::RefPtr<PlatformMessageResponse> response = message->response();
@@ -778,6 +778,9 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   void ScheduleSecondaryVsyncCallback(uintptr_t id,
                                       const fml::closure& callback) override;
 
+  // |PointerDataDispatcher::Delegate|
+  fml::TimePoint GetCurrentTimePoint() override;
+
   //----------------------------------------------------------------------------
   /// @brief      Get the last Entrypoint that was used in the RunConfiguration
   ///             when |Engine::Run| was called.
@@ -803,6 +806,25 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///
   const std::string& InitialRoute() const { return initial_route_; }
 
+  //----------------------------------------------------------------------------
+  /// @brief      Setter for the initial route, for engines that are spawned
+  ///             before the route they are going to show is known.
+  ///
+  void SetInitialRoute(std::string initial_route) {
+    initial_route_ = std::move(initial_route);
+  }
+
+  //--------------------------------------------------------------------------
+  /// @brief      Copies the platform data of the engine this engine was
+  ///             spawned from, except for the viewport metrics, for engines
+  ///             that are spawned before they are run. The locales, user
+  ///             settings, accessibility features and lifecycle state of the
+  ///             spawner may have changed since.
+  ///
+  void CopyPlatformDataFrom(const Engine& spawner) {
+    runtime_controller_->CopyPlatformDataFrom(*spawner.runtime_controller_);
+  }
+
   //--------------------------------------------------------------------------
   /// @brief      Loads the Dart shared library into the Dart VM. When the
   ///             Dart library is loaded successfully, the Dart future
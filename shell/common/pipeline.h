@@ -108,6 +108,39 @@ class Pipeline {
 
   bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
 
+  /// The maximum number of items that may be in flight at once.
+  uint32_t GetDepth() const {
+    std::scoped_lock lock(depth_mutex_);
+    return depth_;
+  }
+
+  /// Changes the maximum number of items in flight, which must be at least
+  /// one. Items that are already in flight are not affected. When the depth
+  /// is reduced while the pipeline is fuller than the new depth, the slots
+  /// over the new depth are retired as their items are consumed.
+  void SetDepth(uint32_t depth) {
+    FML_DCHECK(depth > 0);
+    std::scoped_lock lock(depth_mutex_);
+    while (depth_ < depth) {
+      if (slots_to_retire_ > 0) {
+        slots_to_retire_--;
+      } else {
+        empty_.Signal();
+      }
+      depth_++;
+    }
+    while (depth_ > depth) {
+      if (!empty_.TryWait()) {
+        slots_to_retire_++;
+      }
+      depth_--;
+    }
+    FML_TRACE_COUNTER("flutter", "Pipeline Depth",
+                      reinterpret_cast<int64_t>(this),  //
+                      "depth", depth_                   //
+    );
+  }
+
   ProducerContinuation Produce() {
     if (!empty_.TryWait()) {
       return {};
@@ -169,7 +202,7 @@ class Pipeline {
 
     consumer(std::move(resource));
 
-    empty_.Signal();
+    ReleaseSlot();
     --inflight_;
 
     TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
@@ -180,13 +213,26 @@ class Pipeline {
   }
 
  private:
-  const uint32_t depth_;
+  mutable std::mutex depth_mutex_;
+  uint32_t depth_;
+  // The number of slots that will not be returned to |empty_| after their
+  // items are consumed because the depth was reduced while they were in use.
+  uint32_t slots_to_retire_ = 0;
   fml::Semaphore empty_;
   fml::Semaphore available_;
   std::atomic<int> inflight_;
   std::mutex queue_mutex_;
   std::deque<std::pair<ResourcePtr, size_t>> queue_;
 
+  void ReleaseSlot() {
+    std::scoped_lock lock(depth_mutex_);
+    if (slots_to_retire_ > 0) {
+      slots_to_retire_--;
+      return;
+    }
+    empty_.Signal();
+  }
+
   PipelineProduceResult ProducerCommit(ResourcePtr resource, size_t trace_id) {
     bool is_first_item = false;
     {
@@ -207,7 +253,7 @@ class Pipeline {
       if (!queue_.empty()) {
         // Bail if the queue is not empty, opens up spaces to produce other
         // frames.
-        empty_.Signal();
+        ReleaseSlot();
         return {.success = false, .is_first_item = false};
       }
       queue_.emplace_back(std::move(resource), trace_id);
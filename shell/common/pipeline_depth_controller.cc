@@ -0,0 +1,112 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/pipeline_depth_controller.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+fml::TimeDelta Percentile90(std::vector<fml::TimeDelta>& times) {
+  FML_DCHECK(!times.empty());
+  auto nth = times.begin() + (times.size() - 1) * 9 / 10;
+  std::nth_element(times.begin(), nth, times.end());
+  return *nth;
+}
+
+}  // namespace
+
+PipelineDepthController::PipelineDepthController(uint32_t initial_depth,
+                                                 const Config& config)
+    : config_(config),
+      depth_(std::clamp(initial_depth, config.min_depth, config.max_depth)) {
+  FML_DCHECK(config_.min_depth > 0);
+  FML_DCHECK(config_.min_depth <= config_.max_depth);
+  FML_DCHECK(config_.window_size > 0);
+  build_times_.reserve(config_.window_size);
+  raster_times_.reserve(config_.window_size);
+}
+
+PipelineDepthController::PipelineDepthController(uint32_t initial_depth)
+    : PipelineDepthController(initial_depth, Config{}) {}
+
+PipelineDepthController::~PipelineDepthController() = default;
+
+void PipelineDepthController::AddFrameTiming(const FrameTiming& timing,
+                                             fml::TimeDelta frame_budget) {
+  const fml::TimeDelta build_time = timing.Get(FrameTiming::kBuildFinish) -
+                                    timing.Get(FrameTiming::kBuildStart);
+  const fml::TimeDelta raster_time = timing.Get(FrameTiming::kRasterFinish) -
+                                     timing.Get(FrameTiming::kRasterStart);
+  const fml::TimeDelta latency = timing.Get(FrameTiming::kRasterFinish) -
+                                 timing.Get(FrameTiming::kVsyncStart);
+
+  std::scoped_lock lock(mutex_);
+  if (latency > frame_budget * static_cast<int64_t>(depth_)) {
+    dropped_frames_++;
+  }
+  build_times_.push_back(build_time);
+  raster_times_.push_back(raster_time);
+  if (build_times_.size() >= config_.window_size) {
+    UpdateLocked(frame_budget);
+  }
+}
+
+uint32_t PipelineDepthController::GetDepth() const {
+  std::scoped_lock lock(mutex_);
+  return depth_;
+}
+
+fml::TimeDelta PipelineDepthController::GetFrameStartOffset() const {
+  std::scoped_lock lock(mutex_);
+  return frame_start_offset_;
+}
+
+size_t PipelineDepthController::GetDroppedFrameCount() const {
+  std::scoped_lock lock(mutex_);
+  return dropped_frames_;
+}
+
+void PipelineDepthController::UpdateLocked(fml::TimeDelta frame_budget) {
+  const fml::TimeDelta frame_time =
+      Percentile90(build_times_) + Percentile90(raster_times_);
+  build_times_.clear();
+  raster_times_.clear();
+
+  const double budget_fraction = frame_time.ToMillisecondsF() /
+                                 std::max(frame_budget.ToMillisecondsF(), 1.0);
+  if (budget_fraction > config_.deepen_threshold &&
+      depth_ < config_.max_depth) {
+    depth_++;
+  } else if (budget_fraction < config_.shallow_threshold &&
+             depth_ > config_.min_depth) {
+    depth_--;
+  }
+
+  // Only frames that are presented at the next vsync gain from starting
+  // later, deeper pipelines already queue them for longer than that.
+  frame_start_offset_ = fml::TimeDelta::Zero();
+  if (depth_ == 1 && budget_fraction < config_.shallow_threshold) {
+    const fml::TimeDelta slack =
+        fml::TimeDelta::FromMillisecondsF(frame_budget.ToMillisecondsF() *
+                                          (1.0 - config_.start_offset_margin)) -
+        frame_time;
+    frame_start_offset_ = std::clamp(slack, fml::TimeDelta::Zero(),
+                                     frame_budget / 2);
+  }
+
+  FML_TRACE_COUNTER("flutter", "PipelineDepthController",
+                    reinterpret_cast<int64_t>(this),                   //
+                    "depth", depth_,                                   //
+                    "start_offset_us",                                 //
+                    frame_start_offset_.ToMicroseconds(),              //
+                    "dropped_frames", dropped_frames_);
+}
+
+}  // namespace flutter
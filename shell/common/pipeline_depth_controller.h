@@ -0,0 +1,96 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_PIPELINE_DEPTH_CONTROLLER_H_
+#define FLUTTER_SHELL_COMMON_PIPELINE_DEPTH_CONTROLLER_H_
+
+#include <mutex>
+#include <vector>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Picks the depth of the layer tree pipeline and how long after
+///             vsync the animator starts a frame, from the timings of the
+///             most recently rasterized frames.
+///
+///             A deeper pipeline lets the UI thread build the next frame
+///             while the raster thread is still drawing the previous one,
+///             at the cost of a frame of latency. The controller deepens the
+///             pipeline when the build and raster times together no longer
+///             fit into the frame budget, and makes it shallow again once
+///             both threads have plenty of headroom. With a depth of one and
+///             headroom to spare, it also delays the start of frames so that
+///             they sample input closer to their presentation time.
+///
+///             Decisions are made once per window of frames, so a single
+///             slow frame does not change the depth. Timings are added on
+///             the raster thread and read on the UI thread.
+///
+class PipelineDepthController {
+ public:
+  struct Config {
+    uint32_t min_depth = 1;
+    uint32_t max_depth = 3;
+    /// The number of frames that each decision is based on.
+    size_t window_size = 16;
+    /// The pipeline is deepened when the 90th percentile build and raster
+    /// times add up to more than this fraction of the frame budget.
+    double deepen_threshold = 0.85;
+    /// The pipeline is made shallower when they add up to less than this
+    /// fraction of the frame budget.
+    double shallow_threshold = 0.5;
+    /// The part of the frame budget that is always left between the
+    /// expected end of a frame and its target time when frames are delayed.
+    double start_offset_margin = 0.25;
+  };
+
+  PipelineDepthController(uint32_t initial_depth, const Config& config);
+
+  explicit PipelineDepthController(uint32_t initial_depth);
+
+  ~PipelineDepthController();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records the timings of a rasterized frame that was meant to
+  ///             be presented within |frame_budget|.
+  ///
+  void AddFrameTiming(const FrameTiming& timing, fml::TimeDelta frame_budget);
+
+  uint32_t GetDepth() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The time between the vsync signal and the start of the
+  ///             frame that the animator should wait for.
+  ///
+  fml::TimeDelta GetFrameStartOffset() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of frames whose rasterization finished more than
+  ///             one frame budget per pipeline slot after their vsync.
+  ///
+  size_t GetDroppedFrameCount() const;
+
+ private:
+  const Config config_;
+
+  mutable std::mutex mutex_;
+  uint32_t depth_;
+  fml::TimeDelta frame_start_offset_;
+  size_t dropped_frames_ = 0;
+  std::vector<fml::TimeDelta> build_times_;
+  std::vector<fml::TimeDelta> raster_times_;
+
+  void UpdateLocked(fml::TimeDelta frame_budget);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PipelineDepthController);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_PIPELINE_DEPTH_CONTROLLER_H_
@@ -0,0 +1,124 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/pipeline_depth_controller.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr fml::TimeDelta kFrameBudget =
+    fml::TimeDelta::FromMicroseconds(16667);
+
+// Builds the timings of a frame that started building at its vsync and was
+// rasterized right after it was built.
+FrameTiming MakeTiming(int64_t frame_index,
+                       fml::TimeDelta build_time,
+                       fml::TimeDelta raster_time) {
+  const fml::TimePoint vsync =
+      fml::TimePoint::FromEpochDelta(kFrameBudget * frame_index);
+  FrameTiming timing;
+  timing.Set(FrameTiming::kVsyncStart, vsync);
+  timing.Set(FrameTiming::kBuildStart, vsync);
+  timing.Set(FrameTiming::kBuildFinish, vsync + build_time);
+  timing.Set(FrameTiming::kRasterStart, vsync + build_time);
+  timing.Set(FrameTiming::kRasterFinish, vsync + build_time + raster_time);
+  timing.Set(FrameTiming::kRasterFinishWallTime,
+             vsync + build_time + raster_time);
+  return timing;
+}
+
+void AddFrames(PipelineDepthController& controller,
+               size_t count,
+               fml::TimeDelta build_time,
+               fml::TimeDelta raster_time) {
+  for (size_t i = 0; i < count; i++) {
+    controller.AddFrameTiming(
+        MakeTiming(static_cast<int64_t>(i), build_time, raster_time),
+        kFrameBudget);
+  }
+}
+
+PipelineDepthController::Config MakeConfig() {
+  PipelineDepthController::Config config;
+  config.window_size = 10;
+  return config;
+}
+
+}  // namespace
+
+TEST(PipelineDepthControllerTest, DeepensUnderSustainedRasterPressure) {
+  PipelineDepthController controller(1, MakeConfig());
+  const auto build_time = fml::TimeDelta::FromMilliseconds(6);
+  const auto raster_time = fml::TimeDelta::FromMilliseconds(12);
+
+  // Decisions are only made once a whole window of frames was seen.
+  AddFrames(controller, 9, build_time, raster_time);
+  EXPECT_EQ(controller.GetDepth(), 1u);
+  AddFrames(controller, 1, build_time, raster_time);
+  EXPECT_EQ(controller.GetDepth(), 2u);
+  AddFrames(controller, 10, build_time, raster_time);
+  EXPECT_EQ(controller.GetDepth(), 3u);
+
+  // The depth never exceeds the configured maximum.
+  AddFrames(controller, 10, build_time, raster_time);
+  EXPECT_EQ(controller.GetDepth(), 3u);
+  EXPECT_EQ(controller.GetFrameStartOffset(), fml::TimeDelta::Zero());
+}
+
+TEST(PipelineDepthControllerTest, IgnoresOccasionalSlowFrames) {
+  PipelineDepthController controller(2, MakeConfig());
+  const auto fast = fml::TimeDelta::FromMilliseconds(3);
+  const auto slow = fml::TimeDelta::FromMilliseconds(40);
+
+  for (int window = 0; window < 3; window++) {
+    AddFrames(controller, 9, fast, fast);
+    AddFrames(controller, 1, fast, slow);
+  }
+  // A frame out of ten is above the 90th percentile, so the fast frames
+  // decide the depth.
+  EXPECT_EQ(controller.GetDepth(), 1u);
+  EXPECT_EQ(controller.GetDroppedFrameCount(), 3u);
+}
+
+TEST(PipelineDepthControllerTest, GetsShallowAndStartsLaterWithHeadroom) {
+  PipelineDepthController controller(3, MakeConfig());
+  const auto build_time = fml::TimeDelta::FromMilliseconds(2);
+  const auto raster_time = fml::TimeDelta::FromMilliseconds(3);
+
+  AddFrames(controller, 10, build_time, raster_time);
+  EXPECT_EQ(controller.GetDepth(), 2u);
+  // Deeper pipelines gain nothing from starting frames later.
+  EXPECT_EQ(controller.GetFrameStartOffset(), fml::TimeDelta::Zero());
+
+  AddFrames(controller, 10, build_time, raster_time);
+  EXPECT_EQ(controller.GetDepth(), 1u);
+  const fml::TimeDelta offset = controller.GetFrameStartOffset();
+  EXPECT_GT(offset, fml::TimeDelta::Zero());
+  EXPECT_LE(offset, kFrameBudget / 2);
+  // Frames that start after the offset still end ahead of their target time.
+  EXPECT_LT(offset + build_time + raster_time, kFrameBudget);
+  EXPECT_EQ(controller.GetDroppedFrameCount(), 0u);
+}
+
+TEST(PipelineDepthControllerTest, KeepsDepthBetweenThresholds) {
+  PipelineDepthController controller(2, MakeConfig());
+  AddFrames(controller, 50, fml::TimeDelta::FromMilliseconds(5),
+            fml::TimeDelta::FromMilliseconds(6));
+  EXPECT_EQ(controller.GetDepth(), 2u);
+  EXPECT_EQ(controller.GetFrameStartOffset(), fml::TimeDelta::Zero());
+}
+
+TEST(PipelineDepthControllerTest, CountsFramesThatMissTheirPresentation) {
+  PipelineDepthController controller(1, MakeConfig());
+  AddFrames(controller, 3, fml::TimeDelta::FromMilliseconds(10),
+            fml::TimeDelta::FromMilliseconds(10));
+  EXPECT_EQ(controller.GetDroppedFrameCount(), 3u);
+}
+
+}  // namespace testing
+}  // namespace flutter
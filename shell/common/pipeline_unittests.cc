@@ -144,5 +144,67 @@ TEST(PipelineTest, ProduceIfEmptySuccessfulIfQueueIsEmpty) {
   ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
 }
 
+TEST(PipelineTest, IncreasingDepthAllowsMoreItemsInFlight) {
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(1);
+
+  Continuation continuation_1 = pipeline->Produce();
+  ASSERT_TRUE(continuation_1);
+  ASSERT_FALSE(pipeline->Produce());
+
+  pipeline->SetDepth(3);
+  ASSERT_EQ(pipeline->GetDepth(), 3u);
+  Continuation continuation_2 = pipeline->Produce();
+  Continuation continuation_3 = pipeline->Produce();
+  ASSERT_TRUE(continuation_2);
+  ASSERT_TRUE(continuation_3);
+  ASSERT_FALSE(pipeline->Produce());
+}
+
+TEST(PipelineTest, DecreasingDepthRetiresSlotsOfItemsInFlight) {
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(3);
+
+  for (int i = 0; i < 3; i++) {
+    Continuation continuation = pipeline->Produce();
+    ASSERT_TRUE(continuation);
+    ASSERT_TRUE(continuation.Complete(std::make_unique<int>(i)).success);
+  }
+
+  // All of the slots are in use, so they are retired as they are consumed.
+  pipeline->SetDepth(1);
+  ASSERT_EQ(pipeline->GetDepth(), 1u);
+
+  auto consume = [&pipeline](int expected) {
+    return pipeline->Consume(
+        [expected](std::unique_ptr<int> v) { ASSERT_EQ(*v, expected); });
+  };
+  ASSERT_EQ(consume(0), PipelineConsumeResult::MoreAvailable);
+  ASSERT_FALSE(pipeline->Produce());
+  ASSERT_EQ(consume(1), PipelineConsumeResult::MoreAvailable);
+  ASSERT_FALSE(pipeline->Produce());
+  ASSERT_EQ(consume(2), PipelineConsumeResult::Done);
+
+  Continuation continuation = pipeline->Produce();
+  ASSERT_TRUE(continuation);
+  ASSERT_FALSE(pipeline->Produce());
+}
+
+TEST(PipelineTest, RestoringDepthCancelsRetiredSlots) {
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(2);
+  for (int i = 0; i < 2; i++) {
+    Continuation continuation = pipeline->Produce();
+    ASSERT_TRUE(continuation.Complete(std::make_unique<int>(i)).success);
+  }
+
+  pipeline->SetDepth(1);
+  pipeline->SetDepth(2);
+  ASSERT_FALSE(pipeline->Produce());
+
+  ASSERT_EQ(pipeline->Consume([](std::unique_ptr<int> v) {}),
+            PipelineConsumeResult::MoreAvailable);
+  Continuation continuation = pipeline->Produce();
+  ASSERT_TRUE(continuation);
+  ASSERT_FALSE(pipeline->Produce());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -0,0 +1,163 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/platform_message_stream.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+// Written in place of a header when a message does not fit before the end of
+// the storage. The consumer skips to the start of the storage.
+constexpr uint32_t kWrapMarker = UINT32_MAX;
+
+constexpr size_t kMinCapacity = 64;
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  FML_CHECK(value <= PlatformMessageRing::kMaxCapacity);
+  size_t result = kMinCapacity;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+// Keeps every header aligned so that a wrap marker always fits before the end
+// of the storage.
+size_t GetRecordSize(size_t message_size) {
+  constexpr size_t kAlignment = PlatformMessageRing::kHeaderSize;
+  return (PlatformMessageRing::kHeaderSize + message_size + kAlignment - 1) &
+         ~(kAlignment - 1);
+}
+
+}  // namespace
+
+PlatformMessageRing::PlatformMessageRing(size_t capacity)
+    : capacity_(RoundUpToPowerOfTwo(capacity)),
+      data_(std::make_unique<uint8_t[]>(capacity_)) {}
+
+PlatformMessageRing::~PlatformMessageRing() = default;
+
+size_t PlatformMessageRing::GetMaxMessageSize() const {
+  // Limiting records to half of the storage guarantees that a message fits
+  // into an empty ring: either it fits before the end of the storage or the
+  // skipped bytes were at most half of it.
+  return std::min<size_t>(capacity_ / 2 - kHeaderSize, kWrapMarker - 1);
+}
+
+bool PlatformMessageRing::TryPush(const uint8_t* data, size_t size) {
+  if (size > GetMaxMessageSize()) {
+    return false;
+  }
+  const size_t record_size = GetRecordSize(size);
+  size_t head = head_.load(std::memory_order_relaxed);
+  const size_t tail = tail_.load(std::memory_order_acquire);
+  size_t offset = head & (capacity_ - 1);
+  const size_t contiguous = capacity_ - offset;
+  const size_t needed =
+      record_size <= contiguous ? record_size : contiguous + record_size;
+  if (needed > capacity_ - (head - tail)) {
+    return false;
+  }
+
+  if (record_size > contiguous) {
+    std::memcpy(data_.get() + offset, &kWrapMarker, kHeaderSize);
+    head += contiguous;
+    offset = 0;
+  }
+  const uint32_t header = static_cast<uint32_t>(size);
+  std::memcpy(data_.get() + offset, &header, kHeaderSize);
+  if (size > 0) {
+    std::memcpy(data_.get() + offset + kHeaderSize, data, size);
+  }
+  head_.store(head + record_size, std::memory_order_release);
+  return true;
+}
+
+size_t PlatformMessageRing::Consume(
+    const std::function<void(const uint8_t* data, size_t size)>& visitor) {
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  const size_t head = head_.load(std::memory_order_acquire);
+  size_t count = 0;
+  while (tail != head) {
+    const size_t offset = tail & (capacity_ - 1);
+    uint32_t header;
+    std::memcpy(&header, data_.get() + offset, kHeaderSize);
+    if (header == kWrapMarker) {
+      tail += capacity_ - offset;
+      continue;
+    }
+    visitor(data_.get() + offset + kHeaderSize, header);
+    tail += GetRecordSize(header);
+    count++;
+  }
+  tail_.store(tail, std::memory_order_release);
+  return count;
+}
+
+size_t PlatformMessageRing::GetPendingBytes() const {
+  return head_.load(std::memory_order_acquire) -
+         tail_.load(std::memory_order_acquire);
+}
+
+PlatformMessageStream::PlatformMessageStream(
+    std::string channel,
+    size_t capacity,
+    fml::RefPtr<fml::TaskRunner> task_runner,
+    Dispatcher dispatcher)
+    : channel_(std::move(channel)),
+      task_runner_(std::move(task_runner)),
+      dispatcher_(std::move(dispatcher)),
+      ring_(capacity),
+      // A single drain never visits more than the capacity of the ring, and
+      // the batch layout is never larger than the ring layout.
+      batch_(ring_.GetCapacity()) {
+  FML_DCHECK(task_runner_);
+  FML_DCHECK(dispatcher_);
+}
+
+PlatformMessageStream::~PlatformMessageStream() = default;
+
+bool PlatformMessageStream::Send(const uint8_t* data, size_t size) {
+  if (!ring_.TryPush(data, size)) {
+    return false;
+  }
+  // Pairs with the exchange in |Drain|: either the scheduled drain has not
+  // started yet and will see this message, or this call schedules a new one.
+  if (!drain_scheduled_.exchange(true, std::memory_order_acq_rel)) {
+    task_runner_->PostTask(
+        [stream = shared_from_this()]() { stream->Drain(); });
+  }
+  return true;
+}
+
+size_t PlatformMessageStream::Drain() {
+  TRACE_EVENT0("flutter", "PlatformMessageStream::Drain");
+  FML_DCHECK(task_runner_->RunsTasksOnCurrentThread());
+  drain_scheduled_.exchange(false, std::memory_order_acq_rel);
+
+  size_t batch_size = 0;
+  const size_t count = ring_.Consume([&](const uint8_t* data, size_t size) {
+    const uint32_t header = static_cast<uint32_t>(size);
+    std::memcpy(batch_.data() + batch_size, &header, sizeof(header));
+    std::memcpy(batch_.data() + batch_size + sizeof(header), data, size);
+    batch_size += sizeof(header) + size;
+  });
+  if (count == 0) {
+    return 0;
+  }
+
+  dispatcher_(std::make_unique<PlatformMessage>(
+      channel_, fml::MallocMapping::Copy(batch_.data(), batch_size),
+      nullptr));
+  return count;
+}
+
+}  // namespace flutter
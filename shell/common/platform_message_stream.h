@@ -0,0 +1,155 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_PLATFORM_MESSAGE_STREAM_H_
+#define FLUTTER_SHELL_COMMON_PLATFORM_MESSAGE_STREAM_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/lib/ui/window/platform_message.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A fixed size, lock-free ring of variable length messages with a
+///             single producer and a single consumer.
+///
+///             All storage is allocated up front. Pushing a message copies it
+///             into the ring and never allocates; when the ring does not have
+///             room for a message the push fails and the producer decides
+///             whether to retry or drop it.
+///
+class PlatformMessageRing {
+ public:
+  /// Every message is prefixed with its size in the ring.
+  static constexpr size_t kHeaderSize = sizeof(uint32_t);
+
+  /// The largest capacity of a ring.
+  static constexpr size_t kMaxCapacity = size_t{1} << 30;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a ring with at least |capacity| bytes of storage. The
+  ///             capacity is rounded up to a power of two, and must not exceed
+  ///             |kMaxCapacity|.
+  ///
+  explicit PlatformMessageRing(size_t capacity);
+
+  ~PlatformMessageRing();
+
+  size_t GetCapacity() const { return capacity_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      The largest message that can ever be pushed. A message of
+  ///             this size always fits into an empty ring.
+  ///
+  size_t GetMaxMessageSize() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Copies a message into the ring. May only be called from the
+  ///             producer thread.
+  ///
+  /// @return     false if the ring does not currently have room for the
+  ///             message or if the message is larger than
+  ///             `GetMaxMessageSize`.
+  ///
+  [[nodiscard]] bool TryPush(const uint8_t* data, size_t size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Invokes |visitor| for every message in the ring, oldest first,
+  ///             and then releases their storage to the producer. May only be
+  ///             called from the consumer thread.
+  ///
+  /// @return     The number of messages visited.
+  ///
+  size_t Consume(
+      const std::function<void(const uint8_t* data, size_t size)>& visitor);
+
+  //----------------------------------------------------------------------------
+  /// @brief      An upper bound of the bytes occupied by the messages that
+  ///             have been pushed but not consumed yet, including their
+  ///             headers.
+  ///
+  size_t GetPendingBytes() const;
+
+ private:
+  const size_t capacity_;
+  const std::unique_ptr<uint8_t[]> data_;
+  // Both indices grow monotonically and are wrapped when accessing |data_|.
+  // They live on separate cache lines so the producer and consumer do not
+  // contend on them.
+  alignas(64) std::atomic<size_t> head_ = {0};
+  alignas(64) std::atomic<size_t> tail_ = {0};
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PlatformMessageRing);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      An opt-in, one-way platform channel for high frequency messages.
+///
+///             Messages sent on the stream are queued in a preallocated
+///             `PlatformMessageRing` instead of being wrapped in their own
+///             `PlatformMessage`. The first message queued after a drain
+///             posts a single task to the consumer task runner, which
+///             forwards everything queued by then as one platform message on
+///             the stream's channel.
+///
+///             The payload of that platform message is the concatenation of
+///             the queued messages, each prefixed with its size as a uint32
+///             in host byte order.
+///
+///             `Send` may be called from any single thread at a time.
+///
+class PlatformMessageStream
+    : public std::enable_shared_from_this<PlatformMessageStream> {
+ public:
+  /// Invoked on the consumer task runner with every batch of messages.
+  using Dispatcher = std::function<void(std::unique_ptr<PlatformMessage>)>;
+
+  PlatformMessageStream(std::string channel,
+                        size_t capacity,
+                        fml::RefPtr<fml::TaskRunner> task_runner,
+                        Dispatcher dispatcher);
+
+  ~PlatformMessageStream();
+
+  const std::string& GetChannel() const { return channel_; }
+
+  size_t GetMaxMessageSize() const { return ring_.GetMaxMessageSize(); }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Queues a message for the next batch.
+  ///
+  /// @return     false if the stream is full. The message is not queued and
+  ///             may be sent again once the consumer has caught up.
+  ///
+  [[nodiscard]] bool Send(const uint8_t* data, size_t size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Dispatches all queued messages as a single platform message.
+  ///             Must be called on the consumer task runner.
+  ///
+  /// @return     The number of messages dispatched.
+  ///
+  size_t Drain();
+
+ private:
+  const std::string channel_;
+  const fml::RefPtr<fml::TaskRunner> task_runner_;
+  const Dispatcher dispatcher_;
+  PlatformMessageRing ring_;
+  std::vector<uint8_t> batch_;
+  std::atomic<bool> drain_scheduled_ = {false};
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PlatformMessageStream);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_PLATFORM_MESSAGE_STREAM_H_
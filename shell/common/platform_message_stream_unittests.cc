@@ -0,0 +1,210 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/platform_message_stream.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/message_loop.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::vector<uint8_t> CreateMessage(size_t size, uint8_t seed) {
+  std::vector<uint8_t> message(size);
+  for (size_t i = 0; i < size; i++) {
+    message[i] = static_cast<uint8_t>(seed + i);
+  }
+  return message;
+}
+
+std::vector<std::vector<uint8_t>> ConsumeAll(PlatformMessageRing& ring) {
+  std::vector<std::vector<uint8_t>> messages;
+  ring.Consume([&](const uint8_t* data, size_t size) {
+    messages.emplace_back(data, data + size);
+  });
+  return messages;
+}
+
+// Splits the payload of a batch dispatched by a `PlatformMessageStream`.
+std::vector<std::vector<uint8_t>> SplitBatch(const PlatformMessage& batch) {
+  std::vector<std::vector<uint8_t>> messages;
+  const uint8_t* data = batch.data().GetMapping();
+  const uint8_t* end = data + batch.data().GetSize();
+  while (data < end) {
+    uint32_t size;
+    std::memcpy(&size, data, sizeof(size));
+    data += sizeof(size);
+    messages.emplace_back(data, data + size);
+    data += size;
+  }
+  EXPECT_EQ(data, end);
+  return messages;
+}
+
+}  // namespace
+
+TEST(PlatformMessageRingTest, PreservesMessagesInOrder) {
+  PlatformMessageRing ring(1024);
+  const std::vector<std::vector<uint8_t>> messages = {
+      CreateMessage(3, 0), CreateMessage(0, 0), CreateMessage(17, 5)};
+  for (const auto& message : messages) {
+    ASSERT_TRUE(ring.TryPush(message.data(), message.size()));
+  }
+  EXPECT_EQ(ConsumeAll(ring), messages);
+  EXPECT_EQ(ring.GetPendingBytes(), 0u);
+  EXPECT_TRUE(ConsumeAll(ring).empty());
+}
+
+TEST(PlatformMessageRingTest, RoundsCapacityUpToAPowerOfTwo) {
+  EXPECT_EQ(PlatformMessageRing(1000).GetCapacity(), 1024u);
+  EXPECT_EQ(PlatformMessageRing(1024).GetCapacity(), 1024u);
+  EXPECT_EQ(PlatformMessageRing(0).GetCapacity(), 64u);
+}
+
+TEST(PlatformMessageRingTest, RejectsMessagesWhenFull) {
+  PlatformMessageRing ring(64);
+  const auto message = CreateMessage(12, 0);
+  // Every message takes 16 bytes including its header.
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(ring.TryPush(message.data(), message.size()));
+  }
+  EXPECT_FALSE(ring.TryPush(message.data(), message.size()));
+  EXPECT_EQ(ConsumeAll(ring).size(), 4u);
+  EXPECT_TRUE(ring.TryPush(message.data(), message.size()));
+}
+
+TEST(PlatformMessageRingTest, RejectsOversizedMessages) {
+  PlatformMessageRing ring(64);
+  const auto message = CreateMessage(ring.GetMaxMessageSize() + 1, 0);
+  EXPECT_FALSE(ring.TryPush(message.data(), message.size()));
+}
+
+TEST(PlatformMessageRingTest, MaxSizedMessagesFitAtAnyOffset) {
+  PlatformMessageRing ring(64);
+  const auto small = CreateMessage(0, 0);
+  const auto large = CreateMessage(ring.GetMaxMessageSize(), 1);
+  for (int offset = 0; offset < 16; offset++) {
+    ASSERT_TRUE(ring.TryPush(small.data(), small.size()));
+    ConsumeAll(ring);
+    ASSERT_TRUE(ring.TryPush(large.data(), large.size()));
+    auto messages = ConsumeAll(ring);
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_EQ(messages[0], large);
+  }
+}
+
+TEST(PlatformMessageRingTest, WrapsAround) {
+  PlatformMessageRing ring(256);
+  uint8_t seed = 0;
+  for (int round = 0; round < 100; round++) {
+    std::vector<std::vector<uint8_t>> messages;
+    for (size_t size = round % 7; size < 60; size += 13) {
+      messages.push_back(CreateMessage(size, seed++));
+      ASSERT_TRUE(
+          ring.TryPush(messages.back().data(), messages.back().size()));
+    }
+    ASSERT_EQ(ConsumeAll(ring), messages);
+  }
+}
+
+TEST(PlatformMessageStreamTest, BatchesMessagesPerDrain) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  auto& loop = fml::MessageLoop::GetCurrent();
+  std::vector<std::unique_ptr<PlatformMessage>> batches;
+  auto stream = std::make_shared<PlatformMessageStream>(
+      "test/stream", 1024, loop.GetTaskRunner(),
+      [&](std::unique_ptr<PlatformMessage> message) {
+        batches.push_back(std::move(message));
+      });
+
+  const std::vector<std::vector<uint8_t>> messages = {
+      CreateMessage(1, 0), CreateMessage(8, 1), CreateMessage(0, 2)};
+  for (const auto& message : messages) {
+    ASSERT_TRUE(stream->Send(message.data(), message.size()));
+  }
+  EXPECT_TRUE(batches.empty());
+
+  loop.RunExpiredTasksNow();
+  ASSERT_EQ(batches.size(), 1u);
+  EXPECT_EQ(batches[0]->channel(), "test/stream");
+  EXPECT_FALSE(batches[0]->response());
+  EXPECT_EQ(SplitBatch(*batches[0]), messages);
+
+  // Nothing is dispatched without new messages.
+  loop.RunExpiredTasksNow();
+  EXPECT_EQ(stream->Drain(), 0u);
+  EXPECT_EQ(batches.size(), 1u);
+
+  ASSERT_TRUE(stream->Send(messages[1].data(), messages[1].size()));
+  loop.RunExpiredTasksNow();
+  ASSERT_EQ(batches.size(), 2u);
+  EXPECT_EQ(SplitBatch(*batches[1]).size(), 1u);
+}
+
+TEST(PlatformMessageStreamTest, AppliesBackpressure) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  auto& loop = fml::MessageLoop::GetCurrent();
+  size_t received = 0;
+  auto stream = std::make_shared<PlatformMessageStream>(
+      "test/stream", 64, loop.GetTaskRunner(),
+      [&](std::unique_ptr<PlatformMessage> message) {
+        received += SplitBatch(*message).size();
+      });
+
+  const auto message = CreateMessage(12, 0);
+  size_t sent = 0;
+  while (stream->Send(message.data(), message.size())) {
+    sent++;
+  }
+  EXPECT_EQ(sent, 4u);
+  loop.RunExpiredTasksNow();
+  EXPECT_EQ(received, sent);
+  EXPECT_TRUE(stream->Send(message.data(), message.size()));
+  loop.RunExpiredTasksNow();
+  EXPECT_EQ(received, sent + 1);
+}
+
+TEST(PlatformMessageStreamTest, DeliversAllMessagesAcrossThreads) {
+  constexpr uint32_t kMessageCount = 100000;
+  fml::Thread consumer("consumer");
+  fml::AutoResetWaitableEvent done;
+  uint32_t next = 0;
+  size_t batch_count = 0;
+  auto stream = std::make_shared<PlatformMessageStream>(
+      "test/stream", 256, consumer.GetTaskRunner(),
+      [&](std::unique_ptr<PlatformMessage> message) {
+        batch_count++;
+        for (const auto& payload : SplitBatch(*message)) {
+          uint32_t value;
+          ASSERT_EQ(payload.size(), sizeof(value));
+          std::memcpy(&value, payload.data(), sizeof(value));
+          ASSERT_EQ(value, next);
+          next++;
+        }
+        if (next == kMessageCount) {
+          done.Signal();
+        }
+      });
+
+  for (uint32_t i = 0; i < kMessageCount; i++) {
+    while (!stream->Send(reinterpret_cast<const uint8_t*>(&i), sizeof(i))) {
+      std::this_thread::yield();
+    }
+  }
+  done.Wait();
+  consumer.Join();
+  EXPECT_EQ(next, kMessageCount);
+  EXPECT_LT(batch_count, kMessageCount);
+}
+
+}  // namespace testing
+}  // namespace flutter
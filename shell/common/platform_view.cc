@@ -100,6 +100,11 @@ std::shared_ptr<impeller::Context> PlatformView::GetImpellerContext() const {
 void PlatformView::ReleaseResourceContext() const {}
 
 PointerDataDispatcherMaker PlatformView::GetDispatcherMaker() {
+  if (delegate_.OnPlatformViewGetSettings().enable_pointer_resampling) {
+    return [](DefaultPointerDataDispatcher::Delegate& delegate) {
+      return std::make_unique<ResamplingPointerDataDispatcher>(delegate);
+    };
+  }
   return [](DefaultPointerDataDispatcher::Delegate& delegate) {
     return std::make_unique<DefaultPointerDataDispatcher>(delegate);
   };
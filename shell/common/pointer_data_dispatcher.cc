@@ -4,6 +4,8 @@
 
 #include "flutter/shell/common/pointer_data_dispatcher.h"
 
+#include <algorithm>
+
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -15,6 +17,14 @@ SmoothPointerDataDispatcher::SmoothPointerDataDispatcher(Delegate& delegate)
     : DefaultPointerDataDispatcher(delegate), weak_factory_(this) {}
 SmoothPointerDataDispatcher::~SmoothPointerDataDispatcher() = default;
 
+ResamplingPointerDataDispatcher::ResamplingPointerDataDispatcher(
+    Delegate& delegate,
+    fml::TimeDelta sampling_offset)
+    : DefaultPointerDataDispatcher(delegate),
+      sampling_offset_(sampling_offset),
+      weak_factory_(this) {}
+ResamplingPointerDataDispatcher::~ResamplingPointerDataDispatcher() = default;
+
 void DefaultPointerDataDispatcher::DispatchPacket(
     std::unique_ptr<PointerDataPacket> packet,
     uint64_t trace_flow_id) {
@@ -68,4 +78,259 @@ void SmoothPointerDataDispatcher::DispatchPendingPacket() {
   ScheduleSecondaryVsyncCallback();
 }
 
+namespace {
+
+bool IsResamplable(const PointerData& data) {
+  return data.signal_kind == PointerData::SignalKind::kNone &&
+         (data.change == PointerData::Change::kMove ||
+          data.change == PointerData::Change::kHover);
+}
+
+}  // namespace
+
+void ResamplingPointerDataDispatcher::DispatchPacket(
+    std::unique_ptr<PointerDataPacket> packet,
+    uint64_t trace_flow_id) {
+  TRACE_EVENT0("flutter", "ResamplingPointerDataDispatcher::DispatchPacket");
+  TRACE_FLOW_STEP("flutter", "PointerEvent", trace_flow_id);
+
+  const auto& buffer = packet->data();
+  const size_t count = buffer.size() / sizeof(PointerData);
+  for (size_t i = 0; i < count; i++) {
+    PointerData data;
+    memcpy(&data, &buffer[i * sizeof(PointerData)], sizeof(PointerData));
+    pending_events_.push_back(data);
+  }
+  pending_trace_flow_ids_.push_back(trace_flow_id);
+  ScheduleSecondaryVsyncCallback();
+}
+
+void ResamplingPointerDataDispatcher::ScheduleSecondaryVsyncCallback() {
+  if (is_vsync_scheduled_) {
+    return;
+  }
+  is_vsync_scheduled_ = true;
+  delegate_.ScheduleSecondaryVsyncCallback(
+      reinterpret_cast<uintptr_t>(this),
+      [dispatcher = weak_factory_.GetWeakPtr()]() {
+        if (dispatcher) {
+          dispatcher->OnVsync();
+        }
+      });
+}
+
+void ResamplingPointerDataDispatcher::OnVsync() {
+  is_vsync_scheduled_ = false;
+  if (pending_events_.empty() && !HasUnsettledDevices()) {
+    return;
+  }
+  const fml::TimePoint sample_time =
+      delegate_.GetCurrentTimePoint() + sampling_offset_;
+  DispatchPendingEvents(sample_time.ToEpochDelta().ToMicroseconds());
+  // Keep going after input stops until every device reached its newest
+  // sample.
+  if (HasUnsettledDevices()) {
+    ScheduleSecondaryVsyncCallback();
+  }
+}
+
+bool ResamplingPointerDataDispatcher::IsSettled(const DeviceState& device) {
+  return device.samples.empty() ||
+         (device.has_delivered_position &&
+          device.delivered_x == device.samples.back().x &&
+          device.delivered_y == device.samples.back().y);
+}
+
+bool ResamplingPointerDataDispatcher::HasUnsettledDevices() const {
+  for (const auto& [id, device] : devices_) {
+    if (!IsSettled(device)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ResamplingPointerDataDispatcher::DispatchPendingEvents(
+    int64_t sample_time) {
+  TRACE_EVENT0("flutter",
+               "ResamplingPointerDataDispatcher::DispatchPendingEvents");
+  constexpr uint8_t kSuperseded = 1 << 0;
+  constexpr uint8_t kLastOfDevice = 1 << 1;
+  const size_t count = pending_events_.size();
+
+  // A move or hover is superseded when the next event of the same device is of
+  // the same kind, so only the last event of every such run is delivered.
+  // A move followed by any other event of its device is delivered as is, since
+  // resampling it to the frame time would reorder it with the later event.
+  for (auto& [id, device] : devices_) {
+    device.next_pending_event = nullptr;
+  }
+  pending_event_flags_.assign(count, 0);
+  size_t delivered_count = 0;
+  for (size_t i = count; i-- > 0;) {
+    const PointerData& data = pending_events_[i];
+    DeviceState& device = devices_[data.device];
+    const PointerData* next = device.next_pending_event;
+    if (next == nullptr) {
+      pending_event_flags_[i] = kLastOfDevice;
+    } else if (IsResamplable(data) && IsResamplable(*next) &&
+               next->change == data.change) {
+      pending_event_flags_[i] = kSuperseded;
+    }
+    if (!(pending_event_flags_[i] & kSuperseded)) {
+      delivered_count++;
+    }
+    device.next_pending_event = &data;
+  }
+
+  // Devices without new events that are not at their newest sample yet are
+  // moved towards it, without predicting past it.
+  for (auto& [id, device] : devices_) {
+    device.needs_settling = device.next_pending_event == nullptr &&
+                            !IsSettled(device) &&
+                            sample_time > device.delivered_time_stamp;
+    if (device.needs_settling) {
+      delivered_count++;
+    }
+  }
+  if (delivered_count == 0) {
+    return;
+  }
+
+  auto packet = std::make_unique<PointerDataPacket>(delivered_count);
+  size_t delivered = 0;
+  for (size_t i = 0; i < count; i++) {
+    PointerData data = pending_events_[i];
+    DeviceState& device = devices_[data.device];
+
+    if (!IsResamplable(data)) {
+      if (data.signal_kind == PointerData::SignalKind::kNone) {
+        device.samples.clear();
+        device.has_delivered_position = true;
+        device.delivered_x = data.physical_x;
+        device.delivered_y = data.physical_y;
+        device.delivered_time_stamp = data.time_stamp;
+      }
+      packet->SetPointerData(delivered++, data);
+      if (data.change == PointerData::Change::kRemove) {
+        devices_.erase(data.device);
+      }
+      continue;
+    }
+
+    device.samples.push_back({data.time_stamp, data.physical_x,
+                              data.physical_y});
+    device.last_event = data;
+    if (pending_event_flags_[i] & kSuperseded) {
+      coalesced_event_count_++;
+      continue;
+    }
+
+    // Never move a device backwards in time.
+    const Sample sample = (pending_event_flags_[i] & kLastOfDevice) &&
+                                  sample_time > device.delivered_time_stamp
+                              ? Resample(device.samples, sample_time)
+                              : device.samples.back();
+    DeliverSample(device, sample, data);
+    packet->SetPointerData(delivered++, data);
+  }
+
+  for (auto& [id, device] : devices_) {
+    if (!device.needs_settling) {
+      continue;
+    }
+    device.needs_settling = false;
+    const Sample& newest = device.samples.back();
+    const Sample sample = sample_time >= newest.time_stamp
+                              ? Sample{sample_time, newest.x, newest.y}
+                              : Resample(device.samples, sample_time);
+    PointerData data = device.last_event;
+    DeliverSample(device, sample, data);
+    packet->SetPointerData(delivered++, data);
+  }
+  FML_DCHECK(delivered == delivered_count);
+
+  // Only one flow continues into the framework, the others end here.
+  if (!pending_trace_flow_ids_.empty()) {
+    last_trace_flow_id_ = pending_trace_flow_ids_.back();
+    for (size_t i = 0; i + 1 < pending_trace_flow_ids_.size(); i++) {
+      TRACE_FLOW_END("flutter", "PointerEvent", pending_trace_flow_ids_[i]);
+    }
+  }
+  pending_events_.clear();
+  pending_trace_flow_ids_.clear();
+
+  DefaultPointerDataDispatcher::DispatchPacket(std::move(packet),
+                                               last_trace_flow_id_);
+}
+
+void ResamplingPointerDataDispatcher::DeliverSample(DeviceState& device,
+                                                    const Sample& sample,
+                                                    PointerData& data) {
+  data.time_stamp = sample.time_stamp;
+  data.physical_x = sample.x;
+  data.physical_y = sample.y;
+  if (device.has_delivered_position) {
+    data.physical_delta_x = sample.x - device.delivered_x;
+    data.physical_delta_y = sample.y - device.delivered_y;
+  }
+  device.has_delivered_position = true;
+  device.delivered_x = sample.x;
+  device.delivered_y = sample.y;
+  device.delivered_time_stamp = sample.time_stamp;
+
+  // Keep the samples that bracket the time just delivered and anything newer
+  // since they are needed to resample the next frame.
+  auto& samples = device.samples;
+  size_t first_kept = samples.size() >= 2 ? samples.size() - 2 : 0;
+  for (size_t j = 1; j < samples.size(); j++) {
+    if (samples[j].time_stamp > sample.time_stamp) {
+      first_kept = std::min(first_kept, j - 1);
+      break;
+    }
+  }
+  samples.erase(samples.begin(), samples.begin() + first_kept);
+}
+
+ResamplingPointerDataDispatcher::Sample
+ResamplingPointerDataDispatcher::Resample(const std::vector<Sample>& samples,
+                                          int64_t sample_time) const {
+  FML_DCHECK(!samples.empty());
+  const Sample& last = samples.back();
+
+  if (sample_time >= last.time_stamp) {
+    if (samples.size() < 2) {
+      return last;
+    }
+    const Sample& previous = samples[samples.size() - 2];
+    const int64_t interval = last.time_stamp - previous.time_stamp;
+    if (interval <= 0) {
+      return last;
+    }
+    const int64_t time = std::min(
+        sample_time, last.time_stamp + kMaxExtrapolation.ToMicroseconds());
+    const double t = static_cast<double>(time - last.time_stamp) / interval;
+    return {time, last.x + (last.x - previous.x) * t,
+            last.y + (last.y - previous.y) * t};
+  }
+
+  for (size_t i = samples.size() - 1; i > 0; i--) {
+    const Sample& before = samples[i - 1];
+    const Sample& after = samples[i];
+    if (before.time_stamp <= sample_time) {
+      const int64_t interval = after.time_stamp - before.time_stamp;
+      if (interval <= 0) {
+        return after;
+      }
+      const double t =
+          static_cast<double>(sample_time - before.time_stamp) / interval;
+      return {sample_time, before.x + (after.x - before.x) * t,
+              before.y + (after.y - before.y) * t};
+    }
+  }
+
+  // The sample time predates every sample.
+  return samples.front();
+}
+
 }  // namespace flutter
@@ -5,6 +5,11 @@
 #ifndef POINTER_DATA_DISPATCHER_H_
 #define POINTER_DATA_DISPATCHER_H_
 
+#include <map>
+#include <vector>
+
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/runtime/runtime_controller.h"
 #include "flutter/shell/common/animator.h"
 
@@ -64,6 +69,12 @@ class PointerDataDispatcher {
     virtual void ScheduleSecondaryVsyncCallback(
         uintptr_t id,
         const fml::closure& callback) = 0;
+
+    //--------------------------------------------------------------------------
+    /// @brief    The current time of the clock that VSYNC and pointer event
+    ///           time stamps are measured with. Used by
+    ///           `ResamplingPointerDataDispatcher` to pick the sample time.
+    virtual fml::TimePoint GetCurrentTimePoint() = 0;
   };
 
   //----------------------------------------------------------------------------
@@ -163,6 +174,110 @@ class SmoothPointerDataDispatcher : public DefaultPointerDataDispatcher {
   FML_DISALLOW_COPY_AND_ASSIGN(SmoothPointerDataDispatcher);
 };
 
+//------------------------------------------------------------------------------
+/// A dispatcher that holds every received event until the next VSYNC and then
+/// delivers them to the framework as a single packet per frame.
+///
+/// Consecutive move and hover events of the same device are coalesced into
+/// one event whose position is resampled to the sample time of the frame,
+/// which is the time of the VSYNC callback plus `sampling_offset`. The
+/// position is linearly interpolated between the two samples surrounding the
+/// sample time, or extrapolated from the last two samples by at most
+/// `kMaxExtrapolation` when the sample time is newer than every sample.
+///
+/// All other events (down, up, add, remove, cancel, signals and pan/zoom) are
+/// delivered unmodified and in order. A move that is separated from a later
+/// move of the same device by any such event is never coalesced with it.
+///
+/// With high rate input (e.g. 240Hz touch screens or styluses) this reduces
+/// the number of packets dispatched to the UI thread to at most one per frame
+/// and removes the jitter caused by the phase difference between input
+/// sampling and VSYNC.
+///
+/// Enabled with `Settings::enable_pointer_resampling`.
+///
+/// See also pointer_data_dispatcher_unittests.cc.
+class ResamplingPointerDataDispatcher : public DefaultPointerDataDispatcher {
+ public:
+  /// The furthest a position is predicted past its newest sample.
+  static constexpr fml::TimeDelta kMaxExtrapolation =
+      fml::TimeDelta::FromMilliseconds(8);
+
+  explicit ResamplingPointerDataDispatcher(
+      Delegate& delegate,
+      fml::TimeDelta sampling_offset = fml::TimeDelta::Zero());
+
+  // |PointerDataDispatcer|
+  void DispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                      uint64_t trace_flow_id) override;
+
+  virtual ~ResamplingPointerDataDispatcher();
+
+  /// The number of move and hover events merged into another event so far.
+  size_t GetCoalescedEventCount() const { return coalesced_event_count_; }
+
+ private:
+  struct Sample {
+    int64_t time_stamp;
+    double x;
+    double y;
+  };
+
+  struct DeviceState {
+    // The most recent samples of a device, oldest first. Only the samples
+    // needed to resample the next frame are retained.
+    std::vector<Sample> samples;
+    // The position last delivered to the framework, used to recompute deltas.
+    bool has_delivered_position = false;
+    double delivered_x = 0.0;
+    double delivered_y = 0.0;
+    int64_t delivered_time_stamp = 0;
+    // The last move or hover of the device, which the events that move it to
+    // its newest sample once input stops are based on.
+    PointerData last_event;
+    // The event of the device that follows the one being looked at, while
+    // the pending events are scanned backwards.
+    const PointerData* next_pending_event = nullptr;
+    // Whether the device has no pending events and is moved towards its
+    // newest sample by the events being dispatched. Decided before any event
+    // is delivered, since delivering a removal forgets the device and a later
+    // event with the same id starts it over.
+    bool needs_settling = false;
+  };
+
+  // Whether the position last delivered for |device| is its newest sample.
+  // Otherwise the device was extrapolated past its newest sample or is behind
+  // it, and is moved there on the next frames.
+  static bool IsSettled(const DeviceState& device);
+
+  void ScheduleSecondaryVsyncCallback();
+  void OnVsync();
+  bool HasUnsettledDevices() const;
+  void DispatchPendingEvents(int64_t sample_time);
+  // Updates |data| and the state of |device| to deliver |sample|.
+  void DeliverSample(DeviceState& device,
+                     const Sample& sample,
+                     PointerData& data);
+  Sample Resample(const std::vector<Sample>& samples,
+                  int64_t sample_time) const;
+
+  const fml::TimeDelta sampling_offset_;
+  std::vector<PointerData> pending_events_;
+  std::vector<uint64_t> pending_trace_flow_ids_;
+  // Whether each pending event is superseded or the last of its device.
+  // Reused across frames.
+  std::vector<uint8_t> pending_event_flags_;
+  // Events that move devices to their newest sample continue this flow.
+  uint64_t last_trace_flow_id_ = 0;
+  std::map<int64_t, DeviceState> devices_;
+  bool is_vsync_scheduled_ = false;
+  size_t coalesced_event_count_ = 0;
+
+  // WeakPtrFactory must be the last member.
+  fml::WeakPtrFactory<ResamplingPointerDataDispatcher> weak_factory_;
+  FML_DISALLOW_COPY_AND_ASSIGN(ResamplingPointerDataDispatcher);
+};
+
 //--------------------------------------------------------------------------
 /// @brief      Signature for constructing PointerDataDispatcher.
 ///
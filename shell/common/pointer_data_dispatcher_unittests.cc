@@ -0,0 +1,369 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/pointer_data_dispatcher.h"
+
+#include <cstring>
+#include <vector>
+
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Stands in for the engine. VSYNC is simulated by calling |FireVsync| and the
+// clock only advances when the test says so.
+class FakeDispatcherDelegate : public PointerDataDispatcher::Delegate {
+ public:
+  void DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                        uint64_t trace_flow_id) override {
+    std::vector<PointerData> events;
+    const auto& buffer = packet->data();
+    for (size_t i = 0; i < buffer.size() / sizeof(PointerData); i++) {
+      PointerData data;
+      std::memcpy(&data, &buffer[i * sizeof(PointerData)], sizeof(data));
+      events.push_back(data);
+    }
+    packets.push_back(std::move(events));
+  }
+
+  void ScheduleSecondaryVsyncCallback(uintptr_t id,
+                                      const fml::closure& callback) override {
+    vsync_callback = callback;
+  }
+
+  fml::TimePoint GetCurrentTimePoint() override { return now; }
+
+  void FireVsync() {
+    auto callback = std::move(vsync_callback);
+    vsync_callback = nullptr;
+    if (callback) {
+      callback();
+    }
+  }
+
+  fml::TimePoint now;
+  fml::closure vsync_callback;
+  std::vector<std::vector<PointerData>> packets;
+};
+
+PointerData CreatePointerData(PointerData::Change change,
+                              int64_t device,
+                              int64_t time_stamp_micros,
+                              double x,
+                              double y) {
+  PointerData data;
+  data.Clear();
+  data.time_stamp = time_stamp_micros;
+  data.change = change;
+  data.kind = PointerData::DeviceKind::kTouch;
+  data.signal_kind = PointerData::SignalKind::kNone;
+  data.device = device;
+  data.physical_x = x;
+  data.physical_y = y;
+  return data;
+}
+
+std::unique_ptr<PointerDataPacket> CreatePacket(const PointerData& data) {
+  auto packet = std::make_unique<PointerDataPacket>(1);
+  packet->SetPointerData(0, data);
+  return packet;
+}
+
+constexpr int64_t kFrameMicros = 16000;
+
+}  // namespace
+
+TEST(ResamplingPointerDataDispatcherTest, DispatchesOnePacketPerFrame) {
+  FakeDispatcherDelegate delegate;
+  ResamplingPointerDataDispatcher dispatcher(delegate);
+
+  // A 250Hz touch stream moving right by one pixel every 4ms, for 10 frames.
+  constexpr int64_t kEventMicros = 4000;
+  constexpr int kFrames = 10;
+  int64_t time = 0;
+  size_t events_sent = 1;
+  dispatcher.DispatchPacket(
+      CreatePacket(
+          CreatePointerData(PointerData::Change::kDown, 0, time, 0, 0)),
+      0);
+  for (int frame = 1; frame <= kFrames; frame++) {
+    while (time + kEventMicros <= frame * kFrameMicros) {
+      time += kEventMicros;
+      dispatcher.DispatchPacket(
+          CreatePacket(CreatePointerData(PointerData::Change::kMove, 0, time,
+                                         time / kEventMicros, 0)),
+          events_sent++);
+    }
+    delegate.now = fml::TimePoint::FromEpochDelta(
+        fml::TimeDelta::FromMicroseconds(frame * kFrameMicros));
+    delegate.FireVsync();
+    ASSERT_EQ(delegate.packets.size(), static_cast<size_t>(frame));
+  }
+
+  // The first frame carries the down, every frame has exactly one move.
+  ASSERT_EQ(delegate.packets[0].size(), 2u);
+  for (int frame = 1; frame < kFrames; frame++) {
+    ASSERT_EQ(delegate.packets[frame].size(), 1u);
+    EXPECT_EQ(delegate.packets[frame][0].change, PointerData::Change::kMove);
+  }
+  EXPECT_EQ(dispatcher.GetCoalescedEventCount(),
+            events_sent - 1 - static_cast<size_t>(kFrames));
+
+  // No further dispatches happen without input.
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), static_cast<size_t>(kFrames));
+}
+
+TEST(ResamplingPointerDataDispatcherTest, DeliversEventsAtTheNextVsync) {
+  FakeDispatcherDelegate delegate;
+  ResamplingPointerDataDispatcher dispatcher(delegate);
+
+  dispatcher.DispatchPacket(
+      CreatePacket(CreatePointerData(PointerData::Change::kDown, 0, 0, 0, 0)),
+      0);
+  ASSERT_TRUE(delegate.packets.empty());
+  ASSERT_TRUE(delegate.vsync_callback);
+
+  // The latency is bounded by a single frame.
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), 1u);
+  ASSERT_FALSE(delegate.vsync_callback);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, PreservesNonMoveEventsAndOrder) {
+  FakeDispatcherDelegate delegate;
+  ResamplingPointerDataDispatcher dispatcher(delegate);
+  delegate.now =
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromMicroseconds(100));
+
+  const std::vector<PointerData> events = {
+      CreatePointerData(PointerData::Change::kDown, 0, 10, 0, 0),
+      CreatePointerData(PointerData::Change::kMove, 0, 20, 1, 0),
+      CreatePointerData(PointerData::Change::kMove, 0, 30, 2, 0),
+      CreatePointerData(PointerData::Change::kUp, 0, 40, 2, 0),
+      CreatePointerData(PointerData::Change::kDown, 0, 50, 5, 5),
+      CreatePointerData(PointerData::Change::kMove, 0, 60, 6, 5),
+  };
+  for (const auto& event : events) {
+    dispatcher.DispatchPacket(CreatePacket(event), 0);
+  }
+  delegate.FireVsync();
+
+  ASSERT_EQ(delegate.packets.size(), 1u);
+  const auto& delivered = delegate.packets[0];
+  ASSERT_EQ(delivered.size(), 5u);
+  EXPECT_EQ(delivered[0].change, PointerData::Change::kDown);
+  EXPECT_EQ(delivered[1].change, PointerData::Change::kMove);
+  EXPECT_EQ(delivered[1].physical_x, 2);
+  EXPECT_EQ(delivered[2].change, PointerData::Change::kUp);
+  EXPECT_EQ(delivered[3].change, PointerData::Change::kDown);
+  EXPECT_EQ(delivered[4].change, PointerData::Change::kMove);
+  EXPECT_EQ(dispatcher.GetCoalescedEventCount(), 1u);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, CoalescesDevicesIndependently) {
+  FakeDispatcherDelegate delegate;
+  ResamplingPointerDataDispatcher dispatcher(delegate);
+  delegate.now =
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromMicroseconds(30));
+
+  for (int64_t time = 10; time <= 30; time += 10) {
+    dispatcher.DispatchPacket(
+        CreatePacket(
+            CreatePointerData(PointerData::Change::kMove, 0, time, time, 0)),
+        0);
+    dispatcher.DispatchPacket(
+        CreatePacket(
+            CreatePointerData(PointerData::Change::kMove, 1, time, 0, time)),
+        0);
+  }
+  delegate.FireVsync();
+
+  ASSERT_EQ(delegate.packets.size(), 1u);
+  const auto& delivered = delegate.packets[0];
+  ASSERT_EQ(delivered.size(), 2u);
+  EXPECT_EQ(delivered[0].device, 0);
+  EXPECT_EQ(delivered[0].physical_x, 30);
+  EXPECT_EQ(delivered[1].device, 1);
+  EXPECT_EQ(delivered[1].physical_y, 30);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, InterpolatesToTheSampleTime) {
+  FakeDispatcherDelegate delegate;
+  ResamplingPointerDataDispatcher dispatcher(
+      delegate, fml::TimeDelta::FromMicroseconds(-5000));
+
+  dispatcher.DispatchPacket(
+      CreatePacket(CreatePointerData(PointerData::Change::kDown, 0, 0, 0, 0)),
+      0);
+  dispatcher.DispatchPacket(CreatePacket(CreatePointerData(
+                                PointerData::Change::kMove, 0, 8000, 80, 0)),
+                            0);
+  dispatcher.DispatchPacket(CreatePacket(CreatePointerData(
+                                PointerData::Change::kMove, 0, 16000, 160, 40)),
+                            0);
+
+  // Sampling at 17ms - 5ms = 12ms lands halfway between the two moves.
+  delegate.now =
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromMicroseconds(17000));
+  delegate.FireVsync();
+
+  ASSERT_EQ(delegate.packets.size(), 1u);
+  const auto& move = delegate.packets[0].back();
+  EXPECT_EQ(move.time_stamp, 12000);
+  EXPECT_DOUBLE_EQ(move.physical_x, 120);
+  EXPECT_DOUBLE_EQ(move.physical_y, 20);
+  EXPECT_DOUBLE_EQ(move.physical_delta_x, 120);
+  EXPECT_DOUBLE_EQ(move.physical_delta_y, 20);
+
+  // The next frame continues from the newest sample that was held back.
+  dispatcher.DispatchPacket(CreatePacket(CreatePointerData(
+                                PointerData::Change::kMove, 0, 24000, 240, 80)),
+                            0);
+  delegate.now =
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromMicroseconds(25000));
+  delegate.FireVsync();
+
+  ASSERT_EQ(delegate.packets.size(), 2u);
+  const auto& next_move = delegate.packets[1].back();
+  EXPECT_EQ(next_move.time_stamp, 20000);
+  EXPECT_DOUBLE_EQ(next_move.physical_x, 200);
+  EXPECT_DOUBLE_EQ(next_move.physical_y, 60);
+  EXPECT_DOUBLE_EQ(next_move.physical_delta_x, 80);
+  EXPECT_DOUBLE_EQ(next_move.physical_delta_y, 40);
+
+  // Once input stops, the samples that were held back are still delivered.
+  ASSERT_TRUE(delegate.vsync_callback);
+  delegate.now =
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromMicroseconds(27000));
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), 3u);
+  ASSERT_EQ(delegate.packets[2].size(), 1u);
+  EXPECT_EQ(delegate.packets[2][0].change, PointerData::Change::kMove);
+  EXPECT_EQ(delegate.packets[2][0].time_stamp, 22000);
+  EXPECT_DOUBLE_EQ(delegate.packets[2][0].physical_x, 220);
+  EXPECT_DOUBLE_EQ(delegate.packets[2][0].physical_y, 70);
+
+  delegate.now =
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromMicroseconds(33000));
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), 4u);
+  EXPECT_EQ(delegate.packets[3][0].time_stamp, 28000);
+  EXPECT_DOUBLE_EQ(delegate.packets[3][0].physical_x, 240);
+  EXPECT_DOUBLE_EQ(delegate.packets[3][0].physical_y, 80);
+  EXPECT_DOUBLE_EQ(delegate.packets[3][0].physical_delta_x, 20);
+  EXPECT_DOUBLE_EQ(delegate.packets[3][0].physical_delta_y, 10);
+
+  // Nothing is dispatched once the newest sample was delivered.
+  EXPECT_FALSE(delegate.vsync_callback);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, BoundsExtrapolation) {
+  FakeDispatcherDelegate delegate;
+  ResamplingPointerDataDispatcher dispatcher(delegate);
+
+  dispatcher.DispatchPacket(CreatePacket(CreatePointerData(
+                                PointerData::Change::kMove, 0, 0, 0, 0)),
+                            0);
+  dispatcher.DispatchPacket(CreatePacket(CreatePointerData(
+                                PointerData::Change::kMove, 0, 4000, 40, 0)),
+                            0);
+
+  // Predicting 2ms ahead is within bounds.
+  delegate.now =
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromMicroseconds(6000));
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), 1u);
+  EXPECT_EQ(delegate.packets[0].back().time_stamp, 6000);
+  EXPECT_DOUBLE_EQ(delegate.packets[0].back().physical_x, 60);
+
+  // A stalled stream is not predicted further than kMaxExtrapolation.
+  dispatcher.DispatchPacket(CreatePacket(CreatePointerData(
+                                PointerData::Change::kMove, 0, 8000, 80, 0)),
+                            0);
+  delegate.now =
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromMicroseconds(100000));
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), 2u);
+  const int64_t limit =
+      8000 +
+      ResamplingPointerDataDispatcher::kMaxExtrapolation.ToMicroseconds();
+  EXPECT_EQ(delegate.packets[1].back().time_stamp, limit);
+  EXPECT_DOUBLE_EQ(delegate.packets[1].back().physical_x, limit / 100.0);
+
+  // The overshoot is corrected on the next frame since no input followed.
+  ASSERT_TRUE(delegate.vsync_callback);
+  delegate.now =
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromMicroseconds(116000));
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), 3u);
+  ASSERT_EQ(delegate.packets[2].size(), 1u);
+  EXPECT_EQ(delegate.packets[2][0].change, PointerData::Change::kMove);
+  EXPECT_EQ(delegate.packets[2][0].time_stamp, 116000);
+  EXPECT_DOUBLE_EQ(delegate.packets[2][0].physical_x, 80);
+  EXPECT_DOUBLE_EQ(delegate.packets[2][0].physical_delta_x,
+                   80 - limit / 100.0);
+  EXPECT_FALSE(delegate.vsync_callback);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, RestartsDevicesRemovedInAFrame) {
+  FakeDispatcherDelegate delegate;
+  ResamplingPointerDataDispatcher dispatcher(delegate);
+
+  // Leave the device extrapolated past its newest sample.
+  dispatcher.DispatchPacket(CreatePacket(CreatePointerData(
+                                PointerData::Change::kMove, 0, 0, 0, 0)),
+                            0);
+  dispatcher.DispatchPacket(CreatePacket(CreatePointerData(
+                                PointerData::Change::kMove, 0, 4000, 40, 0)),
+                            0);
+  delegate.now =
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromMicroseconds(6000));
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), 1u);
+
+  // The pointer id is reused within the next frame, and the new pointer ends
+  // up extrapolated as far as allowed.
+  const std::vector<PointerData> events = {
+      CreatePointerData(PointerData::Change::kRemove, 0, 7000, 40, 0),
+      CreatePointerData(PointerData::Change::kAdd, 0, 8000, 0, 0),
+      CreatePointerData(PointerData::Change::kDown, 0, 8000, 0, 0),
+      CreatePointerData(PointerData::Change::kMove, 0, 10000, 20, 0),
+      CreatePointerData(PointerData::Change::kMove, 0, 12000, 40, 0),
+  };
+  for (const auto& event : events) {
+    dispatcher.DispatchPacket(CreatePacket(event), 0);
+  }
+  delegate.now =
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromMicroseconds(100000));
+  delegate.FireVsync();
+
+  ASSERT_EQ(delegate.packets.size(), 2u);
+  const auto& delivered = delegate.packets[1];
+  ASSERT_EQ(delivered.size(), 4u);
+  EXPECT_EQ(delivered[0].change, PointerData::Change::kRemove);
+  EXPECT_EQ(delivered[1].change, PointerData::Change::kAdd);
+  EXPECT_EQ(delivered[2].change, PointerData::Change::kDown);
+  EXPECT_EQ(delivered[3].change, PointerData::Change::kMove);
+  const int64_t limit =
+      12000 +
+      ResamplingPointerDataDispatcher::kMaxExtrapolation.ToMicroseconds();
+  EXPECT_EQ(delivered[3].time_stamp, limit);
+
+  // The new pointer is settled on its newest sample on the next frame.
+  ASSERT_TRUE(delegate.vsync_callback);
+  delegate.now =
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromMicroseconds(116000));
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), 3u);
+  ASSERT_EQ(delegate.packets[2].size(), 1u);
+  EXPECT_DOUBLE_EQ(delegate.packets[2][0].physical_x, 40);
+  EXPECT_FALSE(delegate.vsync_callback);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -111,6 +111,7 @@ void Rasterizer::Teardown() {
     }
     surface_.reset();
   }
+  ReportCacheBytes();
 
   last_layer_tree_.reset();
 
@@ -153,6 +154,84 @@ void Rasterizer::NotifyLowMemoryWarning() const {
   context->performDeferredCleanup(std::chrono::milliseconds(0));
 }
 
+void Rasterizer::RegisterWithMemoryGovernor(
+    fml::MemoryGovernor& governor,
+    fml::RefPtr<fml::TaskRunner> raster_task_runner) {
+  auto post_trim = [raster_task_runner, weak = GetWeakPtr()](
+                       void (Rasterizer::*trim)(size_t)) {
+    return [raster_task_runner, weak, trim](size_t target_bytes) {
+      fml::TaskRunner::RunNowOrPostTask(
+          raster_task_runner, [weak, trim, target_bytes]() {
+            if (weak) {
+              ((*weak).*trim)(target_bytes);
+            }
+          });
+    };
+  };
+  // Images in the raster cache take a frame to recreate each, while unused
+  // Skia resources are cheap to give up.
+  raster_cache_registration_ =
+      governor.Register("RasterCache", fml::MemoryGovernor::Priority::kHigh,
+                        post_trim(&Rasterizer::TrimRasterCache));
+  resource_cache_registration_ = governor.Register(
+      "SkiaResourceCache", fml::MemoryGovernor::Priority::kNormal,
+      post_trim(&Rasterizer::TrimResourceCache));
+  ReportCacheBytes();
+}
+
+void Rasterizer::TrimRasterCache(size_t target_bytes) {
+  // The raster cache keeps no order to evict entries in, so it can only be
+  // emptied, and the entries that are still in use are rasterized again by
+  // the next frames. That is only worth it under memory pressure or when most
+  // of the cache has to go. Smaller excesses are left to the cache, which
+  // evicts the entries that a frame did not use.
+  RasterCache& raster_cache = compositor_context_->raster_cache();
+  const size_t bytes = raster_cache.picture_metrics().total_bytes() +
+                       raster_cache.layer_metrics().total_bytes();
+  if (target_bytes > bytes / 2) {
+    return;
+  }
+  raster_cache.Clear();
+  ReportCacheBytes();
+}
+
+void Rasterizer::TrimResourceCache(size_t target_bytes) {
+  GrDirectContext* context = surface_ ? surface_->GetContext() : nullptr;
+  if (!context) {
+    return;
+  }
+  auto context_switch = surface_->MakeRenderContextCurrent();
+  if (!context_switch->GetResult()) {
+    return;
+  }
+  int resource_count = 0;
+  size_t resource_bytes = 0;
+  context->getResourceCacheUsage(&resource_count, &resource_bytes);
+  if (resource_bytes > target_bytes) {
+    context->purgeUnlockedResources(resource_bytes - target_bytes,
+                                    /*preferScratchResources=*/true);
+  }
+  ReportCacheBytes();
+}
+
+void Rasterizer::ReportCacheBytes() {
+  if (!raster_cache_registration_) {
+    return;
+  }
+  const auto& raster_cache = compositor_context_->raster_cache();
+  raster_cache_registration_->ReportBytes(
+      raster_cache.picture_metrics().total_bytes() +
+      raster_cache.layer_metrics().total_bytes());
+
+  size_t resource_bytes = 0;
+  if (surface_ && surface_->GetContext()) {
+    int resource_count = 0;
+    surface_->GetContext()->getResourceCacheUsage(&resource_count,
+                                                  &resource_bytes);
+  }
+  resource_cache_registration_->ReportBytes(resource_bytes);
+}
+
 flutter::TextureRegistry* Rasterizer::GetTextureRegistry() {
   return &compositor_context_->texture_registry();
 }
@@ -735,6 +814,7 @@ RasterStatus Rasterizer::DrawToSurfaceUnsafe(
     if (surface_->GetContext()) {
       surface_->GetContext()->performDeferredCleanup(kSkiaCleanupExpiration);
     }
+    ReportCacheBytes();
 
     return raster_status;
   }
@@ -16,6 +16,7 @@
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/closure.h"
+#include "flutter/fml/memory/memory_governor.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/raster_thread_merger.h"
 #include "flutter/fml/synchronization/sync_switch.h"
@@ -171,6 +172,15 @@ class Rasterizer final : public SnapshotDelegate,
   ///
   void NotifyLowMemoryWarning() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Registers the raster cache and the Skia resource cache with
+  ///             |governor|, which trims them on |raster_task_runner|. Their
+  ///             sizes are reported after every frame.
+  ///
+  void RegisterWithMemoryGovernor(
+      fml::MemoryGovernor& governor,
+      fml::RefPtr<fml::TaskRunner> raster_task_runner);
+
   //----------------------------------------------------------------------------
   /// @brief      Gets a weak pointer to the rasterizer. The rasterizer may only
   ///             be accessed on the raster task runner.
@@ -517,6 +527,12 @@ class Rasterizer final : public SnapshotDelegate,
 
   void FireNextFrameCallbackIfPresent();
 
+  void TrimRasterCache(size_t target_bytes);
+
+  void TrimResourceCache(size_t target_bytes);
+
+  void ReportCacheBytes();
+
   static bool NoDiscard(const flutter::LayerTree& layer_tree) { return false; }
   static bool ShouldResubmitFrame(const RasterStatus& raster_status);
 
@@ -537,6 +553,10 @@ class Rasterizer final : public SnapshotDelegate,
   std::optional<size_t> max_cache_bytes_;
   fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger_;
   std::shared_ptr<ExternalViewEmbedder> external_view_embedder_;
+  std::unique_ptr<fml::MemoryGovernor::Registration>
+      raster_cache_registration_;
+  std::unique_ptr<fml::MemoryGovernor::Registration>
+      resource_cache_registration_;
 
   // WeakPtrFactory must be the last member.
   fml::TaskRunnerAffineWeakPtrFactory<Rasterizer> weak_factory_;
@@ -17,9 +17,11 @@
 #include "flutter/fml/log_settings.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/make_copyable.h"
+#include "flutter/fml/memory/memory_governor.h"
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_recorder.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/engine.h"
 #include "flutter/shell/common/skia_event_tracer_impl.h"
@@ -100,6 +102,10 @@ void PerformInitializationTasks(Settings& settings) {
       fml::tracing::TraceSetAllowlist(settings.trace_allowlist);
     }
 
+    if (settings.trace_recorder || settings.dump_trace_on_jank) {
+      fml::tracing::TraceRecorder::GetInstance().Start();
+    }
+
     if (!settings.skia_deterministic_rendering_on_cpu) {
       SkGraphics::Init();
     } else {
@@ -196,13 +202,16 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   std::promise<fml::WeakPtr<SnapshotDelegate>> snapshot_delegate_promise;
   auto snapshot_delegate_future = snapshot_delegate_promise.get_future();
   fml::TaskRunner::RunNowOrPostTask(
-      task_runners.GetRasterTaskRunner(), [&rasterizer_promise,  //
-                                           &snapshot_delegate_promise,
-                                           on_create_rasterizer,  //
-                                           shell = shell.get()    //
-  ]() {
+      task_runners.GetRasterTaskRunner(),
+      [&rasterizer_promise,  //
+       &snapshot_delegate_promise,
+       on_create_rasterizer,  //
+       shell = shell.get(),   //
+       raster_task_runner = task_runners.GetRasterTaskRunner()]() {
         TRACE_EVENT0("flutter", "ShellSetupGPUSubsystem");
         std::unique_ptr<Rasterizer> rasterizer(on_create_rasterizer(*shell));
+        rasterizer->RegisterWithMemoryGovernor(
+            fml::MemoryGovernor::GetInstance(), raster_task_runner);
         snapshot_delegate_promise.set_value(rasterizer->GetSnapshotDelegate());
         rasterizer_promise.set_value(std::move(rasterizer));
       });
@@ -288,6 +297,21 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
         // from the platform.
         auto animator = std::make_unique<Animator>(*shell, task_runners,
                                                    std::move(vsync_waiter));
+        // The pipeline must stay one frame deep when the platform and raster
+        // threads are the same.
+        if (shell->GetSettings().enable_adaptive_pipeline_depth &&
+            task_runners.GetPlatformTaskRunner() !=
+                task_runners.GetRasterTaskRunner()) {
+          shell->pipeline_depth_controller_ =
+              std::make_shared<PipelineDepthController>(2);
+          animator->SetPipelineDepthController(
+              shell->pipeline_depth_controller_);
+        } else if (shell->GetSettings().layer_tree_pipeline_depth > 0 &&
+                   task_runners.GetPlatformTaskRunner() !=
+                       task_runners.GetRasterTaskRunner()) {
+          animator->SetPipelineDepth(
+              shell->GetSettings().layer_tree_pipeline_depth);
+        }
 
         engine_promise.set_value(
             on_create_engine(*shell,                          //
@@ -454,6 +478,11 @@ Shell::Shell(DartVMRef vm,
           task_runners_.GetRasterTaskRunner(),
           std::bind(&Shell::OnServiceProtocolRenderFrameWithRasterStats, this,
                     std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetCacheMemoryUsageExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetCacheMemoryUsage, this,
+                    std::placeholders::_1, std::placeholders::_2)};
 }
 
 Shell::~Shell() {
@@ -514,6 +543,16 @@ std::unique_ptr<Shell> Shell::Spawn(
     const std::string& initial_route,
     const CreateCallback<PlatformView>& on_create_platform_view,
     const CreateCallback<Rasterizer>& on_create_rasterizer) const {
+  std::unique_ptr<Shell> result =
+      SpawnIdle(initial_route, on_create_platform_view, on_create_rasterizer);
+  result->RunEngine(std::move(run_configuration));
+  return result;
+}
+
+std::unique_ptr<Shell> Shell::SpawnIdle(
+    const std::string& initial_route,
+    const CreateCallback<PlatformView>& on_create_platform_view,
+    const CreateCallback<Rasterizer>& on_create_rasterizer) const {
   FML_DCHECK(task_runners_.IsValid());
   // It's safe to store this value since it is set on the platform thread.
   bool is_gpu_disabled = false;
@@ -546,10 +585,22 @@ std::unique_ptr<Shell> Shell::Spawn(
             /*snapshot_delegate=*/std::move(snapshot_delegate));
       },
       is_gpu_disabled);
-  result->RunEngine(std::move(run_configuration));
   return result;
 }
 
+std::shared_ptr<PlatformMessageStream> Shell::CreatePlatformMessageStream(
+    std::string channel,
+    size_t capacity) {
+  FML_DCHECK(is_setup_);
+  return std::make_shared<PlatformMessageStream>(
+      std::move(channel), capacity, task_runners_.GetUITaskRunner(),
+      [engine = weak_engine_](std::unique_ptr<PlatformMessage> message) {
+        if (engine) {
+          engine->DispatchPlatformMessage(std::move(message));
+        }
+      });
+}
+
 void Shell::NotifyLowMemoryWarning() const {
   auto trace_id = fml::tracing::TraceNonce();
   TRACE_EVENT_ASYNC_BEGIN0("flutter", "Shell::NotifyLowMemoryWarning",
@@ -560,6 +611,11 @@ void Shell::NotifyLowMemoryWarning() const {
   // running.
   ::Dart_NotifyLowMemory();
 
+  // Empties the caches of every engine in the process. Trims of caches that
+  // live on other threads are posted to them.
+  fml::MemoryGovernor::GetInstance().NotifyPressure(
+      fml::MemoryGovernor::Pressure::kCritical);
+
   task_runners_.GetRasterTaskRunner()->PostTask(
       [rasterizer = rasterizer_->GetWeakPtr(), trace_id = trace_id]() {
         if (rasterizer) {
@@ -669,6 +725,11 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   rasterizer_ = std::move(rasterizer);
   io_manager_ = io_manager;
 
+  if (settings_.memory_budget_bytes > 0) {
+    fml::MemoryGovernor::GetInstance().SetBudgetBytes(
+        settings_.memory_budget_bytes);
+  }
+
   // Set the external view embedder for the rasterizer.
   auto view_embedder = platform_view_->CreateExternalViewEmbedder();
   rasterizer_->SetExternalViewEmbedder(view_embedder);
@@ -724,7 +785,7 @@ fml::TaskRunnerAffineWeakPtr<Rasterizer> Shell::GetRasterizer() const {
   return weak_rasterizer_;
 }
 
-fml::WeakPtr<Engine> Shell::GetEngine() {
+fml::WeakPtr<Engine> Shell::GetEngine() const {
   FML_DCHECK(is_setup_);
   return weak_engine_;
 }
@@ -1396,6 +1457,47 @@ void Shell::ReportTimings() {
   });
 }
 
+void Shell::DumpTraceIfJanky(const FrameTiming& timing) {
+  // Dumps are written in full, so a burst of janky frames only dumps once.
+  static constexpr fml::TimeDelta kMinDumpInterval =
+      fml::TimeDelta::FromSeconds(10);
+
+  const fml::TimeDelta budget =
+      fml::TimeDelta::FromMillisecondsF(GetFrameBudget().count());
+  const fml::TimeDelta build_time = timing.Get(FrameTiming::kBuildFinish) -
+                                    timing.Get(FrameTiming::kBuildStart);
+  const fml::TimeDelta raster_time = timing.Get(FrameTiming::kRasterFinish) -
+                                     timing.Get(FrameTiming::kRasterStart);
+  if (build_time <= budget && raster_time <= budget) {
+    return;
+  }
+
+  const fml::TimePoint now = fml::TimePoint::Now();
+  if (last_jank_trace_dump_time_ &&
+      now - *last_jank_trace_dump_time_ < kMinDumpInterval) {
+    return;
+  }
+  last_jank_trace_dump_time_ = now;
+
+  std::stringstream file_name;
+  file_name << "flutter_jank_trace_" << timing.GetFrameNumber() << ".json";
+  task_runners_.GetIOTaskRunner()->PostTask(
+      [directory = settings_.temp_directory_path, file_name = file_name.str()] {
+        fml::UniqueFD fd = fml::OpenDirectory(
+            directory.c_str(), false, fml::FilePermission::kReadWrite);
+        if (!fd.is_valid() ||
+            !fml::tracing::TraceRecorder::GetInstance().DumpToFile(
+                fd, file_name.c_str(),
+                fml::tracing::TraceRecorder::Format::kChromeJson)) {
+          FML_LOG(ERROR) << "Could not dump the trace of a janky frame to "
+                         << directory << "/" << file_name;
+          return;
+        }
+        FML_LOG(INFO) << "Dumped the trace of a janky frame to " << directory
+                      << "/" << file_name;
+      });
+}
+
 size_t Shell::UnreportedFramesCount() const {
   // Check that this is running on the raster thread to avoid race conditions.
   FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
@@ -1413,6 +1515,15 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
     settings_.frame_rasterized_callback(timing);
   }
 
+  if (pipeline_depth_controller_) {
+    pipeline_depth_controller_->AddFrameTiming(
+        timing, fml::TimeDelta::FromMillisecondsF(GetFrameBudget().count()));
+  }
+
+  if (settings_.dump_trace_on_jank) {
+    DumpTraceIfJanky(timing);
+  }
+
   if (!needs_report_timings_) {
     return;
   }
@@ -1756,6 +1867,50 @@ bool Shell::OnServiceProtocolEstimateRasterCacheMemory(
   return true;
 }
 
+static const char* GetMemoryGovernorPriorityName(
+    fml::MemoryGovernor::Priority priority) {
+  switch (priority) {
+    case fml::MemoryGovernor::Priority::kLow:
+      return "low";
+    case fml::MemoryGovernor::Priority::kNormal:
+      return "normal";
+    case fml::MemoryGovernor::Priority::kHigh:
+      return "high";
+  }
+  return "";
+}
+
+bool Shell::OnServiceProtocolGetCacheMemoryUsage(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  const fml::MemoryGovernor& governor = fml::MemoryGovernor::GetInstance();
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "CacheMemoryUsage", allocator);
+  response->AddMember<uint64_t>("budgetBytes", governor.GetBudgetBytes(),
+                                allocator);
+  response->AddMember<uint64_t>("totalBytes", governor.GetTotalBytes(),
+                                allocator);
+  response->AddMember<uint64_t>("peakTotalBytes",
+                                governor.GetPeakTotalBytes(), allocator);
+  rapidjson::Value caches(rapidjson::kArrayType);
+  for (const auto& stats : governor.GetCacheStats()) {
+    rapidjson::Value cache(rapidjson::kObjectType);
+    cache.AddMember("name", rapidjson::Value(stats.name.c_str(), allocator),
+                    allocator);
+    cache.AddMember(
+        "priority",
+        rapidjson::StringRef(GetMemoryGovernorPriorityName(stats.priority)),
+        allocator);
+    cache.AddMember<uint64_t>("bytes", stats.bytes, allocator);
+    cache.AddMember<uint64_t>("peakBytes", stats.peak_bytes, allocator);
+    cache.AddMember<uint64_t>("trimCount", stats.trim_count, allocator);
+    caches.PushBack(cache, allocator);
+  }
+  response->AddMember("caches", caches, allocator);
+  return true;
+}
+
 // Service protocol handler
 bool Shell::OnServiceProtocolSetAssetBundlePath(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
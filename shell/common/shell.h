@@ -36,6 +36,7 @@
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/display_manager.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/platform_message_stream.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/resource_cache_limit_calculator.h"
@@ -194,6 +195,7 @@ class Shell final : public PlatformView::Delegate,
   ///             same snapshot or AOT.
   ///
   /// @see        http://flutter.dev/go/multiple-engines
+  /// @see        ShellPool
   std::unique_ptr<Shell> Spawn(
       RunConfiguration run_configuration,
       const std::string& initial_route,
@@ -256,7 +258,7 @@ class Shell final : public PlatformView::Delegate,
   ///
   /// @return     A weak pointer to the engine.
   ///
-  fml::WeakPtr<Engine> GetEngine();
+  fml::WeakPtr<Engine> GetEngine() const;
 
   //----------------------------------------------------------------------------
   /// @brief      Platform views may only be accessed on the platform task
@@ -273,6 +275,24 @@ class Shell final : public PlatformView::Delegate,
   ///
   fml::WeakPtr<ShellIOManager> GetIOManager();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a one-way stream of messages to the root isolate on
+  ///             |channel|. Messages sent on the stream are queued in a ring
+  ///             of |capacity| bytes and delivered to the framework in
+  ///             batches, one platform message per UI thread wakeup.
+  ///
+  /// @see        PlatformMessageStream
+  ///
+  /// @param[in]  channel   The channel on which batches are delivered.
+  /// @param[in]  capacity  The minimum size of the ring in bytes.
+  ///
+  /// @return     The stream. It may outlive the shell, in which case messages
+  ///             sent on it are dropped.
+  ///
+  std::shared_ptr<PlatformMessageStream> CreatePlatformMessageStream(
+      std::string channel,
+      size_t capacity);
+
   // Embedders should call this under low memory conditions to free up
   // internal caches used.
   //
@@ -427,6 +447,9 @@ class Shell final : public PlatformView::Delegate,
   std::shared_ptr<VolatilePathTracker> volatile_path_tracker_;
   std::shared_ptr<PlatformMessageHandler> platform_message_handler_;
   std::atomic<bool> route_messages_through_platform_thread_ = false;
+  // Set on the UI thread before setup and fed on the raster thread when
+  // |Settings::enable_adaptive_pipeline_depth| is set.
+  std::shared_ptr<PipelineDepthController> pipeline_depth_controller_;
 
   fml::WeakPtr<Engine> weak_engine_;  // to be shared across threads
   fml::TaskRunnerAffineWeakPtr<Rasterizer>
@@ -462,6 +485,10 @@ class Shell final : public PlatformView::Delegate,
   // here for easier conversions to Dart objects.
   std::vector<int64_t> unreported_timings_;
 
+  // When the trace events were last dumped after a janky frame. Only used on
+  // the raster thread.
+  std::optional<fml::TimePoint> last_jank_trace_dump_time_;
+
   /// Manages the displays. This class is thread safe, can be accessed from any
   /// of the threads.
   std::unique_ptr<DisplayManager> display_manager_;
@@ -518,6 +545,13 @@ class Shell final : public PlatformView::Delegate,
       const EngineCreateCallback& on_create_engine,
       bool is_gpu_disabled);
 
+  // Does the work of |Spawn| short of running the engine, which leaves the
+  // new shell idle until |RunEngine| is called.
+  std::unique_ptr<Shell> SpawnIdle(
+      const std::string& initial_route,
+      const CreateCallback<PlatformView>& on_create_platform_view,
+      const CreateCallback<Rasterizer>& on_create_rasterizer) const;
+
   bool Setup(std::unique_ptr<PlatformView> platform_view,
              std::unique_ptr<Engine> engine,
              std::unique_ptr<Rasterizer> rasterizer,
@@ -525,6 +559,10 @@ class Shell final : public PlatformView::Delegate,
 
   void ReportTimings();
 
+  // Dumps the trace events held by the trace recorder if the frame took
+  // longer than the frame budget.
+  void DumpTraceIfJanky(const FrameTiming& timing);
+
   // |PlatformView::Delegate|
   void OnPlatformViewCreated(std::unique_ptr<Surface> surface) override;
 
@@ -705,6 +743,14 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document* response);
 
+  // Service protocol handler
+  //
+  // Returns the bytes retained by every cache that is registered with the
+  // memory governor of the process, together with their peaks and budget.
+  bool OnServiceProtocolGetCacheMemoryUsage(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
   // Service protocol handler
   //
   // Renders a frame and responds with various statistics pertaining to the
@@ -726,6 +772,7 @@ class Shell final : public PlatformView::Delegate,
   std::unique_ptr<fml::TaskRunnerAffineWeakPtrFactory<Shell>> weak_factory_gpu_;
 
   fml::WeakPtrFactory<Shell> weak_factory_;
+  friend class ShellPool;
   friend class testing::ShellTest;
 
   FML_DISALLOW_COPY_AND_ASSIGN(Shell);
@@ -6,13 +6,56 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/shell_pool.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/elf_loader.h"
 #include "flutter/testing/testing.h"
 
 namespace flutter {
 
+static Settings CreateSettingsForFixtures(
+    const fml::UniqueFD& assets_dir,
+    testing::ELFAOTSymbols& aot_symbols) {
+  Settings settings = {};
+  settings.task_observer_add = [](intptr_t, fml::closure) {};
+  settings.task_observer_remove = [](intptr_t) {};
+
+  if (DartVM::IsRunningPrecompiledCode()) {
+    aot_symbols = testing::LoadELFSymbolFromFixturesIfNeccessary(
+        testing::kDefaultAOTAppELFFileName);
+    FML_CHECK(testing::PrepareSettingsForAOTWithSymbols(settings, aot_symbols))
+        << "Could not set up settings with AOT symbols.";
+  } else {
+    settings.application_kernels = [&assets_dir]() {
+      std::vector<std::unique_ptr<const fml::Mapping>> kernel_mappings;
+      kernel_mappings.emplace_back(
+          fml::FileMapping::CreateReadOnly(assets_dir, "kernel_blob.bin"));
+      return kernel_mappings;
+    };
+  }
+  return settings;
+}
+
+static std::unique_ptr<ThreadHost> CreateThreadHost() {
+  return std::make_unique<ThreadHost>(ThreadHost::ThreadHostConfig(
+      "io.flutter.bench.", ThreadHost::Type::Platform |
+                               ThreadHost::Type::RASTER |
+                               ThreadHost::Type::IO | ThreadHost::Type::UI));
+}
+
+static void PostSync(const fml::RefPtr<fml::TaskRunner>& task_runner,
+                     const fml::closure& task) {
+  fml::AutoResetWaitableEvent latch;
+  fml::TaskRunner::RunNowOrPostTask(task_runner, [&latch, &task]() {
+    task();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
 static void StartupAndShutdownShell(benchmark::State& state,
                                     bool measure_startup,
                                     bool measure_shutdown) {
@@ -24,29 +67,8 @@ static void StartupAndShutdownShell(benchmark::State& state,
 
   {
     benchmarking::ScopedPauseTiming pause(state, !measure_startup);
-    Settings settings = {};
-    settings.task_observer_add = [](intptr_t, fml::closure) {};
-    settings.task_observer_remove = [](intptr_t) {};
-
-    if (DartVM::IsRunningPrecompiledCode()) {
-      aot_symbols = testing::LoadELFSymbolFromFixturesIfNeccessary(
-          testing::kDefaultAOTAppELFFileName);
-      FML_CHECK(
-          testing::PrepareSettingsForAOTWithSymbols(settings, aot_symbols))
-          << "Could not set up settings with AOT symbols.";
-    } else {
-      settings.application_kernels = [&]() {
-        std::vector<std::unique_ptr<const fml::Mapping>> kernel_mappings;
-        kernel_mappings.emplace_back(
-            fml::FileMapping::CreateReadOnly(assets_dir, "kernel_blob.bin"));
-        return kernel_mappings;
-      };
-    }
-
-    thread_host = std::make_unique<ThreadHost>(ThreadHost::ThreadHostConfig(
-        "io.flutter.bench.", ThreadHost::Type::Platform |
-                                 ThreadHost::Type::RASTER |
-                                 ThreadHost::Type::IO | ThreadHost::Type::UI));
+    Settings settings = CreateSettingsForFixtures(assets_dir, aot_symbols);
+    thread_host = CreateThreadHost();
 
     TaskRunners task_runners("test",
                              thread_host->platform_thread->GetTaskRunner(),
@@ -120,4 +142,86 @@ static void BM_ShellInitializationAndShutdown(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitializationAndShutdown);
 
+// Measures the time it takes on the platform thread to get a running shell
+// spawned from another one, either directly or from a pool of idle shells.
+static void BM_ShellSpawn(benchmark::State& state, bool use_pool) {
+  auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
+                                       fml::FilePermission::kRead);
+  testing::ELFAOTSymbols aot_symbols;
+  Settings settings = CreateSettingsForFixtures(assets_dir, aot_symbols);
+  std::unique_ptr<ThreadHost> thread_host = CreateThreadHost();
+  TaskRunners task_runners("test",
+                           thread_host->platform_thread->GetTaskRunner(),
+                           thread_host->raster_thread->GetTaskRunner(),
+                           thread_host->ui_thread->GetTaskRunner(),
+                           thread_host->io_thread->GetTaskRunner());
+  auto platform_task_runner = task_runners.GetPlatformTaskRunner();
+  Shell::CreateCallback<PlatformView> on_create_platform_view =
+      [](Shell& shell) {
+        return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
+      };
+  Shell::CreateCallback<Rasterizer> on_create_rasterizer = [](Shell& shell) {
+    return std::make_unique<Rasterizer>(shell);
+  };
+  auto create_configuration = [&settings]() {
+    RunConfiguration configuration =
+        RunConfiguration::InferFromSettings(settings);
+    configuration.SetEntrypoint("emptyMain");
+    return configuration;
+  };
+
+  std::unique_ptr<Shell> shell;
+  std::unique_ptr<ShellPool> pool;
+  fml::AutoResetWaitableEvent launched;
+  PostSync(platform_task_runner, [&]() {
+    shell = Shell::Create(PlatformData(), task_runners, settings,
+                          on_create_platform_view, on_create_rasterizer);
+    FML_CHECK(shell);
+    shell->RunEngine(create_configuration(),
+                     [&launched](Engine::RunStatus status) {
+                       FML_CHECK(status == Engine::RunStatus::Success);
+                       launched.Signal();
+                     });
+  });
+  launched.Wait();
+  if (use_pool) {
+    PostSync(platform_task_runner, [&]() {
+      pool = std::make_unique<ShellPool>(*shell, on_create_platform_view,
+                                         on_create_rasterizer);
+      pool->SetIdleShellCount(1);
+    });
+  }
+
+  while (state.KeepRunning()) {
+    fml::TimeDelta spawn_time;
+    PostSync(platform_task_runner, [&]() {
+      const fml::TimePoint start = fml::TimePoint::Now();
+      std::unique_ptr<Shell> spawn =
+          pool ? pool->Spawn(create_configuration(), "/")
+               : shell->Spawn(create_configuration(), "/",
+                              on_create_platform_view, on_create_rasterizer);
+      spawn_time = fml::TimePoint::Now() - start;
+      FML_CHECK(spawn);
+      spawn.reset();
+    });
+    // Lets the pool replace the shell it handed out, which happens in a task
+    // posted by the spawn.
+    PostSync(platform_task_runner, []() {});
+    state.SetIterationTime(spawn_time.ToSecondsF());
+  }
+
+  PostSync(platform_task_runner, [&]() {
+    pool.reset();
+    shell.reset();
+  });
+  thread_host.reset();
+}
+
+BENCHMARK_CAPTURE(BM_ShellSpawn, Direct, false)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ShellSpawn, FromPool, true)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
 }  // namespace flutter
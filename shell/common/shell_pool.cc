@@ -0,0 +1,141 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/shell_pool.h"
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+ShellPool::ShellPool(
+    const Shell& spawner,
+    Shell::CreateCallback<PlatformView> on_create_platform_view,
+    Shell::CreateCallback<Rasterizer> on_create_rasterizer)
+    : spawner_(spawner),
+      on_create_platform_view_(std::move(on_create_platform_view)),
+      on_create_rasterizer_(std::move(on_create_rasterizer)),
+      weak_factory_(this) {
+  FML_DCHECK(spawner_.GetTaskRunners()
+                 .GetPlatformTaskRunner()
+                 ->RunsTasksOnCurrentThread());
+  // Idle shells do not report a size, as most of what they retain is shared
+  // with the spawner, so only memory pressure drops them. The trim is always
+  // posted because destroying shells unregisters their caches from other
+  // threads, which waits for the running trims to finish.
+  registration_ = fml::MemoryGovernor::GetInstance().Register(
+      "ShellPool", fml::MemoryGovernor::Priority::kLow,
+      [pool = weak_factory_.GetWeakPtr(),
+       platform_task_runner =
+           spawner_.GetTaskRunners().GetPlatformTaskRunner()](size_t) {
+        platform_task_runner->PostTask([pool]() {
+          if (pool) {
+            pool->Trim();
+          }
+        });
+      });
+}
+
+ShellPool::~ShellPool() {
+  FML_DCHECK(spawner_.GetTaskRunners()
+                 .GetPlatformTaskRunner()
+                 ->RunsTasksOnCurrentThread());
+}
+
+void ShellPool::SetIdleShellCount(size_t count) {
+  TRACE_EVENT1("flutter", "ShellPool::SetIdleShellCount", "count",
+               std::to_string(count).c_str());
+  idle_shell_count_ = count;
+  while (idle_shells_.size() > idle_shell_count_) {
+    idle_shells_.pop_back();
+  }
+  while (idle_shells_.size() < idle_shell_count_) {
+    std::unique_ptr<Shell> shell = SpawnIdleShell();
+    if (!shell) {
+      return;
+    }
+    idle_shells_.push_back(std::move(shell));
+  }
+}
+
+size_t ShellPool::GetIdleShellCount() const {
+  return idle_shells_.size();
+}
+
+std::unique_ptr<Shell> ShellPool::Spawn(RunConfiguration run_configuration,
+                                        const std::string& initial_route) {
+  TRACE_EVENT0("flutter", "ShellPool::Spawn");
+  if (idle_shells_.empty()) {
+    ScheduleRefill();
+    return spawner_.Spawn(std::move(run_configuration), initial_route,
+                          on_create_platform_view_, on_create_rasterizer_);
+  }
+
+  std::unique_ptr<Shell> shell = std::move(idle_shells_.front());
+  idle_shells_.pop_front();
+  // Running the engine is posted to the UI task runner as well, so the route
+  // and the current platform data of the spawner, which may have changed
+  // since the shell was spawned, are set before the root isolate starts.
+  fml::TaskRunner::RunNowOrPostTask(
+      shell->GetTaskRunners().GetUITaskRunner(),
+      [engine = shell->GetEngine(), spawner = spawner_.GetEngine(),
+       initial_route]() {
+        if (!engine) {
+          return;
+        }
+        if (spawner) {
+          engine->CopyPlatformDataFrom(*spawner);
+        }
+        engine->SetInitialRoute(initial_route);
+      });
+  shell->RunEngine(std::move(run_configuration));
+  ScheduleRefill();
+  return shell;
+}
+
+void ShellPool::Trim() {
+  TRACE_EVENT0("flutter", "ShellPool::Trim");
+  idle_shells_.clear();
+  // Drops the pending refill, if any.
+  refill_generation_++;
+  refill_pending_ = false;
+}
+
+std::unique_ptr<Shell> ShellPool::SpawnIdleShell() const {
+  TRACE_EVENT0("flutter", "ShellPool::SpawnIdleShell");
+  std::unique_ptr<Shell> shell = spawner_.SpawnIdle(
+      /*initial_route=*/"", on_create_platform_view_, on_create_rasterizer_);
+  if (!shell) {
+    FML_LOG(ERROR) << "Could not spawn an idle shell.";
+  }
+  return shell;
+}
+
+void ShellPool::ScheduleRefill() {
+  if (refill_pending_ || idle_shells_.size() >= idle_shell_count_) {
+    return;
+  }
+  refill_pending_ = true;
+  spawner_.GetTaskRunners().GetPlatformTaskRunner()->PostTask(
+      [pool = weak_factory_.GetWeakPtr(), generation = refill_generation_]() {
+        if (pool && pool->refill_generation_ == generation) {
+          pool->Refill();
+        }
+      });
+}
+
+void ShellPool::Refill() {
+  refill_pending_ = false;
+  if (idle_shells_.size() >= idle_shell_count_) {
+    return;
+  }
+  std::unique_ptr<Shell> shell = SpawnIdleShell();
+  if (!shell) {
+    return;
+  }
+  idle_shells_.push_back(std::move(shell));
+  ScheduleRefill();
+}
+
+}  // namespace flutter
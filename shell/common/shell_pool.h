@@ -0,0 +1,103 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_SHELL_POOL_H_
+#define FLUTTER_SHELL_COMMON_SHELL_POOL_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/memory_governor.h"
+#include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/shell/common/run_configuration.h"
+#include "flutter/shell/common/shell.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Keeps a number of shells spawned from another shell ready, so
+///             that additional engine instances can be handed out without
+///             paying for the creation of their platform view, rasterizer,
+///             engine and runtime controller.
+///
+///             The idle shells have not run their engine yet. Spawning from
+///             the pool hands out an idle shell, copies the current platform
+///             data of the spawner into it, sets its initial route and runs
+///             the given configuration, which launches the root isolate in the
+///             isolate group of the spawner. The pool then replaces the shell
+///             it handed out in a task of its own, so that the caller does not
+///             wait for it.
+///
+///             Idle shells are dropped when the system runs low on memory, and
+///             are only replaced by the next spawn.
+///
+///             The pool, like the shells it holds, must be created, used and
+///             destroyed on the platform task runner of the spawner. It must
+///             be destroyed before the spawner.
+///
+class ShellPool {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      Creates an empty pool of shells spawned from |spawner| with
+  ///             the given callbacks.
+  ///
+  /// @see        Shell::Spawn
+  ///
+  ShellPool(const Shell& spawner,
+            Shell::CreateCallback<PlatformView> on_create_platform_view,
+            Shell::CreateCallback<Rasterizer> on_create_rasterizer);
+
+  ~ShellPool();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the number of idle shells to keep ready. The missing
+  ///             shells are spawned before this returns, and the extra ones
+  ///             are destroyed.
+  ///
+  void SetIdleShellCount(size_t count);
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of idle shells that are ready to be handed out.
+  ///
+  size_t GetIdleShellCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The equivalent of `Shell::Spawn` that hands out an idle shell
+  ///             if there is one, and spawns a new shell otherwise.
+  ///
+  std::unique_ptr<Shell> Spawn(RunConfiguration run_configuration,
+                               const std::string& initial_route);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Destroys all idle shells. They are replaced by the next spawn.
+  ///
+  void Trim();
+
+ private:
+  const Shell& spawner_;
+  const Shell::CreateCallback<PlatformView> on_create_platform_view_;
+  const Shell::CreateCallback<Rasterizer> on_create_rasterizer_;
+  size_t idle_shell_count_ = 0;
+  std::deque<std::unique_ptr<Shell>> idle_shells_;
+  bool refill_pending_ = false;
+  // Incremented by |Trim| so that pending refills are dropped.
+  size_t refill_generation_ = 0;
+  std::unique_ptr<fml::MemoryGovernor::Registration> registration_;
+  fml::WeakPtrFactory<ShellPool> weak_factory_;
+
+  std::unique_ptr<Shell> SpawnIdleShell() const;
+
+  // Spawns one missing idle shell per task until the pool is full again.
+  void ScheduleRefill();
+
+  void Refill();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ShellPool);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_SHELL_POOL_H_
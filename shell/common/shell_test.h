@@ -107,6 +107,7 @@ class ShellTest : public FixtureTest {
     kSetAssetBundlePath,
     kRunInView,
     kRenderFrameWithRasterStats,
+    kGetCacheMemoryUsage,
   };
 
   // Helper method to test private method Shell::OnServiceProtocolGetSkSLs.
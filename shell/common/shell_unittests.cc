@@ -25,6 +25,7 @@
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
+#include "flutter/shell/common/shell_pool.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/shell_test_external_view_embedder.h"
 #include "flutter/shell/common/shell_test_platform_view.h"
@@ -38,6 +39,10 @@
 #include "third_party/skia/include/core/SkPictureRecorder.h"
 #include "third_party/tonic/converter/dart_converter.h"
 
+#if defined(FML_OS_LINUX) || defined(FML_OS_ANDROID)
+#include <sys/resource.h>
+#endif
+
 #ifdef SHELL_ENABLE_VULKAN
 #include "flutter/vulkan/vulkan_application.h"  // nogncheck
 #endif
@@ -308,6 +313,31 @@ TEST_F(ShellTest, InitializeWithDifferentThreads) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
 }
 
+#if defined(FML_OS_LINUX) || defined(FML_OS_ANDROID)
+TEST_F(ShellTest, ThreadHostAppliesThreadPoliciesPerRole) {
+  ThreadHost::ThreadHostConfig host_config(
+      "io.flutter.test." + GetCurrentTestName() + ".",
+      ThreadHost::Type::RASTER | ThreadHost::Type::UI);
+  ThreadPolicy policy;
+  policy.nice = 19;
+  host_config.SetThreadPolicy(ThreadHost::Type::RASTER, policy);
+  ThreadHost thread_host(host_config);
+
+  int raster_nice = 0;
+  int ui_nice = 0;
+  fml::TaskRunner::RunNowOrPostTask(
+      thread_host.raster_thread->GetTaskRunner(),
+      [&raster_nice]() { raster_nice = getpriority(PRIO_PROCESS, 0); });
+  fml::TaskRunner::RunNowOrPostTask(
+      thread_host.ui_thread->GetTaskRunner(),
+      [&ui_nice]() { ui_nice = getpriority(PRIO_PROCESS, 0); });
+  thread_host.raster_thread->Join();
+  thread_host.ui_thread->Join();
+  ASSERT_EQ(raster_nice, 19);
+  ASSERT_NE(ui_nice, 19);
+}
+#endif
+
 TEST_F(ShellTest, InitializeWithSingleThread) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
   Settings settings = CreateSettingsForFixture();
@@ -2469,6 +2499,37 @@ TEST_F(ShellTest, OnServiceProtocolEstimateRasterCacheMemoryWorks) {
   DestroyShell(std::move(shell));
 }
 
+TEST_F(ShellTest, OnServiceProtocolGetCacheMemoryUsageListsRasterizerCaches) {
+  Settings settings = CreateSettingsForFixture();
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+
+  ServiceProtocol::Handler::ServiceProtocolMap empty_params;
+  rapidjson::Document document;
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kGetCacheMemoryUsage,
+                    shell->GetTaskRunners().GetIOTaskRunner(), empty_params,
+                    &document);
+  ASSERT_TRUE(document.IsObject());
+  EXPECT_STREQ(document["type"].GetString(), "CacheMemoryUsage");
+  ASSERT_TRUE(document["caches"].IsArray());
+
+  bool has_raster_cache = false;
+  bool has_resource_cache = false;
+  for (const auto& cache : document["caches"].GetArray()) {
+    const std::string name = cache["name"].GetString();
+    if (name == "RasterCache") {
+      has_raster_cache = true;
+      EXPECT_STREQ(cache["priority"].GetString(), "high");
+    } else if (name == "SkiaResourceCache") {
+      has_resource_cache = true;
+      EXPECT_STREQ(cache["priority"].GetString(), "normal");
+    }
+  }
+  EXPECT_TRUE(has_raster_cache);
+  EXPECT_TRUE(has_resource_cache);
+
+  DestroyShell(std::move(shell));
+}
+
 // ktz
 TEST_F(ShellTest, OnServiceProtocolRenderFrameWithRasterStatsWorks) {
   auto settings = CreateSettingsForFixture();
@@ -3170,6 +3231,123 @@ TEST_F(ShellTest, IOManagerIsSharedBetweenParentAndSpawnedShell) {
   DestroyShell(std::move(shell));
 }
 
+TEST_F(ShellTest, ShellPoolHandsOutIdleShellsAndRefills) {
+  auto settings = CreateSettingsForFixture();
+  auto shell = CreateShell(settings);
+  ASSERT_TRUE(ValidateShell(shell.get()));
+  auto platform_task_runner = shell->GetTaskRunners().GetPlatformTaskRunner();
+
+  MockPlatformViewDelegate platform_view_delegate;
+  std::unique_ptr<ShellPool> pool;
+  std::unique_ptr<Shell> spawn;
+  const std::string initial_route("/foo");
+  PostSync(platform_task_runner, [&] {
+    pool = std::make_unique<ShellPool>(
+        *shell,
+        [&platform_view_delegate](Shell& shell) {
+          auto result = std::make_unique<MockPlatformView>(
+              platform_view_delegate, shell.GetTaskRunners());
+          ON_CALL(*result, CreateRenderingSurface())
+              .WillByDefault(::testing::Invoke(
+                  [] { return std::make_unique<MockSurface>(); }));
+          return result;
+        },
+        [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+    pool->SetIdleShellCount(1);
+    ASSERT_EQ(pool->GetIdleShellCount(), 1u);
+
+    auto configuration = RunConfiguration::InferFromSettings(settings);
+    ASSERT_TRUE(configuration.IsValid());
+    configuration.SetEntrypoint("emptyMain");
+    spawn = pool->Spawn(std::move(configuration), initial_route);
+    ASSERT_TRUE(ValidateShell(spawn.get()));
+    ASSERT_EQ(pool->GetIdleShellCount(), 0u);
+  });
+
+  PostSync(spawn->GetTaskRunners().GetUITaskRunner(), [&] {
+    ASSERT_EQ("emptyMain", spawn->GetEngine()->GetLastEntrypoint());
+    ASSERT_EQ(initial_route, spawn->GetEngine()->InitialRoute());
+  });
+
+  // The shell that was handed out has been replaced in a separate task, and
+  // idle shells are dropped under memory pressure.
+  PostSync(platform_task_runner, [&] {
+    ASSERT_EQ(pool->GetIdleShellCount(), 1u);
+    fml::MemoryGovernor::GetInstance().NotifyPressure(
+        fml::MemoryGovernor::Pressure::kModerate);
+  });
+  PostSync(platform_task_runner, [&] {
+    ASSERT_EQ(pool->GetIdleShellCount(), 0u);
+    pool.reset();
+  });
+
+  DestroyShell(std::move(spawn));
+  DestroyShell(std::move(shell));
+}
+
+TEST_F(ShellTest, ShellPoolHandsOutShellsWithTheCurrentPlatformData) {
+  auto settings = CreateSettingsForFixture();
+  auto shell = CreateShell(settings);
+  ASSERT_TRUE(ValidateShell(shell.get()));
+  auto platform_task_runner = shell->GetTaskRunners().GetPlatformTaskRunner();
+
+  MockPlatformViewDelegate platform_view_delegate;
+  std::unique_ptr<ShellPool> pool;
+  PostSync(platform_task_runner, [&] {
+    pool = std::make_unique<ShellPool>(
+        *shell,
+        [&platform_view_delegate](Shell& shell) {
+          auto result = std::make_unique<MockPlatformView>(
+              platform_view_delegate, shell.GetTaskRunners());
+          ON_CALL(*result, CreateRenderingSurface())
+              .WillByDefault(::testing::Invoke(
+                  [] { return std::make_unique<MockSurface>(); }));
+          return result;
+        },
+        [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+    pool->SetIdleShellCount(1);
+    ASSERT_EQ(pool->GetIdleShellCount(), 1u);
+  });
+
+  // The locale of the spawner changes after the idle shell was spawned.
+  const std::vector<std::string> locale_data = {"fr", "CA", "", ""};
+  PostSync(shell->GetTaskRunners().GetUITaskRunner(), [&] {
+    std::string request_json = R"json({
+                                  "method": "setLocale",
+                                  "args": ["fr", "CA", "", ""]
+                                })json";
+    auto data =
+        fml::MallocMapping::Copy(request_json.c_str(), request_json.length());
+    shell->GetEngine()->DispatchPlatformMessage(
+        std::make_unique<PlatformMessage>("flutter/localization",
+                                          std::move(data), nullptr));
+    ASSERT_EQ(shell->GetEngine()->GetRuntimeController()
+                  ->GetPlatformData()
+                  .locale_data,
+              locale_data);
+  });
+
+  std::unique_ptr<Shell> spawn;
+  PostSync(platform_task_runner, [&] {
+    auto configuration = RunConfiguration::InferFromSettings(settings);
+    ASSERT_TRUE(configuration.IsValid());
+    configuration.SetEntrypoint("emptyMain");
+    spawn = pool->Spawn(std::move(configuration), "/");
+    ASSERT_TRUE(ValidateShell(spawn.get()));
+  });
+
+  PostSync(spawn->GetTaskRunners().GetUITaskRunner(), [&] {
+    EXPECT_EQ(spawn->GetEngine()->GetRuntimeController()
+                  ->GetPlatformData()
+                  .locale_data,
+              locale_data);
+  });
+
+  PostSync(platform_task_runner, [&] { pool.reset(); });
+  DestroyShell(std::move(spawn));
+  DestroyShell(std::move(shell));
+}
+
 TEST_F(ShellTest, IOManagerInSpawnedShellIsNotNullAfterParentShellDestroyed) {
   auto settings = CreateSettingsForFixture();
   auto shell = CreateShell(settings);
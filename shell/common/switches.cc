@@ -6,6 +6,7 @@
 #include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <optional>
 #include <sstream>
 #include <string>
 
@@ -179,6 +180,82 @@ static bool IsAllowedDartVMFlag(const std::string& flag) {
   return false;
 }
 
+static bool ParseInt(const std::string& input, int* result) {
+  std::istringstream stream(input);
+  int value = 0;
+  if (!(stream >> value) || !stream.eof()) {
+    return false;
+  }
+  *result = value;
+  return true;
+}
+
+// Parses a thread policy such as "cpus=2,3:nice=-10:scheduler=fifo:priority=2"
+// into |policy|. Returns false on any field that is not understood.
+static bool ParseThreadPolicy(const std::string& input,
+                              fml::Thread::ThreadPolicy* policy) {
+  using Scheduler = fml::Thread::ThreadPolicy::Scheduler;
+  std::istringstream ss(input);
+  std::string field;
+  while (std::getline(ss, field, ':')) {
+    const size_t equals = field.find('=');
+    if (equals == std::string::npos) {
+      return false;
+    }
+    const std::string key = field.substr(0, equals);
+    const std::string value = field.substr(equals + 1);
+    if (key == "cpus") {
+      policy->cpus.clear();
+      for (const auto& cpu_string : ParseCommaDelimited(value)) {
+        int cpu = 0;
+        if (!ParseInt(cpu_string, &cpu) || cpu < 0) {
+          return false;
+        }
+        policy->cpus.push_back(cpu);
+      }
+    } else if (key == "nice") {
+      int nice = 0;
+      if (!ParseInt(value, &nice) || nice < -20 || nice > 19) {
+        return false;
+      }
+      policy->nice = nice;
+    } else if (key == "scheduler") {
+      if (value == "default") {
+        policy->scheduler = Scheduler::kDefault;
+      } else if (value == "fifo") {
+        policy->scheduler = Scheduler::kFifo;
+      } else if (value == "rr") {
+        policy->scheduler = Scheduler::kRoundRobin;
+      } else {
+        return false;
+      }
+    } else if (key == "priority") {
+      if (!ParseInt(value, &policy->realtime_priority)) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::optional<fml::Thread::ThreadPolicy> GetThreadPolicy(
+    const fml::CommandLine& command_line,
+    Switch sw) {
+  std::string policy_string;
+  if (!command_line.GetOptionValue(FlagForSwitch(sw), &policy_string)) {
+    return std::nullopt;
+  }
+  fml::Thread::ThreadPolicy policy;
+  if (!ParseThreadPolicy(policy_string, &policy)) {
+    FML_LOG(ERROR) << "Invalid value for --" << FlagForSwitch(sw) << ": '"
+                   << policy_string << "'. It is ignored.";
+    return std::nullopt;
+  }
+  return policy;
+}
+
 template <typename T>
 static bool GetSwitchValue(const fml::CommandLine& command_line,
                            Switch sw,
@@ -302,6 +379,12 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.trace_startup =
       command_line.HasOption(FlagForSwitch(Switch::TraceStartup));
 
+  settings.trace_recorder =
+      command_line.HasOption(FlagForSwitch(Switch::TraceRecorder));
+
+  settings.dump_trace_on_jank =
+      command_line.HasOption(FlagForSwitch(Switch::DumpTraceOnJank));
+
   settings.enable_serial_gc =
       command_line.HasOption(FlagForSwitch(Switch::EnableSerialGC));
 
@@ -427,6 +510,12 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.enable_impeller =
       command_line.HasOption(FlagForSwitch(Switch::EnableImpeller));
 
+  settings.enable_pointer_resampling =
+      command_line.HasOption(FlagForSwitch(Switch::EnablePointerResampling));
+
+  settings.enable_adaptive_pipeline_depth = command_line.HasOption(
+      FlagForSwitch(Switch::EnableAdaptivePipelineDepth));
+
   settings.prefetched_default_font_manager = command_line.HasOption(
       FlagForSwitch(Switch::PrefetchedDefaultFontManager));
 
@@ -473,6 +562,13 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
         std::stoi(resource_cache_max_bytes_threshold);
   }
 
+  if (command_line.HasOption(FlagForSwitch(Switch::MemoryBudgetBytes))) {
+    std::string memory_budget_bytes;
+    command_line.GetOptionValue(FlagForSwitch(Switch::MemoryBudgetBytes),
+                                &memory_budget_bytes);
+    settings.memory_budget_bytes = std::stoull(memory_budget_bytes);
+  }
+
   if (command_line.HasOption(FlagForSwitch(Switch::MsaaSamples))) {
     std::string msaa_samples;
     command_line.GetOptionValue(FlagForSwitch(Switch::MsaaSamples),
@@ -494,6 +590,16 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
                       << "' (expected 0, 1, 2, 4, 8, or 16).";
     }
   }
+
+  settings.ui_thread_policy =
+      GetThreadPolicy(command_line, Switch::UIThreadPolicy);
+  settings.raster_thread_policy =
+      GetThreadPolicy(command_line, Switch::RasterThreadPolicy);
+  settings.io_thread_policy =
+      GetThreadPolicy(command_line, Switch::IOThreadPolicy);
+  settings.concurrent_worker_thread_policy =
+      GetThreadPolicy(command_line, Switch::ConcurrentWorkerThreadPolicy);
+
   return settings;
 }
 
@@ -134,6 +134,15 @@ DEF_SWITCH(TraceStartup,
            "trace-startup",
            "Trace early application lifecycle. Automatically switches to an "
            "endless trace buffer.")
+DEF_SWITCH(TraceRecorder,
+           "trace-recorder",
+           "Record the trace events in memory, without the Dart timeline, so "
+           "that they can be dumped to Chrome JSON or Perfetto traces.")
+DEF_SWITCH(DumpTraceOnJank,
+           "dump-trace-on-jank",
+           "Record the trace events in memory and dump them to the temporary "
+           "directory when a frame takes longer than the frame budget. Dumps "
+           "are at least ten seconds apart.")
 DEF_SWITCH(TraceSkia,
            "trace-skia",
            "Trace Skia calls. This is useful when debugging the GPU threed."
@@ -229,6 +238,11 @@ DEF_SWITCH(OldGenHeapSize,
 DEF_SWITCH(ResourceCacheMaxBytesThreshold,
            "resource-cache-max-bytes-threshold",
            "The max bytes threshold of resource cache, or 0 for unlimited.")
+DEF_SWITCH(MemoryBudgetBytes,
+           "memory-budget-bytes",
+           "The number of bytes that the caches of the engine may retain "
+           "together before the least important of them are trimmed, or 0 "
+           "for unlimited.")
 DEF_SWITCH(EnableSkParagraph,
            "enable-skparagraph",
            "Selects the SkParagraph implementation of the text layout engine.")
@@ -236,6 +250,33 @@ DEF_SWITCH(EnableImpeller,
            "enable-impeller",
            "Enable the Impeller renderer on supported platforms. Ignored if "
            "Impeller is not supported on the platform.")
+DEF_SWITCH(EnablePointerResampling,
+           "enable-pointer-resampling",
+           "Coalesce pointer move events and resample their positions to the "
+           "frame time, delivering at most one pointer packet per frame.")
+DEF_SWITCH(EnableAdaptivePipelineDepth,
+           "enable-adaptive-pipeline-depth",
+           "Adjust how many frames the UI thread may build ahead of the raster "
+           "thread, and how long after vsync frames start, from the timings "
+           "of recent frames.")
+DEF_SWITCH(UIThreadPolicy,
+           "ui-thread-policy",
+           "The CPU affinity and scheduling policy of the UI thread, as "
+           "colon separated fields such as 'cpus=2,3:nice=-10:scheduler=fifo:"
+           "priority=2'. The scheduler is one of 'default', 'fifo' or 'rr'. "
+           "Fields that are left out are not changed.")
+DEF_SWITCH(RasterThreadPolicy,
+           "raster-thread-policy",
+           "The CPU affinity and scheduling policy of the raster thread, in "
+           "the format of --ui-thread-policy.")
+DEF_SWITCH(IOThreadPolicy,
+           "io-thread-policy",
+           "The CPU affinity and scheduling policy of the IO thread, in the "
+           "format of --ui-thread-policy.")
+DEF_SWITCH(ConcurrentWorkerThreadPolicy,
+           "concurrent-worker-thread-policy",
+           "The CPU affinity and scheduling policy of the workers of the "
+           "concurrent message loop, in the format of --ui-thread-policy.")
 DEF_SWITCH(LeakVM,
            "leak-vm",
            "When the last shell shuts down, the shared VM is leaked by default "
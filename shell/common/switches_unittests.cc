@@ -76,5 +76,42 @@ TEST(SwitchesTest, MsaaSamples) {
   EXPECT_EQ(settings.msaa_samples, 0);
 }
 
+TEST(SwitchesTest, ThreadPolicies) {
+  using Scheduler = fml::Thread::ThreadPolicy::Scheduler;
+  fml::CommandLine command_line = fml::CommandLineFromInitializerList(
+      {"command", "--ui-thread-policy=cpus=2,3:nice=-10",
+       "--raster-thread-policy=scheduler=fifo:priority=2",
+       "--concurrent-worker-thread-policy=cpus=0,1:scheduler=default"});
+  Settings settings = SettingsFromCommandLine(command_line);
+
+  ASSERT_TRUE(settings.ui_thread_policy.has_value());
+  EXPECT_EQ(settings.ui_thread_policy->cpus, std::vector<int>({2, 3}));
+  EXPECT_EQ(settings.ui_thread_policy->nice, -10);
+  EXPECT_EQ(settings.ui_thread_policy->scheduler, Scheduler::kDefault);
+
+  ASSERT_TRUE(settings.raster_thread_policy.has_value());
+  EXPECT_TRUE(settings.raster_thread_policy->cpus.empty());
+  EXPECT_FALSE(settings.raster_thread_policy->nice.has_value());
+  EXPECT_EQ(settings.raster_thread_policy->scheduler, Scheduler::kFifo);
+  EXPECT_EQ(settings.raster_thread_policy->realtime_priority, 2);
+
+  EXPECT_FALSE(settings.io_thread_policy.has_value());
+
+  ASSERT_TRUE(settings.concurrent_worker_thread_policy.has_value());
+  EXPECT_EQ(settings.concurrent_worker_thread_policy->cpus,
+            std::vector<int>({0, 1}));
+}
+
+TEST(SwitchesTest, InvalidThreadPoliciesAreIgnored) {
+  for (const char* policy :
+       {"cpus=a", "cpus=-1", "nice=20", "nice=1x", "scheduler=batch",
+        "priority=", "affinity=2", "nice"}) {
+    fml::CommandLine command_line = fml::CommandLineFromInitializerList(
+        {"command", (std::string("--io-thread-policy=") + policy).c_str()});
+    Settings settings = SettingsFromCommandLine(command_line);
+    EXPECT_FALSE(settings.io_thread_policy.has_value()) << policy;
+  }
+}
+
 }  // namespace testing
 }  // namespace flutter
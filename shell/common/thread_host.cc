@@ -56,6 +56,11 @@ void ThreadHost::ThreadHostConfig::SetProfilerConfig(
   profiler_config = config;
 }
 
+void ThreadHost::ThreadHostConfig::SetThreadPolicy(Type type,
+                                                   const ThreadPolicy& policy) {
+  thread_policies[type] = policy;
+}
+
 std::unique_ptr<fml::Thread> ThreadHost::CreateThread(
     Type type,
     std::optional<ThreadConfig> thread_config,
@@ -65,8 +70,15 @@ std::unique_ptr<fml::Thread> ThreadHost::CreateThread(
     thread_config = ThreadConfig(
         ThreadHostConfig::MakeThreadName(type, host_config.name_prefix));
   }
-  return std::make_unique<fml::Thread>(host_config.config_setter,
-                                       thread_config.value());
+  ThreadConfigSetter setter = host_config.config_setter;
+  auto policy = host_config.thread_policies.find(type);
+  if (policy != host_config.thread_policies.end()) {
+    setter = [setter, policy = policy->second](const ThreadConfig& config) {
+      setter(config);
+      fml::Thread::SetCurrentThreadPolicy(policy);
+    };
+  }
+  return std::make_unique<fml::Thread>(setter, thread_config.value());
 }
 
 ThreadHost::ThreadHost() = default;
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_SHELL_COMMON_THREAD_HOST_H_
 #define FLUTTER_SHELL_COMMON_THREAD_HOST_H_
 
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -16,6 +17,7 @@ namespace flutter {
 
 using ThreadConfig = fml::Thread::ThreadConfig;
 using ThreadConfigSetter = fml::Thread::ThreadConfigSetter;
+using ThreadPolicy = fml::Thread::ThreadPolicy;
 
 /// The collection of all the threads used by the engine.
 struct ThreadHost {
@@ -66,6 +68,10 @@ struct ThreadHost {
     /// Specified the ProfilerThread  Config, meanwhile set the mask.
     void SetProfilerConfig(const ThreadConfig&);
 
+    /// Specified the CPU affinity and scheduling policy of the thread of the
+    /// given type. It is applied after the config setter has run.
+    void SetThreadPolicy(Type type, const ThreadPolicy& policy);
+
     uint64_t type_mask;
 
     std::string name_prefix = "";
@@ -77,6 +83,8 @@ struct ThreadHost {
     std::optional<ThreadConfig> raster_config;
     std::optional<ThreadConfig> io_config;
     std::optional<ThreadConfig> profiler_config;
+
+    std::map<Type, ThreadPolicy> thread_policies;
   };
 
   std::string name_prefix;
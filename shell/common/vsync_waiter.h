@@ -32,6 +32,10 @@ class VsyncWaiter : public std::enable_shared_from_this<VsyncWaiter> {
   /// |Animator::ScheduleMaybeClearTraceFlowIds|.
   void ScheduleSecondaryCallback(uintptr_t id, const fml::closure& callback);
 
+  /// Whether the callbacks are paced by a display. Waiters that fire as soon
+  /// as they are asked to return false.
+  virtual bool IsPacedByDisplay() const { return true; }
+
  protected:
   // On some backends, the |FireCallback| needs to be made from a static C
   // method.
@@ -4,6 +4,7 @@
 
 #include "flutter/shell/gpu/gpu_surface_gl_impeller.h"
 
+#include "flutter/display_list/display_list_static_dispatch.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/impeller/display_list/display_list_dispatcher.h"
 #include "flutter/impeller/renderer/backend/gles/surface_gles.h"
@@ -103,7 +104,7 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceGLImpeller::AcquireFrame(
         }
 
         impeller::DisplayListDispatcher impeller_dispatcher;
-        display_list->Dispatch(impeller_dispatcher);
+        display_list->StaticDispatch(impeller_dispatcher);
         auto picture = impeller_dispatcher.EndRecordingAsPicture();
 
         return renderer->Render(
@@ -7,6 +7,7 @@
 #import <Metal/Metal.h>
 #import <QuartzCore/QuartzCore.h>
 
+#include "flutter/display_list/display_list_static_dispatch.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/mapping.h"
 #include "flutter/impeller/display_list/display_list_dispatcher.h"
@@ -31,7 +32,12 @@ GPUSurfaceMetalImpeller::GPUSurfaceMetalImpeller(GPUSurfaceMetalDelegate* delega
     : delegate_(delegate),
       impeller_renderer_(CreateImpellerRenderer(context)),
       aiks_context_(
-          std::make_shared<impeller::AiksContext>(impeller_renderer_ ? context : nullptr)) {}
+          std::make_shared<impeller::AiksContext>(impeller_renderer_ ? context : nullptr)) {
+  // Start creating the pipeline variants of the first frames while the engine is still starting
+  // up. Metal creates them concurrently. Onscreen targets are multisampled by SurfaceMTL.
+  aiks_context_->PrecompilePipelines(
+      impeller::ContentContext::GetCommonPipelineVariants(impeller::SampleCount::kCount4));
+}
 
 GPUSurfaceMetalImpeller::~GPUSurfaceMetalImpeller() = default;
 
@@ -74,7 +80,7 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetalImpeller::AcquireFrame(const SkISiz
         }
 
         impeller::DisplayListDispatcher impeller_dispatcher;
-        display_list->Dispatch(impeller_dispatcher);
+        display_list->StaticDispatch(impeller_dispatcher);
         auto picture = impeller_dispatcher.EndRecordingAsPicture();
 
         return renderer->Render(
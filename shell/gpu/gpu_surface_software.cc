@@ -54,6 +54,17 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
     return nullptr;
   }
 
+  const bool retains_contents = delegate_->BackingStoreRetainsContents();
+  if (retains_contents) {
+    framebuffer_info.supports_partial_repaint = true;
+    // Only a backing store that holds the last presented frame can be
+    // partially repainted.
+    if (backing_store == last_presented_backing_store_) {
+      framebuffer_info.existing_damage = SkIRect::MakeEmpty();
+    }
+    last_presented_backing_store_ = nullptr;
+  }
+
   // If the surface has been scaled, we need to apply the inverse scaling to the
   // underlying canvas so that coordinates are mapped to the same spot
   // irrespective of surface scaling.
@@ -61,8 +72,8 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
   canvas->resetMatrix();
 
   SurfaceFrame::SubmitCallback on_submit =
-      [self = weak_factory_.GetWeakPtr()](const SurfaceFrame& surface_frame,
-                                          SkCanvas* canvas) -> bool {
+      [self = weak_factory_.GetWeakPtr(), retains_contents](
+          const SurfaceFrame& surface_frame, SkCanvas* canvas) -> bool {
     // If the surface itself went away, there is nothing more to do.
     if (!self || !self->IsValid() || canvas == nullptr) {
       return false;
@@ -70,7 +81,19 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
 
     canvas->flush();
 
-    return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
+    if (!retains_contents) {
+      return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
+    }
+
+    sk_sp<SkSurface> backing_store = surface_frame.SkiaSurface();
+    const SkIRect damage =
+        surface_frame.submit_info().frame_damage.value_or(
+            SkIRect::MakeWH(backing_store->width(), backing_store->height()));
+    if (!self->delegate_->PresentBackingStoreDamage(backing_store, damage)) {
+      return false;
+    }
+    self->last_presented_backing_store_ = std::move(backing_store);
+    return true;
   };
 
   return std::make_unique<SurfaceFrame>(backing_store,
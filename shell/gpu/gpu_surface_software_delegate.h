@@ -48,6 +48,29 @@ class GPUSurfaceSoftwareDelegate {
   ///             the screen.
   ///
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether the backing stores keep their contents from one frame
+  ///             to the next when the size stays the same. If so, only the
+  ///             parts of frames that changed are redrawn, and frames are
+  ///             presented with |PresentBackingStoreDamage| instead of
+  ///             |PresentBackingStore|.
+  ///
+  virtual bool BackingStoreRetainsContents() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called instead of |PresentBackingStore| when the backing
+  ///             stores retain their contents.
+  ///
+  /// @param[in]  backing_store  The software backing store to present.
+  /// @param[in]  damage         The part of the backing store that changed
+  ///                            since the last frame.
+  ///
+  /// @return     Returns if the platform could present the backing store onto
+  ///             the screen.
+  ///
+  virtual bool PresentBackingStoreDamage(sk_sp<SkSurface> backing_store,
+                                         const SkIRect& damage);
 };
 
 }  // namespace flutter
@@ -51,19 +51,24 @@ void AccessibilityBridge::CommitUpdates() {
   // and keep doing so until the update map is empty. We then concatenate the
   // lists in the reversed order, this guarantees parent updates always come
   // before child updates.
-  std::vector<std::vector<SemanticsNode>> results;
-  while (!pending_semantics_node_updates_.empty()) {
-    auto begin = pending_semantics_node_updates_.begin();
-    SemanticsNode target = begin->second;
-    std::vector<SemanticsNode> sub_tree_list;
-    GetSubTreeList(target, sub_tree_list);
-    results.push_back(sub_tree_list);
-    pending_semantics_node_updates_.erase(begin);
+  //
+  // The lists point into the pending updates, which stay untouched until the
+  // update has been converted.
+  std::vector<std::vector<const SemanticsNode*>> results;
+  std::unordered_set<int32_t> visited;
+  visited.reserve(pending_semantics_node_updates_.size());
+  for (const auto& [id, target] : pending_semantics_node_updates_) {
+    if (visited.insert(id).second) {
+      std::vector<const SemanticsNode*> sub_tree_list;
+      GetSubTreeList(target, visited, sub_tree_list);
+      results.push_back(std::move(sub_tree_list));
+    }
   }
 
+  update.nodes.reserve(pending_semantics_node_updates_.size());
   for (size_t i = results.size(); i > 0; i--) {
-    for (SemanticsNode node : results[i - 1]) {
-      ConvertFluterUpdate(node, update);
+    for (const SemanticsNode* node : results[i - 1]) {
+      ConvertFluterUpdate(*node, update);
     }
   }
 
@@ -178,15 +183,16 @@ void AccessibilityBridge::OnAtomicUpdateFinished(
 }
 
 // Private method.
-void AccessibilityBridge::GetSubTreeList(SemanticsNode target,
-                                         std::vector<SemanticsNode>& result) {
-  result.push_back(target);
+void AccessibilityBridge::GetSubTreeList(
+    const SemanticsNode& target,
+    std::unordered_set<int32_t>& visited,
+    std::vector<const SemanticsNode*>& result) {
+  result.push_back(&target);
   for (int32_t child : target.children_in_traversal_order) {
     auto iter = pending_semantics_node_updates_.find(child);
-    if (iter != pending_semantics_node_updates_.end()) {
-      SemanticsNode node = iter->second;
-      GetSubTreeList(node, result);
-      pending_semantics_node_updates_.erase(iter);
+    if (iter != pending_semantics_node_updates_.end() &&
+        visited.insert(child).second) {
+      GetSubTreeList(iter->second, visited, result);
     }
   }
 }
@@ -6,6 +6,7 @@
 #define FLUTTER_SHELL_PLATFORM_COMMON_ACCESSIBILITY_BRIDGE_H_
 
 #include <unordered_map>
+#include <unordered_set>
 
 #include "flutter/fml/mapping.h"
 #include "flutter/shell/platform/embedder/embedder.h"
@@ -222,7 +223,9 @@ class AccessibilityBridge
   std::unique_ptr<AccessibilityBridgeDelegate> delegate_;
 
   void InitAXTree(const ui::AXTreeUpdate& initial_state);
-  void GetSubTreeList(SemanticsNode target, std::vector<SemanticsNode>& result);
+  void GetSubTreeList(const SemanticsNode& target,
+                      std::unordered_set<int32_t>& visited,
+                      std::vector<const SemanticsNode*>& result);
   void ConvertFluterUpdate(const SemanticsNode& node,
                            ui::AXTreeUpdate& tree_update);
   void SetRoleFromFlutterUpdate(ui::AXNodeData& node_data,
@@ -45,6 +45,7 @@ extern const intptr_t kPlatformStrongDillSize;
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/shell/common/platform_message_stream.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/platform/embedder/embedder.h"
@@ -142,8 +143,21 @@ static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
 
   const FlutterSoftwareRendererConfig* software_config = &config->software;
 
+  const bool has_framebuffer_acquire_callback =
+      SAFE_ACCESS(software_config, framebuffer_acquire_callback, nullptr) !=
+      nullptr;
+  const bool has_framebuffer_present_callback =
+      SAFE_ACCESS(software_config, framebuffer_present_callback, nullptr) !=
+      nullptr;
+  if (has_framebuffer_acquire_callback != has_framebuffer_present_callback) {
+    return false;
+  }
+
   if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) ==
-      nullptr) {
+          nullptr &&
+      SAFE_ACCESS(software_config, headless_frame_callback, nullptr) ==
+          nullptr &&
+      !has_framebuffer_acquire_callback) {
     return false;
   }
 
@@ -497,6 +511,12 @@ InferVulkanPlatformViewCreationCallback(
 #endif
 }
 
+static void ReleaseSoftwareHeadlessFrame(void* release_user_data) {
+  auto release = reinterpret_cast<fml::closure*>(release_user_data);
+  (*release)();
+  delete release;
+}
+
 static flutter::Shell::CreateCallback<flutter::PlatformView>
 InferSoftwarePlatformViewCreationCallback(
     const FlutterRendererConfig* config,
@@ -515,9 +535,70 @@ InferSoftwarePlatformViewCreationCallback(
     return ptr(user_data, allocation, row_bytes, height);
   };
 
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
+  std::function<void(const void*, size_t, size_t, size_t, fml::closure)>
+      software_present_headless_frame = nullptr;
+  if (SAFE_ACCESS(software_config, headless_frame_callback, nullptr) !=
+      nullptr) {
+    software_present_headless_frame =
+        [ptr = software_config->headless_frame_callback, user_data](
+            const void* allocation, size_t row_bytes, size_t width,
+            size_t height, fml::closure release) {
+          const FlutterSoftwareHeadlessFrame frame = {
+              sizeof(FlutterSoftwareHeadlessFrame),  // struct_size
+              allocation,                            // allocation
+              row_bytes,                             // row_bytes
+              width,                                 // width
+              height,                                // height
+              ReleaseSoftwareHeadlessFrame,          // release_callback
+              new fml::closure(std::move(release)),  // release_user_data
+          };
+          ptr(user_data, &frame);
+        };
+  }
+  const size_t headless_frame_buffer_count =
+      SAFE_ACCESS(software_config, headless_frame_buffer_count, 0);
+
+  std::function<bool(const SkISize&, FlutterSoftwareFramebuffer*)>
+      software_acquire_framebuffer = nullptr;
+  std::function<bool(const FlutterSoftwareFramebuffer&, const SkIRect&)>
+      software_present_framebuffer = nullptr;
+  if (SAFE_ACCESS(software_config, framebuffer_acquire_callback, nullptr) !=
+      nullptr) {
+    software_acquire_framebuffer =
+        [ptr = software_config->framebuffer_acquire_callback, user_data](
+            const SkISize& size, FlutterSoftwareFramebuffer* framebuffer) {
+          FlutterFrameInfo frame_info = {};
+          frame_info.struct_size = sizeof(FlutterFrameInfo);
+          frame_info.size = {static_cast<uint32_t>(size.width()),
+                             static_cast<uint32_t>(size.height())};
+          return ptr(user_data, &frame_info, framebuffer);
+        };
+    software_present_framebuffer =
+        [ptr = software_config->framebuffer_present_callback, user_data](
+            const FlutterSoftwareFramebuffer& framebuffer,
+            const SkIRect& damage) {
+          FlutterSoftwareFramebufferPresentInfo present_info = {};
+          present_info.struct_size =
+              sizeof(FlutterSoftwareFramebufferPresentInfo);
+          present_info.framebuffer = &framebuffer;
+          present_info.damage = {
+              static_cast<double>(damage.left()),
+              static_cast<double>(damage.top()),
+              static_cast<double>(damage.right()),
+              static_cast<double>(damage.bottom()),
+          };
+          return ptr(user_data, &present_info);
+        };
+  }
+
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
       software_dispatch_table = {
-          software_present_backing_store,  // required
+          software_present_backing_store,   // conditionally required
+          software_present_headless_frame,  // optional
+          headless_frame_buffer_count,      // optional
+          software_acquire_framebuffer,     // optional
+          software_present_framebuffer,     // optional
       };
 
   return fml::MakeCopyable(
@@ -973,6 +1054,10 @@ struct _FlutterPlatformMessageResponseHandle {
   std::unique_ptr<flutter::PlatformMessage> message;
 };
 
+struct _FlutterPlatformMessageStream {
+  std::shared_ptr<flutter::PlatformMessageStream> stream;
+};
+
 struct LoadedElfDeleter {
   void operator()(Dart_LoadedElf* elf) {
     if (elf) {
@@ -1234,6 +1319,23 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
 
   flutter::Settings settings = flutter::SettingsFromCommandLine(command_line);
 
+  const bool headless_rendering =
+      config->type == kSoftware &&
+      SAFE_ACCESS(&config->software, headless_frame_callback, nullptr) !=
+          nullptr;
+  if (headless_rendering) {
+    if (SAFE_ACCESS(args, vsync_callback, nullptr) != nullptr ||
+        SAFE_ACCESS(args, compositor, nullptr) != nullptr) {
+      return LOG_EMBEDDER_ERROR(
+          kInvalidArguments,
+          "Headless rendering may not be combined with a vsync callback or a "
+          "custom compositor.");
+    }
+    // Lets the UI thread build the next frames while the raster thread is
+    // still drawing earlier ones.
+    settings.layer_tree_pipeline_depth = 3;
+  }
+
   if (SAFE_ACCESS(args, aot_data, nullptr)) {
     if (SAFE_ACCESS(args, vm_snapshot_data, nullptr) ||
         SAFE_ACCESS(args, vm_snapshot_instructions, nullptr) ||
@@ -1300,10 +1402,9 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
   if (SAFE_ACCESS(args, update_semantics_node_callback, nullptr) != nullptr) {
     update_semantics_nodes_callback =
         [ptr = args->update_semantics_node_callback,
-         user_data](flutter::SemanticsNodeUpdates update) {
-          for (const auto& value : update) {
-            const auto& node = value.second;
-            SkMatrix transform = node.transform.asM33();
+         user_data](const std::vector<const flutter::SemanticsNode*>& nodes) {
+          for (const flutter::SemanticsNode* node : nodes) {
+            SkMatrix transform = node->transform.asM33();
             FlutterTransformation flutter_transform{
                 transform.get(SkMatrix::kMScaleX),
                 transform.get(SkMatrix::kMSkewX),
@@ -1316,33 +1417,33 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
                 transform.get(SkMatrix::kMPersp2)};
             const FlutterSemanticsNode embedder_node{
                 sizeof(FlutterSemanticsNode),
-                node.id,
-                static_cast<FlutterSemanticsFlag>(node.flags),
-                static_cast<FlutterSemanticsAction>(node.actions),
-                node.textSelectionBase,
-                node.textSelectionExtent,
-                node.scrollChildren,
-                node.scrollIndex,
-                node.scrollPosition,
-                node.scrollExtentMax,
-                node.scrollExtentMin,
-                node.elevation,
-                node.thickness,
-                node.label.c_str(),
-                node.hint.c_str(),
-                node.value.c_str(),
-                node.increasedValue.c_str(),
-                node.decreasedValue.c_str(),
-                static_cast<FlutterTextDirection>(node.textDirection),
-                FlutterRect{node.rect.fLeft, node.rect.fTop, node.rect.fRight,
-                            node.rect.fBottom},
+                node->id,
+                static_cast<FlutterSemanticsFlag>(node->flags),
+                static_cast<FlutterSemanticsAction>(node->actions),
+                node->textSelectionBase,
+                node->textSelectionExtent,
+                node->scrollChildren,
+                node->scrollIndex,
+                node->scrollPosition,
+                node->scrollExtentMax,
+                node->scrollExtentMin,
+                node->elevation,
+                node->thickness,
+                node->label.c_str(),
+                node->hint.c_str(),
+                node->value.c_str(),
+                node->increasedValue.c_str(),
+                node->decreasedValue.c_str(),
+                static_cast<FlutterTextDirection>(node->textDirection),
+                FlutterRect{node->rect.fLeft, node->rect.fTop,
+                            node->rect.fRight, node->rect.fBottom},
                 flutter_transform,
-                node.childrenInTraversalOrder.size(),
-                node.childrenInTraversalOrder.data(),
-                node.childrenInHitTestOrder.data(),
-                node.customAccessibilityActions.size(),
-                node.customAccessibilityActions.data(),
-                node.platformViewId,
+                node->childrenInTraversalOrder.size(),
+                node->childrenInTraversalOrder.data(),
+                node->childrenInHitTestOrder.data(),
+                node->customAccessibilityActions.size(),
+                node->customAccessibilityActions.data(),
+                node->platformViewId,
             };
             ptr(&embedder_node, user_data);
           }
@@ -1477,6 +1578,7 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
           vsync_callback,                             //
           compute_platform_resolved_locale_callback,  //
           on_pre_engine_restart_callback,             //
+          headless_rendering,                         //
       };
 
   auto on_create_platform_view = InferPlatformViewCreationCallback(
@@ -1568,9 +1670,20 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
     }
     custom_task_runners->thread_priority_setter(priority);
   };
+  flutter::EmbedderThreadHost::ThreadPolicies thread_policies;
+  if (settings.ui_thread_policy.has_value()) {
+    thread_policies[flutter::ThreadHost::Type::UI] = *settings.ui_thread_policy;
+  }
+  if (settings.raster_thread_policy.has_value()) {
+    thread_policies[flutter::ThreadHost::Type::RASTER] =
+        *settings.raster_thread_policy;
+  }
+  if (settings.io_thread_policy.has_value()) {
+    thread_policies[flutter::ThreadHost::Type::IO] = *settings.io_thread_policy;
+  }
   auto thread_host =
       flutter::EmbedderThreadHost::CreateEmbedderOrEngineManagedThreadHost(
-          custom_task_runners, thread_config_callback);
+          custom_task_runners, thread_config_callback, thread_policies);
 
   if (!thread_host || !thread_host->IsValid()) {
     return LOG_EMBEDDER_ERROR(kInvalidArguments,
@@ -2140,6 +2253,87 @@ FlutterEngineResult FlutterEngineSendPlatformMessageResponse(
   return kSuccess;
 }
 
+FlutterEngineResult FlutterEngineCreatePlatformMessageStream(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const char* channel,
+    size_t capacity,
+    FlutterPlatformMessageStream** stream_out) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (channel == nullptr || stream_out == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Channel or the stream handle was invalid.");
+  }
+
+  if (capacity == 0) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Stream capacity must be non-zero.");
+  }
+
+  if (capacity > flutter::PlatformMessageRing::kMaxCapacity) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Stream capacity must not exceed 1 GiB.");
+  }
+
+  auto stream = reinterpret_cast<flutter::EmbedderEngine*>(engine)
+                    ->CreatePlatformMessageStream(channel, capacity);
+  if (!stream) {
+    return LOG_EMBEDDER_ERROR(kInternalInconsistency,
+                              "Could not create a platform message stream.");
+  }
+
+  *stream_out = new FlutterPlatformMessageStream{std::move(stream)};
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineSendStreamedPlatformMessage(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterPlatformMessageStream* stream,
+    const uint8_t* data,
+    size_t data_length,
+    bool* sent_out) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (stream == nullptr || sent_out == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Stream or the sent flag was invalid.");
+  }
+
+  if (data_length != 0 && data == nullptr) {
+    return LOG_EMBEDDER_ERROR(
+        kInvalidArguments,
+        "Data size was non zero but the pointer to the data was null.");
+  }
+
+  if (data_length > stream->stream->GetMaxMessageSize()) {
+    return LOG_EMBEDDER_ERROR(
+        kInvalidArguments,
+        "Message is larger than the capacity of the stream allows.");
+  }
+
+  *sent_out = stream->stream->Send(data, data_length);
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineReleasePlatformMessageStream(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterPlatformMessageStream* stream) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (stream == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid stream handle.");
+  }
+
+  delete stream;
+  return kSuccess;
+}
+
 FlutterEngineResult __FlutterEngineFlushPendingTasksNow() {
   fml::MessageLoop::GetCurrent().RunExpiredTasksNow();
   return kSuccess;
@@ -2732,6 +2926,12 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
            FlutterEnginePostCallbackOnAllNativeThreads);
   SET_PROC(NotifyDisplayUpdate, FlutterEngineNotifyDisplayUpdate);
   SET_PROC(ScheduleFrame, FlutterEngineScheduleFrame);
+  SET_PROC(CreatePlatformMessageStream,
+           FlutterEngineCreatePlatformMessageStream);
+  SET_PROC(SendStreamedPlatformMessage,
+           FlutterEngineSendStreamedPlatformMessage);
+  SET_PROC(ReleasePlatformMessageStream,
+           FlutterEngineReleasePlatformMessageStream);
 #undef SET_PROC
 
   return kSuccess;
@@ -387,6 +387,35 @@ typedef bool (*SoftwareSurfacePresentCallback)(void* /* user data */,
                                                const void* /* allocation */,
                                                size_t /* row bytes */,
                                                size_t /* height */);
+
+/// A frame rendered by the software renderer in headless mode.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterSoftwareHeadlessFrame).
+  size_t struct_size;
+  /// The pixels of the frame in the native 32-bit RGBA format. They stay valid
+  /// until the frame is released.
+  const void* allocation;
+  /// The number of bytes in a row of pixels.
+  size_t row_bytes;
+  /// The width of the frame in pixels.
+  size_t width;
+  /// The height of the frame in pixels.
+  size_t height;
+  /// Returns the buffer of the frame to the engine so that it can be reused
+  /// for a later frame. Must be called exactly once with
+  /// `release_user_data`, and may be called on any thread, including after
+  /// the engine was shut down.
+  VoidCallback release_callback;
+  /// The baton to pass to `release_callback`.
+  void* release_user_data;
+} FlutterSoftwareHeadlessFrame;
+
+/// Hands a rendered frame to the embedder in headless mode. The embedder owns
+/// the frame until it calls its `release_callback`, which it may do after
+/// this callback returns, for instance once the pixels have been encoded.
+typedef void (*FlutterSoftwareHeadlessFrameCallback)(
+    void* /* user data */,
+    const FlutterSoftwareHeadlessFrame* /* frame */);
 typedef void* (*ProcResolver)(void* /* user data */, const char* /* name */);
 typedef bool (*TextureFrameCallback)(void* /* user data */,
                                      int64_t /* texture identifier */,
@@ -720,6 +749,59 @@ typedef struct {
 
 } FlutterVulkanRendererConfig;
 
+/// A pixel buffer owned by the embedder that the software renderer copies
+/// frames into.
+///
+/// See: \ref FlutterSoftwareRendererConfig.framebuffer_acquire_callback.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterSoftwareFramebuffer).
+  size_t struct_size;
+  /// The pixels of the buffer. The buffer must be large enough for a frame
+  /// of the requested size in `pixel_format`.
+  void* allocation;
+  /// The number of bytes in a row of pixels.
+  size_t row_bytes;
+  /// The pixel format of the buffer.
+  FlutterSoftwarePixelFormat pixel_format;
+  /// The number of frames since the contents of this buffer were presented,
+  /// as in EGL_EXT_buffer_age. A buffer that holds the last presented frame
+  /// has an age of 1. Zero means that the contents are unknown, in which case
+  /// the whole frame is copied into the buffer.
+  size_t age;
+  /// Identifies the buffer to the embedder when it is presented. Not used by
+  /// the engine.
+  void* user_data;
+} FlutterSoftwareFramebuffer;
+
+/// Asks the embedder for a buffer to copy the frame described by
+/// `frame_info` into. The engine sets the `struct_size` of `framebuffer`, and
+/// the embedder fills in the rest. Returning false skips the frame.
+typedef bool (*FlutterSoftwareFramebufferAcquireCallback)(
+    void* /* user data */,
+    const FlutterFrameInfo* /* frame info */,
+    FlutterSoftwareFramebuffer* /* framebuffer */);
+
+/// This information is passed to the embedder when a software framebuffer is
+/// presented.
+///
+/// See: \ref FlutterSoftwareRendererConfig.framebuffer_present_callback.
+typedef struct {
+  /// The size of this struct. Must be
+  /// sizeof(FlutterSoftwareFramebufferPresentInfo).
+  size_t struct_size;
+  /// The buffer returned by the matching call to
+  /// `framebuffer_acquire_callback`.
+  const FlutterSoftwareFramebuffer* framebuffer;
+  /// The part of the buffer that the engine wrote to. Pixels outside of it
+  /// were left as they were.
+  FlutterRect damage;
+} FlutterSoftwareFramebufferPresentInfo;
+
+/// Presents a software framebuffer. Returns whether presentation succeeded.
+typedef bool (*FlutterSoftwareFramebufferPresentCallback)(
+    void* /* user data */,
+    const FlutterSoftwareFramebufferPresentInfo* /* present info */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterSoftwareRendererConfig).
   size_t struct_size;
@@ -728,6 +810,34 @@ typedef struct {
   /// format. The buffer is owned by the Flutter engine and must be copied in
   /// this callback if needed.
   SoftwareSurfacePresentCallback surface_present_callback;
+  /// Optional. Switches the renderer to headless mode, which is meant for
+  /// producing images without a display, such as thumbnails rendered on a
+  /// server. Frames are rendered back to back as fast as the engine can
+  /// build and rasterize them instead of being paced by vsync, and each one
+  /// is handed to this callback in a pooled pixel buffer instead of being
+  /// presented with `surface_present_callback`, which may then be null.
+  ///
+  /// Headless mode may not be combined with a `vsync_callback` or a custom
+  /// compositor.
+  FlutterSoftwareHeadlessFrameCallback headless_frame_callback;
+  /// The number of unused pixel buffers the engine keeps for later frames in
+  /// headless mode. Buffers beyond that are freed when they are released.
+  /// Defaults to 3 when zero.
+  size_t headless_frame_buffer_count;
+  /// Optional. Presents frames into buffers owned by the embedder instead of
+  /// with `surface_present_callback`, which may then be null. Both
+  /// `framebuffer_acquire_callback` and `framebuffer_present_callback` must be
+  /// set to use this mode.
+  ///
+  /// The engine keeps its own copy of the last frame and only redraws what
+  /// changed since then. Only the changed pixels, plus the ones that changed
+  /// since the acquired buffer was last presented according to its `age`, are
+  /// converted to the pixel format of the buffer and copied into it. This
+  /// suits devices that scan out of a small pool of framebuffers.
+  FlutterSoftwareFramebufferAcquireCallback framebuffer_acquire_callback;
+  /// Presents a buffer returned by `framebuffer_acquire_callback` after the
+  /// frame was copied into it.
+  FlutterSoftwareFramebufferPresentCallback framebuffer_present_callback;
 } FlutterSoftwareRendererConfig;
 
 typedef struct {
@@ -971,6 +1081,9 @@ typedef void (*FlutterDataCallback)(const uint8_t* /* data */,
                                     size_t /* size */,
                                     void* /* user data */);
 
+struct _FlutterPlatformMessageStream;
+typedef struct _FlutterPlatformMessageStream FlutterPlatformMessageStream;
+
 /// The identifier of the platform view. This identifier is specified by the
 /// application when a platform view is added to the scene via the
 /// `SceneBuilder.addPlatformView` call.
@@ -1689,6 +1802,10 @@ typedef struct {
   /// callback that is passed a sentinel `FlutterSemanticsNode` whose `id` field
   /// has the value `kFlutterSemanticsNodeIdBatchEnd`.
   ///
+  /// Nodes that did not change since they were last passed to this callback
+  /// are left out of the batch. Once semantics are disabled and enabled again,
+  /// every node is passed again.
+  ///
   /// The callback will be invoked on the thread on which the `FlutterEngineRun`
   /// call is made.
   FlutterUpdateSemanticsNodeCallback update_semantics_node_callback;
@@ -2097,6 +2214,81 @@ FlutterEngineResult FlutterEngineSendPlatformMessageResponse(
     const uint8_t* data,
     size_t data_length);
 
+//------------------------------------------------------------------------------
+/// @brief      Creates a one-way stream of messages from the embedder to the
+///             Flutter application, for channels that carry many small
+///             messages per frame.
+///
+///             Messages sent on the stream are copied into a ring buffer that
+///             is allocated once, when the stream is created. They are
+///             delivered to the application in batches on `channel`, at most
+///             one platform message per wakeup of the UI thread. The payload
+///             of a batch is the concatenation of its messages, each
+///             prefixed with its length as a uint32 in host byte order.
+///             Batches do not expect a response.
+///
+///             The stream must be collected via a call to
+///             `FlutterEngineReleasePlatformMessageStream`.
+///
+/// @see        FlutterEngineSendStreamedPlatformMessage()
+///
+/// @param[in]  engine      A running engine instance.
+/// @param[in]  channel     The channel on which batches are delivered.
+/// @param[in]  capacity    The minimum size of the ring buffer in bytes, at
+///                         most 1 GiB. The largest message that can be sent
+///                         is a little less than half of it.
+/// @param[out] stream_out  The stream created when this call is successful.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineCreatePlatformMessageStream(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const char* channel,
+    size_t capacity,
+    FlutterPlatformMessageStream** stream_out);
+
+//------------------------------------------------------------------------------
+/// @brief      Queues a message on a stream created using
+///             `FlutterEngineCreatePlatformMessageStream`. This call does not
+///             allocate and does not block.
+///
+///             A stream may only be sent messages from one thread at a time.
+///
+/// @param[in]  engine       A running engine instance.
+/// @param[in]  stream       The stream on which to send the message.
+/// @param[in]  data         The message.
+/// @param[in]  data_length  The length of the message.
+/// @param[out] sent_out     Set to false if the stream was full and the
+///                          message was not queued. The embedder may retry
+///                          after the application has caught up, or drop the
+///                          message.
+///
+/// @return     The result of the call. A full stream is not an error.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSendStreamedPlatformMessage(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterPlatformMessageStream* stream,
+    const uint8_t* data,
+    size_t data_length,
+    bool* sent_out);
+
+//------------------------------------------------------------------------------
+/// @brief      Collects a stream created using
+///             `FlutterEngineCreatePlatformMessageStream`. Messages already
+///             queued on the stream are still delivered.
+///
+/// @param[in]  engine  A running engine instance.
+/// @param[in]  stream  The stream to collect.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineReleasePlatformMessageStream(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterPlatformMessageStream* stream);
+
 //------------------------------------------------------------------------------
 /// @brief      This API is only meant to be used by platforms that need to
 ///             flush tasks on a message loop not controlled by the Flutter
@@ -2566,6 +2758,20 @@ typedef FlutterEngineResult (*FlutterEngineSendPlatformMessageResponseFnPtr)(
     const FlutterPlatformMessageResponseHandle* handle,
     const uint8_t* data,
     size_t data_length);
+typedef FlutterEngineResult (*FlutterEngineCreatePlatformMessageStreamFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const char* channel,
+    size_t capacity,
+    FlutterPlatformMessageStream** stream_out);
+typedef FlutterEngineResult (*FlutterEngineSendStreamedPlatformMessageFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterPlatformMessageStream* stream,
+    const uint8_t* data,
+    size_t data_length,
+    bool* sent_out);
+typedef FlutterEngineResult (*FlutterEngineReleasePlatformMessageStreamFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterPlatformMessageStream* stream);
 typedef FlutterEngineResult (*FlutterEngineRegisterExternalTextureFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     int64_t texture_identifier);
@@ -2673,6 +2879,9 @@ typedef struct {
       PostCallbackOnAllNativeThreads;
   FlutterEngineNotifyDisplayUpdateFnPtr NotifyDisplayUpdate;
   FlutterEngineScheduleFrameFnPtr ScheduleFrame;
+  FlutterEngineCreatePlatformMessageStreamFnPtr CreatePlatformMessageStream;
+  FlutterEngineSendStreamedPlatformMessageFnPtr SendStreamedPlatformMessage;
+  FlutterEngineReleasePlatformMessageStreamFnPtr ReleasePlatformMessageStream;
 } FlutterEngineProcTable;
 
 //------------------------------------------------------------------------------
@@ -9,6 +9,8 @@
 
 namespace flutter {
 
+static constexpr int kNumProfilerSamplesPerSec = 5;
+
 struct ShellArgs {
   Settings settings;
   Shell::CreateCallback<PlatformView> on_create_platform_view;
@@ -57,14 +59,49 @@ bool EmbedderEngine::LaunchShell() {
   // shell again.
   shell_args_.reset();
 
+  if (IsValid()) {
+    StartProfiler();
+  }
+
   return IsValid();
 }
 
 bool EmbedderEngine::CollectShell() {
+  profiler_.reset();
   shell_.reset();
   return IsValid();
 }
 
+void EmbedderEngine::StartProfiler() {
+  fml::RefPtr<fml::TaskRunner> profiler_task_runner =
+      thread_host_->GetProfilerTaskRunner();
+  if (!profiler_task_runner) {
+    return;
+  }
+#if FML_OS_LINUX
+  profiler_metrics_ = std::make_shared<ProfilerMetricsLinux>();
+  // The threads are told apart by their ids, as Linux truncates the names of
+  // the engine's threads. If the embedder renders on the platform thread, that
+  // thread is reported as the platform thread.
+  auto register_thread = [metrics = profiler_metrics_](
+                             const fml::RefPtr<fml::TaskRunner>& task_runner,
+                             const char* role) {
+    fml::TaskRunner::RunNowOrPostTask(task_runner, [metrics, role]() {
+      metrics->RegisterCurrentThread(role);
+    });
+  };
+  register_thread(task_runners_.GetRasterTaskRunner(), "raster");
+  register_thread(task_runners_.GetPlatformTaskRunner(), "platform");
+  register_thread(task_runners_.GetUITaskRunner(), "ui");
+  register_thread(task_runners_.GetIOTaskRunner(), "io");
+  profiler_ = std::make_unique<SamplingProfiler>(
+      task_runners_.GetLabel().c_str(), profiler_task_runner,
+      [metrics = profiler_metrics_]() { return metrics->GenerateSample(); },
+      kNumProfilerSamplesPerSec);
+  profiler_->Start();
+#endif  // FML_OS_LINUX
+}
+
 bool EmbedderEngine::RunRootIsolate() {
   if (!IsValid() || !run_configuration_.IsValid()) {
     return false;
@@ -142,6 +179,16 @@ bool EmbedderEngine::SendPlatformMessage(
   return true;
 }
 
+std::shared_ptr<PlatformMessageStream>
+EmbedderEngine::CreatePlatformMessageStream(std::string channel,
+                                            size_t capacity) {
+  if (!IsValid()) {
+    return nullptr;
+  }
+
+  return shell_->CreatePlatformMessageStream(std::move(channel), capacity);
+}
+
 bool EmbedderEngine::RegisterTexture(int64_t texture) {
   if (!IsValid()) {
     return false;
@@ -8,12 +8,18 @@
 #include <memory>
 #include <unordered_map>
 
+#include "flutter/fml/build_config.h"
 #include "flutter/fml/macros.h"
 #include "flutter/shell/common/shell.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/shell/platform/embedder/embedder.h"
 #include "flutter/shell/platform/embedder/embedder_external_texture_resolver.h"
 #include "flutter/shell/platform/embedder/embedder_thread_host.h"
+#include "flutter/shell/profiling/sampling_profiler.h"
+
+#if FML_OS_LINUX
+#include "flutter/shell/profiling/profiler_metrics_linux.h"
+#endif  // FML_OS_LINUX
 namespace flutter {
 
 struct ShellArgs;
@@ -54,6 +60,10 @@ class EmbedderEngine {
 
   bool SendPlatformMessage(std::unique_ptr<PlatformMessage> message);
 
+  std::shared_ptr<PlatformMessageStream> CreatePlatformMessageStream(
+      std::string channel,
+      size_t capacity);
+
   bool RegisterTexture(int64_t texture);
 
   bool UnregisterTexture(int64_t texture);
@@ -92,6 +102,14 @@ class EmbedderEngine {
   std::unique_ptr<ShellArgs> shell_args_;
   std::unique_ptr<Shell> shell_;
   std::unique_ptr<EmbedderExternalTextureResolver> external_texture_resolver_;
+#if FML_OS_LINUX
+  std::shared_ptr<ProfilerMetricsLinux> profiler_metrics_;
+#endif  // FML_OS_LINUX
+  std::unique_ptr<SamplingProfiler> profiler_;
+
+  // Samples the engine into the timeline if the thread host has a profiler
+  // thread.
+  void StartProfiler();
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderEngine);
 };
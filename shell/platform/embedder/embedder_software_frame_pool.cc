@@ -0,0 +1,72 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/embedder_software_frame_pool.h"
+
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/skia/include/core/SkImageInfo.h"
+
+namespace flutter {
+
+std::shared_ptr<EmbedderSoftwareFramePool> EmbedderSoftwareFramePool::Create(
+    size_t max_idle_buffers) {
+  // Note: std::make_shared unviable due to hidden constructor.
+  return std::shared_ptr<EmbedderSoftwareFramePool>(
+      new EmbedderSoftwareFramePool(max_idle_buffers));
+}
+
+EmbedderSoftwareFramePool::EmbedderSoftwareFramePool(size_t max_idle_buffers)
+    : max_idle_buffers_(max_idle_buffers) {}
+
+EmbedderSoftwareFramePool::~EmbedderSoftwareFramePool() = default;
+
+sk_sp<SkSurface> EmbedderSoftwareFramePool::AcquireSurface(
+    const SkISize& size) {
+  {
+    std::scoped_lock lock(mutex_);
+    while (!idle_surfaces_.empty()) {
+      sk_sp<SkSurface> surface = std::move(idle_surfaces_.back());
+      idle_surfaces_.pop_back();
+      if (surface->width() == size.width() &&
+          surface->height() == size.height()) {
+        return surface;
+      }
+      // Surfaces of an earlier frame size are not going to be used again.
+    }
+  }
+
+  SkImageInfo info = SkImageInfo::MakeN32(
+      size.fWidth, size.fHeight, kPremul_SkAlphaType, SkColorSpace::MakeSRGB());
+  sk_sp<SkSurface> surface = SkSurface::MakeRaster(info, nullptr);
+  if (surface == nullptr) {
+    FML_LOG(ERROR) << "Could not create a headless frame buffer.";
+  }
+  return surface;
+}
+
+fml::closure EmbedderSoftwareFramePool::MakeReleaseClosure(
+    sk_sp<SkSurface> surface) {
+  return [weak_pool = weak_from_this(), surface = std::move(surface)]() {
+    if (auto pool = weak_pool.lock()) {
+      pool->ReleaseSurface(surface);
+    }
+  };
+}
+
+size_t EmbedderSoftwareFramePool::GetIdleBufferCount() const {
+  std::scoped_lock lock(mutex_);
+  return idle_surfaces_.size();
+}
+
+void EmbedderSoftwareFramePool::ReleaseSurface(sk_sp<SkSurface> surface) {
+  std::scoped_lock lock(mutex_);
+  if (idle_surfaces_.size() < max_idle_buffers_) {
+    idle_surfaces_.push_back(std::move(surface));
+  }
+}
+
+}  // namespace flutter
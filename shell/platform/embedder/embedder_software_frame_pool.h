@@ -0,0 +1,65 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SOFTWARE_FRAME_POOL_H_
+#define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SOFTWARE_FRAME_POOL_H_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkSize.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Recycles the raster surfaces that the software renderer draws
+///             into in headless mode.
+///
+///             Every frame is drawn into a surface of its own, which the
+///             embedder holds on to until it releases the frame, on any
+///             thread. Released surfaces of the current frame size are kept
+///             for later frames, up to the configured number of buffers. The
+///             pool may be destroyed while the embedder still holds frames.
+///
+class EmbedderSoftwareFramePool
+    : public std::enable_shared_from_this<EmbedderSoftwareFramePool> {
+ public:
+  static std::shared_ptr<EmbedderSoftwareFramePool> Create(
+      size_t max_idle_buffers);
+
+  ~EmbedderSoftwareFramePool();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns an unused surface of the given size, allocating one if
+  ///             none was released earlier.
+  ///
+  sk_sp<SkSurface> AcquireSurface(const SkISize& size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns a closure that hands |surface| back to the pool. It
+  ///             must be called exactly once.
+  ///
+  fml::closure MakeReleaseClosure(sk_sp<SkSurface> surface);
+
+  size_t GetIdleBufferCount() const;
+
+ private:
+  const size_t max_idle_buffers_;
+  mutable std::mutex mutex_;
+  std::vector<sk_sp<SkSurface>> idle_surfaces_;
+
+  explicit EmbedderSoftwareFramePool(size_t max_idle_buffers);
+
+  void ReleaseSurface(sk_sp<SkSurface> surface);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSoftwareFramePool);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SOFTWARE_FRAME_POOL_H_
@@ -5,18 +5,33 @@
 #include "flutter/shell/platform/embedder/embedder_surface_software.h"
 
 #include "flutter/fml/trace_event.h"
+#include "flutter/shell/platform/embedder/pixel_formats.h"
 #include "third_party/skia/include/core/SkColorSpace.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
 #include "third_party/skia/include/gpu/GrDirectContext.h"
 
 namespace flutter {
 
+namespace {
+
+// Buffers older than this are copied into in full.
+constexpr size_t kMaxFramebufferAge = 4;
+
+}  // namespace
+
 EmbedderSurfaceSoftware::EmbedderSurfaceSoftware(
     SoftwareDispatchTable software_dispatch_table,
     std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
     : software_dispatch_table_(software_dispatch_table),
       external_view_embedder_(external_view_embedder) {
-  if (!software_dispatch_table_.software_present_backing_store) {
+  if (software_dispatch_table_.software_present_headless_frame) {
+    const size_t buffer_count =
+        software_dispatch_table_.headless_frame_buffer_count > 0
+            ? software_dispatch_table_.headless_frame_buffer_count
+            : 3;
+    headless_frame_pool_ = EmbedderSoftwareFramePool::Create(buffer_count);
+  } else if (!software_dispatch_table_.software_present_backing_store &&
+             !BackingStoreRetainsContents()) {
     return;
   }
   valid_ = true;
@@ -59,6 +74,12 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
     return nullptr;
   }
 
+  if (headless_frame_pool_) {
+    // The embedder may still hold earlier frames, so every frame gets a
+    // buffer of its own.
+    return headless_frame_pool_->AcquireSurface(size);
+  }
+
   if (sk_surface_ != nullptr &&
       SkISize::Make(sk_surface_->width(), sk_surface_->height()) == size) {
     // The old and new surface sizes are the same. Nothing to do here.
@@ -101,6 +122,18 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
     return false;
   }
 
+  if (headless_frame_pool_) {
+    TRACE_EVENT0("flutter", "EmbedderSurfaceSoftware::PresentHeadlessFrame");
+    software_dispatch_table_.software_present_headless_frame(
+        pixmap.addr(),                                           //
+        pixmap.rowBytes(),                                       //
+        pixmap.width(),                                          //
+        pixmap.height(),                                         //
+        headless_frame_pool_->MakeReleaseClosure(backing_store)  //
+    );
+    return true;
+  }
+
   return software_dispatch_table_.software_present_backing_store(
       pixmap.addr(),      //
       pixmap.rowBytes(),  //
@@ -108,4 +141,68 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
   );
 }
 
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::BackingStoreRetainsContents() const {
+  // Headless frames are handed to the embedder in buffers of their own.
+  return !software_dispatch_table_.software_present_headless_frame &&
+         software_dispatch_table_.software_acquire_framebuffer &&
+         software_dispatch_table_.software_present_framebuffer;
+}
+
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::PresentBackingStoreDamage(
+    sk_sp<SkSurface> backing_store,
+    const SkIRect& damage) {
+  TRACE_EVENT0("flutter", "EmbedderSurfaceSoftware::PresentFramebuffer");
+  if (!IsValid()) {
+    FML_LOG(ERROR) << "Tried to present an invalid software surface.";
+    return false;
+  }
+
+  SkPixmap pixmap;
+  if (!backing_store->peekPixels(&pixmap)) {
+    FML_LOG(ERROR) << "Could not peek the pixels of the backing store.";
+    return false;
+  }
+
+  const SkISize size = pixmap.dimensions();
+  if (size != framebuffer_size_) {
+    framebuffer_damage_history_.clear();
+    framebuffer_size_ = size;
+  }
+
+  FlutterSoftwareFramebuffer framebuffer = {};
+  framebuffer.struct_size = sizeof(FlutterSoftwareFramebuffer);
+  if (!software_dispatch_table_.software_acquire_framebuffer(size,
+                                                             &framebuffer)) {
+    FML_LOG(ERROR) << "Could not acquire a framebuffer from the embedder.";
+    return false;
+  }
+
+  // The buffer lags behind by the damage of every frame presented since it
+  // was last presented itself.
+  SkIRect copy_rect = damage;
+  if (framebuffer.age == 0 ||
+      framebuffer.age - 1 > framebuffer_damage_history_.size()) {
+    copy_rect = SkIRect::MakeSize(size);
+  } else {
+    for (size_t i = 0; i + 1 < framebuffer.age; i++) {
+      copy_rect.join(framebuffer_damage_history_[i]);
+    }
+  }
+  framebuffer_damage_history_.push_front(damage);
+  if (framebuffer_damage_history_.size() > kMaxFramebufferAge) {
+    framebuffer_damage_history_.pop_back();
+  }
+
+  if (!convertPixels(pixmap, copy_rect, framebuffer.pixel_format,
+                     framebuffer.allocation, framebuffer.row_bytes)) {
+    FML_LOG(ERROR) << "Could not copy the frame into the framebuffer.";
+    return false;
+  }
+
+  return software_dispatch_table_.software_present_framebuffer(framebuffer,
+                                                               copy_rect);
+}
+
 }  // namespace flutter
@@ -5,9 +5,14 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 
+#include <deque>
+
+#include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_software.h"
+#include "flutter/shell/platform/embedder/embedder.h"
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
+#include "flutter/shell/platform/embedder/embedder_software_frame_pool.h"
 #include "flutter/shell/platform/embedder/embedder_surface.h"
 
 namespace flutter {
@@ -17,7 +22,20 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
  public:
   struct SoftwareDispatchTable {
     std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
-        software_present_backing_store;  // required
+        software_present_backing_store;  // required unless headless
+    std::function<void(const void* allocation,
+                       size_t row_bytes,
+                       size_t width,
+                       size_t height,
+                       fml::closure release)>
+        software_present_headless_frame;  // optional
+    size_t headless_frame_buffer_count;   // optional
+    std::function<bool(const SkISize& size,
+                       FlutterSoftwareFramebuffer* framebuffer)>
+        software_acquire_framebuffer;  // optional
+    std::function<bool(const FlutterSoftwareFramebuffer& framebuffer,
+                       const SkIRect& damage)>
+        software_present_framebuffer;  // optional
   };
 
   EmbedderSurfaceSoftware(
@@ -30,6 +48,11 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   bool valid_ = false;
   SoftwareDispatchTable software_dispatch_table_;
   sk_sp<SkSurface> sk_surface_;
+  std::shared_ptr<EmbedderSoftwareFramePool> headless_frame_pool_;
+  // The damage of the most recent frames presented into embedder owned
+  // framebuffers, newest first.
+  std::deque<SkIRect> framebuffer_damage_history_;
+  SkISize framebuffer_size_ = SkISize::MakeEmpty();
   std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
 
   // |EmbedderSurface|
@@ -47,6 +70,13 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   // |GPUSurfaceSoftwareDelegate|
   bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
 
+  // |GPUSurfaceSoftwareDelegate|
+  bool BackingStoreRetainsContents() const override;
+
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStoreDamage(sk_sp<SkSurface> backing_store,
+                                 const SkIRect& damage) override;
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceSoftware);
 };
 
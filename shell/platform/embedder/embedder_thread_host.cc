@@ -8,6 +8,7 @@
 
 #include <algorithm>
 
+#include "flutter/fml/build_config.h"
 #include "flutter/fml/message_loop.h"
 #include "flutter/shell/platform/embedder/embedder_struct_macros.h"
 
@@ -82,10 +83,11 @@ CreateEmbedderTaskRunner(const FlutterTaskRunnerDescription* description) {
 std::unique_ptr<EmbedderThreadHost>
 EmbedderThreadHost::CreateEmbedderOrEngineManagedThreadHost(
     const FlutterCustomTaskRunners* custom_task_runners,
-    flutter::ThreadConfigSetter config_setter) {
+    flutter::ThreadConfigSetter config_setter,
+    const ThreadPolicies& thread_policies) {
   {
-    auto host =
-        CreateEmbedderManagedThreadHost(custom_task_runners, config_setter);
+    auto host = CreateEmbedderManagedThreadHost(
+        custom_task_runners, config_setter, thread_policies);
     if (host && host->IsValid()) {
       return host;
     }
@@ -96,7 +98,7 @@ EmbedderThreadHost::CreateEmbedderOrEngineManagedThreadHost(
   // configuration if the embedder attempted to specify a configuration but
   // messed up with an incorrect configuration.
   if (custom_task_runners == nullptr) {
-    auto host = CreateEngineManagedThreadHost(config_setter);
+    auto host = CreateEngineManagedThreadHost(config_setter, thread_policies);
     if (host && host->IsValid()) {
       return host;
     }
@@ -121,11 +123,32 @@ fml::Thread::ThreadConfig MakeThreadConfig(
       priority);
 }
 
+// The engine is sampled on the platforms that have a sampler, except in release
+// modes.
+static void SetProfilerConfig(ThreadHost::ThreadHostConfig& config) {
+#if FML_OS_LINUX && (FLUTTER_RUNTIME_MODE == FLUTTER_RUNTIME_MODE_DEBUG || \
+                     FLUTTER_RUNTIME_MODE == FLUTTER_RUNTIME_MODE_PROFILE)
+  config.SetProfilerConfig(MakeThreadConfig(
+      ThreadHost::Type::Profiler, fml::Thread::ThreadPriority::BACKGROUND));
+#endif
+}
+
+// Policies of threads that are not created by the engine are never applied,
+// since only the threads in the mask of the config are created.
+static void SetThreadPolicies(
+    ThreadHost::ThreadHostConfig& config,
+    const EmbedderThreadHost::ThreadPolicies& thread_policies) {
+  for (const auto& [type, policy] : thread_policies) {
+    config.SetThreadPolicy(type, policy);
+  }
+}
+
 // static
 std::unique_ptr<EmbedderThreadHost>
 EmbedderThreadHost::CreateEmbedderManagedThreadHost(
     const FlutterCustomTaskRunners* custom_task_runners,
-    flutter::ThreadConfigSetter config_setter) {
+    flutter::ThreadConfigSetter config_setter,
+    const ThreadPolicies& thread_policies) {
   if (custom_task_runners == nullptr) {
     return nullptr;
   }
@@ -140,6 +163,8 @@ EmbedderThreadHost::CreateEmbedderManagedThreadHost(
       ThreadHost::Type::UI, fml::Thread::ThreadPriority::DISPLAY));
   thread_host_config.SetIOConfig(MakeThreadConfig(
       ThreadHost::Type::IO, fml::Thread::ThreadPriority::BACKGROUND));
+  SetProfilerConfig(thread_host_config);
+  SetThreadPolicies(thread_host_config, thread_policies);
 
   auto platform_task_runner_pair = CreateEmbedderTaskRunner(
       SAFE_ACCESS(custom_task_runners, platform_task_runner, nullptr));
@@ -223,7 +248,8 @@ EmbedderThreadHost::CreateEmbedderManagedThreadHost(
 // static
 std::unique_ptr<EmbedderThreadHost>
 EmbedderThreadHost::CreateEngineManagedThreadHost(
-    flutter::ThreadConfigSetter config_setter) {
+    flutter::ThreadConfigSetter config_setter,
+    const ThreadPolicies& thread_policies) {
   // Crate a thraed host config, and specified the thread name and priority.
   auto thread_host_config = ThreadHost::ThreadHostConfig(config_setter);
   thread_host_config.SetUIConfig(MakeThreadConfig(
@@ -232,6 +258,8 @@ EmbedderThreadHost::CreateEngineManagedThreadHost(
       flutter::ThreadHost::RASTER, fml::Thread::ThreadPriority::RASTER));
   thread_host_config.SetIOConfig(MakeThreadConfig(
       flutter::ThreadHost::IO, fml::Thread::ThreadPriority::BACKGROUND));
+  SetProfilerConfig(thread_host_config);
+  SetThreadPolicies(thread_host_config, thread_policies);
 
   // Create a thread host with the current thread as the platform thread and all
   // other threads managed.
@@ -295,4 +323,11 @@ bool EmbedderThreadHost::PostTask(int64_t runner, uint64_t task) const {
   return found->second->PostTask(task);
 }
 
+fml::RefPtr<fml::TaskRunner> EmbedderThreadHost::GetProfilerTaskRunner() const {
+  if (!host_.profiler_thread) {
+    return nullptr;
+  }
+  return host_.profiler_thread->GetTaskRunner();
+}
+
 }  // namespace flutter
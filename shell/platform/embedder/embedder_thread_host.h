@@ -19,11 +19,27 @@ namespace flutter {
 
 class EmbedderThreadHost {
  public:
+  using ThreadPolicies = std::map<ThreadHost::Type, ThreadPolicy>;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates the threads that the embedder did not provide task
+  ///             runners for.
+  ///
+  /// @param[in]  custom_task_runners  The task runners of the embedder, or
+  ///                                  nullptr to create every thread.
+  /// @param[in]  config_setter        Sets the name and priority of each
+  ///                                  thread created by the engine.
+  /// @param[in]  thread_policies      The CPU affinity and scheduling policy
+  ///                                  of the threads created by the engine.
+  ///                                  Policies of threads that the embedder
+  ///                                  provides are ignored.
+  ///
   static std::unique_ptr<EmbedderThreadHost>
   CreateEmbedderOrEngineManagedThreadHost(
       const FlutterCustomTaskRunners* custom_task_runners,
       flutter::ThreadConfigSetter config_setter =
-          fml::Thread::SetCurrentThreadName);
+          fml::Thread::SetCurrentThreadName,
+      const ThreadPolicies& thread_policies = {});
 
   EmbedderThreadHost(
       ThreadHost host,
@@ -38,6 +54,13 @@ class EmbedderThreadHost {
 
   bool PostTask(int64_t runner, uint64_t task) const;
 
+  //----------------------------------------------------------------------------
+  /// @return     The task runner of the thread that samples the engine, or
+  ///             nullptr if the engine is not sampled on this platform or in
+  ///             this runtime mode.
+  ///
+  fml::RefPtr<fml::TaskRunner> GetProfilerTaskRunner() const;
+
  private:
   ThreadHost host_;
   flutter::TaskRunners runners_;
@@ -45,12 +68,12 @@ class EmbedderThreadHost {
 
   static std::unique_ptr<EmbedderThreadHost> CreateEmbedderManagedThreadHost(
       const FlutterCustomTaskRunners* custom_task_runners,
-      flutter::ThreadConfigSetter config_setter =
-          fml::Thread::SetCurrentThreadName);
+      flutter::ThreadConfigSetter config_setter,
+      const ThreadPolicies& thread_policies);
 
   static std::unique_ptr<EmbedderThreadHost> CreateEngineManagedThreadHost(
-      flutter::ThreadConfigSetter config_setter =
-          fml::Thread::SetCurrentThreadName);
+      flutter::ThreadConfigSetter config_setter,
+      const ThreadPolicies& thread_policies);
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderThreadHost);
 };
@@ -313,6 +313,33 @@ void null_platform_messages() {
   signalNativeTest();
 }
 
+@pragma('vm:entry-point')
+void platform_message_stream() {
+  int received = 0;
+  PlatformDispatcher.instance.onPlatformMessage =
+      (String name, ByteData? data, PlatformMessageResponseCallback? callback) {
+    if (name == 'test/stream') {
+      // Every streamed message is a uint32 sequence number prefixed with its
+      // length.
+      int offset = 0;
+      while (offset < data!.lengthInBytes) {
+        final int length = data.getUint32(offset, Endian.host);
+        if (length != 4 ||
+            data.getUint32(offset + 4, Endian.host) != received) {
+          signalNativeMessage('Unexpected message after $received messages.');
+          return;
+        }
+        offset += 4 + length;
+        received++;
+      }
+    } else {
+      received++;
+    }
+    signalNativeCount(received);
+  };
+  signalNativeTest();
+}
+
 Picture CreateSimplePicture() {
   Paint blackPaint = Paint();
   Paint whitePaint = Paint()..color = Color.fromARGB(255, 255, 255, 255);
@@ -1067,6 +1094,45 @@ void drawSolidColor(Color c) {
   PlatformDispatcher.instance.scheduleFrame();
 }
 
+@pragma('vm:entry-point')
+void render_frames_continuously() {
+  PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
+    final SceneBuilder builder = SceneBuilder();
+    builder.pushOffset(0.0, 0.0);
+    builder.addPicture(
+        Offset.zero,
+        CreateColoredBox(const Color.fromARGB(255, 255, 0, 0),
+            PlatformDispatcher.instance.views.first.physicalSize));
+    builder.pop();
+    PlatformDispatcher.instance.views.first.render(builder.build());
+    PlatformDispatcher.instance.scheduleFrame();
+  };
+  PlatformDispatcher.instance.scheduleFrame();
+}
+
+@pragma('vm:entry-point')
+void move_box_continuously() {
+  int frame = 0;
+  PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
+    final SceneBuilder builder = SceneBuilder();
+    builder.pushOffset(0.0, 0.0);
+    builder.addPicture(
+        Offset.zero,
+        CreateColoredBox(const Color.fromARGB(255, 0, 0, 255),
+            PlatformDispatcher.instance.views.first.physicalSize));
+    // Moves a red 8x8 box along the top edge of the view, one box per frame.
+    builder.addPicture(
+        Offset((frame % 8) * 8.0, 0.0),
+        CreateColoredBox(
+            const Color.fromARGB(255, 255, 0, 0), const Size(8.0, 8.0)));
+    builder.pop();
+    PlatformDispatcher.instance.views.first.render(builder.build());
+    frame++;
+    PlatformDispatcher.instance.scheduleFrame();
+  };
+  PlatformDispatcher.instance.scheduleFrame();
+}
+
 @pragma('vm:entry-point')
 void draw_solid_red() {
   drawSolidColor(const Color.fromARGB(255, 255, 0, 0));
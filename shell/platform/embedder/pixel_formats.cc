@@ -3,6 +3,9 @@
 // found in the LICENSE file.
 
 #include "flutter/shell/platform/embedder/pixel_formats.h"
+
+#include <cstring>
+
 #include "flutter/shell/platform/embedder/embedder.h"
 
 std::optional<SkColorType> getSkColorType(FlutterSoftwarePixelFormat pixfmt) {
@@ -38,3 +41,175 @@ std::optional<SkColorInfo> getSkColorInfo(FlutterSoftwarePixelFormat pixfmt) {
 
   return SkColorInfo(*ct, at, SkColorSpace::MakeSRGB());
 }
+
+std::optional<size_t> getBytesPerPixel(FlutterSoftwarePixelFormat pixfmt) {
+  auto ct = getSkColorType(pixfmt);
+  if (!ct) {
+    return std::nullopt;
+  }
+  return SkColorTypeBytesPerPixel(*ct);
+}
+
+namespace {
+
+// The row kernels below work on whole 32-bit pixels with shifts and masks
+// only, and without branches, so that the compiler vectorizes their loops.
+// They assume little-endian pixels, which all supported targets use.
+
+// The shifts of the channels in a 32-bit source pixel.
+template <bool kSrcIsBGRA>
+struct SrcChannels {
+  static constexpr uint32_t kR = kSrcIsBGRA ? 16 : 0;
+  static constexpr uint32_t kG = 8;
+  static constexpr uint32_t kB = kSrcIsBGRA ? 0 : 16;
+  static constexpr uint32_t kA = 24;
+};
+
+// Swaps the red and blue channels, converting between RGBA and BGRA.
+void SwizzleRBRow(const uint32_t* __restrict src,
+                  uint32_t* __restrict dst,
+                  int count,
+                  uint32_t or_mask) {
+  for (int i = 0; i < count; i++) {
+    const uint32_t p = src[i];
+    dst[i] = (p & 0xFF00FF00) | ((p >> 16) & 0xFF) | ((p & 0xFF) << 16) |
+             or_mask;
+  }
+}
+
+void OrRow(const uint32_t* __restrict src,
+           uint32_t* __restrict dst,
+           int count,
+           uint32_t or_mask) {
+  for (int i = 0; i < count; i++) {
+    dst[i] = src[i] | or_mask;
+  }
+}
+
+// Packs pixels as kRGB_565_SkColorType does, with red in the high bits.
+template <bool kSrcIsBGRA>
+void PackRGB565Row(const uint32_t* __restrict src,
+                   uint16_t* __restrict dst,
+                   int count) {
+  using C = SrcChannels<kSrcIsBGRA>;
+  for (int i = 0; i < count; i++) {
+    const uint32_t p = src[i];
+    const uint32_t r = (p >> (C::kR + 3)) & 0x1F;
+    const uint32_t g = (p >> (C::kG + 2)) & 0x3F;
+    const uint32_t b = (p >> (C::kB + 3)) & 0x1F;
+    dst[i] = static_cast<uint16_t>((r << 11) | (g << 5) | b);
+  }
+}
+
+// Packs pixels as kARGB_4444_SkColorType does, with alpha in the low bits.
+template <bool kSrcIsBGRA>
+void PackARGB4444Row(const uint32_t* __restrict src,
+                     uint16_t* __restrict dst,
+                     int count) {
+  using C = SrcChannels<kSrcIsBGRA>;
+  for (int i = 0; i < count; i++) {
+    const uint32_t p = src[i];
+    const uint32_t r = (p >> (C::kR + 4)) & 0xF;
+    const uint32_t g = (p >> (C::kG + 4)) & 0xF;
+    const uint32_t b = (p >> (C::kB + 4)) & 0xF;
+    const uint32_t a = (p >> (C::kA + 4)) & 0xF;
+    dst[i] = static_cast<uint16_t>((r << 12) | (g << 8) | (b << 4) | a);
+  }
+}
+
+// Uses the same luminance weights as Skia.
+template <bool kSrcIsBGRA>
+void PackGray8Row(const uint32_t* __restrict src,
+                  uint8_t* __restrict dst,
+                  int count) {
+  using C = SrcChannels<kSrcIsBGRA>;
+  for (int i = 0; i < count; i++) {
+    const uint32_t p = src[i];
+    const uint32_t r = (p >> C::kR) & 0xFF;
+    const uint32_t g = (p >> C::kG) & 0xFF;
+    const uint32_t b = (p >> C::kB) & 0xFF;
+    dst[i] = static_cast<uint8_t>((r * 54 + g * 183 + b * 19) >> 8);
+  }
+}
+
+template <bool kSrcIsBGRA>
+bool ConvertRows(const SkPixmap& src,
+                 const SkIRect& rect,
+                 SkColorType dst_color_type,
+                 uint8_t* dst,
+                 size_t dst_row_bytes) {
+  const SkColorType src_color_type =
+      kSrcIsBGRA ? kBGRA_8888_SkColorType : kRGBA_8888_SkColorType;
+  const int count = rect.width();
+  const size_t dst_bpp = SkColorTypeBytesPerPixel(dst_color_type);
+  for (int y = rect.top(); y < rect.bottom(); y++) {
+    const uint32_t* src_row = src.addr32(rect.left(), y);
+    void* dst_row = dst + y * dst_row_bytes + rect.left() * dst_bpp;
+    switch (dst_color_type) {
+      case kRGBA_8888_SkColorType:
+      case kBGRA_8888_SkColorType:
+        if (dst_color_type == src_color_type) {
+          memcpy(dst_row, src_row, count * sizeof(uint32_t));
+        } else {
+          SwizzleRBRow(src_row, static_cast<uint32_t*>(dst_row), count, 0);
+        }
+        break;
+      case kRGB_888x_SkColorType:
+        if (kSrcIsBGRA) {
+          SwizzleRBRow(src_row, static_cast<uint32_t*>(dst_row), count,
+                       0xFF000000);
+        } else {
+          OrRow(src_row, static_cast<uint32_t*>(dst_row), count, 0xFF000000);
+        }
+        break;
+      case kRGB_565_SkColorType:
+        PackRGB565Row<kSrcIsBGRA>(src_row, static_cast<uint16_t*>(dst_row),
+                                  count);
+        break;
+      case kARGB_4444_SkColorType:
+        PackARGB4444Row<kSrcIsBGRA>(src_row, static_cast<uint16_t*>(dst_row),
+                                    count);
+        break;
+      case kGray_8_SkColorType:
+        PackGray8Row<kSrcIsBGRA>(src_row, static_cast<uint8_t*>(dst_row),
+                                 count);
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool convertPixels(const SkPixmap& src,
+                   const SkIRect& rect,
+                   FlutterSoftwarePixelFormat dst_pixfmt,
+                   void* dst,
+                   size_t dst_row_bytes) {
+  auto dst_color_type = getSkColorType(dst_pixfmt);
+  if (!dst_color_type) {
+    return false;
+  }
+  if (rect.isEmpty()) {
+    return true;
+  }
+  if (!SkIRect::MakeWH(src.width(), src.height()).contains(rect)) {
+    FML_LOG(ERROR) << "Tried to convert pixels outside of the source.";
+    return false;
+  }
+
+  auto dst_bytes = static_cast<uint8_t*>(dst);
+  switch (src.colorType()) {
+    case kRGBA_8888_SkColorType:
+      return ConvertRows<false>(src, rect, *dst_color_type, dst_bytes,
+                                dst_row_bytes);
+    case kBGRA_8888_SkColorType:
+      return ConvertRows<true>(src, rect, *dst_color_type, dst_bytes,
+                               dst_row_bytes);
+    default:
+      FML_LOG(ERROR) << "Unsupported source color type for conversion.";
+      return false;
+  }
+}
@@ -13,4 +13,18 @@ std::optional<SkColorType> getSkColorType(FlutterSoftwarePixelFormat pixfmt);
 
 std::optional<SkColorInfo> getSkColorInfo(FlutterSoftwarePixelFormat pixfmt);
 
+std::optional<size_t> getBytesPerPixel(FlutterSoftwarePixelFormat pixfmt);
+
+/// Converts the pixels of |src| within |rect| to |dst_pixfmt| and writes them
+/// to the same position in |dst|. |src| must hold premultiplied pixels in the
+/// kRGBA_8888 or kBGRA_8888 color type. Pixel formats without alpha get the
+/// pixels as if they were drawn onto black.
+///
+/// Returns false if the conversion is not supported.
+bool convertPixels(const SkPixmap& src,
+                   const SkIRect& rect,
+                   FlutterSoftwarePixelFormat dst_pixfmt,
+                   void* dst,
+                   size_t dst_row_bytes);
+
 #endif
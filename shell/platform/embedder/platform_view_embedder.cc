@@ -4,6 +4,8 @@
 
 #include "flutter/shell/platform/embedder/platform_view_embedder.h"
 
+#include "flutter/shell/platform/embedder/vsync_waiter_headless.h"
+
 namespace flutter {
 
 PlatformViewEmbedder::PlatformViewEmbedder(
@@ -68,7 +70,8 @@ void PlatformViewEmbedder::UpdateSemantics(
     flutter::SemanticsNodeUpdates update,
     flutter::CustomAccessibilityActionUpdates actions) {
   if (platform_dispatch_table_.update_semantics_nodes_callback != nullptr) {
-    platform_dispatch_table_.update_semantics_nodes_callback(std::move(update));
+    semantics_tree_.Update(update, semantics_nodes_);
+    platform_dispatch_table_.update_semantics_nodes_callback(semantics_nodes_);
   }
   if (platform_dispatch_table_.update_semantics_custom_actions_callback !=
       nullptr) {
@@ -77,6 +80,13 @@ void PlatformViewEmbedder::UpdateSemantics(
   }
 }
 
+void PlatformViewEmbedder::SetSemanticsEnabled(bool enabled) {
+  // Embedders drop their semantics tree along with semantics, and the
+  // framework sends the whole tree again once semantics are re-enabled.
+  semantics_tree_.Reset();
+  PlatformView::SetSemanticsEnabled(enabled);
+}
+
 void PlatformViewEmbedder::HandlePlatformMessage(
     std::unique_ptr<flutter::PlatformMessage> message) {
   if (!message) {
@@ -120,6 +130,10 @@ sk_sp<GrDirectContext> PlatformViewEmbedder::CreateResourceContext() const {
 
 // |PlatformView|
 std::unique_ptr<VsyncWaiter> PlatformViewEmbedder::CreateVSyncWaiter() {
+  if (platform_dispatch_table_.headless_rendering) {
+    return std::make_unique<VsyncWaiterHeadless>(task_runners_);
+  }
+
   if (!platform_dispatch_table_.vsync_callback) {
     // Superclass implementation creates a timer based fallback.
     return PlatformView::CreateVSyncWaiter();
@@ -9,6 +9,7 @@
 
 #include "flow/embedded_views.h"
 #include "flutter/fml/macros.h"
+#include "flutter/lib/ui/semantics/semantics_update_codec.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/platform/embedder/embedder.h"
 #include "flutter/shell/platform/embedder/embedder_surface.h"
@@ -31,8 +32,10 @@ namespace flutter {
 
 class PlatformViewEmbedder final : public PlatformView {
  public:
+  // The nodes are owned by the platform view and remain valid until the next
+  // update.
   using UpdateSemanticsNodesCallback =
-      std::function<void(flutter::SemanticsNodeUpdates update)>;
+      std::function<void(const std::vector<const SemanticsNode*>& nodes)>;
   using UpdateSemanticsCustomActionsCallback =
       std::function<void(flutter::CustomAccessibilityActionUpdates actions)>;
   using PlatformMessageResponseCallback =
@@ -52,6 +55,8 @@ class PlatformViewEmbedder final : public PlatformView {
     ComputePlatformResolvedLocaleCallback
         compute_platform_resolved_locale_callback;
     OnPreEngineRestartCallback on_pre_engine_restart_callback;  // optional
+    // Renders frames back to back instead of waiting for vsync.
+    bool headless_rendering;  // optional
   };
 
   // Create a platform view that sets up a software rasterizer.
@@ -103,11 +108,19 @@ class PlatformViewEmbedder final : public PlatformView {
   // |PlatformView|
   void HandlePlatformMessage(std::unique_ptr<PlatformMessage> message) override;
 
+  // |PlatformView|
+  void SetSemanticsEnabled(bool enabled) override;
+
  private:
   std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
   std::unique_ptr<EmbedderSurface> embedder_surface_;
   PlatformDispatchTable platform_dispatch_table_;
 
+  // The semantics tree as last sent to the embedder, so that the embedder
+  // only receives the nodes that changed.
+  RetainedSemanticsTree semantics_tree_;
+  std::vector<const SemanticsNode*> semantics_nodes_;
+
   // |PlatformView|
   std::unique_ptr<Surface> CreateRenderingSurface() override;
 
@@ -0,0 +1,240 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "embedder.h"
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/shell/platform/embedder/pixel_formats.h"
+#include "flutter/shell/platform/embedder/tests/embedder_config_builder.h"
+#include "flutter/shell/platform/embedder/tests/embedder_test.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/tonic/converter/dart_converter.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+class EmbedderBenchmarkFixture : public EmbedderTest {
+  void TestBody() override{};
+};
+
+// Runs the `platform_message_stream` fixture, which counts the messages it
+// receives on any channel.
+class PlatformMessageBenchmark {
+ public:
+  PlatformMessageBenchmark() {
+    auto& context =
+        fixture_.GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+    EmbedderConfigBuilder builder(context);
+    builder.SetSoftwareRendererConfig();
+    builder.SetDartEntrypoint("platform_message_stream");
+
+    fml::AutoResetWaitableEvent ready;
+    context.AddNativeCallback(
+        "SignalNativeTest",
+        CREATE_NATIVE_ENTRY(
+            [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+    context.AddNativeCallback(
+        "SignalNativeCount",
+        CREATE_NATIVE_ENTRY([this](Dart_NativeArguments args) {
+          const int64_t received = tonic::DartConverter<int64_t>::FromDart(
+              Dart_GetNativeArgument(args, 0));
+          if (received == expected_.load()) {
+            received_latch_.Signal();
+          }
+        }));
+    context.AddNativeCallback(
+        "SignalNativeMessage",
+        CREATE_NATIVE_ENTRY([](Dart_NativeArguments args) {
+          FML_LOG(FATAL) << tonic::DartConverter<std::string>::FromDart(
+              Dart_GetNativeArgument(args, 0));
+        }));
+
+    engine_ = builder.LaunchEngine();
+    FML_CHECK(engine_.is_valid());
+    ready.Wait();
+  }
+
+  FLUTTER_API_SYMBOL(FlutterEngine) engine() { return engine_.get(); }
+
+  // Must be called before sending |count| messages that are then waited for
+  // using |WaitForMessages|.
+  void ExpectMessages(int64_t count) { expected_ += count; }
+
+  void WaitForMessages() { received_latch_.Wait(); }
+
+ private:
+  EmbedderBenchmarkFixture fixture_;
+  UniqueEngine engine_;
+  std::atomic<int64_t> expected_ = {0};
+  fml::AutoResetWaitableEvent received_latch_;
+};
+
+// Renders the `render_frames_continuously` fixture in headless mode and counts
+// the frames that reach the embedder.
+class HeadlessFrameBenchmark {
+ public:
+  explicit HeadlessFrameBenchmark(int64_t frame_size) {
+    auto& context = static_cast<EmbedderTestContextSoftware&>(
+        fixture_.GetEmbedderContext(EmbedderTestContextType::kSoftwareContext));
+    context.SetHeadlessFrameCallback(
+        [this](const FlutterSoftwareHeadlessFrame& frame) {
+          frame.release_callback(frame.release_user_data);
+          if (++rendered_ == expected_.load()) {
+            rendered_latch_.Signal();
+          }
+        });
+
+    EmbedderConfigBuilder builder(context);
+    builder.SetSoftwareHeadlessRendererConfig(
+        SkISize::Make(frame_size, frame_size));
+    builder.SetDartEntrypoint("render_frames_continuously");
+    engine_ = builder.LaunchEngine();
+    FML_CHECK(engine_.is_valid());
+
+    FlutterWindowMetricsEvent event = {};
+    event.struct_size = sizeof(event);
+    event.width = frame_size;
+    event.height = frame_size;
+    event.pixel_ratio = 1.0;
+    FML_CHECK(FlutterEngineSendWindowMetricsEvent(engine_.get(), &event) ==
+              kSuccess);
+  }
+
+  // Waits for |count| more frames to be rendered.
+  void WaitForFrames(int64_t count) {
+    expected_ = rendered_.load() + count;
+    rendered_latch_.Wait();
+  }
+
+ private:
+  EmbedderBenchmarkFixture fixture_;
+  std::atomic<int64_t> rendered_ = {0};
+  std::atomic<int64_t> expected_ = {-1};
+  fml::AutoResetWaitableEvent rendered_latch_;
+  UniqueEngine engine_;
+};
+
+}  // namespace
+
+// Reports the number of frames per second that the software backend produces
+// when frames are not paced by vsync.
+static void BM_EmbedderHeadlessFrameRate(benchmark::State& state) {
+  constexpr int64_t kFramesPerIteration = 60;
+  HeadlessFrameBenchmark benchmark(state.range(0));
+  // The first frames include the warm-up of the engine.
+  benchmark.WaitForFrames(kFramesPerIteration);
+  while (state.KeepRunning()) {
+    benchmark.WaitForFrames(kFramesPerIteration);
+  }
+  state.counters["FPS"] = benchmark::Counter(
+      state.iterations() * kFramesPerIteration, benchmark::Counter::kIsRate);
+}
+
+// Converts a whole frame from the format that the software renderer draws in
+// to the pixel format of an embedder owned framebuffer.
+static void BM_EmbedderConvertPixels(benchmark::State& state,
+                                     FlutterSoftwarePixelFormat pixfmt) {
+  constexpr int kSize = 1024;
+  SkBitmap src;
+  src.allocN32Pixels(kSize, kSize);
+  src.eraseColor(SK_ColorCYAN);
+  SkPixmap pixmap;
+  FML_CHECK(src.peekPixels(&pixmap));
+  const size_t row_bytes = kSize * getBytesPerPixel(pixfmt).value();
+  std::vector<uint8_t> dst(row_bytes * kSize);
+
+  while (state.KeepRunning()) {
+    FML_CHECK(convertPixels(pixmap, SkIRect::MakeWH(kSize, kSize), pixfmt,
+                            dst.data(), row_bytes));
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetBytesProcessed(state.iterations() * pixmap.computeByteSize());
+}
+
+static void BM_EmbedderSendPlatformMessage(benchmark::State& state) {
+  PlatformMessageBenchmark benchmark;
+  const int64_t message_count = state.range(0);
+  const uint32_t data = 0;
+
+  FlutterPlatformMessage message = {};
+  message.struct_size = sizeof(FlutterPlatformMessage);
+  message.channel = "test/channel";
+  message.message = reinterpret_cast<const uint8_t*>(&data);
+  message.message_size = sizeof(data);
+
+  while (state.KeepRunning()) {
+    benchmark.ExpectMessages(message_count);
+    for (int64_t i = 0; i < message_count; i++) {
+      FML_CHECK(FlutterEngineSendPlatformMessage(benchmark.engine(),
+                                                 &message) == kSuccess);
+    }
+    benchmark.WaitForMessages();
+  }
+  state.SetItemsProcessed(state.iterations() * message_count);
+}
+
+static void BM_EmbedderSendStreamedPlatformMessage(benchmark::State& state) {
+  PlatformMessageBenchmark benchmark;
+  const int64_t message_count = state.range(0);
+
+  FlutterPlatformMessageStream* stream = nullptr;
+  FML_CHECK(FlutterEngineCreatePlatformMessageStream(
+                benchmark.engine(), "test/stream", 64 * 1024, &stream) ==
+            kSuccess);
+
+  // The fixture verifies that streamed messages are consecutive sequence
+  // numbers.
+  uint32_t sequence_number = 0;
+  while (state.KeepRunning()) {
+    benchmark.ExpectMessages(message_count);
+    for (int64_t i = 0; i < message_count; i++) {
+      bool sent = false;
+      while (!sent) {
+        FML_CHECK(FlutterEngineSendStreamedPlatformMessage(
+                      benchmark.engine(), stream,
+                      reinterpret_cast<const uint8_t*>(&sequence_number),
+                      sizeof(sequence_number), &sent) == kSuccess);
+        if (!sent) {
+          std::this_thread::yield();
+        }
+      }
+      sequence_number++;
+    }
+    benchmark.WaitForMessages();
+  }
+  state.SetItemsProcessed(state.iterations() * message_count);
+
+  FlutterEngineReleasePlatformMessageStream(benchmark.engine(), stream);
+}
+
+BENCHMARK(BM_EmbedderHeadlessFrameRate)
+    ->Arg(256)
+    ->Arg(1024)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_EmbedderConvertPixels, Native32, kNative32);
+BENCHMARK_CAPTURE(BM_EmbedderConvertPixels, RGBX8888, kRGBX8888);
+BENCHMARK_CAPTURE(BM_EmbedderConvertPixels, RGB565, kRGB565);
+BENCHMARK_CAPTURE(BM_EmbedderConvertPixels, RGBA4444, kRGBA4444);
+BENCHMARK_CAPTURE(BM_EmbedderConvertPixels, Gray8, kGray8);
+
+BENCHMARK(BM_EmbedderSendPlatformMessage)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_EmbedderSendStreamedPlatformMessage)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace testing
+}  // namespace flutter
@@ -131,12 +131,51 @@ FlutterProjectArgs& EmbedderConfigBuilder::GetProjectArgs() {
   return project_args_;
 }
 
+FlutterRendererConfig& EmbedderConfigBuilder::GetRendererConfig() {
+  return renderer_config_;
+}
+
 void EmbedderConfigBuilder::SetSoftwareRendererConfig(SkISize surface_size) {
   renderer_config_.type = FlutterRendererType::kSoftware;
   renderer_config_.software = software_renderer_config_;
   context_.SetupSurface(surface_size);
 }
 
+void EmbedderConfigBuilder::SetSoftwareHeadlessRendererConfig(
+    SkISize surface_size,
+    size_t frame_buffer_count) {
+  renderer_config_.type = FlutterRendererType::kSoftware;
+  renderer_config_.software = software_renderer_config_;
+  renderer_config_.software.surface_present_callback = nullptr;
+  renderer_config_.software.headless_frame_callback =
+      [](void* context, const FlutterSoftwareHeadlessFrame* frame) {
+        reinterpret_cast<EmbedderTestContextSoftware*>(context)
+            ->PresentHeadlessFrame(frame);
+      };
+  renderer_config_.software.headless_frame_buffer_count = frame_buffer_count;
+  context_.SetupSurface(surface_size);
+}
+
+void EmbedderConfigBuilder::SetSoftwareFramebufferRendererConfig(
+    SkISize surface_size) {
+  renderer_config_.type = FlutterRendererType::kSoftware;
+  renderer_config_.software = software_renderer_config_;
+  renderer_config_.software.surface_present_callback = nullptr;
+  renderer_config_.software.framebuffer_acquire_callback =
+      [](void* context, const FlutterFrameInfo* frame_info,
+         FlutterSoftwareFramebuffer* framebuffer) {
+        return reinterpret_cast<EmbedderTestContextSoftware*>(context)
+            ->AcquireFramebuffer(frame_info, framebuffer);
+      };
+  renderer_config_.software.framebuffer_present_callback =
+      [](void* context,
+         const FlutterSoftwareFramebufferPresentInfo* present_info) {
+        return reinterpret_cast<EmbedderTestContextSoftware*>(context)
+            ->PresentFramebuffer(present_info);
+      };
+  context_.SetupSurface(surface_size);
+}
+
 void EmbedderConfigBuilder::SetOpenGLFBOCallBack() {
 #ifdef SHELL_ENABLE_GL
   // SetOpenGLRendererConfig must be called before this.
@@ -45,10 +45,24 @@ class EmbedderConfigBuilder {
 
   FlutterProjectArgs& GetProjectArgs();
 
+  FlutterRendererConfig& GetRendererConfig();
+
   void SetRendererConfig(EmbedderTestContextType type, SkISize surface_size);
 
   void SetSoftwareRendererConfig(SkISize surface_size = SkISize::Make(1, 1));
 
+  // Renders in headless mode. Frames are handed to the callback set with
+  // `EmbedderTestContextSoftware::SetHeadlessFrameCallback`.
+  void SetSoftwareHeadlessRendererConfig(
+      SkISize surface_size = SkISize::Make(1, 1),
+      size_t frame_buffer_count = 0);
+
+  // Presents frames into embedder owned framebuffers, which are provided by
+  // the callbacks set with
+  // `EmbedderTestContextSoftware::SetFramebufferCallbacks`.
+  void SetSoftwareFramebufferRendererConfig(
+      SkISize surface_size = SkISize::Make(1, 1));
+
   void SetOpenGLRendererConfig(SkISize surface_size);
 
   void SetMetalRendererConfig(SkISize surface_size);
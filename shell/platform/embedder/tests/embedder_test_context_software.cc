@@ -11,6 +11,8 @@
 #include "flutter/shell/platform/embedder/tests/embedder_test_compositor_software.h"
 #include "flutter/testing/testing.h"
 #include "third_party/dart/runtime/bin/elf_loader.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPixmap.h"
 #include "third_party/skia/include/core/SkSurface.h"
 
 namespace flutter {
@@ -30,6 +32,50 @@ bool EmbedderTestContextSoftware::Present(sk_sp<SkImage> image) {
   return true;
 }
 
+void EmbedderTestContextSoftware::SetHeadlessFrameCallback(
+    const HeadlessFrameCallback& callback) {
+  headless_frame_callback_ = callback;
+}
+
+void EmbedderTestContextSoftware::PresentHeadlessFrame(
+    const FlutterSoftwareHeadlessFrame* frame) {
+  if (headless_frame_callback_) {
+    headless_frame_callback_(*frame);
+    return;
+  }
+
+  auto image_info = SkImageInfo::MakeN32Premul(
+      SkISize::Make(frame->width, frame->height));
+  SkPixmap pixmap(image_info, frame->allocation, frame->row_bytes);
+  // The pixels are only valid until the frame is released.
+  sk_sp<SkImage> image = SkImage::MakeRasterCopy(pixmap);
+  frame->release_callback(frame->release_user_data);
+  Present(std::move(image));
+}
+
+void EmbedderTestContextSoftware::SetFramebufferCallbacks(
+    const FramebufferAcquireCallback& acquire,
+    const FramebufferPresentCallback& present) {
+  framebuffer_acquire_callback_ = acquire;
+  framebuffer_present_callback_ = present;
+}
+
+bool EmbedderTestContextSoftware::AcquireFramebuffer(
+    const FlutterFrameInfo* frame_info,
+    FlutterSoftwareFramebuffer* framebuffer) {
+  FML_CHECK(framebuffer_acquire_callback_)
+      << "Framebuffer callbacks were not set.";
+  return framebuffer_acquire_callback_(*frame_info, framebuffer);
+}
+
+bool EmbedderTestContextSoftware::PresentFramebuffer(
+    const FlutterSoftwareFramebufferPresentInfo* present_info) {
+  FML_CHECK(framebuffer_present_callback_)
+      << "Framebuffer callbacks were not set.";
+  software_surface_present_count_++;
+  return framebuffer_present_callback_(*present_info);
+}
+
 size_t EmbedderTestContextSoftware::GetSurfacePresentCount() const {
   return software_surface_present_count_;
 }
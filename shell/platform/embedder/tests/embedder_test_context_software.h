@@ -23,6 +23,33 @@ class EmbedderTestContextSoftware : public EmbedderTestContext {
 
   bool Present(sk_sp<SkImage> image);
 
+  using HeadlessFrameCallback =
+      std::function<void(const FlutterSoftwareHeadlessFrame& frame)>;
+
+  // Takes over the frames rendered in headless mode, which the callback is
+  // responsible for releasing. Without a callback, frames are presented like
+  // the ones of the regular software renderer.
+  void SetHeadlessFrameCallback(const HeadlessFrameCallback& callback);
+
+  void PresentHeadlessFrame(const FlutterSoftwareHeadlessFrame* frame);
+
+  using FramebufferAcquireCallback =
+      std::function<bool(const FlutterFrameInfo& frame_info,
+                         FlutterSoftwareFramebuffer* framebuffer)>;
+  using FramebufferPresentCallback = std::function<bool(
+      const FlutterSoftwareFramebufferPresentInfo& present_info)>;
+
+  // Provides the framebuffers of the renderer configured with
+  // `EmbedderConfigBuilder::SetSoftwareFramebufferRendererConfig`.
+  void SetFramebufferCallbacks(const FramebufferAcquireCallback& acquire,
+                               const FramebufferPresentCallback& present);
+
+  bool AcquireFramebuffer(const FlutterFrameInfo* frame_info,
+                          FlutterSoftwareFramebuffer* framebuffer);
+
+  bool PresentFramebuffer(
+      const FlutterSoftwareFramebufferPresentInfo* present_info);
+
  protected:
   virtual void SetupCompositor() override;
 
@@ -30,6 +57,9 @@ class EmbedderTestContextSoftware : public EmbedderTestContext {
   sk_sp<SkSurface> surface_;
   SkISize surface_size_;
   size_t software_surface_present_count_ = 0;
+  HeadlessFrameCallback headless_frame_callback_;
+  FramebufferAcquireCallback framebuffer_acquire_callback_;
+  FramebufferPresentCallback framebuffer_present_callback_;
   void SetupSurface(SkISize surface_size) override;
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderTestContextSoftware);
@@ -4,7 +4,11 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <algorithm>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "embedder.h"
@@ -22,12 +26,16 @@
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/platform/embedder/embedder_software_frame_pool.h"
+#include "flutter/shell/platform/embedder/pixel_formats.h"
 #include "flutter/shell/platform/embedder/tests/embedder_assertions.h"
 #include "flutter/shell/platform/embedder/tests/embedder_config_builder.h"
 #include "flutter/shell/platform/embedder/tests/embedder_test.h"
 #include "flutter/shell/platform/embedder/tests/embedder_unittests_util.h"
 #include "flutter/testing/assertions_skia.h"
 #include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkColorPriv.h"
+#include "third_party/skia/include/core/SkPixmap.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/tonic/converter/dart_converter.h"
 
@@ -35,6 +43,10 @@
 #include <pthread.h>
 #endif
 
+#if defined(FML_OS_LINUX)
+#include <sys/resource.h>
+#endif
+
 // CREATE_NATIVE_ENTRY is leaky by design
 // NOLINTBEGIN(clang-analyzer-core.StackAddressEscape)
 
@@ -503,6 +515,109 @@ TEST_F(EmbedderTest, InvalidPlatformMessages) {
   ASSERT_EQ(result, kInvalidArguments);
 }
 
+//------------------------------------------------------------------------------
+/// Tests that messages sent on a platform message stream arrive in order and
+/// are batched into fewer platform messages than were sent.
+///
+TEST_F(EmbedderTest, PlatformMessageStreamsDeliverMessagesInBatches) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.SetDartEntrypoint("platform_message_stream");
+
+  constexpr uint32_t kMessageCount = 10000;
+  size_t batch_count = 0;
+  fml::AutoResetWaitableEvent ready, done;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+  context.AddNativeCallback(
+      "SignalNativeCount",
+      CREATE_NATIVE_ENTRY([&](Dart_NativeArguments args) {
+        batch_count++;
+        if (tonic::DartConverter<int64_t>::FromDart(
+                Dart_GetNativeArgument(args, 0)) == kMessageCount) {
+          done.Signal();
+        }
+      }));
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY([](Dart_NativeArguments args) {
+        FAIL() << tonic::DartConverter<std::string>::FromDart(
+            Dart_GetNativeArgument(args, 0));
+      }));
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+  ready.Wait();
+
+  FlutterPlatformMessageStream* stream = nullptr;
+  ASSERT_EQ(FlutterEngineCreatePlatformMessageStream(
+                engine.get(), "test/stream", 4096, &stream),
+            kSuccess);
+  ASSERT_NE(stream, nullptr);
+
+  for (uint32_t i = 0; i < kMessageCount; i++) {
+    bool sent = false;
+    while (!sent) {
+      ASSERT_EQ(FlutterEngineSendStreamedPlatformMessage(
+                    engine.get(), stream, reinterpret_cast<const uint8_t*>(&i),
+                    sizeof(i), &sent),
+                kSuccess);
+      if (!sent) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  // Queued messages are delivered after the stream is released.
+  ASSERT_EQ(FlutterEngineReleasePlatformMessageStream(engine.get(), stream),
+            kSuccess);
+  done.Wait();
+  EXPECT_LT(batch_count, kMessageCount);
+}
+
+//------------------------------------------------------------------------------
+/// Tests that invalid messages are rejected by platform message streams.
+///
+TEST_F(EmbedderTest, InvalidStreamedPlatformMessages) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterPlatformMessageStream* stream = nullptr;
+  ASSERT_EQ(FlutterEngineCreatePlatformMessageStream(engine.get(),
+                                                     "test/stream", 0, &stream),
+            kInvalidArguments);
+  // Capacities are bounded so that rounding them up cannot overflow.
+  ASSERT_EQ(FlutterEngineCreatePlatformMessageStream(
+                engine.get(), "test/stream", (size_t{1} << 30) + 1, &stream),
+            kInvalidArguments);
+  ASSERT_EQ(FlutterEngineCreatePlatformMessageStream(
+                engine.get(), "test/stream", SIZE_MAX, &stream),
+            kInvalidArguments);
+  ASSERT_EQ(FlutterEngineCreatePlatformMessageStream(
+                engine.get(), "test/stream", 256, &stream),
+            kSuccess);
+
+  bool sent = false;
+  EXPECT_EQ(FlutterEngineSendStreamedPlatformMessage(engine.get(), stream,
+                                                     nullptr, 1, &sent),
+            kInvalidArguments);
+  std::vector<uint8_t> oversized(256);
+  EXPECT_EQ(FlutterEngineSendStreamedPlatformMessage(
+                engine.get(), stream, oversized.data(), oversized.size(),
+                &sent),
+            kInvalidArguments);
+  EXPECT_FALSE(sent);
+
+  ASSERT_EQ(FlutterEngineReleasePlatformMessageStream(engine.get(), stream),
+            kSuccess);
+}
+
 //------------------------------------------------------------------------------
 /// Tests that setting a custom log callback works as expected and defaults to
 /// using tag "flutter".
@@ -2126,6 +2241,286 @@ TEST_F(EmbedderTest, CanScheduleFrame) {
   check_latch.Wait();
 }
 
+TEST(EmbedderSoftwareFramePoolTest, RecyclesReleasedBuffers) {
+  auto pool = EmbedderSoftwareFramePool::Create(1);
+  auto first = pool->AcquireSurface(SkISize::Make(10, 10));
+  auto second = pool->AcquireSurface(SkISize::Make(10, 10));
+  ASSERT_TRUE(first && second);
+  ASSERT_NE(first.get(), second.get());
+  const SkSurface* first_surface = first.get();
+
+  pool->MakeReleaseClosure(std::move(first))();
+  pool->MakeReleaseClosure(std::move(second))();
+  // Buffers over the configured count are freed.
+  EXPECT_EQ(pool->GetIdleBufferCount(), 1u);
+  EXPECT_EQ(pool->AcquireSurface(SkISize::Make(10, 10)).get(), first_surface);
+  EXPECT_EQ(pool->GetIdleBufferCount(), 0u);
+}
+
+TEST(EmbedderSoftwareFramePoolTest, DropsBuffersOfOtherSizes) {
+  auto pool = EmbedderSoftwareFramePool::Create(2);
+  auto small = pool->AcquireSurface(SkISize::Make(10, 10));
+  ASSERT_TRUE(small);
+  pool->MakeReleaseClosure(std::move(small))();
+  EXPECT_EQ(pool->GetIdleBufferCount(), 1u);
+
+  auto large = pool->AcquireSurface(SkISize::Make(20, 20));
+  ASSERT_TRUE(large);
+  EXPECT_EQ(large->width(), 20);
+  EXPECT_EQ(pool->GetIdleBufferCount(), 0u);
+
+  // Frames may outlive the pool.
+  auto release = pool->MakeReleaseClosure(std::move(large));
+  pool.reset();
+  release();
+}
+
+TEST_F(EmbedderTest, HeadlessRenderingDeliversFramesInPooledBuffers) {
+  auto& context = static_cast<EmbedderTestContextSoftware&>(
+      GetEmbedderContext(EmbedderTestContextType::kSoftwareContext));
+
+  constexpr size_t kFrameCount = 10;
+  fml::CountDownLatch frames_latch(kFrameCount);
+  std::mutex mutex;
+  size_t frame_count = 0;
+  std::set<const void*> allocations;
+  std::vector<FlutterSoftwareHeadlessFrame> held_frames;
+  context.SetHeadlessFrameCallback(
+      [&](const FlutterSoftwareHeadlessFrame& frame) {
+        SkPixmap pixmap(SkImageInfo::MakeN32Premul(frame.width, frame.height),
+                        frame.allocation, frame.row_bytes);
+        EXPECT_EQ(pixmap.getColor(0, 0), SK_ColorRED);
+
+        std::scoped_lock lock(mutex);
+        if (frame_count == kFrameCount) {
+          frame.release_callback(frame.release_user_data);
+          return;
+        }
+        allocations.insert(frame.allocation);
+        // Holds on to the first half of the frames.
+        if (frame_count < kFrameCount / 2) {
+          held_frames.push_back(frame);
+        } else {
+          frame.release_callback(frame.release_user_data);
+        }
+        frame_count++;
+        frames_latch.CountDown();
+      });
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareHeadlessRendererConfig(SkISize::Make(64, 64));
+  builder.SetDartEntrypoint("render_frames_continuously");
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 64;
+  event.height = 64;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  frames_latch.Wait();
+  engine.reset();
+
+  // Frames that are held get buffers of their own, and the remaining frames
+  // reuse a single buffer since each is released before the next is drawn.
+  EXPECT_EQ(allocations.size(), kFrameCount / 2 + 1);
+  for (const auto& frame : held_frames) {
+    frame.release_callback(frame.release_user_data);
+  }
+}
+
+TEST_F(EmbedderTest, HeadlessRenderingMayNotBePacedByTheEmbedder) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareHeadlessRendererConfig();
+  builder.SetupVsyncCallback();
+  auto engine = builder.LaunchEngine();
+  ASSERT_FALSE(engine.is_valid());
+}
+
+TEST(EmbedderPixelFormatsTest, ConvertsPremultipliedPixels) {
+  const uint32_t src_pixels[] = {
+      SkPackARGB32(0xFF, 0xFF, 0x00, 0x00),
+      SkPackARGB32(0xFF, 0x00, 0xFF, 0x00),
+      SkPackARGB32(0xFF, 0x00, 0x00, 0xFF),
+      SkPackARGB32(0x80, 0x80, 0x40, 0x00),
+  };
+  SkPixmap src(SkImageInfo::MakeN32Premul(4, 1), src_pixels,
+               sizeof(src_pixels));
+  const SkIRect rect = SkIRect::MakeWH(4, 1);
+
+  uint16_t rgb565[4] = {};
+  ASSERT_TRUE(convertPixels(src, rect, kRGB565, rgb565, sizeof(rgb565)));
+  EXPECT_EQ(rgb565[0], 0xF800);
+  EXPECT_EQ(rgb565[1], 0x07E0);
+  EXPECT_EQ(rgb565[2], 0x001F);
+  EXPECT_EQ(rgb565[3], (0x10 << 11) | (0x10 << 5));
+
+  uint16_t rgba4444[4] = {};
+  ASSERT_TRUE(
+      convertPixels(src, rect, kRGBA4444, rgba4444, sizeof(rgba4444)));
+  EXPECT_EQ(rgba4444[0], 0xF00F);
+  EXPECT_EQ(rgba4444[3], 0x8408);
+
+  uint8_t gray8[4] = {};
+  ASSERT_TRUE(convertPixels(src, rect, kGray8, gray8, sizeof(gray8)));
+  EXPECT_EQ(gray8[0], (0xFF * 54) >> 8);
+  EXPECT_EQ(gray8[1], (0xFF * 183) >> 8);
+  EXPECT_EQ(gray8[2], (0xFF * 19) >> 8);
+
+  uint8_t rgba8888[16] = {};
+  ASSERT_TRUE(
+      convertPixels(src, rect, kRGBA8888, rgba8888, sizeof(rgba8888)));
+  uint8_t bgra8888[16] = {};
+  ASSERT_TRUE(
+      convertPixels(src, rect, kBGRA8888, bgra8888, sizeof(bgra8888)));
+  uint8_t rgbx8888[16] = {};
+  ASSERT_TRUE(
+      convertPixels(src, rect, kRGBX8888, rgbx8888, sizeof(rgbx8888)));
+  for (int i = 0; i < 4; i++) {
+    const SkColor color = src.getColor(i, 0);
+    const uint8_t* rgba = &rgba8888[i * 4];
+    const uint8_t* bgra = &bgra8888[i * 4];
+    const uint8_t* rgbx = &rgbx8888[i * 4];
+    EXPECT_EQ(rgba[0], bgra[2]);
+    EXPECT_EQ(rgba[1], bgra[1]);
+    EXPECT_EQ(rgba[2], bgra[0]);
+    EXPECT_EQ(rgba[3], SkColorGetA(color));
+    EXPECT_EQ(bgra[3], SkColorGetA(color));
+    EXPECT_EQ(rgbx[0], rgba[0]);
+    EXPECT_EQ(rgbx[2], rgba[2]);
+    EXPECT_EQ(rgbx[3], 0xFF);
+  }
+  EXPECT_EQ(rgba8888[0], 0xFF);
+  EXPECT_EQ(rgba8888[2], 0x00);
+}
+
+TEST(EmbedderPixelFormatsTest, ConvertsOnlyPixelsInRect) {
+  uint32_t src_pixels[16];
+  std::fill(std::begin(src_pixels), std::end(src_pixels),
+            SkPackARGB32(0xFF, 0xFF, 0x00, 0x00));
+  SkPixmap src(SkImageInfo::MakeN32Premul(4, 4), src_pixels,
+               4 * sizeof(uint32_t));
+
+  uint16_t dst[16] = {};
+  ASSERT_TRUE(convertPixels(src, SkIRect::MakeLTRB(1, 2, 3, 4), kRGB565, dst,
+                            4 * sizeof(uint16_t)));
+  for (int y = 0; y < 4; y++) {
+    for (int x = 0; x < 4; x++) {
+      const bool in_rect = x >= 1 && x < 3 && y >= 2;
+      EXPECT_EQ(dst[y * 4 + x], in_rect ? 0xF800 : 0) << x << "," << y;
+    }
+  }
+
+  EXPECT_FALSE(convertPixels(src, SkIRect::MakeWH(5, 1), kRGB565, dst,
+                             4 * sizeof(uint16_t)));
+}
+
+TEST_F(EmbedderTest, FramebufferRenderingCopiesOnlyDamagedPixels) {
+  auto& context = static_cast<EmbedderTestContextSoftware&>(
+      GetEmbedderContext(EmbedderTestContextType::kSoftwareContext));
+
+  constexpr int kSize = 64;
+  constexpr size_t kFrameCount = 12;
+  constexpr size_t kFrameBytes = kSize * kSize * sizeof(uint16_t);
+  // Double buffered, like a scanout device that flips between two buffers.
+  std::vector<uint16_t> buffers[2] = {std::vector<uint16_t>(kSize * kSize),
+                                      std::vector<uint16_t>(kSize * kSize)};
+  size_t last_presented[2] = {0, 0};
+  size_t acquire_count = 0;
+  size_t present_count = 0;
+  std::vector<size_t> bytes_copied;
+  fml::CountDownLatch frames_latch(kFrameCount);
+
+  context.SetFramebufferCallbacks(
+      [&](const FlutterFrameInfo& frame_info,
+          FlutterSoftwareFramebuffer* framebuffer) {
+        EXPECT_EQ(frame_info.size.width, static_cast<uint32_t>(kSize));
+        EXPECT_EQ(frame_info.size.height, static_cast<uint32_t>(kSize));
+        const size_t index = acquire_count++ % 2;
+        framebuffer->allocation = buffers[index].data();
+        framebuffer->row_bytes = kSize * sizeof(uint16_t);
+        framebuffer->pixel_format = kRGB565;
+        framebuffer->age = last_presented[index] == 0
+                               ? 0
+                               : acquire_count - last_presented[index];
+        framebuffer->user_data = reinterpret_cast<void*>(index);
+        return true;
+      },
+      [&](const FlutterSoftwareFramebufferPresentInfo& present_info) {
+        const size_t index =
+            reinterpret_cast<size_t>(present_info.framebuffer->user_data);
+        last_presented[index] = acquire_count;
+        if (present_count == kFrameCount) {
+          return true;
+        }
+        present_count++;
+
+        const FlutterRect& damage = present_info.damage;
+        bytes_copied.push_back((damage.right - damage.left) *
+                               (damage.bottom - damage.top) *
+                               sizeof(uint16_t));
+
+        // Whatever was copied, the buffer must hold the whole frame: a blue
+        // view with a single red 8x8 box at the top.
+        size_t red_pixels = 0;
+        for (uint16_t pixel : buffers[index]) {
+          if (pixel == 0xF800) {
+            red_pixels++;
+          } else {
+            EXPECT_EQ(pixel, 0x001F);
+          }
+        }
+        EXPECT_EQ(red_pixels, 64u);
+        frames_latch.CountDown();
+        return true;
+      });
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareFramebufferRendererConfig(SkISize::Make(kSize, kSize));
+  builder.SetDartEntrypoint("move_box_continuously");
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = kSize;
+  event.height = kSize;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  frames_latch.Wait();
+  engine.reset();
+
+  ASSERT_EQ(bytes_copied.size(), kFrameCount);
+  // Each buffer is filled in full the first time it is used.
+  EXPECT_EQ(bytes_copied[0], kFrameBytes);
+  EXPECT_EQ(bytes_copied[1], kFrameBytes);
+  // After that, only the rows of the box are copied, for the frame itself
+  // and for the frame that the buffer missed.
+  size_t total_bytes = 0;
+  for (size_t i = 2; i < kFrameCount; i++) {
+    EXPECT_LE(bytes_copied[i], kFrameBytes / 8) << "Frame " << i;
+    total_bytes += bytes_copied[i];
+  }
+  FML_LOG(INFO) << "Copied " << total_bytes / (kFrameCount - 2)
+                << " bytes per frame on average, out of " << kFrameBytes
+                << ".";
+}
+
+TEST_F(EmbedderTest, FramebufferCallbacksMustBeSetTogether) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareFramebufferRendererConfig();
+  builder.GetRendererConfig().software.framebuffer_present_callback = nullptr;
+  auto engine = builder.LaunchEngine();
+  ASSERT_FALSE(engine.is_valid());
+}
+
 #if defined(FML_OS_MACOSX)
 
 static void MockThreadConfigSetter(const fml::Thread::ThreadConfig& config) {
@@ -2166,6 +2561,53 @@ TEST_F(EmbedderTest, EmbedderThreadHostUseCustomThreadConfig) {
 }
 #endif
 
+#if defined(FML_OS_LINUX)
+TEST_F(EmbedderTest, EmbedderThreadHostAppliesThreadPolicies) {
+  fml::Thread::ThreadPolicy policy;
+  policy.nice = 19;
+  auto thread_host =
+      flutter::EmbedderThreadHost::CreateEmbedderOrEngineManagedThreadHost(
+          nullptr, fml::Thread::SetCurrentThreadName,
+          {{flutter::ThreadHost::Type::RASTER, policy}});
+  ASSERT_TRUE(thread_host && thread_host->IsValid());
+
+  int raster_nice = 0;
+  int ui_nice = 0;
+  fml::AutoResetWaitableEvent latch;
+  fml::TaskRunner::RunNowOrPostTask(
+      thread_host->GetTaskRunners().GetRasterTaskRunner(), [&]() {
+        raster_nice = getpriority(PRIO_PROCESS, 0);
+        fml::TaskRunner::RunNowOrPostTask(
+            thread_host->GetTaskRunners().GetUITaskRunner(), [&]() {
+              ui_nice = getpriority(PRIO_PROCESS, 0);
+              latch.Signal();
+            });
+      });
+  latch.Wait();
+  ASSERT_EQ(raster_nice, 19);
+  ASSERT_NE(ui_nice, 19);
+}
+
+TEST_F(EmbedderTest, ThreadPoliciesCanBeSetFromTheCommandLine) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.AddCommandLineArgument("--raster-thread-policy=nice=19");
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  int raster_nice = 0;
+  fml::AutoResetWaitableEvent latch;
+  auto task_runners = ToEmbedderEngine(engine.get())->GetTaskRunners();
+  task_runners.GetRasterTaskRunner()->PostTask([&]() {
+    raster_nice = getpriority(PRIO_PROCESS, 0);
+    latch.Signal();
+  });
+  latch.Wait();
+  ASSERT_EQ(raster_nice, 19);
+}
+#endif  // FML_OS_LINUX
+
 }  // namespace testing
 }  // namespace flutter
 
@@ -0,0 +1,47 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/vsync_waiter_headless.h"
+
+#include <memory>
+#include <utility>
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+// Frames still get a target time one display refresh after their start so
+// that animations advance the same way they would on a display.
+constexpr fml::TimeDelta kFrameInterval =
+    fml::TimeDelta::FromSecondsF(1.0 / 60.0);
+
+}  // namespace
+
+VsyncWaiterHeadless::VsyncWaiterHeadless(flutter::TaskRunners task_runners)
+    : VsyncWaiter(std::move(task_runners)) {}
+
+VsyncWaiterHeadless::~VsyncWaiterHeadless() = default;
+
+// |VsyncWaiter|
+bool VsyncWaiterHeadless::IsPacedByDisplay() const {
+  return false;
+}
+
+// |VsyncWaiter|
+void VsyncWaiterHeadless::AwaitVSync() {
+  TRACE_EVENT0("flutter", "VSYNC");
+
+  std::weak_ptr<VsyncWaiterHeadless> weak_this =
+      std::static_pointer_cast<VsyncWaiterHeadless>(shared_from_this());
+  task_runners_.GetUITaskRunner()->PostTask([weak_this]() {
+    if (auto vsync_waiter = weak_this.lock()) {
+      const fml::TimePoint now = fml::TimePoint::Now();
+      vsync_waiter->FireCallback(now, now + kFrameInterval);
+    }
+  });
+}
+
+}  // namespace flutter
@@ -0,0 +1,34 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_PLATFORM_EMBEDDER_VSYNC_WAITER_HEADLESS_H_
+#define SHELL_PLATFORM_EMBEDDER_VSYNC_WAITER_HEADLESS_H_
+
+#include "flutter/fml/macros.h"
+#include "flutter/shell/common/vsync_waiter.h"
+
+namespace flutter {
+
+/// A |VsyncWaiter| for engines that render without a display. It fires as
+/// soon as the UI thread gets to it, so frames are only paced by how fast
+/// the layer tree pipeline is drained.
+class VsyncWaiterHeadless final : public VsyncWaiter {
+ public:
+  explicit VsyncWaiterHeadless(flutter::TaskRunners task_runners);
+
+  ~VsyncWaiterHeadless() override;
+
+  // |VsyncWaiter|
+  bool IsPacedByDisplay() const override;
+
+ private:
+  // |VsyncWaiter|
+  void AwaitVSync() override;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(VsyncWaiterHeadless);
+};
+
+}  // namespace flutter
+
+#endif  // SHELL_PLATFORM_EMBEDDER_VSYNC_WAITER_HEADLESS_H_
@@ -0,0 +1,306 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/profiling/profiler_metrics_linux.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "flutter/fml/eintr_wrapper.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr double kBytesPerMB = 1024.0 * 1024.0;
+constexpr double kKiloBytesPerMB = 1024.0;
+
+// Reading smaps_rollup walks every mapping of the process.
+constexpr fml::TimeDelta kProportionalSetSizeInterval =
+    fml::TimeDelta::FromSeconds(1);
+
+// The prefix of the threads of the engine's concurrent message loop.
+constexpr std::string_view kWorkerThreadPrefix = "io.worker.";
+// The name of the threads of the Dart VM's thread pool.
+constexpr std::string_view kDartWorkerThreadName = "DartWorker";
+
+// Reads a file of the proc file system. These report a size of zero, so they
+// cannot be mapped.
+std::optional<std::string> ReadProcFile(const fml::UniqueFD& directory,
+                                        const char* path) {
+  fml::UniqueFD fd = fml::OpenFileReadOnly(directory, path);
+  if (!fd.is_valid()) {
+    return std::nullopt;
+  }
+  std::string contents;
+  char buffer[1024];
+  while (true) {
+    ssize_t bytes = FML_HANDLE_EINTR(read(fd.get(), buffer, sizeof(buffer)));
+    if (bytes < 0) {
+      return std::nullopt;
+    }
+    if (bytes == 0) {
+      return contents;
+    }
+    contents.append(buffer, bytes);
+  }
+}
+
+std::optional<uint64_t> ParseNumber(std::string_view text) {
+  size_t start = text.find_first_not_of(' ');
+  if (start == std::string_view::npos) {
+    return std::nullopt;
+  }
+  uint64_t value = 0;
+  size_t end = start;
+  for (; end < text.size() && text[end] >= '0' && text[end] <= '9'; end++) {
+    value = value * 10 + (text[end] - '0');
+  }
+  if (end == start) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+// Splits |text| at runs of spaces.
+std::vector<std::string_view> SplitFields(std::string_view text) {
+  std::vector<std::string_view> fields;
+  size_t start = text.find_first_not_of(" \n");
+  while (start != std::string_view::npos) {
+    size_t end = text.find_first_of(" \n", start);
+    fields.push_back(text.substr(start, end - start));
+    if (end == std::string_view::npos) {
+      break;
+    }
+    start = text.find_first_not_of(" \n", end);
+  }
+  return fields;
+}
+
+std::string GetRoleFromThreadName(std::string_view name) {
+  if (name.substr(0, kWorkerThreadPrefix.size()) == kWorkerThreadPrefix) {
+    return "worker";
+  }
+  if (name.substr(0, kDartWorkerThreadName.size()) == kDartWorkerThreadName) {
+    return "dart";
+  }
+  return "other";
+}
+
+}  // namespace
+
+ProfilerMetricsLinux::ProfilerMetricsLinux(std::string proc_path)
+    : proc_path_(std::move(proc_path)),
+      clock_ticks_per_second_(sysconf(_SC_CLK_TCK)),
+      page_size_(sysconf(_SC_PAGESIZE)) {}
+
+ProfilerMetricsLinux::~ProfilerMetricsLinux() = default;
+
+void ProfilerMetricsLinux::RegisterCurrentThread(const std::string& role) {
+  RegisterThread(static_cast<pid_t>(syscall(SYS_gettid)), role);
+}
+
+void ProfilerMetricsLinux::RegisterThread(pid_t tid, const std::string& role) {
+  std::scoped_lock lock(registered_roles_mutex_);
+  registered_roles_[tid] = role;
+}
+
+ProfileSample ProfilerMetricsLinux::GenerateSample() {
+  TRACE_EVENT0("flutter::profiling", "ProfilerMetricsLinux::GenerateSample");
+  const fml::TimePoint now = fml::TimePoint::Now();
+  ProfileSample sample;
+  fml::UniqueFD process_directory = fml::OpenDirectory(
+      proc_path_.c_str(), false, fml::FilePermission::kRead);
+  if (!process_directory.is_valid()) {
+    FML_DLOG(ERROR) << "Could not open " << proc_path_;
+    return sample;
+  }
+
+  std::map<std::string, double> cpu_usage_by_role;
+  sample.cpu_usage =
+      SampleCpuUsage(process_directory, now, cpu_usage_by_role);
+  for (const auto& [role, cpu_usage] : cpu_usage_by_role) {
+    sample.thread_cpu_usage.push_back({role, cpu_usage});
+  }
+
+  sample.resident_memory = SampleResidentMemory(process_directory, now);
+
+  last_sample_time_ = now;
+  return sample;
+}
+
+std::optional<CpuUsageInfo> ProfilerMetricsLinux::SampleCpuUsage(
+    const fml::UniqueFD& process_directory,
+    fml::TimePoint now,
+    std::map<std::string, double>& cpu_usage_by_role) {
+  fml::UniqueFD task_directory =
+      fml::OpenDirectoryReadOnly(process_directory, "task");
+  if (!task_directory.is_valid()) {
+    FML_DLOG(ERROR) << "Could not open the threads of " << proc_path_;
+    return std::nullopt;
+  }
+
+  std::optional<std::string> process_stat =
+      ReadProcFile(process_directory, "stat");
+  std::optional<uint64_t> process_cpu_ticks =
+      process_stat ? ParseCpuTicks(*process_stat) : std::nullopt;
+  // Threads first seen after the first sample used all of their CPU time
+  // since it.
+  const bool has_previous_sample = process_cpu_ticks_.has_value();
+  const double elapsed_ticks =
+      (now - last_sample_time_).ToSecondsF() * clock_ticks_per_second_;
+
+  std::unordered_map<pid_t, std::string> registered_roles;
+  {
+    std::scoped_lock lock(registered_roles_mutex_);
+    registered_roles = registered_roles_;
+  }
+
+  std::unordered_map<pid_t, ThreadState> threads;
+  fml::VisitFiles(task_directory, [&](const fml::UniqueFD& directory,
+                                      const std::string& filename) {
+    pid_t tid = static_cast<pid_t>(std::strtol(filename.c_str(), nullptr, 10));
+    if (tid <= 0) {
+      return true;
+    }
+    std::optional<std::string> stat =
+        ReadProcFile(directory, (filename + "/stat").c_str());
+    std::optional<uint64_t> cpu_ticks =
+        stat ? ParseCpuTicks(*stat) : std::nullopt;
+    if (!cpu_ticks) {
+      // The thread has exited since the directory was listed.
+      return true;
+    }
+
+    ThreadState state;
+    state.cpu_ticks = *cpu_ticks;
+    uint64_t previous_cpu_ticks = 0;
+    auto previous = threads_.find(tid);
+    if (previous != threads_.end()) {
+      state.role = std::move(previous->second.role);
+      previous_cpu_ticks = previous->second.cpu_ticks;
+    } else {
+      std::optional<std::string> name =
+          ReadProcFile(directory, (filename + "/comm").c_str());
+      state.role = GetRoleFromThreadName(name ? *name : "");
+    }
+
+    auto registered = registered_roles.find(tid);
+    const std::string& role = registered != registered_roles.end()
+                                  ? registered->second
+                                  : state.role;
+    double& cpu_usage = cpu_usage_by_role[role];
+    if (has_previous_sample && elapsed_ticks > 0 &&
+        state.cpu_ticks >= previous_cpu_ticks) {
+      cpu_usage +=
+          (state.cpu_ticks - previous_cpu_ticks) * 100.0 / elapsed_ticks;
+    }
+    threads[tid] = std::move(state);
+    return true;
+  });
+  // Forgets the threads that have exited.
+  threads_ = std::move(threads);
+
+  std::optional<uint64_t> previous_process_cpu_ticks = process_cpu_ticks_;
+  process_cpu_ticks_ = process_cpu_ticks;
+  if (!has_previous_sample || !process_cpu_ticks || elapsed_ticks <= 0) {
+    cpu_usage_by_role.clear();
+    return std::nullopt;
+  }
+
+  const long num_cores = std::max(sysconf(_SC_NPROCESSORS_ONLN), 1L);
+  return CpuUsageInfo{
+      .num_threads = static_cast<uint32_t>(threads_.size()),
+      .total_cpu_usage = (*process_cpu_ticks - *previous_process_cpu_ticks) *
+                         100.0 / (elapsed_ticks * num_cores),
+  };
+}
+
+std::optional<ResidentMemoryInfo> ProfilerMetricsLinux::SampleResidentMemory(
+    const fml::UniqueFD& process_directory,
+    fml::TimePoint now) {
+  std::optional<std::string> statm = ReadProcFile(process_directory, "statm");
+  std::optional<uint64_t> resident_pages =
+      statm ? ParseResidentPages(*statm) : std::nullopt;
+  if (!resident_pages) {
+    return std::nullopt;
+  }
+
+  if (!proportional_set_size_ ||
+      now - last_proportional_set_size_time_ >= kProportionalSetSizeInterval) {
+    last_proportional_set_size_time_ = now;
+    std::optional<std::string> smaps =
+        ReadProcFile(process_directory, "smaps_rollup");
+    std::optional<uint64_t> pss =
+        smaps ? ParseSmapsField(*smaps, "Pss") : std::nullopt;
+    if (pss) {
+      proportional_set_size_ = *pss / kKiloBytesPerMB;
+    }
+  }
+
+  return ResidentMemoryInfo{
+      .resident_set_size = *resident_pages * page_size_ / kBytesPerMB,
+      .proportional_set_size = proportional_set_size_,
+  };
+}
+
+std::optional<uint64_t> ProfilerMetricsLinux::ParseCpuTicks(
+    std::string_view stat) {
+  // The name of the thread is in parentheses and may contain spaces and
+  // parentheses of its own, so the fields are counted from the last one.
+  size_t name_end = stat.rfind(')');
+  if (name_end == std::string_view::npos) {
+    return std::nullopt;
+  }
+  // The fields after the name start at the state, the third field. The user
+  // and system times are the fourteenth and fifteenth fields.
+  std::vector<std::string_view> fields = SplitFields(stat.substr(name_end + 1));
+  if (fields.size() < 13) {
+    return std::nullopt;
+  }
+  std::optional<uint64_t> user_ticks = ParseNumber(fields[11]);
+  std::optional<uint64_t> system_ticks = ParseNumber(fields[12]);
+  if (!user_ticks || !system_ticks) {
+    return std::nullopt;
+  }
+  return *user_ticks + *system_ticks;
+}
+
+std::optional<uint64_t> ProfilerMetricsLinux::ParseResidentPages(
+    std::string_view statm) {
+  // The resident pages are the second field.
+  std::vector<std::string_view> fields = SplitFields(statm);
+  if (fields.size() < 2) {
+    return std::nullopt;
+  }
+  return ParseNumber(fields[1]);
+}
+
+std::optional<uint64_t> ProfilerMetricsLinux::ParseSmapsField(
+    std::string_view smaps,
+    std::string_view field) {
+  size_t line_start = 0;
+  while (line_start < smaps.size()) {
+    size_t line_end = smaps.find('\n', line_start);
+    std::string_view line = smaps.substr(line_start, line_end - line_start);
+    if (line.size() > field.size() && line.substr(0, field.size()) == field &&
+        line[field.size()] == ':') {
+      return ParseNumber(line.substr(field.size() + 1));
+    }
+    if (line_end == std::string_view::npos) {
+      break;
+    }
+    line_start = line_end + 1;
+  }
+  return std::nullopt;
+}
+
+}  // namespace flutter
@@ -0,0 +1,119 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PROFILING_PROFILER_METRICS_LINUX_H_
+#define FLUTTER_SHELL_PROFILING_PROFILER_METRICS_LINUX_H_
+
+#include <sys/types.h>
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/unique_fd.h"
+#include "flutter/shell/profiling/sampling_profiler.h"
+
+namespace flutter {
+
+/**
+ * @brief Gathers the profiling metrics used by `flutter::SamplingProfiler` on
+ * Linux from the `/proc` file system.
+ *
+ * The CPU usage of every thread of the process is attributed to the role the
+ * thread plays in the engine. Threads are registered with their role by the
+ * embedder. Unregistered threads of the engine's concurrent message loop are
+ * reported as `worker`, and all other threads as `other`.
+ *
+ * Sampling reads one small file per thread. The proportional set size is read
+ * at most once per second, as the kernel walks every mapping of the process to
+ * compute it.
+ *
+ * @see flutter::SamplingProfiler
+ */
+class ProfilerMetricsLinux {
+ public:
+  /**
+   * @param proc_path the `/proc` directory of the process to sample. Tests
+   * point it at a fake directory.
+   */
+  explicit ProfilerMetricsLinux(std::string proc_path = "/proc/self");
+
+  ~ProfilerMetricsLinux();
+
+  /**
+   * @brief Reports the CPU usage of the calling thread under `role`. This may
+   * be called from any thread.
+   */
+  void RegisterCurrentThread(const std::string& role);
+
+  /**
+   * @brief Reports the CPU usage of the thread `tid` under `role`.
+   */
+  void RegisterThread(pid_t tid, const std::string& role);
+
+  /**
+   * @brief Samples the process. The CPU usage is computed since the previous
+   * sample, so the first sample only holds the memory usage.
+   */
+  ProfileSample GenerateSample();
+
+  /**
+   * @brief The CPU time, in clock ticks, from the contents of a
+   * `/proc/<pid>/stat` or `/proc/<pid>/task/<tid>/stat` file.
+   */
+  static std::optional<uint64_t> ParseCpuTicks(std::string_view stat);
+
+  /**
+   * @brief The resident pages from the contents of a `/proc/<pid>/statm`
+   * file.
+   */
+  static std::optional<uint64_t> ParseResidentPages(std::string_view statm);
+
+  /**
+   * @brief The value, in kB, of `field` from the contents of a
+   * `/proc/<pid>/smaps_rollup` file.
+   */
+  static std::optional<uint64_t> ParseSmapsField(std::string_view smaps,
+                                                 std::string_view field);
+
+ private:
+  struct ThreadState {
+    std::string role;
+    uint64_t cpu_ticks = 0;
+  };
+
+  const std::string proc_path_;
+  const double clock_ticks_per_second_;
+  const size_t page_size_;
+
+  std::mutex registered_roles_mutex_;
+  std::unordered_map<pid_t, std::string> registered_roles_;
+
+  // Only accessed by |GenerateSample|.
+  std::unordered_map<pid_t, ThreadState> threads_;
+  std::optional<uint64_t> process_cpu_ticks_;
+  fml::TimePoint last_sample_time_;
+  std::optional<double> proportional_set_size_;
+  fml::TimePoint last_proportional_set_size_time_;
+
+  std::optional<CpuUsageInfo> SampleCpuUsage(
+      const fml::UniqueFD& process_directory,
+      fml::TimePoint now,
+      std::map<std::string, double>& cpu_usage_by_role);
+
+  std::optional<ResidentMemoryInfo> SampleResidentMemory(
+      const fml::UniqueFD& process_directory,
+      fml::TimePoint now);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ProfilerMetricsLinux);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PROFILING_PROFILER_METRICS_LINUX_H_
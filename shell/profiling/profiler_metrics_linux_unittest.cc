@@ -0,0 +1,119 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/profiling/profiler_metrics_linux.h"
+
+#include <string>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::string MakeStat(const std::string& name,
+                     uint64_t user_ticks,
+                     uint64_t system_ticks) {
+  return "42 (" + name + ") S 1 42 42 0 -1 4194560 100 0 0 0 " +
+         std::to_string(user_ticks) + " " + std::to_string(system_ticks) +
+         " 0 0 20 0 3 0 1000 1000000 250 18446744073709551615 0 0 0 0 0 0 0 "
+         "0 0 0 0 0 17 3 0 0 0 0 0\n";
+}
+
+void WriteFile(const fml::UniqueFD& directory,
+               const std::string& path,
+               const std::string& contents) {
+  ASSERT_TRUE(fml::WriteAtomically(directory, path.c_str(),
+                                   fml::DataMapping(contents)));
+}
+
+// Creates the files of a thread of a fake `/proc/self`.
+void WriteThread(const fml::UniqueFD& directory,
+                 const std::string& tid,
+                 const std::string& name,
+                 uint64_t ticks) {
+  fml::CreateDirectory(directory, {"task", tid},
+                       fml::FilePermission::kReadWrite);
+  WriteFile(directory, "task/" + tid + "/stat", MakeStat(name, ticks, 0));
+  WriteFile(directory, "task/" + tid + "/comm", name + "\n");
+}
+
+}  // namespace
+
+TEST(ProfilerMetricsLinuxTest, ParsesCpuTicks) {
+  EXPECT_EQ(ProfilerMetricsLinux::ParseCpuTicks(MakeStat("io.flutter", 7, 5)),
+            12u);
+  // Thread names may contain spaces and parentheses.
+  EXPECT_EQ(ProfilerMetricsLinux::ParseCpuTicks(MakeStat("a) (b c", 7, 5)),
+            12u);
+  EXPECT_FALSE(ProfilerMetricsLinux::ParseCpuTicks("42 (ui) S 1 42"));
+  EXPECT_FALSE(ProfilerMetricsLinux::ParseCpuTicks(""));
+}
+
+TEST(ProfilerMetricsLinuxTest, ParsesMemoryFiles) {
+  EXPECT_EQ(
+      ProfilerMetricsLinux::ParseResidentPages("92416 6251 4132 1 0 10893 0\n"),
+      6251u);
+  EXPECT_FALSE(ProfilerMetricsLinux::ParseResidentPages("92416"));
+
+  const std::string smaps =
+      "55d0cb3c1000-7ffd2f5f9000 ---p 00000000 00:00 0  [rollup]\n"
+      "Rss:               25004 kB\n"
+      "Pss:               20522 kB\n"
+      "Pss_Anon:          13092 kB\n";
+  EXPECT_EQ(ProfilerMetricsLinux::ParseSmapsField(smaps, "Pss"), 20522u);
+  EXPECT_EQ(ProfilerMetricsLinux::ParseSmapsField(smaps, "Pss_Anon"), 13092u);
+  EXPECT_FALSE(ProfilerMetricsLinux::ParseSmapsField(smaps, "Swap"));
+}
+
+TEST(ProfilerMetricsLinuxTest, ReportsCpuUsageByThreadRole) {
+  fml::ScopedTemporaryDirectory proc;
+  WriteFile(proc.fd(), "stat", MakeStat("flutter_tester", 100, 0));
+  WriteFile(proc.fd(), "statm", "92416 512 128 1 0 10893 0\n");
+  WriteFile(proc.fd(), "smaps_rollup", "Rss: 2048 kB\nPss: 1024 kB\n");
+  WriteThread(proc.fd(), "10", "io.flutter.ui", 10);
+  WriteThread(proc.fd(), "11", "io.worker.1", 20);
+  WriteThread(proc.fd(), "12", "io.worker.2", 30);
+  WriteThread(proc.fd(), "13", "gmain", 40);
+
+  ProfilerMetricsLinux metrics(proc.path());
+  metrics.RegisterThread(10, "ui");
+
+  ProfileSample first = metrics.GenerateSample();
+  EXPECT_FALSE(first.cpu_usage);
+  EXPECT_TRUE(first.thread_cpu_usage.empty());
+  ASSERT_TRUE(first.resident_memory);
+  EXPECT_DOUBLE_EQ(first.resident_memory->resident_set_size,
+                   512.0 * sysconf(_SC_PAGESIZE) / (1024 * 1024));
+  EXPECT_EQ(first.resident_memory->proportional_set_size, 1.0);
+
+  WriteFile(proc.fd(), "stat", MakeStat("flutter_tester", 200, 0));
+  WriteThread(proc.fd(), "10", "io.flutter.ui", 20);
+  WriteThread(proc.fd(), "11", "io.worker.1", 20);
+  WriteThread(proc.fd(), "12", "io.worker.2", 31);
+  WriteThread(proc.fd(), "13", "gmain", 40);
+  // The proportional set size is only read again after a second.
+  WriteFile(proc.fd(), "smaps_rollup", "Rss: 2048 kB\nPss: 2048 kB\n");
+
+  ProfileSample second = metrics.GenerateSample();
+  ASSERT_TRUE(second.cpu_usage);
+  EXPECT_EQ(second.cpu_usage->num_threads, 4u);
+  EXPECT_GT(second.cpu_usage->total_cpu_usage, 0);
+  ASSERT_EQ(second.thread_cpu_usage.size(), 3u);
+  EXPECT_EQ(second.thread_cpu_usage[0].role, "other");
+  EXPECT_EQ(second.thread_cpu_usage[0].cpu_usage, 0);
+  EXPECT_EQ(second.thread_cpu_usage[1].role, "ui");
+  EXPECT_EQ(second.thread_cpu_usage[2].role, "worker");
+  // The UI thread used ten ticks and the workers one.
+  EXPECT_DOUBLE_EQ(second.thread_cpu_usage[1].cpu_usage,
+                   10 * second.thread_cpu_usage[2].cpu_usage);
+  ASSERT_TRUE(second.resident_memory);
+  EXPECT_EQ(second.resident_memory->proportional_set_size, 1.0);
+}
+
+}  // namespace testing
+}  // namespace flutter
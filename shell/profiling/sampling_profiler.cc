@@ -77,6 +77,24 @@ void SamplingProfiler::SampleRepeatedly(fml::TimeDelta task_delay) const {
           TRACE_EVENT_INSTANT1("flutter::profiling", "GpuUsage", "gpu_usage",
                                gpu_usage.c_str());
         }
+        // Unlike the events above, these are counters so that the timeline
+        // plots them. Every role gets a counter of its own.
+        for (const auto& thread_cpu_usage : usage.thread_cpu_usage) {
+          const std::string name = "ThreadCpuUsage." + thread_cpu_usage.role;
+          FML_TRACE_COUNTER("flutter::profiling", name.c_str(), 0,
+                            "cpu_usage", thread_cpu_usage.cpu_usage);
+        }
+        if (usage.resident_memory) {
+          const auto& resident_memory = usage.resident_memory;
+          FML_TRACE_COUNTER("flutter::profiling", "ResidentSetSize", 0,
+                            "resident_set_size",
+                            resident_memory->resident_set_size);
+          if (resident_memory->proportional_set_size) {
+            FML_TRACE_COUNTER("flutter::profiling", "ProportionalSetSize", 0,
+                              "proportional_set_size",
+                              *resident_memory->proportional_set_size);
+          }
+        }
         if (shutdown_latch.load()) {
           shutdown_latch.load()->Signal();
         } else {
@@ -9,6 +9,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/task_runner.h"
@@ -43,6 +44,27 @@ struct MemoryUsageInfo {
   double owned_shared_memory_usage;
 };
 
+/**
+ * @brief CPU usage of the threads that play a `role` in the engine, such as
+ * `ui` or `raster`. `cpu_usage` is the percentage of a single core used by
+ * these threads, so it exceeds `100` when several busy threads share a role.
+ */
+struct ThreadCpuUsageInfo {
+  std::string role;
+  double cpu_usage;
+};
+
+/**
+ * @brief Resident memory stats. `resident_set_size` is the physical memory
+ * (in MB) mapped into the process, including the pages it shares with other
+ * processes. `proportional_set_size` is the physical memory (in MB) of the
+ * process when every shared page is divided among the processes sharing it.
+ */
+struct ResidentMemoryInfo {
+  double resident_set_size;
+  std::optional<double> proportional_set_size;
+};
+
 /**
  * @brief Polled information related to the usage of the GPU.
  */
@@ -61,6 +83,8 @@ struct ProfileSample {
   std::optional<CpuUsageInfo> cpu_usage;
   std::optional<MemoryUsageInfo> memory_usage;
   std::optional<GpuUsageInfo> gpu_usage;
+  std::vector<ThreadCpuUsageInfo> thread_cpu_usage;
+  std::optional<ResidentMemoryInfo> resident_memory;
 };
 
 /**
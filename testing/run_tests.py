@@ -339,6 +339,7 @@ def RunCCTests(build_dir, filter, coverage, capture_core_dump):
       make_test('embedder_unittests'),
       make_test('fml_unittests', flags=[fml_unittests_filter] + repeat_flags),
       make_test('no_dart_plugin_registrant_unittests'),
+      make_test('path_ops_unittests'),
       make_test('runtime_unittests'),
       make_test('testing_unittests'),
       make_test('tonic_unittests'),
@@ -438,6 +439,8 @@ def RunEngineBenchmarks(build_dir, filter):
 
   RunEngineExecutable(build_dir, 'fml_benchmarks', filter, icu_flags)
 
+  RunEngineExecutable(build_dir, 'flow_benchmarks', filter, icu_flags)
+
   RunEngineExecutable(build_dir, 'ui_benchmarks', filter, icu_flags)
 
   if IsLinux():
@@ -40,6 +40,9 @@ class ParagraphFixture : public benchmark::Fixture {
  public:
   void SetUp(const benchmark::State& state) {
     font_collection_ = GetTestFontCollection();
+    // Measure the layouts themselves rather than the restores of layouts
+    // from the cache.
+    font_collection_->GetParagraphLayoutCache().SetMaxBytes(0);
 
     bitmap_ = std::make_unique<SkBitmap>();
     bitmap_->allocN32Pixels(1000, 1000);
@@ -245,6 +248,42 @@ BENCHMARK_REGISTER_F(ParagraphFixture, StylesBigO)
     ->Range(1 << 3, 1 << 12)
     ->Complexity(benchmark::oN);
 
+static void RebuildParagraph(benchmark::State& state,
+                             const std::shared_ptr<FontCollection>& fonts) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are nessecary.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+  // Rebuilt widgets build new paragraphs with the same text and styles.
+  while (state.KeepRunning()) {
+    txt::ParagraphBuilderTxt builder(paragraph_style, fonts);
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    auto paragraph = builder.Build();
+    paragraph->Layout(300);
+  }
+}
+
+BENCHMARK_F(ParagraphFixture, RebuildLayout)(benchmark::State& state) {
+  RebuildParagraph(state, font_collection_);
+}
+
+BENCHMARK_F(ParagraphFixture, CachedRebuildLayout)(benchmark::State& state) {
+  font_collection_->GetParagraphLayoutCache().SetMaxBytes(
+      ParagraphLayoutCache::kDefaultMaxBytes);
+  RebuildParagraph(state, font_collection_);
+}
+
 BENCHMARK_F(ParagraphFixture, PaintSimple)(benchmark::State& state) {
   const char* text = "Hello world! This is a simple sentence to test drawing.";
   auto icu_text = icu::UnicodeString::fromUTF8(text);
@@ -81,7 +81,9 @@ class TxtFallbackFontProvider
   std::weak_ptr<FontCollection> font_collection_;
 };
 
-FontCollection::FontCollection() : enable_font_fallback_(true) {}
+FontCollection::FontCollection()
+    : enable_font_fallback_(true),
+      paragraph_layout_cache_(std::make_unique<ParagraphLayoutCache>()) {}
 
 FontCollection::~FontCollection() {
   minikin::Layout::purgeCaches();
@@ -100,10 +102,12 @@ size_t FontCollection::GetFontManagersCount() const {
 void FontCollection::SetupDefaultFontManager(
     uint32_t font_initialization_data) {
   default_font_manager_ = GetDefaultFontManager(font_initialization_data);
+  OnFontsChanged();
 }
 
 void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
   default_font_manager_ = font_manager;
+  OnFontsChanged();
 
 #if FLUTTER_ENABLE_SKSHAPER
   skt_collection_.reset();
@@ -112,6 +116,7 @@ void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
 
 void FontCollection::SetAssetFontManager(sk_sp<SkFontMgr> font_manager) {
   asset_font_manager_ = font_manager;
+  OnFontsChanged();
 
 #if FLUTTER_ENABLE_SKSHAPER
   skt_collection_.reset();
@@ -120,6 +125,7 @@ void FontCollection::SetAssetFontManager(sk_sp<SkFontMgr> font_manager) {
 
 void FontCollection::SetDynamicFontManager(sk_sp<SkFontMgr> font_manager) {
   dynamic_font_manager_ = font_manager;
+  OnFontsChanged();
 
 #if FLUTTER_ENABLE_SKSHAPER
   skt_collection_.reset();
@@ -128,6 +134,7 @@ void FontCollection::SetDynamicFontManager(sk_sp<SkFontMgr> font_manager) {
 
 void FontCollection::SetTestFontManager(sk_sp<SkFontMgr> font_manager) {
   test_font_manager_ = font_manager;
+  OnFontsChanged();
 
 #if FLUTTER_ENABLE_SKSHAPER
   skt_collection_.reset();
@@ -150,6 +157,7 @@ std::vector<sk_sp<SkFontMgr>> FontCollection::GetFontManagerOrder() const {
 
 void FontCollection::DisableFontFallback() {
   enable_font_fallback_ = false;
+  OnFontsChanged();
 
 #if FLUTTER_ENABLE_SKSHAPER
   if (skt_collection_) {
@@ -383,6 +391,7 @@ FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
 
 void FontCollection::ClearFontFamilyCache() {
   font_collections_cache_.clear();
+  OnFontsChanged();
 
 #if FLUTTER_ENABLE_SKSHAPER
   if (skt_collection_) {
@@ -391,6 +400,11 @@ void FontCollection::ClearFontFamilyCache() {
 #endif
 }
 
+void FontCollection::OnFontsChanged() {
+  generation_++;
+  paragraph_layout_cache_->Clear();
+}
+
 #if FLUTTER_ENABLE_SKSHAPER
 
 sk_sp<skia::textlayout::FontCollection>
@@ -29,6 +29,7 @@
 #include "third_party/skia/include/core/SkFontMgr.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
 #include "txt/asset_font_manager.h"
+#include "txt/paragraph_layout_cache.h"
 #include "txt/text_style.h"
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -68,6 +69,15 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   // Remove all entries in the font family cache.
   void ClearFontFamilyCache();
 
+  // Incremented whenever the fonts that this collection resolves may have
+  // changed, which invalidates any layout made with the earlier fonts.
+  uint64_t GetGeneration() const { return generation_; }
+
+  // The layouts of paragraphs that use this collection.
+  ParagraphLayoutCache& GetParagraphLayoutCache() {
+    return *paragraph_layout_cache_;
+  }
+
 #if FLUTTER_ENABLE_SKSHAPER
 
   // Construct a Skia text layout FontCollection based on this collection.
@@ -107,6 +117,8 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   std::unordered_map<std::string, std::vector<std::string>>
       fallback_fonts_for_locale_;
   bool enable_font_fallback_;
+  uint64_t generation_ = 0;
+  std::unique_ptr<ParagraphLayoutCache> paragraph_layout_cache_;
 
 #if FLUTTER_ENABLE_SKSHAPER
   // An equivalent font collection usable by the Skia text shaper library.
@@ -133,6 +145,9 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   FRIEND_TEST(FontCollectionTest, CheckSkTypefacesSorting);
   static void SortSkTypefaces(std::vector<sk_sp<SkTypeface>>& sk_typefaces);
 
+  // Invalidates the layouts made with the current fonts.
+  void OnFontsChanged();
+
   const std::shared_ptr<minikin::FontFamily>& GetFallbackFontFamily(
       const sk_sp<SkFontMgr>& manager,
       const std::string& family_name);
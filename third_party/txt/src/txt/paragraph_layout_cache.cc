@@ -0,0 +1,133 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "paragraph_layout_cache.h"
+
+#include "flutter/fml/trace_event.h"
+
+namespace txt {
+
+ParagraphLayoutCache::Entry::~Entry() = default;
+
+ParagraphLayoutCache::ParagraphLayoutCache(size_t max_bytes)
+    : max_bytes_(max_bytes),
+      registration_(fml::MemoryGovernor::GetInstance().Register(
+          "ParagraphLayoutCache",
+          fml::MemoryGovernor::Priority::kLow,
+          [this](size_t target_bytes) { Trim(target_bytes); })) {}
+
+ParagraphLayoutCache::~ParagraphLayoutCache() = default;
+
+std::shared_ptr<const ParagraphLayoutCache::Entry> ParagraphLayoutCache::Lookup(
+    size_t hash,
+    const std::function<bool(const Entry&)>& matches) {
+  std::scoped_lock lock(mutex_);
+  auto range = index_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (matches(*it->second->entry)) {
+      // Move the node to the front without invalidating its iterator.
+      lru_.splice(lru_.begin(), lru_, it->second);
+      stats_.hits++;
+      TraceStatsLocked();
+      return it->second->entry;
+    }
+  }
+  stats_.misses++;
+  TraceStatsLocked();
+  return nullptr;
+}
+
+void ParagraphLayoutCache::Insert(size_t hash,
+                                  std::shared_ptr<const Entry> entry) {
+  if (!entry) {
+    return;
+  }
+  const size_t bytes = entry->GetByteSize();
+  {
+    std::scoped_lock lock(mutex_);
+    if (bytes > max_bytes_) {
+      return;
+    }
+    lru_.push_front({hash, bytes, std::move(entry)});
+    index_.emplace(hash, lru_.begin());
+    stats_.entries++;
+    stats_.bytes += bytes;
+    EvictLocked(max_bytes_);
+    TraceStatsLocked();
+  }
+  ReportBytes();
+}
+
+void ParagraphLayoutCache::Clear() {
+  {
+    std::scoped_lock lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    stats_.entries = 0;
+    stats_.bytes = 0;
+    TraceStatsLocked();
+  }
+  ReportBytes();
+}
+
+void ParagraphLayoutCache::SetMaxBytes(size_t max_bytes) {
+  {
+    std::scoped_lock lock(mutex_);
+    max_bytes_ = max_bytes;
+    EvictLocked(max_bytes_);
+    TraceStatsLocked();
+  }
+  ReportBytes();
+}
+
+void ParagraphLayoutCache::Trim(size_t target_bytes) {
+  {
+    std::scoped_lock lock(mutex_);
+    EvictLocked(target_bytes);
+    TraceStatsLocked();
+  }
+  ReportBytes();
+}
+
+ParagraphLayoutCache::Stats ParagraphLayoutCache::GetStats() const {
+  std::scoped_lock lock(mutex_);
+  return stats_;
+}
+
+void ParagraphLayoutCache::EvictLocked(size_t max_bytes) {
+  while (stats_.bytes > max_bytes && !lru_.empty()) {
+    auto last = std::prev(lru_.end());
+    auto range = index_.equal_range(last->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == last) {
+        index_.erase(it);
+        break;
+      }
+    }
+    stats_.entries--;
+    stats_.bytes -= last->bytes;
+    lru_.erase(last);
+  }
+}
+
+void ParagraphLayoutCache::ReportBytes() {
+  size_t bytes;
+  {
+    std::scoped_lock lock(mutex_);
+    bytes = stats_.bytes;
+  }
+  registration_->ReportBytes(bytes);
+}
+
+void ParagraphLayoutCache::TraceStatsLocked() const {
+  FML_TRACE_COUNTER("flutter",                                     //
+                    "ParagraphLayoutCache",                        //
+                    reinterpret_cast<int64_t>(this),               //
+                    "Hits", stats_.hits,                           //
+                    "Misses", stats_.misses,                       //
+                    "Entries", stats_.entries,                     //
+                    "KBytes", stats_.bytes / 1024);
+}
+
+}  // namespace txt
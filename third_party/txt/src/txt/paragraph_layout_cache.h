@@ -0,0 +1,96 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LIB_TXT_SRC_PARAGRAPH_LAYOUT_CACHE_H_
+#define LIB_TXT_SRC_PARAGRAPH_LAYOUT_CACHE_H_
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/memory_governor.h"
+
+namespace txt {
+
+// Holds the results of paragraph layouts so that paragraphs with the same
+// text, styles and width are not laid out again when they are rebuilt. The
+// entries are immutable and may be shared by any number of paragraphs. The
+// least recently used entries are evicted once their total size exceeds the
+// byte budget, or when the memory governor asks the cache to trim itself.
+class ParagraphLayoutCache {
+ public:
+  class Entry {
+   public:
+    virtual ~Entry();
+
+    // The approximate number of bytes retained by this entry.
+    virtual size_t GetByteSize() const = 0;
+  };
+
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+  };
+
+  static constexpr size_t kDefaultMaxBytes = 4 * 1024 * 1024;
+
+  explicit ParagraphLayoutCache(size_t max_bytes = kDefaultMaxBytes);
+
+  ~ParagraphLayoutCache();
+
+  // Returns the entry with the given hash for which |matches| returns true, or
+  // nullptr if there is none. The entry becomes the most recently used one.
+  std::shared_ptr<const Entry> Lookup(
+      size_t hash,
+      const std::function<bool(const Entry&)>& matches);
+
+  // Adds |entry| as the most recently used entry and evicts entries until the
+  // cache fits into its byte budget again. Entries that are larger than the
+  // whole budget are not retained.
+  void Insert(size_t hash, std::shared_ptr<const Entry> entry);
+
+  void Clear();
+
+  void SetMaxBytes(size_t max_bytes);
+
+  // Evicts the least recently used entries until the cache retains at most
+  // |target_bytes|, without changing its byte budget.
+  void Trim(size_t target_bytes);
+
+  Stats GetStats() const;
+
+ private:
+  struct Node {
+    size_t hash;
+    size_t bytes;
+    std::shared_ptr<const Entry> entry;
+  };
+
+  mutable std::mutex mutex_;
+  size_t max_bytes_;
+  // Ordered from the most to the least recently used entry.
+  std::list<Node> lru_;
+  std::unordered_multimap<size_t, std::list<Node>::iterator> index_;
+  Stats stats_;
+  std::unique_ptr<fml::MemoryGovernor::Registration> registration_;
+
+  void EvictLocked(size_t max_bytes);
+
+  // Reports the size of the cache to the memory governor. Must be called
+  // without holding the mutex, which trimming acquires.
+  void ReportBytes();
+
+  void TraceStatsLocked() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ParagraphLayoutCache);
+};
+
+}  // namespace txt
+
+#endif  // LIB_TXT_SRC_PARAGRAPH_LAYOUT_CACHE_H_
@@ -24,9 +24,11 @@
 #include <limits>
 #include <map>
 #include <numeric>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/logging.h"
 #include "font_collection.h"
 #include "font_skia.h"
@@ -648,6 +650,343 @@ void ParagraphTxt::ComputePlaceholder(PlaceholderRun* placeholder_run,
   }
 }
 
+namespace {
+
+// TextStyle::equals ignores some of the properties that affect the layout and
+// the painting of the text.
+bool SameTextStyle(const TextStyle& a, const TextStyle& b) {
+  return a.equals(b) && a.font_size == b.font_size &&
+         a.text_baseline == b.text_baseline &&
+         a.has_background == b.has_background &&
+         a.background == b.background &&
+         a.has_foreground == b.has_foreground &&
+         a.font_features.GetFontFeatures() ==
+             b.font_features.GetFontFeatures() &&
+         a.font_variations.GetAxisValues() ==
+             b.font_variations.GetAxisValues();
+}
+
+bool SameParagraphStyle(const ParagraphStyle& a, const ParagraphStyle& b) {
+  return a.font_weight == b.font_weight && a.font_style == b.font_style &&
+         a.font_family == b.font_family && a.font_size == b.font_size &&
+         a.height == b.height &&
+         a.has_height_override == b.has_height_override &&
+         a.text_height_behavior == b.text_height_behavior &&
+         a.strut_enabled == b.strut_enabled &&
+         a.strut_font_weight == b.strut_font_weight &&
+         a.strut_font_style == b.strut_font_style &&
+         a.strut_font_families == b.strut_font_families &&
+         a.strut_font_size == b.strut_font_size &&
+         a.strut_height == b.strut_height &&
+         a.strut_has_height_override == b.strut_has_height_override &&
+         a.strut_half_leading == b.strut_half_leading &&
+         a.strut_leading == b.strut_leading &&
+         a.force_strut_height == b.force_strut_height &&
+         a.text_align == b.text_align &&
+         a.text_direction == b.text_direction &&
+         a.max_lines == b.max_lines && a.ellipsis == b.ellipsis &&
+         a.locale == b.locale && a.break_strategy == b.break_strategy;
+}
+
+bool SamePlaceholderRun(const PlaceholderRun& a, const PlaceholderRun& b) {
+  return a.width == b.width && a.height == b.height &&
+         a.alignment == b.alignment && a.baseline == b.baseline &&
+         a.baseline_offset == b.baseline_offset;
+}
+
+}  // namespace
+
+struct ParagraphTxt::CachedLayout : public ParagraphLayoutCache::Entry {
+  struct RunKey {
+    size_t style_index;
+    size_t start;
+    size_t end;
+  };
+
+  // Maps the styles and placeholders that the results of a layout refer to
+  // onto the ones at the same indexes in another paragraph.
+  struct Rebase {
+    const std::vector<TextStyle>& from_styles;
+    const std::vector<TextStyle>& to_styles;
+    const std::vector<PlaceholderRun>& from_placeholders;
+    std::vector<PlaceholderRun>& to_placeholders;
+
+    const TextStyle* Style(const TextStyle* style) const {
+      if (style == nullptr) {
+        return nullptr;
+      }
+      const size_t index = style - from_styles.data();
+      FML_DCHECK(index < from_styles.size());
+      return &to_styles[index];
+    }
+
+    PlaceholderRun* Placeholder(const PlaceholderRun* placeholder) const {
+      if (placeholder == nullptr) {
+        return nullptr;
+      }
+      const size_t index = placeholder - from_placeholders.data();
+      FML_DCHECK(index < from_placeholders.size());
+      return &to_placeholders[index];
+    }
+  };
+
+  // The inputs of the layout.
+  uint64_t font_generation = 0;
+  double width = 0;
+  std::vector<uint16_t> text;
+  std::vector<TextStyle> styles;
+  std::vector<RunKey> runs;
+  ParagraphStyle paragraph_style;
+  std::vector<PlaceholderRun> placeholders;
+  std::unordered_set<size_t> obj_replacement_char_indexes;
+
+  // The results of the layout, which refer to |styles| and
+  // |laid_out_placeholders|. The text blobs of the records are shared with
+  // every paragraph that the layout is restored into.
+  std::vector<PlaceholderRun> laid_out_placeholders;
+  std::vector<LineMetrics> line_metrics;
+  size_t final_line_count = 0;
+  std::vector<double> line_widths;
+  std::vector<PaintRecord> records;
+  bool did_exceed_max_lines = false;
+  StrutMetrics strut;
+  double max_right = 0;
+  double min_left = 0;
+  std::vector<GlyphLine> glyph_lines;
+  std::vector<CodeUnitRun> code_unit_runs;
+  std::vector<CodeUnitRun> inline_placeholder_code_unit_runs;
+  double longest_line = 0;
+  double max_intrinsic_width = 0;
+  double min_intrinsic_width = 0;
+  double alphabetic_baseline = 0;
+  double ideographic_baseline = 0;
+
+  size_t byte_size = 0;
+
+  size_t GetByteSize() const override { return byte_size; }
+
+  size_t ComputeByteSize() const {
+    size_t size = sizeof(CachedLayout);
+    size += text.size() * sizeof(uint16_t);
+    size += styles.size() * sizeof(TextStyle);
+    size += runs.size() * sizeof(RunKey);
+    size += (placeholders.size() + laid_out_placeholders.size()) *
+            sizeof(PlaceholderRun);
+    size += line_widths.size() * sizeof(double);
+    for (const LineMetrics& line : line_metrics) {
+      size += sizeof(LineMetrics) +
+              line.run_metrics.size() * sizeof(std::pair<size_t, RunMetrics>);
+    }
+    size_t glyph_count = 0;
+    for (const GlyphLine& line : glyph_lines) {
+      glyph_count += line.positions.size();
+      size += sizeof(GlyphLine);
+    }
+    for (const auto* run_list :
+         {&code_unit_runs, &inline_placeholder_code_unit_runs}) {
+      for (const CodeUnitRun& run : *run_list) {
+        size += sizeof(CodeUnitRun) +
+                run.positions.size() * sizeof(GlyphPosition);
+      }
+    }
+    // Every laid out glyph is positioned by the glyph lines and drawn from a
+    // text blob.
+    size += glyph_count * (sizeof(GlyphPosition) + sizeof(SkGlyphID) +
+                           sizeof(SkPoint));
+    size += records.size() * sizeof(PaintRecord);
+    return size;
+  }
+
+  static std::vector<LineMetrics> CopyLineMetrics(
+      const std::vector<LineMetrics>& line_metrics,
+      const Rebase& rebase) {
+    std::vector<LineMetrics> result = line_metrics;
+    for (LineMetrics& line : result) {
+      for (auto& run_metrics : line.run_metrics) {
+        run_metrics.second.text_style =
+            rebase.Style(run_metrics.second.text_style);
+      }
+    }
+    return result;
+  }
+
+  static std::vector<PaintRecord> CopyRecords(
+      const std::vector<PaintRecord>& records,
+      const Rebase& rebase) {
+    std::vector<PaintRecord> result;
+    result.reserve(records.size());
+    for (const PaintRecord& record : records) {
+      result.emplace_back(record.style(), record.offset(),
+                          sk_ref_sp(record.text()), record.metrics(),
+                          record.line(), record.x_start(), record.x_end(),
+                          record.isGhost(),
+                          rebase.Placeholder(record.GetPlaceholderRun()));
+    }
+    return result;
+  }
+
+  static std::vector<CodeUnitRun> CopyCodeUnitRuns(
+      const std::vector<CodeUnitRun>& code_unit_runs,
+      const Rebase& rebase) {
+    std::vector<CodeUnitRun> result = code_unit_runs;
+    for (CodeUnitRun& run : result) {
+      run.style = rebase.Style(run.style);
+      run.placeholder_run = rebase.Placeholder(run.placeholder_run);
+    }
+    return result;
+  }
+};
+
+size_t ParagraphTxt::ComputeLayoutHash() const {
+  const std::u16string_view text(
+      reinterpret_cast<const char16_t*>(text_.data()), text_.size());
+  size_t hash = fml::HashCombine(
+      std::hash<std::u16string_view>()(text), runs_.size(),
+      inline_placeholders_.size(), width_, paragraph_style_.max_lines,
+      font_collection_->GetGeneration());
+  for (const TextStyle& style : runs_.GetStyles()) {
+    fml::HashCombineSeed(hash, style.font_size);
+  }
+  return hash;
+}
+
+bool ParagraphTxt::MatchesCachedLayout(const CachedLayout& layout) const {
+  const std::vector<TextStyle>& styles = runs_.GetStyles();
+  if (layout.font_generation != font_collection_->GetGeneration() ||
+      layout.width != width_ || layout.text != text_ ||
+      layout.runs.size() != runs_.size() ||
+      layout.styles.size() != styles.size() ||
+      layout.placeholders.size() != inline_placeholders_.size() ||
+      layout.obj_replacement_char_indexes != obj_replacement_char_indexes_) {
+    return false;
+  }
+  for (size_t i = 0; i < runs_.size(); ++i) {
+    const StyledRuns::Run run = runs_.GetRun(i);
+    const CachedLayout::RunKey& key = layout.runs[i];
+    if (key.start != run.start || key.end != run.end ||
+        &styles[key.style_index] != &run.style) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < styles.size(); ++i) {
+    if (!SameTextStyle(layout.styles[i], styles[i])) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < inline_placeholders_.size(); ++i) {
+    if (!SamePlaceholderRun(layout.placeholders[i], inline_placeholders_[i])) {
+      return false;
+    }
+  }
+  return SameParagraphStyle(layout.paragraph_style, paragraph_style_);
+}
+
+std::shared_ptr<ParagraphTxt::CachedLayout> ParagraphTxt::MakeCachedLayout(
+    std::vector<PlaceholderRun> placeholders) const {
+  auto layout = std::make_shared<CachedLayout>();
+  const std::vector<TextStyle>& styles = runs_.GetStyles();
+  layout->font_generation = font_collection_->GetGeneration();
+  layout->width = width_;
+  layout->text = text_;
+  layout->styles = styles;
+  layout->runs.reserve(runs_.size());
+  for (size_t i = 0; i < runs_.size(); ++i) {
+    const StyledRuns::Run run = runs_.GetRun(i);
+    layout->runs.push_back({static_cast<size_t>(&run.style - styles.data()),
+                            run.start, run.end});
+  }
+  layout->paragraph_style = paragraph_style_;
+  layout->placeholders = std::move(placeholders);
+  layout->obj_replacement_char_indexes = obj_replacement_char_indexes_;
+
+  layout->laid_out_placeholders = inline_placeholders_;
+  const CachedLayout::Rebase rebase{styles, layout->styles,
+                                    inline_placeholders_,
+                                    layout->laid_out_placeholders};
+  layout->line_metrics = CachedLayout::CopyLineMetrics(line_metrics_, rebase);
+  layout->final_line_count = final_line_count_;
+  layout->line_widths = line_widths_;
+  layout->records = CachedLayout::CopyRecords(records_, rebase);
+  layout->did_exceed_max_lines = did_exceed_max_lines_;
+  layout->strut = strut_;
+  layout->max_right = max_right_;
+  layout->min_left = min_left_;
+  layout->glyph_lines = glyph_lines_;
+  layout->code_unit_runs =
+      CachedLayout::CopyCodeUnitRuns(code_unit_runs_, rebase);
+  layout->inline_placeholder_code_unit_runs =
+      CachedLayout::CopyCodeUnitRuns(inline_placeholder_code_unit_runs_,
+                                     rebase);
+  layout->longest_line = longest_line_;
+  layout->max_intrinsic_width = max_intrinsic_width_;
+  layout->min_intrinsic_width = min_intrinsic_width_;
+  layout->alphabetic_baseline = alphabetic_baseline_;
+  layout->ideographic_baseline = ideographic_baseline_;
+  layout->byte_size = layout->ComputeByteSize();
+  return layout;
+}
+
+void ParagraphTxt::RestoreLayout(const CachedLayout& layout) {
+  inline_placeholders_ = layout.laid_out_placeholders;
+  const CachedLayout::Rebase rebase{layout.styles, runs_.GetStyles(),
+                                    layout.laid_out_placeholders,
+                                    inline_placeholders_};
+  line_metrics_ = CachedLayout::CopyLineMetrics(layout.line_metrics, rebase);
+  final_line_count_ = layout.final_line_count;
+  line_widths_ = layout.line_widths;
+  records_ = CachedLayout::CopyRecords(layout.records, rebase);
+  did_exceed_max_lines_ = layout.did_exceed_max_lines;
+  strut_ = layout.strut;
+  max_right_ = layout.max_right;
+  min_left_ = layout.min_left;
+  // GlyphLine can not be assigned.
+  glyph_lines_.clear();
+  glyph_lines_.reserve(layout.glyph_lines.size());
+  for (const GlyphLine& line : layout.glyph_lines) {
+    glyph_lines_.push_back(line);
+  }
+  code_unit_runs_ =
+      CachedLayout::CopyCodeUnitRuns(layout.code_unit_runs, rebase);
+  inline_placeholder_code_unit_runs_ = CachedLayout::CopyCodeUnitRuns(
+      layout.inline_placeholder_code_unit_runs, rebase);
+  longest_line_ = layout.longest_line;
+  max_intrinsic_width_ = layout.max_intrinsic_width;
+  min_intrinsic_width_ = layout.min_intrinsic_width;
+  alphabetic_baseline_ = layout.alphabetic_baseline;
+  ideographic_baseline_ = layout.ideographic_baseline;
+}
+
+void ParagraphTxt::Layout(double width) {
+  double rounded_width = floor(width);
+  // Do not allow calling layout multiple times without changing anything.
+  if (!needs_layout_ && rounded_width == width_) {
+    return;
+  }
+
+  width_ = rounded_width;
+
+  needs_layout_ = false;
+
+  // Widgets that are rebuilt create new paragraphs with the same text and
+  // styles, so their layouts are looked up in the cache first.
+  ParagraphLayoutCache& cache = font_collection_->GetParagraphLayoutCache();
+  const size_t hash = ComputeLayoutHash();
+  std::shared_ptr<const ParagraphLayoutCache::Entry> cached = cache.Lookup(
+      hash, [this](const ParagraphLayoutCache::Entry& entry) {
+        return MatchesCachedLayout(static_cast<const CachedLayout&>(entry));
+      });
+  if (cached) {
+    RestoreLayout(static_cast<const CachedLayout&>(*cached));
+    return;
+  }
+
+  // The layout adjusts the baselines of the placeholders.
+  std::vector<PlaceholderRun> placeholders = inline_placeholders_;
+  if (ComputeLayout()) {
+    cache.Insert(hash, MakeCachedLayout(std::move(placeholders)));
+  }
+}
+
 // Implementation outline:
 //
 // -For each line:
@@ -664,17 +1003,7 @@ void ParagraphTxt::ComputePlaceholder(PlaceholderRun* placeholder_run,
 //   -Apply letter spacing, alignment, justification, etc
 //   -Calculate line vertical layout (ascent, descent, etc)
 //   -Store per-line metrics
-void ParagraphTxt::Layout(double width) {
-  double rounded_width = floor(width);
-  // Do not allow calling layout multiple times without changing anything.
-  if (!needs_layout_ && rounded_width == width_) {
-    return;
-  }
-
-  width_ = rounded_width;
-
-  needs_layout_ = false;
-
+bool ParagraphTxt::ComputeLayout() {
   records_.clear();
   glyph_lines_.clear();
   code_unit_runs_.clear();
@@ -684,11 +1013,11 @@ void ParagraphTxt::Layout(double width) {
   final_line_count_ = 0;
 
   if (!ComputeLineBreaks())
-    return;
+    return false;
 
   std::vector<BidiRun> bidi_runs;
   if (!ComputeBidiRuns(&bidi_runs))
-    return;
+    return false;
 
   SkFont font;
   font.setEdging(SkFont::Edging::kAntiAlias);
@@ -816,7 +1145,7 @@ void ParagraphTxt::Layout(double width) {
       std::shared_ptr<minikin::FontCollection> minikin_font_collection =
           GetMinikinFontCollectionForStyle(run.style());
       if (!minikin_font_collection) {
-        return;
+        return false;
       }
 
       // Lay out this run.
@@ -1187,6 +1516,7 @@ void ParagraphTxt::Layout(double width) {
             });
 
   longest_line_ = max_right_ - min_left_;
+  return true;
 }
 
 void ParagraphTxt::UpdateLineMetrics(const SkFontMetrics& metrics,
@@ -17,6 +17,7 @@
 #ifndef LIB_TXT_SRC_PARAGRAPH_TXT_H_
 #define LIB_TXT_SRC_PARAGRAPH_TXT_H_
 
+#include <memory>
 #include <set>
 #include <utility>
 #include <vector>
@@ -164,6 +165,7 @@ class ParagraphTxt : public Paragraph {
   FRIEND_TEST(ParagraphTest, GetGlyphPositionAtCoordinateSegfault);
   FRIEND_TEST(ParagraphTest, KhmerLineBreaker);
   FRIEND_TEST(ParagraphTest, TextHeightBehaviorRectsParagraph);
+  FRIEND_TEST(ParagraphTest, LayoutCacheSharesLayoutsBetweenParagraphs);
 
   // Starting data to layout.
   std::vector<uint16_t> text_;
@@ -342,6 +344,26 @@ class ParagraphTxt : public Paragraph {
       std::vector<PlaceholderRun> inline_placeholders,
       std::unordered_set<size_t> obj_replacement_char_indexes);
 
+  // The inputs and results of a layout, shared with other paragraphs through
+  // the paragraph layout cache of the font collection.
+  struct CachedLayout;
+
+  // Lays out the paragraph at width_. Returns false if the layout could not
+  // be completed, in which case the results must not be cached.
+  bool ComputeLayout();
+
+  size_t ComputeLayoutHash() const;
+
+  // Whether |layout| was made from the same inputs at the same width.
+  bool MatchesCachedLayout(const CachedLayout& layout) const;
+
+  // Captures the results of the current layout. |placeholders| are the inline
+  // placeholders as they were before the layout adjusted their baselines.
+  std::shared_ptr<CachedLayout> MakeCachedLayout(
+      std::vector<PlaceholderRun> placeholders) const;
+
+  void RestoreLayout(const CachedLayout& layout);
+
   // Break the text into lines.
   bool ComputeLineBreaks();
 
@@ -52,6 +52,8 @@ class StyledRuns {
 
   const TextStyle& GetStyle(size_t style_index) const;
 
+  const std::vector<TextStyle>& GetStyles() const { return styles_; }
+
   void StartRun(size_t style_index, size_t start);
 
   void EndRunIfNeeded(size_t end);
@@ -83,6 +85,7 @@ class StyledRuns {
   FRIEND_TEST(ParagraphTest, SimpleShadow);
   FRIEND_TEST(ParagraphTest, ComplexShadow);
   FRIEND_TEST(ParagraphTest, FontFallbackParagraph);
+  FRIEND_TEST(ParagraphTest, LayoutCacheSharesLayoutsBetweenParagraphs);
 
   struct IndexedRun {
     size_t style_index = 0;
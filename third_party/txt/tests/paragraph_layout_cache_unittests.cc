@@ -0,0 +1,98 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gtest/gtest.h"
+#include "txt/paragraph_layout_cache.h"
+
+namespace txt {
+namespace {
+
+class TestEntry : public ParagraphLayoutCache::Entry {
+ public:
+  TestEntry(int id, size_t bytes) : id_(id), bytes_(bytes) {}
+
+  int id() const { return id_; }
+
+  size_t GetByteSize() const override { return bytes_; }
+
+ private:
+  int id_;
+  size_t bytes_;
+};
+
+std::function<bool(const ParagraphLayoutCache::Entry&)> HasId(int id) {
+  return [id](const ParagraphLayoutCache::Entry& entry) {
+    return static_cast<const TestEntry&>(entry).id() == id;
+  };
+}
+
+}  // namespace
+
+TEST(ParagraphLayoutCacheTest, FindsEntriesWithMatchingKeys) {
+  ParagraphLayoutCache cache;
+  cache.Insert(1, std::make_shared<TestEntry>(10, 100));
+  // Entries with the same hash are told apart by the predicate.
+  cache.Insert(1, std::make_shared<TestEntry>(11, 100));
+
+  auto entry = cache.Lookup(1, HasId(11));
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(static_cast<const TestEntry&>(*entry).id(), 11);
+  EXPECT_NE(cache.Lookup(1, HasId(10)), nullptr);
+  EXPECT_EQ(cache.Lookup(1, HasId(12)), nullptr);
+  EXPECT_EQ(cache.Lookup(2, HasId(10)), nullptr);
+
+  ParagraphLayoutCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 2u);
+  EXPECT_EQ(stats.misses, 2u);
+  EXPECT_EQ(stats.entries, 2u);
+  EXPECT_EQ(stats.bytes, 200u);
+}
+
+TEST(ParagraphLayoutCacheTest, EvictsLeastRecentlyUsedEntriesOverBudget) {
+  ParagraphLayoutCache cache(300);
+  cache.Insert(1, std::make_shared<TestEntry>(1, 100));
+  cache.Insert(2, std::make_shared<TestEntry>(2, 100));
+  cache.Insert(3, std::make_shared<TestEntry>(3, 100));
+  // Makes the first entry the most recently used one.
+  EXPECT_NE(cache.Lookup(1, HasId(1)), nullptr);
+
+  cache.Insert(4, std::make_shared<TestEntry>(4, 100));
+  EXPECT_NE(cache.Lookup(1, HasId(1)), nullptr);
+  EXPECT_EQ(cache.Lookup(2, HasId(2)), nullptr);
+  EXPECT_NE(cache.Lookup(3, HasId(3)), nullptr);
+  EXPECT_NE(cache.Lookup(4, HasId(4)), nullptr);
+  EXPECT_EQ(cache.GetStats().bytes, 300u);
+
+  // Entries that do not fit into the budget on their own are not retained.
+  cache.Insert(5, std::make_shared<TestEntry>(5, 301));
+  EXPECT_EQ(cache.Lookup(5, HasId(5)), nullptr);
+  EXPECT_EQ(cache.GetStats().entries, 3u);
+
+  cache.SetMaxBytes(100);
+  EXPECT_EQ(cache.GetStats().entries, 1u);
+  EXPECT_NE(cache.Lookup(4, HasId(4)), nullptr);
+
+  cache.Clear();
+  EXPECT_EQ(cache.GetStats().entries, 0u);
+  EXPECT_EQ(cache.GetStats().bytes, 0u);
+  EXPECT_EQ(cache.Lookup(4, HasId(4)), nullptr);
+}
+
+TEST(ParagraphLayoutCacheTest, TrimsWhenTheMemoryGovernorAsks) {
+  ParagraphLayoutCache cache(1000);
+  cache.Insert(1, std::make_shared<TestEntry>(1, 100));
+  cache.Insert(2, std::make_shared<TestEntry>(2, 100));
+  cache.Insert(3, std::make_shared<TestEntry>(3, 100));
+
+  fml::MemoryGovernor& governor = fml::MemoryGovernor::GetInstance();
+  governor.NotifyPressure(fml::MemoryGovernor::Pressure::kModerate);
+  EXPECT_EQ(cache.GetStats().entries, 0u);
+
+  // Trimming leaves the byte budget of the cache alone.
+  cache.Insert(4, std::make_shared<TestEntry>(4, 500));
+  cache.Insert(5, std::make_shared<TestEntry>(5, 500));
+  EXPECT_EQ(cache.GetStats().bytes, 1000u);
+}
+
+}  // namespace txt
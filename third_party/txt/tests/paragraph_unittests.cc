@@ -7111,4 +7111,129 @@ TEST_F(ParagraphTest, MixedTextHeightBehaviorRectsParagraph) {
 
   ASSERT_TRUE(Snapshot());
 }
+
+TEST_F(ParagraphTest, LayoutCacheSharesLayoutsBetweenParagraphs) {
+  const char* text = "Cached layouts are restored for identical paragraphs.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  auto font_collection = GetTestFontCollection();
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.font_size = 26;
+  text_style.color = SK_ColorBLACK;
+
+  auto build_paragraph = [&]() {
+    txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  auto paragraph = build_paragraph();
+  paragraph->Layout(200);
+  auto cached_paragraph = build_paragraph();
+  cached_paragraph->Layout(200);
+
+  ParagraphLayoutCache::Stats stats =
+      font_collection->GetParagraphLayoutCache().GetStats();
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.hits, 1u);
+
+  EXPECT_EQ(cached_paragraph->GetLineCount(), paragraph->GetLineCount());
+  EXPECT_EQ(cached_paragraph->GetHeight(), paragraph->GetHeight());
+  EXPECT_EQ(cached_paragraph->GetLongestLine(), paragraph->GetLongestLine());
+  EXPECT_EQ(cached_paragraph->GetMaxIntrinsicWidth(),
+            paragraph->GetMaxIntrinsicWidth());
+  EXPECT_EQ(cached_paragraph->GetAlphabeticBaseline(),
+            paragraph->GetAlphabeticBaseline());
+
+  // The text blobs are shared, and the styles refer to the paragraph that the
+  // layout was restored into.
+  ASSERT_EQ(cached_paragraph->records_.size(), paragraph->records_.size());
+  for (size_t i = 0; i < paragraph->records_.size(); ++i) {
+    EXPECT_EQ(cached_paragraph->records_[i].text(),
+              paragraph->records_[i].text());
+    EXPECT_EQ(cached_paragraph->records_[i].offset(),
+              paragraph->records_[i].offset());
+  }
+  ASSERT_EQ(cached_paragraph->code_unit_runs_.size(),
+            paragraph->code_unit_runs_.size());
+  for (const auto& run : cached_paragraph->code_unit_runs_) {
+    EXPECT_EQ(run.style, &cached_paragraph->runs_.styles_[1]);
+  }
+
+  auto boxes = paragraph->GetRectsForRange(
+      0, u16_text.length(), Paragraph::RectHeightStyle::kMax,
+      Paragraph::RectWidthStyle::kTight);
+  auto cached_boxes = cached_paragraph->GetRectsForRange(
+      0, u16_text.length(), Paragraph::RectHeightStyle::kMax,
+      Paragraph::RectWidthStyle::kTight);
+  ASSERT_EQ(cached_boxes.size(), boxes.size());
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    EXPECT_EQ(cached_boxes[i].rect, boxes[i].rect);
+  }
+
+  paragraph.reset();
+  cached_paragraph->Paint(GetCanvas(), 10.0, 15.0);
+  ASSERT_TRUE(Snapshot());
+}
+
+TEST_F(ParagraphTest, LayoutCacheMissesWhenInputsChange) {
+  const char* text = "Cached layouts depend on the width and the fonts.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  auto font_collection = GetTestFontCollection();
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  auto layout_paragraph = [&](double width) {
+    txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    auto paragraph = BuildParagraph(builder);
+    paragraph->Layout(width);
+    return paragraph->GetLineCount();
+  };
+  auto& cache = font_collection->GetParagraphLayoutCache();
+
+  size_t line_count = layout_paragraph(100);
+  EXPECT_EQ(layout_paragraph(100), line_count);
+  EXPECT_EQ(cache.GetStats().hits, 1u);
+
+  // Widths are rounded down before the lookup.
+  EXPECT_EQ(layout_paragraph(100.5), line_count);
+  EXPECT_EQ(cache.GetStats().hits, 2u);
+
+  layout_paragraph(400);
+  EXPECT_EQ(cache.GetStats().misses, 2u);
+
+  text_style.font_size = 20;
+  layout_paragraph(100);
+  EXPECT_EQ(cache.GetStats().misses, 3u);
+
+  text_style.color = SK_ColorRED;
+  layout_paragraph(100);
+  EXPECT_EQ(cache.GetStats().misses, 4u);
+
+  paragraph_style.max_lines = 1;
+  EXPECT_EQ(layout_paragraph(100), 1u);
+  EXPECT_EQ(cache.GetStats().misses, 5u);
+
+  // Changing the fonts invalidates every layout.
+  font_collection->ClearFontFamilyCache();
+  EXPECT_EQ(cache.GetStats().entries, 0u);
+  layout_paragraph(100);
+  EXPECT_EQ(cache.GetStats().misses, 6u);
+  EXPECT_EQ(cache.GetStats().hits, 2u);
+}
+
 }  // namespace txt
@@ -4,7 +4,133 @@
 
 #include "path_ops.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace flutter {
+
+namespace {
+
+// Reduces a list of paths with an op, pairing adjacent paths level by level
+// until a single path remains. The pairs of a level are split between the
+// calling thread and a set of workers that live as long as the reducer, so
+// that threads are only created once per batch rather than once per level.
+class PairwiseReducer {
+ public:
+  PairwiseReducer(SkPathOp op, size_t thread_count) : op_(op) {
+    workers_.reserve(thread_count - 1);
+    for (size_t i = 1; i < thread_count; i++) {
+      workers_.emplace_back([this]() { WorkerMain(); });
+    }
+  }
+
+  ~PairwiseReducer() {
+    {
+      std::scoped_lock lock(mutex_);
+      quit_ = true;
+    }
+    level_ready_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  // Returns false if any pairwise op fails.
+  bool Reduce(std::vector<SkPath> level, SkPath* result) {
+    while (level.size() > 1) {
+      std::vector<SkPath> next((level.size() + 1) / 2);
+      // An odd path out is carried to the next level untouched.
+      if (level.size() % 2 == 1) {
+        next.back() = std::move(level.back());
+      }
+      if (!ReduceLevel(level, &next)) {
+        return false;
+      }
+      level = std::move(next);
+    }
+    *result = std::move(level.front());
+    return true;
+  }
+
+ private:
+  const SkPathOp op_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable level_ready_;
+  std::condition_variable level_done_;
+  // Incremented for every level that the workers are asked to help with.
+  uint64_t generation_ = 0;
+  // The number of workers still running pairs of the current level.
+  size_t busy_workers_ = 0;
+  bool quit_ = false;
+
+  // The level being reduced. Only written while no worker is busy.
+  const std::vector<SkPath>* level_ = nullptr;
+  std::vector<SkPath>* next_ = nullptr;
+  size_t pair_count_ = 0;
+  std::atomic<size_t> next_pair_ = 0;
+  std::atomic<bool> failed_ = false;
+
+  bool ReduceLevel(const std::vector<SkPath>& level,
+                   std::vector<SkPath>* next) {
+    level_ = &level;
+    next_ = next;
+    pair_count_ = level.size() / 2;
+    next_pair_ = 0;
+    failed_ = false;
+    if (pair_count_ > 1 && !workers_.empty()) {
+      {
+        std::scoped_lock lock(mutex_);
+        busy_workers_ = workers_.size();
+        generation_++;
+      }
+      level_ready_.notify_all();
+      RunPairs();
+      std::unique_lock lock(mutex_);
+      level_done_.wait(lock, [this]() { return busy_workers_ == 0; });
+    } else {
+      RunPairs();
+    }
+    return !failed_;
+  }
+
+  void RunPairs() {
+    for (size_t i = next_pair_++; i < pair_count_; i = next_pair_++) {
+      if (!Op((*level_)[i * 2], (*level_)[i * 2 + 1], op_, &(*next_)[i])) {
+        failed_ = true;
+      }
+    }
+  }
+
+  void WorkerMain() {
+    uint64_t generation = 0;
+    while (true) {
+      {
+        std::unique_lock lock(mutex_);
+        level_ready_.wait(
+            lock, [&]() { return quit_ || generation_ != generation; });
+        if (quit_) {
+          return;
+        }
+        generation = generation_;
+      }
+      RunPairs();
+      {
+        std::scoped_lock lock(mutex_);
+        busy_workers_--;
+      }
+      level_done_.notify_one();
+    }
+  }
+};
+
+}  // namespace
+
 SkPath* CreatePath(SkPathFillType fill_type) {
   auto* path = new SkPath();
   path->setFillType(fill_type);
@@ -45,6 +171,84 @@ void Op(SkPath* one, SkPath* two, SkPathOp op) {
   Op(*one, *two, op, one);
 }
 
+bool BatchOp(SkPath** paths,
+             size_t count,
+             SkPathOp op,
+             SkPath* result,
+             size_t thread_count) {
+  if (count == 0 || op == SkPathOp::kReverseDifference_SkPathOp) {
+    return false;
+  }
+  if (thread_count == 0) {
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  }
+  // No level has more pairs than the first one.
+  thread_count = std::max<size_t>(1, std::min(thread_count, count / 2));
+  PairwiseReducer reducer(
+      op == SkPathOp::kDifference_SkPathOp ? SkPathOp::kUnion_SkPathOp : op,
+      thread_count);
+
+  if (op == SkPathOp::kDifference_SkPathOp) {
+    if (count == 1) {
+      *result = *paths[0];
+      return true;
+    }
+    SkPath subtrahend;
+    std::vector<SkPath> rest;
+    rest.reserve(count - 1);
+    for (size_t i = 1; i < count; i++) {
+      rest.push_back(*paths[i]);
+    }
+    if (!reducer.Reduce(std::move(rest), &subtrahend)) {
+      return false;
+    }
+    SkPath difference;
+    if (!Op(*paths[0], subtrahend, op, &difference)) {
+      return false;
+    }
+    *result = std::move(difference);
+    return true;
+  }
+
+  // SkPath copies share their underlying data until modified, so this does
+  // not duplicate the point and verb storage of the inputs.
+  std::vector<SkPath> level;
+  level.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    level.push_back(*paths[i]);
+  }
+  SkPath reduced;
+  if (!reducer.Reduce(std::move(level), &reduced)) {
+    return false;
+  }
+  *result = std::move(reduced);
+  return true;
+}
+
+size_t GetVerbCount(SkPath* path) {
+  return path->countVerbs();
+}
+
+size_t GetPointCount(SkPath* path) {
+  return path->countPoints() * 2;
+}
+
+bool CopyPathData(SkPath* path,
+                  uint8_t* verbs,
+                  size_t verb_capacity,
+                  float* points,
+                  size_t point_capacity) {
+  const int verb_count = path->countVerbs();
+  const int point_count = path->countPoints();
+  if (verb_capacity < static_cast<size_t>(verb_count) ||
+      point_capacity < static_cast<size_t>(point_count) * 2) {
+    return false;
+  }
+  path->getVerbs(verbs, verb_count);
+  path->getPoints(reinterpret_cast<SkPoint*>(points), point_count);
+  return true;
+}
+
 struct PathData* Data(SkPath* path) {
   int point_count = path->countPoints();
   int verb_count = path->countVerbs();
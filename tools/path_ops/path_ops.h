@@ -43,6 +43,42 @@ API void DestroyPath(SkPath* path);
 
 API void Op(SkPath* one, SkPath* two, SkPathOp op);
 
+// Combines |count| paths with |op| and stores the outcome in |result|.
+//
+// The inputs are reduced as a balanced tree, with independent pairs at each
+// level of the tree processed on up to |thread_count| threads, which are
+// created once per call. A |thread_count| of zero uses the hardware
+// concurrency. The input paths are not modified.
+//
+// Union, intersect and xor are associative and are applied across all
+// inputs. Difference subtracts the union of paths[1..count) from paths[0].
+// Reverse difference has no meaningful batched form and is rejected.
+//
+// Returns false if the op is unsupported or if Skia fails to compute any
+// intermediate result, in which case |result| is left unchanged.
+API bool BatchOp(SkPath** paths,
+                 size_t count,
+                 SkPathOp op,
+                 SkPath* result,
+                 size_t thread_count);
+
+// The number of verbs that |CopyPathData| will write for |path|.
+API size_t GetVerbCount(SkPath* path);
+
+// The number of floats (two per point) that |CopyPathData| will write for
+// |path|.
+API size_t GetPointCount(SkPath* path);
+
+// Writes the verbs and points of |path| directly into caller owned buffers.
+//
+// Returns false without writing anything if either buffer is too small, as
+// reported by |GetVerbCount| and |GetPointCount|.
+API bool CopyPathData(SkPath* path,
+                      uint8_t* verbs,
+                      size_t verb_capacity,
+                      float* points,
+                      size_t point_capacity);
+
 struct API PathData {
   uint8_t* verbs;
   size_t verb_count;
@@ -0,0 +1,105 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/tools/path_ops/path_ops.h"
+
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+
+namespace flutter {
+namespace {
+
+// Lays out |count| overlapping squares on a grid so that neighbouring inputs
+// intersect and every op has real work to do.
+std::vector<SkPath*> CreateGridOfSquares(size_t count) {
+  std::vector<SkPath*> paths;
+  paths.reserve(count);
+  const size_t columns = 100;
+  for (size_t i = 0; i < count; i++) {
+    SkScalar x = (i % columns) * 8.0f;
+    SkScalar y = (i / columns) * 8.0f;
+    SkPath* path = CreatePath(SkPathFillType::kWinding);
+    MoveTo(path, x, y);
+    LineTo(path, x + 10, y);
+    LineTo(path, x + 10, y + 10);
+    LineTo(path, x, y + 10);
+    Close(path);
+    paths.push_back(path);
+  }
+  return paths;
+}
+
+void DestroyPaths(const std::vector<SkPath*>& paths) {
+  for (SkPath* path : paths) {
+    DestroyPath(path);
+  }
+}
+
+void BM_SequentialUnion(benchmark::State& state) {
+  std::vector<SkPath*> paths = CreateGridOfSquares(state.range(0));
+  while (state.KeepRunning()) {
+    SkPath* result = CreatePath(SkPathFillType::kWinding);
+    for (SkPath* path : paths) {
+      Op(result, path, SkPathOp::kUnion_SkPathOp);
+    }
+    benchmark::DoNotOptimize(result->countVerbs());
+    DestroyPath(result);
+  }
+  DestroyPaths(paths);
+}
+
+void BM_BatchUnion(benchmark::State& state) {
+  std::vector<SkPath*> paths = CreateGridOfSquares(state.range(0));
+  const size_t thread_count = state.range(1);
+  while (state.KeepRunning()) {
+    SkPath* result = CreatePath(SkPathFillType::kWinding);
+    BatchOp(paths.data(), paths.size(), SkPathOp::kUnion_SkPathOp, result,
+            thread_count);
+    benchmark::DoNotOptimize(result->countVerbs());
+    DestroyPath(result);
+  }
+  DestroyPaths(paths);
+}
+
+void BM_CopyPathData(benchmark::State& state) {
+  std::vector<SkPath*> paths = CreateGridOfSquares(state.range(0));
+  SkPath* result = CreatePath(SkPathFillType::kWinding);
+  BatchOp(paths.data(), paths.size(), SkPathOp::kUnion_SkPathOp, result, 0);
+  std::vector<uint8_t> verbs(GetVerbCount(result));
+  std::vector<float> points(GetPointCount(result));
+  while (state.KeepRunning()) {
+    CopyPathData(result, verbs.data(), verbs.size(), points.data(),
+                 points.size());
+    benchmark::DoNotOptimize(points.data());
+  }
+  DestroyPath(result);
+  DestroyPaths(paths);
+}
+
+}  // namespace
+
+BENCHMARK(BM_SequentialUnion)
+    ->RangeMultiplier(10)
+    ->Range(1000, 10000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_BatchUnion)
+    ->Args({1000, 1})
+    ->Args({1000, 4})
+    ->Args({1000, 0})
+    ->Args({10000, 1})
+    ->Args({10000, 4})
+    ->Args({10000, 0})
+    ->Args({100000, 1})
+    ->Args({100000, 4})
+    ->Args({100000, 0})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CopyPathData)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
@@ -0,0 +1,178 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/tools/path_ops/path_ops.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+SkPath* CreateSquare(SkScalar x, SkScalar y, SkScalar size) {
+  SkPath* path = CreatePath(SkPathFillType::kWinding);
+  MoveTo(path, x, y);
+  LineTo(path, x + size, y);
+  LineTo(path, x + size, y + size);
+  LineTo(path, x, y + size);
+  Close(path);
+  return path;
+}
+
+// Overlapping squares on a grid, so that every op has work to do.
+std::vector<SkPath*> CreateGridOfSquares(size_t count) {
+  std::vector<SkPath*> paths;
+  for (size_t i = 0; i < count; i++) {
+    paths.push_back(CreateSquare((i % 8) * 8.0f, (i / 8) * 8.0f, 10));
+  }
+  return paths;
+}
+
+void DestroyPaths(const std::vector<SkPath*>& paths) {
+  for (SkPath* path : paths) {
+    DestroyPath(path);
+  }
+}
+
+SkPath SequentialOp(const std::vector<SkPath*>& paths, SkPathOp op) {
+  SkPath result = *paths[0];
+  for (size_t i = 1; i < paths.size(); i++) {
+    Op(result, *paths[i], op, &result);
+  }
+  return result;
+}
+
+// Ops applied in a different order may produce different contours for the
+// same area, so paths are compared by the points they contain. The squares
+// have integer edges, which the sample points avoid.
+void ExpectSameCoverage(const SkPath& actual, const SkPath& expected) {
+  for (SkScalar y = -1.5f; y < 80; y += 1) {
+    for (SkScalar x = -1.5f; x < 80; x += 1) {
+      ASSERT_EQ(actual.contains(x, y), expected.contains(x, y))
+          << "at " << x << ", " << y;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(PathOpsTest, BatchOpRejectsEmptyInput) {
+  SkPath result;
+  EXPECT_FALSE(BatchOp(nullptr, 0, SkPathOp::kUnion_SkPathOp, &result, 1));
+  EXPECT_TRUE(result.isEmpty());
+}
+
+TEST(PathOpsTest, BatchOpRejectsReverseDifference) {
+  std::vector<SkPath*> paths = CreateGridOfSquares(2);
+  SkPath result;
+  EXPECT_FALSE(BatchOp(paths.data(), paths.size(),
+                       SkPathOp::kReverseDifference_SkPathOp, &result, 1));
+  EXPECT_TRUE(result.isEmpty());
+  DestroyPaths(paths);
+}
+
+TEST(PathOpsTest, BatchOpOfASinglePathIsThatPath) {
+  std::vector<SkPath*> paths = CreateGridOfSquares(1);
+  for (SkPathOp op :
+       {SkPathOp::kUnion_SkPathOp, SkPathOp::kIntersect_SkPathOp,
+        SkPathOp::kXOR_SkPathOp, SkPathOp::kDifference_SkPathOp}) {
+    SkPath result;
+    ASSERT_TRUE(BatchOp(paths.data(), paths.size(), op, &result, 4));
+    ExpectSameCoverage(result, *paths[0]);
+  }
+  DestroyPaths(paths);
+}
+
+TEST(PathOpsTest, BatchOpMatchesSequentialOps) {
+  // An odd count, so that some levels carry a path over.
+  std::vector<SkPath*> paths = CreateGridOfSquares(37);
+  for (SkPathOp op : {SkPathOp::kUnion_SkPathOp, SkPathOp::kXOR_SkPathOp}) {
+    const SkPath expected = SequentialOp(paths, op);
+    for (size_t thread_count : {1, 2, 3, 8, 0}) {
+      SkPath result;
+      ASSERT_TRUE(BatchOp(paths.data(), paths.size(), op, &result,
+                          thread_count));
+      ExpectSameCoverage(result, expected);
+    }
+  }
+  DestroyPaths(paths);
+}
+
+TEST(PathOpsTest, BatchOpIntersectsAllPaths) {
+  std::vector<SkPath*> paths = {CreateSquare(0, 0, 10), CreateSquare(4, 2, 10),
+                                CreateSquare(2, 5, 10)};
+  SkPath result;
+  ASSERT_TRUE(BatchOp(paths.data(), paths.size(),
+                      SkPathOp::kIntersect_SkPathOp, &result, 2));
+  EXPECT_EQ(result.getBounds(), SkRect::MakeLTRB(4, 5, 10, 10));
+  ExpectSameCoverage(result,
+                     SequentialOp(paths, SkPathOp::kIntersect_SkPathOp));
+  DestroyPaths(paths);
+}
+
+TEST(PathOpsTest, BatchOpSubtractsTheOtherPathsFromTheFirst) {
+  std::vector<SkPath*> paths = {CreateSquare(0, 0, 30), CreateSquare(0, 0, 10),
+                                CreateSquare(20, 20, 10),
+                                CreateSquare(50, 50, 10)};
+  SkPath result;
+  ASSERT_TRUE(BatchOp(paths.data(), paths.size(),
+                      SkPathOp::kDifference_SkPathOp, &result, 2));
+  EXPECT_FALSE(result.contains(5, 5));
+  EXPECT_FALSE(result.contains(25, 25));
+  EXPECT_TRUE(result.contains(25, 5));
+  ExpectSameCoverage(result,
+                     SequentialOp(paths, SkPathOp::kDifference_SkPathOp));
+  DestroyPaths(paths);
+}
+
+TEST(PathOpsTest, CopyPathDataWritesVerbsAndPoints) {
+  SkPath* path = CreateSquare(1, 2, 3);
+  const size_t verb_count = GetVerbCount(path);
+  const size_t point_count = GetPointCount(path);
+  ASSERT_EQ(verb_count, 5u);
+  ASSERT_EQ(point_count, 8u);
+
+  std::vector<uint8_t> verbs(verb_count);
+  std::vector<float> points(point_count);
+  ASSERT_TRUE(CopyPathData(path, verbs.data(), verbs.size(), points.data(),
+                           points.size()));
+
+  PathData* data = Data(path);
+  EXPECT_EQ(verbs, std::vector<uint8_t>(data->verbs,
+                                        data->verbs + data->verb_count));
+  EXPECT_EQ(points, std::vector<float>(data->points,
+                                       data->points + data->point_count));
+  EXPECT_EQ(points, std::vector<float>({1, 2, 4, 2, 4, 5, 1, 5}));
+  DestroyData(data);
+  DestroyPath(path);
+}
+
+TEST(PathOpsTest, CopyPathDataRejectsSmallBuffers) {
+  SkPath* path = CreateSquare(1, 2, 3);
+  std::vector<uint8_t> verbs(GetVerbCount(path), 0xff);
+  std::vector<float> points(GetPointCount(path), -1);
+
+  EXPECT_FALSE(CopyPathData(path, verbs.data(), verbs.size() - 1,
+                            points.data(), points.size()));
+  EXPECT_FALSE(CopyPathData(path, verbs.data(), verbs.size(), points.data(),
+                            points.size() - 1));
+  // Nothing is written when either buffer is too small.
+  EXPECT_EQ(verbs, std::vector<uint8_t>(verbs.size(), 0xff));
+  EXPECT_EQ(points, std::vector<float>(points.size(), -1));
+  DestroyPath(path);
+}
+
+TEST(PathOpsTest, CopyPathDataOfAnEmptyPath) {
+  SkPath* path = CreatePath(SkPathFillType::kWinding);
+  EXPECT_EQ(GetVerbCount(path), 0u);
+  EXPECT_EQ(GetPointCount(path), 0u);
+  EXPECT_TRUE(CopyPathData(path, nullptr, 0, nullptr, 0));
+  DestroyPath(path);
+}
+
+}  // namespace testing
+}  // namespace flutter